@@ -0,0 +1,162 @@
+/**
+ *\file py_array_interface.hpp
+ *
+ * This header file declares a few utilities to exchange arrays of doubles between ReaK and
+ * Python (NumPy) without copying the data element by element. ReaK objects expose their
+ * storage through the NumPy array-interface protocol (i.e., an __array_interface__ property,
+ * such that numpy.asarray(obj) is a view on the ReaK object's data), and Python arrays are read
+ * by C++ code through the buffer protocol (any object exporting doubles, e.g., NumPy arrays).
+ * Neither of these require the NumPy headers or library to build the bindings.
+ *
+ * \author Sven Mikael Persson <mikael.s.persson@gmail.com>
+ * \date June 2013
+ */
+
+/*
+ *    Copyright 2013 Sven Mikael Persson
+ *
+ *    THIS SOFTWARE IS DISTRIBUTED UNDER THE TERMS OF THE GNU GENERAL PUBLIC LICENSE v3 (GPLv3).
+ *
+ *    This file is part of ReaK.
+ *
+ *    ReaK is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    (at your option) any later version.
+ *
+ *    ReaK is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with ReaK (as LICENSE in the root folder).
+ *    If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef REAK_PY_ARRAY_INTERFACE_HPP
+#define REAK_PY_ARRAY_INTERFACE_HPP
+
+
+#include "defs.hpp"
+
+#include <boost/python.hpp>
+
+#include <stdexcept>
+#include <cstring>
+
+
+namespace PyReaK {
+
+
+/**
+ * This function returns the NumPy type-string for doubles in the native byte-order.
+ */
+inline const char* py_double_typestr() {
+  const unsigned short one = 1;
+  if(*reinterpret_cast<const unsigned char*>(&one) == 1)
+    return "<f8";
+  else
+    return ">f8";
+};
+
+/**
+ * This function creates the dictionary of the NumPy array-interface (version 3) describing
+ * an array of doubles stored in a ReaK object. The resulting NumPy arrays refer to the ReaK
+ * object (which is kept alive by them) and become invalid if the object is resized.
+ * \param data The pointer to the first element.
+ * \param shape The shape of the array (one or two dimensions).
+ * \param strides The strides (in bytes) of the array, for each dimension.
+ * \param read_only Tells if the array must not be written to.
+ * \return The array-interface dictionary.
+ */
+inline boost::python::dict py_make_array_interface(const double* data,
+                                                   const boost::python::tuple& shape,
+                                                   const boost::python::tuple& strides,
+                                                   bool read_only = false) {
+  using namespace boost::python;
+  dict result;
+  result["version"] = 3;
+  result["typestr"] = py_double_typestr();
+  result["shape"] = shape;
+  result["strides"] = strides;
+  result["data"] = make_tuple(reinterpret_cast<std::size_t>(data), read_only);
+  return result;
+};
+
+
+/**
+ * This class is a read-only view of a one or two dimensional array of doubles exported
+ * by a Python object through the buffer protocol (e.g., a NumPy array, or an array.array('d')).
+ * The data is not copied, and the exporter cannot resize or free the data while the view exists.
+ */
+class py_double_array_view {
+  private:
+    Py_buffer view;
+
+    py_double_array_view(const py_double_array_view&);
+    py_double_array_view& operator=(const py_double_array_view&);
+  public:
+
+    /**
+     * Acquires the buffer of the given Python object.
+     * \throw boost::python::error_already_set If the object does not export a one or two dimensional array of doubles.
+     */
+    explicit py_double_array_view(const boost::python::object& aObj) {
+      if(PyObject_GetBuffer(aObj.ptr(), &view, PyBUF_STRIDES | PyBUF_FORMAT) != 0)
+        boost::python::throw_error_already_set();
+      // the format is "d", possibly preceded by a native byte-order character.
+      const char* fmt = (view.format ? view.format : "");
+      if((*fmt == '@') || (*fmt == '=') || (*fmt == py_double_typestr()[0]))
+        ++fmt;
+      if((view.ndim < 1) || (view.ndim > 2) || (view.itemsize != sizeof(double)) || (std::strcmp(fmt, "d") != 0)) {
+        PyBuffer_Release(&view);
+        PyErr_SetString(PyExc_TypeError, "Expected a one or two dimensional array of doubles (float64).");
+        boost::python::throw_error_already_set();
+      };
+    };
+
+    ~py_double_array_view() {
+      PyBuffer_Release(&view);
+    };
+
+    /// Returns the number of rows (the length of the array, if one-dimensional).
+    std::size_t get_row_count() const { return view.shape[0]; };
+
+    /// Returns the number of columns (one, if one-dimensional).
+    std::size_t get_col_count() const { return (view.ndim == 2 ? view.shape[1] : 1); };
+
+    /// Returns the element (i,j), or the element i if one-dimensional (j == 0).
+    double operator()(std::size_t i, std::size_t j = 0) const {
+      const char* p = static_cast<const char*>(view.buf) + i * view.strides[0];
+      if(view.ndim == 2)
+        p += j * view.strides[1];
+      double result;
+      std::memcpy(&result, p, sizeof(double));
+      return result;
+    };
+};
+
+
+/**
+ * This class releases the Python global interpreter lock (GIL) for the duration of its
+ * life-time, such that other Python threads can run during long computations. No Python
+ * objects can be used while the GIL is released.
+ */
+class py_release_gil {
+  private:
+    PyThreadState* state;
+
+    py_release_gil(const py_release_gil&);
+    py_release_gil& operator=(const py_release_gil&);
+  public:
+    py_release_gil() : state(PyEval_SaveThread()) { };
+    ~py_release_gil() { PyEval_RestoreThread(state); };
+};
+
+
+};
+
+
+#endif
+
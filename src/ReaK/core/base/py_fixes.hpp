@@ -36,9 +36,11 @@
 #include "defs.hpp"
 
 #include <boost/python.hpp>
+#include <boost/version.hpp>
 
 
-#ifdef RK_ENABLE_CXX0X_FEATURES
+// Boost.Python provides get_pointer for std::shared_ptr since version 1.63.
+#if defined(RK_ENABLE_CXX0X_FEATURES) && (BOOST_VERSION < 106300)
 
 namespace std {
   
@@ -141,7 +141,7 @@ ReaK::shared_ptr<Y> rk_dynamic_ptr_cast(const ReaK::shared_ptr<ReaK::shared_obje
 
 template <typename Y, typename Deleter>
 ReaK::unique_ptr<Y,Deleter> rk_dynamic_ptr_cast(ReaK::unique_ptr<ReaK::shared_object_base,Deleter>&& p) {
-  void* tmp = static_cast<ReaK::shared_object*>(p.get())->castTo(Y::getStaticObjectType());
+  void* tmp = static_cast<ReaK::shared_object*>(p.get())->castTo(ReaK::rtti::get_type_id_array<Y>());
   if(tmp) {
     ReaK::unique_ptr<Y,Deleter> r(tmp, p.get_deleter());
     p.release();
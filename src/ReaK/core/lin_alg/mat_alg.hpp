@@ -53,6 +53,11 @@
 #include "mat_alg_lower_triangular.hpp"
 #include "mat_alg_upper_triangular.hpp"
 #include "mat_alg_permutation.hpp"
+#include "mat_alg_sparse.hpp"
+#include "mat_alg_rectangular_fixed.hpp"
+#include "mat_alg_square_fixed.hpp"
+#include "mat_alg_symmetric_fixed.hpp"
+#include "mat_alg_diagonal_fixed.hpp"
 
 #include "mat_operators.hpp"
 
@@ -61,6 +66,7 @@
 #include "mat_transpose_view.hpp"
 #include "mat_slices.hpp"
 #include "mat_composite_adaptor.hpp"
+#include "mat_lazy_expr.hpp"
 
 /** Main namespace for ReaK */
 namespace ReaK {
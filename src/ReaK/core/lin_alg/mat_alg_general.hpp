@@ -52,6 +52,7 @@
 #include <boost/mpl/not.hpp>
 #include <boost/mpl/logical.hpp>
 #include <boost/mpl/less.hpp>
+#include <boost/mpl/if.hpp>
 #include <boost/mpl/comparison.hpp>
 
 
@@ -290,6 +291,34 @@ struct is_diagonal_matrix< mat_fix<T,Structure,RowCount,ColCount,Alignment> > {
 
 
 
+/**
+ * This meta-function selects the fixed-size matrix class template (mat_fix) when both
+ * dimensions are known at compile-time (non-zero), and the dynamically-sized matrix class
+ * template (mat) otherwise. This is mostly useful to create the temporary matrices within
+ * generic algorithms, such that small fixed-size problems use in-place storage and
+ * compile-time loop bounds.
+ *
+ * \note Only the rectangular, square, symmetric and diagonal structures have a fixed-size
+ *       implementation.
+ *
+ * \tparam T Arithmetic type of the elements of the matrix.
+ * \tparam Structure Enum which defines the structure of the matrix, see mat_structure::tag.
+ * \tparam RowCount The static row count (0 if dynamic).
+ * \tparam ColCount The static column count (0 if dynamic).
+ * \tparam Alignment Enum which defines the memory alignment of the matrix.
+ */
+template <typename T,
+          mat_structure::tag Structure,
+	  std::size_t RowCount, std::size_t ColCount,
+	  mat_alignment::tag Alignment = mat_alignment::column_major>
+struct mat_fix_or_dynamic {
+  typedef typename boost::mpl::if_c< ((RowCount != 0) && (ColCount != 0)),
+    mat_fix<T,Structure,RowCount,ColCount,Alignment>,
+    mat<T,Structure,Alignment> >::type type;
+};
+
+
+
 template <mat_structure::tag Structure, mat_alignment::tag Alignment>
 struct mat_indexer { };
 
@@ -0,0 +1,668 @@
+/**
+ * \file mat_alg_sparse.hpp
+ *
+ * This library declares a matrix class template for representing and manipulating sparse matrices
+ * stored in the compressed-column format (CSC). This is mostly useful to represent the large and
+ * mostly empty Jacobian and Hessian matrices that arise in large optimization problems (e.g.,
+ * trajectory optimization by collocation), for which dense storage and dense factorizations are
+ * not appropriate. See mat_sparse_ldl.hpp for the corresponding sparse factorization.
+ *
+ * \author Mikael Persson <mikael.s.persson@gmail.com>
+ * \date June 2013
+ */
+
+/*
+ *    Copyright 2013 Sven Mikael Persson
+ *
+ *    THIS SOFTWARE IS DISTRIBUTED UNDER THE TERMS OF THE GNU GENERAL PUBLIC LICENSE v3 (GPLv3).
+ *
+ *    This file is part of ReaK.
+ *
+ *    ReaK is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    (at your option) any later version.
+ *
+ *    ReaK is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with ReaK (as LICENSE in the root folder).
+ *    If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef REAK_MAT_ALG_SPARSE_HPP
+#define REAK_MAT_ALG_SPARSE_HPP
+
+#include "mat_alg_general.hpp"
+
+#include <vector>
+#include <algorithm>
+
+#include <boost/mpl/and.hpp>
+#include <boost/mpl/not.hpp>
+
+
+namespace ReaK {
+
+
+/**
+ * This class implements a sparse matrix stored in the compressed-column format (CSC), that is,
+ * for each column, the row-indices and values of the stored (non-zero) entries are kept in
+ * increasing row order, and the start of each column within these arrays is recorded. Entries
+ * that are not stored are zero. The matrix is readable like any other matrix (entries are found
+ * by a binary search within their column), and it is writable in the sense that writing to an
+ * entry that is not stored will insert it into the sparsity pattern (which is linear in the number
+ * of stored entries, unless the matrix is filled column by column, in increasing row order). Once
+ * a sparsity pattern has been established (e.g., by a first fill of a Jacobian matrix), subsequent
+ * writes to the same entries do not modify the pattern, which is what allows sparse factorizations
+ * to re-use their symbolic analysis (see sparse_LDL_decomposition).
+ *
+ * Models: ReadableMatrixConcept, WritableMatrixConcept and ResizableMatrixConcept.
+ *
+ * \tparam T Arithmetic type of the elements of the matrix.
+ */
+template <typename T>
+class mat_sparse : public serialization::serializable {
+  public:
+
+    typedef mat_sparse<T> self;
+    typedef void allocator_type;
+
+    typedef T value_type;
+    typedef unsigned int size_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef std::vector<value_type> container_type;
+    typedef std::vector<size_type> index_container_type;
+
+    typedef T& reference;
+    typedef T const_reference;
+    typedef T* pointer;
+    typedef const T* const_pointer;
+
+    typedef void row_iterator;
+    typedef void const_row_iterator;
+    typedef void col_iterator;
+    typedef void const_col_iterator;
+
+    BOOST_STATIC_CONSTANT(std::size_t, static_row_count = 0);
+    BOOST_STATIC_CONSTANT(std::size_t, static_col_count = 0);
+    BOOST_STATIC_CONSTANT(mat_alignment::tag, alignment = mat_alignment::column_major);
+    BOOST_STATIC_CONSTANT(mat_structure::tag, structure = mat_structure::rectangular);
+
+  private:
+    index_container_type col_ptr; ///< Start of each column in the row_idx and q arrays (colCount + 1 elements).
+    index_container_type row_idx; ///< Row-indices of the stored entries.
+    container_type q;             ///< Values of the stored entries.
+    size_type rowCount; ///< Row Count.
+    size_type colCount; ///< Column Count.
+
+    size_type find_entry(size_type i, size_type j) const {
+      typename index_container_type::const_iterator it = std::lower_bound(row_idx.begin() + col_ptr[j], row_idx.begin() + col_ptr[j+1], i);
+      return it - row_idx.begin();
+    };
+
+    size_type insert_entry(size_type pos, size_type i, size_type j) {
+      row_idx.insert(row_idx.begin() + pos, i);
+      q.insert(q.begin() + pos, value_type(0));
+      for(size_type k = j + 1; k <= colCount; ++k)
+        ++(col_ptr[k]);
+      return pos;
+    };
+
+  public:
+    /**
+     * Default constructor. Sets dimensions to zero.
+     */
+    mat_sparse() : col_ptr(1, 0), row_idx(), q(), rowCount(0), colCount(0) { };
+    /**
+     * Constructs an empty (all-zero) sparse matrix of the given dimensions.
+     * \param aRowCount The number of rows.
+     * \param aColCount The number of columns.
+     */
+    mat_sparse(size_type aRowCount, size_type aColCount) : col_ptr(aColCount + 1, 0), row_idx(), q(),
+                                                           rowCount(aRowCount), colCount(aColCount) { };
+
+    /**
+     * Explicit constructor from any type of matrix, only the entries whose magnitude is greater
+     * than the given tolerance are stored (diagonal matrix types only have their diagonal read).
+     * \param M The matrix to copy.
+     * \param aDropTol The tolerance below which an entry is considered zero (and not stored).
+     */
+    template <typename Matrix>
+    explicit mat_sparse(const Matrix& M, value_type aDropTol = value_type(0),
+                        typename boost::enable_if<
+                          boost::mpl::and_<
+                            is_readable_matrix<Matrix>,
+                            boost::mpl::not_< boost::is_same<Matrix,self> >
+                          >, void* >::type dummy = NULL) :
+                        col_ptr(M.get_col_count() + 1, 0), row_idx(), q(),
+                        rowCount(M.get_row_count()), colCount(M.get_col_count()) {
+      using std::fabs;
+      for(size_type j = 0; j < colCount; ++j) {
+        if(is_diagonal_matrix<Matrix>::value) {
+          if((j < rowCount) && (fabs(M(j,j)) > aDropTol)) {
+            row_idx.push_back(j);
+            q.push_back(M(j,j));
+          };
+        } else {
+          for(size_type i = 0; i < rowCount; ++i) {
+            value_type v = M(i,j);
+            if(fabs(v) > aDropTol) {
+              row_idx.push_back(i);
+              q.push_back(v);
+            };
+          };
+        };
+        col_ptr[j+1] = row_idx.size();
+      };
+    };
+
+    /**
+     * Standard swap function (works with ADL).
+     */
+    friend void swap(self& lhs,self& rhs) throw() {
+      using std::swap;
+      lhs.col_ptr.swap(rhs.col_ptr);
+      lhs.row_idx.swap(rhs.row_idx);
+      lhs.q.swap(rhs.q);
+      swap(lhs.rowCount,rhs.rowCount);
+      swap(lhs.colCount,rhs.colCount);
+    };
+
+/*******************************************************************************
+                         Accessors and Methods
+*******************************************************************************/
+
+    /**
+     * Matrix indexing accessor for read-only access.
+     * \param i Row index.
+     * \param j Column index.
+     * \return the element at the given position (zero if it is not stored).
+     */
+    const_reference operator()(size_type i,size_type j) const {
+      size_type k = find_entry(i,j);
+      if((k < col_ptr[j+1]) && (row_idx[k] == i))
+        return q[k];
+      else
+        return value_type(0);
+    };
+
+    /**
+     * Matrix indexing accessor for read-write access. If the entry is not yet stored, it is
+     * inserted in the sparsity pattern (with a zero value).
+     * \param i Row index.
+     * \param j Column index.
+     * \return the element at the given position.
+     */
+    reference operator()(size_type i,size_type j) {
+      size_type k = find_entry(i,j);
+      if((k == col_ptr[j+1]) || (row_idx[k] != i))
+        insert_entry(k,i,j);
+      return q[k];
+    };
+
+    /**
+     * Gets the row-count (number of rows) of the matrix.
+     * \return number of rows of the matrix.
+     */
+    size_type get_row_count() const { return rowCount; };
+
+    /**
+     * Sets the row-count (number of rows) of the matrix. Stored entries beyond the new row-count are removed.
+     * \param aRowCount new number of rows for the matrix.
+     * \param aPreserveData If true, the resizing will preserve all the data it can.
+     */
+    void set_row_count(size_type aRowCount,bool aPreserveData = false) {
+      if(!aPreserveData) {
+        row_idx.clear();
+        q.clear();
+        std::fill(col_ptr.begin(), col_ptr.end(), 0);
+      } else if(aRowCount < rowCount) {
+        size_type k = 0;
+        size_type p = 0;
+        for(size_type j = 0; j < colCount; ++j) {
+          for(; p < col_ptr[j+1]; ++p) {
+            if(row_idx[p] < aRowCount) {
+              row_idx[k] = row_idx[p];
+              q[k] = q[p];
+              ++k;
+            };
+          };
+          col_ptr[j+1] = k;
+        };
+        row_idx.resize(k);
+        q.resize(k);
+      };
+      rowCount = aRowCount;
+    };
+
+    /**
+     * Gets the column-count (number of columns) of the matrix.
+     * \return number of columns of the matrix.
+     */
+    size_type get_col_count() const { return colCount; };
+
+    /**
+     * Sets the column-count (number of columns) of the matrix. Stored entries beyond the new column-count are removed.
+     * \param aColCount new number of columns for the matrix.
+     * \param aPreserveData If true, the resizing will preserve all the data it can.
+     */
+    void set_col_count(size_type aColCount,bool aPreserveData = false) {
+      if(!aPreserveData) {
+        row_idx.clear();
+        q.clear();
+        col_ptr.assign(aColCount + 1, 0);
+      } else {
+        size_type last = (aColCount < colCount ? col_ptr[aColCount] : col_ptr[colCount]);
+        col_ptr.resize(aColCount + 1, last);
+        row_idx.resize(last);
+        q.resize(last);
+      };
+      colCount = aColCount;
+    };
+
+    /**
+     * Returns the number of stored entries (the size of the sparsity pattern).
+     */
+    size_type get_nonzero_count() const { return q.size(); };
+
+    /**
+     * Reserves storage for the given number of stored entries.
+     */
+    void reserve(size_type aNonZeroCount) {
+      row_idx.reserve(aNonZeroCount);
+      q.reserve(aNonZeroCount);
+    };
+
+    /**
+     * Sets all the stored entries to zero, keeping the sparsity pattern intact.
+     */
+    void clear_values() { std::fill(q.begin(), q.end(), value_type(0)); };
+
+    /**
+     * Removes all the stored entries (the matrix becomes zero, with an empty sparsity pattern).
+     */
+    void clear() {
+      row_idx.clear();
+      q.clear();
+      std::fill(col_ptr.begin(), col_ptr.end(), 0);
+    };
+
+    /**
+     * Appends an entry at the end of the last non-empty column, this is meant to be used for the
+     * construction of a sparse matrix column by column (in increasing row order) without the
+     * searches and insertions of the element accessor. The entries must be appended in strictly
+     * increasing column-major order.
+     * \param i Row index.
+     * \param j Column index.
+     * \param value The value of the entry.
+     */
+    void push_back(size_type i, size_type j, const value_type& value) {
+      row_idx.push_back(i);
+      q.push_back(value);
+      for(size_type k = j + 1; k <= colCount; ++k)
+        col_ptr[k] = row_idx.size();
+    };
+
+    /**
+     * Checks if this matrix has the same dimensions and sparsity pattern as another.
+     */
+    bool has_same_pattern(const self& rhs) const {
+      return (rowCount == rhs.rowCount) && (colCount == rhs.colCount) &&
+             (col_ptr == rhs.col_ptr) && (row_idx == rhs.row_idx);
+    };
+
+    /**
+     * Returns the array of column starts (colCount + 1 elements) into the row-index and value arrays.
+     */
+    const index_container_type& get_col_pointers() const { return col_ptr; };
+    /**
+     * Returns the array of row-indices of the stored entries (sorted within each column).
+     */
+    const index_container_type& get_row_indices() const { return row_idx; };
+    /**
+     * Returns the array of values of the stored entries.
+     */
+    const container_type& get_values() const { return q; };
+    /**
+     * Returns the array of values of the stored entries, for read-write access (the sparsity
+     * pattern cannot be modified this way).
+     */
+    container_type& get_values() { return q; };
+
+
+/*******************************************************************************
+                         Basic Operators
+*******************************************************************************/
+
+    /**
+     * Scalar-multiply-and-store operator.
+     * \param S the scalar to be multiplied to this matrix.
+     * \return this matrix by reference.
+     */
+    self& operator *=(const value_type& S) {
+      for(typename container_type::iterator it = q.begin(); it != q.end(); ++it)
+        (*it) *= S;
+      return *this;
+    };
+
+    /**
+     * Negate the matrix.
+     * \return The negative of this matrix, by value.
+     */
+    self operator -() const {
+      self result(*this);
+      for(typename container_type::iterator it = result.q.begin(); it != result.q.end(); ++it)
+        (*it) = -(*it);
+      return result;
+    };
+
+    /**
+     * Addition of two sparse matrices, the resulting sparsity pattern is the union of the two patterns.
+     * \param M1 the first sparse matrix.
+     * \param M2 the second sparse matrix.
+     * \return the sum of the matrices, by value.
+     * \throw std::range_error if the matrix dimensions do not match.
+     */
+    friend self operator +(const self& M1, const self& M2) {
+      return add_impl(M1, M2, value_type(1));
+    };
+
+    /**
+     * Subtraction of two sparse matrices, the resulting sparsity pattern is the union of the two patterns.
+     * \param M1 the first sparse matrix.
+     * \param M2 the second sparse matrix.
+     * \return the difference of the matrices, by value.
+     * \throw std::range_error if the matrix dimensions do not match.
+     */
+    friend self operator -(const self& M1, const self& M2) {
+      return add_impl(M1, M2, value_type(-1));
+    };
+
+    /**
+     * Multiplication of two sparse matrices (column-by-column Gustavson's algorithm, linear in
+     * the number of floating-point operations involved).
+     * \param M1 the first sparse matrix.
+     * \param M2 the second sparse matrix.
+     * \return the product of the matrices, by value.
+     * \throw std::range_error if the matrix dimensions are not proper for multiplication.
+     */
+    friend self operator *(const self& M1, const self& M2) {
+      if(M1.colCount != M2.rowCount)
+        throw std::range_error("Matrix dimension mismatch.");
+      self result(M1.rowCount, M2.colCount);
+      result.reserve(M1.q.size() + M2.q.size());
+      std::vector<value_type> acc(M1.rowCount, value_type(0));
+      std::vector<size_type> mark(M1.rowCount, M2.colCount);
+      std::vector<size_type> pattern;
+      pattern.reserve(M1.rowCount);
+      for(size_type j = 0; j < M2.colCount; ++j) {
+        pattern.clear();
+        for(size_type p = M2.col_ptr[j]; p < M2.col_ptr[j+1]; ++p) {
+          size_type k = M2.row_idx[p];
+          for(size_type r = M1.col_ptr[k]; r < M1.col_ptr[k+1]; ++r) {
+            size_type i = M1.row_idx[r];
+            if(mark[i] != j) {
+              mark[i] = j;
+              acc[i] = value_type(0);
+              pattern.push_back(i);
+            };
+            acc[i] += M1.q[r] * M2.q[p];
+          };
+        };
+        std::sort(pattern.begin(), pattern.end());
+        for(std::size_t r = 0; r < pattern.size(); ++r) {
+          result.row_idx.push_back(pattern[r]);
+          result.q.push_back(acc[pattern[r]]);
+        };
+        result.col_ptr[j+1] = result.row_idx.size();
+      };
+      return result;
+    };
+
+    /**
+     * Transpose the matrix.
+     * \param M the matrix to be transposed.
+     * \return The transpose matrix, by value.
+     */
+    friend self transpose(const self& M) {
+      self result(M.colCount, M.rowCount);
+      result.row_idx.resize(M.q.size());
+      result.q.resize(M.q.size());
+      for(std::size_t p = 0; p < M.q.size(); ++p)
+        ++(result.col_ptr[M.row_idx[p] + 1]);
+      for(size_type i = 0; i < M.rowCount; ++i)
+        result.col_ptr[i+1] += result.col_ptr[i];
+      std::vector<size_type> next(result.col_ptr.begin(), result.col_ptr.end() - 1);
+      for(size_type j = 0; j < M.colCount; ++j) {
+        for(size_type p = M.col_ptr[j]; p < M.col_ptr[j+1]; ++p) {
+          size_type k = next[M.row_idx[p]]++;
+          result.row_idx[k] = j;
+          result.q[k] = M.q[p];
+        };
+      };
+      return result;
+    };
+
+    /**
+     * Transpose and move the matrix.
+     * \param M the matrix to be transposed and moved (emptied).
+     * \return The transpose matrix, by value.
+     */
+    friend self transpose_move(self& M) {
+      self result(transpose(M));
+      M.clear();
+      return result;
+    };
+
+    /**
+     * Returns the trace of a matrix.
+     * \param M A matrix.
+     * \return the trace of matrix M.
+     */
+    friend value_type trace(const self& M) {
+      value_type result(0);
+      size_type N = (M.rowCount < M.colCount ? M.rowCount : M.colCount);
+      for(size_type i = 0; i < N; ++i)
+        result += M(i,i);
+      return result;
+    };
+
+  private:
+
+    static self add_impl(const self& M1, const self& M2, const value_type& s) {
+      if((M1.rowCount != M2.rowCount) || (M1.colCount != M2.colCount))
+        throw std::range_error("Matrix dimension mismatch.");
+      self result(M1.rowCount, M1.colCount);
+      result.reserve(M1.q.size() + M2.q.size());
+      for(size_type j = 0; j < M1.colCount; ++j) {
+        size_type p1 = M1.col_ptr[j];
+        size_type p2 = M2.col_ptr[j];
+        while((p1 < M1.col_ptr[j+1]) || (p2 < M2.col_ptr[j+1])) {
+          if((p2 == M2.col_ptr[j+1]) || ((p1 < M1.col_ptr[j+1]) && (M1.row_idx[p1] < M2.row_idx[p2]))) {
+            result.row_idx.push_back(M1.row_idx[p1]);
+            result.q.push_back(M1.q[p1]);
+            ++p1;
+          } else if((p1 == M1.col_ptr[j+1]) || (M2.row_idx[p2] < M1.row_idx[p1])) {
+            result.row_idx.push_back(M2.row_idx[p2]);
+            result.q.push_back(s * M2.q[p2]);
+            ++p2;
+          } else {
+            result.row_idx.push_back(M1.row_idx[p1]);
+            result.q.push_back(M1.q[p1] + s * M2.q[p2]);
+            ++p1; ++p2;
+          };
+        };
+        result.col_ptr[j+1] = result.row_idx.size();
+      };
+      return result;
+    };
+
+  public:
+
+/*******************************************************************************
+                   ReaK's RTTI and Serialization interfaces
+*******************************************************************************/
+
+    virtual void RK_CALL save(serialization::oarchive& A, unsigned int) const {
+      A & RK_SERIAL_SAVE_WITH_NAME(col_ptr)
+        & RK_SERIAL_SAVE_WITH_NAME(row_idx)
+        & std::pair<std::string, const std::vector<T>&>("q",q)
+        & std::pair<std::string, unsigned int>("rowCount",rowCount)
+        & std::pair<std::string, unsigned int>("colCount",colCount);
+    };
+    virtual void RK_CALL load(serialization::iarchive& A, unsigned int) {
+      A & RK_SERIAL_LOAD_WITH_NAME(col_ptr)
+        & RK_SERIAL_LOAD_WITH_NAME(row_idx)
+        & std::pair<std::string, std::vector<T>&>("q",q)
+        & std::pair<std::string, unsigned int&>("rowCount",rowCount)
+        & std::pair<std::string, unsigned int&>("colCount",colCount);
+    };
+
+    RK_RTTI_REGISTER_CLASS_1BASE(self,1,serialization::serializable)
+
+};
+
+
+
+template <typename T>
+struct is_readable_matrix< mat_sparse<T> > {
+  typedef boost::mpl::integral_c_tag tag;
+  typedef bool value_type;
+  BOOST_STATIC_CONSTANT( bool, value = true );
+  typedef is_readable_matrix< mat_sparse<T> > type;
+};
+
+template <typename T>
+struct is_writable_matrix< mat_sparse<T> > {
+  typedef boost::mpl::integral_c_tag tag;
+  typedef bool value_type;
+  BOOST_STATIC_CONSTANT( bool, value = true );
+  typedef is_writable_matrix< mat_sparse<T> > type;
+};
+
+template <typename T>
+struct is_resizable_matrix< mat_sparse<T> > {
+  typedef boost::mpl::integral_c_tag tag;
+  typedef bool value_type;
+  BOOST_STATIC_CONSTANT( bool, value = true );
+  typedef is_resizable_matrix< mat_sparse<T> > type;
+};
+
+template <typename T>
+struct has_allocator_matrix< mat_sparse<T> > {
+  typedef boost::mpl::integral_c_tag tag;
+  typedef bool value_type;
+  BOOST_STATIC_CONSTANT( bool, value = false );
+  typedef has_allocator_matrix< mat_sparse<T> > type;
+};
+
+
+
+/**
+ * Column-vector multiplication with a sparse matrix (linear in the number of stored entries).
+ * \param M a sparse matrix.
+ * \param V some vector.
+ * \return The product M * V, by value.
+ * \throw std::range_error if matrix and vector dimensions are not proper for multiplication.
+ */
+template <typename T, typename Vector>
+typename boost::enable_if< is_readable_vector<Vector>,
+vect_copy<Vector> >::type::type operator *(const mat_sparse<T>& M, const Vector& V) {
+  if(V.size() != M.get_col_count())
+    throw std::range_error("Matrix dimension mismatch.");
+  typedef typename vect_copy<Vector>::type result_type;
+  typedef typename mat_sparse<T>::size_type size_type;
+  const typename mat_sparse<T>::index_container_type& cp = M.get_col_pointers();
+  const typename mat_sparse<T>::index_container_type& ri = M.get_row_indices();
+  const typename mat_sparse<T>::container_type& q = M.get_values();
+
+  result_type result(M.get_row_count());
+  for(size_type i = 0; i < M.get_row_count(); ++i)
+    result[i] = T(0);
+  for(size_type j = 0; j < M.get_col_count(); ++j)
+    for(size_type p = cp[j]; p < cp[j+1]; ++p)
+      result[ri[p]] += q[p] * V[j];
+  return result;
+};
+
+/**
+ * Row-vector multiplication with a sparse matrix (linear in the number of stored entries).
+ * \param V some row-vector.
+ * \param M a sparse matrix.
+ * \return The product V * M, by value.
+ * \throw std::range_error if matrix and vector dimensions are not proper for multiplication.
+ */
+template <typename T, typename Vector>
+typename boost::enable_if< is_readable_vector<Vector>,
+vect_copy<Vector> >::type::type operator *(const Vector& V, const mat_sparse<T>& M) {
+  if(V.size() != M.get_row_count())
+    throw std::range_error("Matrix dimension mismatch.");
+  typedef typename vect_copy<Vector>::type result_type;
+  typedef typename mat_sparse<T>::size_type size_type;
+  const typename mat_sparse<T>::index_container_type& cp = M.get_col_pointers();
+  const typename mat_sparse<T>::index_container_type& ri = M.get_row_indices();
+  const typename mat_sparse<T>::container_type& q = M.get_values();
+
+  result_type result(M.get_col_count());
+  for(size_type j = 0; j < M.get_col_count(); ++j) {
+    result[j] = T(0);
+    for(size_type p = cp[j]; p < cp[j+1]; ++p)
+      result[j] += V[ri[p]] * q[p];
+  };
+  return result;
+};
+
+/**
+ * Scalar multiplication of a sparse matrix.
+ * \param M a sparse matrix.
+ * \param S some scalar.
+ * \return The product M * S, by value.
+ */
+template <typename T>
+mat_sparse<T> operator *(mat_sparse<T> M, const T& S) {
+  M *= S;
+  return M;
+};
+
+/**
+ * Scalar multiplication of a sparse matrix.
+ * \param S some scalar.
+ * \param M a sparse matrix.
+ * \return The product S * M, by value.
+ */
+template <typename T>
+mat_sparse<T> operator *(const T& S, mat_sparse<T> M) {
+  M *= S;
+  return M;
+};
+
+
+
+namespace rtti {
+
+template <typename T>
+struct get_type_id< mat_sparse<T> > {
+  BOOST_STATIC_CONSTANT(unsigned int, ID = 0x00000014);
+  static std::string type_name() { return "mat_sparse"; };
+  static construct_ptr CreatePtr() { return NULL; };
+
+  typedef const serialization::serializable& save_type;
+  typedef serialization::serializable& load_type;
+};
+
+template <typename T, typename Tail>
+struct get_type_info< mat_sparse<T>, Tail > {
+  typedef detail::type_id< mat_sparse<T> , typename get_type_info<T, Tail>::type > type;
+  static std::string type_name() { return get_type_id< mat_sparse<T> >::type_name() + "<" + get_type_id<T>::type_name() + ">" + (boost::is_same< Tail, null_type_info >::value ? "" : "," + Tail::type_name()); };
+};
+
+};
+
+
+};
+
+#endif
@@ -0,0 +1,465 @@
+/**
+ * \file mat_alg_square_fixed.hpp
+ *
+ * This library implements the specialization of the mat_fix<> template for a
+ * square matrix (fixed dimensions) of both column-major and row-major alignment.
+ * This matrix type fulfills all the general matrix concepts (Readable, Writable,
+ * and Fully-Writable), but it is not resizable.
+ *
+ * \author Mikael Persson <mikael.s.persson@gmail.com>
+ * \date june 2013
+ */
+
+/*
+ *    Copyright 2013 Sven Mikael Persson
+ *
+ *    THIS SOFTWARE IS DISTRIBUTED UNDER THE TERMS OF THE GNU GENERAL PUBLIC LICENSE v3 (GPLv3).
+ *
+ *    This file is part of ReaK.
+ *
+ *    ReaK is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    (at your option) any later version.
+ *
+ *    ReaK is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with ReaK (as LICENSE in the root folder).
+ *    If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef REAK_MAT_ALG_SQUARE_FIXED_HPP
+#define REAK_MAT_ALG_SQUARE_FIXED_HPP
+
+#include "mat_alg_rectangular_fixed.hpp"
+
+namespace ReaK {
+
+
+template <typename T,
+          unsigned int Size,
+          mat_alignment::tag Alignment>
+struct is_fully_writable_matrix< mat_fix<T,mat_structure::square,Size,Size,Alignment> > {
+  BOOST_STATIC_CONSTANT( bool, value = true );
+  typedef is_fully_writable_matrix< mat_fix<T,mat_structure::square,Size,Size,Alignment> > type;
+};
+
+
+/**
+ * This class template specialization implements a matrix with square structure
+ * and fixed dimensions (Size x Size), for either column-major or row-major alignment.
+ * This class is serializable and registered to the ReaK::rtti system. This matrix type
+ * is not resizable, and its elements are stored in-place (no dynamic allocation).
+ *
+ * Models: ReadableMatrixConcept, WritableMatrixConcept, and FullyWritableMatrixConcept.
+ *
+ * \tparam T Arithmetic type of the elements of the matrix.
+ * \tparam Size The number of rows and columns of the matrix.
+ * \tparam Alignment Enum which defines the memory alignment of the matrix. Either mat_alignment::row_major or mat_alignment::column_major (default).
+ */
+template <typename T,
+          unsigned int Size,
+	  mat_alignment::tag Alignment>
+class mat_fix<T,mat_structure::square,Size,Size,Alignment> : public serialization::serializable {
+  public:
+
+    typedef mat_fix<T,mat_structure::square,Size,Size,Alignment> self;
+    typedef void allocator_type;
+
+    typedef T value_type;
+    typedef void container_type;
+
+    typedef T& reference;
+    typedef const T& const_reference;
+    typedef T* pointer;
+    typedef const T* const_pointer;
+
+    typedef stride_iterator< T*, detail::mat_fix_strides<Alignment,Size,Size>::row_stride > row_iterator;
+    typedef stride_iterator< const T*, detail::mat_fix_strides<Alignment,Size,Size>::row_stride > const_row_iterator;
+    typedef stride_iterator< T*, detail::mat_fix_strides<Alignment,Size,Size>::col_stride > col_iterator;
+    typedef stride_iterator< const T*, detail::mat_fix_strides<Alignment,Size,Size>::col_stride > const_col_iterator;
+
+    typedef unsigned int size_type;
+    typedef int difference_type;
+
+    BOOST_STATIC_CONSTANT(std::size_t, static_row_count = Size);
+    BOOST_STATIC_CONSTANT(std::size_t, static_col_count = Size);
+    BOOST_STATIC_CONSTANT(mat_alignment::tag, alignment = Alignment);
+    BOOST_STATIC_CONSTANT(mat_structure::tag, structure = mat_structure::square);
+
+    template <typename T2, mat_structure::tag Structure2, unsigned int RowCount2, unsigned int ColCount2, mat_alignment::tag Alignment2>
+    friend class mat_fix;
+
+  private:
+    value_type q[Size * Size]; ///< Array which holds all the values of the matrix (dimension: Size x Size).
+
+    typedef detail::mat_fix_strides<Alignment,Size,Size> strides;
+
+    static size_type index(size_type i, size_type j) { return i * strides::row_stride + j * strides::col_stride; };
+
+  public:
+
+/*******************************************************************************
+                         Constructors / Destructors
+*******************************************************************************/
+
+    /**
+     * Default constructor, and constructor for a sized matrix (with the same signature as
+     * the dynamically-sized matrix class).
+     * \param aRowCount The row and column count, must be equal to Size.
+     * \param aFill The value to fill the matrix with.
+     * \throw std::range_error if the given dimension does not match the fixed dimension.
+     * \test PASSED
+     */
+    explicit mat_fix(size_type aRowCount = Size, const value_type& aFill = value_type()) {
+      if(aRowCount != Size)
+	throw std::range_error("Matrix dimensions mismatch.");
+      for(size_type i = 0; i < Size * Size; ++i)
+	q[i] = aFill;
+    };
+
+    /**
+     * Constructor for an identity matrix.
+     * \param aRowCount The row and column count, must be equal to Size.
+     * \param aIdentity If true, the matrix is set to the identity, otherwise, to zero.
+     * \throw std::range_error if the given dimension does not match the fixed dimension.
+     * \test PASSED
+     */
+    mat_fix(size_type aRowCount, bool aIdentity) {
+      if(aRowCount != Size)
+	throw std::range_error("Matrix dimensions mismatch.");
+      for(size_type i = 0; i < Size * Size; ++i)
+	q[i] = value_type(0);
+      if(aIdentity)
+	for(size_type i = 0; i < Size; ++i)
+	  q[i * (Size + 1)] = value_type(1);
+    };
+
+    /**
+     * Standard Copy Constructor with standard semantics.
+     * \test PASSED
+     */
+    mat_fix(const self& M) {
+      for(size_type i = 0; i < Size * Size; ++i)
+	q[i] = M.q[i];
+    };
+
+    /**
+     * Explicit constructor from a any type of matrix.
+     * \throw std::range_error if the dimensions of M do not match the fixed dimensions.
+     * \test PASSED
+     */
+    template <typename Matrix>
+    explicit mat_fix(const Matrix& M, typename boost::enable_if_c< is_readable_matrix<Matrix>::value &&
+                                                                   !(boost::is_same<Matrix,self>::value) , void* >::type dummy = NULL) {
+      if((M.get_row_count() != Size) || (M.get_col_count() != Size))
+	throw std::range_error("Matrix dimensions mismatch.");
+      for(size_type j = 0; j < Size; ++j)
+        for(size_type i = 0; i < Size; ++i)
+	  q[index(i,j)] = M(i,j);
+    };
+
+    /**
+     * Destructor.
+     * \test PASSED
+     */
+    ~mat_fix() { };
+
+    /**
+     * The standard swap function (works with ADL).
+     */
+    friend void swap(self& m1, self& m2) throw() {
+      using std::swap;
+      for(size_type i = 0; i < Size * Size; ++i)
+	swap(m1.q[i],m2.q[i]);
+    };
+
+    /**
+     * Standard assignment operator.
+     * \test PASSED
+     */
+    self& operator=(const self& rhs) {
+      for(size_type i = 0; i < Size * Size; ++i)
+	q[i] = rhs.q[i];
+      return *this;
+    };
+
+/*******************************************************************************
+                         Accessors and Methods
+*******************************************************************************/
+
+    /**
+     * Matrix indexing accessor for read-write access.
+     * \param i Row index.
+     * \param j Column index.
+     * \return the element at the given position.
+     * \test PASSED
+     */
+    reference operator()(size_type i,size_type j) { return q[index(i,j)]; };
+
+    /**
+     * Matrix indexing accessor for read-only access.
+     * \param i Row index.
+     * \param j Column index.
+     * \return the element at the given position.
+     * \test PASSED
+     */
+    const_reference operator()(size_type i,size_type j) const { return q[index(i,j)]; };
+
+    /**
+     * Gets the row-count (number of rows) of the matrix.
+     * \return number of rows of the matrix.
+     * \test PASSED
+     */
+    size_type get_row_count() const throw() { return Size; };
+
+    /**
+     * Gets the column-count (number of columns) of the matrix.
+     * \return number of columns of the matrix.
+     * \test PASSED
+     */
+    size_type get_col_count() const throw() { return Size; };
+
+    /**
+     * Gets the row-count and column-count of the matrix, as a std::pair of values.
+     * \return the row-count and column-count of the matrix, as a std::pair of values.
+     * \test PASSED
+     */
+    std::pair<size_type,size_type> size() const throw() { return std::make_pair(Size,Size); };
+
+    /**
+     * Checks that the given dimensions match the fixed dimensions (a fixed-size matrix cannot be resized).
+     * \param sz new dimensions for the matrix.
+     * \throw std::range_error if the given dimensions do not match the fixed dimensions.
+     */
+    void resize(const std::pair<size_type,size_type>& sz) {
+      if((sz.first != Size) || (sz.second != Size))
+	throw std::range_error("Cannot resize a fixed-size matrix.");
+    };
+
+    /**
+     * Checks that the given row-count matches the fixed row-count (a fixed-size matrix cannot be resized).
+     * \param aRowCount new number of rows for the matrix.
+     * \param aPreserveData Ignored.
+     * \throw std::range_error if the given row-count does not match the fixed row-count.
+     */
+    void set_row_count(size_type aRowCount, bool aPreserveData = false) { RK_UNUSED(aPreserveData);
+      if(aRowCount != Size)
+	throw std::range_error("Cannot resize a fixed-size matrix.");
+    };
+
+    /**
+     * Checks that the given column-count matches the fixed column-count (a fixed-size matrix cannot be resized).
+     * \param aColCount new number of columns for the matrix.
+     * \param aPreserveData Ignored.
+     * \throw std::range_error if the given column-count does not match the fixed column-count.
+     */
+    void set_col_count(size_type aColCount, bool aPreserveData = false) { RK_UNUSED(aPreserveData);
+      if(aColCount != Size)
+	throw std::range_error("Cannot resize a fixed-size matrix.");
+    };
+
+    row_iterator first_row() { return row_iterator(q); };
+    const_row_iterator first_row() const { return const_row_iterator(q); };
+    row_iterator last_row() { return row_iterator(q + Size * strides::row_stride); };
+    const_row_iterator last_row() const { return const_row_iterator(q + Size * strides::row_stride); };
+    row_iterator first_row(col_iterator cit) {
+      return row_iterator(q + ((cit.base() - q) / strides::col_stride) % Size * strides::col_stride);
+    };
+    const_row_iterator first_row(const_col_iterator cit) const {
+      return const_row_iterator(q + ((cit.base() - q) / strides::col_stride) % Size * strides::col_stride);
+    };
+    row_iterator last_row(col_iterator cit) {
+      return row_iterator(q + ((cit.base() - q) / strides::col_stride) % Size * strides::col_stride + Size * strides::row_stride);
+    };
+    const_row_iterator last_row(const_col_iterator cit) const {
+      return const_row_iterator(q + ((cit.base() - q) / strides::col_stride) % Size * strides::col_stride + Size * strides::row_stride);
+    };
+    std::pair<row_iterator,row_iterator> rows() {
+      return std::make_pair(first_row(),last_row());
+    };
+    std::pair<const_row_iterator,const_row_iterator> rows() const {
+      return std::make_pair(first_row(),last_row());
+    };
+    std::pair<row_iterator,row_iterator> rows(col_iterator cit) {
+      return std::make_pair(first_row(cit),last_row(cit));
+    };
+    std::pair<const_row_iterator,const_row_iterator> rows(const_col_iterator cit) const {
+      return std::make_pair(first_row(cit),last_row(cit));
+    };
+
+    col_iterator first_col() { return col_iterator(q); };
+    const_col_iterator first_col() const { return const_col_iterator(q); };
+    col_iterator last_col() { return col_iterator(q + Size * strides::col_stride); };
+    const_col_iterator last_col() const { return const_col_iterator(q + Size * strides::col_stride); };
+    col_iterator first_col(row_iterator rit) {
+      return col_iterator(q + ((rit.base() - q) / strides::row_stride) % Size * strides::row_stride);
+    };
+    const_col_iterator first_col(const_row_iterator rit) const {
+      return const_col_iterator(q + ((rit.base() - q) / strides::row_stride) % Size * strides::row_stride);
+    };
+    col_iterator last_col(row_iterator rit) {
+      return col_iterator(q + ((rit.base() - q) / strides::row_stride) % Size * strides::row_stride + Size * strides::col_stride);
+    };
+    const_col_iterator last_col(const_row_iterator rit) const {
+      return const_col_iterator(q + ((rit.base() - q) / strides::row_stride) % Size * strides::row_stride + Size * strides::col_stride);
+    };
+    std::pair<col_iterator,col_iterator> cols() {
+      return std::make_pair(first_col(),last_col());
+    };
+    std::pair<const_col_iterator,const_col_iterator> cols() const {
+      return std::make_pair(first_col(),last_col());
+    };
+    std::pair<col_iterator,col_iterator> cols(row_iterator rit) {
+      return std::make_pair(first_col(rit),last_col(rit));
+    };
+    std::pair<const_col_iterator,const_col_iterator> cols(const_row_iterator rit) const {
+      return std::make_pair(first_col(rit),last_col(rit));
+    };
+
+    /**
+     * Returns the allocator object of the underlying container (none for a fixed-size matrix).
+     */
+    allocator_type get_allocator() const { };
+
+
+/*******************************************************************************
+                         Assignment Operators
+*******************************************************************************/
+
+    /**
+     * Assignment operator from any matrix type.
+     * \throw std::range_error if the dimensions of M do not match the fixed dimensions.
+     * \test PASSED
+     */
+    template <typename Matrix>
+    typename boost::enable_if_c< is_readable_matrix<Matrix>::value,
+    self& >::type operator =(const Matrix& M) {
+      if((M.get_row_count() != Size) || (M.get_col_count() != Size))
+	throw std::range_error("Matrix dimensions mismatch.");
+      self tmp(M);
+      swap(*this,tmp);
+      return *this;
+    };
+
+    /**
+     * Add-and-store operator with standard semantics.
+     * \test PASSED
+     */
+    template <typename Matrix>
+    typename boost::enable_if_c< is_readable_matrix<Matrix>::value,
+    self& >::type operator +=(const Matrix& M) {
+      if((M.get_row_count() != Size) || (M.get_col_count() != Size))
+	throw std::range_error("Matrix dimension mismatch.");
+      for(size_type j = 0; j < Size; ++j)
+        for(size_type i = 0; i < Size; ++i)
+	  q[index(i,j)] += M(i,j);
+      return *this;
+    };
+
+    /**
+     * Sub-and-store operator with standard semantics.
+     * \test PASSED
+     */
+    template <typename Matrix>
+    typename boost::enable_if_c< is_readable_matrix<Matrix>::value,
+    self& >::type operator -=(const Matrix& M) {
+      if((M.get_row_count() != Size) || (M.get_col_count() != Size))
+	throw std::range_error("Matrix dimension mismatch.");
+      for(size_type j = 0; j < Size; ++j)
+        for(size_type i = 0; i < Size; ++i)
+	  q[index(i,j)] -= M(i,j);
+      return *this;
+    };
+
+    /**
+     * Scalar-multiply-and-store operator with standard semantics.
+     * \test PASSED
+     */
+    self& operator *=(const value_type& S) {
+      for(size_type i = 0; i < Size * Size; ++i)
+        q[i] *= S;
+      return *this;
+    };
+
+    /**
+     * General Matrix multiplication.
+     * \test PASSED
+     */
+    template <typename Matrix>
+    typename boost::enable_if_c< is_readable_matrix<Matrix>::value,
+    self& >::type operator *=(const Matrix& M) {
+      *this = *this * M;
+      return *this;
+    };
+
+    /**
+     * Negation operator.
+     * \test PASSED
+     */
+    self operator -() const {
+      self result;
+      for(size_type i = 0; i < Size * Size; ++i)
+        result.q[i] = -q[i];
+      return result;
+    };
+
+    /**
+     * Transposes a matrix by switching its alignment, which amounts to a plain copy of the elements.
+     * \test PASSED
+     */
+    friend mat_fix<T,mat_structure::square,Size,Size,(Alignment == mat_alignment::column_major ? mat_alignment::row_major : mat_alignment::column_major)> transpose(const self& M) {
+      mat_fix<T,mat_structure::square,Size,Size,(Alignment == mat_alignment::column_major ? mat_alignment::row_major : mat_alignment::column_major)> result;
+      for(size_type i = 0; i < Size * Size; ++i)
+	result.q[i] = M.q[i];
+      return result;
+    };
+
+    /**
+     * Transposes a matrix by switching its alignment, which amounts to a plain copy of the elements.
+     * \test PASSED
+     */
+    friend mat_fix<T,mat_structure::square,Size,Size,(Alignment == mat_alignment::column_major ? mat_alignment::row_major : mat_alignment::column_major)> transpose_move(self& M) {
+      return transpose(M);
+    };
+
+    /**
+     * Extracts the trace of matrix M.
+     * \param M A matrix.
+     * \return the trace of matrix M.
+     */
+    friend value_type trace(const self& M) {
+      value_type sum = value_type(0);
+      for(size_type i = 0; i < Size; ++i)
+	sum += M.q[i * (Size + 1)];
+      return sum;
+    };
+
+
+/*******************************************************************************
+                   ReaK's RTTI and Serialization interfaces
+*******************************************************************************/
+
+    virtual void RK_CALL save(serialization::oarchive& A, unsigned int) const {
+      for(size_type i = 0; i < Size * Size; ++i)
+        A & std::pair<std::string, typename ReaK::rtti::get_type_id<T>::save_type >("q",q[i]);
+    };
+    virtual void RK_CALL load(serialization::iarchive& A, unsigned int) {
+      for(size_type i = 0; i < Size * Size; ++i)
+        A & std::pair<std::string, typename ReaK::rtti::get_type_id<T>::load_type >("q",q[i]);
+    };
+
+    RK_RTTI_REGISTER_CLASS_1BASE(self,1,serialization::serializable)
+
+};
+
+
+
+};
+
+
+#endif
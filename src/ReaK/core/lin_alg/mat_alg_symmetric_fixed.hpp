@@ -0,0 +1,406 @@
+/**
+ * \file mat_alg_symmetric_fixed.hpp
+ *
+ * This library implements the specialization of the mat_fix<> template for a
+ * symmetric matrix (fixed dimensions). This matrix type fulfills the Readable
+ * and Writable matrix concepts. Only the lower (or upper) triangular part is
+ * stored, in a packed array of Size * (Size + 1) / 2 elements held in-place.
+ *
+ * \author Mikael Persson <mikael.s.persson@gmail.com>
+ * \date june 2013
+ */
+
+/*
+ *    Copyright 2013 Sven Mikael Persson
+ *
+ *    THIS SOFTWARE IS DISTRIBUTED UNDER THE TERMS OF THE GNU GENERAL PUBLIC LICENSE v3 (GPLv3).
+ *
+ *    This file is part of ReaK.
+ *
+ *    ReaK is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    (at your option) any later version.
+ *
+ *    ReaK is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with ReaK (as LICENSE in the root folder).
+ *    If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef REAK_MAT_ALG_SYMMETRIC_FIXED_HPP
+#define REAK_MAT_ALG_SYMMETRIC_FIXED_HPP
+
+#include "mat_alg_general.hpp"
+
+namespace ReaK {
+
+
+/**
+ * This class template specialization implements a matrix with symmetric structure
+ * and fixed dimensions (Size x Size). This class is serializable and registered to
+ * the ReaK::rtti system. This matrix type is not resizable, and its elements are
+ * stored in-place (no dynamic allocation).
+ *
+ * Models: ReadableMatrixConcept and WritableMatrixConcept.
+ *
+ * \tparam T Arithmetic type of the elements of the matrix.
+ * \tparam Size The number of rows and columns of the matrix.
+ * \tparam Alignment Enum which defines the memory alignment of the matrix (has no effect).
+ */
+template <typename T,
+          unsigned int Size,
+	  mat_alignment::tag Alignment>
+class mat_fix<T,mat_structure::symmetric,Size,Size,Alignment> : public serialization::serializable {
+  public:
+
+    typedef mat_fix<T,mat_structure::symmetric,Size,Size,Alignment> self;
+    typedef void allocator_type;
+
+    typedef T value_type;
+    typedef void container_type;
+
+    typedef T& reference;
+    typedef const T& const_reference;
+    typedef T* pointer;
+    typedef const T* const_pointer;
+
+    typedef void col_iterator;
+    typedef void const_col_iterator;
+    typedef void row_iterator;
+    typedef void const_row_iterator;
+
+    typedef unsigned int size_type;
+    typedef int difference_type;
+
+    BOOST_STATIC_CONSTANT(std::size_t, static_row_count = Size);
+    BOOST_STATIC_CONSTANT(std::size_t, static_col_count = Size);
+    BOOST_STATIC_CONSTANT(mat_alignment::tag, alignment = Alignment);
+    BOOST_STATIC_CONSTANT(mat_structure::tag, structure = mat_structure::symmetric);
+
+  private:
+    value_type q[(Size * (Size + 1)) / 2]; ///< Holds the packed array of scalar entries.
+
+    static size_type index(size_type i, size_type j) {
+      if(i > j)
+	return (i * (i + 1)) / 2 + j;
+      else
+	return (j * (j + 1)) / 2 + i;
+    };
+
+  public:
+
+/*******************************************************************************
+                         Constructors / Destructors
+*******************************************************************************/
+
+    /**
+     * Default constructor, and constructor for a sized matrix (with the same signature as
+     * the dynamically-sized matrix class).
+     * \param aRowCount The row and column count, must be equal to Size.
+     * \param aFill The value to fill the matrix with.
+     * \throw std::range_error if the given dimension does not match the fixed dimension.
+     * \test PASSED
+     */
+    explicit mat_fix(size_type aRowCount = Size, const value_type& aFill = value_type()) {
+      if(aRowCount != Size)
+	throw std::range_error("Matrix dimensions mismatch.");
+      for(size_type i = 0; i < (Size * (Size + 1)) / 2; ++i)
+	q[i] = aFill;
+    };
+
+    /**
+     * Constructor for an identity matrix.
+     * \param aRowCount The row and column count, must be equal to Size.
+     * \param aIdentity If true, the matrix is set to the identity, otherwise, to zero.
+     * \throw std::range_error if the given dimension does not match the fixed dimension.
+     * \test PASSED
+     */
+    mat_fix(size_type aRowCount, bool aIdentity) {
+      if(aRowCount != Size)
+	throw std::range_error("Matrix dimensions mismatch.");
+      for(size_type i = 0; i < (Size * (Size + 1)) / 2; ++i)
+	q[i] = value_type(0);
+      if(aIdentity)
+	for(size_type i = 0; i < Size; ++i)
+	  q[index(i,i)] = value_type(1);
+    };
+
+    /**
+     * Standard Copy Constructor with standard semantics.
+     * \test PASSED
+     */
+    mat_fix(const self& M) {
+      for(size_type i = 0; i < (Size * (Size + 1)) / 2; ++i)
+	q[i] = M.q[i];
+    };
+
+    /**
+     * Explicit constructor from any type of matrix. The "(M + M.transpose) / 2" is applied to guarantee symmetry.
+     * \throw std::range_error if the dimensions of M do not match the fixed dimensions.
+     * \test PASSED
+     */
+    template <typename Matrix>
+    explicit mat_fix(const Matrix& M, typename boost::enable_if<
+                                                 boost::mpl::and_<
+                                                   is_readable_matrix<Matrix>,
+		                                   boost::mpl::not_< is_symmetric_matrix<Matrix> >
+		                                 >, void* >::type dummy = NULL) {
+      if((M.get_row_count() != Size) || (M.get_col_count() != Size))
+	throw std::range_error("Matrix dimensions mismatch.");
+      for(size_type i = 0; i < Size; ++i) {
+	for(size_type j = 0; j < i; ++j)
+	  q[index(i,j)] = value_type(0.5) * (M(j,i) + M(i,j));
+	q[index(i,i)] = M(i,i);
+      };
+    };
+
+    /**
+     * Explicit constructor from any type of symmetric matrix.
+     * \throw std::range_error if the dimensions of M do not match the fixed dimensions.
+     * \test PASSED
+     */
+    template <typename Matrix>
+    explicit mat_fix(const Matrix& M, typename boost::enable_if<
+                                                 boost::mpl::and_<
+                                                   is_readable_matrix<Matrix>,
+		                                   is_symmetric_matrix<Matrix>,
+		                                   boost::mpl::not_< boost::is_same<Matrix,self> >
+		                                 >, void* >::type dummy = NULL) {
+      if(M.get_row_count() != Size)
+	throw std::range_error("Matrix dimensions mismatch.");
+      for(size_type i = 0; i < Size; ++i)
+	for(size_type j = 0; j <= i; ++j)
+	  q[index(i,j)] = M(i,j);
+    };
+
+    /**
+     * Destructor.
+     * \test PASSED
+     */
+    ~mat_fix() { };
+
+    /**
+     * The standard swap function (works with ADL).
+     */
+    friend void swap(self& M1, self& M2) throw() {
+      using std::swap;
+      for(size_type i = 0; i < (Size * (Size + 1)) / 2; ++i)
+	swap(M1.q[i],M2.q[i]);
+    };
+
+/*******************************************************************************
+                         Accessors and Methods
+*******************************************************************************/
+
+    /**
+     * Matrix indexing accessor for read-write access.
+     * \param i Row index.
+     * \param j Column index.
+     * \return the element at the given position.
+     * \test PASSED
+     */
+    reference operator()(size_type i,size_type j) { return q[index(i,j)]; };
+
+    /**
+     * Matrix indexing accessor for read-only access.
+     * \param i Row index.
+     * \param j Column index.
+     * \return the element at the given position.
+     * \test PASSED
+     */
+    const_reference operator()(size_type i,size_type j) const { return q[index(i,j)]; };
+
+    /**
+     * Gets the row-count (number of rows) of the matrix.
+     * \return number of rows of the matrix.
+     * \test PASSED
+     */
+    size_type get_row_count() const throw() { return Size; };
+
+    /**
+     * Gets the column-count (number of columns) of the matrix.
+     * \return number of columns of the matrix.
+     * \test PASSED
+     */
+    size_type get_col_count() const throw() { return Size; };
+
+    /**
+     * Gets the row-count and column-count of the matrix, as a std::pair of values.
+     * \return the row-count and column-count of the matrix, as a std::pair of values.
+     * \test PASSED
+     */
+    std::pair<size_type,size_type> size() const throw() { return std::make_pair(Size,Size); };
+
+    /**
+     * Checks that the given dimensions match the fixed dimensions (a fixed-size matrix cannot be resized).
+     * \param sz new dimensions for the matrix.
+     * \throw std::range_error if the given dimensions do not match the fixed dimensions.
+     */
+    void resize(const std::pair<size_type,size_type>& sz) {
+      if((sz.first != Size) || (sz.second != Size))
+	throw std::range_error("Cannot resize a fixed-size matrix.");
+    };
+
+    /**
+     * Checks that the given row-count matches the fixed row-count (a fixed-size matrix cannot be resized).
+     * \param aRowCount new number of rows for the matrix.
+     * \param aPreserveData Ignored.
+     * \throw std::range_error if the given row-count does not match the fixed row-count.
+     */
+    void set_row_count(size_type aRowCount, bool aPreserveData = false) { RK_UNUSED(aPreserveData);
+      if(aRowCount != Size)
+	throw std::range_error("Cannot resize a fixed-size matrix.");
+    };
+
+    /**
+     * Checks that the given column-count matches the fixed column-count (a fixed-size matrix cannot be resized).
+     * \param aColCount new number of columns for the matrix.
+     * \param aPreserveData Ignored.
+     * \throw std::range_error if the given column-count does not match the fixed column-count.
+     */
+    void set_col_count(size_type aColCount, bool aPreserveData = false) { RK_UNUSED(aPreserveData);
+      if(aColCount != Size)
+	throw std::range_error("Cannot resize a fixed-size matrix.");
+    };
+
+    /**
+     * Returns the allocator object of the underlying container (none for a fixed-size matrix).
+     */
+    allocator_type get_allocator() const { };
+
+/*******************************************************************************
+                         Assignment Operators
+*******************************************************************************/
+
+    /**
+     * Standard Assignment operator with a symmetric matrix.
+     * \test PASSED
+     */
+    self& operator =(const self& M) {
+      for(size_type i = 0; i < (Size * (Size + 1)) / 2; ++i)
+	q[i] = M.q[i];
+      return *this;
+    };
+
+    /**
+     * Standard Assignment operator with a matrix of any type. The "(M + M.transpose) / 2" formula is applied to guarantee symmetry.
+     * \test PASSED
+     */
+    template <typename Matrix>
+    typename boost::enable_if_c< is_readable_matrix<Matrix>::value,
+    self& >::type operator =(const Matrix& M) {
+      self tmp(M);
+      swap(*this,tmp);
+      return *this;
+    };
+
+    /**
+     * Add-and-store operator with a symmetric matrix.
+     * \test PASSED
+     */
+    template <typename Matrix>
+    typename boost::enable_if_c< is_readable_matrix<Matrix>::value && is_symmetric_matrix<Matrix>::value,
+    self& >::type operator +=(const Matrix& M) {
+      if(M.get_row_count() != Size)
+	throw std::range_error("Matrix dimension mismatch.");
+      for(size_type i = 0; i < Size; ++i)
+	for(size_type j = 0; j <= i; ++j)
+	  q[index(i,j)] += M(i,j);
+      return *this;
+    };
+
+    /**
+     * Sub-and-store operator with a symmetric matrix.
+     * \test PASSED
+     */
+    template <typename Matrix>
+    typename boost::enable_if_c< is_readable_matrix<Matrix>::value && is_symmetric_matrix<Matrix>::value,
+    self& >::type operator -=(const Matrix& M) {
+      if(M.get_row_count() != Size)
+	throw std::range_error("Matrix dimension mismatch.");
+      for(size_type i = 0; i < Size; ++i)
+	for(size_type j = 0; j <= i; ++j)
+	  q[index(i,j)] -= M(i,j);
+      return *this;
+    };
+
+    /**
+     * Scalar-multiply-and-store operator with standard semantics.
+     * \test PASSED
+     */
+    self& operator *=(const value_type& S) {
+      for(size_type i = 0; i < (Size * (Size + 1)) / 2; ++i)
+        q[i] *= S;
+      return *this;
+    };
+
+    /**
+     * Negation operator.
+     * \test PASSED
+     */
+    self operator -() const {
+      self result;
+      for(size_type i = 0; i < (Size * (Size + 1)) / 2; ++i)
+        result.q[i] = -q[i];
+      return result;
+    };
+
+    /**
+     * Transposes the matrix M (which is the same as M).
+     * \param M The symmetric matrix to be transposed.
+     * \return The transpose of M.
+     */
+    friend const self& transpose(const self& M) {
+      return M;
+    };
+
+    /**
+     * Transposes the matrix M (which is the same as M).
+     * \param M The symmetric matrix to be transposed.
+     * \return The transpose of M.
+     */
+    friend self transpose_move(self& M) {
+      return M;
+    };
+
+    /**
+     * Extracts the trace of matrix M.
+     * \param M A matrix.
+     * \return the trace of matrix M.
+     */
+    friend value_type trace(const self& M) {
+      value_type sum = value_type(0);
+      for(size_type i = 0; i < Size; ++i)
+	sum += M.q[index(i,i)];
+      return sum;
+    };
+
+
+/*******************************************************************************
+                   ReaK's RTTI and Serialization interfaces
+*******************************************************************************/
+
+    virtual void RK_CALL save(serialization::oarchive& A, unsigned int) const {
+      for(size_type i = 0; i < (Size * (Size + 1)) / 2; ++i)
+        A & std::pair<std::string, typename ReaK::rtti::get_type_id<T>::save_type >("q",q[i]);
+    };
+    virtual void RK_CALL load(serialization::iarchive& A, unsigned int) {
+      for(size_type i = 0; i < (Size * (Size + 1)) / 2; ++i)
+        A & std::pair<std::string, typename ReaK::rtti::get_type_id<T>::load_type >("q",q[i]);
+    };
+
+    RK_RTTI_REGISTER_CLASS_1BASE(self,1,serialization::serializable)
+
+};
+
+
+
+};
+
+
+#endif
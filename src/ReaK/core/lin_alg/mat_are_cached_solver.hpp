@@ -0,0 +1,252 @@
+/**
+ * \file mat_are_cached_solver.hpp
+ *
+ * This library provides a class template to solve a sequence of related Algebraic Riccati
+ * Equations (AREs), as arise from the linearization of a non-linear system at different
+ * state-space points, by caching the solutions at the previously solved linearization points
+ * and warm-starting Newton-Kleinman iterations from the solution at the nearest cached point.
+ *
+ * \author Sven Mikael Persson <mikael.s.persson@gmail.com>
+ * \date June 2013
+ */
+
+/*
+ *    Copyright 2013 Sven Mikael Persson
+ *
+ *    THIS SOFTWARE IS DISTRIBUTED UNDER THE TERMS OF THE GNU GENERAL PUBLIC LICENSE v3 (GPLv3).
+ *
+ *    This file is part of ReaK.
+ *
+ *    ReaK is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    (at your option) any later version.
+ *
+ *    ReaK is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with ReaK (as LICENSE in the root folder).
+ *    If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef REAK_MAT_ARE_CACHED_SOLVER_HPP
+#define REAK_MAT_ARE_CACHED_SOLVER_HPP
+
+#include "mat_are_solver.hpp"
+
+#include <list>
+#include <limits>
+
+namespace ReaK {
+
+
+/**
+ * This class template is used to solve the Infinite-horizon Continuous-time Affine Quadratic
+ * Regulator (AQR) problem (see solve_IHCT_AQR) repeatedly for the linearizations of a system
+ * at different points (keys). The solutions (P,K) at the most recently solved points are kept
+ * in a bounded cache. When a new problem is posed, the nearest cached point (according to
+ * the distance functor given) is retrieved and, if it is within the key tolerance and its
+ * linearization (A,B) is within the model tolerance of the new one, the CARE solution is
+ * obtained by Newton-Kleinman iterations warm-started from the cached solution
+ * (see solve_care_newton_kleinman). Otherwise, or if the iterations fail to converge, the
+ * full QZ-based solution (see solve_care_problem) is computed.
+ * \n
+ * The cost matrices Q and R are assumed to be the same for all the problems posed to a given
+ * solver object, call clear() if they change. Also note that this class is not thread-safe,
+ * each thread should use its own solver object.
+ *
+ * \tparam KeyType The type of the linearization points used to index the cache.
+ * \tparam T The value-type of the matrices.
+ */
+template <typename KeyType, typename T = double>
+class IHCT_AQR_cached_solver {
+  public:
+    typedef IHCT_AQR_cached_solver<KeyType,T> self;
+    typedef T value_type;
+    typedef std::size_t size_type;
+
+  private:
+    struct cache_entry {
+      KeyType key;
+      mat<T,mat_structure::square> A;
+      mat<T,mat_structure::rectangular> B;
+      mat<T,mat_structure::square> P;
+    };
+
+    std::list< cache_entry > m_entries; // most-recently used entries first.
+    size_type m_capacity;
+    T m_key_tolerance;
+    T m_model_tolerance;
+    T m_NK_tolerance;
+    size_type m_NK_max_iter;
+
+    size_type m_warm_solves;
+    size_type m_full_solves;
+
+  public:
+
+    /**
+     * Default constructor.
+     * \param aCapacity The maximum number of solutions kept in the cache.
+     * \param aKeyTolerance The maximum distance between keys for a cached solution to be used as warm-start.
+     * \param aModelTolerance The maximum relative difference (1-norm) between the (A,B) matrices for a cached solution to be used as warm-start.
+     * \param aNKTolerance The relative tolerance for the convergence of the Newton-Kleinman iterations.
+     * \param aNKMaxIter The maximum number of Newton-Kleinman iterations before reverting to the full solution.
+     */
+    IHCT_AQR_cached_solver(size_type aCapacity = 64,
+                           T aKeyTolerance = std::numeric_limits<T>::infinity(),
+                           T aModelTolerance = T(0.1),
+                           T aNKTolerance = T(1e-6),
+                           size_type aNKMaxIter = 8) :
+                           m_entries(), m_capacity(aCapacity),
+                           m_key_tolerance(aKeyTolerance), m_model_tolerance(aModelTolerance),
+                           m_NK_tolerance(aNKTolerance), m_NK_max_iter(aNKMaxIter),
+                           m_warm_solves(0), m_full_solves(0) { };
+
+    /**
+     * Solves the IHCT AQR problem, see solve_IHCT_AQR, for the linearization at a given point.
+     * \param x The linearization point, used as the key to the cache.
+     * \param dist The distance functor between keys, called as dist(x1, x2).
+     * \param A square (n x n) matrix which represents state-to-state-derivative linear map.
+     * \param B rectangular (n x m) matrix which represents input-to-state-derivative linear map.
+     * \param c a readable vector (n) which represents the constant term of the state-derivative expression.
+     * \param Q square (n x n) positive-definite matrix which represents quadratic state-error penalty.
+     * \param R square (m x m) positive-definite matrix which represents quadratic input penalty.
+     * \param K holds as output, the (mxn) LQR-optimal gain matrix for u = - K * (x_cur - x_ref).
+     * \param P holds as output, the (nxn) nonnegative definite solution to the CARE problem.
+     * \param u_bias holds as output, the constant input term to apply to the system in addition to the feedback term (K * (x_cur - x_ref)).
+     * \param NumTol tolerance for considering a value to be zero in avoiding divisions
+     *               by zero and singularities.
+     * \param UseBalancing specifies whether balancing should be applied for the full solution of the CARE problem.
+     *
+     * \throws std::range_error if the matrix dimensions are not consistent.
+     * \throws singularity_error if the CARE problem cannot be solved, usually because the system is not stabilizable.
+     */
+    template <typename KeyDistance, typename Matrix1, typename Matrix2, typename Vector1, typename Matrix3,
+              typename Matrix4, typename Matrix5, typename Matrix6, typename Vector2>
+    void solve(const KeyType& x, KeyDistance dist,
+               const Matrix1& A, const Matrix2& B, const Vector1& c,
+               const Matrix3& Q, const Matrix4& R,
+               Matrix5& K, Matrix6& P, Vector2& u_bias,
+               T NumTol = T(1E-8), bool UseBalancing = false) {
+      typename std::list< cache_entry >::iterator best_it = m_entries.end();
+      T best_dist = std::numeric_limits<T>::infinity();
+      for(typename std::list< cache_entry >::iterator it = m_entries.begin(); it != m_entries.end(); ++it) {
+        if((it->A.get_row_count() != A.get_row_count()) || (it->B.get_col_count() != B.get_col_count()))
+          continue;
+        T d = dist(x, it->key);
+        if(d < best_dist) {
+          best_dist = d;
+          best_it = it;
+        };
+      };
+
+      bool solved = false;
+      if((best_it != m_entries.end()) && (best_dist <= m_key_tolerance)) {
+        T dA = norm_1(A - best_it->A);
+        T dB = norm_1(B - best_it->B);
+        T sA = norm_1(A);
+        T sB = norm_1(B);
+        if((dA <= m_model_tolerance * sA) && (dB <= m_model_tolerance * sB)) {
+          P = best_it->P;
+          solved = solve_care_newton_kleinman(A, B, Q, R, P, m_NK_tolerance, m_NK_max_iter);
+          if(solved)
+            ++m_warm_solves;
+        };
+        // move the nearest entry to the front, it is the most recently used.
+        m_entries.splice(m_entries.begin(), m_entries, best_it);
+      };
+
+      if(!solved) {
+        solve_care_problem(A, B, Q, R, P, NumTol, UseBalancing);
+        ++m_full_solves;
+      };
+
+      detail::compute_IHCT_AQR_gains_impl(A, B, c, R, P, K, u_bias);
+
+      if(m_capacity == 0)
+        return;
+      if(best_it != m_entries.end() && best_dist == T(0.0)) {
+        // same key, just refresh the solution.
+        best_it->A = A;
+        best_it->B = B;
+        best_it->P = P;
+        return;
+      };
+      m_entries.push_front(cache_entry());
+      m_entries.front().key = x;
+      m_entries.front().A = A;
+      m_entries.front().B = B;
+      m_entries.front().P = P;
+      while(m_entries.size() > m_capacity)
+        m_entries.pop_back();
+    };
+
+    /**
+     * Clears all the cached solutions.
+     */
+    void clear() { m_entries.clear(); };
+
+    /**
+     * Returns the number of cached solutions.
+     */
+    size_type size() const { return m_entries.size(); };
+
+    /**
+     * Sets the maximum number of solutions kept in the cache (0 disables the caching).
+     */
+    void set_capacity(size_type aCapacity) {
+      m_capacity = aCapacity;
+      while(m_entries.size() > m_capacity)
+        m_entries.pop_back();
+    };
+    /**
+     * Returns the maximum number of solutions kept in the cache.
+     */
+    size_type get_capacity() const { return m_capacity; };
+
+    /**
+     * Sets the maximum distance between keys for a cached solution to be used as warm-start.
+     */
+    void set_key_tolerance(T aKeyTolerance) { m_key_tolerance = aKeyTolerance; };
+    /**
+     * Returns the maximum distance between keys for a cached solution to be used as warm-start.
+     */
+    T get_key_tolerance() const { return m_key_tolerance; };
+
+    /**
+     * Sets the maximum relative difference between the (A,B) matrices for a cached solution to be used as warm-start.
+     */
+    void set_model_tolerance(T aModelTolerance) { m_model_tolerance = aModelTolerance; };
+    /**
+     * Returns the maximum relative difference between the (A,B) matrices for a cached solution to be used as warm-start.
+     */
+    T get_model_tolerance() const { return m_model_tolerance; };
+
+    /**
+     * Sets the relative tolerance and the maximum number of iterations of the Newton-Kleinman iterations.
+     */
+    void set_newton_kleinman_parameters(T aNKTolerance, size_type aNKMaxIter) {
+      m_NK_tolerance = aNKTolerance;
+      m_NK_max_iter = aNKMaxIter;
+    };
+
+    /**
+     * Returns the number of problems that were solved by warm-started Newton-Kleinman iterations.
+     */
+    size_type get_warm_solve_count() const { return m_warm_solves; };
+    /**
+     * Returns the number of problems that required the full (QZ-based) solution.
+     */
+    size_type get_full_solve_count() const { return m_full_solves; };
+
+};
+
+
+};
+
+#endif
+
@@ -39,12 +39,15 @@
 #include "mat_householder.hpp"
 #include "mat_hess_decomp.hpp"
 #include "mat_schur_decomp.hpp"
+#include "mat_gaussian_elim.hpp"
 
 #include "mat_ctrl_decomp.hpp"
 
 #include "mat_norms.hpp"
 #include "mat_balance.hpp"
 
+#include <vector>
+
 namespace ReaK {
   
 
@@ -1396,6 +1399,218 @@ void partition_schur_pencil_impl(Matrix1& A, Matrix2& B, Matrix3* Q, Matrix4* Z,
 
 
 
+
+/*
+ * This class holds the storage for the augmented pencils, their generalized Schur factors and 
+ * the balancing exponents used by the CARE / DARE solvers. The storage is allocated for a 
+ * given (n,m) problem size and reused from one solution to the next (see care_solver and dare_solver).
+ */
+template <typename T>
+struct are_pencil_workspace {
+  typedef std::size_t size_type;
+  
+  size_type N;
+  size_type M;
+  mat<T, mat_structure::rectangular> R_tmp;  // (2n+m x m)
+  mat<T, mat_structure::square> Q_tmp;       // (2n+m x 2n+m)
+  mat<T, mat_structure::rectangular> A_aug;  // (2n x 2n)
+  mat<T, mat_structure::rectangular> B_aug;  // (2n x 2n)
+  mat<T, mat_structure::square> Q_aug;       // (2n x 2n)
+  mat<T, mat_structure::square> Z_aug;       // (2n x 2n)
+  vect_n<int> Dl_aug;
+  vect_n<int> Dr_aug;
+  
+  explicit are_pencil_workspace(size_type aN = 0, size_type aM = 0) :
+    N(aN), M(aM), 
+    R_tmp(2 * aN + aM, aM), Q_tmp(2 * aN + aM), 
+    A_aug(2 * aN, 2 * aN), B_aug(2 * aN, 2 * aN),
+    Q_aug(2 * aN), Z_aug(2 * aN), 
+    Dl_aug(2 * aN), Dr_aug(2 * aN) { };
+  
+  void resize(size_type aN, size_type aM) {
+    if((aN == N) && (aM == M))
+      return;
+    *this = are_pencil_workspace<T>(aN, aM);
+  };
+  
+  /* Resets the workspace to its initial state: R_tmp = 0, Q_tmp = the block-rotation (0 I_2n; I_m 0), Q_aug = Z_aug = I. */
+  void reset() {
+    size_type NA = 2 * N + M;
+    for(size_type j = 0; j < M; ++j)
+      for(size_type i = 0; i < NA; ++i)
+        R_tmp(i,j) = T(0.0);
+    for(size_type j = 0; j < NA; ++j)
+      for(size_type i = 0; i < NA; ++i)
+        Q_tmp(i,j) = T(0.0);
+    for(size_type i = 0; i < 2 * N; ++i)
+      Q_tmp(i, M + i) = T(1.0);
+    for(size_type i = 0; i < M; ++i)
+      Q_tmp(2 * N + i, i) = T(1.0);
+    for(size_type j = 0; j < 2 * N; ++j) {
+      for(size_type i = 0; i < 2 * N; ++i) {
+        Q_aug(i,j) = T(0.0);
+        Z_aug(i,j) = T(0.0);
+      };
+      Q_aug(j,j) = T(1.0);
+      Z_aug(j,j) = T(1.0);
+    };
+  };
+  
+  /* Transposes Q_tmp in-place. */
+  void transpose_Q_tmp() {
+    using std::swap;
+    size_type NA = 2 * N + M;
+    for(size_type j = 1; j < NA; ++j)
+      for(size_type i = 0; i < j; ++i)
+        swap(Q_tmp(i,j), Q_tmp(j,i));
+  };
+};
+
+
+template <typename Matrix1, typename Matrix2, typename Matrix3, typename Matrix4, typename Matrix5>
+void solve_care_problem_impl(const Matrix1& A, const Matrix2& B, 
+                             const Matrix3& Q, const Matrix4& R, Matrix5& P, 
+                             typename mat_traits<Matrix1>::value_type NumTol, bool UseBalancing,
+                             are_pencil_workspace< typename mat_traits<Matrix1>::value_type >& ws) {
+  typedef typename mat_traits<Matrix1>::value_type ValueType;
+  typedef typename mat_traits<Matrix1>::size_type SizeType;
+  SizeType N = A.get_row_count();
+  SizeType M = R.get_row_count();
+  if((N == 0) || (M == 0))
+    return;
+  
+  ws.resize(N, M);
+  ws.reset();
+  
+  sub(ws.R_tmp)(range(0,M-1), range(0,M-1)) = R;
+  sub(ws.R_tmp)(range(M,M + N - 1), range(0,M-1)) = B;
+  
+  decompose_QR_impl(ws.R_tmp, &ws.Q_tmp, NumTol);
+  ws.transpose_Q_tmp();
+  
+  sub(ws.B_aug)(range(0,2*N - 1), range(0,2*N - 1)) = sub(ws.Q_tmp)(range(M,M + 2*N - 1), range(0,2*N - 1));
+  
+  sub(ws.A_aug)(range(0,2 * N - 1),range(0, N - 1)) = 
+      sub(ws.Q_tmp)(range(M,M + 2*N-1),range(0,N-1)) * A
+    - sub(ws.Q_tmp)(range(M,M + 2*N-1),range(N,2*N-1)) * Q;
+  sub(ws.A_aug)(range(0,2 * N - 1),range(N, 2*N - 1)) = 
+      sub(ws.Q_tmp)(range(M,M + 2*N-1),range(2*N,2*N+M-1)) * transpose_view(B)
+    - sub(ws.Q_tmp)(range(M,M + 2*N-1),range(N,2*N-1)) * transpose_view(A);
+  
+  bool should_interchange = false;
+  if(norm_1(ws.A_aug) > norm_1(ws.B_aug))
+    should_interchange = true;
+  
+  if(UseBalancing)
+    balance_pencil(ws.A_aug,ws.B_aug,ws.Dl_aug,ws.Dr_aug);
+  
+  if(should_interchange)
+    gen_schur_decomp_impl(ws.B_aug,ws.A_aug,&ws.Q_aug,&ws.Z_aug,NumTol);
+  else
+    gen_schur_decomp_impl(ws.A_aug,ws.B_aug,&ws.Q_aug,&ws.Z_aug,NumTol);
+  
+  if(should_interchange)
+    partition_schur_pencil_impl(ws.B_aug,ws.A_aug,&ws.Q_aug,&ws.Z_aug,neg_real_val_eigen_first(),NumTol);
+  else
+    partition_schur_pencil_impl(ws.A_aug,ws.B_aug,&ws.Q_aug,&ws.Z_aug,neg_real_val_eigen_first(),NumTol);
+  
+  P.set_row_count(N);
+  P.set_col_count(N);
+  mat_sub_block< mat<ValueType, mat_structure::square> > subZ11(ws.Z_aug, N, N, 0, 0);
+  mat_sub_block< mat<ValueType, mat_structure::square> > subZ21(ws.Z_aug, N, N, N, 0);
+  try {
+    linlsq_QR(transpose_view(subZ11), P, transpose_view(subZ21), NumTol);
+  } catch(singularity_error& e) {
+    throw singularity_error("The Continuous-time Algebraic Riccati Equation (CARE) cannot be solved! Usually indicates that the system is not stabilizable.");
+  };
+  
+  if(UseBalancing) {
+    apply_left_bal_inv_exp(sub(ws.Dr_aug)[range(0,N-1)], P);
+    apply_right_bal_exp(P, sub(ws.Dr_aug)[range(N,2*N-1)]);
+  };
+  
+  for(SizeType j = 1; j < N; ++j) {
+    for(SizeType i = 0; i < j; ++i) {
+      ValueType tmp = ValueType(0.5) * (P(i,j) + P(j,i));
+      P(i,j) = tmp;
+      P(j,i) = tmp;
+    };
+  };
+};
+
+
+template <typename Matrix1, typename Matrix2, typename Matrix3, typename Matrix4, typename Matrix5>
+void solve_dare_problem_impl(const Matrix1& F, const Matrix2& G, 
+                             const Matrix3& Q, const Matrix4& R, Matrix5& P, 
+                             typename mat_traits<Matrix1>::value_type NumTol, bool UseBalancing,
+                             are_pencil_workspace< typename mat_traits<Matrix1>::value_type >& ws) {
+  typedef typename mat_traits<Matrix1>::value_type ValueType;
+  typedef typename mat_traits<Matrix1>::size_type SizeType;
+  SizeType N = F.get_row_count();
+  SizeType M = R.get_row_count();
+  
+  ws.resize(N, M);
+  ws.reset();
+  
+  sub(ws.R_tmp)(range(0,M-1), range(0,M-1)) = R;
+  sub(ws.R_tmp)(range(M,M + N - 1), range(0,M-1)) = -G;
+  
+  decompose_QR_impl(ws.R_tmp, &ws.Q_tmp, NumTol);
+  ws.transpose_Q_tmp();
+  
+  sub(ws.B_aug)(range(0,2 * N - 1),range(0, N - 1)) = sub(ws.Q_tmp)(range(M,M + 2*N-1),range(0,N-1));
+  sub(ws.B_aug)(range(0,2 * N - 1),range(N, 2*N - 1)) = 
+      sub(ws.Q_tmp)(range(M,M + 2*N-1),range(N,2*N-1)) * transpose_view(F)
+    + sub(ws.Q_tmp)(range(M,M + 2*N-1),range(2*N,2*N+M-1)) * transpose_view(G);
+  
+  sub(ws.A_aug)(range(0,2 * N - 1),range(0, N - 1)) = 
+      sub(ws.Q_tmp)(range(M,M + 2*N-1),range(0,N-1)) * F
+    - sub(ws.Q_tmp)(range(M,M + 2*N-1),range(N,2*N-1)) * Q;
+  sub(ws.A_aug)(range(0,2 * N - 1),range(N, 2*N - 1)) = sub(ws.Q_tmp)(range(M,M + 2*N-1),range(N,2*N-1));
+  
+  bool should_interchange = false;
+  if(norm_1(ws.A_aug) > norm_1(ws.B_aug))
+    should_interchange = true;
+  
+  if(UseBalancing)
+    balance_pencil(ws.A_aug,ws.B_aug,ws.Dl_aug,ws.Dr_aug);
+  
+  if(should_interchange)
+    gen_schur_decomp_impl(ws.B_aug,ws.A_aug,&ws.Q_aug,&ws.Z_aug,NumTol);
+  else
+    gen_schur_decomp_impl(ws.A_aug,ws.B_aug,&ws.Q_aug,&ws.Z_aug,NumTol);
+  
+  if(should_interchange)
+    partition_schur_pencil_impl(ws.B_aug,ws.A_aug,&ws.Q_aug,&ws.Z_aug,out_unit_circle_eigen_first(),NumTol);
+  else
+    partition_schur_pencil_impl(ws.A_aug,ws.B_aug,&ws.Q_aug,&ws.Z_aug,in_unit_circle_eigen_first(),NumTol);
+  
+  P.set_row_count(N);
+  P.set_col_count(N);
+  mat_sub_block< mat<ValueType, mat_structure::square> > subZ11(ws.Z_aug, N, N, 0, 0);
+  mat_sub_block< mat<ValueType, mat_structure::square> > subZ21(ws.Z_aug, N, N, N, 0);
+  
+  try {
+    linlsq_QR(transpose_view(subZ11), P, transpose_view(subZ21), NumTol);
+  } catch(singularity_error& e) {
+    throw singularity_error("The Discrete-time Algebraic Riccati Equation (DARE) cannot be solved! Usually indicates that the system is not stabilizable.");
+  };
+  
+  if(UseBalancing) {
+    apply_left_bal_inv_exp(sub(ws.Dr_aug)[range(0,N-1)], P);
+    apply_right_bal_exp(P, sub(ws.Dr_aug)[range(N,2*N-1)]);
+  };
+  
+  for(SizeType j = 1; j < N; ++j) {
+    for(SizeType i = 0; i < j; ++i) {
+      ValueType tmp = ValueType(0.5) * (P(i,j) + P(j,i));
+      P(i,j) = tmp;
+      P(j,i) = tmp;
+    };
+  };
+};
+
+
 }; //detail
 
 
@@ -1457,102 +1672,279 @@ void >::type solve_care_problem(const Matrix1& A, const Matrix2& B,
      (B.get_col_count() != R.get_col_count()))
     throw std::range_error("The dimensions of the CARE system matrices do not match! Should be A(n x n), B(n x m), Q(n x n), and R(m x m).");
   
+  typedef typename mat_traits<Matrix1>::value_type ValueType;
+  detail::are_pencil_workspace<ValueType> ws(A.get_row_count(), R.get_row_count());
+  detail::solve_care_problem_impl(A,B,Q,R,P,NumTol,UseBalancing,ws);
+};
+
+
+
+namespace detail {
+
+/*
+ * Solves the small (at most 4 x 4) linear system M y = c, which arises for each pair of 
+ * diagonal blocks of the real Schur form in the Bartels-Stewart algorithm, by Gaussian 
+ * elimination with partial pivoting. The solution is stored in c.
+ */
+template <typename ValueType>
+void solve_bartels_stewart_block(ValueType (&M)[4][4], ValueType (&c)[4], int n, ValueType NumTol) {
+  using std::fabs;
+  using std::swap;
+  for(int k = 0; k < n; ++k) {
+    int piv = k;
+    for(int i = k + 1; i < n; ++i)
+      if(fabs(M[i][k]) > fabs(M[piv][k]))
+        piv = i;
+    if(fabs(M[piv][k]) < NumTol)
+      throw singularity_error("The Continuous-time Lyapunov Equation cannot be solved! Usually indicates that the system matrix has eigenvalues that are symmetric about the imaginary axis.");
+    if(piv != k) {
+      for(int j = k; j < n; ++j)
+        swap(M[k][j], M[piv][j]);
+      swap(c[k], c[piv]);
+    };
+    for(int i = k + 1; i < n; ++i) {
+      ValueType f = M[i][k] / M[k][k];
+      for(int j = k; j < n; ++j)
+        M[i][j] -= f * M[k][j];
+      c[i] -= f * c[k];
+    };
+  };
+  for(int k = n - 1; k >= 0; --k) {
+    for(int j = k + 1; j < n; ++j)
+      c[k] -= M[k][j] * c[j];
+    c[k] /= M[k][k];
+  };
+};
+
+};
+
+
+/**
+ * Solves the Continuous-time Lyapunov Equation with the Bartels-Stewart algorithm. The 
+ * system matrix is reduced to its real Schur form (A = U T U^T), the transformed equation 
+ * T^T Y + Y T + U^T Q U = 0 is solved for one (1x1 or 2x2) block of Y at a time, by 
+ * forward-substitution over the quasi-triangular T, and the solution is X = U Y U^T.
+ * \n
+ * $A^T X + X A + Q = 0$
+ * \n
+ *
+ * \tparam Matrix1 A readable matrix type.
+ * \tparam Matrix2 A readable matrix type.
+ * \tparam Matrix3 A fully-writable (square) matrix type.
+ * \param A square (n x n) matrix.
+ * \param Q square (n x n) symmetric matrix.
+ * \param X holds as output, the symmetric solution to A^T X + X A + Q = 0.
+ * \param NumTol tolerance for considering a value to be zero in avoiding divisions
+ *               by zero and singularities.
+ *
+ * \throws std::range_error if the matrix dimensions are not consistent.
+ * \throws singularity_error if the Lyapunov equation has no unique solution (A has eigenvalues l1, l2 with l1 + l2 = 0).
+ *
+ * \author Mikael Persson
+ */
+template <typename Matrix1, typename Matrix2, typename Matrix3>
+typename boost::enable_if_c< is_readable_matrix<Matrix1>::value && 
+                             is_readable_matrix<Matrix2>::value && 
+                             is_fully_writable_matrix<Matrix3>::value, 
+void >::type solve_clyap_problem(const Matrix1& A, const Matrix2& Q, Matrix3& X, 
+                                 typename mat_traits<Matrix1>::value_type NumTol = 1E-8) {
+  if((A.get_row_count() != A.get_col_count()) || 
+     (Q.get_row_count() != Q.get_col_count()) || 
+     (Q.get_row_count() != A.get_row_count()))
+    throw std::range_error("The dimensions of the Lyapunov equation matrices do not match! Should be A(n x n) and Q(n x n).");
+  
   typedef typename mat_traits<Matrix1>::value_type ValueType;
   typedef typename mat_traits<Matrix1>::size_type SizeType;
   SizeType N = A.get_row_count();
-  SizeType M = R.get_row_count();
-  if((N == 0) || (M == 0))
+  X.set_row_count(N);
+  X.set_col_count(N);
+  if(N == 0)
     return;
   
-  mat<ValueType, mat_structure::rectangular> R_tmp(N * 2 + M, M);
-  sub(R_tmp)(range(0,M-1), range(0,M-1)) = R;
-  sub(R_tmp)(range(M,M + N - 1), range(0,M-1)) = B;
-  mat<ValueType, mat_structure::square> Q_tmp = mat<ValueType, mat_structure::square>(N * 2 + M);
-  sub(Q_tmp)(range(0, 2 * N - 1), range(M, M + 2 * N - 1)) = mat<ValueType, mat_structure::identity>(2 * N);
-  sub(Q_tmp)(range(2 * N, 2 * N + M - 1), range(0, M - 1)) = mat<ValueType, mat_structure::identity>(M);
-  
-//   std::cout << "CARE: (R; B; 0) = " << R_tmp << std::endl;
-//   std::cout << "CARE: Q = " << Q_tmp << std::endl;
-  
-  detail::decompose_QR_impl(R_tmp, &Q_tmp, NumTol);
-  Q_tmp = transpose(Q_tmp);
-  
-//   std::cout << "CARE: Q' (R; B; 0) = " << R_tmp << std::endl;
-//   std::cout << "CARE: Q' = " << Q_tmp << std::endl;
-  
-  mat<ValueType, mat_structure::rectangular> B_aug(2 * N, 2 * N);
-  B_aug = sub(Q_tmp)(range(M,M + 2*N - 1), range(0,2*N - 1));
-  
-  mat<ValueType, mat_structure::rectangular> A_aug(2 * N, 2 * N);
-  sub(A_aug)(range(0,2 * N - 1),range(0, N - 1)) = 
-      sub(Q_tmp)(range(M,M + 2*N-1),range(0,N-1)) * A
-    - sub(Q_tmp)(range(M,M + 2*N-1),range(N,2*N-1)) * Q;
-  sub(A_aug)(range(0,2 * N - 1),range(N, 2*N - 1)) = 
-      sub(Q_tmp)(range(M,M + 2*N-1),range(2*N,2*N+M-1)) * transpose_view(B)
-    - sub(Q_tmp)(range(M,M + 2*N-1),range(N,2*N-1)) * transpose_view(A);
-  
-  mat<ValueType, mat_structure::square> Q_aug = mat<ValueType, mat_structure::square>(mat<ValueType, mat_structure::identity>(2*N));
-  mat<ValueType, mat_structure::square> Z_aug = mat<ValueType, mat_structure::square>(mat<ValueType, mat_structure::identity>(2*N));
-  
-//   std::cout << "CARE: (Before Schur) A_aug = " << A_aug << std::endl;
-//   std::cout << "CARE: (Before Schur) B_aug = " << B_aug << std::endl;
-//   std::cout << "CARE: (Before Schur) Q_aug = " << Q_aug << std::endl;
-//   std::cout << "CARE: (Before Schur) Z_aug = " << Z_aug << std::endl;
-  
-  bool should_interchange = false;
-//   std::cout << "CARE: norm_A = " << norm_1(A_aug) << " norm_B = " << norm_1(B_aug) << std::endl;
-  if(norm_1(A_aug) > norm_1(B_aug))
-    should_interchange = true;
-  
-//   std::cout << "CARE: (Before Balancing) A_aug = " << A_aug << std::endl;
-//   std::cout << "CARE: (Before Balancing) B_aug = " << B_aug << std::endl;
-  vect_n<int> Dl_aug(2*N);
-  vect_n<int> Dr_aug(2*N);
-  if(UseBalancing)
-    balance_pencil(A_aug,B_aug,Dl_aug,Dr_aug);
-//   std::cout << "CARE: norm_A = " << norm_1(A_aug) << " norm_B = " << norm_1(B_aug) << std::endl;
-//   std::cout << "CARE: (After Balancing) B_aug = " << B_aug << std::endl;
-//   std::cout << "CARE: (After Balancing) A_aug = " << A_aug << std::endl;
+  mat<ValueType, mat_structure::square> U(N);
+  mat<ValueType, mat_structure::square> T(N);
+  decompose_RealSchur(A, U, T, NumTol);
+  mat<ValueType, mat_structure::square> C(transpose_view(U) * Q * U);
+  
+  // the first row/column of each diagonal block of T (1x1, or 2x2 for complex eigenvalues).
+  std::vector<SizeType> blk;
+  for(SizeType i = 0; i < N; ) {
+    blk.push_back(i);
+    i += ((i + 1 < N) && (T(i + 1, i) != ValueType(0.0)) ? 2 : 1);
+  };
+  blk.push_back(N);
+  
+  mat<ValueType, mat_structure::square> Y(N);
+  for(std::size_t k = 0; k + 1 < blk.size(); ++k) {
+    SizeType rk = blk[k];
+    int p = int(blk[k + 1] - rk);
+    for(std::size_t l = k; l + 1 < blk.size(); ++l) {
+      SizeType rl = blk[l];
+      int q = int(blk[l + 1] - rl);
+      
+      // T_kk^T Y_kl + Y_kl T_ll = -C_kl - sum_{i<k} T_ik^T Y_il - sum_{j<l} Y_kj T_jl
+      ValueType M[4][4];
+      ValueType c[4];
+      for(int b = 0; b < q; ++b) {
+        for(int a = 0; a < p; ++a) {
+          ValueType sum = -C(rk + a, rl + b);
+          for(SizeType i = 0; i < rk; ++i)
+            sum -= T(i, rk + a) * Y(i, rl + b);
+          for(SizeType j = 0; j < rl; ++j)
+            sum -= Y(rk + a, j) * T(j, rl + b);
+          c[a + p * b] = sum;
+          for(int j = 0; j < p * q; ++j)
+            M[a + p * b][j] = ValueType(0.0);
+          for(int i = 0; i < p; ++i)
+            M[a + p * b][i + p * b] += T(rk + i, rk + a);
+          for(int j = 0; j < q; ++j)
+            M[a + p * b][a + p * j] += T(rl + j, rl + b);
+        };
+      };
+      detail::solve_bartels_stewart_block(M, c, p * q, NumTol);
+      
+      for(int b = 0; b < q; ++b) {
+        for(int a = 0; a < p; ++a) {
+          Y(rk + a, rl + b) = c[a + p * b];
+          Y(rl + b, rk + a) = c[a + p * b];
+        };
+      };
+    };
+  };
   
-  if(should_interchange)
-    detail::gen_schur_decomp_impl(B_aug,A_aug,&Q_aug,&Z_aug,NumTol);
-  else
-    detail::gen_schur_decomp_impl(A_aug,B_aug,&Q_aug,&Z_aug,NumTol);
+  C = U * Y * transpose_view(U);
+  for(SizeType j = 0; j < N; ++j) {
+    for(SizeType i = 0; i <= j; ++i) {
+      X(i,j) = ValueType(0.5) * (C(i,j) + C(j,i));
+      X(j,i) = X(i,j);
+    };
+  };
+};
+
+
+
+namespace detail {
+
+/* Checks that all the eigenvalues of a square matrix have a negative real part, from its real 
+ * Schur form, in which the eigenvalues are the 1x1 diagonal blocks or the pairs of the 2x2 blocks 
+ * (whose real part is half of the block's trace). */
+template <typename Matrix>
+bool is_Hurwitz_impl(const Matrix& A, typename mat_traits<Matrix>::value_type NumTol) {
+  typedef typename mat_traits<Matrix>::value_type ValueType;
+  typedef typename mat_traits<Matrix>::size_type SizeType;
+  using std::fabs;
   
-//   std::cout << "CARE: (After Schur) A_aug = " << A_aug << std::endl;
-//   std::cout << "CARE: (After Schur) B_aug = " << B_aug << std::endl;
-//   std::cout << "CARE: (After Schur) Q_aug = " << Q_aug << std::endl;
-//   std::cout << "CARE: (After Schur) Z_aug = " << Z_aug << std::endl;
+  mat<ValueType, mat_structure::square> T(A.get_row_count());
+  decompose_RealSchur(A, T, NumTol);
+  SizeType N = T.get_row_count();
+  for(SizeType i = 0; i < N; ++i) {
+    if((i + 1 < N) && (fabs(T(i+1,i)) > NumTol * (fabs(T(i,i)) + fabs(T(i+1,i+1))))) {
+      if(T(i,i) + T(i+1,i+1) >= ValueType(0.0))
+        return false;
+      ++i;
+    } else if(T(i,i) >= ValueType(0.0))
+      return false;
+  };
+  return true;
+};
+
+};
+
+/**
+ * Solves the Continuous-time Algebraic Riccati Equation (for infinite horizon LQR) using 
+ * the Newton-Kleinman iterations, warm-started from a given initial guess of the solution.
+ * Each iteration computes the gain K = R^{-1} B^T P from the current solution and then solves 
+ * the Lyapunov equation (A - B K)^T P + P (A - B K) + Q + K^T R K = 0 for the next solution 
+ * (see solve_clyap_problem). The iterations converge quadratically as long as the initial 
+ * gain is stabilizing, which is normally the case when the initial guess is the solution of 
+ * a nearby CARE problem (e.g., at a neighbouring linearization point). The initial closed-loop 
+ * matrix A - B K is checked to be Hurwitz (from the eigenvalues of its real Schur form), after which 
+ * all the iterates are stabilizing (Kleinman, 1968). This function does not fall back on any other 
+ * method, it is up to the caller to use solve_care_problem if this function returns false 
+ * (as IHCT_AQR_cached_solver does).
+ * \n
+ * $Q + A^T P + P A - P B R^{-1} B^T P = 0$
+ * \n
+ *
+ * \tparam Matrix1 A readable matrix type.
+ * \tparam Matrix2 A readable matrix type.
+ * \tparam Matrix3 A readable matrix type.
+ * \tparam Matrix4 A readable matrix type.
+ * \tparam Matrix5 A fully-writable (square) matrix type.
+ * \param A square (n x n) matrix which represents state-to-state-derivative linear map.
+ * \param B rectangular (n x m) matrix which represents input-to-state-derivative linear map.
+ * \param Q square (n x n) positive-definite matrix which represents quadratic state-error penalty.
+ * \param R square (m x m) positive-definite matrix which represents quadratic input penalty.
+ * \param P holds as input, the initial guess (with a stabilizing gain) and, as output, the 
+ *          nonnegative definite solution to Q + A^T P + P A - P B R^-1 B^T P = 0.
+ * \param NumTol tolerance on the relative change of the solution between two iterations 
+ *               for considering the iterations converged.
+ * \param MaxIter the maximum number of Newton-Kleinman iterations to perform.
+ * \return True if the iterations converged to a nonnegative definite solution, false otherwise, 
+ *         including when the initial gain is not stabilizing (in which case, P holds the last 
+ *         iterate, which should not be used).
+ *
+ * \throws std::range_error if the matrix dimensions are not consistent.
+ *
+ * \author Mikael Persson
+ */
+template <typename Matrix1, typename Matrix2, typename Matrix3, typename Matrix4, typename Matrix5>
+typename boost::enable_if_c< is_readable_matrix<Matrix1>::value && 
+                             is_readable_matrix<Matrix2>::value && 
+                             is_readable_matrix<Matrix3>::value && 
+                             is_readable_matrix<Matrix4>::value && 
+                             is_fully_writable_matrix<Matrix5>::value, 
+bool >::type solve_care_newton_kleinman(const Matrix1& A, const Matrix2& B, 
+                                        const Matrix3& Q, const Matrix4& R, 
+                                        Matrix5& P, typename mat_traits<Matrix1>::value_type NumTol = 1E-8,
+                                        std::size_t MaxIter = 10) {
+  if((A.get_row_count() != A.get_col_count()) || 
+     (B.get_row_count() != A.get_row_count()) || 
+     (Q.get_row_count() != Q.get_col_count()) || 
+     (R.get_row_count() != R.get_col_count()) || 
+     (B.get_col_count() != R.get_col_count()) ||
+     (P.get_row_count() != A.get_row_count()) || 
+     (P.get_col_count() != A.get_row_count()))
+    throw std::range_error("The dimensions of the CARE system matrices do not match! Should be A(n x n), B(n x m), Q(n x n), R(m x m), and P(n x n).");
   
-  if(should_interchange)
-    detail::partition_schur_pencil_impl(B_aug,A_aug,&Q_aug,&Z_aug,detail::neg_real_val_eigen_first(),NumTol);
-  else
-    detail::partition_schur_pencil_impl(A_aug,B_aug,&Q_aug,&Z_aug,detail::neg_real_val_eigen_first(),NumTol);
+  typedef typename mat_traits<Matrix1>::value_type ValueType;
+  typedef typename mat_traits<Matrix1>::size_type SizeType;
+  using std::fabs;
+  SizeType N = A.get_row_count();
+  SizeType M = R.get_row_count();
+  if((N == 0) || (M == 0))
+    return true;
   
-//   std::cout << "CARE: (After Part) A_aug = " << A_aug << std::endl;
-//   std::cout << "CARE: (After Part) B_aug = " << B_aug << std::endl;
-//   std::cout << "CARE: (After Part) Q_aug = " << Q_aug << std::endl;
-//   std::cout << "CARE: (After Part) Z_aug = " << Z_aug << std::endl;
-//   std::cout << "CARE: (After Part) Q_aug A_aug Z_aug' = " << Q_aug * A_aug * transpose_view(Z_aug) << std::endl;
-//   std::cout << "CARE: (After Part) Q_aug B_aug Z_aug' = " << Q_aug * B_aug * transpose_view(Z_aug) << std::endl;
+  mat<ValueType, mat_structure::rectangular> K(M, N);
+  mat<ValueType, mat_structure::rectangular> BtP(M, N);
+  mat<ValueType, mat_structure::square> P_next(N);
   
-  P.set_row_count(N);
-  P.set_col_count(N);
-  mat_sub_block< mat<ValueType, mat_structure::square> > subZ11(Z_aug, N, N, 0, 0);
-  mat_sub_block< mat<ValueType, mat_structure::square> > subZ21(Z_aug, N, N, N, 0);
   try {
-    linlsq_QR(transpose_view(subZ11), P, transpose_view(subZ21), NumTol);
+    for(std::size_t it = 0; it < MaxIter; ++it) {
+      BtP = transpose_view(B) * P;
+      linlsq_QR(R, K, BtP, NumTol);
+      
+      mat<ValueType, mat_structure::square> Acl(A - B * K);
+      if((it == 0) && !detail::is_Hurwitz_impl(Acl, NumTol))
+        return false;  // the warm-start gain is not stabilizing, the iterations would diverge.
+      mat<ValueType, mat_structure::square> Qk(Q + transpose_view(K) * BtP);
+      solve_clyap_problem(Acl, Qk, P_next, NumTol);
+      
+      for(SizeType i = 0; i < N; ++i)
+        if(P_next(i,i) < ValueType(0.0))
+          return false;  // not a stabilizing gain, the iterate is indefinite.
+      
+      ValueType delta = norm_1(P_next - P);
+      ValueType scale = norm_1(P_next);
+      P = P_next;
+      if(delta <= NumTol * (scale > ValueType(1.0) ? scale : ValueType(1.0)))
+        return true;
+    };
   } catch(singularity_error& e) {
-    throw singularity_error("The Continuous-time Algebraic Riccati Equation (CARE) cannot be solved! Usually indicates that the system is not stabilizable.");
-  };
-  
-  if(UseBalancing) {
-    apply_left_bal_inv_exp(sub(Dr_aug)[range(0,N-1)], P);
-    apply_right_bal_exp(P, sub(Dr_aug)[range(N,2*N-1)]);
+    return false;
   };
   
-  P += transpose(P);
-  P *= ValueType(0.5);
+  return false;
 };
 
 
@@ -1890,6 +2282,31 @@ mat_traits<Matrix1> >::type::size_type
 
 
 
+namespace detail {
+
+/* Computes the gain K and the input bias u_bias of the IHCT AQR, given the solution P of the CARE problem. */
+template <typename Matrix1, typename Matrix2, typename Vector1, typename Matrix3, 
+          typename Matrix4, typename Matrix5, typename Vector2>
+void compute_IHCT_AQR_gains_impl(const Matrix1& A, const Matrix2& B, const Vector1& c,
+                                 const Matrix3& R, const Matrix4& P, Matrix5& K, Vector2& u_bias) {
+  typedef typename mat_traits<Matrix1>::value_type ValueType;
+  
+  mat<ValueType,mat_structure::rectangular> M_tmp(B.get_col_count(),A.get_col_count());
+  M_tmp = transpose_view(B) * P;
+  linlsq_QR(R,K,M_tmp);
+  
+  mat<ValueType,mat_structure::square> KB_A ( transpose_view(K) * transpose_view(B) - transpose_view(A) );
+  mat_const_vect_adaptor< Vector1 > c_v_m(c);
+  mat<ValueType,mat_structure::rectangular> eta( c_v_m );
+  linlsq_QR(KB_A, eta, c_v_m);
+  mat_vect_adaptor< Vector2 > u_bias_m(u_bias);
+  linlsq_QR(R, u_bias_m, transpose_view(B) * eta);
+};
+
+};
+
+
+
 /**
  * Solves the Infinite-horizon Continuous-time Affine Quadratic Regulator (AQR) problem.
  * This implementation uses the QZ-algorithm approach as described in Van Dooren (1981)
@@ -1939,20 +2356,8 @@ void >::type solve_IHCT_AQR(const Matrix1& A, const Matrix2& B, const Vector1& c
                             Matrix5& K, Matrix6& P, Vector2& u_bias,
                             typename mat_traits<Matrix1>::value_type NumTol = 1E-8,
                             bool UseBalancing = false) {
-  typedef typename mat_traits<Matrix1>::value_type ValueType;
-  
   solve_care_problem(A,B,Q,R,P,NumTol,UseBalancing);
-  
-  mat<ValueType,mat_structure::rectangular> M_tmp(B.get_col_count(),A.get_col_count());
-  M_tmp = transpose_view(B) * P;
-  linlsq_QR(R,K,M_tmp);
-  
-  mat<ValueType,mat_structure::square> KB_A ( transpose_view(K) * transpose_view(B) - transpose_view(A) );
-  mat_const_vect_adaptor< Vector1 > c_v_m(c);
-  mat<ValueType,mat_structure::rectangular> eta( c_v_m );
-  linlsq_QR(KB_A, eta, c_v_m);
-  mat_vect_adaptor< Vector2 > u_bias_m(u_bias);
-  linlsq_QR(R, u_bias_m, transpose_view(B) * eta);
+  detail::compute_IHCT_AQR_gains_impl(A,B,c,R,P,K,u_bias);
 };
 
 
@@ -2277,104 +2682,8 @@ void >::type solve_dare_problem(const Matrix1& F, const Matrix2& G,
     throw std::range_error("The dimensions of the DARE system matrices do not match! Should be F(n x n), G(n x m), Q(n x n), and R(m x m).");
   
   typedef typename mat_traits<Matrix1>::value_type ValueType;
-  typedef typename mat_traits<Matrix1>::size_type SizeType;
-  SizeType N = F.get_row_count();
-  SizeType M = R.get_row_count();
-  
-  mat<ValueType, mat_structure::rectangular> R_tmp(N * 2 + M, M);
-  sub(R_tmp)(range(0,M-1), range(0,M-1)) = R;
-  sub(R_tmp)(range(M,M + N - 1), range(0,M-1)) = -G;
-  mat<ValueType, mat_structure::square> Q_tmp = mat<ValueType, mat_structure::square>(N * 2 + M);
-  sub(Q_tmp)(range(0, 2 * N - 1), range(M, M + 2 * N - 1)) = mat<ValueType, mat_structure::identity>(2 * N);
-  sub(Q_tmp)(range(2 * N, 2 * N + M - 1), range(0, M - 1)) = mat<ValueType, mat_structure::identity>(M);
-  
-//   std::cout << "DARE: (R; -G; 0) = " << R_tmp << std::endl;
-//   std::cout << "DARE: Q = " << Q_tmp << std::endl;
-  
-  detail::decompose_QR_impl(R_tmp, &Q_tmp, NumTol);
-  Q_tmp = transpose(Q_tmp);
-  
-//   std::cout << "DARE: Q' (R; -G; 0) = " << R_tmp << std::endl;
-//   std::cout << "DARE: Q' = " << Q_tmp << std::endl;
-  
-  mat<ValueType, mat_structure::rectangular> B_aug(2 * N, 2 * N);
-  sub(B_aug)(range(0,2 * N - 1),range(0, N - 1)) = sub(Q_tmp)(range(M,M + 2*N-1),range(0,N-1));
-  sub(B_aug)(range(0,2 * N - 1),range(N, 2*N - 1)) = 
-      sub(Q_tmp)(range(M,M + 2*N-1),range(N,2*N-1)) * transpose_view(F)
-    + sub(Q_tmp)(range(M,M + 2*N-1),range(2*N,2*N+M-1)) * transpose_view(G);
-  
-  mat<ValueType, mat_structure::rectangular> A_aug(2 * N, 2 * N);
-  sub(A_aug)(range(0,2 * N - 1),range(0, N - 1)) = 
-      sub(Q_tmp)(range(M,M + 2*N-1),range(0,N-1)) * F
-    - sub(Q_tmp)(range(M,M + 2*N-1),range(N,2*N-1)) * Q;
-  sub(A_aug)(range(0,2 * N - 1),range(N, 2*N - 1)) = sub(Q_tmp)(range(M,M + 2*N-1),range(N,2*N-1));
-  
-  mat<ValueType, mat_structure::square> Q_aug = mat<ValueType, mat_structure::square>(mat<ValueType, mat_structure::identity>(2*N));
-  mat<ValueType, mat_structure::square> Z_aug = mat<ValueType, mat_structure::square>(mat<ValueType, mat_structure::identity>(2*N));
-  
-//   std::cout << "DARE: (Before Schur) A_aug = " << A_aug << std::endl;
-//   std::cout << "DARE: (Before Schur) B_aug = " << B_aug << std::endl;
-//   std::cout << "DARE: (Before Schur) Q_aug = " << Q_aug << std::endl;
-//   std::cout << "DARE: (Before Schur) Z_aug = " << Z_aug << std::endl;
-  
-  bool should_interchange = false;
-//   std::cout << "DARE: norm_A = " << norm_1(A_aug) << " norm_B = " << norm_1(B_aug) << std::endl;
-  if(norm_1(A_aug) > norm_1(B_aug))
-    should_interchange = true;
-  
-//   if(N < 4) {
-//     std::cout << "DARE: (Before Balancing) A_aug = " << A_aug << std::endl;
-//     std::cout << "DARE: (Before Balancing) B_aug = " << B_aug << std::endl;
-//   };
-  vect_n<int> Dl_aug(2*N);
-  vect_n<int> Dr_aug(2*N);
-  if(UseBalancing)
-    balance_pencil(A_aug,B_aug,Dl_aug,Dr_aug);
-//   if(N < 4) {
-//     std::cout << "DARE: (After Balancing) A_aug = " << A_aug << std::endl;
-//     std::cout << "DARE: (After Balancing) B_aug = " << B_aug << std::endl;
-//   };
-  
-  if(should_interchange)
-    detail::gen_schur_decomp_impl(B_aug,A_aug,&Q_aug,&Z_aug,NumTol);
-  else
-    detail::gen_schur_decomp_impl(A_aug,B_aug,&Q_aug,&Z_aug,NumTol);
-  
-//   std::cout << "DARE: (After Schur) A_aug = " << A_aug << std::endl;
-//   std::cout << "DARE: (After Schur) B_aug = " << B_aug << std::endl;
-//   std::cout << "DARE: (After Schur) Q_aug = " << Q_aug << std::endl;
-//   std::cout << "DARE: (After Schur) Z_aug = " << Z_aug << std::endl;
-  
-  if(should_interchange)
-    detail::partition_schur_pencil_impl(B_aug,A_aug,&Q_aug,&Z_aug,detail::out_unit_circle_eigen_first(),NumTol);
-  else
-    detail::partition_schur_pencil_impl(A_aug,B_aug,&Q_aug,&Z_aug,detail::in_unit_circle_eigen_first(),NumTol);
-  
-//   std::cout << "DARE: (After Part) A_aug = " << A_aug << std::endl;
-//   std::cout << "DARE: (After Part) B_aug = " << B_aug << std::endl;
-//   std::cout << "DARE: (After Part) Q_aug = " << Q_aug << std::endl;
-//   std::cout << "DARE: (After Part) Z_aug = " << Z_aug << std::endl;
-//   std::cout << "DARE: (After Part) Q_aug A_aug Z_aug' = " << Q_aug * A_aug * transpose_view(Z_aug) << std::endl;
-//   std::cout << "DARE: (After Part) Q_aug B_aug Z_aug' = " << Q_aug * B_aug * transpose_view(Z_aug) << std::endl;
-  
-  P.set_row_count(N);
-  P.set_col_count(N);
-  mat_sub_block< mat<ValueType, mat_structure::square> > subZ11(Z_aug, N, N, 0, 0);
-  mat_sub_block< mat<ValueType, mat_structure::square> > subZ21(Z_aug, N, N, N, 0);
-  
-  try {
-    linlsq_QR(transpose_view(subZ11), P, transpose_view(subZ21), NumTol);
-  } catch(singularity_error& e) {
-    throw singularity_error("The Discrete-time Algebraic Riccati Equation (DARE) cannot be solved! Usually indicates that the system is not stabilizable.");
-  };
-  
-  if(UseBalancing) {
-    apply_left_bal_inv_exp(sub(Dr_aug)[range(0,N-1)], P);
-    apply_right_bal_exp(P, sub(Dr_aug)[range(N,2*N-1)]);
-  };
-  
-  P += transpose(P);
-  P *= ValueType(0.5);
+  detail::are_pencil_workspace<ValueType> ws(F.get_row_count(), R.get_row_count());
+  detail::solve_dare_problem_impl(F,G,Q,R,P,NumTol,UseBalancing,ws);
 };
 
 /**
@@ -2883,6 +3192,252 @@ void >::type solve_dtsf_problem(const Matrix1& F, const Matrix2& G,
 
 
 
+/**
+ * This class template is a solver for the Continuous-time Algebraic Riccati Equation (CARE) 
+ * which owns the workspace needed by the QZ-algorithm approach of solve_care_problem, i.e., 
+ * the augmented pencil, its generalized Schur factors and the balancing exponents. The workspace 
+ * is sized at construction for a given (n x n) state matrix and (n x m) input matrix, and it is 
+ * reused by every call to solve(), such that recomputing the solution at a fixed rate (e.g., for 
+ * gain-scheduling) does not re-allocate the pencils at each call. If a problem of a different 
+ * size is given, the workspace is re-sized for it.
+ * \n
+ * $Q + A^T P + P A - P B R^{-1} B^T P = 0$
+ * \n
+ *
+ * \tparam T The value-type of the matrices.
+ *
+ * \author Mikael Persson
+ */
+template <typename T>
+class care_solver {
+  public:
+    typedef T value_type;
+    typedef std::size_t size_type;
+  
+  private:
+    detail::are_pencil_workspace<T> m_ws;
+    mat<T, mat_structure::rectangular> m_BtP;
+    T m_NumTol;
+    bool m_UseBalancing;
+    
+  public:
+    
+    /**
+     * Parametrized and default constructor.
+     * \param aN The number of states (n) of the problems to solve.
+     * \param aM The number of inputs (m) of the problems to solve.
+     * \param aNumTol tolerance for considering a value to be zero in avoiding divisions
+     *                by zero and singularities.
+     * \param aUseBalancing specifies whether balancing should be applied to the problem before performing 
+     *                      the Schur decomposition (see solve_care_problem).
+     */
+    explicit care_solver(size_type aN = 0, size_type aM = 0, 
+                         T aNumTol = T(1E-8), bool aUseBalancing = false) :
+                         m_ws(aN, aM), m_BtP(aM, aN), 
+                         m_NumTol(aNumTol), m_UseBalancing(aUseBalancing) { };
+    
+    /**
+     * Solves the CARE problem, see solve_care_problem.
+     * \param A square (n x n) matrix which represents state-to-state-derivative linear map.
+     * \param B rectangular (n x m) matrix which represents input-to-state-derivative linear map.
+     * \param Q square (n x n) positive-definite matrix which represents quadratic state-error penalty.
+     * \param R square (m x m) positive-semi-definite matrix which represents quadratic input penalty.
+     * \param P holds as output, the nonnegative definite solution to Q + A^T P + P A - P B R^-1 B^T P = 0.
+     *
+     * \throws std::range_error if the matrix dimensions are not consistent.
+     * \throws singularity_error if the CARE problem cannot be solved, usually because the system is not stabilizable.
+     */
+    template <typename Matrix1, typename Matrix2, typename Matrix3, typename Matrix4, typename Matrix5>
+    typename boost::enable_if_c< is_readable_matrix<Matrix1>::value && 
+                                 is_readable_matrix<Matrix2>::value && 
+                                 is_readable_matrix<Matrix3>::value && 
+                                 is_readable_matrix<Matrix4>::value && 
+                                 is_fully_writable_matrix<Matrix5>::value, 
+    void >::type solve(const Matrix1& A, const Matrix2& B, 
+                       const Matrix3& Q, const Matrix4& R, Matrix5& P) {
+      if((A.get_row_count() != A.get_col_count()) || 
+         (B.get_row_count() != A.get_row_count()) || 
+         (Q.get_row_count() != Q.get_col_count()) || 
+         (R.get_row_count() != R.get_col_count()) || 
+         (B.get_col_count() != R.get_col_count()))
+        throw std::range_error("The dimensions of the CARE system matrices do not match! Should be A(n x n), B(n x m), Q(n x n), and R(m x m).");
+      detail::solve_care_problem_impl(A, B, Q, R, P, m_NumTol, m_UseBalancing, m_ws);
+    };
+    
+    /**
+     * Solves the Infinite-horizon Continuous-time Linear Quadratic Regulator (LQR) problem, see solve_IHCT_LQR.
+     * \param A square (n x n) matrix which represents state-to-state-derivative linear map.
+     * \param B rectangular (n x m) matrix which represents input-to-state-derivative linear map.
+     * \param Q square (n x n) positive-definite matrix which represents quadratic state-error penalty.
+     * \param R square (m x m) positive-definite matrix which represents quadratic input penalty.
+     * \param K holds as output, the (mxn) LQR-optimal gain matrix for u = - K * (x_cur - x_ref).
+     * \param P holds as output, the nonnegative definite solution to Q + A^T P + P A - P B R^-1 B^T P = 0.
+     *
+     * \throws std::range_error if the matrix dimensions are not consistent.
+     * \throws singularity_error if the CARE problem cannot be solved, usually because the system is not stabilizable.
+     */
+    template <typename Matrix1, typename Matrix2, typename Matrix3, typename Matrix4, typename Matrix5, typename Matrix6>
+    typename boost::enable_if_c< is_readable_matrix<Matrix1>::value && 
+                                 is_readable_matrix<Matrix2>::value && 
+                                 is_readable_matrix<Matrix3>::value && 
+                                 is_readable_matrix<Matrix4>::value && 
+                                 is_fully_writable_matrix<Matrix5>::value && 
+                                 is_fully_writable_matrix<Matrix6>::value, 
+    void >::type solve_LQR(const Matrix1& A, const Matrix2& B, 
+                           const Matrix3& Q, const Matrix4& R, 
+                           Matrix5& K, Matrix6& P) {
+      solve(A, B, Q, R, P);
+      m_BtP.set_row_count(B.get_col_count());
+      m_BtP.set_col_count(A.get_col_count());
+      m_BtP = transpose_view(B) * P;
+      linlsq_QR(R, K, m_BtP);
+    };
+    
+    /** Returns the number of states (n) for which the workspace is currently sized. */
+    size_type get_state_count() const { return m_ws.N; };
+    /** Returns the number of inputs (m) for which the workspace is currently sized. */
+    size_type get_input_count() const { return m_ws.M; };
+    
+    /** Sets the tolerance for considering a value to be zero in avoiding divisions by zero and singularities. */
+    void set_tolerance(T aNumTol) { m_NumTol = aNumTol; };
+    /** Returns the tolerance for considering a value to be zero in avoiding divisions by zero and singularities. */
+    T get_tolerance() const { return m_NumTol; };
+    
+    /** Sets whether balancing should be applied to the problem before performing the Schur decomposition. */
+    void set_balancing(bool aUseBalancing) { m_UseBalancing = aUseBalancing; };
+    /** Returns whether balancing is applied to the problem before performing the Schur decomposition. */
+    bool get_balancing() const { return m_UseBalancing; };
+    
+};
+
+
+
+/**
+ * This class template is a solver for the Discrete-time Algebraic Riccati Equation (DARE) 
+ * which owns the workspace needed by the QZ-algorithm approach of solve_dare_problem, i.e., 
+ * the augmented pencil, its generalized Schur factors and the balancing exponents. The workspace 
+ * is sized at construction for a given (n x n) state-transition matrix and (n x m) input matrix, 
+ * and it is reused by every call to solve(), such that recomputing the solution at a fixed rate 
+ * (e.g., for gain-scheduling) does not re-allocate the pencils at each call. If a problem of a 
+ * different size is given, the workspace is re-sized for it.
+ * \n
+ * $P = F^T P F - F^T P G ( R + G^T P G )^{-1} G^T P F + Q$
+ * \n
+ *
+ * \tparam T The value-type of the matrices.
+ *
+ * \author Mikael Persson
+ */
+template <typename T>
+class dare_solver {
+  public:
+    typedef T value_type;
+    typedef std::size_t size_type;
+  
+  private:
+    detail::are_pencil_workspace<T> m_ws;
+    mat<T, mat_structure::rectangular> m_GtP;
+    mat<T, mat_structure::rectangular> m_GtPF;
+    mat<T, mat_structure::rectangular> m_RGtPG;
+    T m_NumTol;
+    bool m_UseBalancing;
+    
+  public:
+    
+    /**
+     * Parametrized and default constructor.
+     * \param aN The number of states (n) of the problems to solve.
+     * \param aM The number of inputs (m) of the problems to solve.
+     * \param aNumTol tolerance for considering a value to be zero in avoiding divisions
+     *                by zero and singularities.
+     * \param aUseBalancing specifies whether balancing should be applied to the problem before performing 
+     *                      the Schur decomposition (see solve_dare_problem).
+     */
+    explicit dare_solver(size_type aN = 0, size_type aM = 0, 
+                         T aNumTol = T(1E-8), bool aUseBalancing = false) :
+                         m_ws(aN, aM), m_GtP(aM, aN), m_GtPF(aM, aN), m_RGtPG(aM, aM), 
+                         m_NumTol(aNumTol), m_UseBalancing(aUseBalancing) { };
+    
+    /**
+     * Solves the DARE problem, see solve_dare_problem.
+     * \param F square (n x n) matrix which represents state-to-next-state linear map.
+     * \param G rectangular (n x m) matrix which represents input-to-next-state linear map.
+     * \param Q square (n x n) positive-definite matrix which represents quadratic state-error penalty.
+     * \param R square (m x m) positive-semi-definite matrix which represents quadratic input penalty.
+     * \param P holds as output, the nonnegative definite solution to P = F^T P F - F^T P G ( R + G^T P G )^{-1} G^T P F + Q.
+     *
+     * \throws std::range_error if the matrix dimensions are not consistent.
+     * \throws singularity_error if the DARE problem cannot be solved, usually because the system is not stabilizable.
+     */
+    template <typename Matrix1, typename Matrix2, typename Matrix3, typename Matrix4, typename Matrix5>
+    typename boost::enable_if_c< is_readable_matrix<Matrix1>::value && 
+                                 is_readable_matrix<Matrix2>::value && 
+                                 is_readable_matrix<Matrix3>::value && 
+                                 is_readable_matrix<Matrix4>::value && 
+                                 is_fully_writable_matrix<Matrix5>::value, 
+    void >::type solve(const Matrix1& F, const Matrix2& G, 
+                       const Matrix3& Q, const Matrix4& R, Matrix5& P) {
+      if((F.get_row_count() != F.get_col_count()) || 
+         (G.get_row_count() != F.get_row_count()) || 
+         (Q.get_row_count() != Q.get_col_count()) || 
+         (R.get_row_count() != R.get_col_count()) || 
+         (G.get_col_count() != R.get_col_count()))
+        throw std::range_error("The dimensions of the DARE system matrices do not match! Should be F(n x n), G(n x m), Q(n x n), and R(m x m).");
+      detail::solve_dare_problem_impl(F, G, Q, R, P, m_NumTol, m_UseBalancing, m_ws);
+    };
+    
+    /**
+     * Solves the Infinite-horizon Discrete-time Linear Quadratic Regulator (LQR) problem, see solve_IHDT_LQR.
+     * \param F square (n x n) matrix which represents state-to-next-state linear map.
+     * \param G rectangular (n x m) matrix which represents input-to-next-state linear map.
+     * \param Q square (n x n) positive-definite matrix which represents quadratic state-error penalty.
+     * \param R square (m x m) positive-definite matrix which represents quadratic input penalty.
+     * \param K holds as output, the (mxn) LQR-optimal gain matrix for u = - K * (x_cur - x_ref).
+     * \param P holds as output, the nonnegative definite solution to P = F^T P F - F^T P G ( R + G^T P G )^{-1} G^T P F + Q.
+     *
+     * \throws std::range_error if the matrix dimensions are not consistent.
+     * \throws singularity_error if the DARE problem cannot be solved, usually because the system is not stabilizable.
+     */
+    template <typename Matrix1, typename Matrix2, typename Matrix3, typename Matrix4, typename Matrix5, typename Matrix6>
+    typename boost::enable_if_c< is_readable_matrix<Matrix1>::value && 
+                                 is_readable_matrix<Matrix2>::value && 
+                                 is_readable_matrix<Matrix3>::value && 
+                                 is_readable_matrix<Matrix4>::value && 
+                                 is_fully_writable_matrix<Matrix5>::value && 
+                                 is_fully_writable_matrix<Matrix6>::value, 
+    void >::type solve_LQR(const Matrix1& F, const Matrix2& G, 
+                           const Matrix3& Q, const Matrix4& R, 
+                           Matrix5& K, Matrix6& P) {
+      solve(F, G, Q, R, P);
+      m_GtP.set_row_count(G.get_col_count());
+      m_GtP.set_col_count(F.get_col_count());
+      m_GtP = transpose_view(G) * P;
+      m_GtPF = m_GtP * F;
+      m_RGtPG = R;
+      m_RGtPG += m_GtP * G;
+      linlsq_QR(m_RGtPG, K, m_GtPF);
+    };
+    
+    /** Returns the number of states (n) for which the workspace is currently sized. */
+    size_type get_state_count() const { return m_ws.N; };
+    /** Returns the number of inputs (m) for which the workspace is currently sized. */
+    size_type get_input_count() const { return m_ws.M; };
+    
+    /** Sets the tolerance for considering a value to be zero in avoiding divisions by zero and singularities. */
+    void set_tolerance(T aNumTol) { m_NumTol = aNumTol; };
+    /** Returns the tolerance for considering a value to be zero in avoiding divisions by zero and singularities. */
+    T get_tolerance() const { return m_NumTol; };
+    
+    /** Sets whether balancing should be applied to the problem before performing the Schur decomposition. */
+    void set_balancing(bool aUseBalancing) { m_UseBalancing = aUseBalancing; };
+    /** Returns whether balancing is applied to the problem before performing the Schur decomposition. */
+    bool get_balancing() const { return m_UseBalancing; };
+    
+};
+
+
+
+
 #if (defined(RK_ENABLE_CXX11_FEATURES) && defined(RK_ENABLE_EXTERN_TEMPLATES))
 
 extern template void solve_care_problem(const mat<double,mat_structure::square>& A, const mat<double,mat_structure::rectangular>& B, 
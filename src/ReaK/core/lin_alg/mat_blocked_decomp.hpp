@@ -0,0 +1,618 @@
+/**
+ * \file mat_blocked_decomp.hpp
+ *
+ * This library provides blocked (right-looking) versions of the Cholesky, QR and PLU
+ * decompositions. These algorithms factorize a narrow panel of columns at a time (with the
+ * un-blocked algorithms of mat_cholesky.hpp, mat_qr_decomp.hpp and mat_gaussian_elim.hpp) and
+ * then apply the panel to the trailing matrix as a single matrix-multiplication (level-3) update.
+ * The trailing updates are split into independent blocks of columns, which can be distributed
+ * over a number of threads. For small matrices (less than twice the block-size), the blocked
+ * functions simply revert to the un-blocked algorithms.
+ *
+ * \author Sven Mikael Persson <mikael.s.persson@gmail.com>
+ * \date June 2013
+ */
+
+/*
+ *    Copyright 2013 Sven Mikael Persson
+ *
+ *    THIS SOFTWARE IS DISTRIBUTED UNDER THE TERMS OF THE GNU GENERAL PUBLIC LICENSE v3 (GPLv3).
+ *
+ *    This file is part of ReaK.
+ *
+ *    ReaK is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    (at your option) any later version.
+ *
+ *    ReaK is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with ReaK (as LICENSE in the root folder).
+ *    If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef REAK_MAT_BLOCKED_DECOMP_HPP
+#define REAK_MAT_BLOCKED_DECOMP_HPP
+
+#include "base/defs.hpp"
+#include "base/thread_incl.hpp"
+
+#include "mat_alg.hpp"
+#include "mat_num_exceptions.hpp"
+
+#include "mat_cholesky.hpp"
+#include "mat_qr_decomp.hpp"
+#include "mat_gaussian_elim.hpp"
+
+#include <vector>
+
+namespace ReaK {
+
+
+
+/*************************************************************************
+                     Blocked Matrix-Multiplication Kernel
+*************************************************************************/
+
+namespace detail {
+
+enum block_gemm_op {
+  block_gemm_NN = 0,  // C += alpha * A * B
+  block_gemm_NT,      // C += alpha * A * B^T
+  block_gemm_TN       // C += alpha * A^T * B
+};
+
+/*
+ * This functor performs the update of a (m x n) block of C (at offset (c_row,c_col)) by the
+ * product of a (m x k) block of op(A) (at offset (a_row,a_col) of A) with a (k x n) block of
+ * op(B) (at offset (b_row,b_col) of B). The loops are ordered to run down the columns, which
+ * is the contiguous direction in the (column-major) matrices used by the blocked algorithms.
+ */
+template <typename Matrix1, typename Matrix2, typename Matrix3>
+struct block_gemm_task {
+  typedef typename mat_traits<Matrix3>::value_type ValueType;
+  typedef typename mat_traits<Matrix3>::size_type SizeType;
+
+  const Matrix1* A; SizeType a_row; SizeType a_col;
+  const Matrix2* B; SizeType b_row; SizeType b_col;
+  Matrix3* C; SizeType c_row; SizeType c_col;
+  SizeType m; SizeType n; SizeType k;
+  ValueType alpha;
+  block_gemm_op op;
+
+  block_gemm_task(const Matrix1& aA, SizeType aARow, SizeType aACol,
+                  const Matrix2& aB, SizeType aBRow, SizeType aBCol,
+                  Matrix3& aC, SizeType aCRow, SizeType aCCol,
+                  SizeType aM, SizeType aN, SizeType aK,
+                  ValueType aAlpha, block_gemm_op aOp) :
+                  A(&aA), a_row(aARow), a_col(aACol),
+                  B(&aB), b_row(aBRow), b_col(aBCol),
+                  C(&aC), c_row(aCRow), c_col(aCCol),
+                  m(aM), n(aN), k(aK), alpha(aAlpha), op(aOp) { };
+
+  void operator()() const {
+    const SizeType kc = 128; // tile on the inner dimension, to keep the panel of A in cache.
+    if(op == block_gemm_TN) {
+      for(SizeType j = 0; j < n; ++j) {
+        for(SizeType i = 0; i < m; ++i) {
+          ValueType s = ValueType(0.0);
+          for(SizeType l = 0; l < k; ++l)
+            s += (*A)(a_row + l, a_col + i) * (*B)(b_row + l, b_col + j);
+          (*C)(c_row + i, c_col + j) += alpha * s;
+        };
+      };
+      return;
+    };
+    for(SizeType l0 = 0; l0 < k; l0 += kc) {
+      SizeType l1 = (l0 + kc < k ? l0 + kc : k);
+      for(SizeType j = 0; j < n; ++j) {
+        for(SizeType l = l0; l < l1; ++l) {
+          ValueType b = alpha * (op == block_gemm_NN ? (*B)(b_row + l, b_col + j) : (*B)(b_row + j, b_col + l));
+          if(b == ValueType(0.0))
+            continue;
+          for(SizeType i = 0; i < m; ++i)
+            (*C)(c_row + i, c_col + j) += (*A)(a_row + i, a_col + l) * b;
+        };
+      };
+    };
+  };
+};
+
+template <typename Task>
+struct block_task_runner {
+  const std::vector< Task >* tasks;
+  std::size_t first;
+  std::size_t stride;
+
+  block_task_runner(const std::vector< Task >& aTasks, std::size_t aFirst, std::size_t aStride) :
+                    tasks(&aTasks), first(aFirst), stride(aStride) { };
+
+  void operator()() const {
+    for(std::size_t i = first; i < tasks->size(); i += stride)
+      (*tasks)[i]();
+  };
+};
+
+/*
+ * Runs a set of independent block tasks, distributed (round-robin) over a number of threads
+ * (the calling thread being one of them).
+ */
+template <typename Task>
+void run_block_tasks(const std::vector< Task >& tasks, std::size_t aThreadCount) {
+  if((aThreadCount <= 1) || (tasks.size() <= 1)) {
+    for(std::size_t i = 0; i < tasks.size(); ++i)
+      tasks[i]();
+    return;
+  };
+  std::size_t T = (aThreadCount < tasks.size() ? aThreadCount : tasks.size());
+  std::vector< shared_ptr< ReaKaux::thread > > threads;
+  for(std::size_t t = 1; t < T; ++t)
+    threads.push_back(shared_ptr< ReaKaux::thread >(new ReaKaux::thread(block_task_runner< Task >(tasks, t, T))));
+  block_task_runner< Task >(tasks, 0, T)();
+  for(std::size_t t = 0; t < threads.size(); ++t)
+    threads[t]->join();
+};
+
+/*
+ * Performs the update C(m x n) += alpha * op(A)(m x k) * op(B)(k x n), with the columns of C
+ * split into blocks (of aBlockSize columns) which are distributed over aThreadCount threads.
+ */
+template <typename Matrix1, typename Matrix2, typename Matrix3>
+void block_gemm_impl(const Matrix1& A, typename mat_traits<Matrix3>::size_type a_row, typename mat_traits<Matrix3>::size_type a_col,
+                     const Matrix2& B, typename mat_traits<Matrix3>::size_type b_row, typename mat_traits<Matrix3>::size_type b_col,
+                     Matrix3& C, typename mat_traits<Matrix3>::size_type c_row, typename mat_traits<Matrix3>::size_type c_col,
+                     typename mat_traits<Matrix3>::size_type m, typename mat_traits<Matrix3>::size_type n, typename mat_traits<Matrix3>::size_type k,
+                     typename mat_traits<Matrix3>::value_type alpha, block_gemm_op op,
+                     typename mat_traits<Matrix3>::size_type aBlockSize, std::size_t aThreadCount) {
+  typedef typename mat_traits<Matrix3>::size_type SizeType;
+  if((m == 0) || (n == 0) || (k == 0))
+    return;
+  std::vector< block_gemm_task<Matrix1,Matrix2,Matrix3> > tasks;
+  SizeType nb = (aThreadCount > 1 ? aBlockSize : n);
+  for(SizeType j0 = 0; j0 < n; j0 += nb) {
+    SizeType w = (j0 + nb < n ? nb : n - j0);
+    if(op == block_gemm_NT)
+      tasks.push_back(block_gemm_task<Matrix1,Matrix2,Matrix3>(A, a_row, a_col, B, b_row + j0, b_col,
+                                                                C, c_row, c_col + j0, m, w, k, alpha, op));
+    else
+      tasks.push_back(block_gemm_task<Matrix1,Matrix2,Matrix3>(A, a_row, a_col, B, b_row, b_col + j0,
+                                                                C, c_row, c_col + j0, m, w, k, alpha, op));
+  };
+  run_block_tasks(tasks, aThreadCount);
+};
+
+
+};
+
+
+
+/*************************************************************************
+                        Blocked Cholesky Decomposition
+*************************************************************************/
+
+namespace detail {
+
+template <typename Matrix>
+void decompose_Cholesky_blocked_impl(Matrix& L, typename mat_traits<Matrix>::value_type NumTol,
+                                     typename mat_traits<Matrix>::size_type aBlockSize, std::size_t aThreadCount)
+{
+  typedef typename mat_traits<Matrix>::value_type ValueType;
+  typedef typename mat_traits<Matrix>::size_type SizeType;
+  SizeType N = L.get_row_count();
+
+  for(SizeType k0 = 0; k0 < N; k0 += aBlockSize) {
+    SizeType k1 = (k0 + aBlockSize < N ? k0 + aBlockSize : N);
+
+    // factorize the diagonal block (in-place):
+    mat_sub_block<Matrix> L11(L, k1 - k0, k1 - k0, k0, k0);
+    decompose_Cholesky_impl(L11, L11, NumTol);
+    if(k1 == N)
+      break;
+
+    // solve for the panel below the diagonal block: L21 = A21 * L11^-T
+    for(SizeType j = k0; j < k1; ++j) {
+      for(SizeType l = k0; l < j; ++l) {
+        ValueType ljl = L(j,l);
+        for(SizeType i = k1; i < N; ++i)
+          L(i,j) -= L(i,l) * ljl;
+      };
+      ValueType ljj = L(j,j);
+      for(SizeType i = k1; i < N; ++i)
+        L(i,j) /= ljj;
+    };
+
+    // update the lower part of the trailing matrix: A22 -= L21 * L21^T
+    std::vector< block_gemm_task<Matrix,Matrix,Matrix> > tasks;
+    for(SizeType j0 = k1; j0 < N; j0 += aBlockSize) {
+      SizeType w = (j0 + aBlockSize < N ? aBlockSize : N - j0);
+      tasks.push_back(block_gemm_task<Matrix,Matrix,Matrix>(L, j0, k0, L, j0, k0, L, j0, j0,
+                                                           N - j0, w, k1 - k0, ValueType(-1.0), block_gemm_NT));
+    };
+    run_block_tasks(tasks, aThreadCount);
+  };
+
+  for(SizeType j = 1; j < N; ++j)
+    for(SizeType i = 0; i < j; ++i)
+      L(i,j) = ValueType(0.0);
+};
+
+};
+
+
+/**
+ * Performs the Cholesky decomposition of A (positive-definite symmetric matrix) using a blocked
+ * (right-looking) algorithm, see decompose_Cholesky. The diagonal blocks are factorized with the
+ * un-blocked algorithm and the trailing matrix is updated by a matrix-multiplication of the panel
+ * below the diagonal block, one block of columns per task. Matrices with less than twice the
+ * block-size in rows are decomposed with the un-blocked algorithm.
+ *
+ * \param A real, positive-definite, symmetric, square, full-rank matrix to be decomposed.
+ * \param L stores, as output, the lower-triangular matrix in A = L * transpose(L).
+ * \param NumTol tolerance for considering a value to be zero in avoiding divisions
+ *               by zero and singularities.
+ * \param aBlockSize the number of columns in each block (panel) of the algorithm.
+ * \param aThreadCount the number of threads over which the trailing matrix updates are distributed.
+ *
+ * \throws singularity_error if the matrix A is singular (or rank-deficient) or not positive-definite.
+ *
+ * \note the symmetry or positive-definitiveness of the matrix A is not checked and thus it is
+ *       the caller's responsibility to ensure it's correct.
+ *
+ * \author Mikael Persson
+ */
+template <typename Matrix1, typename Matrix2>
+typename boost::enable_if_c< is_readable_matrix<Matrix1>::value &&
+                             ((mat_traits<Matrix1>::structure == mat_structure::square) ||
+                              (mat_traits<Matrix1>::structure == mat_structure::symmetric) ||
+                              (mat_traits<Matrix1>::structure == mat_structure::tridiagonal)) &&
+                             is_writable_matrix<Matrix2>::value,
+void >::type decompose_Cholesky_blocked(const Matrix1& A, Matrix2& L, typename mat_traits<Matrix1>::value_type NumTol = 1E-8,
+                                        typename mat_traits<Matrix1>::size_type aBlockSize = 64, std::size_t aThreadCount = 1) {
+  typedef typename mat_traits<Matrix1>::value_type ValueType;
+  typedef typename mat_traits<Matrix1>::size_type SizeType;
+  SizeType N = A.get_row_count();
+  mat<ValueType, mat_structure::square> L_tmp(N, ValueType(0));
+  if((aBlockSize == 0) || (N < 2 * aBlockSize)) {
+    detail::decompose_Cholesky_impl(A,L_tmp,NumTol);
+  } else {
+    for(SizeType j = 0; j < N; ++j)
+      for(SizeType i = j; i < N; ++i)
+        L_tmp(i,j) = A(i,j);
+    detail::decompose_Cholesky_blocked_impl(L_tmp,NumTol,aBlockSize,aThreadCount);
+  };
+  L = L_tmp;
+};
+
+
+
+/*************************************************************************
+                          Blocked QR Decomposition
+*************************************************************************/
+
+namespace detail {
+
+template <typename Matrix1, typename Matrix2>
+void decompose_QR_blocked_impl(Matrix1& A, Matrix2* Q, typename mat_traits<Matrix1>::value_type NumTol,
+                               typename mat_traits<Matrix1>::size_type aBlockSize, std::size_t aThreadCount)
+{
+  typedef typename mat_traits<Matrix1>::value_type ValueType;
+  typedef typename mat_traits<Matrix1>::size_type SizeType;
+  typedef mat<ValueType,mat_structure::rectangular> WorkMatrix;
+  SizeType N = A.get_row_count();
+  SizeType M = A.get_col_count();
+  householder_matrix< vect_n<ValueType> > hhm;
+
+  SizeType t = (N-1 > M ? M : N-1);
+
+  for(SizeType k0 = 0; k0 < t; k0 += aBlockSize) {
+    SizeType kb = (k0 + aBlockSize < t ? aBlockSize : t - k0);
+    SizeType k1 = k0 + kb;
+    SizeType nr = N - k0;
+
+    // factorize the panel, keeping the householder vectors in V (as lower-trapezoidal columns).
+    WorkMatrix V(nr, kb, ValueType(0.0));
+    mat<ValueType,mat_structure::square> T(kb, ValueType(0.0));
+    for(SizeType c = 0; c < kb; ++c) {
+      SizeType i = k0 + c;
+      hhm.set(mat_row_slice<Matrix1>(A,i,i,N - i),NumTol);
+      mat_sub_block<Matrix1> subA(A,N - i,k1 - i,i,i);
+      householder_prod(hhm,subA);
+      for(SizeType r = 0; r < N - i; ++r)
+        V(c + r, c) = hhm.v[r];
+      // form the triangular factor of the block reflector: H_0 ... H_c = I - V * T * V^T
+      T(c,c) = hhm.beta;
+      for(SizeType r = 0; r < c; ++r) {
+        ValueType z = ValueType(0.0);
+        for(SizeType l = c; l < nr; ++l)
+          z += V(l, r) * V(l, c);
+        T(r,c) = z;
+      };
+      for(SizeType r = 0; r < c; ++r) {
+        ValueType s = ValueType(0.0);
+        for(SizeType l = r; l < c; ++l)
+          s += T(r,l) * T(l,c);
+        T(r,c) = s;
+      };
+      for(SizeType r = 0; r < c; ++r)
+        T(r,c) *= -hhm.beta;
+    };
+
+    // apply the block reflector to the trailing columns: A2 = (I - V * T^T * V^T) * A2
+    if(k1 < M) {
+      SizeType nc = M - k1;
+      WorkMatrix W(kb, nc, ValueType(0.0));
+      block_gemm_impl(V, 0, 0, A, k0, k1, W, 0, 0, kb, nc, nr, ValueType(1.0), block_gemm_TN, aBlockSize, aThreadCount);
+      for(SizeType j = 0; j < nc; ++j) {
+        for(SizeType r = kb; r > 0; --r) {
+          ValueType s = ValueType(0.0);
+          for(SizeType l = 0; l < r; ++l)
+            s += T(l, r - 1) * W(l, j);
+          W(r - 1, j) = s;
+        };
+      };
+      block_gemm_impl(V, 0, 0, W, 0, 0, A, k0, k1, nr, nc, kb, ValueType(-1.0), block_gemm_NN, aBlockSize, aThreadCount);
+    };
+
+    // accumulate the block reflector in Q: Q2 = Q2 * (I - V * T * V^T)
+    if(Q) {
+      SizeType nq = Q->get_row_count();
+      WorkMatrix W(nq, kb, ValueType(0.0));
+      block_gemm_impl(*Q, 0, k0, V, 0, 0, W, 0, 0, nq, kb, nr, ValueType(1.0), block_gemm_NN, aBlockSize, 1);
+      for(SizeType i = 0; i < nq; ++i) {
+        for(SizeType c = kb; c > 0; --c) {
+          ValueType s = ValueType(0.0);
+          for(SizeType l = 0; l < c; ++l)
+            s += W(i, l) * T(l, c - 1);
+          W(i, c - 1) = s;
+        };
+      };
+      block_gemm_impl(W, 0, 0, V, 0, 0, *Q, 0, k0, nq, nr, kb, ValueType(-1.0), block_gemm_NT, aBlockSize, aThreadCount);
+    };
+  };
+};
+
+};
+
+
+/**
+ * Performs the QR decomposition on a matrix, using a blocked (right-looking) Householder
+ * reflections approach, see decompose_QR. Each panel of columns is factorized with Householder
+ * reflections which are then accumulated into a block reflector (I - V * T * V^T), applied to
+ * the trailing columns (and to Q) by matrix-multiplications. Matrices with less than twice the
+ * block-size in columns are decomposed with the un-blocked algorithm.
+ *
+ * \tparam Matrix1 A readable matrix type.
+ * \tparam Matrix2 A fully-writable matrix type.
+ * \tparam Matrix3 A writable matrix type.
+ * \param A rectangular matrix with row-count >= column-count, a real full-rank matrix.
+ * \param Q holds as output, the orthogonal rectangular matrix Q.
+ * \param R holds as output, the upper-triangular or right-triangular matrix R in A = QR.
+ * \param NumTol tolerance for considering a value to be zero in avoiding divisions
+ *               by zero and singularities.
+ * \param aBlockSize the number of columns in each block (panel) of the algorithm.
+ * \param aThreadCount the number of threads over which the trailing matrix updates are distributed.
+ *
+ * \throws std::range_error if the matrix A does not have equal-or-more rows than columns.
+ *
+ * \author Mikael Persson
+ */
+template <typename Matrix1, typename Matrix2, typename Matrix3>
+typename boost::enable_if_c< is_readable_matrix<Matrix1>::value &&
+                             is_fully_writable_matrix<Matrix2>::value &&
+                             is_writable_matrix<Matrix3>::value,
+void >::type decompose_QR_blocked(const Matrix1& A, Matrix2& Q, Matrix3& R, typename mat_traits<Matrix1>::value_type NumTol = 1E-8,
+                                  typename mat_traits<Matrix1>::size_type aBlockSize = 64, std::size_t aThreadCount = 1) {
+  if(A.get_row_count() < A.get_col_count())
+    throw std::range_error("QR decomposition is only possible on a matrix with row-count >= column-count!");
+
+  typedef typename mat_traits<Matrix1>::value_type ValueType;
+
+  Q = mat<ValueType,mat_structure::identity>(A.get_row_count());
+  mat<typename mat_traits<Matrix3>::value_type, mat_structure::rectangular> R_tmp(A);
+
+  if((aBlockSize == 0) || (A.get_col_count() < 2 * aBlockSize))
+    detail::decompose_QR_impl(R_tmp,&Q,NumTol);
+  else
+    detail::decompose_QR_blocked_impl(R_tmp,&Q,NumTol,aBlockSize,aThreadCount);
+  R = R_tmp;
+};
+
+
+
+/*************************************************************************
+                      Blocked PLU Decomposition
+*************************************************************************/
+
+namespace detail {
+
+template <typename Matrix1, typename Matrix2, typename IndexVector>
+void linsolve_PLU_blocked_impl(Matrix1& A, Matrix2& b, IndexVector& P, typename mat_traits<Matrix1>::value_type NumTol,
+                               typename mat_traits<Matrix1>::size_type aBlockSize, std::size_t aThreadCount) {
+  using std::swap;
+  using std::fabs;
+  typedef typename mat_traits<Matrix1>::value_type ValueType;
+  typedef typename mat_traits<Matrix1>::size_type SizeType;
+
+  SizeType N = A.get_row_count();
+  SizeType bn = b.get_col_count();
+  vect_n<ValueType> s(N, ValueType(0.0));
+
+  for(SizeType i = 0; i < N; ++i) {
+    P[i] = i;
+    for(SizeType j = 0; j < N; ++j)
+      if(s[i] < fabs(A(i,j)))
+        s[i] = fabs(A(i,j));
+    if(s[i] < NumTol)
+      throw singularity_error("A");
+  };
+
+  // right-looking LU decomposition (unit lower-triangular L) with scaled partial pivoting.
+  for(SizeType k0 = 0; k0 < N; k0 += aBlockSize) {
+    SizeType k1 = (k0 + aBlockSize < N ? k0 + aBlockSize : N);
+
+    // factorize the panel.
+    for(SizeType k = k0; k < k1; ++k) {
+      SizeType temp_i = k;
+      for(SizeType i = k + 1; i < N; ++i)
+        if(fabs(A(i,k) / s[i]) > fabs(A(temp_i,k) / s[temp_i]))
+          temp_i = i;
+      if(k != temp_i) {
+        for(SizeType j = 0; j < N; ++j)
+          swap(A(k,j), A(temp_i,j));
+        swap(s[k], s[temp_i]);
+        swap(P[k], P[temp_i]);
+      };
+      ValueType akk = A(k,k);
+      if(fabs(akk) < NumTol)
+        throw singularity_error("A");
+      for(SizeType i = k + 1; i < N; ++i)
+        A(i,k) /= akk;
+      for(SizeType j = k + 1; j < k1; ++j) {
+        ValueType akj = A(k,j);
+        for(SizeType i = k + 1; i < N; ++i)
+          A(i,j) -= A(i,k) * akj;
+      };
+    };
+    if(k1 == N)
+      break;
+
+    // solve for the block-row of U: U12 = L11^-1 * A12
+    for(SizeType j = k1; j < N; ++j) {
+      for(SizeType k = k0; k < k1; ++k) {
+        ValueType akj = A(k,j);
+        for(SizeType i = k + 1; i < k1; ++i)
+          A(i,j) -= A(i,k) * akj;
+      };
+    };
+
+    // update the trailing matrix: A22 -= L21 * U12
+    block_gemm_impl(A, k1, k0, A, k0, k1, A, k1, k1, N - k1, N - k1, k1 - k0, ValueType(-1.0), block_gemm_NN, aBlockSize, aThreadCount);
+  };
+
+  // forward- and back-substitution.
+  mat<ValueType,mat_structure::rectangular> x(N, bn);
+  for(SizeType l = 0; l < bn; ++l) {
+    for(SizeType k = 0; k < N; ++k)
+      x(k,l) = b(P[k],l);
+    for(SizeType k = 0; k < N; ++k) {
+      ValueType xk = x(k,l);
+      for(SizeType i = k + 1; i < N; ++i)
+        x(i,l) -= A(i,k) * xk;
+    };
+    for(SizeType k = N; k > 0; --k) {
+      x(k-1,l) /= A(k-1,k-1);
+      ValueType xk = x(k-1,l);
+      for(SizeType i = 0; i < k-1; ++i)
+        x(i,l) -= A(i,k-1) * xk;
+    };
+  };
+  b = x;
+
+  // convert to the Crout form of linsolve_PLU (L with diagonal, unit upper-triangular U).
+  for(SizeType k = 0; k < N; ++k) {
+    ValueType d = A(k,k);
+    for(SizeType i = k + 1; i < N; ++i)
+      A(i,k) *= d;
+    for(SizeType j = k + 1; j < N; ++j)
+      A(k,j) /= d;
+  };
+};
+
+};
+
+
+/**
+ * Solves the linear problem AX = B using a blocked (right-looking) PLU decomposition, see
+ * linsolve_PLU. Each panel of columns is factorized with partial pivoting, and the trailing
+ * matrix is updated by a matrix-multiplication of the panel with the corresponding block-row of U.
+ * Matrices with less than twice the block-size in rows are solved with the un-blocked algorithm.
+ * \note To solve a linear system involving vectors for X and B, use the Matrix-Vector Adaptors (mat_vector_adaptor.hpp).
+ *
+ * \tparam Matrix1 A writable matrix type.
+ * \tparam Matrix2 A writable matrix type.
+ * \tparam IndexVector A writable vector type.
+ * \param A well-conditioned, square (Size x Size), real, full-rank matrix which multiplies x.
+ *          As output, A stores the LU decomposition, permutated by P.
+ * \param b stores, as input, the RHS of the linear system of equation and stores, as output,
+ *          the solution matrix X (Size x B_ColCount).
+ * \param P vector of Size unsigned integer elements holding, as output, the permutations done
+ *          the rows of matrix A during the decomposition to LU.
+ * \param NumTol tolerance for considering a value to be zero in avoiding divisions
+ *               by zero.
+ * \param aBlockSize the number of columns in each block (panel) of the algorithm.
+ * \param aThreadCount the number of threads over which the trailing matrix updates are distributed.
+ *
+ * \throws singularity_error if the matrix A is numerically singular (or rank-deficient).
+ * \throws std::range_error if the matrix A is not square or if b's row count does not match that of A.
+ *
+ * \author Mikael Persson
+ */
+template <typename Matrix1, typename Matrix2, typename IndexVector>
+typename boost::enable_if_c< is_writable_matrix< Matrix1 >::value &&
+                             is_writable_matrix< Matrix2 >::value &&
+                             is_writable_vector< IndexVector >::value,
+void >::type linsolve_PLU_blocked(Matrix1& A, Matrix2& b, IndexVector& P, typename mat_traits<Matrix1>::value_type NumTol = 1E-8,
+                                  typename mat_traits<Matrix1>::size_type aBlockSize = 64, std::size_t aThreadCount = 1) {
+  if(A.get_col_count() != A.get_row_count())
+    throw std::range_error("PLU decomposition impossible! Matrix A is not square!");
+  if(b.get_row_count() != A.get_col_count())
+    throw std::range_error("PLU decomposition impossible! Matrix b must have same row count as A!");
+
+  P.resize(A.get_col_count());
+  if((aBlockSize == 0) || (A.get_row_count() < 2 * aBlockSize)) {
+    detail::linsolve_PLU_dispatch(A,b,P,NumTol);
+    return;
+  };
+  typedef typename mat_traits<Matrix1>::value_type ValueType;
+  typedef typename mat_traits<Matrix2>::value_type ValueType2;
+  mat<ValueType,mat_structure::square> A_tmp(A);
+  mat<ValueType2,mat_structure::rectangular> b_tmp(b);
+  detail::linsolve_PLU_blocked_impl(A_tmp,b_tmp,P,NumTol,aBlockSize,aThreadCount);
+  A = A_tmp;
+  b = b_tmp;
+};
+
+
+
+/**
+ * Inverts a matrix using a blocked (right-looking) PLU decomposition, see linsolve_PLU_blocked and invert_PLU.
+ *
+ * \tparam Matrix1 A readable matrix type.
+ * \tparam Matrix2 A fully-writable matrix type.
+ * \param A well-conditioned, square (Size x Size), real, full-rank matrix to be inverted.
+ * \param A_inv stores, as output, the inverse of matrix A.
+ * \param NumTol tolerance for considering a value to be zero in avoiding divisions
+ *               by zero.
+ * \param aBlockSize the number of columns in each block (panel) of the algorithm.
+ * \param aThreadCount the number of threads over which the trailing matrix updates are distributed.
+ *
+ * \throws singularity_error if the matrix A is numerically singular (or rank-deficient).
+ * \throws std::range_error if the matrix A is not square.
+ *
+ * \author Mikael Persson
+ */
+template <typename Matrix1, typename Matrix2>
+typename boost::enable_if_c< is_readable_matrix< Matrix1 >::value &&
+                             is_fully_writable_matrix< Matrix2 >::value,
+void >::type invert_PLU_blocked(const Matrix1& A, Matrix2& A_inv, typename mat_traits<Matrix1>::value_type NumTol = 1E-8,
+                                typename mat_traits<Matrix1>::size_type aBlockSize = 64, std::size_t aThreadCount = 1) {
+  typedef typename mat_traits<Matrix1>::value_type ValueType;
+
+  if(A.get_col_count() != A.get_row_count())
+    throw std::range_error("PLU decomposition impossible! Matrix A is not square!");
+
+  mat<ValueType,mat_structure::square> A_tmp(A);
+  A_inv = mat<ValueType,mat_structure::identity>(A.get_col_count());
+  vect_n<unsigned int> P(A.get_col_count());
+  linsolve_PLU_blocked(A_tmp,A_inv,P,NumTol,aBlockSize,aThreadCount);
+};
+
+};
+
+#endif
+
+
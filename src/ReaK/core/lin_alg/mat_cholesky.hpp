@@ -422,7 +422,7 @@ typename boost::enable_if_c< is_readable_matrix<Matrix1>::value &&
                               (mat_traits<Matrix1>::structure == mat_structure::symmetric) ||
                               (mat_traits<Matrix1>::structure == mat_structure::tridiagonal)) &&
                              is_writable_matrix<Matrix2>::value &&
-                             is_resizable_matrix<Matrix2>::value &&
+                             (is_resizable_matrix<Matrix2>::value || is_fully_writable_matrix<Matrix2>::value) &&
                              (mat_traits<Matrix2>::structure != mat_structure::lower_triangular),
 void >::type decompose_Cholesky(const Matrix1& A, Matrix2& L, typename mat_traits<Matrix1>::value_type NumTol = 1E-8) {
   L.set_col_count(A.get_col_count());
@@ -454,7 +454,8 @@ typename boost::enable_if_c< is_readable_matrix<Matrix1>::value &&
                              (mat_traits<Matrix2>::structure == mat_structure::lower_triangular),
 void >::type decompose_Cholesky(const Matrix1& A, Matrix2& L, typename mat_traits<Matrix1>::value_type NumTol = 1E-8) {
   typedef typename mat_traits<Matrix1>::value_type ValueType;
-  mat<ValueType, mat_structure::square> L_tmp(A.get_row_count(),ValueType(0));
+  typename mat_fix_or_dynamic<ValueType, mat_structure::square,
+                              mat_traits<Matrix1>::static_row_count, mat_traits<Matrix1>::static_col_count>::type L_tmp(A.get_row_count(),ValueType(0));
   detail::decompose_Cholesky_impl(A,L_tmp,NumTol);
   L = L_tmp;
 };
@@ -508,7 +509,8 @@ typename boost::enable_if_c< is_readable_matrix<Matrix>::value,
 typename mat_traits<Matrix>::value_type >::type determinant_Cholesky(const Matrix& A, typename mat_traits<Matrix>::value_type NumTol = 1E-8) {
   typedef typename mat_traits<Matrix>::value_type ValueType;
   typedef typename mat_traits<Matrix>::value_type SizeType;
-  mat<ValueType, mat_structure::square> L(A.get_row_count(),ValueType(0));
+  typename mat_fix_or_dynamic<ValueType, mat_structure::square,
+                              mat_traits<Matrix>::static_row_count, mat_traits<Matrix>::static_col_count>::type L(A.get_row_count(),ValueType(0));
   try {
     decompose_Cholesky(A,L,NumTol);
   } catch(singularity_error& e) {
@@ -549,7 +551,8 @@ void >::type linsolve_Cholesky(const Matrix1& A, Matrix2& b, typename mat_traits
     throw std::range_error("For linear equation solution, matrix b must have same row count as A!");
 
   typedef typename mat_traits<Matrix1>::value_type ValueType;
-  mat<ValueType,mat_structure::square> L(A.get_row_count(),ValueType(0));
+  typename mat_fix_or_dynamic<ValueType, mat_structure::square,
+                              mat_traits<Matrix1>::static_row_count, mat_traits<Matrix1>::static_col_count>::type L(A.get_row_count(),ValueType(0));
   detail::decompose_Cholesky_impl(A,L,NumTol);
   detail::backsub_Cholesky_impl(L,b);
 };
@@ -584,9 +587,11 @@ void >::type linsolve_Cholesky(const Matrix1& A, Matrix2& b, typename mat_traits
     throw std::range_error("For linear equation solution, matrix b must have same row count as A!");
 
   typedef typename mat_traits<Matrix1>::value_type ValueType;
-  mat<ValueType,mat_structure::square> L(A.get_row_count(),ValueType(0));
+  typename mat_fix_or_dynamic<ValueType, mat_structure::square,
+                              mat_traits<Matrix1>::static_row_count, mat_traits<Matrix1>::static_col_count>::type L(A.get_row_count(),ValueType(0));
   detail::decompose_Cholesky_impl(A,L,NumTol);
-  mat<typename mat_traits<Matrix2>::value_type, mat_structure::rectangular> b_tmp(b);
+  typename mat_fix_or_dynamic<typename mat_traits<Matrix2>::value_type, mat_structure::rectangular,
+                              mat_traits<Matrix2>::static_row_count, mat_traits<Matrix2>::static_col_count>::type b_tmp(b);
   detail::backsub_Cholesky_impl(L,b_tmp);
   b = b_tmp;
 };
@@ -774,9 +779,11 @@ typename boost::enable_if_c< is_readable_matrix<Matrix1>::value &&
 void >::type invert_Cholesky(const Matrix1& A, Matrix2& A_inv, typename mat_traits<Matrix1>::value_type NumTol = 1E-8) {
   typedef typename mat_traits<Matrix1>::value_type ValueType;
   
-  mat<ValueType,mat_structure::square> L;
+  typedef typename mat_fix_or_dynamic<ValueType, mat_structure::square,
+                                      mat_traits<Matrix1>::static_row_count, mat_traits<Matrix1>::static_col_count>::type SquareType;
+  SquareType L(A.get_row_count(),ValueType(0));
   decompose_Cholesky(A,L,NumTol);
-  mat<ValueType,mat_structure::square> result(mat<ValueType,mat_structure::identity>(A.get_col_count()));
+  SquareType result(mat<ValueType,mat_structure::identity>(A.get_col_count()));
   detail::backsub_Cholesky_impl(L,result);
   A_inv = result;
 };
@@ -1217,6 +1224,94 @@ void >::type invert_TriDiagLDL(const Matrix1& A, Matrix2& A_inv,
 
 
 
+/*************************************************************************
+                     Cholesky Rank-one Update / Downdate
+*************************************************************************/
+
+/**
+ * Performs a rank-one update of a Cholesky factor, that is, given L such that A = L * transpose(L),
+ * it computes the Cholesky factor of A + x * transpose(x), in-place, in O(N^2) operations (instead of
+ * the O(N^3) operations required for re-computing the decomposition).
+ *
+ * \param L stores, as input, the lower-triangular Cholesky factor of A, and stores, as output, the
+ *          lower-triangular Cholesky factor of A + x * transpose(x).
+ * \param x the vector of the rank-one update.
+ *
+ * \throws std::range_error if the size of x does not match the size of L.
+ * 
+ * \author Mikael Persson
+ */
+template <typename Matrix, typename Vector>
+typename boost::enable_if_c< is_fully_writable_matrix<Matrix>::value &&
+                             is_readable_vector<Vector>::value,
+void >::type update_Cholesky(Matrix& L, const Vector& x) {
+  typedef typename mat_traits<Matrix>::value_type ValueType;
+  typedef typename mat_traits<Matrix>::size_type SizeType;
+  using std::sqrt;
+  SizeType N = L.get_row_count();
+  if(x.size() != N)
+    throw std::range_error("For a Cholesky update, vector x must have the same size as L!");
+  vect_n<ValueType> w(N);
+  for(SizeType i = 0; i < N; ++i)
+    w[i] = x[i];
+  for(SizeType k = 0; k < N; ++k) {
+    ValueType r = sqrt(L(k,k) * L(k,k) + w[k] * w[k]);
+    ValueType c = r / L(k,k);
+    ValueType s = w[k] / L(k,k);
+    L(k,k) = r;
+    for(SizeType i = k + 1; i < N; ++i) {
+      L(i,k) = (L(i,k) + s * w[i]) / c;
+      w[i] = c * w[i] - s * L(i,k);
+    };
+  };
+};
+
+/**
+ * Performs a rank-one downdate of a Cholesky factor, that is, given L such that A = L * transpose(L),
+ * it computes the Cholesky factor of A - x * transpose(x), in-place, in O(N^2) operations (instead of
+ * the O(N^3) operations required for re-computing the decomposition).
+ *
+ * \param L stores, as input, the lower-triangular Cholesky factor of A, and stores, as output, the
+ *          lower-triangular Cholesky factor of A - x * transpose(x).
+ * \param x the vector of the rank-one downdate.
+ * \param NumTol tolerance for considering a value to be zero in avoiding divisions
+ *               by zero and singularities.
+ *
+ * \throws singularity_error if the downdated matrix is not positive-definite (L is left in an unspecified state).
+ * \throws std::range_error if the size of x does not match the size of L.
+ * 
+ * \author Mikael Persson
+ */
+template <typename Matrix, typename Vector>
+typename boost::enable_if_c< is_fully_writable_matrix<Matrix>::value &&
+                             is_readable_vector<Vector>::value,
+void >::type downdate_Cholesky(Matrix& L, const Vector& x, typename mat_traits<Matrix>::value_type NumTol = 1E-8) {
+  typedef typename mat_traits<Matrix>::value_type ValueType;
+  typedef typename mat_traits<Matrix>::size_type SizeType;
+  using std::sqrt;
+  SizeType N = L.get_row_count();
+  if(x.size() != N)
+    throw std::range_error("For a Cholesky downdate, vector x must have the same size as L!");
+  vect_n<ValueType> w(N);
+  for(SizeType i = 0; i < N; ++i)
+    w[i] = x[i];
+  for(SizeType k = 0; k < N; ++k) {
+    ValueType r2 = L(k,k) * L(k,k) - w[k] * w[k];
+    if(r2 < NumTol * NumTol)
+      throw singularity_error("L * transpose(L) - x * transpose(x)");
+    ValueType r = sqrt(r2);
+    ValueType c = r / L(k,k);
+    ValueType s = w[k] / L(k,k);
+    L(k,k) = r;
+    for(SizeType i = k + 1; i < N; ++i) {
+      L(i,k) = (L(i,k) - s * w[i]) / c;
+      w[i] = c * w[i] - s * L(i,k);
+    };
+  };
+};
+
+
+
 #if 0
 /**
  * Performs the Permuted LTL decomposition of A (symmetric matrix).
@@ -168,7 +168,8 @@ void linsolve_PLU_impl(Matrix1& A, Matrix2& b, IndexVector& P, typename mat_trai
   typedef typename mat_traits<Matrix1>::value_type ValueType;
   typedef typename mat_traits<Matrix1>::size_type SizeType;
   
-  mat<ValueType,mat_structure::rectangular,mat_alignment::column_major> s(b.get_row_count(),b.get_col_count());
+  typename mat_fix_or_dynamic<ValueType, mat_structure::rectangular,
+                              mat_traits<Matrix2>::static_row_count, mat_traits<Matrix2>::static_col_count>::type s(b.get_row_count(),b.get_col_count());
   SizeType An = A.get_row_count();
   SizeType bn = b.get_col_count();
   
@@ -210,7 +211,7 @@ void linsolve_PLU_impl(Matrix1& A, Matrix2& b, IndexVector& P, typename mat_trai
   // Back-substitution
   for(SizeType k=0;k<An;++k) {
     for(SizeType l=0;l<bn;++l)
-      s(P[k],l) = b(P[k],l);
+      s(k,l) = b(P[k],l);
 
     for(SizeType l=0;l<bn;++l) {
       for(SizeType j=0;j<k;++j)
@@ -242,7 +243,8 @@ typename boost::enable_if_c< !is_fully_writable_matrix< Matrix1 >::value &&
                              is_fully_writable_matrix< Matrix2 >::value, 
 void >::type linsolve_PLU_dispatch(Matrix1& A, Matrix2& b, IndexVector& P, typename mat_traits<Matrix1>::value_type NumTol) {
   typedef typename mat_traits<Matrix1>::value_type ValueType;
-  mat<ValueType,mat_structure::square> A_tmp(A);
+  typename mat_fix_or_dynamic<ValueType, mat_structure::square,
+                              mat_traits<Matrix1>::static_row_count, mat_traits<Matrix1>::static_col_count>::type A_tmp(A);
   linsolve_PLU_impl(A_tmp,b,P,NumTol);
   A = A_tmp;
 };
@@ -252,9 +254,11 @@ typename boost::enable_if_c< !is_fully_writable_matrix< Matrix1 >::value &&
                              !is_fully_writable_matrix< Matrix2 >::value, 
 void >::type linsolve_PLU_dispatch(Matrix1& A, Matrix2& b, IndexVector& P, typename mat_traits<Matrix1>::value_type NumTol) {
   typedef typename mat_traits<Matrix1>::value_type ValueType;
-  mat<ValueType,mat_structure::square> A_tmp(A);
+  typename mat_fix_or_dynamic<ValueType, mat_structure::square,
+                              mat_traits<Matrix1>::static_row_count, mat_traits<Matrix1>::static_col_count>::type A_tmp(A);
   typedef typename mat_traits<Matrix2>::value_type ValueType2;
-  mat<ValueType2,mat_structure::rectangular> b_tmp(b);
+  typename mat_fix_or_dynamic<ValueType2, mat_structure::rectangular,
+                              mat_traits<Matrix2>::static_row_count, mat_traits<Matrix2>::static_col_count>::type b_tmp(b);
   linsolve_PLU_impl(A_tmp,b_tmp,P,NumTol);
   A = A_tmp;
   b = b_tmp;
@@ -265,7 +269,8 @@ typename boost::enable_if_c< is_fully_writable_matrix< Matrix1 >::value &&
                              !is_fully_writable_matrix< Matrix2 >::value, 
 void >::type linsolve_PLU_dispatch(Matrix1& A, Matrix2& b, IndexVector& P, typename mat_traits<Matrix1>::value_type NumTol) {
   typedef typename mat_traits<Matrix2>::value_type ValueType2;
-  mat<ValueType2,mat_structure::rectangular> b_tmp(b);
+  typename mat_fix_or_dynamic<ValueType2, mat_structure::rectangular,
+                              mat_traits<Matrix2>::static_row_count, mat_traits<Matrix2>::static_col_count>::type b_tmp(b);
   linsolve_PLU_impl(A,b_tmp,P,NumTol);
   b = b_tmp;
 };
@@ -406,7 +411,8 @@ struct PLU_linsolver {
   template <typename Matrix1, typename Matrix2, typename Matrix3>
   void operator()(const Matrix1& A, Matrix2& X, const Matrix3& B, typename mat_traits<Matrix1>::value_type NumTol = 1E-8) {
     typedef typename mat_traits<Matrix1>::value_type ValueType;
-    mat<ValueType, mat_structure::square> A_tmp(A);
+    typename mat_fix_or_dynamic<ValueType, mat_structure::square,
+                                mat_traits<Matrix1>::static_row_count, mat_traits<Matrix1>::static_col_count>::type A_tmp(A);
     X = B;
     linsolve_PLU(A_tmp,X,NumTol);
   };
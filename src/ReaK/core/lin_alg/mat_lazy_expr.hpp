@@ -0,0 +1,1238 @@
+/**
+ * \file mat_lazy_expr.hpp
+ *
+ * This library provides a light-weight expression-template layer for the matrix and vector
+ * classes. Wrapping an operand with lazy_expr() makes the subsequent sums, differences, scalings,
+ * negations, transpositions and products build expression objects instead of result matrices.
+ * An expression is only evaluated when it is assigned to a destination (see lazy_assign(),
+ * lazy_add_assign() and lazy_sub_assign()), which is done in a single pass over the elements
+ * of the destination, without the intermediate temporaries that the eager operators of
+ * mat_operators.hpp create. The only sub-expressions that get evaluated into a temporary are
+ * the operands of a product (e.g., the product A * B in (A * B) * C), which are copied once
+ * into a row-major (left) or column-major (right) matrix such that every inner-product runs
+ * over contiguous memory, a copy that is cheap compared to the product itself.
+ *
+ * The expressions model the ReadableMatrixConcept (or the ReadableVectorConcept), and can thus
+ * be used anywhere a readable matrix (or vector) is expected. Because expressions refer to their
+ * operands, they should be consumed within the full-expression that creates them, e.g.:
+ *
+ *   lazy_assign(P, lazy_expr(A) * P * transpose(lazy_expr(A)) + Q);
+ *
+ * The assignment functions detect when the destination is also referred to within the expression
+ * in a way that prevents an element-wise evaluation (e.g., as the operand of a transposition),
+ * in which case the expression is first evaluated into a temporary. Aliasing can only be detected
+ * by address for matrices and vectors that own their elements; any other operand (e.g., a sub-block
+ * or transpose view) or destination is conservatively assumed to share storage with the other side,
+ * and is thus always evaluated through a temporary.
+ *
+ * \author Sven Mikael Persson <mikael.s.persson@gmail.com>
+ * \date June 2013
+ */
+
+/*
+ *    Copyright 2013 Sven Mikael Persson
+ *
+ *    THIS SOFTWARE IS DISTRIBUTED UNDER THE TERMS OF THE GNU GENERAL PUBLIC LICENSE v3 (GPLv3).
+ *
+ *    This file is part of ReaK.
+ *
+ *    ReaK is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    (at your option) any later version.
+ *
+ *    ReaK is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with ReaK (as LICENSE in the root folder).
+ *    If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef REAK_MAT_LAZY_EXPR_HPP
+#define REAK_MAT_LAZY_EXPR_HPP
+
+#include "mat_alg_general.hpp"
+#include "mat_alg_rectangular.hpp"
+#include "vect_alg.hpp"
+#include "vect_index_iterator.hpp"
+
+#include <boost/utility/enable_if.hpp>
+#include <boost/mpl/if.hpp>
+#include <boost/mpl/and.hpp>
+#include <boost/mpl/or.hpp>
+#include <boost/mpl/not.hpp>
+#include <boost/mpl/bool.hpp>
+
+#include <stdexcept>
+
+namespace ReaK {
+
+
+template <typename Node>
+class mat_expr;
+
+template <typename Node>
+class vect_expr;
+
+
+namespace detail {
+
+/*******************************************************************************
+                         Matrix Expression Nodes
+*******************************************************************************/
+
+/*
+ * This trait tells if a matrix or vector type owns its elements, such that two objects of
+ * such types can only share elements if they are the same object (same address). Views
+ * (e.g., sub-blocks, transposes, slices) do not own their elements, and can only be
+ * assumed to refer to any other matrix or vector.
+ */
+template <typename T>
+struct is_lazy_expr_storage : boost::mpl::false_ { };
+
+template <typename T, mat_structure::tag Structure, mat_alignment::tag Alignment, typename Allocator>
+struct is_lazy_expr_storage< mat<T,Structure,Alignment,Allocator> > : boost::mpl::true_ { };
+
+template <typename T, mat_structure::tag Structure, unsigned int RowCount, unsigned int ColCount, mat_alignment::tag Alignment>
+struct is_lazy_expr_storage< mat_fix<T,Structure,RowCount,ColCount,Alignment> > : boost::mpl::true_ { };
+
+template <typename T, unsigned int Size>
+struct is_lazy_expr_storage< vect<T,Size> > : boost::mpl::true_ { };
+
+template <typename T, typename Allocator>
+struct is_lazy_expr_storage< vect_n<T,Allocator> > : boost::mpl::true_ { };
+
+/*
+ * Returns the address under which a destination is checked for aliasing, or a null
+ * pointer if the destination is a view (whose storage is unknown).
+ */
+template <typename T>
+const void* lazy_expr_address(const T& x) {
+  return (is_lazy_expr_storage<T>::value ? static_cast<const void*>(&x) : static_cast<const void*>(0));
+};
+
+
+/*
+ * All expression nodes provide the element-wise accessor and the dimensions, and two
+ * aliasing queries:
+ *  - refers_to(p) tells if the object at address p is an operand of the expression;
+ *  - aliases(p) tells if an element-wise evaluation of the expression into the object
+ *    at address p would read elements of p that were already overwritten (i.e., if p
+ *    is read at other indices than the one being written).
+ * A null address p stands for a destination of unknown storage (a view), and leaf operands
+ * which are views report that they refer to (and alias) any address.
+ * The is_nested flag tells if the node should be evaluated into a temporary when it
+ * is used as the operand of a matrix-vector product.
+ */
+
+template <typename Matrix>
+class mat_expr_leaf {
+  public:
+    typedef typename mat_traits<Matrix>::value_type value_type;
+    typedef typename mat_traits<Matrix>::size_type size_type;
+    BOOST_STATIC_CONSTANT(bool, is_nested = false);
+
+  private:
+    const Matrix* m;
+
+  public:
+    explicit mat_expr_leaf(const Matrix& aM) : m(&aM) { };
+
+    value_type operator()(size_type i, size_type j) const { return (*m)(i,j); };
+    size_type get_row_count() const { return m->get_row_count(); };
+    size_type get_col_count() const { return m->get_col_count(); };
+
+    bool refers_to(const void* p) const { 
+      return !is_lazy_expr_storage<Matrix>::value || (p == 0) || (static_cast<const void*>(m) == p);
+    };
+    bool aliases(const void* p) const { return !is_lazy_expr_storage<Matrix>::value || (p == 0); };
+};
+
+template <typename T, mat_alignment::tag Alignment = mat_alignment::column_major>
+class mat_expr_value {
+  public:
+    typedef T value_type;
+    typedef typename mat<T,mat_structure::rectangular,Alignment>::size_type size_type;
+    BOOST_STATIC_CONSTANT(bool, is_nested = false);
+
+  private:
+    mat<T,mat_structure::rectangular,Alignment> m;
+
+  public:
+    template <typename Node>
+    explicit mat_expr_value(const Node& aNode) : m(aNode.get_row_count(), aNode.get_col_count()) {
+      const size_type RowCount = m.get_row_count();
+      const size_type ColCount = m.get_col_count();
+      if(Alignment == mat_alignment::row_major) {
+        for(size_type i = 0; i < RowCount; ++i)
+          for(size_type j = 0; j < ColCount; ++j)
+            m(i,j) = aNode(i,j);
+      } else {
+        for(size_type j = 0; j < ColCount; ++j)
+          for(size_type i = 0; i < RowCount; ++i)
+            m(i,j) = aNode(i,j);
+      };
+    };
+
+    value_type operator()(size_type i, size_type j) const { return m(i,j); };
+    size_type get_row_count() const { return m.get_row_count(); };
+    size_type get_col_count() const { return m.get_col_count(); };
+
+    bool refers_to(const void*) const { return false; };
+    bool aliases(const void*) const { return false; };
+};
+
+struct mat_expr_plus {
+  template <typename T>
+  static T apply(const T& a, const T& b) { return a + b; };
+};
+
+struct mat_expr_minus {
+  template <typename T>
+  static T apply(const T& a, const T& b) { return a - b; };
+};
+
+template <typename Node1, typename Node2, typename Op>
+class mat_expr_binary {
+  public:
+    typedef typename Node1::value_type value_type;
+    typedef typename Node1::size_type size_type;
+    BOOST_STATIC_CONSTANT(bool, is_nested = true);
+
+  private:
+    Node1 n1;
+    Node2 n2;
+
+  public:
+    mat_expr_binary(const Node1& aN1, const Node2& aN2) : n1(aN1), n2(aN2) {
+      if((n1.get_row_count() != n2.get_row_count()) || (n1.get_col_count() != n2.get_col_count()))
+        throw std::range_error("Matrix dimension mismatch.");
+    };
+
+    value_type operator()(size_type i, size_type j) const { return Op::apply(value_type(n1(i,j)), value_type(n2(i,j))); };
+    size_type get_row_count() const { return n1.get_row_count(); };
+    size_type get_col_count() const { return n1.get_col_count(); };
+
+    bool refers_to(const void* p) const { return n1.refers_to(p) || n2.refers_to(p); };
+    bool aliases(const void* p) const { return n1.aliases(p) || n2.aliases(p); };
+};
+
+template <typename Node>
+class mat_expr_scaled {
+  public:
+    typedef typename Node::value_type value_type;
+    typedef typename Node::size_type size_type;
+    BOOST_STATIC_CONSTANT(bool, is_nested = Node::is_nested);
+
+  private:
+    Node n;
+    value_type s;
+
+  public:
+    mat_expr_scaled(const Node& aN, const value_type& aS) : n(aN), s(aS) { };
+
+    value_type operator()(size_type i, size_type j) const { return n(i,j) * s; };
+    size_type get_row_count() const { return n.get_row_count(); };
+    size_type get_col_count() const { return n.get_col_count(); };
+
+    bool refers_to(const void* p) const { return n.refers_to(p); };
+    bool aliases(const void* p) const { return n.aliases(p); };
+};
+
+template <typename Node>
+class mat_expr_transposed {
+  public:
+    typedef typename Node::value_type value_type;
+    typedef typename Node::size_type size_type;
+    BOOST_STATIC_CONSTANT(bool, is_nested = Node::is_nested);
+
+  private:
+    Node n;
+
+  public:
+    explicit mat_expr_transposed(const Node& aN) : n(aN) { };
+
+    value_type operator()(size_type i, size_type j) const { return n(j,i); };
+    size_type get_row_count() const { return n.get_col_count(); };
+    size_type get_col_count() const { return n.get_row_count(); };
+
+    bool refers_to(const void* p) const { return n.refers_to(p); };
+    bool aliases(const void* p) const { return n.refers_to(p); };
+};
+
+/*
+ * The operands of a product are evaluated once, at construction, into matrices whose alignment
+ * makes the inner-products contiguous. Since the product no longer refers to its operands
+ * afterwards, it can never alias the destination.
+ */
+template <typename Node1, typename Node2>
+class mat_expr_product {
+  public:
+    typedef typename Node1::value_type value_type;
+    typedef typename Node1::size_type size_type;
+    BOOST_STATIC_CONSTANT(bool, is_nested = true);
+
+    typedef mat_expr_value<value_type, mat_alignment::row_major> first_type;
+    typedef mat_expr_value<value_type, mat_alignment::column_major> second_type;
+
+  private:
+    first_type n1;
+    second_type n2;
+
+  public:
+    mat_expr_product(const Node1& aN1, const Node2& aN2) : n1(aN1), n2(aN2) {
+      if(n1.get_col_count() != n2.get_row_count())
+        throw std::range_error("Matrix dimension mismatch.");
+    };
+
+    value_type operator()(size_type i, size_type j) const {
+      value_type result = value_type(0);
+      const size_type K = n1.get_col_count();
+      for(size_type k = 0; k < K; ++k)
+        result += n1(i,k) * n2(k,j);
+      return result;
+    };
+    size_type get_row_count() const { return n1.get_row_count(); };
+    size_type get_col_count() const { return n2.get_col_count(); };
+
+    bool refers_to(const void*) const { return false; };
+    bool aliases(const void*) const { return false; };
+};
+
+
+/*******************************************************************************
+                         Vector Expression Nodes
+*******************************************************************************/
+
+template <typename Vector>
+class vect_expr_leaf {
+  public:
+    typedef typename vect_traits<Vector>::value_type value_type;
+    typedef typename vect_traits<Vector>::size_type size_type;
+    BOOST_STATIC_CONSTANT(bool, is_nested = false);
+
+  private:
+    const Vector* v;
+
+  public:
+    explicit vect_expr_leaf(const Vector& aV) : v(&aV) { };
+
+    value_type operator[](size_type i) const { return (*v)[i]; };
+    size_type size() const { return v->size(); };
+
+    bool refers_to(const void* p) const { 
+      return !is_lazy_expr_storage<Vector>::value || (p == 0) || (static_cast<const void*>(v) == p);
+    };
+    bool aliases(const void* p) const { return !is_lazy_expr_storage<Vector>::value || (p == 0); };
+};
+
+template <typename T>
+class vect_expr_value {
+  public:
+    typedef T value_type;
+    typedef typename vect_n<T>::size_type size_type;
+    BOOST_STATIC_CONSTANT(bool, is_nested = false);
+
+  private:
+    vect_n<T> v;
+
+  public:
+    template <typename Node>
+    explicit vect_expr_value(const Node& aNode) : v(aNode.size()) {
+      for(size_type i = 0; i < v.size(); ++i)
+        v[i] = aNode[i];
+    };
+
+    value_type operator[](size_type i) const { return v[i]; };
+    size_type size() const { return v.size(); };
+
+    bool refers_to(const void*) const { return false; };
+    bool aliases(const void*) const { return false; };
+};
+
+template <typename Node1, typename Node2, typename Op>
+class vect_expr_binary {
+  public:
+    typedef typename Node1::value_type value_type;
+    typedef typename Node1::size_type size_type;
+    BOOST_STATIC_CONSTANT(bool, is_nested = true);
+
+  private:
+    Node1 n1;
+    Node2 n2;
+
+  public:
+    vect_expr_binary(const Node1& aN1, const Node2& aN2) : n1(aN1), n2(aN2) {
+      if(n1.size() != n2.size())
+        throw std::range_error("Vector size mismatch.");
+    };
+
+    value_type operator[](size_type i) const { return Op::apply(value_type(n1[i]), value_type(n2[i])); };
+    size_type size() const { return n1.size(); };
+
+    bool refers_to(const void* p) const { return n1.refers_to(p) || n2.refers_to(p); };
+    bool aliases(const void* p) const { return n1.aliases(p) || n2.aliases(p); };
+};
+
+template <typename Node>
+class vect_expr_scaled {
+  public:
+    typedef typename Node::value_type value_type;
+    typedef typename Node::size_type size_type;
+    BOOST_STATIC_CONSTANT(bool, is_nested = Node::is_nested);
+
+  private:
+    Node n;
+    value_type s;
+
+  public:
+    vect_expr_scaled(const Node& aN, const value_type& aS) : n(aN), s(aS) { };
+
+    value_type operator[](size_type i) const { return n[i] * s; };
+    size_type size() const { return n.size(); };
+
+    bool refers_to(const void* p) const { return n.refers_to(p); };
+    bool aliases(const void* p) const { return n.aliases(p); };
+};
+
+template <typename MatNode, typename VectNode>
+class mat_vect_expr_product {
+  public:
+    typedef typename MatNode::value_type value_type;
+    typedef typename MatNode::size_type size_type;
+    BOOST_STATIC_CONSTANT(bool, is_nested = true);
+
+    typedef typename boost::mpl::if_c< MatNode::is_nested,
+      mat_expr_value<value_type>,
+      MatNode >::type first_type;
+    typedef typename boost::mpl::if_c< VectNode::is_nested,
+      vect_expr_value<value_type>,
+      VectNode >::type second_type;
+
+  private:
+    first_type m;
+    second_type v;
+
+  public:
+    mat_vect_expr_product(const MatNode& aM, const VectNode& aV) : m(aM), v(aV) {
+      if(m.get_col_count() != v.size())
+        throw std::range_error("Matrix dimension mismatch.");
+    };
+
+    value_type operator[](size_type i) const {
+      value_type result = value_type(0);
+      for(size_type j = 0; j < m.get_col_count(); ++j)
+        result += m(i,j) * v[j];
+      return result;
+    };
+    size_type size() const { return m.get_row_count(); };
+
+    bool refers_to(const void* p) const { return m.refers_to(p) || v.refers_to(p); };
+    bool aliases(const void* p) const { return refers_to(p); };
+};
+
+
+};
+
+
+
+/*******************************************************************************
+                         Expression Classes
+*******************************************************************************/
+
+/**
+ * This class template is the matrix expression type produced by the lazy operators. It
+ * models the ReadableMatrixConcept, each element being evaluated upon access. Expressions
+ * are normally created with lazy_expr() and consumed by lazy_assign() (or by the constructor
+ * of a matrix type), within the same full-expression.
+ * \tparam Node The expression-node type (see detail namespace).
+ */
+template <typename Node>
+class mat_expr {
+  public:
+    typedef mat_expr<Node> self;
+    typedef Node node_type;
+    typedef void allocator_type;
+
+    typedef typename Node::value_type value_type;
+
+    typedef void reference;
+    typedef value_type const_reference;
+    typedef void pointer;
+    typedef void const_pointer;
+
+    typedef void row_iterator;
+    typedef void const_row_iterator;
+    typedef void col_iterator;
+    typedef void const_col_iterator;
+
+    typedef typename Node::size_type size_type;
+    typedef std::ptrdiff_t difference_type;
+
+    BOOST_STATIC_CONSTANT(std::size_t, static_row_count = 0);
+    BOOST_STATIC_CONSTANT(std::size_t, static_col_count = 0);
+    BOOST_STATIC_CONSTANT(mat_alignment::tag, alignment = mat_alignment::column_major);
+    BOOST_STATIC_CONSTANT(mat_structure::tag, structure = mat_structure::rectangular);
+
+  private:
+    Node n;
+
+  public:
+    /**
+     * Constructs the expression from its root node.
+     */
+    explicit mat_expr(const Node& aNode) : n(aNode) { };
+
+    /**
+     * Matrix indexing accessor for read-only access, evaluates the given element.
+     * \param i Row index.
+     * \param j Column index.
+     * \return the element at the given position.
+     */
+    value_type operator()(size_type i, size_type j) const { return n(i,j); };
+
+    /**
+     * Gets the row-count (number of rows) of the matrix.
+     * \return number of rows of the matrix.
+     */
+    size_type get_row_count() const { return n.get_row_count(); };
+    /**
+     * Gets the column-count (number of columns) of the matrix.
+     * \return number of columns of the matrix.
+     */
+    size_type get_col_count() const { return n.get_col_count(); };
+    /**
+     * Gets the row-count and column-count of the matrix, as a std::pair of values.
+     * \return the row-count and column-count of the matrix, as a std::pair of values.
+     */
+    std::pair<size_type,size_type> size() const { return std::make_pair(n.get_row_count(),n.get_col_count()); };
+
+    /**
+     * Returns the root node of the expression.
+     */
+    const Node& get_node() const { return n; };
+
+};
+
+template <typename Node>
+struct is_readable_matrix< mat_expr<Node> > {
+  BOOST_STATIC_CONSTANT( bool, value = true );
+  typedef is_readable_matrix< mat_expr<Node> > type;
+};
+
+template <typename Node>
+struct is_writable_matrix< mat_expr<Node> > {
+  BOOST_STATIC_CONSTANT( bool, value = false );
+  typedef is_writable_matrix< mat_expr<Node> > type;
+};
+
+template <typename Node>
+struct is_fully_writable_matrix< mat_expr<Node> > {
+  BOOST_STATIC_CONSTANT( bool, value = false );
+  typedef is_fully_writable_matrix< mat_expr<Node> > type;
+};
+
+template <typename Node>
+struct is_resizable_matrix< mat_expr<Node> > {
+  BOOST_STATIC_CONSTANT( bool, value = false );
+  typedef is_resizable_matrix< mat_expr<Node> > type;
+};
+
+template <typename Node>
+struct has_allocator_matrix< mat_expr<Node> > {
+  BOOST_STATIC_CONSTANT( bool, value = false );
+  typedef has_allocator_matrix< mat_expr<Node> > type;
+};
+
+// the highest priority makes the structure-specific eager products step aside for the lazy ones.
+template <typename Node>
+struct mat_product_priority< mat_expr<Node> > {
+  typedef boost::mpl::integral_c_tag tag;
+  typedef std::size_t value_type;
+  BOOST_STATIC_CONSTANT(std::size_t, value = detail::product_priority<mat_structure::nil>::value + 1);
+  typedef mat_product_priority< mat_expr<Node> > type;
+};
+
+
+/**
+ * This class template is the vector expression type produced by the lazy operators. It
+ * models the ReadableVectorConcept, each element being evaluated upon access.
+ * \tparam Node The expression-node type (see detail namespace).
+ */
+template <typename Node>
+class vect_expr {
+  public:
+    typedef vect_expr<Node> self;
+    typedef Node node_type;
+    typedef void allocator_type;
+
+    typedef typename Node::value_type value_type;
+
+    typedef void reference;
+    typedef value_type const_reference;
+    typedef void pointer;
+    typedef void const_pointer;
+
+    typedef void iterator;
+    typedef vect_index_const_iter<self> const_iterator;
+
+    typedef typename Node::size_type size_type;
+    typedef std::ptrdiff_t difference_type;
+
+    BOOST_STATIC_CONSTANT(std::size_t, dimensions = 0);
+
+  private:
+    Node n;
+
+  public:
+    /**
+     * Constructs the expression from its root node.
+     */
+    explicit vect_expr(const Node& aNode) : n(aNode) { };
+
+    /**
+     * Vector indexing accessor for read-only access, evaluates the given element.
+     * \param i Index.
+     * \return the element at the given position.
+     */
+    value_type operator[](size_type i) const { return n[i]; };
+    /**
+     * Vector indexing operator, accessor for read only.
+     */
+    value_type operator()(size_type i) const { return n[i]; };
+
+    /**
+     * Gets the size of the vector.
+     * \return number of elements of the vector.
+     */
+    size_type size() const { return n.size(); };
+
+    /**
+     * Returns a const-iterator to the first element of the vector.
+     */
+    const_iterator begin() const { return const_iterator(*this,0); };
+    /**
+     * Returns a const-iterator to the one-past-last element of the vector.
+     */
+    const_iterator end() const { return const_iterator(*this); };
+
+    /**
+     * Returns the root node of the expression.
+     */
+    const Node& get_node() const { return n; };
+
+};
+
+template <typename Node>
+struct is_readable_vector< vect_expr<Node> > {
+  BOOST_STATIC_CONSTANT( bool, value = true );
+  typedef is_readable_vector< vect_expr<Node> > type;
+};
+
+template <typename Node>
+struct is_writable_vector< vect_expr<Node> > {
+  BOOST_STATIC_CONSTANT( bool, value = false );
+  typedef is_writable_vector< vect_expr<Node> > type;
+};
+
+template <typename Node>
+struct is_resizable_vector< vect_expr<Node> > {
+  BOOST_STATIC_CONSTANT( bool, value = false );
+  typedef is_resizable_vector< vect_expr<Node> > type;
+};
+
+template <typename Node>
+struct has_allocator_vector< vect_expr<Node> > {
+  BOOST_STATIC_CONSTANT( bool, value = false );
+  typedef has_allocator_vector< vect_expr<Node> > type;
+};
+
+template <typename Node>
+struct vect_copy< vect_expr<Node> > {
+  typedef vect_n< typename Node::value_type > type;
+};
+
+
+
+/*******************************************************************************
+                         Expression Factories
+*******************************************************************************/
+
+/**
+ * Wraps a readable matrix as the operand of a lazy expression.
+ * \param M The matrix operand (which must outlive the expression).
+ * \return A matrix expression referring to M.
+ */
+template <typename Matrix>
+typename boost::enable_if_c< is_readable_matrix<Matrix>::value,
+mat_expr< detail::mat_expr_leaf<Matrix> > >::type lazy_expr(const Matrix& M) {
+  return mat_expr< detail::mat_expr_leaf<Matrix> >(detail::mat_expr_leaf<Matrix>(M));
+};
+
+/**
+ * Wraps a matrix expression as the operand of a lazy expression (no-op).
+ */
+template <typename Node>
+const mat_expr<Node>& lazy_expr(const mat_expr<Node>& E) {
+  return E;
+};
+
+/**
+ * Wraps a readable vector as the operand of a lazy expression.
+ * \param V The vector operand (which must outlive the expression).
+ * \return A vector expression referring to V.
+ */
+template <typename Vector>
+typename boost::enable_if_c< is_readable_vector<Vector>::value,
+vect_expr< detail::vect_expr_leaf<Vector> > >::type lazy_expr(const Vector& V) {
+  return vect_expr< detail::vect_expr_leaf<Vector> >(detail::vect_expr_leaf<Vector>(V));
+};
+
+/**
+ * Wraps a vector expression as the operand of a lazy expression (no-op).
+ */
+template <typename Node>
+const vect_expr<Node>& lazy_expr(const vect_expr<Node>& E) {
+  return E;
+};
+
+
+
+/*******************************************************************************
+                         Matrix Expression Operators
+*******************************************************************************/
+
+/**
+ * Lazy addition of two matrix expressions.
+ */
+template <typename Node1, typename Node2>
+mat_expr< detail::mat_expr_binary<Node1, Node2, detail::mat_expr_plus> >
+  operator +(const mat_expr<Node1>& E1, const mat_expr<Node2>& E2) {
+  typedef detail::mat_expr_binary<Node1, Node2, detail::mat_expr_plus> node_type;
+  return mat_expr< node_type >(node_type(E1.get_node(), E2.get_node()));
+};
+
+/**
+ * Lazy addition of a matrix expression and a matrix.
+ */
+template <typename Node1, typename Matrix2>
+typename boost::enable_if_c< is_readable_matrix<Matrix2>::value,
+mat_expr< detail::mat_expr_binary<Node1, detail::mat_expr_leaf<Matrix2>, detail::mat_expr_plus> > >::type
+  operator +(const mat_expr<Node1>& E1, const Matrix2& M2) {
+  return E1 + lazy_expr(M2);
+};
+
+/**
+ * Lazy addition of a matrix and a matrix expression.
+ */
+template <typename Matrix1, typename Node2>
+typename boost::enable_if_c< is_readable_matrix<Matrix1>::value,
+mat_expr< detail::mat_expr_binary<detail::mat_expr_leaf<Matrix1>, Node2, detail::mat_expr_plus> > >::type
+  operator +(const Matrix1& M1, const mat_expr<Node2>& E2) {
+  return lazy_expr(M1) + E2;
+};
+
+/**
+ * Lazy subtraction of two matrix expressions.
+ */
+template <typename Node1, typename Node2>
+mat_expr< detail::mat_expr_binary<Node1, Node2, detail::mat_expr_minus> >
+  operator -(const mat_expr<Node1>& E1, const mat_expr<Node2>& E2) {
+  typedef detail::mat_expr_binary<Node1, Node2, detail::mat_expr_minus> node_type;
+  return mat_expr< node_type >(node_type(E1.get_node(), E2.get_node()));
+};
+
+/**
+ * Lazy subtraction of a matrix from a matrix expression.
+ */
+template <typename Node1, typename Matrix2>
+typename boost::enable_if_c< is_readable_matrix<Matrix2>::value,
+mat_expr< detail::mat_expr_binary<Node1, detail::mat_expr_leaf<Matrix2>, detail::mat_expr_minus> > >::type
+  operator -(const mat_expr<Node1>& E1, const Matrix2& M2) {
+  return E1 - lazy_expr(M2);
+};
+
+/**
+ * Lazy subtraction of a matrix expression from a matrix.
+ */
+template <typename Matrix1, typename Node2>
+typename boost::enable_if_c< is_readable_matrix<Matrix1>::value,
+mat_expr< detail::mat_expr_binary<detail::mat_expr_leaf<Matrix1>, Node2, detail::mat_expr_minus> > >::type
+  operator -(const Matrix1& M1, const mat_expr<Node2>& E2) {
+  return lazy_expr(M1) - E2;
+};
+
+/**
+ * Lazy negation of a matrix expression.
+ */
+template <typename Node>
+mat_expr< detail::mat_expr_scaled<Node> > operator -(const mat_expr<Node>& E) {
+  typedef detail::mat_expr_scaled<Node> node_type;
+  return mat_expr< node_type >(node_type(E.get_node(), typename Node::value_type(-1)));
+};
+
+/**
+ * Lazy multiplication of a matrix expression by a scalar.
+ */
+template <typename Node, typename Scalar>
+typename boost::enable_if<
+  boost::mpl::and_<
+    boost::mpl::not_< is_readable_matrix< Scalar > >,
+    boost::mpl::not_< is_readable_vector< Scalar > >
+  >,
+mat_expr< detail::mat_expr_scaled<Node> > >::type operator *(const mat_expr<Node>& E, const Scalar& S) {
+  typedef detail::mat_expr_scaled<Node> node_type;
+  return mat_expr< node_type >(node_type(E.get_node(), S));
+};
+
+/**
+ * Lazy multiplication of a matrix expression by a scalar.
+ */
+template <typename Node, typename Scalar>
+typename boost::enable_if<
+  boost::mpl::and_<
+    boost::mpl::not_< is_readable_matrix< Scalar > >,
+    boost::mpl::not_< is_readable_vector< Scalar > >
+  >,
+mat_expr< detail::mat_expr_scaled<Node> > >::type operator *(const Scalar& S, const mat_expr<Node>& E) {
+  typedef detail::mat_expr_scaled<Node> node_type;
+  return mat_expr< node_type >(node_type(E.get_node(), S));
+};
+
+/**
+ * Lazy division of a matrix expression by a scalar.
+ */
+template <typename Node, typename Scalar>
+typename boost::enable_if<
+  boost::mpl::and_<
+    boost::mpl::not_< is_readable_matrix< Scalar > >,
+    boost::mpl::not_< is_readable_vector< Scalar > >
+  >,
+mat_expr< detail::mat_expr_scaled<Node> > >::type operator /(const mat_expr<Node>& E, const Scalar& S) {
+  typedef detail::mat_expr_scaled<Node> node_type;
+  typedef typename Node::value_type ValueType;
+  return mat_expr< node_type >(node_type(E.get_node(), ValueType(1) / ValueType(S)));
+};
+
+/**
+ * Lazy transposition of a matrix expression.
+ */
+template <typename Node>
+mat_expr< detail::mat_expr_transposed<Node> > transpose(const mat_expr<Node>& E) {
+  typedef detail::mat_expr_transposed<Node> node_type;
+  return mat_expr< node_type >(node_type(E.get_node()));
+};
+
+/**
+ * Lazy multiplication of two matrix expressions. Operands which are sums, differences or
+ * products themselves are evaluated once, into a temporary, when the product is created.
+ */
+template <typename Node1, typename Node2>
+mat_expr< detail::mat_expr_product<Node1, Node2> >
+  operator *(const mat_expr<Node1>& E1, const mat_expr<Node2>& E2) {
+  typedef detail::mat_expr_product<Node1, Node2> node_type;
+  return mat_expr< node_type >(node_type(E1.get_node(), E2.get_node()));
+};
+
+/**
+ * Lazy multiplication of a matrix expression and a matrix.
+ */
+template <typename Node1, typename Matrix2>
+typename boost::enable_if_c< is_readable_matrix<Matrix2>::value,
+mat_expr< detail::mat_expr_product<Node1, detail::mat_expr_leaf<Matrix2> > > >::type
+  operator *(const mat_expr<Node1>& E1, const Matrix2& M2) {
+  return E1 * lazy_expr(M2);
+};
+
+/**
+ * Lazy multiplication of a matrix and a matrix expression.
+ */
+template <typename Matrix1, typename Node2>
+typename boost::enable_if_c< is_readable_matrix<Matrix1>::value,
+mat_expr< detail::mat_expr_product<detail::mat_expr_leaf<Matrix1>, Node2> > >::type
+  operator *(const Matrix1& M1, const mat_expr<Node2>& E2) {
+  return lazy_expr(M1) * E2;
+};
+
+
+
+/*******************************************************************************
+                         Vector Expression Operators
+*******************************************************************************/
+
+/**
+ * Lazy addition of two vector expressions.
+ */
+template <typename Node1, typename Node2>
+vect_expr< detail::vect_expr_binary<Node1, Node2, detail::mat_expr_plus> >
+  operator +(const vect_expr<Node1>& E1, const vect_expr<Node2>& E2) {
+  typedef detail::vect_expr_binary<Node1, Node2, detail::mat_expr_plus> node_type;
+  return vect_expr< node_type >(node_type(E1.get_node(), E2.get_node()));
+};
+
+/**
+ * Lazy addition of a vector expression and a vector.
+ */
+template <typename Node1, typename Vector2>
+typename boost::enable_if_c< is_readable_vector<Vector2>::value,
+vect_expr< detail::vect_expr_binary<Node1, detail::vect_expr_leaf<Vector2>, detail::mat_expr_plus> > >::type
+  operator +(const vect_expr<Node1>& E1, const Vector2& V2) {
+  return E1 + lazy_expr(V2);
+};
+
+/**
+ * Lazy addition of a vector and a vector expression.
+ */
+template <typename Vector1, typename Node2>
+typename boost::enable_if_c< is_readable_vector<Vector1>::value,
+vect_expr< detail::vect_expr_binary<detail::vect_expr_leaf<Vector1>, Node2, detail::mat_expr_plus> > >::type
+  operator +(const Vector1& V1, const vect_expr<Node2>& E2) {
+  return lazy_expr(V1) + E2;
+};
+
+/**
+ * Lazy subtraction of two vector expressions.
+ */
+template <typename Node1, typename Node2>
+vect_expr< detail::vect_expr_binary<Node1, Node2, detail::mat_expr_minus> >
+  operator -(const vect_expr<Node1>& E1, const vect_expr<Node2>& E2) {
+  typedef detail::vect_expr_binary<Node1, Node2, detail::mat_expr_minus> node_type;
+  return vect_expr< node_type >(node_type(E1.get_node(), E2.get_node()));
+};
+
+/**
+ * Lazy subtraction of a vector from a vector expression.
+ */
+template <typename Node1, typename Vector2>
+typename boost::enable_if_c< is_readable_vector<Vector2>::value,
+vect_expr< detail::vect_expr_binary<Node1, detail::vect_expr_leaf<Vector2>, detail::mat_expr_minus> > >::type
+  operator -(const vect_expr<Node1>& E1, const Vector2& V2) {
+  return E1 - lazy_expr(V2);
+};
+
+/**
+ * Lazy subtraction of a vector expression from a vector.
+ */
+template <typename Vector1, typename Node2>
+typename boost::enable_if_c< is_readable_vector<Vector1>::value,
+vect_expr< detail::vect_expr_binary<detail::vect_expr_leaf<Vector1>, Node2, detail::mat_expr_minus> > >::type
+  operator -(const Vector1& V1, const vect_expr<Node2>& E2) {
+  return lazy_expr(V1) - E2;
+};
+
+/**
+ * Lazy negation of a vector expression.
+ */
+template <typename Node>
+vect_expr< detail::vect_expr_scaled<Node> > operator -(const vect_expr<Node>& E) {
+  typedef detail::vect_expr_scaled<Node> node_type;
+  return vect_expr< node_type >(node_type(E.get_node(), typename Node::value_type(-1)));
+};
+
+/**
+ * Lazy multiplication of a vector expression by a scalar.
+ */
+template <typename Node, typename Scalar>
+typename boost::enable_if<
+  boost::mpl::and_<
+    boost::mpl::not_< is_readable_matrix< Scalar > >,
+    boost::mpl::not_< is_readable_vector< Scalar > >
+  >,
+vect_expr< detail::vect_expr_scaled<Node> > >::type operator *(const vect_expr<Node>& E, const Scalar& S) {
+  typedef detail::vect_expr_scaled<Node> node_type;
+  return vect_expr< node_type >(node_type(E.get_node(), S));
+};
+
+/**
+ * Lazy multiplication of a vector expression by a scalar.
+ */
+template <typename Node, typename Scalar>
+typename boost::enable_if<
+  boost::mpl::and_<
+    boost::mpl::not_< is_readable_matrix< Scalar > >,
+    boost::mpl::not_< is_readable_vector< Scalar > >
+  >,
+vect_expr< detail::vect_expr_scaled<Node> > >::type operator *(const Scalar& S, const vect_expr<Node>& E) {
+  typedef detail::vect_expr_scaled<Node> node_type;
+  return vect_expr< node_type >(node_type(E.get_node(), S));
+};
+
+/**
+ * Lazy division of a vector expression by a scalar.
+ */
+template <typename Node, typename Scalar>
+typename boost::enable_if<
+  boost::mpl::and_<
+    boost::mpl::not_< is_readable_matrix< Scalar > >,
+    boost::mpl::not_< is_readable_vector< Scalar > >
+  >,
+vect_expr< detail::vect_expr_scaled<Node> > >::type operator /(const vect_expr<Node>& E, const Scalar& S) {
+  typedef detail::vect_expr_scaled<Node> node_type;
+  typedef typename Node::value_type ValueType;
+  return vect_expr< node_type >(node_type(E.get_node(), ValueType(1) / ValueType(S)));
+};
+
+/**
+ * Lazy multiplication of a matrix expression and a (column) vector expression.
+ */
+template <typename MatNode, typename VectNode>
+vect_expr< detail::mat_vect_expr_product<MatNode, VectNode> >
+  operator *(const mat_expr<MatNode>& E, const vect_expr<VectNode>& V) {
+  typedef detail::mat_vect_expr_product<MatNode, VectNode> node_type;
+  return vect_expr< node_type >(node_type(E.get_node(), V.get_node()));
+};
+
+/**
+ * Lazy multiplication of a matrix expression and a (column) vector.
+ */
+template <typename MatNode, typename Vector>
+typename boost::enable_if_c< is_readable_vector<Vector>::value,
+vect_expr< detail::mat_vect_expr_product<MatNode, detail::vect_expr_leaf<Vector> > > >::type
+  operator *(const mat_expr<MatNode>& E, const Vector& V) {
+  return E * lazy_expr(V);
+};
+
+/**
+ * Lazy multiplication of a matrix and a (column) vector expression.
+ */
+template <typename Matrix, typename VectNode>
+typename boost::enable_if_c< is_readable_matrix<Matrix>::value,
+vect_expr< detail::mat_vect_expr_product<detail::mat_expr_leaf<Matrix>, VectNode> > >::type
+  operator *(const Matrix& M, const vect_expr<VectNode>& V) {
+  return lazy_expr(M) * V;
+};
+
+
+
+/*******************************************************************************
+                         Expression Evaluation
+*******************************************************************************/
+
+namespace detail {
+
+struct lazy_assign_op {
+  template <typename T, typename U>
+  static void apply(T& lhs, const U& rhs) { lhs = rhs; };
+};
+
+struct lazy_add_assign_op {
+  template <typename T, typename U>
+  static void apply(T& lhs, const U& rhs) { lhs += rhs; };
+};
+
+struct lazy_sub_assign_op {
+  template <typename T, typename U>
+  static void apply(T& lhs, const U& rhs) { lhs -= rhs; };
+};
+
+template <typename Op, typename Matrix, typename Node>
+void lazy_eval_mat_impl(Matrix& M, const Node& N) {
+  typedef typename mat_traits<Matrix>::size_type SizeType;
+  const SizeType RowCount = N.get_row_count();
+  const SizeType ColCount = N.get_col_count();
+  if(!is_fully_writable_matrix<Matrix>::value) {
+    // symmetric destination: only the upper-triangular part is evaluated.
+    for(SizeType j = 0; j < ColCount; ++j)
+      for(SizeType i = 0; i <= j; ++i)
+        Op::apply(M(i,j), N(i,j));
+  } else if(mat_traits<Matrix>::alignment == mat_alignment::row_major) {
+    for(SizeType i = 0; i < RowCount; ++i)
+      for(SizeType j = 0; j < ColCount; ++j)
+        Op::apply(M(i,j), N(i,j));
+  } else {
+    for(SizeType j = 0; j < ColCount; ++j)
+      for(SizeType i = 0; i < RowCount; ++i)
+        Op::apply(M(i,j), N(i,j));
+  };
+};
+
+template <typename Matrix, typename Matrix2>
+void lazy_eval_mat_fallback(Matrix& M, const Matrix2& M2, lazy_assign_op*) {
+  M = M2;
+};
+
+template <typename Matrix, typename Matrix2>
+void lazy_eval_mat_fallback(Matrix& M, const Matrix2& M2, lazy_add_assign_op*) {
+  M += M2;
+};
+
+template <typename Matrix, typename Matrix2>
+void lazy_eval_mat_fallback(Matrix& M, const Matrix2& M2, lazy_sub_assign_op*) {
+  M -= M2;
+};
+
+// fully writable or symmetric destinations are evaluated element-wise.
+template <typename Op, typename Matrix, typename Node>
+void lazy_eval_mat(Matrix& M, const mat_expr<Node>& E, boost::mpl::true_) {
+  typedef typename mat_traits<Matrix>::value_type ValueType;
+  // a destination which is not fully writable (i.e., symmetric) also writes the mirrored elements.
+  const void* p = lazy_expr_address(M);
+  if(E.get_node().aliases(p) || (!is_fully_writable_matrix<Matrix>::value && E.get_node().refers_to(p)))
+    lazy_eval_mat_impl<Op>(M, mat_expr_value<ValueType>(E.get_node()));
+  else
+    lazy_eval_mat_impl<Op>(M, E.get_node());
+};
+
+// other writable destinations (e.g., diagonal) rely on their own assignment operators.
+template <typename Op, typename Matrix, typename Node>
+void lazy_eval_mat(Matrix& M, const mat_expr<Node>& E, boost::mpl::false_) {
+  typedef typename mat_traits<Matrix>::value_type ValueType;
+  mat<ValueType, mat_structure::rectangular> tmp(E);
+  lazy_eval_mat_fallback(M, tmp, static_cast<Op*>(0));
+};
+
+template <typename Op, typename Vector, typename Node>
+void lazy_eval_vect(Vector& V, const vect_expr<Node>& E) {
+  typedef typename vect_traits<Vector>::value_type ValueType;
+  typedef typename vect_traits<Vector>::size_type SizeType;
+  if(E.get_node().aliases(lazy_expr_address(V))) {
+    vect_expr_value<ValueType> tmp(E.get_node());
+    for(SizeType i = 0; i < V.size(); ++i)
+      Op::apply(V[i], tmp[i]);
+  } else {
+    for(SizeType i = 0; i < V.size(); ++i)
+      Op::apply(V[i], E.get_node()[i]);
+  };
+};
+
+template <typename Matrix, typename Node>
+void lazy_resize_mat(Matrix& M, const mat_expr<Node>& E, boost::mpl::true_) {
+  M = E;
+};
+
+template <typename Matrix, typename Node>
+void lazy_resize_mat(Matrix&, const mat_expr<Node>&, boost::mpl::false_) {
+  throw std::range_error("Matrix dimension mismatch.");
+};
+
+template <typename Vector, typename Node>
+void lazy_resize_vect(Vector& V, const vect_expr<Node>& E, boost::mpl::true_) {
+  V = typename vect_copy< vect_expr<Node> >::type(E.begin(), E.end());
+};
+
+template <typename Vector, typename Node>
+void lazy_resize_vect(Vector&, const vect_expr<Node>&, boost::mpl::false_) {
+  throw std::range_error("Vector size mismatch.");
+};
+
+};
+
+
+/**
+ * Evaluates a matrix expression into a matrix, in a single pass over the elements of the
+ * destination. The destination is only re-allocated if its dimensions do not match the
+ * expression's (and it is resizable). If the destination is aliased within the expression,
+ * the expression is first evaluated into a temporary. A symmetric destination only evaluates
+ * the upper-triangular part of the expression.
+ * \param M The destination matrix.
+ * \param E The matrix expression to evaluate.
+ * \return The destination matrix.
+ * \throw std::range_error if the dimensions do not match and the destination is not resizable.
+ */
+template <typename Matrix, typename Node>
+typename boost::enable_if_c< is_writable_matrix<Matrix>::value,
+Matrix& >::type lazy_assign(Matrix& M, const mat_expr<Node>& E) {
+  if((M.get_row_count() != E.get_row_count()) || (M.get_col_count() != E.get_col_count())) {
+    detail::lazy_resize_mat(M, E, boost::mpl::bool_< is_resizable_matrix<Matrix>::value >());
+    return M;
+  };
+  detail::lazy_eval_mat<detail::lazy_assign_op>(M, E, 
+    boost::mpl::bool_< is_fully_writable_matrix<Matrix>::value || is_symmetric_matrix<Matrix>::value >());
+  return M;
+};
+
+/**
+ * Adds a matrix expression to a matrix, in a single pass over the elements of the destination.
+ * \param M The destination matrix.
+ * \param E The matrix expression to add.
+ * \return The destination matrix.
+ * \throw std::range_error if the dimensions do not match.
+ */
+template <typename Matrix, typename Node>
+typename boost::enable_if_c< is_writable_matrix<Matrix>::value,
+Matrix& >::type lazy_add_assign(Matrix& M, const mat_expr<Node>& E) {
+  if((M.get_row_count() != E.get_row_count()) || (M.get_col_count() != E.get_col_count()))
+    throw std::range_error("Matrix dimension mismatch.");
+  detail::lazy_eval_mat<detail::lazy_add_assign_op>(M, E, 
+    boost::mpl::bool_< is_fully_writable_matrix<Matrix>::value || is_symmetric_matrix<Matrix>::value >());
+  return M;
+};
+
+/**
+ * Subtracts a matrix expression from a matrix, in a single pass over the elements of the destination.
+ * \param M The destination matrix.
+ * \param E The matrix expression to subtract.
+ * \return The destination matrix.
+ * \throw std::range_error if the dimensions do not match.
+ */
+template <typename Matrix, typename Node>
+typename boost::enable_if_c< is_writable_matrix<Matrix>::value,
+Matrix& >::type lazy_sub_assign(Matrix& M, const mat_expr<Node>& E) {
+  if((M.get_row_count() != E.get_row_count()) || (M.get_col_count() != E.get_col_count()))
+    throw std::range_error("Matrix dimension mismatch.");
+  detail::lazy_eval_mat<detail::lazy_sub_assign_op>(M, E, 
+    boost::mpl::bool_< is_fully_writable_matrix<Matrix>::value || is_symmetric_matrix<Matrix>::value >());
+  return M;
+};
+
+/**
+ * Evaluates a vector expression into a vector, in a single pass over the elements of the
+ * destination. The destination is only re-allocated if its size does not match the expression's
+ * (and it is resizable). If the destination is aliased within the expression, the expression
+ * is first evaluated into a temporary.
+ * \param V The destination vector.
+ * \param E The vector expression to evaluate.
+ * \return The destination vector.
+ * \throw std::range_error if the sizes do not match and the destination is not resizable.
+ */
+template <typename Vector, typename Node>
+typename boost::enable_if_c< is_writable_vector<Vector>::value,
+Vector& >::type lazy_assign(Vector& V, const vect_expr<Node>& E) {
+  if(V.size() != E.size()) {
+    detail::lazy_resize_vect(V, E, boost::mpl::bool_< is_resizable_vector<Vector>::value >());
+    return V;
+  };
+  detail::lazy_eval_vect<detail::lazy_assign_op>(V, E);
+  return V;
+};
+
+/**
+ * Adds a vector expression to a vector, in a single pass over the elements of the destination.
+ * \param V The destination vector.
+ * \param E The vector expression to add.
+ * \return The destination vector.
+ * \throw std::range_error if the sizes do not match.
+ */
+template <typename Vector, typename Node>
+typename boost::enable_if_c< is_writable_vector<Vector>::value,
+Vector& >::type lazy_add_assign(Vector& V, const vect_expr<Node>& E) {
+  if(V.size() != E.size())
+    throw std::range_error("Vector size mismatch.");
+  detail::lazy_eval_vect<detail::lazy_add_assign_op>(V, E);
+  return V;
+};
+
+/**
+ * Subtracts a vector expression from a vector, in a single pass over the elements of the destination.
+ * \param V The destination vector.
+ * \param E The vector expression to subtract.
+ * \return The destination vector.
+ * \throw std::range_error if the sizes do not match.
+ */
+template <typename Vector, typename Node>
+typename boost::enable_if_c< is_writable_vector<Vector>::value,
+Vector& >::type lazy_sub_assign(Vector& V, const vect_expr<Node>& E) {
+  if(V.size() != E.size())
+    throw std::range_error("Vector size mismatch.");
+  detail::lazy_eval_vect<detail::lazy_sub_assign_op>(V, E);
+  return V;
+};
+
+
+};
+
+#endif
+
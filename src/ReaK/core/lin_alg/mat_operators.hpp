@@ -1056,6 +1056,178 @@ vect<T,Size> operator *(const vect<T,Size>& V,const mat<T,Structure,Alignment,Al
   
 
 
+/*******************************************************************************
+                         Fixed-size Matrix Operators
+*******************************************************************************/
+
+namespace detail {
+
+/*
+ * This class template unrolls, at compile-time, the inner-products involved in the
+ * multiplication of fixed-size matrices (and vectors), for a given inner dimension.
+ */
+template <unsigned int InnerCount>
+struct mat_fix_unroller {
+  template <typename Matrix1, typename Matrix2>
+  static typename mat_traits<Matrix1>::value_type mat_mat(const Matrix1& M1, const Matrix2& M2, unsigned int i, unsigned int j) {
+    return mat_fix_unroller<InnerCount - 1>::mat_mat(M1,M2,i,j) + M1(i,InnerCount - 1) * M2(InnerCount - 1,j);
+  };
+  template <typename Matrix, typename Vector>
+  static typename mat_traits<Matrix>::value_type mat_vect(const Matrix& M, const Vector& V, unsigned int i) {
+    return mat_fix_unroller<InnerCount - 1>::mat_vect(M,V,i) + M(i,InnerCount - 1) * V[InnerCount - 1];
+  };
+  template <typename Vector, typename Matrix>
+  static typename mat_traits<Matrix>::value_type vect_mat(const Vector& V, const Matrix& M, unsigned int j) {
+    return mat_fix_unroller<InnerCount - 1>::vect_mat(V,M,j) + V[InnerCount - 1] * M(InnerCount - 1,j);
+  };
+};
+
+template <>
+struct mat_fix_unroller<1> {
+  template <typename Matrix1, typename Matrix2>
+  static typename mat_traits<Matrix1>::value_type mat_mat(const Matrix1& M1, const Matrix2& M2, unsigned int i, unsigned int j) {
+    return M1(i,0) * M2(0,j);
+  };
+  template <typename Matrix, typename Vector>
+  static typename mat_traits<Matrix>::value_type mat_vect(const Matrix& M, const Vector& V, unsigned int i) {
+    return M(i,0) * V[0];
+  };
+  template <typename Vector, typename Matrix>
+  static typename mat_traits<Matrix>::value_type vect_mat(const Vector& V, const Matrix& M, unsigned int j) {
+    return V[0] * M(0,j);
+  };
+};
+
+/*
+ * This meta-function gives the structure of the product of two fixed-size matrices.
+ * The result is rectangular if any operand is rectangular (or the result is not square),
+ * diagonal if both are diagonal, and square otherwise.
+ */
+template <mat_structure::tag Structure1, mat_structure::tag Structure2, unsigned int RowCount, unsigned int ColCount>
+struct mat_fix_product_structure {
+  BOOST_STATIC_CONSTANT(mat_structure::tag, value = (((RowCount != ColCount) ||
+                                                      (Structure1 == mat_structure::rectangular) ||
+                                                      (Structure2 == mat_structure::rectangular)) ?
+                                                     mat_structure::rectangular :
+                                                     (((Structure1 == mat_structure::diagonal) &&
+                                                       (Structure2 == mat_structure::diagonal)) ?
+                                                      mat_structure::diagonal : mat_structure::square)));
+};
+
+/*
+ * This meta-function gives the structure of the sum of two fixed-size matrices.
+ * The result has the same structure if both operands have the same structure, otherwise
+ * it is rectangular if any operand is rectangular, and square otherwise.
+ */
+template <mat_structure::tag Structure1, mat_structure::tag Structure2>
+struct mat_fix_addition_structure {
+  BOOST_STATIC_CONSTANT(mat_structure::tag, value = ((Structure1 == Structure2) ?
+                                                     Structure1 :
+                                                     (((Structure1 == mat_structure::rectangular) ||
+                                                       (Structure2 == mat_structure::rectangular)) ?
+                                                      mat_structure::rectangular : mat_structure::square)));
+};
+
+};
+
+
+/**
+ * Matrix multiplication operator for fixed-size matrices. The inner-products are unrolled
+ * at compile-time and the result is a fixed-size matrix (no dynamic allocation).
+ * \param M1 The first matrix operand (RowCount x InnerCount).
+ * \param M2 The second matrix operand (InnerCount x ColCount).
+ * \return Fixed-size matrix equal to M1 * M2.
+ * \test PASSED
+ */
+template <typename T,
+          mat_structure::tag Structure1, mat_structure::tag Structure2,
+          unsigned int RowCount, unsigned int InnerCount, unsigned int ColCount,
+          mat_alignment::tag Alignment1, mat_alignment::tag Alignment2>
+mat_fix<T, detail::mat_fix_product_structure<Structure1,Structure2,RowCount,ColCount>::value, RowCount, ColCount, Alignment1>
+  operator *(const mat_fix<T,Structure1,RowCount,InnerCount,Alignment1>& M1,
+             const mat_fix<T,Structure2,InnerCount,ColCount,Alignment2>& M2) {
+  typedef mat_fix<T, detail::mat_fix_product_structure<Structure1,Structure2,RowCount,ColCount>::value, RowCount, ColCount, Alignment1> result_type;
+  result_type result;
+  if(detail::mat_fix_product_structure<Structure1,Structure2,RowCount,ColCount>::value == mat_structure::diagonal) {
+    for(unsigned int i = 0; i < RowCount; ++i)
+      result(i,i) = M1(i,i) * M2(i,i);
+  } else {
+    for(unsigned int j = 0; j < ColCount; ++j)
+      for(unsigned int i = 0; i < RowCount; ++i)
+        result(i,j) = detail::mat_fix_unroller<InnerCount>::mat_mat(M1,M2,i,j);
+  };
+  return result;
+};
+
+/**
+ * Matrix addition operator for fixed-size matrices.
+ * \param M1 The first matrix operand.
+ * \param M2 The second matrix operand.
+ * \return Fixed-size matrix equal to M1 + M2.
+ * \test PASSED
+ */
+template <typename T,
+          mat_structure::tag Structure1, mat_structure::tag Structure2,
+          unsigned int RowCount, unsigned int ColCount,
+          mat_alignment::tag Alignment1, mat_alignment::tag Alignment2>
+mat_fix<T, detail::mat_fix_addition_structure<Structure1,Structure2>::value, RowCount, ColCount, Alignment1>
+  operator +(const mat_fix<T,Structure1,RowCount,ColCount,Alignment1>& M1,
+             const mat_fix<T,Structure2,RowCount,ColCount,Alignment2>& M2) {
+  mat_fix<T, detail::mat_fix_addition_structure<Structure1,Structure2>::value, RowCount, ColCount, Alignment1> result(M1);
+  result += M2;
+  return result;
+};
+
+/**
+ * Matrix subtraction operator for fixed-size matrices.
+ * \param M1 The first matrix operand.
+ * \param M2 The second matrix operand.
+ * \return Fixed-size matrix equal to M1 - M2.
+ * \test PASSED
+ */
+template <typename T,
+          mat_structure::tag Structure1, mat_structure::tag Structure2,
+          unsigned int RowCount, unsigned int ColCount,
+          mat_alignment::tag Alignment1, mat_alignment::tag Alignment2>
+mat_fix<T, detail::mat_fix_addition_structure<Structure1,Structure2>::value, RowCount, ColCount, Alignment1>
+  operator -(const mat_fix<T,Structure1,RowCount,ColCount,Alignment1>& M1,
+             const mat_fix<T,Structure2,RowCount,ColCount,Alignment2>& M2) {
+  mat_fix<T, detail::mat_fix_addition_structure<Structure1,Structure2>::value, RowCount, ColCount, Alignment1> result(M1);
+  result -= M2;
+  return result;
+};
+
+/**
+ * Multiplication of a fixed-size matrix by a fixed-size column-vector, unrolled at compile-time.
+ * \param M the matrix (RowCount x ColCount).
+ * \param V the column vector (ColCount).
+ * \return column-vector equal to M * V.
+ * \test PASSED
+ */
+template <typename T, mat_structure::tag Structure, unsigned int RowCount, unsigned int ColCount, mat_alignment::tag Alignment>
+vect<T,RowCount> operator *(const mat_fix<T,Structure,RowCount,ColCount,Alignment>& M, const vect<T,ColCount>& V) {
+  vect<T,RowCount> result;
+  for(unsigned int i = 0; i < RowCount; ++i)
+    result[i] = detail::mat_fix_unroller<ColCount>::mat_vect(M,V,i);
+  return result;
+};
+
+/**
+ * Multiplication of a fixed-size row-vector by a fixed-size matrix, unrolled at compile-time.
+ * \param V the row vector (RowCount).
+ * \param M the matrix (RowCount x ColCount).
+ * \return row-vector equal to V * M.
+ * \test PASSED
+ */
+template <typename T, mat_structure::tag Structure, unsigned int RowCount, unsigned int ColCount, mat_alignment::tag Alignment>
+vect<T,ColCount> operator *(const vect<T,RowCount>& V, const mat_fix<T,Structure,RowCount,ColCount,Alignment>& M) {
+  vect<T,ColCount> result;
+  for(unsigned int j = 0; j < ColCount; ++j)
+    result[j] = detail::mat_fix_unroller<RowCount>::vect_mat(V,M,j);
+  return result;
+};
+
+
 
 
 
@@ -0,0 +1,414 @@
+/**
+ * \file mat_sparse_ldl.hpp
+ *
+ * This library provides a sparse LDL decomposition of symmetric matrices stored as sparse
+ * matrices (see mat_sparse). The decomposition is split in a symbolic analysis phase (fill-reducing
+ * ordering, elimination tree and column counts of the factor) and a numerical factorization phase,
+ * such that a sequence of matrices that share the same sparsity pattern (e.g., the KKT matrices
+ * of successive iterations of an optimization method) only require the symbolic analysis once.
+ * The numerical factorization is the up-looking algorithm described in: \n
+ *   Davis, T. A., "Algorithm 849: A concise sparse Cholesky factorization package", ACM TOMS, 2005.\n
+ * and the fill-reducing ordering is the reverse Cuthill-McKee ordering, which is well suited to the
+ * banded or block-banded matrices that arise in trajectory optimization problems. The decomposition
+ * does not pivot, and is therefore meant for positive-definite matrices (Cholesky) or for
+ * symmetric quasi-definite matrices (such as regularized KKT matrices), for which an LDL
+ * factorization exists for any symmetric permutation.
+ *
+ * \author Mikael Persson <mikael.s.persson@gmail.com>
+ * \date June 2013
+ */
+
+/*
+ *    Copyright 2013 Sven Mikael Persson
+ *
+ *    THIS SOFTWARE IS DISTRIBUTED UNDER THE TERMS OF THE GNU GENERAL PUBLIC LICENSE v3 (GPLv3).
+ *
+ *    This file is part of ReaK.
+ *
+ *    ReaK is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    (at your option) any later version.
+ *
+ *    ReaK is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with ReaK (as LICENSE in the root folder).
+ *    If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef REAK_MAT_SPARSE_LDL_HPP
+#define REAK_MAT_SPARSE_LDL_HPP
+
+#include "mat_alg.hpp"
+#include "mat_alg_sparse.hpp"
+#include "mat_num_exceptions.hpp"
+
+#include <vector>
+#include <algorithm>
+
+namespace ReaK {
+
+
+/**
+ * This class template computes and stores the sparse LDL decomposition of a symmetric matrix
+ * (only the upper-triangular part of the given matrix is used), that is, P A P' = L D L', where
+ * P is a fill-reducing permutation, L is a unit lower-triangular sparse matrix and D is diagonal.
+ * The symbolic analysis (permutation, elimination tree and structure of L) is computed when the
+ * sparsity pattern of the matrix is first seen, and re-used by subsequent factorizations of
+ * matrices with the same sparsity pattern.
+ *
+ * \tparam T The value-type of the matrices.
+ */
+template <typename T>
+class sparse_LDL_decomposition {
+  public:
+    typedef T value_type;
+    typedef std::size_t size_type;
+
+  private:
+    typedef typename mat_sparse<T>::size_type index_type;
+
+    // sparsity pattern of the analyzed matrix:
+    mat_sparse<T> m_pattern;
+
+    // symbolic analysis:
+    std::vector<size_type> m_perm;      // m_perm[k] = original index of the k-th pivot.
+    std::vector<size_type> m_perm_inv;  // inverse of m_perm.
+    std::vector<size_type> m_C_ptr;     // column starts of the permuted upper-triangular matrix.
+    std::vector<size_type> m_C_idx;     // row-indices of the permuted upper-triangular matrix.
+    std::vector<size_type> m_C_map;     // position of each entry of the original matrix in the permuted one (or -1).
+    std::vector<size_type> m_parent;    // elimination tree.
+    std::vector<size_type> m_L_ptr;     // column starts of L.
+
+    // numerical factorization:
+    std::vector<value_type> m_C_val;
+    std::vector<size_type> m_L_idx;
+    std::vector<value_type> m_L_val;
+    std::vector<value_type> m_D;
+
+    size_type m_analysis_count;
+    size_type m_pos_pivots;
+    size_type m_neg_pivots;
+    bool m_factorized;
+
+    static size_type none() { return static_cast<size_type>(-1); };
+
+    void solve_permuted(std::vector<value_type>& x) const {
+      const size_type N = m_D.size();
+      for(size_type j = 0; j < N; ++j)
+        for(size_type p = m_L_ptr[j]; p < m_L_ptr[j+1]; ++p)
+          x[m_L_idx[p]] -= m_L_val[p] * x[j];
+      for(size_type j = 0; j < N; ++j)
+        x[j] /= m_D[j];
+      for(size_type j = N; j > 0; --j)
+        for(size_type p = m_L_ptr[j-1]; p < m_L_ptr[j]; ++p)
+          x[j-1] -= m_L_val[p] * x[m_L_idx[p]];
+    };
+
+    void compute_ordering(const mat_sparse<T>& A) {
+      const size_type N = A.get_col_count();
+      const std::vector<index_type>& cp = A.get_col_pointers();
+      const std::vector<index_type>& ri = A.get_row_indices();
+
+      // build the symmetric adjacency structure (without the diagonal).
+      std::vector<size_type> deg(N, 0);
+      for(size_type j = 0; j < N; ++j)
+        for(size_type p = cp[j]; p < cp[j+1]; ++p)
+          if(ri[p] < j) {
+            ++deg[ri[p]];
+            ++deg[j];
+          };
+      std::vector<size_type> adj_ptr(N + 1, 0);
+      for(size_type j = 0; j < N; ++j)
+        adj_ptr[j+1] = adj_ptr[j] + deg[j];
+      std::vector<size_type> adj(adj_ptr[N]);
+      std::vector<size_type> next(adj_ptr.begin(), adj_ptr.end() - 1);
+      for(size_type j = 0; j < N; ++j)
+        for(size_type p = cp[j]; p < cp[j+1]; ++p)
+          if(ri[p] < j) {
+            adj[next[ri[p]]++] = j;
+            adj[next[j]++] = ri[p];
+          };
+
+      // reverse Cuthill-McKee ordering, each connected component being started from a node of minimum degree.
+      m_perm.clear();
+      m_perm.reserve(N);
+      std::vector<bool> visited(N, false);
+      std::vector< std::pair<size_type, size_type> > neighbors;
+      while(m_perm.size() < N) {
+        size_type start = none();
+        for(size_type i = 0; i < N; ++i)
+          if(!visited[i] && ((start == none()) || (deg[i] < deg[start])))
+            start = i;
+        size_type head = m_perm.size();
+        m_perm.push_back(start);
+        visited[start] = true;
+        for(; head < m_perm.size(); ++head) {
+          size_type u = m_perm[head];
+          neighbors.clear();
+          for(size_type p = adj_ptr[u]; p < adj_ptr[u+1]; ++p)
+            if(!visited[adj[p]]) {
+              visited[adj[p]] = true;
+              neighbors.push_back(std::pair<size_type, size_type>(deg[adj[p]], adj[p]));
+            };
+          std::sort(neighbors.begin(), neighbors.end());
+          for(size_type k = 0; k < neighbors.size(); ++k)
+            m_perm.push_back(neighbors[k].second);
+        };
+      };
+      std::reverse(m_perm.begin(), m_perm.end());
+      m_perm_inv.resize(N);
+      for(size_type k = 0; k < N; ++k)
+        m_perm_inv[m_perm[k]] = k;
+    };
+
+    void compute_symbolic(const mat_sparse<T>& A) {
+      const size_type N = A.get_col_count();
+      const std::vector<index_type>& cp = A.get_col_pointers();
+      const std::vector<index_type>& ri = A.get_row_indices();
+
+      compute_ordering(A);
+
+      // structure of the permuted upper-triangular matrix C = P A P' (and the map from A to C).
+      m_C_ptr.assign(N + 1, 0);
+      for(size_type j = 0; j < N; ++j)
+        for(size_type p = cp[j]; p < cp[j+1]; ++p)
+          if(ri[p] <= j)
+            ++m_C_ptr[std::max(m_perm_inv[ri[p]], m_perm_inv[j]) + 1];
+      for(size_type k = 0; k < N; ++k)
+        m_C_ptr[k+1] += m_C_ptr[k];
+      m_C_idx.resize(m_C_ptr[N]);
+      m_C_map.assign(cp[N], none());
+      std::vector<size_type> next(m_C_ptr.begin(), m_C_ptr.end() - 1);
+      for(size_type j = 0; j < N; ++j)
+        for(size_type p = cp[j]; p < cp[j+1]; ++p)
+          if(ri[p] <= j) {
+            size_type pi = m_perm_inv[ri[p]];
+            size_type pj = m_perm_inv[j];
+            size_type k = next[std::max(pi,pj)]++;
+            m_C_idx[k] = std::min(pi,pj);
+            m_C_map[p] = k;
+          };
+      m_C_val.resize(m_C_ptr[N]);
+
+      // elimination tree and column counts of L.
+      m_parent.assign(N, none());
+      std::vector<size_type> flag(N);
+      std::vector<size_type> Lnz(N, 0);
+      for(size_type k = 0; k < N; ++k) {
+        flag[k] = k;
+        for(size_type p = m_C_ptr[k]; p < m_C_ptr[k+1]; ++p) {
+          for(size_type i = m_C_idx[p]; flag[i] != k; i = m_parent[i]) {
+            if(m_parent[i] == none())
+              m_parent[i] = k;
+            ++Lnz[i];
+            flag[i] = k;
+          };
+        };
+      };
+      m_L_ptr.assign(N + 1, 0);
+      for(size_type k = 0; k < N; ++k)
+        m_L_ptr[k+1] = m_L_ptr[k] + Lnz[k];
+      m_L_idx.resize(m_L_ptr[N]);
+      m_L_val.resize(m_L_ptr[N]);
+      m_D.resize(N);
+
+      m_pattern = A;
+      ++m_analysis_count;
+    };
+
+  public:
+
+    /**
+     * Default constructor.
+     */
+    sparse_LDL_decomposition() : m_analysis_count(0), m_pos_pivots(0), m_neg_pivots(0), m_factorized(false) { };
+
+    /**
+     * Performs the symbolic analysis of the given sparse symmetric matrix (only its sparsity
+     * pattern is used). This is done automatically by factorize() when needed.
+     * \param A The sparse symmetric matrix (only the upper-triangular part is used).
+     * \throws std::range_error if the matrix is not square.
+     */
+    void analyze(const mat_sparse<T>& A) {
+      if(A.get_row_count() != A.get_col_count())
+        throw std::range_error("Sparse LDL decomposition is only possible on a square (symmetric) matrix!");
+      compute_symbolic(A);
+      m_factorized = false;
+    };
+
+    /**
+     * Computes the numerical factorization of the given sparse symmetric matrix. The symbolic
+     * analysis is re-used if the matrix has the same sparsity pattern as the last analyzed matrix.
+     * \param A The sparse symmetric matrix (only the upper-triangular part is used).
+     * \param NumTol The tolerance below which a pivot is considered to be zero.
+     * \throws singularity_error if a zero pivot is encountered.
+     * \throws std::range_error if the matrix is not square.
+     */
+    void factorize(const mat_sparse<T>& A, value_type NumTol = value_type(1E-8)) {
+      using std::fabs;
+      if((m_analysis_count == 0) || (!A.has_same_pattern(m_pattern)))
+        analyze(A);
+      m_factorized = false;
+
+      const size_type N = A.get_col_count();
+      const std::vector<value_type>& q = A.get_values();
+      std::fill(m_C_val.begin(), m_C_val.end(), value_type(0));
+      for(size_type p = 0; p < q.size(); ++p)
+        if(m_C_map[p] != none())
+          m_C_val[m_C_map[p]] += q[p];
+
+      std::vector<value_type> Y(N, value_type(0));
+      std::vector<size_type> pattern(N);
+      std::vector<size_type> flag(N);
+      std::vector<size_type> Lnz(N, 0);
+      m_pos_pivots = 0;
+      m_neg_pivots = 0;
+      for(size_type k = 0; k < N; ++k) {
+        // compute the non-zero pattern of the k-th row of L (a subtree of the elimination tree).
+        size_type top = N;
+        flag[k] = k;
+        for(size_type p = m_C_ptr[k]; p < m_C_ptr[k+1]; ++p) {
+          size_type i = m_C_idx[p];
+          Y[i] += m_C_val[p];
+          size_type len = 0;
+          for(; flag[i] != k; i = m_parent[i]) {
+            pattern[len++] = i;
+            flag[i] = k;
+          };
+          while(len > 0)
+            pattern[--top] = pattern[--len];
+        };
+        // sparse triangular solve for the k-th row of L and the k-th pivot.
+        m_D[k] = Y[k];
+        Y[k] = value_type(0);
+        for(; top < N; ++top) {
+          size_type i = pattern[top];
+          value_type yi = Y[i];
+          Y[i] = value_type(0);
+          size_type p2 = m_L_ptr[i] + Lnz[i];
+          for(size_type p = m_L_ptr[i]; p < p2; ++p)
+            Y[m_L_idx[p]] -= m_L_val[p] * yi;
+          value_type l_ki = yi / m_D[i];
+          m_D[k] -= l_ki * yi;
+          m_L_idx[p2] = k;
+          m_L_val[p2] = l_ki;
+          ++Lnz[i];
+        };
+        if(fabs(m_D[k]) <= NumTol)
+          throw singularity_error("A");
+        if(m_D[k] > value_type(0))
+          ++m_pos_pivots;
+        else
+          ++m_neg_pivots;
+      };
+      m_factorized = true;
+    };
+
+    /**
+     * Solves the linear system A x = b using the current factorization.
+     * \param b Stores, as input, the right-hand-side vector b, and as output, the solution x.
+     * \param aRefineSteps The number of iterative refinement steps to perform, which is useful to
+     *                     recover accuracy when the matrix is a regularized (quasi-definite) KKT matrix.
+     * \throws std::range_error if the vector dimension does not match or if there is no factorization.
+     */
+    template <typename Vector>
+    void solve(Vector& b, size_type aRefineSteps = 0) const {
+      if(!m_factorized)
+        throw std::range_error("Cannot solve a linear system with a sparse LDL decomposition that has not been factorized!");
+      const size_type N = m_D.size();
+      if(b.size() != N)
+        throw std::range_error("Vector dimension mismatch for the sparse LDL solution!");
+      std::vector<value_type> bp(N);
+      for(size_type k = 0; k < N; ++k)
+        bp[k] = b[m_perm[k]];
+      std::vector<value_type> x(bp);
+      solve_permuted(x);
+      std::vector<value_type> r(N);
+      for(size_type s = 0; s < aRefineSteps; ++s) {
+        // r = b - A x, using the upper-triangular part of the permuted matrix.
+        r = bp;
+        for(size_type j = 0; j < N; ++j)
+          for(size_type p = m_C_ptr[j]; p < m_C_ptr[j+1]; ++p) {
+            size_type i = m_C_idx[p];
+            r[i] -= m_C_val[p] * x[j];
+            if(i != j)
+              r[j] -= m_C_val[p] * x[i];
+          };
+        solve_permuted(r);
+        for(size_type k = 0; k < N; ++k)
+          x[k] += r[k];
+      };
+      for(size_type k = 0; k < N; ++k)
+        b[m_perm[k]] = x[k];
+    };
+
+    /**
+     * Returns the number of positive pivots (entries of D) of the last factorization.
+     */
+    size_type get_positive_pivot_count() const { return m_pos_pivots; };
+    /**
+     * Returns the number of negative pivots (entries of D) of the last factorization.
+     */
+    size_type get_negative_pivot_count() const { return m_neg_pivots; };
+    /**
+     * Returns the number of stored entries in the factor L of the last analysis.
+     */
+    size_type get_factor_nonzero_count() const { return (m_L_ptr.empty() ? 0 : m_L_ptr.back()); };
+    /**
+     * Returns the number of symbolic analyses that were performed (a measure of how well
+     * the symbolic analysis is re-used).
+     */
+    size_type get_analysis_count() const { return m_analysis_count; };
+    /**
+     * Checks if a numerical factorization is available.
+     */
+    bool is_factorized() const { return m_factorized; };
+
+};
+
+
+/**
+ * Solves the linear system A x = b for a sparse symmetric positive-definite (or quasi-definite)
+ * matrix A by a sparse LDL decomposition.
+ * \param A The sparse symmetric matrix (only the upper-triangular part is used).
+ * \param b Stores, as input, the right-hand-side vector b, and as output, the solution x.
+ * \param NumTol The tolerance below which a pivot is considered to be zero.
+ * \throws singularity_error if a zero pivot is encountered.
+ * \throws std::range_error if the dimensions do not match.
+ */
+template <typename T, typename Vector>
+void linsolve_sparse_LDL(const mat_sparse<T>& A, Vector& b, T NumTol = T(1E-8)) {
+  sparse_LDL_decomposition<T> ldl;
+  ldl.factorize(A, NumTol);
+  ldl.solve(b);
+};
+
+
+/**
+ * Functor to wrap a call to a sparse LDL-decomposition-based linear system solver. The
+ * decomposition is kept within the functor such that successive calls with matrices of the
+ * same sparsity pattern re-use the symbolic analysis.
+ */
+template <typename T>
+struct sparse_LDL_linsolver {
+  shared_ptr< sparse_LDL_decomposition<T> > ldl;
+
+  sparse_LDL_linsolver() : ldl(new sparse_LDL_decomposition<T>()) { };
+
+  template <typename Vector1, typename Vector2>
+  void operator()(const mat_sparse<T>& A, Vector1& x, const Vector2& b, T NumTol = T(1E-8)) {
+    x = b;
+    ldl->factorize(A, NumTol);
+    ldl->solve(x);
+  };
+};
+
+
+};
+
+#endif
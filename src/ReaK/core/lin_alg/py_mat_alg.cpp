@@ -0,0 +1,127 @@
+/**
+ *\file py_mat_alg.cpp
+ *
+ * This source file defines export functions for the python bindings on mat_alg classes
+ * of the ReaK platform.
+ *
+ * \author Sven Mikael Persson <mikael.s.persson@gmail.com>
+ * \date June 2013
+ */
+
+/*
+ *    Copyright 2013 Sven Mikael Persson
+ *
+ *    THIS SOFTWARE IS DISTRIBUTED UNDER THE TERMS OF THE GNU GENERAL PUBLIC LICENSE v3 (GPLv3).
+ *
+ *    This file is part of ReaK.
+ *
+ *    ReaK is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    (at your option) any later version.
+ *
+ *    ReaK is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with ReaK (as LICENSE in the root folder).
+ *    If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#include "base/defs.hpp"
+
+#include "mat_alg.hpp"
+
+#include <boost/python.hpp>
+
+#include "base/py_fixes.hpp"
+#include "base/py_array_interface.hpp"
+
+#include <sstream>
+
+
+
+namespace PyReaK {
+
+
+typedef ReaK::mat<double, ReaK::mat_structure::rectangular> py_matrix_type;
+
+
+double mat_getitem(const py_matrix_type& m, const boost::python::tuple& ij) {
+  std::size_t i = boost::python::extract<std::size_t>(ij[0]);
+  std::size_t j = boost::python::extract<std::size_t>(ij[1]);
+  if((i >= m.get_row_count()) || (j >= m.get_col_count())) {
+    PyErr_SetString(PyExc_IndexError, "Matrix index out of range.");
+    boost::python::throw_error_already_set();
+  };
+  return m(i,j);
+};
+
+void mat_setitem(py_matrix_type& m, const boost::python::tuple& ij, double d) {
+  std::size_t i = boost::python::extract<std::size_t>(ij[0]);
+  std::size_t j = boost::python::extract<std::size_t>(ij[1]);
+  if((i >= m.get_row_count()) || (j >= m.get_col_count())) {
+    PyErr_SetString(PyExc_IndexError, "Matrix index out of range.");
+    boost::python::throw_error_already_set();
+  };
+  m(i,j) = d;
+};
+
+std::string mat_to_string(const py_matrix_type& m) {
+  std::stringstream ss;
+  ss << m;
+  return ss.str();
+};
+
+// the matrix is column-major, which NumPy sees as a Fortran-ordered array (each column is contiguous).
+boost::python::dict mat_array_interface(const py_matrix_type& m) {
+  using boost::python::make_tuple;
+  return py_make_array_interface((m.get_row_count() * m.get_col_count() ? &m(0,0) : NULL),
+                                 make_tuple(m.get_row_count(), m.get_col_count()),
+                                 make_tuple(sizeof(double), sizeof(double) * m.get_row_count()));
+};
+
+py_matrix_type mat_from_array(const boost::python::object& aObj) {
+  py_double_array_view a(aObj);
+  py_matrix_type result(a.get_row_count(), a.get_col_count());
+  for(std::size_t j = 0; j < a.get_col_count(); ++j)
+    for(std::size_t i = 0; i < a.get_row_count(); ++i)
+      result(i,j) = a(i,j);
+  return result;
+};
+
+
+void export_mat_alg() {
+
+  using namespace boost::python;
+
+  class_< py_matrix_type,
+          bases< ReaK::serialization::serializable >
+        >("Matrix")
+    .def(init<std::size_t,std::size_t>())
+    .def(self + self)
+    .def(self - self)
+    .def(-self)
+    .def(self * self)
+    .def(self += self)
+    .def(self -= self)
+    .def(self * double())
+    .def(double() * self)
+    .def("__str__", mat_to_string)
+    .def("__getitem__", mat_getitem)
+    .def("__setitem__", mat_setitem)
+    .add_property("row_count", &py_matrix_type::get_row_count)
+    .add_property("col_count", &py_matrix_type::get_col_count)
+    .add_property("__array_interface__", mat_array_interface);
+
+  def("matrix_from_array", mat_from_array);
+
+};
+
+
+};
+
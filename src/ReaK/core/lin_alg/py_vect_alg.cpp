@@ -40,6 +40,7 @@
 #include <boost/python/suite/indexing/vector_indexing_suite.hpp>
 
 #include "base/py_fixes.hpp"
+#include "base/py_array_interface.hpp"
 
 #include <sstream>
 
@@ -65,6 +66,21 @@ std::string vect_to_string(const Vector& v) {
   return ss.str();
 };
 
+template <typename Vector>
+boost::python::dict vect_array_interface(const Vector& v) {
+  using boost::python::make_tuple;
+  return py_make_array_interface((v.size() ? &v[0] : NULL), make_tuple(v.size()), make_tuple(sizeof(double)));
+};
+
+ReaK::vect_n<double> vect_n_from_array(const boost::python::object& aObj) {
+  py_double_array_view a(aObj);
+  ReaK::vect_n<double> result(a.get_row_count() * a.get_col_count());
+  for(std::size_t i = 0, k = 0; i < a.get_row_count(); ++i)
+    for(std::size_t j = 0; j < a.get_col_count(); ++j, ++k)
+      result[k] = a(i,j);
+  return result;
+};
+
 
 void export_vect_alg() {
 
@@ -89,7 +105,8 @@ void export_vect_alg() {
     .def("__str__",vect_to_string< ReaK::vect<double,2> >)
     .def("__len__",&ReaK::vect<double,2>::size)
     .def("__getitem__",vect_getitem< ReaK::vect<double,2> >)
-    .def("__setitem__",vect_setitem< ReaK::vect<double,2> >);
+    .def("__setitem__",vect_setitem< ReaK::vect<double,2> >)
+    .add_property("__array_interface__",vect_array_interface< ReaK::vect<double,2> >);
   
   def("norm_2_sqr",static_cast< double(*)(const ReaK::vect<double,2>&) >(&ReaK::norm_2_sqr));
   def("norm_2",static_cast< double(*)(const ReaK::vect<double,2>&) >(&ReaK::norm_2));
@@ -117,7 +134,8 @@ void export_vect_alg() {
     .def("__str__",vect_to_string< ReaK::vect<double,3> >)
     .def("__len__",&ReaK::vect<double,3>::size)
     .def("__getitem__",vect_getitem< ReaK::vect<double,3> >)
-    .def("__setitem__",vect_setitem< ReaK::vect<double,3> >);
+    .def("__setitem__",vect_setitem< ReaK::vect<double,3> >)
+    .add_property("__array_interface__",vect_array_interface< ReaK::vect<double,3> >);
   
   def("norm_2_sqr",static_cast< double(*)(const ReaK::vect<double,3>&) >(&ReaK::norm_2_sqr));
   def("norm_2",static_cast< double(*)(const ReaK::vect<double,3>&) >(&ReaK::norm_2));
@@ -144,7 +162,8 @@ void export_vect_alg() {
     .def("__str__",vect_to_string< ReaK::vect<double,4> >)
     .def("__len__",&ReaK::vect<double,4>::size)
     .def("__getitem__",vect_getitem< ReaK::vect<double,4> >)
-    .def("__setitem__",vect_setitem< ReaK::vect<double,4> >);
+    .def("__setitem__",vect_setitem< ReaK::vect<double,4> >)
+    .add_property("__array_interface__",vect_array_interface< ReaK::vect<double,4> >);
   
   def("norm_2_sqr",static_cast< double(*)(const ReaK::vect<double,4>&) >(&ReaK::norm_2_sqr));
   def("norm_2",static_cast< double(*)(const ReaK::vect<double,4>&) >(&ReaK::norm_2));
@@ -187,7 +206,10 @@ void export_vect_alg() {
     .def("__len__",&ReaK::vect_n<double, std::allocator<double> >::size)
     .def("__getitem__",vect_getitem< ReaK::vect_n<double, std::allocator<double> > >)
     .def("__setitem__",vect_setitem< ReaK::vect_n<double, std::allocator<double> > >)
-    .def("resize", &ReaK::vect_n<double, std::allocator<double> >::resize);
+    .def("resize", &ReaK::vect_n<double, std::allocator<double> >::resize)
+    .add_property("__array_interface__",vect_array_interface< ReaK::vect_n<double, std::allocator<double> > >);
+  
+  def("vector_from_array", vect_n_from_array);
   
   def("norm_2_sqr",static_cast< double(*)(const ReaK::vect_n<double>&) >(&ReaK::norm_2_sqr));
   def("norm_2",static_cast< double(*)(const ReaK::vect_n<double>&) >(&ReaK::norm_2));
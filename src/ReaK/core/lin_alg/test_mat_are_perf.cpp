@@ -0,0 +1,155 @@
+
+/*
+ *    Copyright 2013 Sven Mikael Persson
+ *
+ *    THIS SOFTWARE IS DISTRIBUTED UNDER THE TERMS OF THE GNU GENERAL PUBLIC LICENSE v3 (GPLv3).
+ *
+ *    This file is part of ReaK.
+ *
+ *    ReaK is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    (at your option) any later version.
+ *
+ *    ReaK is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with ReaK (as LICENSE in the root folder).  
+ *    If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "base/defs.hpp"
+
+#include "mat_alg.hpp"
+
+#include "mat_are_solver.hpp"
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "boost/date_time/posix_time/posix_time.hpp"
+
+/*
+ * This program compares the run-time of the free-function CARE / DARE solvers (which allocate 
+ * their workspace at every call) against the care_solver / dare_solver objects (which reuse 
+ * their workspace), on the CAREX / DAREX benchmark problems.
+ */
+
+struct are_problem {
+  ReaK::mat<double, ReaK::mat_structure::rectangular> A;
+  ReaK::mat<double, ReaK::mat_structure::rectangular> B;
+  ReaK::mat<double, ReaK::mat_structure::rectangular> R;
+  ReaK::mat<double, ReaK::mat_structure::rectangular> Q;
+};
+
+static void read_are_matrix(std::istream& in, ReaK::mat<double, ReaK::mat_structure::rectangular>& M, 
+                            std::size_t rows, std::size_t cols) {
+  M.set_row_count(rows);
+  M.set_col_count(cols);
+  for(std::size_t i = 0; i < rows; ++i) {
+    std::string str_tmp;
+    std::getline(in,str_tmp);
+    std::stringstream ss(str_tmp);
+    for(std::size_t j = 0; j < cols; ++j)
+      ss >> M(i,j);
+  };
+};
+
+static std::vector< are_problem > read_are_problems(const std::string& aFileName) {
+  std::vector< are_problem > result;
+  std::ifstream infile(aFileName.c_str());
+  while(infile) {
+    std::string str_tmp;
+    std::getline(infile,str_tmp);
+    if(!infile)
+      break;
+    std::size_t N, M;
+    std::stringstream ss(str_tmp);
+    ss >> N >> M;
+    are_problem p;
+    read_are_matrix(infile, p.A, N, N);
+    read_are_matrix(infile, p.B, N, M);
+    read_are_matrix(infile, p.R, M, M);
+    read_are_matrix(infile, p.Q, N, N);
+    result.push_back(p);
+  };
+  return result;
+};
+
+
+int main(int argc, char** argv) {
+
+  using namespace ReaK;
+  
+  std::string data_path = "are_data/";
+  if(argc > 1)
+    data_path = argv[1];
+  std::size_t reps = 100;
+  if(argc > 2) {
+    std::stringstream ss(argv[2]);
+    ss >> reps;
+  };
+  
+  std::vector< are_problem > carex = read_are_problems(data_path + "carex_data.txt");
+  std::vector< are_problem > darex = read_are_problems(data_path + "darex_data.txt");
+  
+  std::cout << "Problem\tN\tM\tfree-func (us)\tsolver-obj (us)" << std::endl;
+  
+  boost::posix_time::ptime t1;
+  boost::posix_time::time_duration dt[2];
+  
+  for(std::size_t i = 0; i < carex.size(); ++i) {
+    const are_problem& p = carex[i];
+    mat<double,mat_structure::rectangular> P(p.A.get_row_count(),p.A.get_col_count());
+    try {
+      t1 = boost::posix_time::microsec_clock::local_time();
+      for(std::size_t k = 0; k < reps; ++k)
+        solve_care_problem(p.A, p.B, p.Q, p.R, P, 1e-6);
+      dt[0] = boost::posix_time::microsec_clock::local_time() - t1;
+      
+      care_solver<double> solver(p.A.get_row_count(), p.B.get_col_count(), 1e-6);
+      t1 = boost::posix_time::microsec_clock::local_time();
+      for(std::size_t k = 0; k < reps; ++k)
+        solver.solve(p.A, p.B, p.Q, p.R, P);
+      dt[1] = boost::posix_time::microsec_clock::local_time() - t1;
+    } catch(std::exception& e) {
+      std::cout << "CAREX " << i << "\tfailed: " << e.what() << std::endl;
+      continue;
+    };
+    std::cout << "CAREX " << i << "\t" << p.A.get_row_count() << "\t" << p.B.get_col_count() 
+              << "\t" << (dt[0].total_microseconds() / reps) 
+              << "\t" << (dt[1].total_microseconds() / reps) << std::endl;
+  };
+  
+  for(std::size_t i = 0; i < darex.size(); ++i) {
+    const are_problem& p = darex[i];
+    mat<double,mat_structure::rectangular> P(p.A.get_row_count(),p.A.get_col_count());
+    try {
+      t1 = boost::posix_time::microsec_clock::local_time();
+      for(std::size_t k = 0; k < reps; ++k)
+        solve_dare_problem(p.A, p.B, p.Q, p.R, P, 1e-6);
+      dt[0] = boost::posix_time::microsec_clock::local_time() - t1;
+      
+      dare_solver<double> solver(p.A.get_row_count(), p.B.get_col_count(), 1e-6);
+      t1 = boost::posix_time::microsec_clock::local_time();
+      for(std::size_t k = 0; k < reps; ++k)
+        solver.solve(p.A, p.B, p.Q, p.R, P);
+      dt[1] = boost::posix_time::microsec_clock::local_time() - t1;
+    } catch(std::exception& e) {
+      std::cout << "DAREX " << i << "\tfailed: " << e.what() << std::endl;
+      continue;
+    };
+    std::cout << "DAREX " << i << "\t" << p.A.get_row_count() << "\t" << p.B.get_col_count() 
+              << "\t" << (dt[0].total_microseconds() / reps) 
+              << "\t" << (dt[1].total_microseconds() / reps) << std::endl;
+  };
+  
+  return 0;
+};
+
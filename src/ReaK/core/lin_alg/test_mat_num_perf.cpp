@@ -34,6 +34,7 @@
 #include "mat_qr_decomp.hpp"
 #include "mat_svd_method.hpp"
 #include "mat_schur_decomp.hpp"
+#include "mat_blocked_decomp.hpp"
 
 #include "boost/date_time/posix_time/posix_time.hpp"
 
@@ -49,11 +50,11 @@ int main() {
     mat<double,mat_structure::symmetric> m_test(2.0,-1.0,0.0,2.0,-1.0,2.0);
     mat<double,mat_structure::symmetric> m_inc(2.0,-1.0,2.0);
     boost::posix_time::ptime t1;
-    boost::posix_time::time_duration dt[11];
+    boost::posix_time::time_duration dt[16];
 
     std::ofstream out_stream;
     out_stream.open("performance_data.dat");
-    out_stream << "N\tGauss\tPLU\tChol\tJac\tQR\tSymQR\tLDL\tSVD\tJac_E\tQR_E\tSVD_E" << std::endl;
+    out_stream << "N\tGauss\tPLU\tChol\tJac\tQR\tSymQR\tLDL\tSVD\tJac_E\tQR_E\tSVD_E\tPLU_B\tChol_D\tChol_B\tQR_D\tQR_B" << std::endl;
     std::cout << "Recording performance..." << std::endl;
     for(unsigned int i=3;i<=1000;i += inc) {
       if(i == 50) {
@@ -129,6 +130,33 @@ int main() {
       decompose_SVD(m_test,m_svd_U,m_svd_E,m_svd_V,double(1E-15));
       dt[10] = boost::posix_time::microsec_clock::local_time() - t1;
       
+      mat<double,mat_structure::square> m_plu_b_inv(i);
+      t1 = boost::posix_time::microsec_clock::local_time();
+      invert_PLU_blocked(m_test,m_plu_b_inv,double(1E-15));
+      dt[11] = boost::posix_time::microsec_clock::local_time() - t1;
+      
+      mat<double,mat_structure::square> m_chol_L(i);
+      t1 = boost::posix_time::microsec_clock::local_time();
+      decompose_Cholesky(m_test,m_chol_L,double(1E-15));
+      dt[12] = boost::posix_time::microsec_clock::local_time() - t1;
+      
+      mat<double,mat_structure::square> m_chol_b_L(i);
+      t1 = boost::posix_time::microsec_clock::local_time();
+      decompose_Cholesky_blocked(m_test,m_chol_b_L,double(1E-15));
+      dt[13] = boost::posix_time::microsec_clock::local_time() - t1;
+      
+      mat<double,mat_structure::square> m_qr_Qd(i);
+      mat<double,mat_structure::square> m_qr_Rd(i);
+      t1 = boost::posix_time::microsec_clock::local_time();
+      decompose_QR(m_test,m_qr_Qd,m_qr_Rd,double(1E-15));
+      dt[14] = boost::posix_time::microsec_clock::local_time() - t1;
+      
+      mat<double,mat_structure::square> m_qr_b_Q(i);
+      mat<double,mat_structure::square> m_qr_b_R(i);
+      t1 = boost::posix_time::microsec_clock::local_time();
+      decompose_QR_blocked(m_test,m_qr_b_Q,m_qr_b_R,double(1E-15));
+      dt[15] = boost::posix_time::microsec_clock::local_time() - t1;
+      
       out_stream << i << "\t" << dt[0].total_microseconds()
                       << "\t" << dt[1].total_microseconds()
                       << "\t" << dt[2].total_microseconds()
@@ -139,7 +167,12 @@ int main() {
 		      << "\t" << dt[7].total_microseconds()
 		      << "\t" << dt[8].total_microseconds()
                       << "\t" << dt[9].total_microseconds()
-                      << "\t" << dt[10].total_microseconds() << std::endl;
+                      << "\t" << dt[10].total_microseconds()
+                      << "\t" << dt[11].total_microseconds()
+                      << "\t" << dt[12].total_microseconds()
+                      << "\t" << dt[13].total_microseconds()
+                      << "\t" << dt[14].total_microseconds()
+                      << "\t" << dt[15].total_microseconds() << std::endl;
       std::cout << i << std::endl;
 
     };
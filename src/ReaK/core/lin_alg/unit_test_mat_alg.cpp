@@ -315,3 +315,135 @@ BOOST_AUTO_TEST_CASE( mat_operator_tests )
 };
 
 
+
+
+BOOST_AUTO_TEST_CASE( mat_fixed_tests )
+{
+  using namespace ReaK;
+  using std::fabs;
+  
+  mat<double,mat_structure::rectangular> m_dyn(3,4);
+  for(unsigned int i = 0; i < 3; ++i)
+    for(unsigned int j = 0; j < 4; ++j)
+      m_dyn(i,j) = double(i * 4 + j + 1);
+  
+  mat_fix<double,mat_structure::rectangular,3,4> m_fix(m_dyn);
+  BOOST_CHECK_EQUAL( m_fix.get_row_count(), 3u );
+  BOOST_CHECK_EQUAL( m_fix.get_col_count(), 4u );
+  BOOST_CHECK( is_null_mat(m_fix - m_dyn, std::numeric_limits<double>::epsilon()) );
+  BOOST_CHECK_THROW( (mat_fix<double,mat_structure::rectangular,4,4>(m_dyn)), std::range_error );
+  
+  mat_fix<double,mat_structure::rectangular,4,3,mat_alignment::row_major> m_fix_t = transpose(m_fix);
+  BOOST_CHECK( is_null_mat(m_fix_t - transpose(m_dyn), std::numeric_limits<double>::epsilon()) );
+  
+  mat_fix<double,mat_structure::rectangular,3,3> p_fix = m_fix * m_fix_t;
+  mat<double,mat_structure::rectangular> p_dyn = m_dyn * transpose(m_dyn);
+  BOOST_CHECK( is_null_mat(p_fix - p_dyn, 1e-12) );
+  
+  mat_fix<double,mat_structure::rectangular,3,4> s_fix = m_fix + m_fix;
+  BOOST_CHECK( is_null_mat(s_fix - 2.0 * m_dyn, std::numeric_limits<double>::epsilon()) );
+  s_fix -= m_fix;
+  BOOST_CHECK( is_null_mat(s_fix - m_dyn, std::numeric_limits<double>::epsilon()) );
+  
+  vect<double,4> v4(1.0,-1.0,2.0,0.5);
+  vect<double,3> mv = m_fix * v4;
+  vect_n<double> mv_dyn = m_dyn * vect_n<double>(1.0,-1.0,2.0,0.5);
+  for(unsigned int i = 0; i < 3; ++i)
+    BOOST_CHECK( fabs(mv[i] - mv_dyn[i]) < 1e-12 );
+  vect<double,4> vm = vect<double,3>(1.0,2.0,3.0) * m_fix;
+  vect_n<double> vm_dyn = vect_n<double>(1.0,2.0,3.0) * m_dyn;
+  for(unsigned int i = 0; i < 4; ++i)
+    BOOST_CHECK( fabs(vm[i] - vm_dyn[i]) < 1e-12 );
+  
+  mat_fix<double,mat_structure::symmetric,3> sym_fix(p_fix);
+  BOOST_CHECK( fabs(sym_fix(0,2) - sym_fix(2,0)) < std::numeric_limits<double>::epsilon() );
+  sym_fix(1,2) = 42.0;
+  BOOST_CHECK( fabs(sym_fix(2,1) - 42.0) < std::numeric_limits<double>::epsilon() );
+  
+  mat_fix<double,mat_structure::diagonal,3> d_fix(vect<double,3>(1.0,2.0,3.0));
+  const mat_fix<double,mat_structure::diagonal,3>& d_fix_ref = d_fix;
+  BOOST_CHECK( fabs(d_fix_ref(1,1) - 2.0) < std::numeric_limits<double>::epsilon() );
+  BOOST_CHECK( fabs(d_fix_ref(0,1)) < std::numeric_limits<double>::epsilon() );
+  mat_fix<double,mat_structure::diagonal,3> d2_fix = d_fix * d_fix;
+  BOOST_CHECK( fabs(d2_fix(2,2) - 9.0) < std::numeric_limits<double>::epsilon() );
+  BOOST_CHECK( fabs(trace(d2_fix) - 14.0) < std::numeric_limits<double>::epsilon() );
+  
+};
+
+
+BOOST_AUTO_TEST_CASE( mat_lazy_expr_tests )
+{
+  using namespace ReaK;
+  
+  mat<double,mat_structure::rectangular> A(3,3);
+  mat<double,mat_structure::rectangular> B(3,2);
+  for(unsigned int i = 0; i < 3; ++i) {
+    for(unsigned int j = 0; j < 3; ++j)
+      A(i,j) = double(i * 3 + j + 1) / (j + 2.0);
+    for(unsigned int j = 0; j < 2; ++j)
+      B(i,j) = double(i) - 0.5 * j;
+  };
+  mat<double,mat_structure::symmetric> Q(mat<double,mat_structure::identity>(3));
+  mat<double,mat_structure::square> U(mat<double,mat_structure::identity>(2));
+  
+  mat<double,mat_structure::rectangular> R(3,3);
+  lazy_assign(R, lazy_expr(A) + 2.0 * lazy_expr(A) - transpose(lazy_expr(A)) / 2.0);
+  BOOST_CHECK( is_null_mat(R - (A + 2.0 * A - 0.5 * transpose(A)), 1e-12) );
+  
+  lazy_add_assign(R, -lazy_expr(A));
+  BOOST_CHECK( is_null_mat(R - (2.0 * A - 0.5 * transpose(A)), 1e-12) );
+  lazy_sub_assign(R, lazy_expr(A) * 2.0);
+  BOOST_CHECK( is_null_mat(R + 0.5 * transpose(A), 1e-12) );
+  
+  mat<double,mat_structure::rectangular> P(3,3);
+  P = A * transpose(A) + Q;
+  mat<double,mat_structure::rectangular> P_eager = A * P * transpose(A) + B * U * transpose(B);
+  lazy_assign(P, lazy_expr(A) * P * transpose(lazy_expr(A)) + lazy_expr(B) * U * transpose(lazy_expr(B)));
+  BOOST_CHECK( is_null_mat(P - P_eager, 1e-9) );
+  
+  mat<double,mat_structure::rectangular> M(A);
+  lazy_assign(M, transpose(lazy_expr(M)));
+  BOOST_CHECK( is_null_mat(M - transpose(A), 1e-12) );
+  
+  mat<double,mat_structure::symmetric> S(3);
+  lazy_assign(S, lazy_expr(A) * transpose(lazy_expr(A)) + Q);
+  BOOST_CHECK( is_null_mat(S - (A * transpose(A) + Q), 1e-12) );
+  
+  mat<double,mat_structure::rectangular> E;
+  lazy_assign(E, lazy_expr(B) * transpose(lazy_expr(B)));
+  BOOST_CHECK( is_null_mat(E - B * transpose(B), 1e-12) );
+  
+  vect_n<double> x(1.0, -2.0, 0.5);
+  vect_n<double> y = A * x + x;
+  vect_n<double> z(3, 0.0);
+  lazy_assign(z, lazy_expr(A) * x + lazy_expr(x));
+  BOOST_CHECK( norm_2(z - y) < 1e-12 );
+  lazy_assign(x, lazy_expr(A) * x + lazy_expr(x));
+  BOOST_CHECK( norm_2(x - y) < 1e-12 );
+  lazy_sub_assign(z, 2.0 * lazy_expr(y) - lazy_expr(y));
+  BOOST_CHECK( norm_2(z) < 1e-12 );
+  
+  mat<double,mat_structure::square> Sq(3);
+  BOOST_CHECK_THROW( lazy_assign(Sq, lazy_expr(B) * U), std::range_error );
+  BOOST_CHECK_THROW( lazy_add_assign(R, lazy_expr(B)), std::range_error );
+  
+  // aliasing through views of the destination.
+  typedef mat<double,mat_structure::rectangular> mat_type;
+  M = A;
+  lazy_assign(M, transpose(lazy_expr(mat_sub_block<mat_type>(M,3,3,0,0))));
+  BOOST_CHECK( is_null_mat(M - transpose(A), 1e-12) );
+  
+  M = A;
+  lazy_assign(M, lazy_expr(transpose_view(M)) + A);
+  BOOST_CHECK( is_null_mat(M - (transpose(A) + A), 1e-12) );
+  
+  mat_type W(3,4);
+  for(unsigned int i = 0; i < 3; ++i)
+    for(unsigned int j = 0; j < 4; ++j)
+      W(i,j) = double(i * 4 + j);
+  mat_type W_left(mat_const_sub_block<mat_type>(W,3,3,0,0));
+  mat_sub_block<mat_type> W_right(W,3,3,0,1);
+  lazy_assign(W_right, lazy_expr(mat_const_sub_block<mat_type>(W,3,3,0,0)));
+  BOOST_CHECK( is_null_mat(W_right - W_left, 1e-12) );
+  
+};
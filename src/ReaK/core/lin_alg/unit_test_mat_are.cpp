@@ -33,6 +33,7 @@
 #include <fstream>
 #include <sstream>
 #include <string>
+#include <cmath>
 
 #define BOOST_TEST_DYN_LINK
 
@@ -224,3 +225,74 @@ BOOST_AUTO_TEST_CASE( mat_carex_tests )
 
 
 
+
+
+
+BOOST_AUTO_TEST_CASE( mat_care_newton_kleinman_tests )
+{
+
+  using namespace ReaK;
+  
+  // A lightly damped 2-dof oscillator, and a perturbation of it, to test the warm-started solution.
+  mat<double,mat_structure::square> A(4, 0.0);
+  A(0,2) = 1.0; A(1,3) = 1.0;
+  A(2,0) = -2.0; A(2,1) = 1.0; A(2,2) = -0.1;
+  A(3,0) = 1.0; A(3,1) = -1.0; A(3,3) = -0.1;
+  mat<double,mat_structure::rectangular> B(4, 2, 0.0);
+  B(2,0) = 1.0; B(3,1) = 1.0;
+  mat<double,mat_structure::diagonal> Q(4, 1.0);
+  mat<double,mat_structure::diagonal> R(2, 0.1);
+  
+  mat<double,mat_structure::square> A2 = A;
+  A2(2,0) = -2.1; A2(3,1) = -0.9;
+  
+  mat<double,mat_structure::square> P_ref(4);
+  BOOST_CHECK_NO_THROW( solve_care_problem(A2, B, Q, R, P_ref, 1e-8) );
+  
+  mat<double,mat_structure::square> P(4);
+  BOOST_CHECK_NO_THROW( solve_care_problem(A, B, Q, R, P, 1e-8) );
+  bool converged = false;
+  BOOST_CHECK_NO_THROW( converged = solve_care_newton_kleinman(A2, B, Q, R, P, 1e-10, 10) );
+  BOOST_CHECK( converged );
+  BOOST_CHECK_MESSAGE( (norm_1(P - P_ref) < 1e-6 * norm_1(P_ref)), "Warm-started Newton-Kleinman solution does not match the QZ solution!" );
+  
+  // the Lyapunov solution for the stable closed-loop.
+  mat<double,mat_structure::square> X(4);
+  mat<double,mat_structure::rectangular> K(2,4);
+  mat<double,mat_structure::rectangular> BtP(2,4);
+  BtP = transpose_view(B) * P_ref;
+  linlsq_QR(R, K, BtP);
+  mat<double,mat_structure::square> Acl(A2 - B * K);
+  BOOST_CHECK_NO_THROW( solve_clyap_problem(Acl, Q, X, 1e-10) );
+  BOOST_CHECK( (norm_1(transpose_view(Acl) * X + X * Acl + Q) < 1e-8 * norm_1(X)) );
+  
+  // a larger, non-symmetric, stable system with both real and complex eigenvalues.
+  mat<double,mat_structure::square> A3(12);
+  mat<double,mat_structure::square> Q3(12);
+  for(std::size_t i = 0; i < 12; ++i) {
+    for(std::size_t j = 0; j < 12; ++j) {
+      A3(i,j) = std::sin(double(3 * i + 7 * j + 1));
+      Q3(i,j) = std::cos(double(i + j)) + (i == j ? 12.0 : 0.0);
+    };
+    A3(i,i) -= 4.0;
+  };
+  mat<double,mat_structure::square> X3(12);
+  BOOST_CHECK_NO_THROW( solve_clyap_problem(A3, Q3, X3, 1e-10) );
+  BOOST_CHECK( (norm_1(transpose_view(A3) * X3 + X3 * A3 + Q3) < 1e-8 * norm_1(X3)) );
+  
+  // an unstable open-loop, so a zero initial guess gives a non-stabilizing (zero) gain, which is rejected.
+  mat<double,mat_structure::square> A4 = A2;
+  A4(2,2) = 0.5;
+  mat<double,mat_structure::square> P4(4, 0.0);
+  converged = true;
+  BOOST_CHECK_NO_THROW( converged = solve_care_newton_kleinman(A4, B, Q, R, P4, 1e-10, 10) );
+  BOOST_CHECK( !converged );
+  // the solution of the stable system is stabilizing for the unstable one too (the feedback dominates).
+  P4 = P_ref;
+  BOOST_CHECK_NO_THROW( converged = solve_care_newton_kleinman(A4, B, Q, R, P4, 1e-10, 10) );
+  BOOST_CHECK( converged );
+  mat<double,mat_structure::rectangular> Rinv_Bt(2,4);
+  linlsq_QR(R, Rinv_Bt, mat<double,mat_structure::rectangular>(transpose_view(B)));
+  BOOST_CHECK( (norm_1(transpose_view(A4) * P4 + P4 * A4 + Q - P4 * B * Rinv_Bt * P4) < 1e-8 * norm_1(P4)) );
+  
+};
@@ -40,6 +40,10 @@
 
 #include "mat_balance.hpp"
 
+#include "mat_sparse_ldl.hpp"
+
+#include "mat_blocked_decomp.hpp"
+
 #define BOOST_TEST_DYN_LINK
 
 #define BOOST_TEST_MODULE mat_num
@@ -424,7 +428,25 @@ BOOST_AUTO_TEST_CASE( mat_decompositions_tests )
   BOOST_CHECK( is_lower_triangular(m_test_L, std::numeric_limits<double>::epsilon()) );
   BOOST_CHECK( is_diagonal(m_test_D, std::numeric_limits<double>::epsilon()) );
   BOOST_CHECK( is_null_mat(((m_test_L * m_test_D * transpose_view(m_test_L)) - m_test_sqr), 1e-6) );
-  
+
+  m_test_sqr(0,0) = 6.0; m_test_sqr(0,1) = 3.0; m_test_sqr(0,2) = 2.0;
+  m_test_sqr(1,0) = 3.0; m_test_sqr(1,1) = 5.0; m_test_sqr(1,2) = 2.0;
+  m_test_sqr(2,0) = 2.0; m_test_sqr(2,1) = 2.0; m_test_sqr(2,2) = 4.0;
+  m_test_L = mat<double,mat_structure::nil>(3,3);
+  BOOST_CHECK_NO_THROW( (decompose_Cholesky(m_test_sqr,m_test_L,1e-6)) );
+  vect<double,3> v_upd(1.0, -0.5, 2.0);
+  mat<double,mat_structure::square> m_test_outer(3,0.0);
+  for(unsigned int i = 0; i < 3; ++i)
+    for(unsigned int j = 0; j < 3; ++j)
+      m_test_outer(i,j) = v_upd[i] * v_upd[j];
+  BOOST_CHECK_NO_THROW( (update_Cholesky(m_test_L,v_upd)) );
+  BOOST_CHECK( is_lower_triangular(m_test_L, std::numeric_limits<double>::epsilon()) );
+  BOOST_CHECK( is_null_mat(((m_test_L * transpose_view(m_test_L)) - m_test_sqr - m_test_outer), 1e-6) );
+  BOOST_CHECK_NO_THROW( (downdate_Cholesky(m_test_L,v_upd,1e-6)) );
+  BOOST_CHECK( is_lower_triangular(m_test_L, std::numeric_limits<double>::epsilon()) );
+  BOOST_CHECK( is_null_mat(((m_test_L * transpose_view(m_test_L)) - m_test_sqr), 1e-6) );
+  BOOST_CHECK_THROW( (downdate_Cholesky(m_test_L,vect<double,3>(10.0, 0.0, 0.0),1e-6)), singularity_error );
+
 };
 
 
@@ -631,8 +653,167 @@ BOOST_AUTO_TEST_CASE( mat_balancing_tests )
 
 
 
+BOOST_AUTO_TEST_CASE( mat_sparse_LDL_tests )
+{
+  using namespace ReaK;
+  
+  mat<double,mat_structure::symmetric> m_gauss(2.0, -1.0,  0.0,  
+                                                     2.0, -1.0, 
+                                                           2.0);
+  mat<double,mat_structure::symmetric> m_gauss_trueinv(0.75, 0.5,  0.25,  
+                                                             1.0,  0.5, 
+                                                                   0.75);
+  
+  mat_sparse<double> m_sp(m_gauss);
+  BOOST_CHECK_EQUAL( m_sp.get_nonzero_count(), 7 );
+  BOOST_CHECK( ( is_null_mat(mat<double,mat_structure::square>(m_sp) - m_gauss, std::numeric_limits<double>::epsilon()) ) );
+  BOOST_CHECK( ( is_null_mat(mat<double,mat_structure::square>(transpose(m_sp) * m_sp) - m_gauss * m_gauss, std::numeric_limits<double>::epsilon()) ) );
+  BOOST_CHECK( ( is_null_mat(mat<double,mat_structure::square>(m_sp + m_sp) - (m_gauss + m_gauss), std::numeric_limits<double>::epsilon()) ) );
+  
+  vect_n<double> v(1.0, 2.0, 3.0);
+  BOOST_CHECK( ( norm_2(m_sp * v - m_gauss * v) < std::numeric_limits<double>::epsilon() ) );
+  BOOST_CHECK( ( norm_2(v * m_sp - v * m_gauss) < std::numeric_limits<double>::epsilon() ) );
+  
+  sparse_LDL_decomposition<double> ldl;
+  BOOST_CHECK_NO_THROW( ldl.factorize(m_sp, 1E-15) );
+  BOOST_CHECK_EQUAL( ldl.get_positive_pivot_count(), 3 );
+  mat<double,mat_structure::square> m_sp_inv(3);
+  for(std::size_t j = 0; j < 3; ++j) {
+    vect_n<double> e_j(3, 0.0);
+    e_j[j] = 1.0;
+    BOOST_CHECK_NO_THROW( ldl.solve(e_j) );
+    for(std::size_t i = 0; i < 3; ++i)
+      m_sp_inv(i,j) = e_j[i];
+  };
+  BOOST_CHECK( ( is_null_mat(m_sp_inv - m_gauss_trueinv, 4.0 * std::numeric_limits<double>::epsilon()) ) );
+  
+  // same pattern, different values: the symbolic analysis must be re-used.
+  m_sp *= 2.0;
+  BOOST_CHECK_NO_THROW( ldl.factorize(m_sp, 1E-15) );
+  BOOST_CHECK_EQUAL( ldl.get_analysis_count(), 1 );
+  vect_n<double> x = v;
+  BOOST_CHECK_NO_THROW( ldl.solve(x) );
+  BOOST_CHECK( ( norm_2(m_sp * x - v) < 8.0 * std::numeric_limits<double>::epsilon() ) );
+  
+  // quasi-definite (KKT) matrix: [H A'; A -d I]
+  mat_sparse<double> m_kkt(5,5);
+  m_kkt(0,0) = 4.0; m_kkt(0,1) = 1.0; m_kkt(1,0) = 1.0; m_kkt(1,1) = 3.0; m_kkt(2,2) = 2.0;
+  m_kkt(0,3) = 1.0; m_kkt(3,0) = 1.0; m_kkt(2,3) = 1.0; m_kkt(3,2) = 1.0;
+  m_kkt(1,4) = 1.0; m_kkt(4,1) = 1.0; m_kkt(2,4) = -1.0; m_kkt(4,2) = -1.0;
+  m_kkt(3,3) = -1E-8; m_kkt(4,4) = -1E-8;
+  BOOST_CHECK_NO_THROW( ldl.factorize(m_kkt, 1E-15) );
+  BOOST_CHECK_EQUAL( ldl.get_analysis_count(), 2 );
+  BOOST_CHECK_EQUAL( ldl.get_positive_pivot_count(), 3 );
+  BOOST_CHECK_EQUAL( ldl.get_negative_pivot_count(), 2 );
+  vect_n<double> b(1.0, -1.0, 2.0, 0.5, 0.25);
+  vect_n<double> y = b;
+  BOOST_CHECK_NO_THROW( ldl.solve(y, 2) );
+  BOOST_CHECK( ( norm_2(m_kkt * y - b) < 1E-10 ) );
+  
+};
+
 
 
+BOOST_AUTO_TEST_CASE( mat_blocked_decompositions_tests )
+{
+  using namespace ReaK;
+  
+  // tridiagonal (positive-definite) test matrix, large enough to use several blocks.
+  const std::size_t N = 37;
+  mat<double,mat_structure::symmetric> m_test(N, 0.0);
+  for(std::size_t i = 0; i < N; ++i) {
+    m_test(i,i) = 4.0;
+    if(i + 1 < N)
+      m_test(i,i+1) = -1.0;
+    if(i + 3 < N)
+      m_test(i,i+3) = 0.5;
+  };
+  mat<double,mat_structure::square> m_nonsym(m_test);
+  for(std::size_t i = 0; i + 2 < N; ++i)
+    m_nonsym(i+2,i) += 1.5;
+  
+  mat<double,mat_structure::square> L(N), L_blk(N);
+  BOOST_CHECK_NO_THROW( decompose_Cholesky(m_test, L, 1E-15) );
+  BOOST_CHECK_NO_THROW( decompose_Cholesky_blocked(m_test, L_blk, 1E-15, 8, 2) );
+  BOOST_CHECK( ( is_null_mat(L_blk - L, 1E-12) ) );
+  BOOST_CHECK( ( is_null_mat(L_blk * transpose_view(L_blk) - m_test, 1E-12) ) );
+  
+  mat<double,mat_structure::square> Q(N), Q_blk(N), R(N), R_blk(N);
+  BOOST_CHECK_NO_THROW( decompose_QR(m_nonsym, Q, R, 1E-15) );
+  BOOST_CHECK_NO_THROW( decompose_QR_blocked(m_nonsym, Q_blk, R_blk, 1E-15, 8, 2) );
+  BOOST_CHECK( ( is_null_mat(Q_blk * R_blk - m_nonsym, 1E-12) ) );
+  BOOST_CHECK( ( is_null_mat(transpose_view(Q_blk) * Q_blk - mat<double,mat_structure::identity>(N), 1E-12) ) );
+  BOOST_CHECK( ( is_null_mat(R_blk - R, 1E-12) ) );
+  
+  mat<double,mat_structure::square> A_plu(m_nonsym), A_plu_blk(m_nonsym);
+  mat<double,mat_structure::rectangular> x(N, 2, 1.0), x_blk(N, 2, 1.0);
+  for(std::size_t i = 0; i < N; ++i)
+    x_blk(i,1) = x(i,1) = double(i);
+  vect_n<unsigned int> P, P_blk;
+  BOOST_CHECK_NO_THROW( linsolve_PLU(A_plu, x, P, 1E-15) );
+  BOOST_CHECK_NO_THROW( linsolve_PLU_blocked(A_plu_blk, x_blk, P_blk, 1E-15, 8, 2) );
+  BOOST_CHECK( ( is_null_mat(x_blk - x, 1E-12) ) );
+  BOOST_CHECK( ( is_null_mat(A_plu_blk - A_plu, 1E-12) ) );
+  mat<double,mat_structure::rectangular> b_check(N, 2, 1.0);
+  for(std::size_t i = 0; i < N; ++i)
+    b_check(i,1) = double(i);
+  BOOST_CHECK( ( is_null_mat(m_nonsym * x_blk - b_check, 1E-12) ) );
+  
+  // a matrix which is not diagonally dominant, such that the PLU decompositions must swap rows 
+  // (with a permutation that is not its own inverse), both above and below the blocked threshold.
+  const std::size_t sizes[] = {40, 150};
+  for(std::size_t t = 0; t < 2; ++t) {
+    const std::size_t M = sizes[t];
+    mat<double,mat_structure::square> m_piv(M);
+    for(std::size_t i = 0; i < M; ++i)
+      for(std::size_t j = 0; j < M; ++j)
+        m_piv(i,j) = std::sin(double(5 * i + 3 * j + 2)) + (j == (i + 1) % M ? 2.0 : 0.0);
+    
+    mat<double,mat_structure::square> A_piv(m_piv);
+    vect_n<double> b_piv(M, 1.0), x_piv(M, 1.0);
+    vect_n<unsigned int> P_piv;
+    BOOST_CHECK_NO_THROW( linsolve_PLU(A_piv, x_piv, P_piv, 1E-15) );
+    bool is_involution = true;
+    for(std::size_t i = 0; i < M; ++i)
+      if(P_piv[P_piv[i]] != i)
+        is_involution = false;
+    BOOST_CHECK( !is_involution );
+    BOOST_CHECK( ( norm_2(m_piv * x_piv - b_piv) < 1E-9 ) );
+    
+    mat<double,mat_structure::square> A_piv_inv(M);
+    BOOST_CHECK_NO_THROW( invert_PLU(m_piv, A_piv_inv, 1E-15) );
+    BOOST_CHECK( ( is_null_mat(m_piv * A_piv_inv - mat<double,mat_structure::identity>(M), 1E-9) ) );
+    BOOST_CHECK_NO_THROW( invert_PLU_blocked(m_piv, A_piv_inv, 1E-15) );
+    BOOST_CHECK( ( is_null_mat(m_piv * A_piv_inv - mat<double,mat_structure::identity>(M), 1E-9) ) );
+    BOOST_CHECK_NO_THROW( invert_PLU_blocked(m_piv, A_piv_inv, 1E-15, 16, 2) );
+    BOOST_CHECK( ( is_null_mat(m_piv * A_piv_inv - mat<double,mat_structure::identity>(M), 1E-9) ) );
+  };
+  
+};
 
 
 
+BOOST_AUTO_TEST_CASE( mat_fixed_solver_tests )
+{
+  using namespace ReaK;
+  
+  mat_fix<double,mat_structure::symmetric,4> A_spd(4, true);
+  for(unsigned int i = 0; i < 4; ++i)
+    for(unsigned int j = i; j < 4; ++j)
+      A_spd(i,j) = (i == j ? 10.0 : 1.0 / double(i + j + 1));
+  mat_fix<double,mat_structure::rectangular,4,2> B_fix(4,2,1.0);
+  mat_fix<double,mat_structure::rectangular,4,2> X_fix(B_fix);
+  linsolve_Cholesky(A_spd, X_fix);
+  BOOST_CHECK( is_null_mat(A_spd * X_fix - B_fix, 1e-12) );
+  
+  mat_fix<double,mat_structure::square,4> A_inv(4, false);
+  invert_Cholesky(A_spd, A_inv);
+  BOOST_CHECK( is_null_mat(A_inv * A_spd - mat<double,mat_structure::identity>(4), 1e-12) );
+  
+  mat_fix<double,mat_structure::square,4> A_sq(A_spd);
+  A_sq(0,3) = 2.0;
+  mat_fix<double,mat_structure::square,4> A_sq_inv(4, false);
+  invert_PLU(A_sq, A_sq_inv);
+  BOOST_CHECK( is_null_mat(A_sq * A_sq_inv - mat<double,mat_structure::identity>(4), 1e-12) );
+  
+};
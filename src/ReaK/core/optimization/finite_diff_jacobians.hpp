@@ -39,11 +39,17 @@
 
 #include "lin_alg/mat_alg.hpp"
 
+#include "base/thread_incl.hpp"
+
 #include <boost/mpl/and.hpp>
 #include <boost/mpl/or.hpp>
 #include <boost/utility/enable_if.hpp>
 #include <boost/bind.hpp>
 
+#include <vector>
+#include <complex>
+#include <exception>
+
 
 namespace ReaK {
   
@@ -163,6 +169,192 @@ void compute_jacobian_5pts_central_impl(Function f, Vector1& x, const Vector2& y
 };
 
 
+/* The finite-difference schemes available for the evaluation of a Jacobian column. */
+enum jacobian_fd_scheme {
+  fd_2pts_forward = 0,
+  fd_2pts_central,
+  fd_5pts_central
+};
+
+/* Computes the j-th column of the Jacobian with a given finite-difference scheme, x[j] is restored on exit. */
+template <typename Function, typename Vector1, typename Vector2, typename Matrix>
+void compute_jacobian_column_impl(Function& f, Vector1& x, const Vector2& y, Matrix& jac, 
+                                  typename vect_traits<Vector1>::size_type j, 
+                                  typename vect_traits<Vector1>::value_type delta, 
+                                  jacobian_fd_scheme scheme) {
+  typedef typename vect_traits<Vector1>::value_type ValueType;
+  typedef typename vect_traits<Vector1>::size_type SizeType;
+  using std::fabs;
+  
+  SizeType M = y.size();
+  
+  /* determine d=max(1E-04*|p[j]|, delta), see HZ */
+  ValueType d = ValueType(1E-04) * fabs(x[j]);
+  if( d < delta )
+    d = delta;
+  
+  ValueType tmp = x[j];
+  switch(scheme) {
+    case fd_2pts_forward:
+      {
+        x[j] += d;
+        Vector2 y1 = f(x);
+        x[j] = tmp;
+        slice(jac)(range(SizeType(0),M-1),j) = (y1 - y) * (1.0 / d);
+      };
+      break;
+    case fd_2pts_central:
+      {
+        x[j] -= d;
+        Vector2 y_prev = f(x);
+        x[j] = tmp + d;
+        Vector2 y_next = f(x);
+        x[j] = tmp;
+        slice(jac)(range(SizeType(0),M-1),j) = (y_next - y_prev) * (0.5 / d);
+      };
+      break;
+    case fd_5pts_central:
+      {
+        x[j] -= 2.0 * d;
+        Vector2 y0 = f(x);
+        x[j] += d;
+        Vector2 y1 = f(x);
+        x[j] += 2.0 * d;
+        Vector2 y2 = f(x);
+        x[j] += d;
+        Vector2 y3 = f(x);
+        x[j] = tmp;
+        slice(jac)(range(SizeType(0),M-1),j) = (y0 - 8.0 * (y1 - y2) - y3) * (1.0 / (12.0 * d));
+      };
+      break;
+  };
+};
+
+/* 
+ * This functor computes a subset of the columns of a finite-difference Jacobian (every 
+ * stride-th column, starting at first). Each worker holds its own clone of the function 
+ * and its own copy of the input vector, such that workers can run concurrently, each 
+ * writing to distinct columns of the Jacobian matrix. An exception thrown by the function 
+ * is caught and stored (to be rethrown by the caller once all the workers have joined).
+ */
+template <typename Function, typename Vector1, typename Vector2, typename Matrix>
+struct jacobian_columns_worker {
+  Function f;
+  Vector1 x;
+  const Vector2* y;
+  Matrix* jac;
+  std::size_t first;
+  std::size_t stride;
+  typename vect_traits<Vector1>::value_type delta;
+  jacobian_fd_scheme scheme;
+  std::exception_ptr* error;
+  
+  jacobian_columns_worker(const Function& aF, const Vector1& aX, const Vector2* aY, Matrix* aJac,
+                          std::size_t aFirst, std::size_t aStride, 
+                          typename vect_traits<Vector1>::value_type aDelta, jacobian_fd_scheme aScheme,
+                          std::exception_ptr* aError) :
+                          f(aF), x(aX), y(aY), jac(aJac), first(aFirst), stride(aStride), 
+                          delta(aDelta), scheme(aScheme), error(aError) { };
+  
+  void operator()() {
+    try {
+      for(std::size_t j = first; j < x.size(); j += stride)
+        compute_jacobian_column_impl(f, x, *y, *jac, j, delta, scheme);
+    } catch(...) {
+      *error = std::current_exception();
+    };
+  };
+};
+
+template <typename Function, typename Vector1, typename Vector2, typename Matrix>
+void compute_jacobian_parallel_impl(const std::vector< Function >& fs, const Vector1& x, const Vector2& y, Matrix& jac, 
+                                    typename vect_traits<Vector1>::value_type delta, jacobian_fd_scheme scheme) {
+  typedef typename vect_traits<Vector1>::size_type SizeType;
+  typedef jacobian_columns_worker< Function, Vector1, Vector2, Matrix > worker_type;
+  
+  SizeType N = x.size();
+  SizeType M = y.size();
+  if(jac.get_row_count() != M) 
+    jac.set_row_count(M);
+  if(jac.get_col_count() != N)
+    jac.set_col_count(N);
+  if(fs.empty() || (N == 0))
+    return;
+  
+  std::size_t stride = (fs.size() < N ? fs.size() : N);
+  
+  std::vector< std::exception_ptr > errors(stride);
+  std::vector< shared_ptr< ReaKaux::thread > > threads;
+  for(std::size_t i = 1; i < stride; ++i)
+    threads.push_back(shared_ptr< ReaKaux::thread >(new ReaKaux::thread(
+      worker_type(fs[i], x, &y, &jac, i, stride, delta, scheme, &errors[i]))));
+  worker_type(fs[0], x, &y, &jac, 0, stride, delta, scheme, &errors[0])();
+  for(std::size_t i = 0; i < threads.size(); ++i)
+    threads[i]->join();
+  for(std::size_t i = 0; i < stride; ++i)
+    if(errors[i])
+      std::rethrow_exception(errors[i]);
+};
+
+template <typename Function, typename Vector1, typename Vector2, typename Matrix>
+void compute_jacobian_cpr_impl(Function f, Vector1& x, const Vector2& y, Matrix& jac, 
+                               const std::vector< std::vector< std::size_t > >& aColRows,
+                               const std::vector< std::vector< std::size_t > >& aGroups,
+                               typename vect_traits<Vector1>::value_type delta, bool aCentral) {
+  typedef typename vect_traits<Vector1>::value_type ValueType;
+  typedef typename vect_traits<Vector1>::size_type SizeType;
+  using std::fabs;
+  
+  SizeType N = x.size();
+  SizeType M = y.size();
+  if(aColRows.size() != N)
+    throw std::range_error("The sparsity pattern of the Jacobian does not match the number of input variables!");
+  if(jac.get_row_count() != M) 
+    jac.set_row_count(M);
+  if(jac.get_col_count() != N)
+    jac.set_col_count(N);
+  for(SizeType j = 0; j < N; ++j)
+    for(SizeType i = 0; i < M; ++i)
+      jac(i,j) = ValueType(0.0);
+  
+  std::vector< ValueType > d(N, ValueType(0.0));
+  std::vector< ValueType > x_saved(N, ValueType(0.0));
+  for(std::size_t g = 0; g < aGroups.size(); ++g) {
+    const std::vector< std::size_t >& cols = aGroups[g];
+    
+    for(std::size_t k = 0; k < cols.size(); ++k) {
+      SizeType j = cols[k];
+      /* determine d=max(1E-04*|p[j]|, delta), see HZ */
+      d[j] = ValueType(1E-04) * fabs(x[j]);
+      if( d[j] < delta )
+        d[j] = delta;
+      x_saved[j] = x[j];
+      x[j] += d[j];
+    };
+    Vector2 y_next = f(x);
+    
+    if(aCentral) {
+      for(std::size_t k = 0; k < cols.size(); ++k)
+        x[cols[k]] = x_saved[cols[k]] - d[cols[k]];
+      Vector2 y_prev = f(x);
+      for(std::size_t k = 0; k < cols.size(); ++k) {
+        SizeType j = cols[k];
+        x[j] = x_saved[j]; /* restore */
+        for(std::size_t l = 0; l < aColRows[j].size(); ++l)
+          jac(aColRows[j][l], j) = (y_next[aColRows[j][l]] - y_prev[aColRows[j][l]]) * (0.5 / d[j]);
+      };
+    } else {
+      for(std::size_t k = 0; k < cols.size(); ++k) {
+        SizeType j = cols[k];
+        x[j] = x_saved[j]; /* restore */
+        for(std::size_t l = 0; l < aColRows[j].size(); ++l)
+          jac(aColRows[j][l], j) = (y_next[aColRows[j][l]] - y[aColRows[j][l]]) * (1.0 / d[j]);
+      };
+    };
+  };
+};
+
+
 
 template <typename Function, typename Vector, typename Scalar>
 vect<Scalar,1> scalar_return_function_to_vect_function(Function f, const Vector& x) {
@@ -400,6 +592,247 @@ void >::type compute_jacobian_5pts_central(Function f, Scalar1& x, const Scalar2
 
 
 
+/**
+ * Computes the Jacobian of a function by 2-point forward finite-differences, evaluating the 
+ * columns of the Jacobian concurrently, one thread per function object given. Each thread 
+ * uses its own function object (thread-cloned functors), such that functions with internal 
+ * state (e.g., a kinematics model that is updated during the evaluation) can be used as 
+ * long as each function object of the vector is an independent clone.
+ * \param fs The function objects, one per thread, all evaluating the same function.
+ * \param x The point at which to evaluate the Jacobian.
+ * \param y The value of the function at x.
+ * \param jac Stores, as output, the (y.size() x x.size()) Jacobian matrix.
+ * \param delta The minimum finite-difference step.
+ */
+template <typename Function, typename Vector1, typename Vector2, typename Matrix>
+typename boost::enable_if< 
+  boost::mpl::and_<
+    is_readable_vector<Vector1>,
+    is_readable_vector<Vector2>,
+    is_fully_writable_matrix<Matrix> 
+  >,
+void >::type compute_jacobian_2pts_forward_parallel(const std::vector< Function >& fs, const Vector1& x, const Vector2& y, Matrix& jac, typename vect_traits<Vector1>::value_type delta = typename vect_traits<Vector1>::value_type(1e-6)) {
+  detail::compute_jacobian_parallel_impl(fs,x,y,jac,delta,detail::fd_2pts_forward);
+};
+
+/**
+ * Computes the Jacobian of a function by 2-point forward finite-differences, evaluating the 
+ * columns of the Jacobian concurrently on a given number of threads, each using a copy of 
+ * the function object (which must therefore be safe to copy and to use concurrently).
+ * \param f The function object.
+ * \param x The point at which to evaluate the Jacobian.
+ * \param y The value of the function at x.
+ * \param jac Stores, as output, the (y.size() x x.size()) Jacobian matrix.
+ * \param aThreadCount The number of threads to use (including the calling thread).
+ * \param delta The minimum finite-difference step.
+ */
+template <typename Function, typename Vector1, typename Vector2, typename Matrix>
+typename boost::enable_if< 
+  boost::mpl::and_<
+    is_readable_vector<Vector1>,
+    is_readable_vector<Vector2>,
+    is_fully_writable_matrix<Matrix> 
+  >,
+void >::type compute_jacobian_2pts_forward_parallel(Function f, const Vector1& x, const Vector2& y, Matrix& jac, std::size_t aThreadCount, typename vect_traits<Vector1>::value_type delta = typename vect_traits<Vector1>::value_type(1e-6)) {
+  detail::compute_jacobian_parallel_impl(std::vector< Function >(aThreadCount, f),x,y,jac,delta,detail::fd_2pts_forward);
+};
+
+/**
+ * Computes the Jacobian of a function by 2-point central finite-differences, evaluating the 
+ * columns of the Jacobian concurrently, one thread per function object given (see 
+ * compute_jacobian_2pts_forward_parallel).
+ * \param fs The function objects, one per thread, all evaluating the same function.
+ * \param x The point at which to evaluate the Jacobian.
+ * \param y The value of the function at x.
+ * \param jac Stores, as output, the (y.size() x x.size()) Jacobian matrix.
+ * \param delta The minimum finite-difference step.
+ */
+template <typename Function, typename Vector1, typename Vector2, typename Matrix>
+typename boost::enable_if< 
+  boost::mpl::and_<
+    is_readable_vector<Vector1>,
+    is_readable_vector<Vector2>,
+    is_fully_writable_matrix<Matrix> 
+  >,
+void >::type compute_jacobian_2pts_central_parallel(const std::vector< Function >& fs, const Vector1& x, const Vector2& y, Matrix& jac, typename vect_traits<Vector1>::value_type delta = typename vect_traits<Vector1>::value_type(1e-6)) {
+  detail::compute_jacobian_parallel_impl(fs,x,y,jac,delta,detail::fd_2pts_central);
+};
+
+/**
+ * Computes the Jacobian of a function by 2-point central finite-differences, evaluating the 
+ * columns of the Jacobian concurrently on a given number of threads, each using a copy of 
+ * the function object (which must therefore be safe to copy and to use concurrently).
+ * \param f The function object.
+ * \param x The point at which to evaluate the Jacobian.
+ * \param y The value of the function at x.
+ * \param jac Stores, as output, the (y.size() x x.size()) Jacobian matrix.
+ * \param aThreadCount The number of threads to use (including the calling thread).
+ * \param delta The minimum finite-difference step.
+ */
+template <typename Function, typename Vector1, typename Vector2, typename Matrix>
+typename boost::enable_if< 
+  boost::mpl::and_<
+    is_readable_vector<Vector1>,
+    is_readable_vector<Vector2>,
+    is_fully_writable_matrix<Matrix> 
+  >,
+void >::type compute_jacobian_2pts_central_parallel(Function f, const Vector1& x, const Vector2& y, Matrix& jac, std::size_t aThreadCount, typename vect_traits<Vector1>::value_type delta = typename vect_traits<Vector1>::value_type(1e-6)) {
+  detail::compute_jacobian_parallel_impl(std::vector< Function >(aThreadCount, f),x,y,jac,delta,detail::fd_2pts_central);
+};
+
+/**
+ * Computes the Jacobian of a function by 5-point central finite-differences, evaluating the 
+ * columns of the Jacobian concurrently, one thread per function object given (see 
+ * compute_jacobian_2pts_forward_parallel).
+ * \param fs The function objects, one per thread, all evaluating the same function.
+ * \param x The point at which to evaluate the Jacobian.
+ * \param y The value of the function at x.
+ * \param jac Stores, as output, the (y.size() x x.size()) Jacobian matrix.
+ * \param delta The minimum finite-difference step.
+ */
+template <typename Function, typename Vector1, typename Vector2, typename Matrix>
+typename boost::enable_if< 
+  boost::mpl::and_<
+    is_readable_vector<Vector1>,
+    is_readable_vector<Vector2>,
+    is_fully_writable_matrix<Matrix> 
+  >,
+void >::type compute_jacobian_5pts_central_parallel(const std::vector< Function >& fs, const Vector1& x, const Vector2& y, Matrix& jac, typename vect_traits<Vector1>::value_type delta = typename vect_traits<Vector1>::value_type(1e-6)) {
+  detail::compute_jacobian_parallel_impl(fs,x,y,jac,delta,detail::fd_5pts_central);
+};
+
+
+
+/**
+ * Computes the column groups of the Curtis-Powell-Reid (CPR) method for the estimation of a 
+ * sparse Jacobian with a known sparsity pattern. Columns that have no non-zero row in common 
+ * are placed in the same group, such that they can all be perturbed at once, requiring only 
+ * one function evaluation (two for central differences) per group instead of per column. 
+ * The groups are formed greedily, in the order of the columns.
+ * \param aColRows The sparsity pattern of the Jacobian, as the list of the indices of the non-zero rows of each column.
+ * \param aRowCount The number of rows of the Jacobian (outputs of the function).
+ * \param aGroups Stores, as output, the list of the column indices of each group.
+ */
+inline void compute_jacobian_cpr_groups(const std::vector< std::vector< std::size_t > >& aColRows, std::size_t aRowCount,
+                                        std::vector< std::vector< std::size_t > >& aGroups) {
+  aGroups.clear();
+  std::vector< std::vector< bool > > used_rows;
+  for(std::size_t j = 0; j < aColRows.size(); ++j) {
+    std::size_t g = 0;
+    for(; g < aGroups.size(); ++g) {
+      bool conflict = false;
+      for(std::size_t l = 0; l < aColRows[j].size(); ++l) {
+        if(used_rows[g][aColRows[j][l]]) {
+          conflict = true;
+          break;
+        };
+      };
+      if(!conflict)
+        break;
+    };
+    if(g == aGroups.size()) {
+      aGroups.push_back(std::vector< std::size_t >());
+      used_rows.push_back(std::vector< bool >(aRowCount, false));
+    };
+    aGroups[g].push_back(j);
+    for(std::size_t l = 0; l < aColRows[j].size(); ++l)
+      used_rows[g][aColRows[j][l]] = true;
+  };
+};
+
+/**
+ * Computes a sparse Jacobian, with a known sparsity pattern, by 2-point forward finite-differences
+ * using the Curtis-Powell-Reid (CPR) grouping of the columns (see compute_jacobian_cpr_groups). 
+ * The entries of the Jacobian outside of the sparsity pattern are set to zero.
+ * \param f The function object.
+ * \param x The point at which to evaluate the Jacobian.
+ * \param y The value of the function at x.
+ * \param jac Stores, as output, the (y.size() x x.size()) Jacobian matrix.
+ * \param aColRows The sparsity pattern of the Jacobian, as the list of the indices of the non-zero rows of each column.
+ * \param aGroups The column groups, as computed by compute_jacobian_cpr_groups.
+ * \param delta The minimum finite-difference step.
+ */
+template <typename Function, typename Vector1, typename Vector2, typename Matrix>
+typename boost::enable_if< 
+  boost::mpl::and_<
+    is_readable_vector<Vector1>,
+    is_readable_vector<Vector2>,
+    is_fully_writable_matrix<Matrix> 
+  >,
+void >::type compute_jacobian_2pts_forward_cpr(Function f, Vector1& x, const Vector2& y, Matrix& jac, 
+                                               const std::vector< std::vector< std::size_t > >& aColRows,
+                                               const std::vector< std::vector< std::size_t > >& aGroups,
+                                               typename vect_traits<Vector1>::value_type delta = typename vect_traits<Vector1>::value_type(1e-6)) {
+  detail::compute_jacobian_cpr_impl(f,x,y,jac,aColRows,aGroups,delta,false);
+};
+
+/**
+ * Computes a sparse Jacobian, with a known sparsity pattern, by 2-point central finite-differences
+ * using the Curtis-Powell-Reid (CPR) grouping of the columns (see compute_jacobian_cpr_groups). 
+ * The entries of the Jacobian outside of the sparsity pattern are set to zero.
+ * \param f The function object.
+ * \param x The point at which to evaluate the Jacobian.
+ * \param y The value of the function at x.
+ * \param jac Stores, as output, the (y.size() x x.size()) Jacobian matrix.
+ * \param aColRows The sparsity pattern of the Jacobian, as the list of the indices of the non-zero rows of each column.
+ * \param aGroups The column groups, as computed by compute_jacobian_cpr_groups.
+ * \param delta The minimum finite-difference step.
+ */
+template <typename Function, typename Vector1, typename Vector2, typename Matrix>
+typename boost::enable_if< 
+  boost::mpl::and_<
+    is_readable_vector<Vector1>,
+    is_readable_vector<Vector2>,
+    is_fully_writable_matrix<Matrix> 
+  >,
+void >::type compute_jacobian_2pts_central_cpr(Function f, Vector1& x, const Vector2& y, Matrix& jac, 
+                                               const std::vector< std::vector< std::size_t > >& aColRows,
+                                               const std::vector< std::vector< std::size_t > >& aGroups,
+                                               typename vect_traits<Vector1>::value_type delta = typename vect_traits<Vector1>::value_type(1e-6)) {
+  detail::compute_jacobian_cpr_impl(f,x,y,jac,aColRows,aGroups,delta,true);
+};
+
+
+
+/**
+ * Computes the Jacobian of a function by the complex-step method, i.e., J(:,j) = Im(f(x + i h e_j)) / h.
+ * Unlike finite-differences, this method is not subject to subtractive cancellation, and thus, the 
+ * step h can be taken extremely small to obtain a Jacobian accurate to machine precision. However, 
+ * the function must be analytic and implemented such that it can be evaluated with complex numbers, 
+ * i.e., it must be callable with a std::vector< std::complex<T> > and return a std::vector< std::complex<T> >.
+ * \param f The function object, taking and returning vectors of std::complex values.
+ * \param x The point at which to evaluate the Jacobian.
+ * \param jac Stores, as output, the Jacobian matrix.
+ * \param h The imaginary step.
+ */
+template <typename Function, typename Vector, typename Matrix>
+typename boost::enable_if< 
+  boost::mpl::and_<
+    is_readable_vector<Vector>,
+    is_fully_writable_matrix<Matrix> 
+  >,
+void >::type compute_jacobian_complex_step(Function f, const Vector& x, Matrix& jac, typename vect_traits<Vector>::value_type h = typename vect_traits<Vector>::value_type(1e-20)) {
+  typedef typename vect_traits<Vector>::value_type ValueType;
+  typedef typename vect_traits<Vector>::size_type SizeType;
+  typedef std::complex<ValueType> ComplexType;
+  
+  SizeType N = x.size();
+  std::vector< ComplexType > xc(N);
+  for(SizeType j = 0; j < N; ++j)
+    xc[j] = ComplexType(x[j], ValueType(0.0));
+  
+  for(SizeType j = 0; j < N; ++j) {
+    xc[j] = ComplexType(x[j], h);
+    std::vector< ComplexType > yc = f(xc);
+    xc[j] = ComplexType(x[j], ValueType(0.0));
+    if(j == 0) {
+      jac.set_row_count(yc.size());
+      jac.set_col_count(N);
+    };
+    for(SizeType i = 0; i < yc.size(); ++i)
+      jac(i,j) = yc[i].imag() / h;
+  };
+};
 
 
 
@@ -0,0 +1,606 @@
+/**
+ * \file lbfgs_methods.hpp
+ *
+ * The following library provides the limited-memory BFGS method (L-BFGS) to perform non-linear
+ * optimization of large problems. Instead of the dense (n x n) Hessian approximations used by
+ * the quasi-Newton methods (see quasi_newton_methods.hpp), this method only stores the last
+ * few (m) steps and gradient changes, and applies the approximate (inverse) Hessian implicitly.
+ * Simple limits on the search domain (e.g. box constraints) can be imposed via the limit-functions
+ * (see limit_functions.hpp), in which case the method behaves as a projected L-BFGS method (L-BFGS-B)
+ * which performs the quasi-Newton iterations only over the variables that are not at their limits.
+ * Both a line-search and a trust-region version of the method are provided.
+ *
+ * \author Sven Mikael Persson <mikael.s.persson@gmail.com>
+ * \date June 2013
+ */
+
+/*
+ *    Copyright 2013 Sven Mikael Persson
+ *
+ *    THIS SOFTWARE IS DISTRIBUTED UNDER THE TERMS OF THE GNU GENERAL PUBLIC LICENSE v3 (GPLv3).
+ *
+ *    This file is part of ReaK.
+ *
+ *    ReaK is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    (at your option) any later version.
+ *
+ *    ReaK is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with ReaK (as LICENSE in the root folder).
+ *    If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef REAK_LBFGS_METHODS_HPP
+#define REAK_LBFGS_METHODS_HPP
+
+#include "base/defs.hpp"
+
+#include "lin_alg/vect_alg.hpp"
+#include "lin_alg/mat_num_exceptions.hpp"
+
+#include "trust_region_search.hpp"
+#include "line_search.hpp"
+#include "limit_functions.hpp"
+
+#include <deque>
+#include <vector>
+
+
+namespace ReaK {
+
+
+namespace optim {
+
+
+/**
+ * This class template stores a limited-memory BFGS approximation of the Hessian of a function.
+ * Only the last m pairs of steps (s) and gradient changes (y) are kept. The product of the
+ * inverse Hessian approximation with a vector is computed with the two-loop recursion, in O(mn),
+ * and the product of the Hessian approximation with a vector (B * v, available as an operator
+ * to use this object as an implicit matrix, e.g., within trust_region_solver_steihaug_cg) is
+ * computed from the unrolled form of the BFGS updates, in O(mn) as well.
+ * \tparam Vector The vector type of the independent variable of the function.
+ */
+template <typename Vector>
+class limited_memory_bfgs_approx {
+  public:
+    typedef limited_memory_bfgs_approx<Vector> self;
+    typedef typename vect_traits<Vector>::value_type value_type;
+    typedef typename vect_traits<Vector>::size_type size_type;
+
+  private:
+    std::deque< Vector > s_list;
+    std::deque< Vector > y_list;
+    std::deque< value_type > rho_list;
+    std::vector< Vector > a_list;
+    std::vector< Vector > b_list;
+    size_type m;
+    value_type gamma;
+
+    void compute_unrolled_form() {
+      using std::sqrt;
+      a_list.resize(s_list.size());
+      b_list.resize(s_list.size());
+      for(size_type i = 0; i < s_list.size(); ++i) {
+        b_list[i] = y_list[i];
+        b_list[i] *= sqrt(rho_list[i]);
+        a_list[i] = s_list[i];
+        a_list[i] *= value_type(1.0) / gamma;
+        for(size_type j = 0; j < i; ++j) {
+          a_list[i] += (b_list[j] * s_list[i]) * b_list[j];
+          a_list[i] -= (a_list[j] * s_list[i]) * a_list[j];
+        };
+        a_list[i] *= value_type(1.0) / sqrt(s_list[i] * a_list[i]);
+      };
+    };
+
+  public:
+
+    /**
+     * Default constructor.
+     * \param aMemorySize The number of step / gradient-change pairs to keep.
+     */
+    explicit limited_memory_bfgs_approx(size_type aMemorySize = 10) : m(aMemorySize), gamma(1.0) { };
+
+    /**
+     * Returns the number of step / gradient-change pairs currently stored.
+     */
+    size_type size() const { return s_list.size(); };
+    /**
+     * Returns the maximum number of step / gradient-change pairs kept.
+     */
+    size_type get_memory_size() const { return m; };
+
+    /**
+     * Clears the approximation (i.e. resets it to identity).
+     */
+    void clear() {
+      s_list.clear(); y_list.clear(); rho_list.clear();
+      a_list.clear(); b_list.clear();
+      gamma = value_type(1.0);
+    };
+
+    /**
+     * Updates the approximation with a new step and gradient change. The update is skipped
+     * if the curvature condition (y * s > 0) is not met by a sufficient margin, which preserves
+     * the positive-definiteness of the approximation.
+     * \param s The step taken.
+     * \param y The change in the gradient corresponding to the step taken.
+     * \param abs_tol The tolerance on the curvature, relative to the norm of y.
+     * \return True if the approximation was updated.
+     */
+    bool update(const Vector& s, const Vector& y, value_type abs_tol = value_type(1e-8)) {
+      value_type ys = y * s;
+      value_type yy = y * y;
+      if((ys <= abs_tol * yy) || (yy == value_type(0.0)))
+        return false;
+      if(m == 0)
+        return false;
+      if(s_list.size() >= m) {
+        s_list.pop_front(); y_list.pop_front(); rho_list.pop_front();
+      };
+      s_list.push_back(s);
+      y_list.push_back(y);
+      rho_list.push_back(value_type(1.0) / ys);
+      gamma = ys / yy;
+      compute_unrolled_form();
+      return true;
+    };
+
+    /**
+     * Computes the product of the inverse Hessian approximation with a vector (two-loop recursion).
+     * \param v The vector to multiply, which also stores the result.
+     */
+    void apply_inverse(Vector& v) const {
+      std::vector< value_type > alpha(s_list.size());
+      for(size_type i = s_list.size(); i > 0; --i) {
+        alpha[i-1] = rho_list[i-1] * (s_list[i-1] * v);
+        v -= alpha[i-1] * y_list[i-1];
+      };
+      v *= gamma;
+      for(size_type i = 0; i < s_list.size(); ++i) {
+        value_type beta = rho_list[i] * (y_list[i] * v);
+        v += (alpha[i] - beta) * s_list[i];
+      };
+    };
+
+    /**
+     * Computes the product of the Hessian approximation with a vector.
+     * \param v The vector to multiply.
+     * \return The product B * v.
+     */
+    Vector apply(const Vector& v) const {
+      Vector result = v;
+      result *= value_type(1.0) / gamma;
+      for(size_type i = 0; i < s_list.size(); ++i) {
+        result += (b_list[i] * v) * b_list[i];
+        result -= (a_list[i] * v) * a_list[i];
+      };
+      return result;
+    };
+
+    /**
+     * Multiplication of the Hessian approximation with a vector.
+     */
+    friend Vector operator *(const self& B, const Vector& v) {
+      return B.apply(v);
+    };
+
+};
+
+
+
+namespace detail {
+
+
+  /**
+   * This function determines which variables are at their limits (epsilon-active set), by
+   * probing the limit-function with a small step (of size eps) in the steepest-descent direction.
+   * The components of the given vector that correspond to active variables are zeroed.
+   */
+  template <typename Vector, typename LimitFunction>
+  void lbfgs_find_active_set(const Vector& x, const Vector& x_grad, LimitFunction impose_limits,
+                             typename vect_traits<Vector>::value_type eps, std::vector<bool>& active) {
+    typedef typename vect_traits<Vector>::value_type ValueType;
+    typedef typename vect_traits<Vector>::size_type SizeType;
+    using std::fabs;
+    Vector probe = x_grad;
+    for(SizeType i = 0; i < probe.size(); ++i) {
+      if(x_grad[i] > ValueType(0.0))
+        probe[i] = -eps;
+      else if(x_grad[i] < ValueType(0.0))
+        probe[i] = eps;
+    };
+    impose_limits(x, probe);
+    active.resize(probe.size());
+    for(SizeType i = 0; i < probe.size(); ++i)
+      active[i] = (x_grad[i] != ValueType(0.0)) && (fabs(probe[i]) < ValueType(0.5) * eps);
+  };
+
+  template <typename Vector>
+  void lbfgs_zero_active(Vector& v, const std::vector<bool>& active) {
+    typedef typename vect_traits<Vector>::value_type ValueType;
+    typedef typename vect_traits<Vector>::size_type SizeType;
+    for(SizeType i = 0; i < v.size(); ++i)
+      if(active[i])
+        v[i] = ValueType(0.0);
+  };
+
+  /**
+   * This function computes the projected gradient (i.e. the steepest-descent step allowed by the
+   * limit-function) and returns its norm, which is used as the convergence criterion.
+   */
+  template <typename Vector, typename LimitFunction>
+  typename vect_traits<Vector>::value_type lbfgs_projected_grad_norm(const Vector& x, const Vector& x_grad, LimitFunction impose_limits) {
+    Vector pg = -x_grad;
+    impose_limits(x, pg);
+    return norm_2(pg);
+  };
+
+  /**
+   * This function computes the L-BFGS search direction over the free (inactive) variables,
+   * falling back to the (free) steepest-descent direction if the result is not a descent direction.
+   */
+  template <typename Vector>
+  void lbfgs_compute_direction(limited_memory_bfgs_approx<Vector>& H, const Vector& x_grad,
+                               const std::vector<bool>& active, Vector& p) {
+    typedef typename vect_traits<Vector>::value_type ValueType;
+    Vector g_free = x_grad;
+    lbfgs_zero_active(g_free, active);
+    p = g_free;
+    H.apply_inverse(p);
+    lbfgs_zero_active(p, active);
+    if((p * g_free) <= ValueType(0.0)) {
+      H.clear();
+      p = g_free;
+    };
+    p = -p;
+  };
+
+
+  template <typename Function, typename GradFunction, typename Vector, typename LineSearcher, typename LimitFunction>
+  void lbfgs_method_ls_impl(Function f, GradFunction df, Vector& x, unsigned int memory_size, unsigned int max_iter,
+                            LineSearcher get_alpha, LimitFunction impose_limits,
+                            typename vect_traits<Vector>::value_type abs_tol,
+                            typename vect_traits<Vector>::value_type abs_grad_tol) {
+    typedef typename vect_traits<Vector>::value_type ValueType;
+    using std::fabs;
+
+    limited_memory_bfgs_approx<Vector> H(memory_size);
+    std::vector<bool> active;
+
+    ValueType x_value = f(x);
+    Vector x_grad = df(x);
+    Vector p = x_grad;
+    Vector y = x_grad;
+
+    unsigned int k = 0;
+    while(true) {
+      ValueType norm_pg = lbfgs_projected_grad_norm(x, x_grad, impose_limits);
+      if(norm_pg < abs_grad_tol)
+        return;
+      lbfgs_find_active_set(x, x_grad, impose_limits, (norm_pg < ValueType(1e-3) ? norm_pg : ValueType(1e-3)), active);
+      lbfgs_compute_direction(H, x_grad, active, p);
+      if(H.size() == 0) {
+        // scale the first steepest-descent step to a unit-length.
+        ValueType norm_p = norm_2(p);
+        if(norm_p > ValueType(1.0))
+          p *= ValueType(1.0) / norm_p;
+      };
+
+      // check Wolfe for alpha 1.0
+      ValueType alpha = ValueType(1.0);
+      ValueType pxg = -(p * x_grad);
+      if((f(x + p) > x_value - ValueType(1e-4) * pxg) || (fabs(p * df(x + p)) > ValueType(0.9) * fabs(pxg)))
+        alpha = get_alpha(f,df,ValueType(0.0),ValueType(2.0),x,p,abs_tol);
+      p *= alpha;
+      impose_limits(x,p);
+      if(norm_2(p) < abs_tol)
+        return;
+      x += p;
+
+      if(++k > max_iter)
+        throw maximum_iteration(max_iter);
+
+      y = -x_grad;
+      x_value = f(x);
+      x_grad = df(x);
+      y += x_grad;
+      H.update(p, y);
+    };
+  };
+
+
+  template <typename Function, typename GradFunction, typename Vector, typename TrustRegionSolver, typename LimitFunction>
+  void lbfgs_method_tr_impl(Function f, GradFunction df, Vector& x, unsigned int memory_size,
+                            typename vect_traits<Vector>::value_type max_radius, unsigned int max_iter,
+                            TrustRegionSolver solve_step, LimitFunction impose_limits,
+                            typename vect_traits<Vector>::value_type abs_tol,
+                            typename vect_traits<Vector>::value_type abs_grad_tol,
+                            typename vect_traits<Vector>::value_type eta) {
+    typedef typename vect_traits<Vector>::value_type ValueType;
+
+    limited_memory_bfgs_approx<Vector> B(memory_size);
+
+    ValueType radius = ValueType(0.5) * max_radius;
+    ValueType x_value = f(x);
+    Vector x_grad = df(x);
+    Vector p = x_grad;
+    Vector y = x_grad;
+    ValueType norm_p = ValueType(0.0);
+
+    unsigned int k = 0;
+    while(true) {
+      if(lbfgs_projected_grad_norm(x, x_grad, impose_limits) < abs_grad_tol)
+        return;
+      solve_step(x_grad,B,p,norm_p,radius,abs_tol);
+      impose_limits(x,p);
+      norm_p = norm_2(p);
+      if(norm_p < abs_tol)
+        return;
+      Vector xt = x; xt += p;
+      ValueType xt_value = f(xt);
+      Vector xt_grad = df(xt);
+      ValueType aredux = x_value - xt_value;
+      ValueType predux = -(x_grad * p + ValueType(0.5) * (p * (B * p)));
+
+      y = xt_grad; y -= x_grad;
+      B.update(p, y);
+
+      ValueType ratio = aredux / predux;
+      if( ratio > ValueType(0.75) ) {
+        if(norm_p > ValueType(0.8) * radius) {
+          radius *= ValueType(2.0);
+          if(radius > max_radius)
+            radius = max_radius;
+        };
+      } else if( ratio < ValueType(0.1) ) {
+        radius *= ValueType(0.5);
+      };
+      if( ratio > eta ) {
+        x = xt;
+        x_value = xt_value;
+        x_grad = xt_grad;
+      };
+
+      if(++k > max_iter)
+        throw maximum_iteration(max_iter);
+    };
+  };
+
+
+};
+
+
+
+
+/**
+ * This functor is a factory class to construct a limited-memory BFGS (L-BFGS) optimizer routine
+ * that uses a line-search approach. When a limit-function is set (see set_limiter), the method
+ * becomes a projected L-BFGS method (L-BFGS-B, for box-limits) in which the variables at their
+ * limits are held fixed while the quasi-Newton step is taken over the free variables.
+ * Use make_lbfgs_method_ls to construct this without having to specify the template arguments explicitly.
+ * \test Must create a unit-test for this.
+ * \tparam Function The functor type of the function to optimize.
+ * \tparam GradFunction The functor type of the gradient of the function to optimize.
+ * \tparam T The value-type of the field on which the optimization is performed.
+ * \tparam LimitFunction A functor type that can impose limits on a proposed solution step (see no_limit_functor or box_limit_function for examples).
+ * \tparam LineSearcher A functor type that can perform a line-search which satisfy the strong Wolfe conditions (see line_search_expand_and_zoom).
+ */
+template <typename Function, typename GradFunction, typename T,
+          typename LimitFunction = no_limit_functor,
+          typename LineSearcher = line_search_expand_and_zoom<T> >
+struct lbfgs_method_ls_factory {
+  Function f;
+  GradFunction df;
+  unsigned int memory_size;
+  unsigned int max_iter;
+  T abs_tol;
+  T abs_grad_tol;
+  LimitFunction impose_limits;
+  LineSearcher get_alpha;
+
+  /**
+   * Parametrized constructor of the factory object.
+   * \param aF The function to minimize.
+   * \param aDf The gradient of the function to minimize.
+   * \param aMemorySize The number of past steps used to approximate the Hessian.
+   * \param aMaxIter The maximum number of iterations to perform.
+   * \param aTol The tolerance on the norm of step size.
+   * \param aGradTol The tolerance on the norm of the (projected) gradient.
+   * \param aImposeLimits The functor that can impose simple limits on the search domain.
+   * \param aGetAlpha The functor that can perform a line-search.
+   */
+  lbfgs_method_ls_factory(Function aF, GradFunction aDf, unsigned int aMemorySize = 10,
+                          unsigned int aMaxIter = 100, T aTol = T(1e-6), T aGradTol = T(1e-6),
+                          LimitFunction aImposeLimits = LimitFunction(),
+                          LineSearcher aGetAlpha = LineSearcher(1e-4,0.9)) :
+                          f(aF), df(aDf), memory_size(aMemorySize), max_iter(aMaxIter),
+                          abs_tol(aTol), abs_grad_tol(aGradTol),
+                          impose_limits(aImposeLimits), get_alpha(aGetAlpha) { };
+
+  /**
+   * This function finds the minimum of a function, given its derivative, using a
+   * limited-memory BFGS search direction and using a line-search approach.
+   * \tparam Vector The vector type of the independent variable for the function.
+   * \param x The initial guess to the solution, as well as a storage for the result of the algorihm.
+   */
+  template <typename Vector>
+  void operator()(Vector& x) const {
+    detail::lbfgs_method_ls_impl(f,df,x,memory_size,max_iter,get_alpha,impose_limits,abs_tol,abs_grad_tol);
+  };
+
+  /**
+   * This function remaps the factory to one which will use the given limit-function for the search domain.
+   * \tparam NewLimitFunction A new functor type that can impose limits on a proposed solution step (see no_limit_functor or box_limit_function for examples).
+   * \param new_limits The functor that can impose simple limits on the search domain.
+   */
+  template <typename NewLimitFunction>
+  lbfgs_method_ls_factory<Function,GradFunction,T,NewLimitFunction,LineSearcher>
+    set_limiter(NewLimitFunction new_limits) const {
+    return lbfgs_method_ls_factory<Function,GradFunction,T,NewLimitFunction,LineSearcher>(
+      f,df,memory_size,max_iter,abs_tol,abs_grad_tol,new_limits,get_alpha);
+  };
+
+  /**
+   * This function remaps the factory to one which will use the given line-search method.
+   * \tparam NewLineSearcher A functor type that can perform a line-search (see line_search_expand_and_zoom).
+   * \param new_line_searcher The functor that can perform a line-search.
+   */
+  template <typename NewLineSearcher>
+  lbfgs_method_ls_factory<Function,GradFunction,T,LimitFunction,NewLineSearcher>
+    set_line_searcher(NewLineSearcher new_line_searcher) const {
+    return lbfgs_method_ls_factory<Function,GradFunction,T,LimitFunction,NewLineSearcher>(
+      f,df,memory_size,max_iter,abs_tol,abs_grad_tol,impose_limits,new_line_searcher);
+  };
+
+};
+
+/**
+ * This function template creates a factory object to construct a limited-memory BFGS (L-BFGS)
+ * optimizer routine that uses a line-search approach.
+ * \test Must create a unit-test for this.
+ * \tparam Function The functor type of the function to optimize.
+ * \tparam GradFunction The functor type of the gradient of the function to optimize.
+ * \param f The function to minimize.
+ * \param df The gradient of the function to minimize.
+ * \param memory_size The number of past steps used to approximate the Hessian.
+ * \param max_iter The maximum number of iterations to perform.
+ * \param abs_tol The tolerance on the norm of the step size.
+ * \param abs_grad_tol The tolerance on the norm of the gradient.
+ */
+template <typename Function, typename GradFunction>
+lbfgs_method_ls_factory<Function,GradFunction,double>
+  make_lbfgs_method_ls(Function f, GradFunction df, unsigned int memory_size = 10,
+                       unsigned int max_iter = 100, double abs_tol = 1e-6, double abs_grad_tol = 1e-6) {
+  return lbfgs_method_ls_factory<Function,GradFunction,double>(f,df,memory_size,max_iter,abs_tol,abs_grad_tol);
+};
+
+
+
+
+/**
+ * This functor is a factory class to construct a limited-memory BFGS (L-BFGS) optimizer routine
+ * that uses a trust-region approach. The trust-region solver must only require products of the
+ * Hessian approximation with vectors (see trust_region_solver_steihaug_cg, the default).
+ * Use make_lbfgs_method_tr to construct this without having to specify the template arguments explicitly.
+ * \test Must create a unit-test for this.
+ * \tparam Function The functor type of the function to optimize.
+ * \tparam GradFunction The functor type of the gradient of the function to optimize.
+ * \tparam T The value-type of the field on which the optimization is performed.
+ * \tparam LimitFunction A functor type that can impose limits on a proposed solution step (see no_limit_functor or box_limit_function for examples).
+ * \tparam TrustRegionSolver A functor type that can solve for a solution step within a trust-region using only Hessian-vector products (see trust_region_solver_steihaug_cg).
+ */
+template <typename Function, typename GradFunction, typename T,
+          typename LimitFunction = no_limit_functor,
+          typename TrustRegionSolver = trust_region_solver_steihaug_cg<T> >
+struct lbfgs_method_tr_factory {
+  Function f;
+  GradFunction df;
+  unsigned int memory_size;
+  T max_radius;
+  unsigned int max_iter;
+  T abs_tol;
+  T abs_grad_tol;
+  T eta;
+  LimitFunction impose_limits;
+  TrustRegionSolver solve_step;
+
+  /**
+   * Parametrized constructor of the factory object.
+   * \param aF The function to minimize.
+   * \param aDf The gradient of the function to minimize.
+   * \param aMemorySize The number of past steps used to approximate the Hessian.
+   * \param aMaxRadius The maximum trust-region radius to use (i.e. maximum optimization step).
+   * \param aMaxIter The maximum number of iterations to perform.
+   * \param aTol The tolerance on the norm of step size.
+   * \param aGradTol The tolerance on the norm of the (projected) gradient.
+   * \param aEta The tolerance on the ratio between actual reduction and predicted reduction in order to accept a given step.
+   * \param aImposeLimits The functor that can impose simple limits on the search domain.
+   * \param aSolveStep The functor that can solve for a solution step within a trust-region.
+   */
+  lbfgs_method_tr_factory(Function aF, GradFunction aDf, unsigned int aMemorySize = 10,
+                          T aMaxRadius = T(1.0), unsigned int aMaxIter = 100,
+                          T aTol = T(1e-6), T aGradTol = T(1e-6), T aEta = T(1e-4),
+                          LimitFunction aImposeLimits = LimitFunction(),
+                          TrustRegionSolver aSolveStep = TrustRegionSolver()) :
+                          f(aF), df(aDf), memory_size(aMemorySize), max_radius(aMaxRadius),
+                          max_iter(aMaxIter), abs_tol(aTol), abs_grad_tol(aGradTol), eta(aEta),
+                          impose_limits(aImposeLimits), solve_step(aSolveStep) { };
+
+  /**
+   * This function finds the minimum of a function, given its derivative, using a
+   * limited-memory BFGS approximation of the Hessian and using a trust-region approach.
+   * \tparam Vector The vector type of the independent variable for the function.
+   * \param x The initial guess to the solution, as well as a storage for the result of the algorihm.
+   */
+  template <typename Vector>
+  void operator()(Vector& x) const {
+    detail::lbfgs_method_tr_impl(f,df,x,memory_size,max_radius,max_iter,solve_step,impose_limits,abs_tol,abs_grad_tol,eta);
+  };
+
+  /**
+   * This function remaps the factory to one which will use the given limit-function for the search domain.
+   * \tparam NewLimitFunction A new functor type that can impose limits on a proposed solution step (see no_limit_functor or box_limit_function for examples).
+   * \param new_limits The functor that can impose simple limits on the search domain.
+   */
+  template <typename NewLimitFunction>
+  lbfgs_method_tr_factory<Function,GradFunction,T,NewLimitFunction,TrustRegionSolver>
+    set_limiter(NewLimitFunction new_limits) const {
+    return lbfgs_method_tr_factory<Function,GradFunction,T,NewLimitFunction,TrustRegionSolver>(
+      f,df,memory_size,max_radius,max_iter,abs_tol,abs_grad_tol,eta,new_limits,solve_step);
+  };
+
+  /**
+   * This function remaps the factory to one which will use the given solver within the trust-region.
+   * \tparam NewTrustRegionSolver A functor type that can solve for a solution step within a trust-region using only Hessian-vector products.
+   * \param new_solver The functor that can solve for a solution step within a trust-region.
+   */
+  template <typename NewTrustRegionSolver>
+  lbfgs_method_tr_factory<Function,GradFunction,T,LimitFunction,NewTrustRegionSolver>
+    set_tr_solver(NewTrustRegionSolver new_solver) const {
+    return lbfgs_method_tr_factory<Function,GradFunction,T,LimitFunction,NewTrustRegionSolver>(
+      f,df,memory_size,max_radius,max_iter,abs_tol,abs_grad_tol,eta,impose_limits,new_solver);
+  };
+
+};
+
+/**
+ * This function template creates a factory object to construct a limited-memory BFGS (L-BFGS)
+ * optimizer routine that uses a trust-region approach.
+ * \test Must create a unit-test for this.
+ * \tparam Function The functor type of the function to optimize.
+ * \tparam GradFunction The functor type of the gradient of the function to optimize.
+ * \param f The function to minimize.
+ * \param df The gradient of the function to minimize.
+ * \param memory_size The number of past steps used to approximate the Hessian.
+ * \param max_radius The maximum trust-region radius to use (i.e. maximum optimization step).
+ * \param max_iter The maximum number of iterations to perform.
+ * \param abs_tol The tolerance on the norm of the step size.
+ * \param abs_grad_tol The tolerance on the norm of the gradient.
+ * \param eta The tolerance on the ratio between actual reduction and predicted reduction in order to accept a given step.
+ */
+template <typename Function, typename GradFunction>
+lbfgs_method_tr_factory<Function,GradFunction,double>
+  make_lbfgs_method_tr(Function f, GradFunction df, unsigned int memory_size = 10,
+                       double max_radius = 1.0, unsigned int max_iter = 100,
+                       double abs_tol = 1e-6, double abs_grad_tol = 1e-6, double eta = 1e-4) {
+  return lbfgs_method_tr_factory<Function,GradFunction,double>(f,df,memory_size,max_radius,max_iter,abs_tol,abs_grad_tol,eta);
+};
+
+
+
+};
+
+};
+
+
+#endif
+
+
@@ -432,7 +432,8 @@ namespace detail {
   
   template <typename Function, typename GradFunction, typename Vector, 
             typename EqFunction, typename EqJacFunction, 
-	    typename IneqFunction, typename IneqJacFunction>
+	    typename IneqFunction, typename IneqJacFunction,
+	    typename JacobianMatrix = mat<typename vect_traits<Vector>::value_type, mat_structure::rectangular> >
   struct merit_function_computer {
     
     typedef typename vect_traits<Vector>::value_type ValueType;
@@ -481,11 +482,11 @@ namespace detail {
       //for(SizeType i = 0; i < s.size(); ++i)
 	//muDlog_s +=  (mu * (*p_s)[i]) / s[i];
       Vector c_g = g(x); 
-      mat<ValueType, mat_structure::rectangular> Jac_g(c_g.size(),x.size());
+      JacobianMatrix Jac_g(c_g.size(),x.size());
       fill_g_jac(Jac_g,x,c_g); 
       
       Vector c_h = h(x);
-      mat<ValueType, mat_structure::rectangular> Jac_h(c_h.size(),x.size());
+      JacobianMatrix Jac_h(c_h.size(),x.size());
       fill_h_jac(Jac_h,x,c_h);
       c_h -= s;
       
@@ -506,26 +507,127 @@ namespace detail {
   
   
   
+  // multiplies each row of the matrix by the corresponding element of the vector.
+  template <typename Matrix, typename Vector>
+  void nlip_mult_rows(Matrix& J, const Vector& v) {
+    for(std::size_t i = 0; i < J.get_row_count(); ++i)
+      for(std::size_t j = 0; j < J.get_col_count(); ++j)
+	J(i,j) *= v[i];
+  };
+  
+  template <typename T, typename Vector>
+  void nlip_mult_rows(mat_sparse<T>& J, const Vector& v) {
+    typename mat_sparse<T>::container_type& q = J.get_values();
+    for(std::size_t p = 0; p < q.size(); ++p)
+      q[p] *= v[J.get_row_indices()[p]];
+  };
+  
+  // divides each row of the matrix by the corresponding element of the vector.
+  template <typename Matrix, typename Vector>
+  void nlip_div_rows(Matrix& J, const Vector& v) {
+    for(std::size_t i = 0; i < J.get_row_count(); ++i)
+      for(std::size_t j = 0; j < J.get_col_count(); ++j)
+	J(i,j) /= v[i];
+  };
+  
+  template <typename T, typename Vector>
+  void nlip_div_rows(mat_sparse<T>& J, const Vector& v) {
+    typename mat_sparse<T>::container_type& q = J.get_values();
+    for(std::size_t p = 0; p < q.size(); ++p)
+      q[p] /= v[J.get_row_indices()[p]];
+  };
+  
+  // computes the Hessian of the barrier sub-problem: qp_G = H + SJ' * ZJ.
+  template <typename Matrix1, typename Matrix2, typename Matrix3>
+  void nlip_compute_qp_hessian(const Matrix1& H, const Matrix2& SJ, const Matrix2& ZJ, Matrix3& qp_G) {
+    qp_G = H + transpose_view(SJ) * ZJ;
+  };
+  
+  template <typename T>
+  void nlip_compute_qp_hessian(const mat_sparse<T>& H, const mat_sparse<T>& SJ, const mat_sparse<T>& ZJ, mat_sparse<T>& qp_G) {
+    qp_G = H + transpose(SJ) * ZJ;
+  };
+  
+  // unconstrained problems with a dense Hessian matrix are solved with the Newton method.
+  template <typename Function, typename GradFunction, typename HessianFunction, 
+            typename Vector, typename EqQPSolver>
+  void nlip_unconstrained_newton_ls(Function f, GradFunction df, HessianFunction fill_hessian, 
+				    Vector& x, unsigned int max_iter,
+			            typename vect_traits<Vector>::value_type abs_tol, 
+				    typename vect_traits<Vector>::value_type kappa,
+				    EqQPSolver, boost::mpl::true_) {
+    typedef typename vect_traits<Vector>::value_type ValueType;
+    newton_method_ls_impl(f,df,fill_hessian,x,max_iter,line_search_expand_and_zoom<ValueType>(kappa,ValueType(0.9)),no_limit_functor(),newton_directioner(),abs_tol,abs_tol);
+  };
+  
+  // otherwise, the Newton direction is obtained from the EQP solver (without constraints).
+  template <typename Function, typename GradFunction, typename HessianFunction, 
+            typename Vector, typename EqQPSolver>
+  void nlip_unconstrained_newton_ls(Function f, GradFunction df, HessianFunction fill_hessian, 
+				    Vector& x, unsigned int max_iter,
+			            typename vect_traits<Vector>::value_type abs_tol, 
+				    typename vect_traits<Vector>::value_type kappa,
+				    EqQPSolver solve_eqp, boost::mpl::false_) {
+    typedef typename vect_traits<Vector>::value_type ValueType;
+    using std::fabs;
+    
+    typename EqQPSolver::jacobian_type A(0, x.size());
+    Vector b = x; b.resize(0);
+    
+    ValueType x_value = f(x);
+    Vector x_grad = df(x);
+    typename EqQPSolver::hessian_type H(mat<ValueType,mat_structure::identity>(x.size()));
+    fill_hessian(H,x,x_value,x_grad);
+    
+    line_search_expand_and_zoom<ValueType> get_alpha(kappa,ValueType(0.9));
+    Vector p = x_grad;
+    unsigned int k = 0;
+    while( norm_2(x_grad) > abs_tol ) {
+      solve_eqp(A, b, H, x_grad, p, std::numeric_limits<ValueType>::infinity(), max_iter, abs_tol, abs_tol);
+      ValueType alpha = ValueType(1.0);
+      ValueType pxg = p * x_grad;
+      if((f(x + p) > x_value + kappa * pxg) || (fabs(p * df(x + p)) > ValueType(0.9) * fabs(pxg)))
+        alpha = get_alpha(f,df,ValueType(0.0),ValueType(2.0),x,p,abs_tol);
+      p *= alpha;
+      x += p;
+      if(norm_2(p) < abs_tol)
+        return;
+      
+      if(++k > max_iter)
+	throw maximum_iteration(max_iter);
+      
+      Vector x_grad_prev = x_grad;
+      x_value = f(x);
+      x_grad = df(x);
+      fill_hessian(H,x,x_value,x_grad,p,x_grad - x_grad_prev);
+    };
+  };
+  
+  
+  
   template <typename Function, typename GradFunction, typename HessianFunction, 
             typename Vector, typename EqFunction, typename EqJacFunction, 
-	    typename IneqFunction, typename IneqJacFunction>
+	    typename IneqFunction, typename IneqJacFunction, typename EqQPSolver>
   void nl_intpoint_method_ls_impl(Function f, GradFunction df, HessianFunction fill_hessian,  
 				  EqFunction g, EqJacFunction fill_g_jac,
 				  IneqFunction h, IneqJacFunction fill_h_jac,
 				  Vector& x, 
-				  typename vect_traits<Vector>::value_type mu = typename vect_traits<Vector>::value_type(0.1), 
-				  unsigned int max_iter = 100,
-			          typename vect_traits<Vector>::value_type abs_tol = typename vect_traits<Vector>::value_type(1e-6), 
-				  typename vect_traits<Vector>::value_type kappa = typename vect_traits<Vector>::value_type(1e-4),
-				  typename vect_traits<Vector>::value_type tau = typename vect_traits<Vector>::value_type(0.995)) {
+				  typename vect_traits<Vector>::value_type mu, 
+				  unsigned int max_iter,
+			          typename vect_traits<Vector>::value_type abs_tol, 
+				  typename vect_traits<Vector>::value_type kappa,
+				  typename vect_traits<Vector>::value_type tau,
+				  EqQPSolver solve_eqp) {
     typedef typename vect_traits<Vector>::value_type ValueType;
     typedef typename vect_traits<Vector>::size_type SizeType;
+    typedef typename EqQPSolver::jacobian_type JacobianMatrix;
+    typedef typename EqQPSolver::hessian_type HessianMatrix;
     using std::sqrt; using std::fabs; using std::log;
     
     SizeType N = x.size();
     Vector c_h = h(x);
     SizeType K = c_h.size();
-    mat<ValueType, mat_structure::rectangular> Jac_h(K,N);
+    JacobianMatrix Jac_h(K,N);
     fill_h_jac(Jac_h,x,c_h);
     
     //compute initial slack vector and roughly adjust x if needed.
@@ -565,11 +667,12 @@ namespace detail {
     SizeType M = c_g.size();
     ValueType g_norm = norm_2(c_g);
     
-    mat<ValueType, mat_structure::rectangular> Jac_g(M,N);
+    JacobianMatrix Jac_g(M,N);
     fill_g_jac(Jac_g,x,c_g);
     
     if((M == 0) && (K == 0)) { //this means it is an unconstrained problem. TODO change this to dispatch on the type of the fill-hessian functor.
-      newton_method_ls_impl(f,df,fill_hessian,x,max_iter,line_search_expand_and_zoom<ValueType>(kappa,ValueType(0.9)),no_limit_functor(),newton_directioner(),abs_tol,abs_tol);
+      nlip_unconstrained_newton_ls(f,df,fill_hessian,x,max_iter,abs_tol,kappa,solve_eqp,
+                                   boost::mpl::bool_< boost::is_same< HessianMatrix, mat<ValueType,mat_structure::symmetric> >::value >());
       return;
     };
     
@@ -577,7 +680,7 @@ namespace detail {
     
     ValueType x_value = f(x);
     Vector x_grad = df(x);
-    mat<ValueType,mat_structure::symmetric> H(mat<ValueType,mat_structure::identity>(x.size()));
+    HessianMatrix H(mat<ValueType,mat_structure::identity>(x.size()));
     fill_hessian(H,x,x_value,x_grad);
     
     Vector y = c_g;
@@ -586,12 +689,12 @@ namespace detail {
       mat<ValueType,mat_structure::diagonal> mS(K);
       mat<ValueType,mat_structure::nil> Zero_mk(M,K);
     
-      mat_const_ref_horiz_cat< mat<ValueType, mat_structure::rectangular>, mat<ValueType, mat_structure::nil> > Jac_upper(Jac_g, Zero_mk);
-      mat_const_ref_horiz_cat< mat<ValueType, mat_structure::rectangular>, mat<ValueType, mat_structure::diagonal> > Jac_lower(Jac_h, mS);
+      mat_const_ref_horiz_cat< JacobianMatrix, mat<ValueType, mat_structure::nil> > Jac_upper(Jac_g, Zero_mk);
+      mat_const_ref_horiz_cat< JacobianMatrix, mat<ValueType, mat_structure::diagonal> > Jac_lower(Jac_h, mS);
     
       mat_const_ref_vert_cat< 
-        mat_const_ref_horiz_cat< mat<ValueType, mat_structure::rectangular>, mat<ValueType, mat_structure::nil> >,
-        mat_const_ref_horiz_cat< mat<ValueType, mat_structure::rectangular>, mat<ValueType, mat_structure::diagonal> >
+        mat_const_ref_horiz_cat< JacobianMatrix, mat<ValueType, mat_structure::nil> >,
+        mat_const_ref_horiz_cat< JacobianMatrix, mat<ValueType, mat_structure::diagonal> >
       > Jac_aug(Jac_upper,Jac_lower);
     
       mS = mat<ValueType,mat_structure::diagonal>(-s);
@@ -638,15 +741,13 @@ namespace detail {
     for(SizeType i = 0; i < K; ++i)
       muSES_inv(i,i) = mu / (z[i] * s[i]);
     
-    mat<ValueType,mat_structure::rectangular> ZJac_h(Jac_h);
-    mat<ValueType,mat_structure::rectangular> SJac_h(Jac_h);
-    for(SizeType i = 0; i < K; ++i)
-      for(SizeType j = 0; j < N; ++j) {
-	ZJac_h(i,j) *= z[i];
-	SJac_h(i,j) /= s[i];
-      };
+    JacobianMatrix ZJac_h(Jac_h);
+    JacobianMatrix SJac_h(Jac_h);
+    nlip_mult_rows(ZJac_h, z);
+    nlip_div_rows(SJac_h, s);
     
-    mat<ValueType,mat_structure::symmetric> qp_G(H + transpose_view(SJac_h) * ZJac_h);
+    HessianMatrix qp_G(H);
+    nlip_compute_qp_hessian(H, SJac_h, ZJac_h, qp_G);
     
     Vector qp_c(x_grad);
     Vector c_h_s = c_h;
@@ -654,7 +755,7 @@ namespace detail {
       c_h_s[i] /= s[i];
     qp_c -= y * Jac_g + z * Jac_h - (c_h_s - muSES_inv * vect_scalar<ValueType>(K,1.0)) * ZJac_h;
     
-    typedef merit_function_computer<Function,GradFunction,Vector,EqFunction,EqJacFunction,IneqFunction,IneqJacFunction> MeritFuncComputer;
+    typedef merit_function_computer<Function,GradFunction,Vector,EqFunction,EqJacFunction,IneqFunction,IneqJacFunction,JacobianMatrix> MeritFuncComputer;
     MeritFuncComputer m_func(f, df, x, p_x, s, p_s, nu, mu, g, fill_g_jac, h, fill_h_jac);
     
     
@@ -755,15 +856,11 @@ namespace detail {
 	
 	
 	
-	try {
-	  null_space_QP_method(Jac_g, -c_g, qp_G, qp_c, p_x, abs_tol, std::numeric_limits<ValueType>::infinity(), &p_y);
-	} catch(singularity_error&) {
-	  try {
-            projected_CG_method(Jac_g, -c_g, qp_G, qp_c, p_x, max_iter, abs_tol_mu, &p_y);
-	  } catch(maximum_iteration&) { };
-	};
+	solve_eqp(Jac_g, -c_g, qp_G, qp_c, p_x, std::numeric_limits<ValueType>::infinity(), max_iter, abs_tol, abs_tol_mu, &p_y);
 	
-// 	p_s = Jac_h * p_x + c_h - s;
+	// slack and (scaled) inequality multiplier steps, from the linearized inequalities and complementarity.
+	p_s = Jac_h * p_x + c_h - s;
+	p_z = muSES_inv * vect_scalar<ValueType>(K,ValueType(1.0)) - c_h_s - SJac_h * p_x;
 	ValueType alpha_s_max(1.0);
 	ValueType dq_p(0.0);
 	ValueType pHp = p_x * (H * p_x);
@@ -812,7 +909,6 @@ namespace detail {
 	else
           nu *= 1.1;
 	
-// 	p_z = muSES_inv * vect_scalar<ValueType>(K,ValueType(1.0)) - c_h_s - SJac_h * p_x;
 	ValueType alpha_z((mu * ValueType(K) - s * z) / (s * p_z));
 	for(SizeType i = 0; i < K; ++i) {
 	  if( alpha_z * p_z[i] < -tau )
@@ -831,11 +927,9 @@ namespace detail {
 	fill_h_jac(Jac_h,x,c_h);
 	h_norm = norm_2(c_h - s);
 	ZJac_h = Jac_h;
-        for(SizeType i = 0; i < K; ++i)
-          for(SizeType j = 0; j < N; ++j) {
-	    ZJac_h(i,j) *= z[i];
-	    SJac_h(i,j) /= s[i];
-	  };
+	SJac_h = Jac_h;
+	nlip_mult_rows(ZJac_h, z);
+	nlip_div_rows(SJac_h, s);
 	for(SizeType i = 0; i < K; ++i)
           muSES_inv(i,i) = mu / (z[i] * s[i]);
 	
@@ -852,7 +946,7 @@ namespace detail {
 	l = lt;
         norm_star = norm_2(l);
 	
-	qp_G = H + transpose_view(SJac_h) * ZJac_h;
+	nlip_compute_qp_hessian(H, SJac_h, ZJac_h, qp_G);
 	
 	Err_value = ValueType(0.0);
 	for(SizeType i = 0; i < K; ++i) {
@@ -924,6 +1018,24 @@ namespace detail {
   };
   
   
+  template <typename Function, typename GradFunction, typename HessianFunction, 
+            typename Vector, typename EqFunction, typename EqJacFunction, 
+	    typename IneqFunction, typename IneqJacFunction>
+  void nl_intpoint_method_ls_impl(Function f, GradFunction df, HessianFunction fill_hessian,  
+				  EqFunction g, EqJacFunction fill_g_jac,
+				  IneqFunction h, IneqJacFunction fill_h_jac,
+				  Vector& x, 
+				  typename vect_traits<Vector>::value_type mu = typename vect_traits<Vector>::value_type(0.1), 
+				  unsigned int max_iter = 100,
+			          typename vect_traits<Vector>::value_type abs_tol = typename vect_traits<Vector>::value_type(1e-6), 
+				  typename vect_traits<Vector>::value_type kappa = typename vect_traits<Vector>::value_type(1e-4),
+				  typename vect_traits<Vector>::value_type tau = typename vect_traits<Vector>::value_type(0.995)) {
+    nl_intpoint_method_ls_impl(f, df, fill_hessian, g, fill_g_jac, h, fill_h_jac, 
+                               x, mu, max_iter, abs_tol, kappa, tau, 
+                               null_space_eqp_solver<typename vect_traits<Vector>::value_type>());
+  };
+  
+  
   
   
   
@@ -1562,10 +1674,14 @@ nlip_quasi_newton_tr_factory<Function,GradFunction,T>
  * \tparam EqJacFunction The functor type of the equality constraints jacobian function.
  * \tparam IneqFunction The functor type of the inequality constraints function (vector function).
  * \tparam IneqJacFunction The functor type of the inequality constraints jacobian function.
+ * \tparam EqQPSolver The policy type used to solve the equality-constrained QP sub-problems, which also 
+ *                    determines the matrix types of the Hessian and Jacobians (see null_space_eqp_solver and
+ *                    sparse_kkt_eqp_solver).
  */
 template <typename Function, typename GradFunction, typename HessianFunction, typename T,
           typename EqFunction = no_constraint_functor, typename EqJacFunction = no_constraint_jac_functor, 
-          typename IneqFunction = no_constraint_functor, typename IneqJacFunction = no_constraint_jac_functor>
+          typename IneqFunction = no_constraint_functor, typename IneqJacFunction = no_constraint_jac_functor,
+          typename EqQPSolver = null_space_eqp_solver<T> >
 struct nlip_newton_ls_factory {
   Function f;
   GradFunction df;
@@ -1579,9 +1695,10 @@ struct nlip_newton_ls_factory {
   EqJacFunction fill_g_jac;
   IneqFunction h;
   IneqJacFunction fill_h_jac;
+  EqQPSolver solve_eqp;
   
   typedef nlip_newton_ls_factory<Function,GradFunction,HessianFunction,T,
-                                 EqFunction,EqJacFunction,IneqFunction,IneqJacFunction> self;
+                                 EqFunction,EqJacFunction,IneqFunction,IneqJacFunction,EqQPSolver> self;
   
   /**
    * Parametrized constructor of the factory object.
@@ -1597,17 +1714,20 @@ struct nlip_newton_ls_factory {
    * \param aTol The tolerance on the norm of the gradient (and thus the step size).
    * \param aEta The tolerance on the sufficient decrease in order to accept a line-search step.
    * \param aTau The portion (close to 1.0) of a total step to do without coming too close to the inequality constraint (barrier).
+   * \param aSolveEQP The policy object used to solve the equality-constrained QP sub-problems.
    */
   nlip_newton_ls_factory(Function aF, GradFunction aDf, HessianFunction aFillHessian, 
 			 T aMu, unsigned int aMaxIter,
 			 EqFunction aG = EqFunction(), EqJacFunction aFillGJac = EqJacFunction(),
 			 IneqFunction aH = EqFunction(), IneqJacFunction aFillHJac = IneqJacFunction(),
-			 T aTol = T(1e-6), T aEta = T(1e-4), T aTau = T(0.995)) :
+			 T aTol = T(1e-6), T aEta = T(1e-4), T aTau = T(0.995),
+			 EqQPSolver aSolveEQP = EqQPSolver()) :
 			 f(aF), df(aDf), fill_hessian(aFillHessian),
 			 mu(aMu), max_iter(aMaxIter), 
 			 tol(aTol), eta(aEta), tau(aTau), 
 			 g(aG), fill_g_jac(aFillGJac), 
-			 h(aH), fill_h_jac(aFillHJac) { };
+			 h(aH), fill_h_jac(aFillHJac),
+			 solve_eqp(aSolveEQP) { };
   /**
    * This function finds the minimum of a function, given its derivative and Hessian, 
    * using a newton search direction and using a trust-region approach.
@@ -1619,7 +1739,7 @@ struct nlip_newton_ls_factory {
     detail::nl_intpoint_method_ls_impl(
       f, df, hessian_update_dual_exact<HessianFunction>(fill_hessian), 
       g, fill_g_jac, h, fill_h_jac,
-      x, mu, max_iter, tol,eta,tau);
+      x, mu, max_iter, tol,eta,tau,solve_eqp);
   };
   
   /**
@@ -1658,15 +1778,15 @@ struct nlip_newton_ls_factory {
   template <typename NewEqFunction, typename NewEqJacFunction>
   nlip_newton_ls_factory<Function,GradFunction,HessianFunction,T,
                          NewEqFunction, NewEqJacFunction,
-                         IneqFunction, IneqJacFunction>
+                         IneqFunction, IneqJacFunction, EqQPSolver>
     set_eq_constraints(NewEqFunction new_g, NewEqJacFunction new_fill_g_jac) const {
     return nlip_newton_ls_factory<Function,GradFunction,HessianFunction,T,
                                   NewEqFunction, NewEqJacFunction,
-                                  IneqFunction, IneqJacFunction>(f,df,fill_hessian,
-					                         mu, max_iter,
-								 new_g, new_fill_g_jac, 
-								 h, fill_h_jac, 
-								 tol, eta, tau);
+                                  IneqFunction, IneqJacFunction, EqQPSolver>(f,df,fill_hessian,
+					                                     mu, max_iter,
+								             new_g, new_fill_g_jac, 
+								             h, fill_h_jac, 
+								             tol, eta, tau, solve_eqp);
   };
     
   /**
@@ -1680,15 +1800,37 @@ struct nlip_newton_ls_factory {
   template <typename NewIneqFunction, typename NewIneqJacFunction>
   nlip_newton_ls_factory<Function,GradFunction,HessianFunction,T,
                          EqFunction, EqJacFunction,
-                         NewIneqFunction, NewIneqJacFunction>
+                         NewIneqFunction, NewIneqJacFunction, EqQPSolver>
     set_ineq_constraints(NewIneqFunction new_h, NewIneqJacFunction new_fill_h_jac) const {
     return nlip_newton_ls_factory<Function,GradFunction,HessianFunction,T,
                                   EqFunction, EqJacFunction,
-                                  NewIneqFunction, NewIneqJacFunction>(f,df,fill_hessian,
-					                               mu, max_iter,
-								       g, fill_g_jac, 
-								       new_h, new_fill_h_jac, 
-								       tol, eta, tau);
+                                  NewIneqFunction, NewIneqJacFunction, EqQPSolver>(f,df,fill_hessian,
+					                                           mu, max_iter,
+								                   g, fill_g_jac, 
+								                   new_h, new_fill_h_jac, 
+								                   tol, eta, tau, solve_eqp);
+  };
+    
+  /**
+   * This function remaps the factory to one which will use the given policy to solve the 
+   * equality-constrained QP sub-problems, and thus, the matrix types of the Hessian and constraint 
+   * Jacobians that the policy requires (e.g., sparse_kkt_eqp_solver for sparse matrices, in which 
+   * case the Hessian and Jacobian functors must fill mat_sparse matrices).
+   * \tparam NewEqQPSolver The policy type used to solve the equality-constrained QP sub-problems.
+   * \param new_solve_eqp The policy object used to solve the equality-constrained QP sub-problems.
+   */
+  template <typename NewEqQPSolver>
+  nlip_newton_ls_factory<Function,GradFunction,HessianFunction,T,
+                         EqFunction, EqJacFunction,
+                         IneqFunction, IneqJacFunction, NewEqQPSolver>
+    set_eqp_solver(NewEqQPSolver new_solve_eqp) const {
+    return nlip_newton_ls_factory<Function,GradFunction,HessianFunction,T,
+                                  EqFunction, EqJacFunction,
+                                  IneqFunction, IneqJacFunction, NewEqQPSolver>(f,df,fill_hessian,
+					                                        mu, max_iter,
+								                g, fill_g_jac, 
+								                h, fill_h_jac, 
+								                tol, eta, tau, new_solve_eqp);
   };
     
 };
@@ -40,6 +40,7 @@
 #include "lin_alg/mat_alg.hpp"
 #include "lin_alg/mat_qr_decomp.hpp"
 #include "lin_alg/mat_views.hpp"
+#include "lin_alg/mat_sparse_ldl.hpp"
 
 #include <vector>
 
@@ -371,6 +372,251 @@ void projected_CG_method(const Matrix1& A, const Vector1& b,
 
 
 
+/**
+ * This class is a policy type for the solution of the equality-constrained quadratic programs
+ * (EQP) that arise within the interior-point and SQP methods (see nl_interior_points_methods.hpp
+ * and sequential_qp_methods.hpp). This policy uses dense matrices for the Hessian and the constraint
+ * Jacobian, and uses the null-space method (see null_space_QP_method), reverting to the projected
+ * CG method (see projected_CG_method) if the reduced Hessian is singular.
+ * \tparam T The value-type of the matrices.
+ */
+template <typename T>
+struct null_space_eqp_solver {
+  typedef mat<T,mat_structure::rectangular> jacobian_type;
+  typedef mat<T,mat_structure::symmetric> hessian_type;
+  
+  /**
+   * Solves the problem: min c'x + 0.5 * x' G x, subject to A x = b.
+   * \param A The constraint matrix of dimension M*N.
+   * \param b The b vector of dimension M.
+   * \param G The G matrix of dimension NxN.
+   * \param c The cost vector of dimension N.
+   * \param x Stores, as output, the optimal vector.
+   * \param max_norm The maximum norm of the solution (used when the reduced Hessian is singular).
+   * \param max_iter The maximum number of iterations of the projected CG method.
+   * \param abs_tol The tolerance on the singularity of components of the matrices involved.
+   * \param cg_tol The tolerance of the projected CG method.
+   * \param lambda Stores, as output, the Lagrange multipliers (if not NULL).
+   */
+  template <typename Matrix1, typename Vector1, typename Matrix2, typename Vector2>
+  void operator()(const Matrix1& A, const Vector1& b, const Matrix2& G, const Vector2& c, Vector2& x,
+                  T max_norm, unsigned int max_iter, T abs_tol, T cg_tol, Vector1* lambda = NULL) const {
+    try {
+      null_space_QP_method(A, b, G, c, x, abs_tol, max_norm, lambda);
+    } catch(singularity_error&) {
+      try {
+        projected_CG_method(A, b, G, c, x, max_iter, cg_tol, lambda);
+      } catch(maximum_iteration&) { };
+    };
+  };
+};
+
+
+/**
+ * This class is a policy type for the solution of the equality-constrained quadratic programs
+ * (EQP) that arise within the interior-point and SQP methods (see nl_interior_points_methods.hpp
+ * and sequential_qp_methods.hpp). This policy uses sparse matrices (see mat_sparse) for the Hessian
+ * and the constraint Jacobian, and solves the KKT system: \n
+ * \n
+ *   [ G + dp I     A' ] [  x ]   [ -c ] \n
+ *   [    A     -dd I  ] [ -l ] = [  b ] \n
+ * \n
+ * with a sparse LDL decomposition (see sparse_LDL_decomposition). The primal regularization dp
+ * is increased until the factorization has the correct inertia (N positive and M negative pivots),
+ * which makes the step a descent direction even when G is not positive-definite on the null-space
+ * of A, and the small dual regularization dd makes the system quasi-definite even when A is rank
+ * deficient. The KKT matrix is assembled once per call, with all its diagonal entries stored, and
+ * only its diagonal values change with dp. The decompositions are shared by the copies of this object, 
+ * such that their symbolic analysis is re-used by all the iterations of a solver as long as the 
+ * sparsity patterns of the Hessian and Jacobian matrices do not change.
+ * \n
+ * When the solution is longer than the maximum norm, only its component in the null-space of A is
+ * scaled down, such that A x = b still holds. If the minimum-norm solution of A x = b (the normal 
+ * component) is already longer than the maximum norm, the normal component is returned as is.
+ * \n
+ * Note that the full sparsity patterns of the matrices (both triangles of G) should be filled, and
+ * that for the analysis to be re-used, the stored entries should not depend on the values (store
+ * zeros explicitly if needed). Dense matrices given to this policy are converted with all their 
+ * entries stored, for the same reason.
+ * \tparam T The value-type of the matrices.
+ */
+template <typename T>
+struct sparse_kkt_eqp_solver {
+  typedef mat_sparse<T> jacobian_type;
+  typedef mat_sparse<T> hessian_type;
+  
+  shared_ptr< sparse_LDL_decomposition<T> > ldl;
+  shared_ptr< sparse_LDL_decomposition<T> > ldl_normal;
+  T primal_reg;
+  T dual_reg;
+  
+  /**
+   * Default constructor.
+   * \param aPrimalReg The initial primal regularization applied when the inertia is not correct.
+   * \param aDualReg The dual regularization (applied to the constraint block).
+   */
+  explicit sparse_kkt_eqp_solver(T aPrimalReg = T(1e-4), T aDualReg = T(1e-8)) :
+                                 ldl(new sparse_LDL_decomposition<T>()),
+                                 ldl_normal(new sparse_LDL_decomposition<T>()),
+                                 primal_reg(aPrimalReg), dual_reg(aDualReg) { };
+  
+  /**
+   * Solves the problem: min c'x + 0.5 * x' G x, subject to A x = b.
+   * \param A The constraint matrix of dimension M*N.
+   * \param b The b vector of dimension M.
+   * \param G The G matrix of dimension NxN.
+   * \param c The cost vector of dimension N.
+   * \param x Stores, as output, the optimal vector.
+   * \param max_norm The maximum norm of the solution (the constraints A x = b are kept).
+   * \param max_iter Not used.
+   * \param abs_tol The tolerance on the singularity of the pivots (it is lowered below the dual 
+   *                regularization, whose pivots are legitimate).
+   * \param cg_tol Not used.
+   * \param lambda Stores, as output, the Lagrange multipliers (if not NULL).
+   * \throws singularity_error if the KKT system cannot be regularized to the correct inertia.
+   */
+  template <typename Matrix1, typename Vector1, typename Matrix2, typename Vector2>
+  void operator()(const Matrix1& A, const Vector1& b, const Matrix2& G, const Vector2& c, Vector2& x,
+                  T max_norm, unsigned int max_iter, T abs_tol, T cg_tol, Vector1* lambda = NULL) const {
+    mat_sparse<T> A_tmp, G_tmp;
+    solve_impl(to_sparse(A, A_tmp), b, to_sparse(G, G_tmp), c, x, max_norm, abs_tol, lambda);
+  };
+  
+  private:
+    typedef typename mat_sparse<T>::size_type size_type;
+    
+    static const mat_sparse<T>& to_sparse(const mat_sparse<T>& M, mat_sparse<T>&) { return M; };
+    
+    template <typename Matrix>
+    static const mat_sparse<T>& to_sparse(const Matrix& M, mat_sparse<T>& M_tmp) {
+      // a negative drop tolerance stores every entry, which keeps the pattern independent of the values.
+      M_tmp = mat_sparse<T>(M, T(-1.0));
+      return M_tmp;
+    };
+    
+    // assembles the upper-triangular part of the KKT matrix (without primal regularization), 
+    // and records the positions of the diagonal entries of the primal block.
+    static void assemble_kkt(const mat_sparse<T>& A, const mat_sparse<T>& G, T dd, 
+                             mat_sparse<T>& KKT, std::vector<size_type>& diag_pos) {
+      const size_type N = G.get_col_count();
+      const size_type M = A.get_row_count();
+      mat_sparse<T> At = transpose(A);
+      KKT = mat_sparse<T>(N + M, N + M);
+      KKT.reserve(G.get_nonzero_count() / 2 + At.get_nonzero_count() + N + M);
+      diag_pos.resize(N);
+      for(size_type j = 0; j < N; ++j) {
+        bool has_diag = false;
+        for(size_type p = G.get_col_pointers()[j]; p < G.get_col_pointers()[j+1]; ++p) {
+          size_type i = G.get_row_indices()[p];
+          if(i > j)
+            break;
+          if(i == j) {
+            diag_pos[j] = KKT.get_nonzero_count();
+            has_diag = true;
+          };
+          KKT.push_back(i, j, G.get_values()[p]);
+        };
+        if(!has_diag) {
+          diag_pos[j] = KKT.get_nonzero_count();
+          KKT.push_back(j, j, T(0.0));
+        };
+      };
+      for(size_type r = 0; r < M; ++r) {
+        for(size_type p = At.get_col_pointers()[r]; p < At.get_col_pointers()[r+1]; ++p)
+          KKT.push_back(At.get_row_indices()[p], N + r, At.get_values()[p]);
+        KKT.push_back(N + r, N + r, -dd);
+      };
+    };
+    
+    // computes the minimum-norm solution of A x = b, i.e., the normal component of the solution.
+    template <typename Vector1>
+    void solve_normal(const mat_sparse<T>& A, const Vector1& b, vect_n<T>& x_n, T pivot_tol) const {
+      const size_type N = A.get_col_count();
+      const size_type M = A.get_row_count();
+      mat_sparse<T> I_n = mat_sparse<T>(mat<T,mat_structure::identity>(N));
+      mat_sparse<T> KKT;
+      std::vector<size_type> diag_pos;
+      assemble_kkt(A, I_n, dual_reg, KKT, diag_pos);
+      ldl_normal->factorize(KKT, pivot_tol);
+      vect_n<T> sol(N + M, T(0.0));
+      for(size_type i = 0; i < M; ++i)
+        sol[N + i] = b[i];
+      ldl_normal->solve(sol, 2);
+      x_n.resize(N);
+      for(size_type i = 0; i < N; ++i)
+        x_n[i] = sol[i];
+    };
+    
+    template <typename Vector1, typename Vector2>
+    void solve_impl(const mat_sparse<T>& A, const Vector1& b, const mat_sparse<T>& G, const Vector2& c, Vector2& x,
+                    T max_norm, T abs_tol, Vector1* lambda) const {
+      using std::sqrt;
+      const size_type N = c.size();
+      const size_type M = b.size();
+      const T pivot_tol = (abs_tol < T(0.5) * dual_reg ? abs_tol : T(0.5) * dual_reg);
+      
+      mat_sparse<T> KKT;
+      std::vector<size_type> diag_pos;
+      assemble_kkt(A, G, dual_reg, KKT, diag_pos);
+      std::vector<T> G_diag(N);
+      for(size_type j = 0; j < N; ++j)
+        G_diag[j] = KKT.get_values()[diag_pos[j]];
+      
+      T dp(0.0);
+      while(true) {
+        for(size_type j = 0; j < N; ++j)
+          KKT.get_values()[diag_pos[j]] = G_diag[j] + dp;
+        try {
+          ldl->factorize(KKT, pivot_tol);
+          if((ldl->get_positive_pivot_count() == N) && (ldl->get_negative_pivot_count() == M))
+            break;
+        } catch(singularity_error&) { };
+        dp = (dp == T(0.0) ? primal_reg : T(10.0) * dp);
+        if(dp > T(1e20))
+          throw singularity_error("KKT");
+      };
+      
+      vect_n<T> sol(N + M);
+      for(size_type i = 0; i < N; ++i)
+        sol[i] = -c[i];
+      for(size_type i = 0; i < M; ++i)
+        sol[N + i] = b[i];
+      ldl->solve(sol, 2);
+      
+      T x_norm(0.0);
+      for(size_type i = 0; i < N; ++i) {
+        x[i] = sol[i];
+        x_norm += sol[i] * sol[i];
+      };
+      x_norm = sqrt(x_norm);
+      if(x_norm > max_norm) {
+        // x = x_n + x_t, with x_n in the range of A' and x_t in the null-space of A (orthogonal), 
+        // so, only x_t is scaled down to meet the maximum norm.
+        vect_n<T> x_n;
+        solve_normal(A, b, x_n, pivot_tol);
+        T xn_sqr(0.0), xt_sqr(0.0);
+        for(size_type i = 0; i < N; ++i) {
+          xn_sqr += x_n[i] * x_n[i];
+          xt_sqr += (x[i] - x_n[i]) * (x[i] - x_n[i]);
+        };
+        T s(0.0);
+        if((xn_sqr < max_norm * max_norm) && (xt_sqr > T(0.0)))
+          s = sqrt((max_norm * max_norm - xn_sqr) / xt_sqr);
+        if(s < T(1.0))
+          for(size_type i = 0; i < N; ++i)
+            x[i] = x_n[i] + s * (x[i] - x_n[i]);
+      };
+      
+      if(lambda) {
+        (*lambda) = b;
+        for(size_type i = 0; i < M; ++i)
+          (*lambda)[i] = -sol[N + i];
+      };
+    };
+};
+
+
+
 
 
 
@@ -60,19 +60,88 @@ namespace optim {
 namespace detail {
   
   
+  // unconstrained problems with a dense Hessian matrix are solved with the trust-region Newton method.
+  template <typename Function, typename GradFunction, typename HessianFunction, typename Vector, 
+	    typename TrustRegionSolver, typename LimitFunction, typename EqQPSolver>
+  void bosqp_unconstrained_newton_tr(Function f, GradFunction df, HessianFunction fill_hessian, Vector& x, 
+				     typename vect_traits<Vector>::value_type max_radius, unsigned int max_iter, 
+				     TrustRegionSolver solve_step, LimitFunction impose_limits, 
+				     typename vect_traits<Vector>::value_type abs_tol, 
+				     typename vect_traits<Vector>::value_type kappa,
+				     EqQPSolver, boost::mpl::true_) {
+    newton_method_tr_impl(f,df,fill_hessian,x,max_radius,max_iter,solve_step,impose_limits,abs_tol,abs_tol,kappa);
+  };
+  
+  // otherwise, the Newton step within the trust-region is obtained from the EQP solver (without constraints).
+  template <typename Function, typename GradFunction, typename HessianFunction, typename Vector, 
+	    typename TrustRegionSolver, typename LimitFunction, typename EqQPSolver>
+  void bosqp_unconstrained_newton_tr(Function f, GradFunction df, HessianFunction fill_hessian, Vector& x, 
+				     typename vect_traits<Vector>::value_type max_radius, unsigned int max_iter, 
+				     TrustRegionSolver, LimitFunction impose_limits, 
+				     typename vect_traits<Vector>::value_type abs_tol, 
+				     typename vect_traits<Vector>::value_type kappa,
+				     EqQPSolver solve_eqp, boost::mpl::false_) {
+    typedef typename vect_traits<Vector>::value_type ValueType;
+    
+    typename EqQPSolver::jacobian_type A(0, x.size());
+    Vector b = x; b.resize(0);
+    
+    ValueType radius = ValueType(0.5) * max_radius;
+    ValueType x_value = f(x);
+    Vector x_grad = df(x);
+    typename EqQPSolver::hessian_type H(mat<ValueType,mat_structure::identity>(x.size()));
+    fill_hessian(H,x,x_value,x_grad);
+    
+    Vector p = x_grad;
+    Vector xt = x;
+    unsigned int k = 0;
+    while(norm_2(x_grad) > abs_tol) {
+      solve_eqp(A, b, H, x_grad, p, radius, max_iter, abs_tol, abs_tol);
+      impose_limits(x,p);
+      xt = x; xt += p;
+      ValueType norm_p = norm_2(p);
+      ValueType xt_value = f(xt);
+      ValueType ratio = (x_value - xt_value) / (-(x_grad * p + ValueType(0.5) * (p * (H * p))));
+      if( ratio > ValueType(0.75) ) {
+        if(norm_p > ValueType(0.8) * radius) {
+          radius *= ValueType(2.0);
+          if(radius > max_radius)
+            radius = max_radius;
+        };
+      } else if( ratio < ValueType(0.1) ) {
+        radius *= ValueType(0.5);
+      };
+      if( ratio > kappa ) {  //the step is accepted.
+        x = xt;
+	if(norm_p < abs_tol)
+	  return;
+        Vector x_grad_prev = x_grad;
+        x_value = xt_value;
+        x_grad = df(x);
+        fill_hessian(H,x,x_value,x_grad,p,x_grad - x_grad_prev);
+      };
+      if(++k > max_iter)
+	throw maximum_iteration(max_iter);
+    };
+  };
+  
+  
   template <typename Function, typename GradFunction, typename HessianFunction, 
             typename Vector, typename EqFunction, typename EqJacFunction, 
-	    typename TrustRegionSolver, typename LimitFunction>
+	    typename TrustRegionSolver, typename LimitFunction, typename EqQPSolver>
   void byrd_omojokun_sqp_method_tr_impl(Function f, GradFunction df, HessianFunction fill_hessian,  
 				        EqFunction g, EqJacFunction fill_g_jac,
 				        Vector& x, typename vect_traits<Vector>::value_type max_radius,
 					unsigned int max_iter,
 			                TrustRegionSolver solve_step, LimitFunction impose_limits, 
-			                typename vect_traits<Vector>::value_type abs_tol = typename vect_traits<Vector>::value_type(1e-6), 
-				        typename vect_traits<Vector>::value_type kappa = typename vect_traits<Vector>::value_type(1e-4), 
-				        typename vect_traits<Vector>::value_type rho = typename vect_traits<Vector>::value_type(1e-4)) {
+			                typename vect_traits<Vector>::value_type abs_tol, 
+				        typename vect_traits<Vector>::value_type kappa, 
+				        typename vect_traits<Vector>::value_type rho,
+				        EqQPSolver solve_eqp) {
     typedef typename vect_traits<Vector>::value_type ValueType;
     typedef typename vect_traits<Vector>::size_type SizeType;
+    typedef typename EqQPSolver::jacobian_type JacobianMatrix;
+    typedef typename EqQPSolver::hessian_type HessianMatrix;
     using std::sqrt; using std::fabs;
     
     SizeType N = x.size();
@@ -80,12 +149,13 @@ namespace detail {
     Vector gt_value = g_value;
     SizeType M = g_value.size();
     
-    mat<ValueType, mat_structure::rectangular> Jac_g(M,N);
+    JacobianMatrix Jac_g(M,N);
     fill_g_jac(Jac_g,x,g_value);
-    mat_transpose_view< mat<ValueType, mat_structure::rectangular> > Jac_g_t = transpose_view(Jac_g);
+    mat_transpose_view< JacobianMatrix > Jac_g_t = transpose_view(Jac_g);
     
     if(M == 0) { //this means it is an unconstrained problem.
-      newton_method_tr_impl(f,df,fill_hessian,x,max_radius,max_iter,solve_step,impose_limits,abs_tol,abs_tol,kappa);
+      bosqp_unconstrained_newton_tr(f,df,fill_hessian,x,max_radius,max_iter,solve_step,impose_limits,abs_tol,kappa,solve_eqp,
+                                    boost::mpl::bool_< boost::is_same< HessianMatrix, mat<ValueType,mat_structure::symmetric> >::value >());
       return;
     };
     
@@ -105,7 +175,7 @@ namespace detail {
     ValueType norm_star = norm_2(lag);;
     
     
-    mat<ValueType,mat_structure::symmetric> H(mat<ValueType,mat_structure::identity>(x.size()));
+    HessianMatrix H(mat<ValueType,mat_structure::identity>(x.size()));
     fill_hessian(H,x,x_value,x_grad);
     
     Vector xt = x;
@@ -122,13 +192,7 @@ namespace detail {
       solve_step(g_value,Jac_g,v,norm_v,ValueType(0.8) * radius,abs_tol);
       r = g_value; r += Jac_g * v;
       
-      try {
-	null_space_QP_method(Jac_g, r - g_value, H, x_grad, p, abs_tol, radius);
-      } catch(singularity_error&) {
-	try {
-          projected_CG_method(Jac_g, r - g_value, H, x_grad, p, max_iter, abs_tol);
-	} catch(maximum_iteration&) { };
-      };
+      solve_eqp(Jac_g, r - g_value, H, x_grad, p, radius, max_iter, abs_tol, abs_tol);
       norm_p = norm_2(p);
       if(norm_p > radius) {
 	p *= radius / norm_p;
@@ -184,6 +248,23 @@ namespace detail {
   };
   
   
+  template <typename Function, typename GradFunction, typename HessianFunction, 
+            typename Vector, typename EqFunction, typename EqJacFunction, 
+	    typename TrustRegionSolver, typename LimitFunction>
+  void byrd_omojokun_sqp_method_tr_impl(Function f, GradFunction df, HessianFunction fill_hessian,  
+				        EqFunction g, EqJacFunction fill_g_jac,
+				        Vector& x, typename vect_traits<Vector>::value_type max_radius,
+					unsigned int max_iter,
+			                TrustRegionSolver solve_step, LimitFunction impose_limits, 
+			                typename vect_traits<Vector>::value_type abs_tol = typename vect_traits<Vector>::value_type(1e-6), 
+				        typename vect_traits<Vector>::value_type kappa = typename vect_traits<Vector>::value_type(1e-4), 
+				        typename vect_traits<Vector>::value_type rho = typename vect_traits<Vector>::value_type(1e-4)) {
+    byrd_omojokun_sqp_method_tr_impl(f, df, fill_hessian, g, fill_g_jac, x, max_radius, max_iter,
+                                     solve_step, impose_limits, abs_tol, kappa, rho,
+                                     null_space_eqp_solver<typename vect_traits<Vector>::value_type>());
+  };
+  
+  
   
 };
 
@@ -211,11 +292,15 @@ namespace detail {
  * \tparam EqJacFunction The functor type of the equality constraints jacobian function.
  * \tparam TrustRegionSolver A functor type that can solve for a solution step within a trust-region (see trust_region_solver_dogleg for an example).
  * \tparam LimitFunction A functor type that can impose limits on a proposed solution step (see no_limit_functor or box_limit_function for examples).
+ * \tparam EqQPSolver The policy type used to solve the equality-constrained QP sub-problems, which also 
+ *                    determines the matrix types of the Hessian and Jacobian (see null_space_eqp_solver and
+ *                    sparse_kkt_eqp_solver).
  */
 template <typename Function, typename GradFunction, typename HessianFunction, typename T,
           typename EqFunction = no_constraint_functor, typename EqJacFunction = no_constraint_jac_functor, 
 	  typename TrustRegionSolver = tr_solver_right_pinv_dogleg, 
-	  typename LimitFunction = no_limit_functor>
+	  typename LimitFunction = no_limit_functor,
+	  typename EqQPSolver = null_space_eqp_solver<T> >
 struct bosqp_newton_tr_factory {
   Function f;
   GradFunction df;
@@ -229,10 +314,11 @@ struct bosqp_newton_tr_factory {
   EqJacFunction fill_g_jac;
   TrustRegionSolver solve_step;
   LimitFunction impose_limits;
+  EqQPSolver solve_eqp;
   
   typedef bosqp_newton_tr_factory<Function,GradFunction,HessianFunction,T,
                                   EqFunction,EqJacFunction,
-				  TrustRegionSolver,LimitFunction> self;
+				  TrustRegionSolver,LimitFunction,EqQPSolver> self;
   
   /**
    * Parametrized constructor of the factory object.
@@ -248,18 +334,21 @@ struct bosqp_newton_tr_factory {
    * \param aRho The margin on the sufficient decrease of a step in the trust region.
    * \param aSolveStep The functor that can solve for the step to take within the trust-region.
    * \param aImposeLimits The functor that can impose simple limits on the search domain (e.g. box-constraints or non-negativity).
+   * \param aSolveEQP The policy object used to solve the equality-constrained QP sub-problems.
    */
   bosqp_newton_tr_factory(Function aF, GradFunction aDf,
 			  HessianFunction aFillHessian, T aMaxRadius, unsigned int aMaxIter,
 			  EqFunction aG = EqFunction(), EqJacFunction aFillGJac = EqJacFunction(),
 			  T aTol = T(1e-6), T aEta = T(1e-4), T aRho = T(1e-4),
 			  TrustRegionSolver aSolveStep = TrustRegionSolver(),
-			  LimitFunction aImposeLimits = LimitFunction()) :
+			  LimitFunction aImposeLimits = LimitFunction(),
+			  EqQPSolver aSolveEQP = EqQPSolver()) :
 			  f(aF), df(aDf), fill_hessian(aFillHessian),
 			  max_radius(aMaxRadius), max_iter(aMaxIter), tol(aTol), eta(aEta), rho(aRho),
 			  g(aG), fill_g_jac(aFillGJac), 
 			  solve_step(aSolveStep),
-			  impose_limits(aImposeLimits) { };
+			  impose_limits(aImposeLimits),
+			  solve_eqp(aSolveEQP) { };
   /**
    * This function finds the minimum of a function, given its derivative and Hessian, 
    * using a newton search direction and using a trust-region approach.
@@ -271,7 +360,7 @@ struct bosqp_newton_tr_factory {
     detail::byrd_omojokun_sqp_method_tr_impl(
       f, df, hessian_update_dual_exact<HessianFunction>(fill_hessian), g, fill_g_jac, 
       x, max_radius, max_iter, solve_step,
-      impose_limits,tol,eta,rho);
+      impose_limits,tol,eta,rho,solve_eqp);
   };
   
   /**
@@ -302,16 +391,16 @@ struct bosqp_newton_tr_factory {
    */
   bosqp_newton_tr_factory<Function,GradFunction,HessianFunction,T,
                           EqFunction, EqJacFunction, 
-                          tr_solver_right_pinv_dogleg_reg<T>, LimitFunction>
+                          tr_solver_right_pinv_dogleg_reg<T>, LimitFunction, EqQPSolver>
     regularize(const T& tau) const {
     return bosqp_newton_tr_factory<Function,GradFunction,HessianFunction,T,
                                    EqFunction, EqJacFunction, 
-                                   tr_solver_right_pinv_dogleg_reg<T>, LimitFunction>(f,df,fill_hessian,
+                                   tr_solver_right_pinv_dogleg_reg<T>, LimitFunction, EqQPSolver>(f,df,fill_hessian,
 					                                              max_radius, max_iter,
 										      g, fill_g_jac, 
 										      tol, eta, rho,
 										      tr_solver_right_pinv_dogleg_reg<T>(tau),
-										      impose_limits);
+										      impose_limits, solve_eqp);
   };
     
   /**
@@ -322,15 +411,15 @@ struct bosqp_newton_tr_factory {
   template <typename NewTrustRegionSolver>
   bosqp_newton_tr_factory<Function,GradFunction,HessianFunction,T,
                                EqFunction, EqJacFunction, 
-                               NewTrustRegionSolver, LimitFunction>
+                               NewTrustRegionSolver, LimitFunction, EqQPSolver>
     set_tr_solver(NewTrustRegionSolver new_solver) const {
     return bosqp_newton_tr_factory<Function,GradFunction,HessianFunction,T,
                                    EqFunction, EqJacFunction, 
-                                   NewTrustRegionSolver, LimitFunction>(f,df,fill_hessian,
+                                   NewTrustRegionSolver, LimitFunction, EqQPSolver>(f,df,fill_hessian,
 					                                max_radius, max_iter,
 								        g, fill_g_jac, 
 								        tol, eta, rho,
-								        new_solver,impose_limits);
+								        new_solver,impose_limits,solve_eqp);
   };
     
   /**
@@ -344,15 +433,15 @@ struct bosqp_newton_tr_factory {
   template <typename NewLimitFunction>
   bosqp_newton_tr_factory<Function,GradFunction,HessianFunction,T,
                                EqFunction, EqJacFunction,
-                               TrustRegionSolver, NewLimitFunction>
+                               TrustRegionSolver, NewLimitFunction, EqQPSolver>
     set_limiter(NewLimitFunction new_limits) const {
     return bosqp_newton_tr_factory<Function,GradFunction,HessianFunction,T,
                                    EqFunction, EqJacFunction,
-                                   TrustRegionSolver, NewLimitFunction>(f,df,fill_hessian,
+                                   TrustRegionSolver, NewLimitFunction, EqQPSolver>(f,df,fill_hessian,
 					                                max_radius, max_iter,
 								        g, fill_g_jac, 
 								        tol, eta, rho,
-								        solve_step,new_limits);
+								        solve_step,new_limits,solve_eqp);
   };
     
   /**
@@ -366,15 +455,37 @@ struct bosqp_newton_tr_factory {
   template <typename NewEqFunction, typename NewEqJacFunction>
   bosqp_newton_tr_factory<Function,GradFunction,HessianFunction,T,
                           NewEqFunction, NewEqJacFunction,
-                          TrustRegionSolver, LimitFunction>
+                          TrustRegionSolver, LimitFunction, EqQPSolver>
     set_eq_constraints(NewEqFunction new_g, NewEqJacFunction new_fill_g_jac) const {
     return bosqp_newton_tr_factory<Function,GradFunction,HessianFunction,T,
                                    NewEqFunction, NewEqJacFunction,
-                                   TrustRegionSolver, LimitFunction>(f,df,fill_hessian,
-					                             max_radius, max_iter,
-								     new_g, new_fill_g_jac, 
-								     tol, eta, rho,
-								     solve_step,impose_limits);
+                                   TrustRegionSolver, LimitFunction, EqQPSolver>(f,df,fill_hessian,
+					                                         max_radius, max_iter,
+								                 new_g, new_fill_g_jac, 
+								                 tol, eta, rho,
+								                 solve_step,impose_limits,solve_eqp);
+  };
+    
+  /**
+   * This function remaps the factory to one which will use the given policy to solve the 
+   * equality-constrained QP sub-problems, and thus, the matrix types of the Hessian and constraint 
+   * Jacobian that the policy requires (e.g., sparse_kkt_eqp_solver for sparse matrices, in which 
+   * case the Hessian and Jacobian functors must fill mat_sparse matrices).
+   * \tparam NewEqQPSolver The policy type used to solve the equality-constrained QP sub-problems.
+   * \param new_solve_eqp The policy object used to solve the equality-constrained QP sub-problems.
+   */
+  template <typename NewEqQPSolver>
+  bosqp_newton_tr_factory<Function,GradFunction,HessianFunction,T,
+                          EqFunction, EqJacFunction,
+                          TrustRegionSolver, LimitFunction, NewEqQPSolver>
+    set_eqp_solver(NewEqQPSolver new_solve_eqp) const {
+    return bosqp_newton_tr_factory<Function,GradFunction,HessianFunction,T,
+                                   EqFunction, EqJacFunction,
+                                   TrustRegionSolver, LimitFunction, NewEqQPSolver>(f,df,fill_hessian,
+					                                            max_radius, max_iter,
+								                    g, fill_g_jac, 
+								                    tol, eta, rho,
+								                    solve_step,impose_limits,new_solve_eqp);
   };
     
 };
@@ -29,6 +29,8 @@
 #include "conjugate_gradient_methods.hpp"
 #include "nelder_mead_method.hpp"
 #include "quasi_newton_methods.hpp"
+#include "lbfgs_methods.hpp"
+#include "truncated_newton_methods.hpp"
 #include "trust_region_search.hpp"
 
 #include "path_planning/global_rng.hpp"
@@ -57,6 +59,11 @@ ReaK::vect<double,2> banana_function_grad(const ReaK::vect<double,2>& x) {
                               200.0 * (x[1] - x[0] * x[0]));
 };
 
+ReaK::vect<double,2> banana_function_hess_vect(const ReaK::vect<double,2>& x, const ReaK::vect<double,2>&, const ReaK::vect<double,2>& v) {
+  return ReaK::vect<double,2>((2.0 - 400.0 * x[1] + 1200.0 * x[0] * x[0]) * v[0] - 400.0 * x[0] * v[1],
+                              -400.0 * x[0] * v[0] + 200.0 * v[1]);
+};
+
 double easy_function(const ReaK::vect<double,2>& x) {
   evalCount++;
   static ReaK::mat<double,ReaK::mat_structure::symmetric> Q(10.0, -2.0, 1.0);
@@ -208,6 +215,39 @@ int main() {
   
   
   
+  evalCount = 0;
+  gradCount = 0;
+  x_2D = ReaK::vect<double,2>(0.5,1.0);
+  std::cout << "  L-BFGS method started at " << x_2D << std::endl;
+  ReaK::optim::make_lbfgs_method_ls(banana_function,banana_function_grad, 5, 100, 1e-7, 1e-7)(x_2D);
+  std::cout << "    found optimum: " << x_2D << " after " << evalCount << " function evaluations and " << gradCount << " gradient evaluations." << std::endl;
+  std::cout << "    function gives: " << banana_function(x_2D) << " gradient gives: " << banana_function_grad(x_2D) << std::endl;
+  
+  evalCount = 0;
+  gradCount = 0;
+  x_2D = ReaK::vect<double,2>(0.5,1.0);
+  std::cout << "  L-BFGS trust-region method started at " << x_2D << std::endl;
+  ReaK::optim::make_lbfgs_method_tr(banana_function,banana_function_grad, 5, 0.5, 100, 1e-7, 1e-7)(x_2D);
+  std::cout << "    found optimum: " << x_2D << " after " << evalCount << " function evaluations and " << gradCount << " gradient evaluations." << std::endl;
+  std::cout << "    function gives: " << banana_function(x_2D) << " gradient gives: " << banana_function_grad(x_2D) << std::endl;
+  
+  evalCount = 0;
+  gradCount = 0;
+  x_2D = ReaK::vect<double,2>(0.5,1.0);
+  std::cout << "  Newton-CG method started at " << x_2D << std::endl;
+  ReaK::optim::make_newton_cg_ls(banana_function,banana_function_grad, banana_function_hess_vect, 100, 1e-7, 1e-7)(x_2D);
+  std::cout << "    found optimum: " << x_2D << " after " << evalCount << " function evaluations and " << gradCount << " gradient evaluations." << std::endl;
+  std::cout << "    function gives: " << banana_function(x_2D) << " gradient gives: " << banana_function_grad(x_2D) << std::endl;
+  
+  evalCount = 0;
+  gradCount = 0;
+  x_2D = ReaK::vect<double,2>(0.5,1.0);
+  std::cout << "  Newton-CG trust-region method started at " << x_2D << std::endl;
+  ReaK::optim::make_newton_cg_tr(banana_function,banana_function_grad, banana_function_hess_vect, 0.5, 100, 1e-7, 1e-7)(x_2D);
+  std::cout << "    found optimum: " << x_2D << " after " << evalCount << " function evaluations and " << gradCount << " gradient evaluations." << std::endl;
+  std::cout << "    function gives: " << banana_function(x_2D) << " gradient gives: " << banana_function_grad(x_2D) << std::endl;
+  
+  
   std::cout << std::endl << std::endl;
   std::cout << "Testing optimization methods on the Easy Function (optimum at (0,0), with value 0.0)" << std::endl;
   
@@ -296,7 +336,23 @@ int main() {
   std::cout << "    found optimum: " << x_2D << " after " << evalCount << " function evaluations and " << gradCount << " gradient evaluations." << std::endl;
   std::cout << "    function gives: " << easy_function(x_2D) << " gradient gives: " << easy_function_grad(x_2D) << std::endl;
   
+  evalCount = 0;
+  gradCount = 0;
+  x_2D = ReaK::vect<double,2>(0.5,1.0);
+  std::cout << "  L-BFGS method started at " << x_2D << std::endl;
+  ReaK::optim::make_lbfgs_method_ls(easy_function,easy_function_grad, 5, 100, 1e-7, 1e-7)(x_2D);
+  std::cout << "    found optimum: " << x_2D << " after " << evalCount << " function evaluations and " << gradCount << " gradient evaluations." << std::endl;
+  std::cout << "    function gives: " << easy_function(x_2D) << " gradient gives: " << easy_function_grad(x_2D) << std::endl;
+  
+  evalCount = 0;
+  gradCount = 0;
+  x_2D = ReaK::vect<double,2>(0.5,1.0);
+  std::cout << "  Newton-CG method (finite-difference Hessian-vector products) started at " << x_2D << std::endl;
+  ReaK::optim::make_newton_cg_ls(easy_function,easy_function_grad, ReaK::optim::finite_diff_hess_vect_prod< ReaK::vect<double,2> (*)(const ReaK::vect<double,2>&) >(easy_function_grad), 100, 1e-7, 1e-7)(x_2D);
+  std::cout << "    found optimum: " << x_2D << " after " << evalCount << " function evaluations and " << gradCount << " gradient evaluations." << std::endl;
+  std::cout << "    function gives: " << easy_function(x_2D) << " gradient gives: " << easy_function_grad(x_2D) << std::endl;
   
+ 
   evalCount = 0;
   gradCount = 0;
   x_2D = ReaK::vect<double,2>(0.5,1.0);
@@ -0,0 +1,502 @@
+/**
+ * \file truncated_newton_methods.hpp
+ *
+ * The following library provides truncated Newton methods (or Newton-CG methods) to perform
+ * non-linear optimization of large problems. These methods never form the Hessian matrix of the
+ * function, they only require products of the Hessian with vectors (which can be provided
+ * analytically or approximated by finite differences of the gradient, see finite_diff_hess_vect_prod).
+ * The Newton step is solved inexactly by conjugate-gradient iterations, which are truncated when
+ * the residual is small enough (relative to the gradient) or when negative curvature is encountered.
+ * Both a line-search and a trust-region (Steihaug-CG, see trust_region_solver_steihaug_cg) version
+ * of the method are provided.
+ *
+ * \author Sven Mikael Persson <mikael.s.persson@gmail.com>
+ * \date June 2013
+ */
+
+/*
+ *    Copyright 2013 Sven Mikael Persson
+ *
+ *    THIS SOFTWARE IS DISTRIBUTED UNDER THE TERMS OF THE GNU GENERAL PUBLIC LICENSE v3 (GPLv3).
+ *
+ *    This file is part of ReaK.
+ *
+ *    ReaK is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    (at your option) any later version.
+ *
+ *    ReaK is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with ReaK (as LICENSE in the root folder).
+ *    If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef REAK_TRUNCATED_NEWTON_METHODS_HPP
+#define REAK_TRUNCATED_NEWTON_METHODS_HPP
+
+#include "base/defs.hpp"
+
+#include "lin_alg/vect_alg.hpp"
+#include "lin_alg/mat_num_exceptions.hpp"
+
+#include "trust_region_search.hpp"
+#include "line_search.hpp"
+#include "limit_functions.hpp"
+#include "lbfgs_methods.hpp"
+
+#include <vector>
+
+
+namespace ReaK {
+
+
+namespace optim {
+
+
+/**
+ * This functor class approximates the product of the Hessian of a function with a vector by
+ * a forward finite-difference of its gradient, i.e., H * v = (df(x + h * v) - df(x)) / h.
+ * \tparam GradFunction The functor type of the gradient of the function.
+ * \tparam T The value-type.
+ */
+template <typename GradFunction, typename T = double>
+struct finite_diff_hess_vect_prod {
+  GradFunction df;
+  T rel_step;
+
+  /**
+   * Parametrized constructor.
+   * \param aDf The gradient of the function.
+   * \param aRelStep The relative finite-difference step size (scaled by the norms of x and v).
+   */
+  finite_diff_hess_vect_prod(GradFunction aDf, T aRelStep = T(1e-7)) : df(aDf), rel_step(aRelStep) { };
+
+  /**
+   * Computes the product of the Hessian of the function with a vector.
+   * \tparam Vector The vector type of the independent variable for the function.
+   * \param x The point at which the Hessian is evaluated.
+   * \param x_grad The gradient of the function at x.
+   * \param v The vector to multiply with the Hessian.
+   * \return The Hessian-vector product.
+   */
+  template <typename Vector>
+  Vector operator()(const Vector& x, const Vector& x_grad, const Vector& v) const {
+    using std::sqrt;
+    T norm_v = norm_2(v);
+    if(norm_v == T(0.0))
+      return v;
+    T h = rel_step * (T(1.0) + norm_2(x)) / norm_v;
+    Vector result = df(x + h * v);
+    result -= x_grad;
+    result *= T(1.0) / h;
+    return result;
+  };
+};
+
+
+namespace detail {
+
+
+  /**
+   * This class wraps a Hessian-vector product functor, evaluated at a given point, into an
+   * implicit matrix object (which only provides a product with a vector), for use within
+   * the trust-region solvers that require only Hessian-vector products.
+   */
+  template <typename HessVectFunction, typename Vector>
+  struct hess_vect_operator {
+    typedef hess_vect_operator<HessVectFunction,Vector> self;
+
+    const HessVectFunction* hess_vect;
+    const Vector* x;
+    const Vector* x_grad;
+
+    hess_vect_operator(const HessVectFunction& aHessVect, const Vector& aX, const Vector& aXGrad) :
+                       hess_vect(&aHessVect), x(&aX), x_grad(&aXGrad) { };
+
+    friend Vector operator *(const self& H, const Vector& v) {
+      return (*H.hess_vect)(*H.x, *H.x_grad, v);
+    };
+  };
+
+
+  /**
+   * This function computes an inexact Newton direction over the free variables by truncated
+   * conjugate-gradient iterations. The iterations stop when the residual falls below the
+   * forcing term, min(0.5, sqrt(|g|)) * |g|, or when negative curvature is encountered.
+   */
+  template <typename HessVectFunction, typename Vector>
+  void newton_cg_compute_direction(const HessVectFunction& hess_vect, const Vector& x, const Vector& x_grad,
+                                   const std::vector<bool>& active, Vector& p, unsigned int max_cg_iter,
+                                   typename vect_traits<Vector>::value_type abs_tol) {
+    typedef typename vect_traits<Vector>::value_type ValueType;
+    using std::sqrt;
+
+    Vector r = x_grad;
+    lbfgs_zero_active(r, active);
+    ValueType norm_g = norm_2(r);
+    ValueType eps = (sqrt(norm_g) < ValueType(0.5) ? sqrt(norm_g) : ValueType(0.5)) * norm_g;
+    p = r; p *= ValueType(0.0);
+    Vector d = -r;
+    ValueType rr = r * r;
+    for(unsigned int j = 0; j < max_cg_iter; ++j) {
+      Vector Hd = hess_vect(x, x_grad, d);
+      lbfgs_zero_active(Hd, active);
+      ValueType dHd = d * Hd;
+      if(dHd <= abs_tol * (d * d)) {
+        // negative curvature: use the current iterate (or steepest-descent at first iteration).
+        if(j == 0)
+          p = d;
+        return;
+      };
+      ValueType alpha = rr / dHd;
+      p += alpha * d;
+      r += alpha * Hd;
+      ValueType rr_n = r * r;
+      if(sqrt(rr_n) < eps)
+        return;
+      d *= rr_n / rr;
+      d -= r;
+      rr = rr_n;
+    };
+  };
+
+
+  template <typename Function, typename GradFunction, typename HessVectFunction, typename Vector,
+            typename LineSearcher, typename LimitFunction>
+  void newton_cg_method_ls_impl(Function f, GradFunction df, HessVectFunction hess_vect, Vector& x,
+                                unsigned int max_iter, unsigned int max_cg_iter,
+                                LineSearcher get_alpha, LimitFunction impose_limits,
+                                typename vect_traits<Vector>::value_type abs_tol,
+                                typename vect_traits<Vector>::value_type abs_grad_tol) {
+    typedef typename vect_traits<Vector>::value_type ValueType;
+    using std::fabs;
+
+    std::vector<bool> active;
+    ValueType x_value = f(x);
+    Vector x_grad = df(x);
+    Vector p = x_grad;
+
+    unsigned int k = 0;
+    while(true) {
+      ValueType norm_pg = lbfgs_projected_grad_norm(x, x_grad, impose_limits);
+      if(norm_pg < abs_grad_tol)
+        return;
+      lbfgs_find_active_set(x, x_grad, impose_limits, (norm_pg < ValueType(1e-3) ? norm_pg : ValueType(1e-3)), active);
+      newton_cg_compute_direction(hess_vect, x, x_grad, active, p, max_cg_iter, abs_tol);
+
+      // check Wolfe for alpha 1.0
+      ValueType alpha = ValueType(1.0);
+      ValueType pxg = -(p * x_grad);
+      if((f(x + p) > x_value - ValueType(1e-4) * pxg) || (fabs(p * df(x + p)) > ValueType(0.9) * fabs(pxg)))
+        alpha = get_alpha(f,df,ValueType(0.0),ValueType(2.0),x,p,abs_tol);
+      p *= alpha;
+      impose_limits(x,p);
+      if(norm_2(p) < abs_tol)
+        return;
+      x += p;
+
+      if(++k > max_iter)
+        throw maximum_iteration(max_iter);
+
+      x_value = f(x);
+      x_grad = df(x);
+    };
+  };
+
+
+  template <typename Function, typename GradFunction, typename HessVectFunction, typename Vector,
+            typename TrustRegionSolver, typename LimitFunction>
+  void newton_cg_method_tr_impl(Function f, GradFunction df, HessVectFunction hess_vect, Vector& x,
+                                typename vect_traits<Vector>::value_type max_radius, unsigned int max_iter,
+                                TrustRegionSolver solve_step, LimitFunction impose_limits,
+                                typename vect_traits<Vector>::value_type abs_tol,
+                                typename vect_traits<Vector>::value_type abs_grad_tol,
+                                typename vect_traits<Vector>::value_type eta) {
+    typedef typename vect_traits<Vector>::value_type ValueType;
+
+    ValueType radius = ValueType(0.5) * max_radius;
+    ValueType x_value = f(x);
+    Vector x_grad = df(x);
+    Vector p = x_grad;
+    ValueType norm_p = ValueType(0.0);
+
+    unsigned int k = 0;
+    while(true) {
+      if(lbfgs_projected_grad_norm(x, x_grad, impose_limits) < abs_grad_tol)
+        return;
+      hess_vect_operator<HessVectFunction,Vector> H(hess_vect, x, x_grad);
+      solve_step(x_grad,H,p,norm_p,radius,abs_tol);
+      impose_limits(x,p);
+      norm_p = norm_2(p);
+      if(norm_p < abs_tol)
+        return;
+      Vector xt = x; xt += p;
+      ValueType xt_value = f(xt);
+      ValueType aredux = x_value - xt_value;
+      ValueType predux = -(x_grad * p + ValueType(0.5) * (p * (H * p)));
+
+      ValueType ratio = aredux / predux;
+      if( ratio > ValueType(0.75) ) {
+        if(norm_p > ValueType(0.8) * radius) {
+          radius *= ValueType(2.0);
+          if(radius > max_radius)
+            radius = max_radius;
+        };
+      } else if( ratio < ValueType(0.1) ) {
+        radius *= ValueType(0.5);
+      };
+      if( ratio > eta ) {
+        x = xt;
+        x_value = xt_value;
+        x_grad = df(x);
+      };
+
+      if(++k > max_iter)
+        throw maximum_iteration(max_iter);
+    };
+  };
+
+
+};
+
+
+
+
+/**
+ * This functor is a factory class to construct a truncated Newton (Newton-CG) optimizer routine
+ * that uses a line-search approach. The Hessian-vector product functor is called as
+ * hess_vect(x, x_grad, v) and returns the product of the Hessian at x with v (see
+ * finite_diff_hess_vect_prod for an approximation from the gradient function).
+ * Use make_newton_cg_ls to construct this without having to specify the template arguments explicitly.
+ * \test Must create a unit-test for this.
+ * \tparam Function The functor type of the function to optimize.
+ * \tparam GradFunction The functor type of the gradient of the function to optimize.
+ * \tparam HessVectFunction The functor type of the Hessian-vector product of the function to optimize.
+ * \tparam T The value-type of the field on which the optimization is performed.
+ * \tparam LimitFunction A functor type that can impose limits on a proposed solution step (see no_limit_functor or box_limit_function for examples).
+ * \tparam LineSearcher A functor type that can perform a line-search which satisfy the strong Wolfe conditions (see line_search_expand_and_zoom).
+ */
+template <typename Function, typename GradFunction, typename HessVectFunction, typename T,
+          typename LimitFunction = no_limit_functor,
+          typename LineSearcher = line_search_expand_and_zoom<T> >
+struct newton_cg_ls_factory {
+  Function f;
+  GradFunction df;
+  HessVectFunction hess_vect;
+  unsigned int max_iter;
+  unsigned int max_cg_iter;
+  T abs_tol;
+  T abs_grad_tol;
+  LimitFunction impose_limits;
+  LineSearcher get_alpha;
+
+  /**
+   * Parametrized constructor of the factory object.
+   * \param aF The function to minimize.
+   * \param aDf The gradient of the function to minimize.
+   * \param aHessVect The functor that can compute the Hessian-vector products of the function to minimize.
+   * \param aMaxIter The maximum number of iterations to perform.
+   * \param aMaxCGIter The maximum number of conjugate-gradient iterations per Newton step.
+   * \param aTol The tolerance on the norm of step size.
+   * \param aGradTol The tolerance on the norm of the (projected) gradient.
+   * \param aImposeLimits The functor that can impose simple limits on the search domain.
+   * \param aGetAlpha The functor that can perform a line-search.
+   */
+  newton_cg_ls_factory(Function aF, GradFunction aDf, HessVectFunction aHessVect,
+                       unsigned int aMaxIter = 100, unsigned int aMaxCGIter = 100,
+                       T aTol = T(1e-6), T aGradTol = T(1e-6),
+                       LimitFunction aImposeLimits = LimitFunction(),
+                       LineSearcher aGetAlpha = LineSearcher(1e-4,0.9)) :
+                       f(aF), df(aDf), hess_vect(aHessVect),
+                       max_iter(aMaxIter), max_cg_iter(aMaxCGIter),
+                       abs_tol(aTol), abs_grad_tol(aGradTol),
+                       impose_limits(aImposeLimits), get_alpha(aGetAlpha) { };
+
+  /**
+   * This function finds the minimum of a function, given its derivative and Hessian-vector
+   * products, using a truncated Newton search direction and using a line-search approach.
+   * \tparam Vector The vector type of the independent variable for the function.
+   * \param x The initial guess to the solution, as well as a storage for the result of the algorihm.
+   */
+  template <typename Vector>
+  void operator()(Vector& x) const {
+    detail::newton_cg_method_ls_impl(f,df,hess_vect,x,max_iter,max_cg_iter,get_alpha,impose_limits,abs_tol,abs_grad_tol);
+  };
+
+  /**
+   * This function remaps the factory to one which will use the given limit-function for the search domain.
+   * \tparam NewLimitFunction A new functor type that can impose limits on a proposed solution step (see no_limit_functor or box_limit_function for examples).
+   * \param new_limits The functor that can impose simple limits on the search domain.
+   */
+  template <typename NewLimitFunction>
+  newton_cg_ls_factory<Function,GradFunction,HessVectFunction,T,NewLimitFunction,LineSearcher>
+    set_limiter(NewLimitFunction new_limits) const {
+    return newton_cg_ls_factory<Function,GradFunction,HessVectFunction,T,NewLimitFunction,LineSearcher>(
+      f,df,hess_vect,max_iter,max_cg_iter,abs_tol,abs_grad_tol,new_limits,get_alpha);
+  };
+
+  /**
+   * This function remaps the factory to one which will use the given line-search method.
+   * \tparam NewLineSearcher A functor type that can perform a line-search (see line_search_expand_and_zoom).
+   * \param new_line_searcher The functor that can perform a line-search.
+   */
+  template <typename NewLineSearcher>
+  newton_cg_ls_factory<Function,GradFunction,HessVectFunction,T,LimitFunction,NewLineSearcher>
+    set_line_searcher(NewLineSearcher new_line_searcher) const {
+    return newton_cg_ls_factory<Function,GradFunction,HessVectFunction,T,LimitFunction,NewLineSearcher>(
+      f,df,hess_vect,max_iter,max_cg_iter,abs_tol,abs_grad_tol,impose_limits,new_line_searcher);
+  };
+
+};
+
+/**
+ * This function template creates a factory object to construct a truncated Newton (Newton-CG)
+ * optimizer routine that uses a line-search approach.
+ * \test Must create a unit-test for this.
+ * \tparam Function The functor type of the function to optimize.
+ * \tparam GradFunction The functor type of the gradient of the function to optimize.
+ * \tparam HessVectFunction The functor type of the Hessian-vector product of the function to optimize.
+ * \param f The function to minimize.
+ * \param df The gradient of the function to minimize.
+ * \param hess_vect The functor that can compute the Hessian-vector products, called as hess_vect(x, x_grad, v).
+ * \param max_iter The maximum number of iterations to perform.
+ * \param abs_tol The tolerance on the norm of the step size.
+ * \param abs_grad_tol The tolerance on the norm of the gradient.
+ */
+template <typename Function, typename GradFunction, typename HessVectFunction>
+newton_cg_ls_factory<Function,GradFunction,HessVectFunction,double>
+  make_newton_cg_ls(Function f, GradFunction df, HessVectFunction hess_vect, unsigned int max_iter = 100,
+                    double abs_tol = 1e-6, double abs_grad_tol = 1e-6) {
+  return newton_cg_ls_factory<Function,GradFunction,HessVectFunction,double>(f,df,hess_vect,max_iter,100,abs_tol,abs_grad_tol);
+};
+
+
+
+
+/**
+ * This functor is a factory class to construct a truncated Newton (Newton-CG) optimizer routine
+ * that uses a trust-region approach (by default, the Steihaug-CG method is used to solve the
+ * trust-region sub-problem, see trust_region_solver_steihaug_cg). The Hessian-vector product functor
+ * is called as hess_vect(x, x_grad, v) and returns the product of the Hessian at x with v.
+ * Use make_newton_cg_tr to construct this without having to specify the template arguments explicitly.
+ * \test Must create a unit-test for this.
+ * \tparam Function The functor type of the function to optimize.
+ * \tparam GradFunction The functor type of the gradient of the function to optimize.
+ * \tparam HessVectFunction The functor type of the Hessian-vector product of the function to optimize.
+ * \tparam T The value-type of the field on which the optimization is performed.
+ * \tparam LimitFunction A functor type that can impose limits on a proposed solution step (see no_limit_functor or box_limit_function for examples).
+ * \tparam TrustRegionSolver A functor type that can solve for a solution step within a trust-region using only Hessian-vector products (see trust_region_solver_steihaug_cg).
+ */
+template <typename Function, typename GradFunction, typename HessVectFunction, typename T,
+          typename LimitFunction = no_limit_functor,
+          typename TrustRegionSolver = trust_region_solver_steihaug_cg<T> >
+struct newton_cg_tr_factory {
+  Function f;
+  GradFunction df;
+  HessVectFunction hess_vect;
+  T max_radius;
+  unsigned int max_iter;
+  T abs_tol;
+  T abs_grad_tol;
+  T eta;
+  LimitFunction impose_limits;
+  TrustRegionSolver solve_step;
+
+  /**
+   * Parametrized constructor of the factory object.
+   * \param aF The function to minimize.
+   * \param aDf The gradient of the function to minimize.
+   * \param aHessVect The functor that can compute the Hessian-vector products of the function to minimize.
+   * \param aMaxRadius The maximum trust-region radius to use (i.e. maximum optimization step).
+   * \param aMaxIter The maximum number of iterations to perform.
+   * \param aTol The tolerance on the norm of step size.
+   * \param aGradTol The tolerance on the norm of the (projected) gradient.
+   * \param aEta The tolerance on the ratio between actual reduction and predicted reduction in order to accept a given step.
+   * \param aImposeLimits The functor that can impose simple limits on the search domain.
+   * \param aSolveStep The functor that can solve for a solution step within a trust-region.
+   */
+  newton_cg_tr_factory(Function aF, GradFunction aDf, HessVectFunction aHessVect,
+                       T aMaxRadius = T(1.0), unsigned int aMaxIter = 100,
+                       T aTol = T(1e-6), T aGradTol = T(1e-6), T aEta = T(1e-4),
+                       LimitFunction aImposeLimits = LimitFunction(),
+                       TrustRegionSolver aSolveStep = TrustRegionSolver()) :
+                       f(aF), df(aDf), hess_vect(aHessVect), max_radius(aMaxRadius),
+                       max_iter(aMaxIter), abs_tol(aTol), abs_grad_tol(aGradTol), eta(aEta),
+                       impose_limits(aImposeLimits), solve_step(aSolveStep) { };
+
+  /**
+   * This function finds the minimum of a function, given its derivative and Hessian-vector
+   * products, using a truncated Newton step and using a trust-region approach.
+   * \tparam Vector The vector type of the independent variable for the function.
+   * \param x The initial guess to the solution, as well as a storage for the result of the algorihm.
+   */
+  template <typename Vector>
+  void operator()(Vector& x) const {
+    detail::newton_cg_method_tr_impl(f,df,hess_vect,x,max_radius,max_iter,solve_step,impose_limits,abs_tol,abs_grad_tol,eta);
+  };
+
+  /**
+   * This function remaps the factory to one which will use the given limit-function for the search domain.
+   * \tparam NewLimitFunction A new functor type that can impose limits on a proposed solution step (see no_limit_functor or box_limit_function for examples).
+   * \param new_limits The functor that can impose simple limits on the search domain.
+   */
+  template <typename NewLimitFunction>
+  newton_cg_tr_factory<Function,GradFunction,HessVectFunction,T,NewLimitFunction,TrustRegionSolver>
+    set_limiter(NewLimitFunction new_limits) const {
+    return newton_cg_tr_factory<Function,GradFunction,HessVectFunction,T,NewLimitFunction,TrustRegionSolver>(
+      f,df,hess_vect,max_radius,max_iter,abs_tol,abs_grad_tol,eta,new_limits,solve_step);
+  };
+
+  /**
+   * This function remaps the factory to one which will use the given solver within the trust-region.
+   * \tparam NewTrustRegionSolver A functor type that can solve for a solution step within a trust-region using only Hessian-vector products.
+   * \param new_solver The functor that can solve for a solution step within a trust-region.
+   */
+  template <typename NewTrustRegionSolver>
+  newton_cg_tr_factory<Function,GradFunction,HessVectFunction,T,LimitFunction,NewTrustRegionSolver>
+    set_tr_solver(NewTrustRegionSolver new_solver) const {
+    return newton_cg_tr_factory<Function,GradFunction,HessVectFunction,T,LimitFunction,NewTrustRegionSolver>(
+      f,df,hess_vect,max_radius,max_iter,abs_tol,abs_grad_tol,eta,impose_limits,new_solver);
+  };
+
+};
+
+/**
+ * This function template creates a factory object to construct a truncated Newton (Newton-CG)
+ * optimizer routine that uses a trust-region approach.
+ * \test Must create a unit-test for this.
+ * \tparam Function The functor type of the function to optimize.
+ * \tparam GradFunction The functor type of the gradient of the function to optimize.
+ * \tparam HessVectFunction The functor type of the Hessian-vector product of the function to optimize.
+ * \param f The function to minimize.
+ * \param df The gradient of the function to minimize.
+ * \param hess_vect The functor that can compute the Hessian-vector products, called as hess_vect(x, x_grad, v).
+ * \param max_radius The maximum trust-region radius to use (i.e. maximum optimization step).
+ * \param max_iter The maximum number of iterations to perform.
+ * \param abs_tol The tolerance on the norm of the step size.
+ * \param abs_grad_tol The tolerance on the norm of the gradient.
+ * \param eta The tolerance on the ratio between actual reduction and predicted reduction in order to accept a given step.
+ */
+template <typename Function, typename GradFunction, typename HessVectFunction>
+newton_cg_tr_factory<Function,GradFunction,HessVectFunction,double>
+  make_newton_cg_tr(Function f, GradFunction df, HessVectFunction hess_vect,
+                    double max_radius = 1.0, unsigned int max_iter = 100,
+                    double abs_tol = 1e-6, double abs_grad_tol = 1e-6, double eta = 1e-4) {
+  return newton_cg_tr_factory<Function,GradFunction,HessVectFunction,double>(f,df,hess_vect,max_radius,max_iter,abs_tol,abs_grad_tol,eta);
+};
+
+
+
+};
+
+};
+
+
+#endif
+
+
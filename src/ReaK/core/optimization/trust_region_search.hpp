@@ -182,6 +182,59 @@ namespace detail {
   };
 
 
+  template <typename Vector, typename T>
+  T compute_boundary_step_impl(const Vector& z, const Vector& d, T radius) {
+    using std::sqrt;
+    T dd = d * d;
+    T zd = z * d;
+    T zz = z * z;
+    return (-zd + sqrt(zd * zd + dd * (radius * radius - zz))) / dd;
+  };
+
+
+  template <typename Vector, typename Matrix, typename T>
+  void compute_steihaug_cg_point_impl(const Vector& g, const Matrix& B, Vector& p, T& norm_p, T radius, unsigned int max_iter, T rel_tol, T abs_tol) {
+    using std::sqrt;
+    T norm_g = norm_2(g);
+    T eps = (sqrt(norm_g) < rel_tol ? sqrt(norm_g) : rel_tol) * norm_g;
+    p = g; p *= T(0.0);
+    norm_p = T(0.0);
+    if(norm_g < abs_tol)
+      return;
+    Vector r = g;
+    Vector d = -g;
+    T rr = r * r;
+    for(unsigned int j = 0; j < max_iter; ++j) {
+      Vector Bd = B * d;
+      T dBd = d * Bd;
+      if(dBd <= abs_tol * (d * d)) {
+        // negative curvature: go to the boundary along d (or steepest-descent at first iteration).
+        T tau = compute_boundary_step_impl(p, d, radius);
+        p += tau * d;
+        norm_p = radius;
+        return;
+      };
+      T alpha = rr / dBd;
+      Vector pn = p; pn += alpha * d;
+      if(norm_2(pn) >= radius) {
+        T tau = compute_boundary_step_impl(p, d, radius);
+        p += tau * d;
+        norm_p = radius;
+        return;
+      };
+      p = pn;
+      r += alpha * Bd;
+      T rr_n = r * r;
+      if(sqrt(rr_n) < eps)
+        break;
+      d *= rr_n / rr;
+      d -= r;
+      rr = rr_n;
+    };
+    norm_p = norm_2(p);
+  };
+
+
 };
 
 
@@ -418,6 +471,71 @@ struct tr_solver_right_pinv_dogleg_reg {
 
 
 
+/**
+ * This function computes the Steihaug conjugate-gradient point, which is the solution to the 
+ * trust-region sub-problem obtained by conjugate-gradient iterations (truncated when negative
+ * curvature is found, when the trust-region boundary is reached, or when the residual is small 
+ * enough). This solver only requires matrix-vector products with the Hessian (B * v), and thus, 
+ * B can be any (implicit) linear operator that provides such a product, such as a limited-memory
+ * quasi-Newton approximation or a Hessian-vector product functor.
+ * \tparam Vector A writable vector type.
+ * \tparam Matrix A readable matrix type, or any type such that B * v is a vector.
+ * \param g The gradient vector of the function at the center of the trust-region.
+ * \param B The Hessian (or approximate Hessian) of the function at the center of the trust-region.
+ * \param p The resulting point.
+ * \param norm_p The resulting norm of the point (less-than or equal to the trust-region radius).
+ * \param radius The radius of the trust-region.
+ * \param max_iter The maximum number of conjugate-gradient iterations.
+ * \param rel_tol The maximum relative tolerance on the residual (forcing term), relative to the norm of the gradient.
+ * \param abs_tol The tolerance at which to consider values to be zero.
+ */
+template <typename Vector, typename Matrix>
+typename boost::enable_if<
+  is_writable_vector<Vector>,
+void >::type compute_steihaug_cg_point(const Vector& g, const Matrix& B, Vector& p, typename vect_traits<Vector>::value_type& norm_p, typename vect_traits<Vector>::value_type radius, unsigned int max_iter = 100, typename vect_traits<Vector>::value_type rel_tol = typename vect_traits<Vector>::value_type(0.5), typename vect_traits<Vector>::value_type abs_tol = typename vect_traits<Vector>::value_type(1e-6)) {
+  detail::compute_steihaug_cg_point_impl(g,B,p,norm_p,radius,max_iter,rel_tol,abs_tol);
+};
+
+/**
+ * This functor class computes the Steihaug conjugate-gradient point which approximately minimizes 
+ * a quadratic function within a trust-region of a given radius, using only products with the 
+ * Hessian matrix (see compute_steihaug_cg_point).
+ * \test Must create a unit-test for this.
+ * \tparam T The value-type.
+ */
+template <typename T>
+struct trust_region_solver_steihaug_cg {
+  unsigned int max_iter;
+  T rel_tol;
+  
+  /**
+   * Parametrized Constructor.
+   * \param aMaxIter The maximum number of conjugate-gradient iterations.
+   * \param aRelTol The maximum relative tolerance on the residual (forcing term), relative to the norm of the gradient.
+   */
+  trust_region_solver_steihaug_cg(unsigned int aMaxIter = 100, T aRelTol = T(0.5)) : max_iter(aMaxIter), rel_tol(aRelTol) { };
+  
+  /**
+   * This function computes the Steihaug conjugate-gradient point which approximately minimizes 
+   * a quadratic function within a trust-region of a given radius.
+   * \tparam Vector A writable vector type.
+   * \tparam Matrix A readable matrix type, or any type such that B * v is a vector.
+   * \param g The gradient vector of the function at the center of the trust-region.
+   * \param B The Hessian (or approximate Hessian) of the function at the center of the trust-region.
+   * \param p The resulting point.
+   * \param norm_p The resulting norm of the point (less-than or equal to the trust-region radius).
+   * \param radius The radius of the trust-region.
+   * \param abs_tol The tolerance at which to consider values to be zero.
+   */
+  template <typename Vector, typename Matrix>
+  void operator()(const Vector& g, const Matrix& B, Vector& p, typename vect_traits<Vector>::value_type& norm_p, typename vect_traits<Vector>::value_type radius, typename vect_traits<Vector>::value_type abs_tol = typename vect_traits<Vector>::value_type(1e-6)) const {
+    compute_steihaug_cg_point(g,B,p,norm_p,radius,max_iter,rel_tol,abs_tol);
+  };
+};
+
+
+
+
 
 };
 
@@ -0,0 +1,203 @@
+
+/*
+ *    Copyright 2013 Sven Mikael Persson
+ *
+ *    THIS SOFTWARE IS DISTRIBUTED UNDER THE TERMS OF THE GNU GENERAL PUBLIC LICENSE v3 (GPLv3).
+ *
+ *    This file is part of ReaK.
+ *
+ *    ReaK is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    (at your option) any later version.
+ *
+ *    ReaK is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with ReaK (as LICENSE in the root folder).
+ *    If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "base/defs.hpp"
+
+#include "finite_diff_jacobians.hpp"
+
+#include "lin_alg/mat_alg.hpp"
+
+#include <vector>
+#include <complex>
+#include <cmath>
+#include <stdexcept>
+
+#define BOOST_TEST_DYN_LINK
+
+#define BOOST_TEST_MODULE finite_diff_jacobians
+#include <boost/test/unit_test.hpp>
+
+
+namespace {
+
+using namespace ReaK;
+
+typedef mat<double, mat_structure::rectangular> mat_type;
+
+/* 
+ * A banded test function from R^N to R^(N-2), y_i = sin(x_i) * x_(i+1)^2 + exp(0.1 * x_(i+2)), 
+ * written for real and complex arguments. The (i,j) entry of its Jacobian is non-zero only for i <= j <= i + 2.
+ */
+struct banded_function {
+  template <typename T>
+  static void eval(const std::vector<T>& x, std::vector<T>& y) {
+    using std::sin; using std::exp;
+    y.resize(x.size() - 2);
+    for(std::size_t i = 0; i < y.size(); ++i)
+      y[i] = sin(x[i]) * x[i+1] * x[i+1] + exp(0.1 * x[i+2]);
+  };
+  
+  vect_n<double> operator()(const vect_n<double>& x) const {
+    std::vector<double> xs(x.begin(), x.end()), ys;
+    eval(xs, ys);
+    return vect_n<double>(ys.begin(), ys.end());
+  };
+  
+  std::vector< std::complex<double> > operator()(const std::vector< std::complex<double> >& x) const {
+    std::vector< std::complex<double> > y;
+    eval(x, y);
+    return y;
+  };
+};
+
+/* Throws when its aBadIndex-th input is perturbed away from aBadValue. */
+struct throwing_function {
+  std::size_t bad_index;
+  double bad_value;
+  throwing_function(std::size_t aBadIndex, double aBadValue) : bad_index(aBadIndex), bad_value(aBadValue) { };
+  vect_n<double> operator()(const vect_n<double>& x) const {
+    if(x[bad_index] != bad_value)
+      throw std::domain_error("Function evaluated outside its domain!");
+    return banded_function()(x);
+  };
+};
+
+double max_abs_diff(const mat_type& A, const mat_type& B) {
+  double result = 0.0;
+  for(std::size_t i = 0; i < A.get_row_count(); ++i)
+    for(std::size_t j = 0; j < A.get_col_count(); ++j)
+      if(std::fabs(A(i,j) - B(i,j)) > result)
+        result = std::fabs(A(i,j) - B(i,j));
+  return result;
+};
+
+vect_n<double> make_test_point(std::size_t N) {
+  vect_n<double> x(N);
+  for(std::size_t i = 0; i < N; ++i)
+    x[i] = 0.3 + 0.7 * std::sin(1.3 * i + 0.5);
+  return x;
+};
+
+};
+
+
+BOOST_AUTO_TEST_CASE( parallel_jacobians_tests )
+{
+  const std::size_t N = 23;
+  vect_n<double> x = make_test_point(N);
+  banded_function f;
+  vect_n<double> y = f(x);
+  
+  mat_type J_serial(y.size(), N), J_par(y.size(), N);
+  optim::compute_jacobian_2pts_central(f, x, y, J_serial);
+  BOOST_CHECK_EQUAL( J_serial.get_row_count(), N - 2 );
+  
+  for(std::size_t threads = 1; threads <= 4; ++threads) {
+    optim::compute_jacobian_2pts_central_parallel(f, x, y, J_par, threads);
+    BOOST_CHECK_LT( max_abs_diff(J_par, J_serial), 3e-9 );
+    
+    optim::compute_jacobian_2pts_central_parallel(std::vector< banded_function >(threads, f), x, y, J_par);
+    BOOST_CHECK_LT( max_abs_diff(J_par, J_serial), 3e-9 );
+    
+    optim::compute_jacobian_5pts_central_parallel(std::vector< banded_function >(threads, f), x, y, J_par);
+    BOOST_CHECK_LT( max_abs_diff(J_par, J_serial), 3e-9 );
+    
+    mat_type J_fwd(y.size(), N);
+    optim::compute_jacobian_2pts_forward(f, x, y, J_fwd);
+    optim::compute_jacobian_2pts_forward_parallel(f, x, y, J_par, threads);
+    BOOST_CHECK_LT( max_abs_diff(J_par, J_fwd), 1e-12 );
+  };
+};
+
+
+BOOST_AUTO_TEST_CASE( cpr_jacobians_tests )
+{
+  const std::size_t N = 23;
+  vect_n<double> x = make_test_point(N);
+  banded_function f;
+  vect_n<double> y = f(x);
+  
+  mat_type J_serial(y.size(), N), J_cpr(y.size(), N);
+  optim::compute_jacobian_2pts_central(f, x, y, J_serial);
+  
+  std::vector< std::vector< std::size_t > > col_rows(N);
+  for(std::size_t j = 0; j < N; ++j)
+    for(std::size_t i = (j < 2 ? 0 : j - 2); (i <= j) && (i < y.size()); ++i)
+      col_rows[j].push_back(i);
+  std::vector< std::vector< std::size_t > > groups;
+  optim::compute_jacobian_cpr_groups(col_rows, y.size(), groups);
+  BOOST_CHECK_EQUAL( groups.size(), 3 ); // a band of width 3 needs 3 groups.
+  
+  optim::compute_jacobian_2pts_central_cpr(f, x, y, J_cpr, col_rows, groups);
+  BOOST_CHECK_LT( max_abs_diff(J_cpr, J_serial), 3e-9 );
+  
+  mat_type J_fwd(y.size(), N);
+  optim::compute_jacobian_2pts_forward(f, x, y, J_fwd);
+  optim::compute_jacobian_2pts_forward_cpr(f, x, y, J_cpr, col_rows, groups);
+  BOOST_CHECK_LT( max_abs_diff(J_cpr, J_fwd), 1e-6 );
+  
+  // the point must be restored.
+  BOOST_CHECK_LT( norm_2(x - make_test_point(N)), 1e-15 );
+};
+
+
+BOOST_AUTO_TEST_CASE( complex_step_jacobian_tests )
+{
+  const std::size_t N = 23;
+  vect_n<double> x = make_test_point(N);
+  banded_function f;
+  vect_n<double> y = f(x);
+  
+  mat_type J_serial(y.size(), N), J_cs(y.size(), N);
+  optim::compute_jacobian_2pts_central(f, x, y, J_serial);
+  optim::compute_jacobian_complex_step(f, x, J_cs);
+  BOOST_CHECK_EQUAL( J_cs.get_row_count(), N - 2 );
+  BOOST_CHECK_LT( max_abs_diff(J_cs, J_serial), 3e-9 );
+  
+  // the complex-step is exact (to machine precision) against the analytical Jacobian.
+  mat_type J_exact(y.size(), N);
+  for(std::size_t i = 0; i < y.size(); ++i) {
+    for(std::size_t j = 0; j < N; ++j)
+      J_exact(i,j) = 0.0;
+    J_exact(i,i)   = std::cos(x[i]) * x[i+1] * x[i+1];
+    J_exact(i,i+1) = 2.0 * std::sin(x[i]) * x[i+1];
+    J_exact(i,i+2) = 0.1 * std::exp(0.1 * x[i+2]);
+  };
+  BOOST_CHECK_LT( max_abs_diff(J_cs, J_exact), 1e-14 );
+};
+
+
+BOOST_AUTO_TEST_CASE( parallel_jacobian_exceptions_tests )
+{
+  const std::size_t N = 23;
+  vect_n<double> x = make_test_point(N);
+  vect_n<double> y = banded_function()(x);
+  mat_type J(y.size(), N);
+  
+  // the perturbation of a column handled by a worker thread, and by the calling thread.
+  BOOST_CHECK_THROW( optim::compute_jacobian_2pts_central_parallel(throwing_function(5, x[5]), x, y, J, 3), std::domain_error );
+  BOOST_CHECK_THROW( optim::compute_jacobian_2pts_central_parallel(throwing_function(0, x[0]), x, y, J, 3), std::domain_error );
+  BOOST_CHECK_THROW( optim::compute_jacobian_2pts_forward_parallel(throwing_function(N - 1, x[N - 1]), x, y, J, 4), std::domain_error );
+};
+
+
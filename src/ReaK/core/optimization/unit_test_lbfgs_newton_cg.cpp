@@ -0,0 +1,129 @@
+
+/*
+ *    Copyright 2013 Sven Mikael Persson
+ *
+ *    THIS SOFTWARE IS DISTRIBUTED UNDER THE TERMS OF THE GNU GENERAL PUBLIC LICENSE v3 (GPLv3).
+ *
+ *    This file is part of ReaK.
+ *
+ *    ReaK is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    (at your option) any later version.
+ *
+ *    ReaK is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with ReaK (as LICENSE in the root folder).
+ *    If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "base/defs.hpp"
+
+#include "lbfgs_methods.hpp"
+#include "truncated_newton_methods.hpp"
+#include "limit_functions.hpp"
+
+#include <boost/bind.hpp>
+
+#include <cmath>
+
+#define BOOST_TEST_DYN_LINK
+
+#define BOOST_TEST_MODULE lbfgs_newton_cg
+#include <boost/test/unit_test.hpp>
+
+
+namespace {
+
+using namespace ReaK;
+
+typedef vect<double,2> vect_2;
+
+double rosenbrock_function(const vect_2& x) {
+  return (1.0 - x[0]) * (1.0 - x[0]) + 100.0 * (x[1] - x[0] * x[0]) * (x[1] - x[0] * x[0]);
+};
+
+vect_2 rosenbrock_function_grad(const vect_2& x) {
+  return vect_2(2.0 * (x[0] - 1.0) - 400.0 * x[0] * (x[1] - x[0] * x[0]),
+                200.0 * (x[1] - x[0] * x[0]));
+};
+
+vect_2 rosenbrock_function_hess_vect(const vect_2& x, const vect_2&, const vect_2& v) {
+  return vect_2((2.0 - 400.0 * x[1] + 1200.0 * x[0] * x[0]) * v[0] - 400.0 * x[0] * v[1],
+                -400.0 * x[0] * v[0] + 200.0 * v[1]);
+};
+
+typedef double (*func_ptr)(const vect_2&);
+typedef vect_2 (*grad_ptr)(const vect_2&);
+
+};
+
+
+BOOST_AUTO_TEST_CASE( lbfgs_rosenbrock_tests )
+{
+  vect_2 x(0.5, 1.0);
+  optim::make_lbfgs_method_ls(rosenbrock_function, rosenbrock_function_grad, 5, 200, 1e-10, 1e-8)(x);
+  BOOST_CHECK_SMALL( x[0] - 1.0, 1e-5 );
+  BOOST_CHECK_SMALL( x[1] - 1.0, 1e-5 );
+  
+  x = vect_2(-1.2, 1.0);
+  optim::make_lbfgs_method_ls(rosenbrock_function, rosenbrock_function_grad, 5, 200, 1e-10, 1e-8)(x);
+  BOOST_CHECK_SMALL( x[0] - 1.0, 1e-5 );
+  BOOST_CHECK_SMALL( x[1] - 1.0, 1e-5 );
+  
+  x = vect_2(0.5, 1.0);
+  optim::make_lbfgs_method_tr(rosenbrock_function, rosenbrock_function_grad, 5, 0.5, 500, 1e-10, 1e-8)(x);
+  BOOST_CHECK_SMALL( x[0] - 1.0, 1e-5 );
+  BOOST_CHECK_SMALL( x[1] - 1.0, 1e-5 );
+};
+
+
+BOOST_AUTO_TEST_CASE( newton_cg_rosenbrock_tests )
+{
+  vect_2 x(0.5, 1.0);
+  optim::make_newton_cg_ls(rosenbrock_function, rosenbrock_function_grad, rosenbrock_function_hess_vect, 200, 1e-10, 1e-8)(x);
+  BOOST_CHECK_SMALL( x[0] - 1.0, 1e-5 );
+  BOOST_CHECK_SMALL( x[1] - 1.0, 1e-5 );
+  
+  x = vect_2(0.5, 1.0);
+  optim::make_newton_cg_tr(rosenbrock_function, rosenbrock_function_grad, rosenbrock_function_hess_vect, 0.5, 200, 1e-10, 1e-8)(x);
+  BOOST_CHECK_SMALL( x[0] - 1.0, 1e-5 );
+  BOOST_CHECK_SMALL( x[1] - 1.0, 1e-5 );
+  
+  // with finite-difference Hessian-vector products.
+  x = vect_2(0.5, 1.0);
+  optim::make_newton_cg_ls(rosenbrock_function, rosenbrock_function_grad, 
+                           optim::finite_diff_hess_vect_prod< grad_ptr >(rosenbrock_function_grad), 200, 1e-10, 1e-8)(x);
+  BOOST_CHECK_SMALL( x[0] - 1.0, 1e-4 );
+  BOOST_CHECK_SMALL( x[1] - 1.0, 1e-4 );
+};
+
+
+BOOST_AUTO_TEST_CASE( bounded_lbfgs_rosenbrock_tests )
+{
+  // with x[0] <= 0.5, the constrained minimum is at the KKT point (0.5, 0.25), 
+  // where the gradient is (-1, 0), i.e., pushing against the active bound.
+  vect_2 l(-2.0, -2.0);
+  vect_2 u( 0.5,  2.0);
+  
+  vect_2 x(-1.2, 1.0);
+  optim::make_lbfgs_method_ls(rosenbrock_function, rosenbrock_function_grad, 5, 200, 1e-10, 1e-8)
+    .set_limiter(boost::bind(optim::box_limit_function<vect_2>, _1, _2, l, u))(x);
+  BOOST_CHECK_SMALL( x[0] - 0.5, 1e-6 );
+  BOOST_CHECK_SMALL( x[1] - 0.25, 1e-5 );
+  vect_2 g = rosenbrock_function_grad(x);
+  BOOST_CHECK_LT( g[0], 0.0 );
+  BOOST_CHECK_SMALL( g[1], 1e-4 );
+  
+  x = vect_2(-1.2, 1.0);
+  optim::make_lbfgs_method_tr(rosenbrock_function, rosenbrock_function_grad, 5, 0.5, 500, 1e-10, 1e-8)
+    .set_limiter(boost::bind(optim::box_limit_function<vect_2>, _1, _2, l, u))(x);
+  BOOST_CHECK_SMALL( x[0] - 0.5, 1e-6 );
+  BOOST_CHECK_SMALL( x[1] - 0.25, 1e-5 );
+};
+
+
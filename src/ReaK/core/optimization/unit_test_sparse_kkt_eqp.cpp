@@ -0,0 +1,147 @@
+/*
+ *    Copyright 2013 Sven Mikael Persson
+ *
+ *    THIS SOFTWARE IS DISTRIBUTED UNDER THE TERMS OF THE GNU GENERAL PUBLIC LICENSE v3 (GPLv3).
+ *
+ *    This file is part of ReaK.
+ *
+ *    ReaK is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    (at your option) any later version.
+ *
+ *    ReaK is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with ReaK (as LICENSE in the root folder).
+ *    If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "base/defs.hpp"
+
+#include "quadratic_programs.hpp"
+#include "nl_interior_points_methods.hpp"
+
+#include <cmath>
+
+#define BOOST_TEST_DYN_LINK
+
+#define BOOST_TEST_MODULE sparse_kkt_eqp
+#include <boost/test/unit_test.hpp>
+
+
+namespace {
+
+using namespace ReaK;
+
+/*
+ * A separable quadratic in 3D: f(x) = sum_i (x_i - i - 1)^2,
+ * with x_0 + x_1 + x_2 = 3 and x_2 <= 1.5, whose solution is (0.25, 1.25, 1.5).
+ */
+double quad_f(const vect_n<double>& x) {
+  return (x[0] - 1.0) * (x[0] - 1.0) + (x[1] - 2.0) * (x[1] - 2.0) + (x[2] - 3.0) * (x[2] - 3.0);
+};
+
+vect_n<double> quad_df(const vect_n<double>& x) {
+  return vect_n<double>(2.0 * (x[0] - 1.0), 2.0 * (x[1] - 2.0), 2.0 * (x[2] - 3.0));
+};
+
+void quad_fill_hessian(mat_sparse<double>& H, const vect_n<double>&, double, const vect_n<double>&) {
+  H = mat_sparse<double>(mat<double,mat_structure::diagonal>(3, 2.0));
+};
+
+vect_n<double> sum_g(const vect_n<double>& x) {
+  return vect_n<double>(1, x[0] + x[1] + x[2] - 3.0);
+};
+
+void sum_fill_g_jac(mat_sparse<double>& J, const vect_n<double>&, const vect_n<double>&) {
+  J = mat_sparse<double>(mat<double,mat_structure::rectangular>(1, 3, 1.0));
+};
+
+vect_n<double> bound_h(const vect_n<double>& x) {
+  return vect_n<double>(1, 1.5 - x[2]);
+};
+
+void bound_fill_h_jac(mat_sparse<double>& J, const vect_n<double>&, const vect_n<double>&) {
+  J = mat_sparse<double>(1, 3);
+  J(0,2) = -1.0;
+};
+
+// builds a small EQP in 4D with two constraints, G is indefinite but positive-definite on the null-space of A.
+void make_eqp(mat<double,mat_structure::rectangular>& A, vect_n<double>& b,
+              mat<double,mat_structure::symmetric>& G, vect_n<double>& c) {
+  A = mat<double,mat_structure::rectangular>(2, 4);
+  A(0,0) = 1.0; A(0,1) = 1.0;
+  A(1,2) = 1.0; A(1,3) = -1.0;
+  b = vect_n<double>(vect<double,2>(2.0, 1.0));
+  G = mat<double,mat_structure::symmetric>(mat<double,mat_structure::identity>(4));
+  G(0,1) = -2.0;  // indefinite, but positive on the null-space (x0 = -x1, x2 = x3).
+  c = vect_n<double>(1.0, -1.0, 0.5, 0.0);
+};
+
+};
+
+
+BOOST_AUTO_TEST_CASE( sparse_kkt_equality_only_tests )
+{
+  mat<double,mat_structure::rectangular> A;
+  mat<double,mat_structure::symmetric> G;
+  vect_n<double> b, c;
+  make_eqp(A, b, G, c);
+
+  vect_n<double> x_dense(4, 0.0), l_dense(2, 0.0);
+  optim::null_space_eqp_solver<double>()(A, b, G, c, x_dense, std::numeric_limits<double>::infinity(), 100, 1e-8, 1e-8, &l_dense);
+
+  optim::sparse_kkt_eqp_solver<double> solve_eqp;
+  vect_n<double> x_sparse(4, 0.0), l_sparse(2, 0.0);
+  solve_eqp(mat_sparse<double>(A), b, mat_sparse<double>(G), c, x_sparse, std::numeric_limits<double>::infinity(), 100, 1e-8, 1e-8, &l_sparse);
+
+  BOOST_CHECK_SMALL( norm_2(x_sparse - x_dense), 1e-6 );
+  BOOST_CHECK_SMALL( norm_2(l_sparse - l_dense), 1e-6 );
+  BOOST_CHECK_SMALL( norm_2(A * x_sparse - b), 1e-6 );
+
+  // the same pattern is analyzed only once, even with different values.
+  G(2,2) = 3.0; c[1] = 2.0;
+  solve_eqp(mat_sparse<double>(A), b, mat_sparse<double>(G), c, x_sparse, std::numeric_limits<double>::infinity(), 100, 1e-8, 1e-8, &l_sparse);
+  BOOST_CHECK_EQUAL( solve_eqp.ldl->get_analysis_count(), 1 );
+  BOOST_CHECK_SMALL( norm_2(A * x_sparse - b), 1e-6 );
+
+  // a trust-region that is smaller than the step is applied in the null-space of A only.
+  double full_norm = norm_2(x_sparse);
+  double min_norm = norm_2(transpose_view(A) * (0.5 * b));  // the minimum-norm solution of A x = b (A A' = 2 I).
+  double max_norm = 0.5 * (full_norm + min_norm);
+  vect_n<double> x_tr(4, 0.0);
+  solve_eqp(mat_sparse<double>(A), b, mat_sparse<double>(G), c, x_tr, max_norm, 100, 1e-8, 1e-8);
+  BOOST_CHECK_SMALL( norm_2(A * x_tr - b), 1e-6 );
+  BOOST_CHECK_LE( norm_2(x_tr), max_norm + 1e-6 );
+};
+
+
+BOOST_AUTO_TEST_CASE( sparse_kkt_interior_point_tests )
+{
+  // the copies of the solver share its decomposition.
+  optim::sparse_kkt_eqp_solver<double> solve_eqp;
+  vect_n<double> x(0.0, 0.0, 0.0);
+  optim::make_nlip_newton_ls(quad_f, quad_df, quad_fill_hessian, 1.0, 100, 1e-6, 1e-4, 0.995)
+    .set_eq_constraints(sum_g, sum_fill_g_jac)
+    .set_ineq_constraints(bound_h, bound_fill_h_jac)
+    .set_eqp_solver(solve_eqp)(x);
+  BOOST_CHECK_SMALL( x[0] - 0.25, 1e-4 );
+  BOOST_CHECK_SMALL( x[1] - 1.25, 1e-4 );
+  BOOST_CHECK_SMALL( x[2] - 1.5, 1e-4 );
+  // the KKT pattern does not change from one iteration to the next.
+  BOOST_CHECK_EQUAL( solve_eqp.ldl->get_analysis_count(), 1 );
+
+  // with the inequality only.
+  x = vect_n<double>(0.0, 0.0, 0.0);
+  optim::make_nlip_newton_ls(quad_f, quad_df, quad_fill_hessian, 1.0, 100, 1e-6, 1e-4, 0.995)
+    .set_ineq_constraints(bound_h, bound_fill_h_jac)
+    .set_eqp_solver(optim::sparse_kkt_eqp_solver<double>())(x);
+  BOOST_CHECK_SMALL( x[0] - 1.0, 1e-4 );
+  BOOST_CHECK_SMALL( x[1] - 2.0, 1e-4 );
+  BOOST_CHECK_SMALL( x[2] - 1.5, 1e-4 );
+};
+
@@ -71,7 +71,9 @@ void bin_recorder::setStreamImpl(const shared_ptr<std::ostream>& aStreamPtr) {
 
 bool bin_extractor::readRow() {
   ReaKaux::unique_lock< ReaKaux::mutex > lock_here(access_mutex);
-  if((in_stream) && (*in_stream) && (colCount > 0)) {
+  if((!in_stream) || (!(*in_stream)))
+    return false;
+  if(colCount > 0) {
     for(unsigned int i = 0; i < colCount; ++i) {
       double tmp = 0;
       in_stream->read(reinterpret_cast<char*>(&tmp),sizeof(double));
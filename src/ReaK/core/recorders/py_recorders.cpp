@@ -0,0 +1,153 @@
+/**
+ *\file py_recorders.cpp
+ *
+ * This source file defines export functions for the python bindings on the data extractor
+ * classes of the ReaK platform.
+ *
+ * \author Sven Mikael Persson <mikael.s.persson@gmail.com>
+ * \date June 2013
+ */
+
+/*
+ *    Copyright 2013 Sven Mikael Persson
+ *
+ *    THIS SOFTWARE IS DISTRIBUTED UNDER THE TERMS OF THE GNU GENERAL PUBLIC LICENSE v3 (GPLv3).
+ *
+ *    This file is part of ReaK.
+ *
+ *    ReaK is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    (at your option) any later version.
+ *
+ *    ReaK is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with ReaK (as LICENSE in the root folder).
+ *    If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#include "base/defs.hpp"
+
+#include "ssv_recorder.hpp"
+#include "tsv_recorder.hpp"
+#include "bin_recorder.hpp"
+#include "tcp_recorder.hpp"
+#ifdef REAK_HAS_SHM_RECORDER
+#include "shm_recorder.hpp"
+#endif
+
+#include "lin_alg/mat_alg.hpp"
+
+#include <boost/python.hpp>
+
+#include "base/py_fixes.hpp"
+#include "base/py_array_interface.hpp"
+
+
+
+namespace PyReaK {
+
+
+boost::python::list py_extractor_names(ReaK::recorder::data_extractor& aExtractor) {
+  boost::python::list result;
+  try {
+    for(std::size_t i = 0; i < aExtractor.getColCount(); ++i) {
+      std::string name;
+      aExtractor >> name;
+      result.append(name);
+    };
+  } catch(ReaK::recorder::out_of_bounds&) { };
+  return result;
+};
+
+/*
+ * Reads (at most aMaxRows, or all) rows from the extractor into a column-major matrix, such that
+ * each column of data is contiguous when the matrix is viewed as a NumPy array. The GIL is released
+ * while reading, as reading can be long (and can wait for a network or shared-memory stream).
+ */
+ReaK::mat<double, ReaK::mat_structure::rectangular> py_extractor_read_columns(ReaK::recorder::data_extractor& aExtractor, std::size_t aMaxRows) {
+  using namespace ReaK::recorder;
+  const std::size_t col_count = aExtractor.getColCount();
+  std::vector<double> values;
+  std::size_t row_count = 0;
+  {
+    py_release_gil no_gil_here;
+    try {
+      while((col_count > 0) && ((aMaxRows == 0) || (row_count < aMaxRows))) {
+        for(std::size_t j = 0; j < col_count; ++j) {
+          double v;
+          aExtractor >> v;
+          values.push_back(v);
+        };
+        aExtractor >> data_extractor::end_value_row;
+        ++row_count;
+      };
+    } catch(end_of_record&) { };
+  };
+  ReaK::mat<double, ReaK::mat_structure::rectangular> result(row_count, col_count);
+  std::vector<double>::const_iterator it = values.begin();
+  for(std::size_t i = 0; i < row_count; ++i)
+    for(std::size_t j = 0; j < col_count; ++j, ++it)
+      result(i,j) = *it;
+  return result;
+};
+
+
+void export_recorders() {
+
+  using namespace boost::python;
+
+  class_< ReaK::recorder::data_extractor,
+          bases< ReaK::shared_object >,
+          ReaK::shared_ptr< ReaK::recorder::data_extractor >,
+          boost::noncopyable
+        >("DataExtractor",no_init)
+    .add_property("col_count", &ReaK::recorder::data_extractor::getColCount)
+    .def("names", py_extractor_names)
+    .def("read_columns", py_extractor_read_columns, (arg("max_rows") = 0));
+
+  class_< ReaK::recorder::ssv_extractor,
+          bases< ReaK::recorder::data_extractor >,
+          ReaK::shared_ptr< ReaK::recorder::ssv_extractor >,
+          boost::noncopyable
+        >("SSVExtractor", init<std::string>());
+
+  class_< ReaK::recorder::tsv_extractor,
+          bases< ReaK::recorder::ssv_extractor >,
+          ReaK::shared_ptr< ReaK::recorder::tsv_extractor >,
+          boost::noncopyable
+        >("TSVExtractor", init<std::string>());
+
+  class_< ReaK::recorder::bin_extractor,
+          bases< ReaK::recorder::data_extractor >,
+          ReaK::shared_ptr< ReaK::recorder::bin_extractor >,
+          boost::noncopyable
+        >("BinExtractor", init<std::string>());
+
+  class_< ReaK::recorder::tcp_extractor,
+          bases< ReaK::recorder::data_extractor >,
+          ReaK::shared_ptr< ReaK::recorder::tcp_extractor >,
+          boost::noncopyable
+        >("TCPExtractor", init<std::string>())
+    .def(init<std::string,bool>());
+
+#ifdef REAK_HAS_SHM_RECORDER
+  class_< ReaK::recorder::shm_extractor,
+          bases< ReaK::recorder::data_extractor >,
+          ReaK::shared_ptr< ReaK::recorder::shm_extractor >,
+          boost::noncopyable
+        >("ShmExtractor", init<std::string>())
+    .add_property("dropped_row_count", &ReaK::recorder::shm_extractor::getDroppedRowCount);
+#endif
+
+};
+
+
+};
+
@@ -0,0 +1,401 @@
+
+/*
+ *    Copyright 2013 Sven Mikael Persson
+ *
+ *    THIS SOFTWARE IS DISTRIBUTED UNDER THE TERMS OF THE GNU GENERAL PUBLIC LICENSE v3 (GPLv3).
+ *
+ *    This file is part of ReaK.
+ *
+ *    ReaK is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    (at your option) any later version.
+ *
+ *    ReaK is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with ReaK (as LICENSE in the root folder).
+ *    If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "shm_recorder.hpp"
+
+#include "base/chrono_incl.hpp"
+
+#include <boost/version.hpp>
+#include <boost/interprocess/shared_memory_object.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#if BOOST_VERSION < 105300
+#error "The shared-memory recorder requires Boost.Atomic (Boost 1.53 or later)."
+#endif
+#include <boost/atomic.hpp>
+
+#include <cstring>
+#include <new>
+
+#include <stdint.h>
+
+#if BOOST_ATOMIC_INT64_LOCK_FREE != 2
+#error "The shared-memory recorder requires lock-free 64-bit atomic integers (for inter-process use)."
+#endif
+
+
+namespace ReaK {
+
+namespace recorder {
+
+
+namespace {
+
+/*
+ * Layout of the shared-memory object:
+ *  - the ring header (below);
+ *  - the column names, as consecutive null-terminated strings;
+ *  - the row slots (starting at the data offset), each made of a 64-bit sequence number
+ *    followed by the values of the row, and padded to a multiple of the cache-line size.
+ *
+ * Row number n (counted from zero) is stored in slot (n % row_capacity). While the slot is
+ * being written, its sequence number is (2n + 1), and once the row is complete, it is (2n + 2).
+ * A reader copies the values of a slot between two reads of its sequence number, and the
+ * copy is valid only if both reads give the expected (2n + 2), i.e., a sequence lock.
+ */
+
+const uint64_t shm_ring_magic = 0x52654B53686D5231ULL; // "ReKShmR1"
+const std::size_t shm_cache_line = 64;
+
+struct shm_ring_header {
+  boost::atomic<uint64_t> ready;    // equal to the magic number once the ring is initialized.
+  uint64_t col_count;
+  uint64_t row_capacity;
+  uint64_t names_size;
+  uint64_t slot_size;
+  uint64_t data_offset;
+  char padding1[shm_cache_line - 6 * sizeof(uint64_t)];
+  boost::atomic<uint64_t> write_seq; // number of complete rows (on its own cache-line, as it is polled by readers).
+  boost::atomic<uint64_t> closed;    // non-zero once the recorder has closed the ring.
+  char padding2[shm_cache_line - 2 * sizeof(uint64_t)];
+};
+
+std::size_t shm_round_up(std::size_t sz) {
+  return ((sz + shm_cache_line - 1) / shm_cache_line) * shm_cache_line;
+};
+
+};
+
+
+class shm_ring_writer {
+  public:
+    std::string name;
+    boost::interprocess::shared_memory_object shm;
+    boost::interprocess::mapped_region region;
+    shm_ring_header* header;
+    char* data;
+    uint64_t col_count;
+    uint64_t row_capacity;
+    uint64_t slot_size;
+    uint64_t next_seq;
+
+    shm_ring_writer(const std::string& aName, std::size_t aRowCapacity, const std::vector<std::string>& aNames) :
+                    name(aName), shm(), region(), header(NULL), data(NULL),
+                    col_count(aNames.size()), row_capacity(aRowCapacity),
+                    slot_size(shm_round_up(sizeof(uint64_t) + aNames.size() * sizeof(double))), next_seq(0) {
+      if(row_capacity == 0)
+        row_capacity = 1;
+      std::size_t names_size = 0;
+      for(std::size_t i = 0; i < aNames.size(); ++i)
+        names_size += aNames[i].size() + 1;
+      std::size_t data_offset = shm_round_up(sizeof(shm_ring_header) + names_size);
+      std::size_t total_size = data_offset + row_capacity * slot_size;
+
+      // a left-over object from a recorder that crashed is replaced (readers that still map it keep their copy).
+      boost::interprocess::shared_memory_object::remove(name.c_str());
+      boost::interprocess::shared_memory_object(boost::interprocess::create_only, name.c_str(), boost::interprocess::read_write).swap(shm);
+      shm.truncate(total_size);
+      boost::interprocess::mapped_region(shm, boost::interprocess::read_write).swap(region);
+
+      char* base = static_cast<char*>(region.get_address());
+      header = new(base) shm_ring_header();
+      header->ready.store(0, boost::memory_order_relaxed);
+      header->col_count = col_count;
+      header->row_capacity = row_capacity;
+      header->names_size = names_size;
+      header->slot_size = slot_size;
+      header->data_offset = data_offset;
+      header->write_seq.store(0, boost::memory_order_relaxed);
+      header->closed.store(0, boost::memory_order_relaxed);
+
+      char* names_ptr = base + sizeof(shm_ring_header);
+      for(std::size_t i = 0; i < aNames.size(); ++i) {
+        std::memcpy(names_ptr, aNames[i].c_str(), aNames[i].size() + 1);
+        names_ptr += aNames[i].size() + 1;
+      };
+
+      data = base + data_offset;
+      for(std::size_t i = 0; i < row_capacity; ++i)
+        new(data + i * slot_size) boost::atomic<uint64_t>(0);
+
+      header->ready.store(shm_ring_magic, boost::memory_order_release);
+    };
+
+    ~shm_ring_writer() {
+      header->closed.store(1, boost::memory_order_release);
+      boost::interprocess::shared_memory_object::remove(name.c_str());
+    };
+
+    // publishes one row (col_count values), never waits for readers.
+    void publish(const double* values) {
+      char* slot = data + (next_seq % row_capacity) * slot_size;
+      boost::atomic<uint64_t>& seq = *reinterpret_cast< boost::atomic<uint64_t>* >(slot);
+      seq.store(2 * next_seq + 1, boost::memory_order_relaxed);
+      boost::atomic_thread_fence(boost::memory_order_release);
+      std::memcpy(slot + sizeof(uint64_t), values, col_count * sizeof(double));
+      seq.store(2 * next_seq + 2, boost::memory_order_release);
+      ++next_seq;
+      header->write_seq.store(next_seq, boost::memory_order_release);
+    };
+};
+
+
+class shm_ring_reader {
+  public:
+    boost::interprocess::shared_memory_object shm;
+    boost::interprocess::mapped_region region;
+    const shm_ring_header* header;
+    const char* data;
+    uint64_t col_count;
+    uint64_t row_capacity;
+    uint64_t slot_size;
+    uint64_t next_seq;
+    uint64_t dropped_rows;
+    std::vector<double> row_buf;
+
+    // opens the ring with the given name, waiting (for a limited time) for it to be created.
+    explicit shm_ring_reader(const std::string& aName) :
+                             shm(), region(), header(NULL), data(NULL), col_count(0),
+                             row_capacity(0), slot_size(0), next_seq(0), dropped_rows(0), row_buf() {
+      for(std::size_t i = 0; i < 50; ++i) {
+        if(try_open(aName))
+          return;
+        ReaKaux::this_thread::sleep_for(ReaKaux::chrono::milliseconds(100));
+      };
+      header = NULL;
+    };
+
+    bool try_open(const std::string& aName) {
+      try {
+        boost::interprocess::shared_memory_object(boost::interprocess::open_only, aName.c_str(), boost::interprocess::read_write).swap(shm);
+        boost::interprocess::offset_t sz = 0;
+        if((!shm.get_size(sz)) || (sz < static_cast<boost::interprocess::offset_t>(sizeof(shm_ring_header))))
+          return false;
+        // the mapping is read-write only because some platforms implement atomic loads with a
+        // compare-and-swap, the reader never writes to the shared memory otherwise.
+        boost::interprocess::mapped_region(shm, boost::interprocess::read_write).swap(region);
+        header = static_cast<const shm_ring_header*>(region.get_address());
+        if(header->ready.load(boost::memory_order_acquire) != shm_ring_magic)
+          return false;
+        if(region.get_size() < header->data_offset + header->row_capacity * header->slot_size)
+          return false;
+      } catch(boost::interprocess::interprocess_exception&) {
+        return false;
+      };
+      col_count = header->col_count;
+      row_capacity = header->row_capacity;
+      slot_size = header->slot_size;
+      data = static_cast<const char*>(region.get_address()) + header->data_offset;
+      row_buf.resize(col_count);
+      // start from the oldest row still held in the ring.
+      uint64_t w = header->write_seq.load(boost::memory_order_acquire);
+      next_seq = (w > row_capacity ? w - row_capacity : 0);
+      return true;
+    };
+
+    bool is_open() const { return (header != NULL); };
+
+    void read_names(std::vector<std::string>& aNames) const {
+      const char* it = static_cast<const char*>(region.get_address()) + sizeof(shm_ring_header);
+      const char* it_end = it + header->names_size;
+      for(uint64_t i = 0; (i < col_count) && (it < it_end); ++i) {
+        aNames.push_back(std::string(it));
+        it += aNames.back().size() + 1;
+      };
+    };
+
+    // reads the available rows (at most max_rows) into the queue, returns the number of rows
+    // read, and sets 'ended' if the recorder has closed the ring and all rows were read.
+    std::size_t read_rows(std::queue<double>& values, std::size_t max_rows, bool& ended) {
+      ended = false;
+      uint64_t w = header->write_seq.load(boost::memory_order_acquire);
+      if(next_seq >= w) {
+        if(header->closed.load(boost::memory_order_acquire) == 0)
+          return 0;
+        w = header->write_seq.load(boost::memory_order_acquire);
+        if(next_seq >= w) {
+          ended = true;
+          return 0;
+        };
+      };
+      if(w - next_seq > row_capacity) {
+        dropped_rows += w - row_capacity - next_seq;
+        next_seq = w - row_capacity;
+      };
+      std::size_t rows = 0;
+      for(; (next_seq < w) && (rows < max_rows); ++next_seq) {
+        const char* slot = data + (next_seq % row_capacity) * slot_size;
+        const boost::atomic<uint64_t>& seq = *reinterpret_cast< const boost::atomic<uint64_t>* >(slot);
+        uint64_t s1 = seq.load(boost::memory_order_acquire);
+        std::memcpy(&row_buf[0], slot + sizeof(uint64_t), col_count * sizeof(double));
+        boost::atomic_thread_fence(boost::memory_order_acquire);
+        uint64_t s2 = seq.load(boost::memory_order_relaxed);
+        if((s1 != 2 * next_seq + 2) || (s2 != s1)) {
+          // the row was overwritten by the recorder (this reader is lagging behind).
+          ++dropped_rows;
+          continue;
+        };
+        for(uint64_t i = 0; i < col_count; ++i)
+          values.push(row_buf[i]);
+        ++rows;
+      };
+      return rows;
+    };
+};
+
+
+
+
+shm_recorder::shm_recorder() : data_recorder(), pimpl(), shmName(), rowCapacity(1024) { };
+
+shm_recorder::shm_recorder(const std::string& aFileName, std::size_t aRowCapacity) :
+                           data_recorder(), pimpl(), shmName(), rowCapacity(aRowCapacity) {
+  setFileName(aFileName);
+};
+
+shm_recorder::~shm_recorder() {
+  if(colCount != 0)
+    *this << close;
+  ReaKaux::unique_lock< ReaKaux::mutex > lock_here(access_mutex);
+  pimpl.reset();
+};
+
+void shm_recorder::writeRow() {
+  ReaKaux::unique_lock< ReaKaux::mutex > lock_here(access_mutex);
+  if((pimpl) && (rowCount > 0) && (colCount > 0) && (pimpl->col_count == colCount)) {
+    // all pending rows are published at once.
+    std::vector<double> row(colCount);
+    for(; rowCount > 0; --rowCount) {
+      for(unsigned int i = 0; i < colCount; ++i) {
+        row[i] = values_rm.front();
+        values_rm.pop();
+      };
+      pimpl->publish(&row[0]);
+    };
+  };
+};
+
+void shm_recorder::writeNames() {
+  ReaKaux::unique_lock< ReaKaux::mutex > lock_here(access_mutex);
+  pimpl.reset();
+  if((!shmName.empty()) && (!names.empty()))
+    pimpl = shared_ptr<shm_ring_writer>(new shm_ring_writer(shmName, rowCapacity, names));
+};
+
+void shm_recorder::setFileName(const std::string& aFileName) {
+  if(colCount != 0) {
+    *this << close;
+
+    ReaKaux::unique_lock< ReaKaux::mutex > lock_here(access_mutex);
+    shmName = aFileName;
+    colCount = names.size();
+    currentColumn = 0;
+    rowCount = 0;
+    lock_here.unlock();
+    writeNames();
+    lock_here.lock();
+    writing_thread = ReaK::shared_ptr<ReaKaux::thread>(new ReaKaux::thread(record_process(*this)));
+  } else {
+    ReaKaux::unique_lock< ReaKaux::mutex > lock_here(access_mutex);
+    shmName = aFileName;
+    pimpl.reset();
+  };
+};
+
+std::size_t shm_recorder::getPublishedRowCount() const {
+  shared_ptr<shm_ring_writer> pimpl_tmp = pimpl;
+  if(!pimpl_tmp)
+    return 0;
+  return pimpl_tmp->header->write_seq.load(boost::memory_order_acquire);
+};
+
+
+
+
+
+shm_extractor::shm_extractor() : data_extractor(), pimpl() { };
+
+shm_extractor::shm_extractor(const std::string& aFileName) : data_extractor(), pimpl() {
+  setFileName(aFileName);
+};
+
+shm_extractor::~shm_extractor() { };
+
+bool shm_extractor::readRow() {
+  while(colCount > 0) {
+    {
+      ReaKaux::unique_lock< ReaKaux::mutex > lock_here(access_mutex);
+      shared_ptr<shm_ring_reader> pimpl_tmp = pimpl;
+      if((!pimpl_tmp) || (!pimpl_tmp->is_open()) || (pimpl_tmp->col_count != colCount))
+        return false;
+      bool ended = false;
+      if(pimpl_tmp->read_rows(values_rm, pimpl_tmp->row_capacity, ended) > 0)
+        return true;
+      if(ended)
+        return false;
+    };
+    // nothing new yet, poll again without holding the lock (such that buffered values can be consumed).
+    ReaKaux::this_thread::sleep_for(ReaKaux::chrono::microseconds(50));
+  };
+  return false;
+};
+
+bool shm_extractor::readNames() {
+  shared_ptr<shm_ring_reader> pimpl_tmp = pimpl;
+  if((pimpl_tmp) && (pimpl_tmp->is_open())) {
+    std::vector<std::string> new_names;
+    pimpl_tmp->read_names(new_names);
+    for(std::size_t i = 0; i < new_names.size(); ++i) {
+      names.push_back(new_names[i]);
+      ++colCount;
+    };
+  };
+  return true;
+};
+
+void shm_extractor::setFileName(const std::string& aFileName) {
+  if(colCount != 0)
+    *this >> close;
+
+  ReaKaux::unique_lock< ReaKaux::mutex > lock_here(access_mutex);
+  names.clear();
+  currentColumn = 0;
+  currentNameCol = 0;
+  pimpl = shared_ptr<shm_ring_reader>(new shm_ring_reader(aFileName));
+  readNames();
+};
+
+std::size_t shm_extractor::getDroppedRowCount() const {
+  shared_ptr<shm_ring_reader> pimpl_tmp = pimpl;
+  if(!pimpl_tmp)
+    return 0;
+  return pimpl_tmp->dropped_rows;
+};
+
+
+
+};
+
+
+};
+
@@ -0,0 +1,171 @@
+/**
+ * \file shm_recorder.hpp
+ *
+ * This library declares the classes for data recording to a shared-memory ring buffer, for
+ * consumers (e.g., visualization or logging processes) running on the same host as the
+ * recording process. Here, "data" is meant as columns of floating-point (double) records
+ * of data, such as simulation results for example.
+ *
+ * \author Sven Mikael Persson <mikael.s.persson@gmail.com>
+ * \date June 2013
+ */
+
+/*
+ *    Copyright 2013 Sven Mikael Persson
+ *
+ *    THIS SOFTWARE IS DISTRIBUTED UNDER THE TERMS OF THE GNU GENERAL PUBLIC LICENSE v3 (GPLv3).
+ *
+ *    This file is part of ReaK.
+ *
+ *    ReaK is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    (at your option) any later version.
+ *
+ *    ReaK is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with ReaK (as LICENSE in the root folder).
+ *    If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef REAK_SHM_RECORDER_HPP
+#define REAK_SHM_RECORDER_HPP
+
+#include "data_record.hpp"
+
+namespace ReaK {
+
+namespace recorder {
+
+
+class shm_ring_writer;
+class shm_ring_reader;
+
+
+/**
+ * This class handles the publication of data rows into a named shared-memory ring buffer.
+ *
+ * The shared-memory object (named by setFileName) is created when the column names are ended,
+ * and it holds the column names followed by a fixed number of row slots. Each row is published
+ * with a sequence number, and the recorder never waits for the readers: when the ring is full,
+ * the oldest rows are overwritten, and a reader that falls behind by more than the capacity
+ * of the ring skips the rows it missed (see shm_extractor::getDroppedRowCount()). Any number
+ * of extractors can read from the same ring. The shared-memory object is removed when the
+ * recorder is re-opened (setFileName) or destroyed, which is signaled to the extractors.
+ */
+class shm_recorder : public data_recorder {
+  protected:
+    virtual void writeRow();
+    virtual void writeNames();
+    virtual void setStreamImpl(const shared_ptr<std::ostream>& aStreamPtr) { };
+
+    shared_ptr<shm_ring_writer> pimpl;
+    std::string shmName; ///< Holds the name of the shared-memory object.
+    std::size_t rowCapacity; ///< Holds the number of row slots in the ring buffer.
+  public:
+
+    /**
+     * Default constructor.
+     */
+    shm_recorder();
+
+    /**
+     * Constructor that opens the shared-memory object with name aFileName.
+     * \param aFileName The name of the shared-memory object (e.g., "reak_telemetry").
+     * \param aRowCapacity The number of row slots in the ring buffer.
+     */
+    shm_recorder(const std::string& aFileName, std::size_t aRowCapacity = 1024);
+
+    /**
+     * Destructor, closes the shared-memory object.
+     */
+    virtual ~shm_recorder();
+
+    virtual void setFileName(const std::string& aFileName);
+
+    /**
+     * Returns the number of rows that were published to the ring buffer.
+     */
+    std::size_t getPublishedRowCount() const;
+
+    virtual void RK_CALL save(serialization::oarchive& A, unsigned int) const {
+      data_recorder::save(A,data_recorder::getStaticObjectType()->TypeVersion());
+      A & RK_SERIAL_SAVE_WITH_NAME(shmName)
+        & RK_SERIAL_SAVE_WITH_NAME(rowCapacity);
+    };
+    virtual void RK_CALL load(serialization::iarchive& A, unsigned int) {
+      data_recorder::load(A,data_recorder::getStaticObjectType()->TypeVersion());
+      A & RK_SERIAL_LOAD_WITH_NAME(shmName)
+        & RK_SERIAL_LOAD_WITH_NAME(rowCapacity);
+      writeNames();
+    };
+
+    RK_RTTI_MAKE_CONCRETE_1BASE(shm_recorder,0x81100006,1,"shm_recorder",data_recorder)
+};
+
+
+
+/**
+ * This class handles the extraction of data rows from a named shared-memory ring buffer
+ * published by a shm_recorder. Opening the shared-memory object (setFileName) waits (for a
+ * few seconds) until the recorder has created it, and the extraction starts from the oldest
+ * row still held in the ring buffer. The extractor only reads from the shared memory, such
+ * that it cannot block the recorder or the other extractors. The extraction ends (end_of_record)
+ * once the recorder has removed the shared-memory object and all its rows were read.
+ */
+class shm_extractor : public data_extractor {
+  protected:
+    virtual bool readRow();
+    virtual bool readNames();
+    virtual void setStreamImpl(const shared_ptr<std::istream>& aStreamPtr) { };
+
+    shared_ptr<shm_ring_reader> pimpl;
+  public:
+
+    /**
+     * Default constructor.
+     */
+    shm_extractor();
+
+    /**
+     * Constructor that opens the shared-memory object with name aFileName.
+     */
+    shm_extractor(const std::string& aFileName);
+
+    /**
+     * Destructor, closes the shared-memory object.
+     */
+    virtual ~shm_extractor();
+
+    virtual void setFileName(const std::string& aFileName);
+
+    /**
+     * Returns the number of rows that were overwritten by the recorder before they could be read.
+     */
+    std::size_t getDroppedRowCount() const;
+
+    virtual void RK_CALL save(serialization::oarchive& A, unsigned int) const {
+      data_extractor::save(A,data_extractor::getStaticObjectType()->TypeVersion());
+    };
+    virtual void RK_CALL load(serialization::iarchive& A, unsigned int) {
+      data_extractor::load(A,data_extractor::getStaticObjectType()->TypeVersion());
+    };
+
+    RK_RTTI_MAKE_CONCRETE_1BASE(shm_extractor,0x81200006,1,"shm_extractor",data_extractor)
+};
+
+
+
+};
+
+
+};
+
+
+#endif
+
+
@@ -23,6 +23,10 @@
 
 #include "ssv_recorder.hpp"
 
+#include "text_number_format.hpp"
+
+#include <sstream>
+
 namespace ReaK {
 
 namespace recorder {
@@ -31,14 +35,12 @@ namespace recorder {
 void ssv_recorder::writeRow() {
   ReaKaux::unique_lock< ReaKaux::mutex > lock_here(access_mutex);
   if((out_stream) && (*out_stream) && (rowCount > 0) && (colCount > 0)) {
-    (*out_stream) << std::endl;
-    (*out_stream) << values_rm.front();
-    values_rm.pop();
-    for(unsigned int i = 1; i < colCount; ++i) {
-      (*out_stream) << " " << values_rm.front();
-      values_rm.pop();
-    };
-    --rowCount;
+    // all pending rows are formatted into the row buffer and written at once.
+    row_buffer.clear();
+    append_text_rows(values_rm, rowCount, colCount, ' ', row_buffer);
+    rowCount = 0;
+    out_stream->write(&row_buffer[0], row_buffer.size());
+    out_stream->flush();
   };
 };
 
@@ -59,8 +61,6 @@ void ssv_recorder::setStreamImpl(const shared_ptr<std::ostream>& aStreamPtr) {
     if((aStreamPtr) && (*aStreamPtr)) {
       ReaKaux::unique_lock< ReaKaux::mutex > lock_here(access_mutex);
       out_stream = aStreamPtr;
-      out_stream->setf(std::ios::scientific, std::ios::floatfield);
-      out_stream->precision(11);
       colCount = names.size();
       lock_here.unlock();
       writeNames();
@@ -69,8 +69,6 @@ void ssv_recorder::setStreamImpl(const shared_ptr<std::ostream>& aStreamPtr) {
     if((aStreamPtr) && (*aStreamPtr)) {
       ReaKaux::unique_lock< ReaKaux::mutex > lock_here(access_mutex);
       out_stream = aStreamPtr;
-      out_stream->setf(std::ios::scientific, std::ios::floatfield);
-      out_stream->precision(11);
     };
   };
 };
@@ -79,16 +77,21 @@ void ssv_recorder::setStreamImpl(const shared_ptr<std::ostream>& aStreamPtr) {
 
 bool ssv_extractor::readRow() {
   ReaKaux::unique_lock< ReaKaux::mutex > lock_here(access_mutex);
-  if((in_stream) && (*in_stream) && (colCount > 0)) {
-    std::string temp;
-    std::getline(*in_stream, temp, '\n');
-    std::stringstream ss(temp);
+  if((!in_stream) || (!(*in_stream)))
+    return false;
+  if(colCount > 0) {
+    // on failure (end of stream), getline leaves the previous row in the buffer.
+    if(!std::getline(*in_stream, row_buffer, '\n'))
+      return false;
+    const char* it = row_buffer.data();
+    const char* it_end = it + row_buffer.size();
     for(unsigned int i = 0; i < colCount; ++i) {
       double tmp = 0;
-      ss >> tmp;
-      if(!ss)
+      const char* it_next = parse_double(it, it_end, tmp);
+      if(it_next == it)
         return false;
       values_rm.push(tmp);
+      it = it_next;
     };
   };
   return true;
@@ -47,6 +47,8 @@ namespace recorder {
  */
 class ssv_recorder : public data_recorder {
   protected:
+    std::vector<char> row_buffer; ///< Holds the text of the rows being written (re-used between writes).
+    
     virtual void writeRow();
     virtual void writeNames();
     virtual void setStreamImpl(const shared_ptr<std::ostream>& aStreamPtr);
@@ -55,12 +57,12 @@ class ssv_recorder : public data_recorder {
     /**
      * Default constructor.
      */
-    ssv_recorder() : data_recorder() { };
+    ssv_recorder() : data_recorder(), row_buffer() { };
     
     /**
      * Constructor that opens a file with name aFileName.
      */
-    ssv_recorder(const std::string& aFileName) : data_recorder() {
+    ssv_recorder(const std::string& aFileName) : data_recorder(), row_buffer() {
       setFileName(aFileName);
     };
 
@@ -87,6 +89,8 @@ class ssv_recorder : public data_recorder {
  */
 class ssv_extractor : public data_extractor {
   protected:
+    std::string row_buffer; ///< Holds the text of the row being read (re-used between reads).
+    
     virtual bool readRow();
     virtual bool readNames();
     virtual void setStreamImpl(const shared_ptr<std::istream>& aStreamPtr);
@@ -95,12 +99,12 @@ class ssv_extractor : public data_extractor {
     /**
      * Default constructor.
      */
-    ssv_extractor() : data_extractor() { };
+    ssv_extractor() : data_extractor(), row_buffer() { };
 
     /**
      * Constructor that opens a file with name aFileName.
      */
-    ssv_extractor(const std::string& aFileName) : data_extractor() {
+    ssv_extractor(const std::string& aFileName) : data_extractor(), row_buffer() {
       setFileName(aFileName);
     };
 
@@ -23,7 +23,13 @@
 
 #include "tcp_recorder.hpp"
 
+#include "base/chrono_incl.hpp"
+
 #include <boost/asio.hpp>
+#include <boost/bind.hpp>
+
+#include <deque>
+#include <cstring>
 
 
 namespace ReaK {
@@ -47,6 +53,264 @@ class tcp_server_impl {
     
 };
 
+
+/*
+ * This class implements the asynchronous mode of the tcp_recorder. The rows are queued in
+ * batches (one batch per call to writeRow), and a network thread runs the io_service that
+ * accepts clients and sends the queued batches. All the queued batches (up to max_gather) are
+ * sent by a single gather-write, and are only removed from the queue once completely sent,
+ * such that a connection loss only causes the batches in flight to be re-sent to the next client.
+ * The socket and acceptor are only used by the network thread. The block_writer policy only makes
+ * the writer wait while a client is connected to consume the queue, and never once the recorder
+ * is being closed, otherwise it applies the drop_oldest policy.
+ */
+class tcp_async_server_impl {
+  public:
+    typedef std::vector<char> batch_type;
+    
+    struct queued_batch {
+      shared_ptr<batch_type> data;
+      std::size_t rows;
+      queued_batch(const shared_ptr<batch_type>& aData, std::size_t aRows) : data(aData), rows(aRows) { };
+    };
+    
+    struct io_runner {
+      boost::asio::io_service* service;
+      explicit io_runner(boost::asio::io_service* aService) : service(aService) { };
+      void operator()() { service->run(); };
+    };
+    
+    static const std::size_t max_gather = 64;
+    
+    boost::asio::io_service io_service;
+    shared_ptr<boost::asio::io_service::work> io_work;
+    boost::asio::ip::tcp::acceptor acceptor;
+    boost::asio::ip::tcp::socket socket;
+    
+    ReaKaux::mutex queue_mutex;
+    ReaKaux::condition_variable queue_cond;
+    std::deque<queued_batch> queue;
+    std::string header;
+    shared_ptr<std::string> header_in_flight;
+    std::size_t queued_rows;
+    std::size_t max_queued_rows;
+    tcp_recorder::overflow_policy policy;
+    std::size_t dropped_rows;
+    std::size_t sent_rows;
+    std::size_t in_flight;
+    char watch_buf[16];
+    bool connected;
+    bool accepting;
+    bool watching;
+    bool sending;
+    bool header_pending;
+    bool flushing;
+    bool closing;
+    
+    shared_ptr<ReaKaux::thread> io_thread;
+    
+    tcp_async_server_impl(std::size_t port_num, std::size_t aMaxQueuedRows, tcp_recorder::overflow_policy aPolicy) :
+      io_service(),
+      io_work(new boost::asio::io_service::work(io_service)),
+      acceptor(io_service),
+      socket(io_service),
+      queue_mutex(), queue_cond(), queue(), header(), header_in_flight(),
+      queued_rows(0), max_queued_rows(aMaxQueuedRows), policy(aPolicy),
+      dropped_rows(0), sent_rows(0), in_flight(0),
+      connected(false), accepting(false), watching(false), sending(false), header_pending(false), flushing(false), closing(false),
+      io_thread() {
+      boost::asio::ip::tcp::endpoint endpoint(boost::asio::ip::tcp::v4(), port_num);
+      acceptor.open(endpoint.protocol());
+      acceptor.set_option(boost::asio::ip::tcp::acceptor::reuse_address(true));
+      acceptor.bind(endpoint);
+      acceptor.listen();
+      start_accept_locked();
+      io_thread = shared_ptr<ReaKaux::thread>(new ReaKaux::thread(io_runner(&io_service)));
+    };
+    
+    ~tcp_async_server_impl() {
+      shutdown();
+    };
+    
+    // a new client is only accepted once all operations on the previous connection have completed.
+    void start_accept_locked() {
+      if(connected || accepting || sending || watching || closing)
+        return;
+      accepting = true;
+      acceptor.async_accept(socket, boost::bind(&tcp_async_server_impl::handle_accept, this, 
+                                                boost::asio::placeholders::error));
+    };
+    
+    void handle_accept(const boost::system::error_code& err) {
+      ReaKaux::unique_lock< ReaKaux::mutex > lock_here(queue_mutex);
+      accepting = false;
+      if(err) {
+        if(err != boost::asio::error::operation_aborted)
+          start_accept_locked();
+        return;
+      };
+      boost::system::error_code ec;
+      socket.set_option(boost::asio::ip::tcp::no_delay(true), ec);
+      connected = true;
+      header_pending = true;
+      start_watch_locked();
+      start_send_locked();
+    };
+    
+    // the client never sends anything, a pending read detects the disconnection right away.
+    void start_watch_locked() {
+      watching = true;
+      socket.async_read_some(boost::asio::buffer(watch_buf), boost::bind(&tcp_async_server_impl::handle_watch, this, 
+                                                                          boost::asio::placeholders::error));
+    };
+    
+    void handle_watch(const boost::system::error_code& err) {
+      ReaKaux::unique_lock< ReaKaux::mutex > lock_here(queue_mutex);
+      watching = false;
+      if(!err && connected) {
+        start_watch_locked();
+        return;
+      };
+      disconnect_locked();
+      start_accept_locked();
+    };
+    
+    void disconnect_locked() {
+      if(!connected)
+        return;
+      connected = false;
+      boost::system::error_code ec;
+      socket.close(ec);
+      queue_cond.notify_all();
+    };
+    
+    void start_send() {
+      ReaKaux::unique_lock< ReaKaux::mutex > lock_here(queue_mutex);
+      start_send_locked();
+    };
+    
+    void start_send_locked() {
+      if(!connected || sending || header.empty() || (queue.empty() && !header_pending))
+        return;
+      std::vector<boost::asio::const_buffer> bufs;
+      if(header_pending) {
+        // the write keeps its own copy of the header, which set_header() could replace meanwhile.
+        header_in_flight = shared_ptr<std::string>(new std::string(header));
+        bufs.push_back(boost::asio::buffer(*header_in_flight));
+      };
+      in_flight = 0;
+      for(std::deque<queued_batch>::iterator it = queue.begin(); (it != queue.end()) && (in_flight < max_gather); ++it, ++in_flight)
+        bufs.push_back(boost::asio::buffer(*(it->data)));
+      sending = true;
+      boost::asio::async_write(socket, bufs, boost::bind(&tcp_async_server_impl::handle_write, this, 
+                                                         boost::asio::placeholders::error));
+    };
+    
+    void handle_write(const boost::system::error_code& err) {
+      ReaKaux::unique_lock< ReaKaux::mutex > lock_here(queue_mutex);
+      sending = false;
+      shared_ptr<std::string> sent_header = header_in_flight;
+      header_in_flight.reset();
+      if(err) {
+        // connection lost: the batches in flight stay queued, for the next client.
+        in_flight = 0;
+        disconnect_locked();
+        start_accept_locked();
+        return;
+      };
+      // a header set during the write is still pending.
+      if(sent_header && (*sent_header == header))
+        header_pending = false;
+      for(; in_flight > 0; --in_flight) {
+        queued_rows -= queue.front().rows;
+        sent_rows += queue.front().rows;
+        queue.pop_front();
+      };
+      queue_cond.notify_all();
+      start_send_locked();
+      start_accept_locked();
+    };
+    
+    void set_header(const std::string& aHeader) {
+      ReaKaux::unique_lock< ReaKaux::mutex > lock_here(queue_mutex);
+      header = aHeader;
+      header_pending = true;
+      io_service.post(boost::bind(&tcp_async_server_impl::start_send, this));
+    };
+    
+    void push_batch(const shared_ptr<batch_type>& aBatch, std::size_t aRows) {
+      ReaKaux::unique_lock< ReaKaux::mutex > lock_here(queue_mutex);
+      if(policy == tcp_recorder::block_writer) {
+        // without a client to consume the queue (or when closing), waiting could never end.
+        while(connected && (queued_rows > 0) && (queued_rows + aRows > max_queued_rows) && !flushing && !closing)
+          queue_cond.wait(lock_here);
+      };
+      // with a client, a blocking writer only overfills an empty queue, or a queue being flushed.
+      if((queued_rows + aRows > max_queued_rows) && !((policy == tcp_recorder::block_writer) && connected)) {
+        if(policy == tcp_recorder::drop_newest) {
+          dropped_rows += aRows;
+          return;
+        };
+        if(aRows > max_queued_rows) {
+          // the batch alone exceeds the queue, its oldest rows are discarded.
+          const std::size_t excess = aRows - max_queued_rows;
+          const std::size_t row_bytes = aBatch->size() / aRows;
+          aBatch->erase(aBatch->begin(), aBatch->begin() + excess * row_bytes);
+          dropped_rows += excess;
+          aRows = max_queued_rows;
+        };
+        // drop_oldest: discard the batches that are not being sent.
+        while((queue.size() > in_flight) && (queued_rows + aRows > max_queued_rows)) {
+          std::deque<queued_batch>::iterator it = queue.begin() + in_flight;
+          queued_rows -= it->rows;
+          dropped_rows += it->rows;
+          queue.erase(it);
+        };
+      };
+      queue.push_back(queued_batch(aBatch, aRows));
+      queued_rows += aRows;
+      io_service.post(boost::bind(&tcp_async_server_impl::start_send, this));
+    };
+    
+    // the writer stops waiting for room in the queue, such that the last rows can be flushed.
+    void stop_blocking() {
+      ReaKaux::unique_lock< ReaKaux::mutex > lock_here(queue_mutex);
+      flushing = true;
+      queue_cond.notify_all();
+    };
+    
+    void drain(std::size_t max_wait_ms) {
+      ReaKaux::unique_lock< ReaKaux::mutex > lock_here(queue_mutex);
+      for(std::size_t i = 0; (i < max_wait_ms) && !queue.empty(); ++i) {
+        lock_here.unlock();
+        ReaKaux::this_thread::sleep_for(ReaKaux::chrono::milliseconds(1));
+        lock_here.lock();
+      };
+    };
+    
+    void close_all() {
+      boost::system::error_code ec;
+      acceptor.close(ec);
+      socket.close(ec);
+    };
+    
+    void shutdown() {
+      if(!io_thread)
+        return;
+      {
+        ReaKaux::unique_lock< ReaKaux::mutex > lock_here(queue_mutex);
+        closing = true;
+        queue_cond.notify_all();
+      };
+      io_service.post(boost::bind(&tcp_async_server_impl::close_all, this));
+      io_work.reset();
+      io_thread->join();
+      io_thread.reset();
+    };
+    
+};
+
+
 class tcp_client_impl {
   public:
     boost::asio::io_service io_service;
@@ -61,20 +325,79 @@ class tcp_client_impl {
       socket.connect(endpoint);
     };
     
+    tcp_client_impl(const boost::asio::ip::tcp::endpoint& aEndpoint) : 
+      io_service(), 
+      endpoint(aEndpoint),
+      socket(io_service) { 
+      socket.connect(endpoint);
+    };
+    
+    void read_names(std::vector<std::string>& names) {
+      uint32_t data_len = 0;
+      {
+        boost::asio::streambuf::mutable_buffers_type bufs = row_buf.prepare(sizeof(uint32_t));
+        std::size_t len = boost::asio::read(socket, bufs);
+        row_buf.commit(len);
+        std::istream s_tmp(&row_buf);
+        s_tmp.read(reinterpret_cast<char*>(&data_len),sizeof(uint32_t));
+        data_len = ntohl(data_len);
+      };
+      boost::asio::streambuf::mutable_buffers_type bufs = row_buf.prepare(data_len);
+      std::size_t len = boost::asio::read(socket, bufs);
+      row_buf.commit(len);
+      std::istream s_tmp(&row_buf);
+      std::string tmp_name = "";
+      while((row_buf.size() > 0) && (s_tmp >> tmp_name))
+        names.push_back(tmp_name);
+    };
+    
 };
 
 
 
-tcp_recorder::tcp_recorder() : data_recorder(), pimpl() { };
+tcp_recorder::tcp_recorder() : data_recorder(), pimpl(), async_pimpl(), asyncMode(false), maxQueuedRows(0), overflowPolicy(drop_oldest) { };
+
+tcp_recorder::tcp_recorder(const std::string& aFileName) : data_recorder(), pimpl(), async_pimpl(), 
+                                                          asyncMode(false), maxQueuedRows(0), overflowPolicy(drop_oldest) {
+  setFileName(aFileName);
+};
 
-tcp_recorder::tcp_recorder(const std::string& aFileName) {
+tcp_recorder::tcp_recorder(const std::string& aFileName, std::size_t aMaxQueuedRows, overflow_policy aPolicy) : 
+                           data_recorder(), pimpl(), async_pimpl(), 
+                           asyncMode(true), maxQueuedRows(aMaxQueuedRows), overflowPolicy(aPolicy) {
   setFileName(aFileName);
 };
 
-tcp_recorder::~tcp_recorder() { };
+tcp_recorder::~tcp_recorder() { 
+  if(async_pimpl) {
+    // send what remains, waiting for a limited time (also for a client to connect).
+    async_pimpl->stop_blocking();
+    if(colCount != 0)
+      *this << close;
+    async_pimpl->drain(2000);
+    async_pimpl->shutdown();
+  };
+};
 
 void tcp_recorder::writeRow() {
   ReaKaux::unique_lock< ReaKaux::mutex > lock_here(access_mutex);
+  if(async_pimpl) {
+    if((rowCount > 0) && (colCount > 0)) {
+      // all pending rows are moved to a batch, the lock is kept while queuing it, such that a 
+      // blocking overflow policy propagates the back-pressure to the recording.
+      std::size_t rows = rowCount;
+      shared_ptr< std::vector<char> > batch(new std::vector<char>(rows * colCount * sizeof(double)));
+      char* it = &(*batch)[0];
+      for(std::size_t i = 0; i < rows * colCount; ++i, it += sizeof(double)) {
+        double tmp(values_rm.front());
+        std::memcpy(it, &tmp, sizeof(double));
+        values_rm.pop();
+      };
+      rowCount = 0;
+      async_pimpl->push_batch(batch, rows);
+    };
+    return;
+  };
   if((pimpl) && (pimpl->socket.is_open()) && (rowCount > 0) && (colCount > 0)) {
     std::ostream s_tmp(&(pimpl->row_buf));
     {
@@ -92,12 +415,17 @@ void tcp_recorder::writeRow() {
 
 void tcp_recorder::writeNames() {
   ReaKaux::unique_lock< ReaKaux::mutex > lock_here(access_mutex);
-  if((pimpl) && (pimpl->socket.is_open())) {
+  if(((pimpl) && (pimpl->socket.is_open())) || (async_pimpl)) {
     std::stringstream ss;
     for(std::vector<std::string>::iterator it = names.begin(); it != names.end(); ++it)
       ss << " " << *it;
     std::string data_str = ss.str();
     uint32_t data_len = htonl(data_str.size());
+    if(async_pimpl) {
+      std::string header(reinterpret_cast<char*>(&data_len), sizeof(uint32_t));
+      async_pimpl->set_header(header + data_str);
+      return;
+    };
     std::ostream s_tmp(&(pimpl->row_buf));
     s_tmp.write(reinterpret_cast<char*>(&data_len), sizeof(uint32_t));
     s_tmp.write(data_str.c_str(), data_str.size());
@@ -113,7 +441,11 @@ void tcp_recorder::setFileName(const std::string& aFileName) {
     ReaKaux::unique_lock< ReaKaux::mutex > lock_here(access_mutex);
     std::size_t port_num = 0;
     std::stringstream ss(aFileName); ss >> port_num;
-    pimpl = shared_ptr<tcp_server_impl>(new tcp_server_impl(port_num));
+    if(asyncMode) {
+      async_pimpl.reset();
+      async_pimpl = shared_ptr<tcp_async_server_impl>(new tcp_async_server_impl(port_num, maxQueuedRows, overflowPolicy));
+    } else
+      pimpl = shared_ptr<tcp_server_impl>(new tcp_server_impl(port_num));
     colCount = names.size();
     lock_here.unlock();
     writeNames();
@@ -121,37 +453,87 @@ void tcp_recorder::setFileName(const std::string& aFileName) {
     ReaKaux::unique_lock< ReaKaux::mutex > lock_here(access_mutex);
     std::size_t port_num = 0;
     std::stringstream ss(aFileName); ss >> port_num;
-    pimpl = shared_ptr<tcp_server_impl>(new tcp_server_impl(port_num));
+    if(asyncMode) {
+      async_pimpl.reset();
+      async_pimpl = shared_ptr<tcp_async_server_impl>(new tcp_async_server_impl(port_num, maxQueuedRows, overflowPolicy));
+    } else
+      pimpl = shared_ptr<tcp_server_impl>(new tcp_server_impl(port_num));
   };
 };
 
+std::size_t tcp_recorder::getDroppedRowCount() const {
+  if(!async_pimpl)
+    return 0;
+  ReaKaux::unique_lock< ReaKaux::mutex > lock_here(async_pimpl->queue_mutex);
+  return async_pimpl->dropped_rows;
+};
+
+std::size_t tcp_recorder::getSentRowCount() const {
+  if(!async_pimpl)
+    return 0;
+  ReaKaux::unique_lock< ReaKaux::mutex > lock_here(async_pimpl->queue_mutex);
+  return async_pimpl->sent_rows;
+};
+
 
 
 
 
-tcp_extractor::tcp_extractor() : data_extractor(), pimpl() { };
+tcp_extractor::tcp_extractor() : data_extractor(), pimpl(), autoReconnect(false) { };
+
+tcp_extractor::tcp_extractor(const std::string& aFileName) : data_extractor(), pimpl(), autoReconnect(false) {
+  setFileName(aFileName);
+};
 
-tcp_extractor::tcp_extractor(const std::string& aFileName) : data_extractor(), pimpl() {
+tcp_extractor::tcp_extractor(const std::string& aFileName, bool aAutoReconnect) : data_extractor(), pimpl(), autoReconnect(aAutoReconnect) {
   setFileName(aFileName);
 };
 
 tcp_extractor::~tcp_extractor() {};
 
-bool tcp_extractor::readRow() {
-  ReaKaux::unique_lock< ReaKaux::mutex > lock_here(access_mutex);
+bool tcp_extractor::reconnect() {
   shared_ptr<tcp_client_impl> pimpl_tmp = pimpl;
-  if((pimpl_tmp) && (pimpl_tmp->socket.is_open()) && (colCount > 0)) {
+  if(!pimpl_tmp)
+    return false;
+  boost::asio::ip::tcp::endpoint endpoint = pimpl_tmp->endpoint;
+  pimpl.reset();
+  for(std::size_t i = 0; i < 50; ++i) {
+    ReaKaux::this_thread::sleep_for(ReaKaux::chrono::milliseconds(100));
     try {
-      boost::asio::streambuf::mutable_buffers_type bufs = pimpl_tmp->row_buf.prepare(colCount * sizeof(double));
-      std::size_t len = boost::asio::read(pimpl_tmp->socket, bufs);
-      pimpl_tmp->row_buf.commit(len);
-      if(len < colCount * sizeof(double))
+      pimpl_tmp = shared_ptr<tcp_client_impl>(new tcp_client_impl(endpoint));
+      std::vector<std::string> new_names;
+      pimpl_tmp->read_names(new_names);
+      if(new_names.size() != colCount)
         return false;
-    } catch(...) {
-      return false;
+      pimpl = pimpl_tmp;
+      return true;
+    } catch(...) { };
+  };
+  return false;
+};
+
+bool tcp_extractor::readRow() {
+  ReaKaux::unique_lock< ReaKaux::mutex > lock_here(access_mutex);
+  shared_ptr<tcp_client_impl> pimpl_tmp = pimpl;
+  if((!pimpl_tmp) || (!pimpl_tmp->socket.is_open()))
+    return false;
+  if(colCount > 0) {
+    const std::size_t row_size = colCount * sizeof(double);
+    while(pimpl_tmp->row_buf.size() < row_size) {
+      try {
+        // take whatever has arrived (at least one byte), which is often many rows at once.
+        boost::asio::streambuf::mutable_buffers_type bufs = pimpl_tmp->row_buf.prepare((row_size < 65536 ? 65536 : row_size));
+        std::size_t len = pimpl_tmp->socket.read_some(bufs);
+        pimpl_tmp->row_buf.commit(len);
+      } catch(...) {
+        if((!autoReconnect) || (!reconnect()))
+          return false;
+        pimpl_tmp = pimpl;
+      };
     };
+    std::size_t value_count = (pimpl_tmp->row_buf.size() / row_size) * colCount;
     std::istream s_tmp(&(pimpl_tmp->row_buf));
-    for(std::size_t i = 0; (i < colCount) && (s_tmp); ++i) {
+    for(std::size_t i = 0; (i < value_count) && (s_tmp); ++i) {
       double tmp = 0;
       s_tmp.read(reinterpret_cast<char*>(&tmp),sizeof(double));
       values_rm.push(tmp);
@@ -163,22 +545,10 @@ bool tcp_extractor::readRow() {
 bool tcp_extractor::readNames() {
   shared_ptr<tcp_client_impl> pimpl_tmp = pimpl;
   if((pimpl_tmp) && (pimpl_tmp->socket.is_open())) {
-    uint32_t data_len = 0;
-    {
-      boost::asio::streambuf::mutable_buffers_type bufs = pimpl_tmp->row_buf.prepare(sizeof(uint32_t));
-      std::size_t len = boost::asio::read(pimpl_tmp->socket, bufs);
-      pimpl_tmp->row_buf.commit(len);
-      std::istream s_tmp(&(pimpl_tmp->row_buf));
-      s_tmp.read(reinterpret_cast<char*>(&data_len),sizeof(uint32_t));
-      data_len = ntohl(data_len);
-    };
-    boost::asio::streambuf::mutable_buffers_type bufs = pimpl_tmp->row_buf.prepare(data_len);
-    std::size_t len = boost::asio::read(pimpl_tmp->socket, bufs);
-    pimpl_tmp->row_buf.commit(len);
-    std::istream s_tmp(&(pimpl_tmp->row_buf));
-    std::string tmp_name = "";
-    while(s_tmp >> tmp_name) {
-      names.push_back(tmp_name);
+    std::vector<std::string> new_names;
+    pimpl_tmp->read_names(new_names);
+    for(std::size_t i = 0; i < new_names.size(); ++i) {
+      names.push_back(new_names[i]);
       ++colCount;
     };
   };
@@ -209,4 +579,3 @@ void tcp_extractor::setFileName(const std::string& aFileName) {
 };
 
 
-
@@ -42,19 +42,41 @@ namespace recorder {
   
 
 class tcp_server_impl;
+class tcp_async_server_impl;
 class tcp_client_impl;
 
 
 /**
  * This class handles file IO operations for a binary tcp-ip stream.
+ * 
+ * By default (synchronous mode), opening the stream (setFileName) waits for a client to connect
+ * and each row is sent by a blocking write. In asynchronous mode, the rows are queued and sent
+ * by a dedicated network thread which coalesces all queued rows into a single gather-write (with
+ * Nagle's algorithm disabled), such that the recording never waits for the network. The queue
+ * is bounded (see overflow_policy) and, when the client disconnects, the recorder waits for a new
+ * client, to which the column names are sent again before the queued rows. Rows that were being
+ * sent when the connection was lost are sent again to the next client (at-least-once delivery).
  */
 class tcp_recorder : public data_recorder {
+  public:
+    
+    /// Policies applied in asynchronous mode when the queue of rows waiting to be sent is full.
+    enum overflow_policy {
+      block_writer, ///< The writer waits until the queue has room (back-pressure on the recording) while a client is connected, otherwise the oldest queued rows are discarded.
+      drop_oldest, ///< The oldest queued rows (that are not already being sent) are discarded.
+      drop_newest ///< The rows being written are discarded.
+    };
+    
   protected:
     virtual void writeRow();
     virtual void writeNames();
     virtual void setStreamImpl(const shared_ptr<std::ostream>& aStreamPtr) { };
 
     shared_ptr<tcp_server_impl> pimpl;
+    shared_ptr<tcp_async_server_impl> async_pimpl;
+    bool asyncMode; ///< Holds the flag that tells if the asynchronous mode is used.
+    std::size_t maxQueuedRows; ///< Holds the maximum number of rows waiting to be sent in asynchronous mode.
+    overflow_policy overflowPolicy; ///< Holds the policy applied when the queue of rows is full.
   public:
     
     /**
@@ -67,12 +89,30 @@ class tcp_recorder : public data_recorder {
      */
     tcp_recorder(const std::string& aFileName);
     
+    /**
+     * Constructor that opens the port aFileName in asynchronous mode.
+     * \param aFileName The port number to listen to, as a string.
+     * \param aMaxQueuedRows The maximum number of rows waiting to be sent.
+     * \param aPolicy The policy applied when the queue of rows waiting to be sent is full.
+     */
+    tcp_recorder(const std::string& aFileName, std::size_t aMaxQueuedRows, overflow_policy aPolicy = drop_oldest);
+    
     /**
      * Destructor, closes the file.
      */
     virtual ~tcp_recorder();
 
     virtual void setFileName(const std::string& aFileName);
+    
+    /**
+     * Returns the number of rows that were discarded because of the overflow policy (asynchronous mode).
+     */
+    std::size_t getDroppedRowCount() const;
+    
+    /**
+     * Returns the number of rows that were sent to clients (asynchronous mode).
+     */
+    std::size_t getSentRowCount() const;
 
     virtual void RK_CALL save(serialization::oarchive& A, unsigned int) const {
       data_recorder::save(A,data_recorder::getStaticObjectType()->TypeVersion());
@@ -95,7 +135,15 @@ class tcp_extractor : public data_extractor {
     virtual bool readNames();
     virtual void setStreamImpl(const shared_ptr<std::istream>& aStreamPtr) { };
     
+    /**
+     * Re-connects to the server after a connection loss, and reads the column names again.
+     * 
+eturn True if the connection was re-established with the same number of columns.
+     */
+    bool reconnect();
+    
     shared_ptr<tcp_client_impl> pimpl;
+    bool autoReconnect; ///< Holds the flag that tells if the connection should be re-established when lost.
   public:
 
     /**
@@ -107,6 +155,13 @@ class tcp_extractor : public data_extractor {
      * Constructor that opens a file with name aFileName.
      */
     tcp_extractor(const std::string& aFileName);
+    
+    /**
+     * Constructor that opens a file with name aFileName.
+     * \param aFileName The address and port of the server, as "ip4_address:port".
+     * \param aAutoReconnect If true, the connection is re-established (for a few seconds) when it is lost.
+     */
+    tcp_extractor(const std::string& aFileName, bool aAutoReconnect);
 
     /**
      * Destructor, closes the file.
@@ -0,0 +1,452 @@
+/*
+ *    Copyright 2013 Sven Mikael Persson
+ *
+ *    THIS SOFTWARE IS DISTRIBUTED UNDER THE TERMS OF THE GNU GENERAL PUBLIC LICENSE v3 (GPLv3).
+ *
+ *    This file is part of ReaK.
+ *
+ *    ReaK is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    (at your option) any later version.
+ *
+ *    ReaK is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with ReaK (as LICENSE in the root folder).
+ *    If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "text_number_format.hpp"
+
+#include <cstring>
+#include <cstdlib>
+
+#include <stdint.h>
+
+namespace ReaK {
+
+namespace recorder {
+
+
+namespace {
+
+/*
+ * This is an implementation of the Grisu2 algorithm from:
+ *   F. Loitsch, "Printing Floating-Point Numbers Quickly and Accurately with Integers", PLDI 2010.
+ * It generates a digit sequence that always reads back to the same double, and that is the
+ * shortest such sequence in the vast majority of cases.
+ */
+
+const uint64_t dp_significand_mask = 0x000FFFFFFFFFFFFFULL;
+const uint64_t dp_exponent_mask    = 0x7FF0000000000000ULL;
+const uint64_t dp_hidden_bit       = 0x0010000000000000ULL;
+const uint64_t dp_sign_mask        = 0x8000000000000000ULL;
+const int dp_significand_size = 52;
+const int dp_exponent_bias = 0x3FF + dp_significand_size;
+const int diy_significand_size = 64;
+
+struct diy_fp {
+  uint64_t f;
+  int e;
+  diy_fp() : f(0), e(0) { };
+  diy_fp(uint64_t aF, int aE) : f(aF), e(aE) { };
+};
+
+uint64_t double_to_bits(double d) {
+  uint64_t u;
+  std::memcpy(&u, &d, sizeof(double));
+  return u;
+};
+
+diy_fp diy_fp_from_double(double d) {
+  uint64_t u = double_to_bits(d);
+  int biased_e = static_cast<int>((u & dp_exponent_mask) >> dp_significand_size);
+  uint64_t significand = (u & dp_significand_mask);
+  if(biased_e != 0)
+    return diy_fp(significand + dp_hidden_bit, biased_e - dp_exponent_bias);
+  else
+    return diy_fp(significand, 1 - dp_exponent_bias);
+};
+
+diy_fp operator-(const diy_fp& a, const diy_fp& b) {
+  return diy_fp(a.f - b.f, a.e);
+};
+
+diy_fp operator*(const diy_fp& a, const diy_fp& b) {
+  const uint64_t M32 = 0xFFFFFFFFULL;
+  const uint64_t ah = a.f >> 32, al = a.f & M32;
+  const uint64_t bh = b.f >> 32, bl = b.f & M32;
+  const uint64_t hh = ah * bh, lh = al * bh, hl = ah * bl, ll = al * bl;
+  uint64_t tmp = (ll >> 32) + (hl & M32) + (lh & M32);
+  tmp += 1ULL << 31; // round to nearest
+  return diy_fp(hh + (hl >> 32) + (lh >> 32) + (tmp >> 32), a.e + b.e + 64);
+};
+
+diy_fp normalize(diy_fp r) {
+  while(!(r.f & 0xFFC0000000000000ULL)) {
+    r.f <<= 10;
+    r.e -= 10;
+  };
+  while(!(r.f & dp_sign_mask)) {
+    r.f <<= 1;
+    --r.e;
+  };
+  return r;
+};
+
+void normalized_boundaries(const diy_fp& v, diy_fp& m_minus, diy_fp& m_plus) {
+  diy_fp pl((v.f << 1) + 1, v.e - 1);
+  while(!(pl.f & (dp_hidden_bit << 1))) {
+    pl.f <<= 1;
+    --pl.e;
+  };
+  pl.f <<= (diy_significand_size - dp_significand_size - 2);
+  pl.e -= (diy_significand_size - dp_significand_size - 2);
+  diy_fp mi = (v.f == dp_hidden_bit) ? diy_fp((v.f << 2) - 1, v.e - 2) : diy_fp((v.f << 1) - 1, v.e - 1);
+  mi.f <<= mi.e - pl.e;
+  mi.e = pl.e;
+  m_minus = mi;
+  m_plus = pl;
+};
+
+// normalized 64-bit approximations of 10^k, for k = -348, -340, ..., 340.
+const uint64_t cached_powers_f[] = {
+  0xfa8fd5a0081c0288ULL, 0xbaaee17fa23ebf76ULL, 0x8b16fb203055ac76ULL,
+  0xcf42894a5dce35eaULL, 0x9a6bb0aa55653b2dULL, 0xe61acf033d1a45dfULL,
+  0xab70fe17c79ac6caULL, 0xff77b1fcbebcdc4fULL, 0xbe5691ef416bd60cULL,
+  0x8dd01fad907ffc3cULL, 0xd3515c2831559a83ULL, 0x9d71ac8fada6c9b5ULL,
+  0xea9c227723ee8bcbULL, 0xaecc49914078536dULL, 0x823c12795db6ce57ULL,
+  0xc21094364dfb5637ULL, 0x9096ea6f3848984fULL, 0xd77485cb25823ac7ULL,
+  0xa086cfcd97bf97f4ULL, 0xef340a98172aace5ULL, 0xb23867fb2a35b28eULL,
+  0x84c8d4dfd2c63f3bULL, 0xc5dd44271ad3cdbaULL, 0x936b9fcebb25c996ULL,
+  0xdbac6c247d62a584ULL, 0xa3ab66580d5fdaf6ULL, 0xf3e2f893dec3f126ULL,
+  0xb5b5ada8aaff80b8ULL, 0x87625f056c7c4a8bULL, 0xc9bcff6034c13053ULL,
+  0x964e858c91ba2655ULL, 0xdff9772470297ebdULL, 0xa6dfbd9fb8e5b88fULL,
+  0xf8a95fcf88747d94ULL, 0xb94470938fa89bcfULL, 0x8a08f0f8bf0f156bULL,
+  0xcdb02555653131b6ULL, 0x993fe2c6d07b7facULL, 0xe45c10c42a2b3b06ULL,
+  0xaa242499697392d3ULL, 0xfd87b5f28300ca0eULL, 0xbce5086492111aebULL,
+  0x8cbccc096f5088ccULL, 0xd1b71758e219652cULL, 0x9c40000000000000ULL,
+  0xe8d4a51000000000ULL, 0xad78ebc5ac620000ULL, 0x813f3978f8940984ULL,
+  0xc097ce7bc90715b3ULL, 0x8f7e32ce7bea5c70ULL, 0xd5d238a4abe98068ULL,
+  0x9f4f2726179a2245ULL, 0xed63a231d4c4fb27ULL, 0xb0de65388cc8ada8ULL,
+  0x83c7088e1aab65dbULL, 0xc45d1df942711d9aULL, 0x924d692ca61be758ULL,
+  0xda01ee641a708deaULL, 0xa26da3999aef774aULL, 0xf209787bb47d6b85ULL,
+  0xb454e4a179dd1877ULL, 0x865b86925b9bc5c2ULL, 0xc83553c5c8965d3dULL,
+  0x952ab45cfa97a0b3ULL, 0xde469fbd99a05fe3ULL, 0xa59bc234db398c25ULL,
+  0xf6c69a72a3989f5cULL, 0xb7dcbf5354e9beceULL, 0x88fcf317f22241e2ULL,
+  0xcc20ce9bd35c78a5ULL, 0x98165af37b2153dfULL, 0xe2a0b5dc971f303aULL,
+  0xa8d9d1535ce3b396ULL, 0xfb9b7cd9a4a7443cULL, 0xbb764c4ca7a44410ULL,
+  0x8bab8eefb6409c1aULL, 0xd01fef10a657842cULL, 0x9b10a4e5e9913129ULL,
+  0xe7109bfba19c0c9dULL, 0xac2820d9623bf429ULL, 0x80444b5e7aa7cf85ULL,
+  0xbf21e44003acdd2dULL, 0x8e679c2f5e44ff8fULL, 0xd433179d9c8cb841ULL,
+  0x9e19db92b4e31ba9ULL, 0xeb96bf6ebadf77d9ULL, 0xaf87023b9bf0ee6bULL
+};
+
+const short cached_powers_e[] = {
+  -1220, -1193, -1166, -1140, -1113, -1087, -1060, -1034, -1007, -980,
+  -954, -927, -901, -874, -847, -821, -794, -768, -741, -715,
+  -688, -661, -635, -608, -582, -555, -529, -502, -475, -449,
+  -422, -396, -369, -343, -316, -289, -263, -236, -210, -183,
+  -157, -130, -103, -77, -50, -24, 3, 30, 56, 83,
+  109, 136, 162, 189, 216, 242, 269, 295, 322, 348,
+  375, 402, 428, 455, 481, 508, 534, 561, 588, 614,
+  641, 667, 694, 720, 747, 774, 800, 827, 853, 880,
+  907, 933, 960, 986, 1013, 1039, 1066
+};
+
+diy_fp get_cached_power(int e, int& K) {
+  // 0.30102999566398114 = log10(2)
+  double dk = (-61 - e) * 0.30102999566398114 + 347;
+  int k = static_cast<int>(dk);
+  if(dk - k > 0.0)
+    ++k;
+  unsigned int index = static_cast<unsigned int>((k >> 3) + 1);
+  K = -(-348 + static_cast<int>(index << 3));
+  return diy_fp(cached_powers_f[index], cached_powers_e[index]);
+};
+
+const uint32_t pow10_u32[] = { 1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000 };
+
+int count_decimal_digits(uint32_t n) {
+  int d = 1;
+  while((d < 10) && (n >= pow10_u32[d]))
+    ++d;
+  return d;
+};
+
+void grisu_round(char* buffer, int len, uint64_t delta, uint64_t rest, uint64_t ten_kappa, uint64_t wp_w) {
+  while((rest < wp_w) && (delta - rest >= ten_kappa) &&
+        ((rest + ten_kappa < wp_w) || (wp_w - rest > rest + ten_kappa - wp_w))) {
+    --buffer[len - 1];
+    rest += ten_kappa;
+  };
+};
+
+void digit_gen(const diy_fp& W, const diy_fp& Mp, uint64_t delta, char* buffer, int& len, int& K) {
+  const diy_fp one(1ULL << -Mp.e, Mp.e);
+  const diy_fp wp_w = Mp - W;
+  uint32_t p1 = static_cast<uint32_t>(Mp.f >> -one.e);
+  uint64_t p2 = Mp.f & (one.f - 1);
+  int kappa = count_decimal_digits(p1);
+  len = 0;
+
+  while(kappa > 0) {
+    uint32_t d = p1 / pow10_u32[kappa - 1];
+    p1 %= pow10_u32[kappa - 1];
+    if(d || len)
+      buffer[len++] = static_cast<char>('0' + d);
+    --kappa;
+    uint64_t tmp = (static_cast<uint64_t>(p1) << -one.e) + p2;
+    if(tmp <= delta) {
+      K += kappa;
+      grisu_round(buffer, len, delta, tmp, static_cast<uint64_t>(pow10_u32[kappa]) << -one.e, wp_w.f);
+      return;
+    };
+  };
+
+  for(;;) {
+    p2 *= 10;
+    delta *= 10;
+    char d = static_cast<char>(p2 >> -one.e);
+    if(d || len)
+      buffer[len++] = static_cast<char>('0' + d);
+    p2 &= one.f - 1;
+    --kappa;
+    if(p2 < delta) {
+      K += kappa;
+      int index = -kappa;
+      grisu_round(buffer, len, delta, p2, one.f, wp_w.f * (index < 10 ? pow10_u32[index] : 0));
+      return;
+    };
+  };
+};
+
+// generates the digits of a positive, finite and non-zero value, such that value = digits * 10^K.
+void grisu2(double value, char* buffer, int& len, int& K) {
+  const diy_fp v = diy_fp_from_double(value);
+  diy_fp w_m, w_p;
+  normalized_boundaries(v, w_m, w_p);
+
+  const diy_fp c_mk = get_cached_power(w_p.e, K);
+  const diy_fp W = normalize(v) * c_mk;
+  diy_fp Wp = w_p * c_mk;
+  diy_fp Wm = w_m * c_mk;
+  ++Wm.f;
+  --Wp.f;
+  digit_gen(W, Wp, Wp.f - Wm.f, buffer, len, K);
+};
+
+char* write_exponent(int K, char* out) {
+  if(K < 0) {
+    *out++ = '-';
+    K = -K;
+  } else
+    *out++ = '+';
+  if(K >= 100) {
+    *out++ = static_cast<char>('0' + K / 100);
+    K %= 100;
+  };
+  *out++ = static_cast<char>('0' + K / 10);
+  *out++ = static_cast<char>('0' + K % 10);
+  return out;
+};
+
+// lays out the digits (value = digits * 10^k) in fixed or scientific notation.
+char* prettify(const char* digits, int length, int k, char* out) {
+  const int kk = length + k; // 10^(kk-1) <= value < 10^kk
+  if((length <= kk) && (kk <= 21)) {
+    // integer: dddd000
+    std::memcpy(out, digits, length);
+    out += length;
+    for(int i = length; i < kk; ++i)
+      *out++ = '0';
+  } else if((0 < kk) && (kk <= 21)) {
+    // dd.ddd
+    std::memcpy(out, digits, kk);
+    out += kk;
+    *out++ = '.';
+    std::memcpy(out, digits + kk, length - kk);
+    out += length - kk;
+  } else if((-6 < kk) && (kk <= 0)) {
+    // 0.000ddd
+    *out++ = '0';
+    *out++ = '.';
+    for(int i = kk; i < 0; ++i)
+      *out++ = '0';
+    std::memcpy(out, digits, length);
+    out += length;
+  } else {
+    // d.ddde+XX
+    *out++ = digits[0];
+    if(length > 1) {
+      *out++ = '.';
+      std::memcpy(out, digits + 1, length - 1);
+      out += length - 1;
+    };
+    *out++ = 'e';
+    out = write_exponent(kk - 1, out);
+  };
+  return out;
+};
+
+// exactly representable powers of ten.
+const double exact_pow10[] = {
+  1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+  1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+inline bool is_blank(char c) {
+  return (c == ' ') || (c == '\t') || (c == '\r');
+};
+
+inline bool is_digit(char c) {
+  return static_cast<unsigned int>(c - '0') < 10;
+};
+
+inline bool is_delimiter(char c) {
+  return is_blank(c) || (c == '\n');
+};
+
+};
+
+
+char* format_double(double value, char* first) {
+  const uint64_t u = double_to_bits(value);
+  if((u & dp_exponent_mask) == dp_exponent_mask) {
+    if(u & dp_significand_mask) {
+      std::memcpy(first, "nan", 3);
+      return first + 3;
+    };
+    if(u & dp_sign_mask)
+      *first++ = '-';
+    std::memcpy(first, "inf", 3);
+    return first + 3;
+  };
+  if(u & dp_sign_mask) {
+    *first++ = '-';
+    value = -value;
+  };
+  if(value == 0.0) {
+    *first++ = '0';
+    return first;
+  };
+  char digits[20];
+  int length = 0;
+  int K = 0;
+  grisu2(value, digits, length, K);
+  return prettify(digits, length, K, first);
+};
+
+
+const char* parse_double(const char* input, const char* last, double& value) {
+  const char* first = input;
+  while((first != last) && is_blank(*first))
+    ++first;
+  const char* p = first;
+  bool negative = false;
+  if((p != last) && ((*p == '-') || (*p == '+'))) {
+    negative = (*p == '-');
+    ++p;
+  };
+
+  uint64_t mantissa = 0;
+  int sig_digits = 0;
+  int exp10 = 0;
+  bool has_digits = false;
+  bool truncated = false;
+  for(; (p != last) && is_digit(*p); ++p) {
+    has_digits = true;
+    if(sig_digits < 19) {
+      mantissa = mantissa * 10 + static_cast<unsigned int>(*p - '0');
+      if(mantissa)
+        ++sig_digits;
+    } else {
+      ++exp10;
+      truncated = truncated || (*p != '0');
+    };
+  };
+  if((p != last) && (*p == '.')) {
+    for(++p; (p != last) && is_digit(*p); ++p) {
+      has_digits = true;
+      if(sig_digits < 19) {
+        mantissa = mantissa * 10 + static_cast<unsigned int>(*p - '0');
+        if(mantissa)
+          ++sig_digits;
+        --exp10;
+      } else
+        truncated = truncated || (*p != '0');
+    };
+  };
+  if(has_digits && (p != last) && ((*p == 'e') || (*p == 'E'))) {
+    const char* q = p + 1;
+    bool exp_negative = false;
+    if((q != last) && ((*q == '-') || (*q == '+'))) {
+      exp_negative = (*q == '-');
+      ++q;
+    };
+    if((q != last) && is_digit(*q)) {
+      int e = 0;
+      for(; (q != last) && is_digit(*q); ++q)
+        if(e < 10000)
+          e = e * 10 + (*q - '0');
+      exp10 += (exp_negative ? -e : e);
+      p = q;
+    };
+  };
+
+  if(has_digits && !truncated && ((p == last) || is_delimiter(*p)) &&
+     (mantissa <= (1ULL << 53)) && (exp10 >= -22) && (exp10 <= 22)) {
+    // both the mantissa and the power of ten are exact doubles, a single rounding occurs.
+    double result = static_cast<double>(mantissa);
+    if(exp10 < 0)
+      result /= exact_pow10[-exp10];
+    else
+      result *= exact_pow10[exp10];
+    value = (negative ? -result : result);
+    return p;
+  };
+
+  // slow path: hand over the token to the C library (long mantissas, large exponents, inf, nan).
+  const char* token_end = first;
+  while((token_end != last) && !is_delimiter(*token_end))
+    ++token_end;
+  char token[64];
+  std::size_t token_size = token_end - first;
+  if((token_size == 0) || (token_size >= sizeof(token)))
+    return input;
+  std::memcpy(token, first, token_size);
+  token[token_size] = '\0';
+  char* parse_end = token;
+  double result = std::strtod(token, &parse_end);
+  if(parse_end == token)
+    return input;
+  value = result;
+  return first + (parse_end - token);
+};
+
+
+void append_text_rows(std::queue<double>& values, unsigned int rowCount, unsigned int colCount,
+                      char separator, std::vector<char>& buffer) {
+  std::size_t pos = buffer.size();
+  buffer.resize(pos + rowCount * (colCount * (max_formatted_double_size + 1) + 1));
+  for(unsigned int i = 0; i < rowCount; ++i) {
+    buffer[pos++] = '\n';
+    for(unsigned int j = 0; j < colCount; ++j) {
+      if(j != 0)
+        buffer[pos++] = separator;
+      pos = format_double(values.front(), &buffer[pos]) - &buffer[0];
+      values.pop();
+    };
+  };
+  buffer.resize(pos);
+};
+
+
+};
+
+};
+
@@ -0,0 +1,91 @@
+/**
+ * \file text_number_format.hpp
+ *
+ * This library declares the functions used by the text-based data recorders (ssv, tsv) to format
+ * and parse floating-point values without going through the iostream formatting facilities.
+ * The formatter produces the shortest (or nearly shortest) decimal representation that reads
+ * back to the exact same double value (Grisu2 algorithm), and the parser takes an exact
+ * fast-path for short mantissas and moderate exponents (which covers most recorded data),
+ * relying on the C library's strtod for the rest.
+ *
+ * \author Sven Mikael Persson <mikael.s.persson@gmail.com>
+ * \date June 2013
+ */
+
+/*
+ *    Copyright 2013 Sven Mikael Persson
+ *
+ *    THIS SOFTWARE IS DISTRIBUTED UNDER THE TERMS OF THE GNU GENERAL PUBLIC LICENSE v3 (GPLv3).
+ *
+ *    This file is part of ReaK.
+ *
+ *    ReaK is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    (at your option) any later version.
+ *
+ *    ReaK is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with ReaK (as LICENSE in the root folder).
+ *    If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TEXT_NUMBER_FORMAT_HPP
+#define TEXT_NUMBER_FORMAT_HPP
+
+#include <vector>
+#include <queue>
+
+namespace ReaK {
+
+namespace recorder {
+
+
+/// The maximum number of characters that format_double() can write.
+const unsigned int max_formatted_double_size = 32;
+
+/**
+ * This function writes the shortest decimal representation of a double value that reads back to
+ * the same value, e.g., "0.5", "-12", "3.0000000000000004" or "1.5e-07". Infinities and NaNs are
+ * written as "inf", "-inf" and "nan".
+ * \param value The value to format.
+ * \param first The beginning of the output character buffer, which must have room for
+ *              at least max_formatted_double_size characters.
+ * \return The end of the written characters (no null-character is written).
+ */
+char* format_double(double value, char* first);
+
+/**
+ * This function parses a double value from a range of characters, skipping leading blanks
+ * (spaces, tabs and carriage-returns). Values that have at most 19 significant digits
+ * and a decimal exponent within [-22,22] are parsed exactly without calling the C library.
+ * \param first The beginning of the character range.
+ * \param last The end of the character range.
+ * \param value The parsed value (unchanged on failure).
+ * \return The end of the parsed characters, or the input 'first' if no value could be parsed.
+ */
+const char* parse_double(const char* first, const char* last, double& value);
+
+/**
+ * This function appends rows of buffered values to a text buffer, each row starting with a
+ * new-line and its values being delimited by the given separator.
+ * \param values The queue of buffered values, from which rowCount * colCount values are popped.
+ * \param rowCount The number of rows to format.
+ * \param colCount The number of values per row.
+ * \param separator The separator character between the values of a row.
+ * \param buffer The text buffer to which the rows are appended.
+ */
+void append_text_rows(std::queue<double>& values, unsigned int rowCount, unsigned int colCount,
+                      char separator, std::vector<char>& buffer);
+
+
+};
+
+};
+
+#endif
+
@@ -23,6 +23,8 @@
 
 #include "tsv_recorder.hpp"
 
+#include "text_number_format.hpp"
+
 namespace ReaK {
 
 namespace recorder {
@@ -30,14 +32,11 @@ namespace recorder {
 void tsv_recorder::writeRow() {
   ReaKaux::unique_lock< ReaKaux::mutex > lock_here(access_mutex);
   if((out_stream) && (*out_stream) && (rowCount > 0) && (colCount > 0)) {
-    (*out_stream) << std::endl;
-    (*out_stream) << values_rm.front();
-    values_rm.pop();
-    for(unsigned int i=1;i<colCount;++i) {
-      (*out_stream) << "\t" << values_rm.front();
-      values_rm.pop();
-    };
-    --rowCount;
+    row_buffer.clear();
+    append_text_rows(values_rm, rowCount, colCount, '\t', row_buffer);
+    rowCount = 0;
+    out_stream->write(&row_buffer[0], row_buffer.size());
+    out_stream->flush();
   };
 };
 
@@ -53,24 +52,6 @@ void tsv_recorder::writeNames() {
 };
 
 
-bool tsv_extractor::readRow() {
-  ReaKaux::unique_lock< ReaKaux::mutex > lock_here(access_mutex);
-  if((in_stream) && (*in_stream) && (colCount > 0)) {
-    std::string temp;
-    std::getline(*in_stream, temp, '\n');
-    std::stringstream ss(temp);
-    for(unsigned int i = 0; i < colCount; ++i) {
-      double tmp = 0;
-      ss >> tmp;
-      if(!ss)
-        return false;
-      values_rm.push(tmp);
-    };
-  };
-  return true;
-};
-
-
 };
 
 };
@@ -83,8 +83,6 @@ class tsv_recorder : public ssv_recorder {
  * This class handles file IO operations for a tab-separated-values data extractor.
  */
 class tsv_extractor : public ssv_extractor {
-  protected:
-    virtual bool readRow();
   public:
 
     /**
@@ -25,8 +25,15 @@
 #include "tsv_recorder.hpp"
 #include "bin_recorder.hpp"
 #include "tcp_recorder.hpp"
+#ifdef REAK_HAS_SHM_RECORDER
+#include "shm_recorder.hpp"
+#endif
+#include "text_number_format.hpp"
 
 #include <sstream>
+#include <cmath>
+#include <cstring>
+#include <limits>
 
 #include "base/chrono_incl.hpp"
 
@@ -77,6 +84,9 @@ BOOST_AUTO_TEST_CASE( ssv_record_extract_test )
         BOOST_CHECK_CLOSE( v3, (x*x), 1e-6 );
         BOOST_CHECK_NO_THROW( input_rec >> data_extractor::end_value_row );
       };
+      double v;
+      BOOST_CHECK_THROW( input_rec >> v, end_of_record );
+      BOOST_CHECK_THROW( input_rec >> v, end_of_record );
       BOOST_CHECK_NO_THROW( input_rec >> data_extractor::close );
     };
     
@@ -124,6 +134,9 @@ BOOST_AUTO_TEST_CASE( tsv_record_extract_test )
         BOOST_CHECK_CLOSE( v3, (x*x), 1e-6 );
         BOOST_CHECK_NO_THROW( input_rec >> data_extractor::end_value_row );
       };
+      double v;
+      BOOST_CHECK_THROW( input_rec >> v, end_of_record );
+      BOOST_CHECK_THROW( input_rec >> v, end_of_record );
       BOOST_CHECK_NO_THROW( input_rec >> data_extractor::close );
     };
     
@@ -171,6 +184,9 @@ BOOST_AUTO_TEST_CASE( bin_record_extract_test )
         BOOST_CHECK_CLOSE( v3, (x*x), 1e-6 );
         BOOST_CHECK_NO_THROW( input_rec >> data_extractor::end_value_row );
       };
+      double v;
+      BOOST_CHECK_THROW( input_rec >> v, end_of_record );
+      BOOST_CHECK_THROW( input_rec >> v, end_of_record );
       BOOST_CHECK_NO_THROW( input_rec >> data_extractor::close );
     };
     
@@ -179,6 +195,130 @@ BOOST_AUTO_TEST_CASE( bin_record_extract_test )
 };
 
 
+BOOST_AUTO_TEST_CASE( text_number_format_test )
+{
+  using namespace ReaK;
+  using namespace recorder;
+  
+  const double special_values[] = { 0.0, 1.0, -1.0, 0.5, 0.1, 1.0 / 3.0, 100.25, 1e21, 1e22, 1e-7, 1.5e-6,
+    123456789012345678.0, std::numeric_limits<double>::min(), std::numeric_limits<double>::max(),
+    std::numeric_limits<double>::denorm_min(), std::numeric_limits<double>::epsilon() };
+  char buf[max_formatted_double_size + 1];
+  for(std::size_t i = 0; i < sizeof(special_values) / sizeof(double); ++i) {
+    char* buf_end = format_double(special_values[i], buf);
+    BOOST_CHECK( buf_end - buf <= int(max_formatted_double_size) );
+    double v = 0.0;
+    BOOST_CHECK( parse_double(buf, buf_end, v) == buf_end );
+    BOOST_CHECK_EQUAL( v, special_values[i] );
+  };
+  
+  // round-trip of pseudo-random bit patterns (linear congruential generator).
+  unsigned long long seed = 42;
+  for(unsigned int i = 0; i < 100000; ++i) {
+    seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+    double x;
+    std::memcpy(&x, &seed, sizeof(double));
+    if(x != x)
+      continue;
+    char* buf_end = format_double(x, buf);
+    double v = 0.0;
+    parse_double(buf, buf_end, v);
+    BOOST_CHECK_EQUAL( v, x );
+  };
+  
+  const char row[] = "  1.25\t-3e2 inf 0.000123  12345678901234567890123\r";
+  const char* it = row;
+  const char* it_end = row + sizeof(row) - 1;
+  double v = 0.0;
+  it = parse_double(it, it_end, v);  BOOST_CHECK_EQUAL( v, 1.25 );
+  it = parse_double(it, it_end, v);  BOOST_CHECK_EQUAL( v, -300.0 );
+  it = parse_double(it, it_end, v);  BOOST_CHECK_EQUAL( v, std::numeric_limits<double>::infinity() );
+  it = parse_double(it, it_end, v);  BOOST_CHECK_EQUAL( v, 0.000123 );
+  it = parse_double(it, it_end, v);  BOOST_CHECK_EQUAL( v, 12345678901234567890123.0 );
+  BOOST_CHECK( parse_double(it, it_end, v) == it );
+  
+};
+
+
+BOOST_AUTO_TEST_CASE( text_format_benchmark_test )
+{
+  using namespace ReaK;
+  using namespace recorder;
+  using namespace ReaKaux::chrono;
+  
+  const unsigned int row_count = 2000;
+  const unsigned int col_count = 100;
+  std::vector<double> data(row_count * col_count);
+  for(std::size_t i = 0; i < data.size(); ++i)
+    data[i] = std::sin(0.001 * i) * double(i % 1000) + 1e-3 * double(i);
+  
+  // previous path: iostream formatting of each value, scientific with 11 digits.
+  high_resolution_clock::time_point t0 = high_resolution_clock::now();
+  std::stringstream ss_old;
+  ss_old.setf(std::ios::scientific, std::ios::floatfield);
+  ss_old.precision(11);
+  for(unsigned int i = 0; i < row_count; ++i) {
+    ss_old << std::endl << data[i * col_count];
+    for(unsigned int j = 1; j < col_count; ++j)
+      ss_old << " " << data[i * col_count + j];
+  };
+  high_resolution_clock::time_point t1 = high_resolution_clock::now();
+  
+  // new path: shortest round-trip formatting into a row buffer.
+  std::queue<double> values;
+  for(std::size_t i = 0; i < data.size(); ++i)
+    values.push(data[i]);
+  high_resolution_clock::time_point t2 = high_resolution_clock::now();
+  std::vector<char> buffer;
+  append_text_rows(values, row_count, col_count, ' ', buffer);
+  std::stringstream ss_new;
+  ss_new.write(&buffer[0], buffer.size());
+  high_resolution_clock::time_point t3 = high_resolution_clock::now();
+  
+  // previous parsing path: string-stream extraction.
+  std::string line;
+  std::getline(ss_old, line, '\n');
+  std::vector<double> parsed_old;
+  parsed_old.reserve(data.size());
+  high_resolution_clock::time_point t4 = high_resolution_clock::now();
+  while(std::getline(ss_old, line, '\n')) {
+    std::stringstream ss(line);
+    double tmp;
+    while(ss >> tmp)
+      parsed_old.push_back(tmp);
+  };
+  high_resolution_clock::time_point t5 = high_resolution_clock::now();
+  
+  std::getline(ss_new, line, '\n');
+  std::vector<double> parsed_new;
+  parsed_new.reserve(data.size());
+  high_resolution_clock::time_point t6 = high_resolution_clock::now();
+  while(std::getline(ss_new, line, '\n')) {
+    const char* it = line.data();
+    const char* it_end = it + line.size();
+    double tmp;
+    for(const char* it_next = parse_double(it, it_end, tmp); it_next != it; it_next = parse_double(it, it_end, tmp)) {
+      parsed_new.push_back(tmp);
+      it = it_next;
+    };
+  };
+  high_resolution_clock::time_point t7 = high_resolution_clock::now();
+  
+  BOOST_CHECK_EQUAL( parsed_old.size(), data.size() );
+  BOOST_REQUIRE_EQUAL( parsed_new.size(), data.size() );
+  for(std::size_t i = 0; i < data.size(); ++i)
+    BOOST_CHECK_EQUAL( parsed_new[i], data[i] );
+  
+  BOOST_TEST_MESSAGE( "Formatting " << data.size() << " values: iostream " 
+                      << duration_cast<microseconds>(t1 - t0).count() << " us, row buffer " 
+                      << duration_cast<microseconds>(t3 - t2).count() << " us" );
+  BOOST_TEST_MESSAGE( "Parsing " << data.size() << " values: iostream " 
+                      << duration_cast<microseconds>(t5 - t4).count() << " us, parse_double " 
+                      << duration_cast<microseconds>(t7 - t6).count() << " us" );
+  
+};
+
+
 struct server_runner {
   bool* succeeded;
   unsigned int* num_points;
@@ -249,17 +389,283 @@ BOOST_AUTO_TEST_CASE( tcp_record_extract_test )
 };
 
 
+struct async_server_runner {
+  bool* succeeded;
+  unsigned int row_count;
+  async_server_runner(bool* aSucceeded, unsigned int aRowCount) : succeeded(aSucceeded), row_count(aRowCount) { };
+  
+  void operator()() {
+    
+    using namespace ReaK;
+    using namespace recorder;
+    using namespace ReaKaux::chrono;
+    
+    try {
+      tcp_recorder output_rec("17018", 100000, tcp_recorder::block_writer);
+      output_rec << "t" << "i";
+      for(unsigned int j = 2; j < 10; ++j)
+        output_rec << "x";
+      output_rec << data_recorder::end_name_row;
+      
+      for(unsigned int i = 0; i < row_count; ++i) {
+        output_rec << double(duration_cast<microseconds>(high_resolution_clock::now().time_since_epoch()).count()) << double(i);
+        for(unsigned int j = 2; j < 10; ++j)
+          output_rec << double(i * j);
+        output_rec << data_recorder::end_value_row;
+      };
+      output_rec << data_recorder::flush;
+    } catch(...) {
+      *succeeded = false;
+      return;
+    };
+    
+    *succeeded = true;
+  };  
+  
+};
 
 
+BOOST_AUTO_TEST_CASE( tcp_async_record_extract_test )
+{
+  using namespace ReaK;
+  using namespace recorder;
+  using namespace ReaKaux::chrono;
+  
+  const unsigned int row_count = 20000;
+  bool server_worked = false;
+  async_server_runner srv(&server_worked, row_count);
+  ReaKaux::thread server_thd( srv );
+  
+  ReaKaux::this_thread::sleep_for(ReaKaux::chrono::milliseconds(10));
+  
+  high_resolution_clock::time_point t0 = high_resolution_clock::now();
+  tcp_extractor input_rec("127.0.0.1:17018");
+  BOOST_CHECK_EQUAL( input_rec.getColCount(), 10 );
+  
+  double total_latency = 0.0;
+  bool all_good = true;
+  for(unsigned int i = 0; i < row_count; ++i) {
+    double t_sent, v;
+    input_rec >> t_sent >> v;
+    all_good = all_good && (v == double(i));
+    for(unsigned int j = 2; j < 10; ++j) {
+      input_rec >> v;
+      all_good = all_good && (v == double(i * j));
+    };
+    input_rec >> data_extractor::end_value_row;
+    total_latency += double(duration_cast<microseconds>(high_resolution_clock::now().time_since_epoch()).count()) - t_sent;
+  };
+  high_resolution_clock::time_point t1 = high_resolution_clock::now();
+  BOOST_CHECK( all_good );
+  
+  BOOST_CHECK_NO_THROW( server_thd.join() );
+  BOOST_CHECK( server_worked );
+  
+  BOOST_TEST_MESSAGE( "Asynchronous tcp loopback: " << row_count << " rows of 10 values in " 
+                      << duration_cast<microseconds>(t1 - t0).count() << " us, mean latency " 
+                      << (total_latency / row_count) << " us" );
+  
+};
 
 
+BOOST_AUTO_TEST_CASE( tcp_async_reconnect_test )
+{
+  using namespace ReaK;
+  using namespace recorder;
+  
+  tcp_recorder output_rec("17019", 1000, tcp_recorder::drop_oldest);
+  output_rec << "x" << "2*x" << data_recorder::end_name_row;
+  
+  for(unsigned int k = 0; k < 2; ++k) {
+    // each client must receive the column names, then consistent rows.
+    tcp_extractor input_rec("127.0.0.1:17019");
+    BOOST_CHECK_EQUAL( input_rec.getColCount(), 2 );
+    std::string s1, s2;
+    input_rec >> s1 >> s2;
+    BOOST_CHECK( s2 == "2*x" );
+    for(unsigned int i = 0; i < 10; ++i)
+      output_rec << double(i) << double(2 * i) << data_recorder::end_value_row;
+    output_rec << data_recorder::flush;
+    for(unsigned int i = 0; i < 5; ++i) {
+      double v1, v2;
+      BOOST_CHECK_NO_THROW( input_rec >> v1 >> v2 );
+      BOOST_CHECK_EQUAL( v2, 2.0 * v1 );
+      input_rec >> data_extractor::end_value_row;
+    };
+  };
+  
+  // with a small queue and no client, the oldest rows are dropped instead of blocking.
+  for(unsigned int i = 0; i < 5000; ++i)
+    output_rec << double(i) << double(2 * i) << data_recorder::end_value_row;
+  output_rec << data_recorder::flush;
+  BOOST_CHECK( output_rec.getDroppedRowCount() > 0 );
+  
+};
 
 
+struct blocking_server_runner {
+  bool* finished;
+  explicit blocking_server_runner(bool* aFinished) : finished(aFinished) { };
+  
+  void operator()() {
+    
+    using namespace ReaK;
+    using namespace recorder;
+    
+    {
+      // no client ever connects, neither the writes nor the destructor may wait forever.
+      tcp_recorder output_rec("17020", 100, tcp_recorder::block_writer);
+      output_rec << "x" << "2*x" << data_recorder::end_name_row;
+      for(unsigned int i = 0; i < 5000; ++i)
+        output_rec << double(i) << double(2 * i) << data_recorder::end_value_row;
+      output_rec << data_recorder::flush;
+      for(unsigned int i = 0; i < 500; ++i)
+        output_rec << double(i) << double(2 * i) << data_recorder::end_value_row;
+    };
+    *finished = true;
+  };
+  
+};
 
 
+BOOST_AUTO_TEST_CASE( tcp_async_block_without_client_test )
+{
+  using namespace ReaK;
+  
+  bool finished = false;
+  blocking_server_runner srv(&finished);
+  ReaKaux::thread server_thd( srv );
+  
+  // the destructor waits up to 2 seconds for a client.
+  for(unsigned int i = 0; (i < 100) && !finished; ++i)
+    ReaKaux::this_thread::sleep_for(ReaKaux::chrono::milliseconds(100));
+  BOOST_CHECK( finished );
+  if(finished)
+    server_thd.join();
+  else
+    server_thd.detach();
+  
+};
+
+
+#ifdef REAK_HAS_SHM_RECORDER
+
+BOOST_AUTO_TEST_CASE( shm_record_extract_test )
+{
+  using namespace ReaK;
+  using namespace recorder;
+  
+  shared_ptr<shm_recorder> output_rec(new shm_recorder("reak_unit_test_shm_1"));
+  BOOST_CHECK_NO_THROW( *output_rec << "x" << "2*x" << "x^2" << data_recorder::end_name_row );
+  for(double x = 0; x < 10.1; x += 0.5)
+    BOOST_CHECK_NO_THROW( *output_rec << x << 2*x << x*x << data_recorder::end_value_row );
+  BOOST_CHECK_NO_THROW( *output_rec << data_recorder::flush );
+  BOOST_CHECK_EQUAL( output_rec->getPublishedRowCount(), 21 );
+  
+  shm_extractor input_rec("reak_unit_test_shm_1");
+  
+  BOOST_CHECK_EQUAL( input_rec.getColCount(), 3 );
+  std::string s1, s2, s3;
+  BOOST_CHECK_NO_THROW( input_rec >> s1 >> s2 >> s3 );
+  BOOST_CHECK( s1 == "x" );
+  BOOST_CHECK( s2 == "2*x" );
+  BOOST_CHECK( s3 == "x^2" );
+  
+  // the recorder is removed before all the rows are read, they remain readable.
+  output_rec.reset();
+  for(double x = 0; x < 10.1; x += 0.5) {
+    double v1, v2, v3;
+    BOOST_CHECK_NO_THROW( input_rec >> v1 >> v2 >> v3 );
+    BOOST_CHECK_CLOSE( v1, x, 1e-6 );
+    BOOST_CHECK_CLOSE( v2, (2.0*x), 1e-6 );
+    BOOST_CHECK_CLOSE( v3, (x*x), 1e-6 );
+    BOOST_CHECK_NO_THROW( input_rec >> data_extractor::end_value_row );
+  };
+  double v;
+  BOOST_CHECK_THROW( input_rec >> v, end_of_record );
+  BOOST_CHECK_EQUAL( input_rec.getDroppedRowCount(), 0 );
+  
+};
+
 
+struct shm_reader_runner {
+  ReaK::recorder::shm_extractor* input_rec;
+  unsigned int* rows_read;
+  bool* consistent;
+  shm_reader_runner(ReaK::recorder::shm_extractor* aInputRec, unsigned int* aRowsRead, bool* aConsistent) : 
+                    input_rec(aInputRec), rows_read(aRowsRead), consistent(aConsistent) { };
+  
+  void operator()() {
+    
+    using namespace ReaK;
+    using namespace recorder;
+    
+    double last_i = -1.0;
+    try {
+      while(true) {
+        double i, v;
+        (*input_rec) >> i >> v >> data_extractor::end_value_row;
+        // rows can be skipped (dropped), but never torn or out-of-order.
+        if((v != 2.0 * i) || (i <= last_i))
+          *consistent = false;
+        last_i = i;
+        ++(*rows_read);
+      };
+    } catch(end_of_record&) { 
+    } catch(...) {
+      *consistent = false;
+    };
+  };
+  
+};
 
 
+BOOST_AUTO_TEST_CASE( shm_many_readers_test )
+{
+  using namespace ReaK;
+  using namespace recorder;
+  using namespace ReaKaux::chrono;
+  
+  const unsigned int row_count = 200000;
+  
+  shared_ptr<shm_recorder> output_rec(new shm_recorder("reak_unit_test_shm_2", 256));
+  *output_rec << "i" << "2*i" << data_recorder::end_name_row;
+  
+  shm_extractor input_rec1("reak_unit_test_shm_2");
+  shm_extractor input_rec2("reak_unit_test_shm_2");
+  BOOST_CHECK_EQUAL( input_rec1.getColCount(), 2 );
+  BOOST_CHECK_EQUAL( input_rec2.getColCount(), 2 );
+  std::string s1, s2;
+  input_rec1 >> s1 >> s2;
+  input_rec2 >> s1 >> s2;
+  
+  unsigned int rows_read1 = 0, rows_read2 = 0;
+  bool consistent1 = true, consistent2 = true;
+  ReaKaux::thread reader1( shm_reader_runner(&input_rec1, &rows_read1, &consistent1) );
+  ReaKaux::thread reader2( shm_reader_runner(&input_rec2, &rows_read2, &consistent2) );
+  
+  // the recorder never waits for the readers, even with a small ring.
+  high_resolution_clock::time_point t0 = high_resolution_clock::now();
+  for(unsigned int i = 0; i < row_count; ++i)
+    *output_rec << double(i) << double(2 * i) << data_recorder::end_value_row;
+  *output_rec << data_recorder::flush;
+  high_resolution_clock::time_point t1 = high_resolution_clock::now();
+  BOOST_CHECK_EQUAL( output_rec->getPublishedRowCount(), row_count );
+  output_rec.reset();
+  
+  BOOST_CHECK_NO_THROW( reader1.join() );
+  BOOST_CHECK_NO_THROW( reader2.join() );
+  BOOST_CHECK( consistent1 );
+  BOOST_CHECK( consistent2 );
+  BOOST_CHECK_EQUAL( rows_read1 + input_rec1.getDroppedRowCount(), row_count );
+  BOOST_CHECK_EQUAL( rows_read2 + input_rec2.getDroppedRowCount(), row_count );
+  
+  BOOST_TEST_MESSAGE( "Published " << row_count << " rows in " 
+                      << duration_cast<microseconds>(t1 - t0).count() << " us, readers received " 
+                      << rows_read1 << " and " << rows_read2 << " rows" );
+  
+};
 
+#endif
 
 
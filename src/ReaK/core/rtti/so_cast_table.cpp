@@ -0,0 +1,71 @@
+
+/*
+ *    Copyright 2013 Sven Mikael Persson
+ *
+ *    THIS SOFTWARE IS DISTRIBUTED UNDER THE TERMS OF THE GNU GENERAL PUBLIC LICENSE v3 (GPLv3).
+ *
+ *    This file is part of ReaK.
+ *
+ *    ReaK is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    (at your option) any later version.
+ *
+ *    ReaK is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with ReaK (as LICENSE in the root folder).
+ *    If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "so_cast_table.hpp"
+
+namespace ReaK {
+
+namespace rtti {
+
+namespace detail {
+
+
+int cast_table::find_index(const unsigned int* aTypeID) const {
+  for(std::size_t i = 0; i < entries.size(); ++i)
+    if(equal_type_id(entries[i].type_id, aTypeID))
+      return int(i);
+  return -1;
+};
+
+void cast_table::add_entry(const unsigned int* aTypeID, std::ptrdiff_t aOffset, int aViaBase, bool aBaseLookup) {
+  if(find_index(aTypeID) >= 0)
+    return;
+  entry e;
+  e.type_id = aTypeID;
+  e.offset = aOffset;
+  e.via_base = aViaBase;
+  e.base_lookup = aBaseLookup;
+  entries.push_back(e);
+};
+
+void cast_table::finalize() {
+  // keep the load factor at or below one half, such that the probe sequences are short.
+  std::size_t capacity = 4;
+  while(capacity < 2 * entries.size())
+    capacity *= 2;
+  slots.assign(capacity, -1);
+  for(std::size_t i = 0; i < entries.size(); ++i) {
+    std::size_t j = hash_type_id(entries[i].type_id) & (capacity - 1);
+    while(slots[j] >= 0)
+      j = (j + 1) & (capacity - 1);
+    slots[j] = int(i);
+  };
+};
+
+
+};
+
+};
+
+};
+
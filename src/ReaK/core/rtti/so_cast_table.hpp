@@ -0,0 +1,263 @@
+/**
+ * \file so_cast_table.hpp
+ *
+ * This library declares the cast tables used by the ReaK::rtti system to perform the dynamic
+ * casts of typed_object pointers (castTo and rk_dynamic_ptr_cast). Each registered class has
+ * a table (built once, on its first cast) which associates the type-ID of each of its ancestors
+ * (including itself) to the offset of the pointer to that ancestor, such that a cast is a single
+ * hash-table lookup instead of a walk through the inheritance graph with shared-pointer copies.
+ * Ancestors reached through virtual inheritance have no fixed offset, and casting to them goes
+ * through the (virtual) base, that is, a cast to the direct base that leads to them, followed by
+ * a fixed offset or, if there is more than one virtual base on the way, a look up in its cast table.
+ *
+ * \author Sven Mikael Persson <mikael.s.persson@gmail.com>
+ * \date June 2013
+ */
+
+/*
+ *    Copyright 2013 Sven Mikael Persson
+ *
+ *    THIS SOFTWARE IS DISTRIBUTED UNDER THE TERMS OF THE GNU GENERAL PUBLIC LICENSE v3 (GPLv3).
+ *
+ *    This file is part of ReaK.
+ *
+ *    ReaK is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    (at your option) any later version.
+ *
+ *    ReaK is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with ReaK (as LICENSE in the root folder).
+ *    If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef REAK_SO_CAST_TABLE_HPP
+#define REAK_SO_CAST_TABLE_HPP
+
+#include "base/defs.hpp"
+
+#include "so_register_type.hpp"
+
+#include <vector>
+#include <cstddef>
+
+namespace ReaK {
+
+namespace rtti {
+
+
+/**
+ * This function returns the (zero-terminated) type-ID array of the type T, i.e., the same
+ * type-ID that the so_type of T holds, but without going through the type registry. This is the
+ * preferred argument to castTo (e.g., obj.castTo(rtti::get_type_id_array<T>())).
+ */
+template <typename T>
+const unsigned int* get_type_id_array() {
+  struct id_array {
+    std::vector<unsigned int> ids;
+    id_array() : ids(detail::type_id_count< typename get_type_info<T>::type >::value) {
+      for(unsigned int i = 0; i < ids.size(); ++i)
+        ids[i] = detail::get_type_id< typename get_type_info<T>::type >().at(i);
+    };
+  };
+  static const id_array result;
+  return &(result.ids[0]);
+};
+
+
+
+namespace detail {
+
+
+/**
+ * This class is a cast table of a class, which maps the type-IDs of its ancestors to the pointer
+ * offset to apply to obtain a pointer to the ancestor (or to the index of the direct base to
+ * cast to, first, if the ancestor is reached through a virtual base).
+ */
+class cast_table {
+  public:
+    struct entry {
+      const unsigned int* type_id; ///< The zero-terminated type-ID array of the ancestor.
+      std::ptrdiff_t offset; ///< The offset (in bytes) to the ancestor, from the object, or from the direct base (if via_base >= 0).
+      int via_base; ///< The index of the direct base to cast to (when reached virtually), or -1.
+      bool base_lookup; ///< Tells if the ancestor must be looked up in the cast table of the direct base (when its offset is not fixed).
+    };
+
+  private:
+    std::vector<entry> entries; // in the order of the search (depth-first through the bases).
+    std::vector<int> slots;     // the open-addressing hash-table of entry indices (or -1).
+
+    int find_index(const unsigned int* aTypeID) const;
+
+  public:
+
+    cast_table() { };
+
+    /**
+     * Adds an entry to the table, unless the type-ID was already added (the first entry wins,
+     * as in a depth-first search of the inheritance graph).
+     */
+    void add_entry(const unsigned int* aTypeID, std::ptrdiff_t aOffset, int aViaBase = -1, bool aBaseLookup = false);
+
+    /**
+     * Builds the hash-table of the entries, to be called once all the entries were added.
+     */
+    void finalize();
+
+    /**
+     * Returns the entries of the table, in order of the search.
+     */
+    const std::vector<entry>& get_entries() const { return entries; };
+
+    /**
+     * Finds the entry for a given type-ID array.
+     * \return The entry, or NULL if the type is not an ancestor of the class of this table.
+     */
+    const entry* find(const unsigned int* aTypeID) const {
+      if(slots.empty())
+        return NULL;
+      std::size_t mask = slots.size() - 1;
+      std::size_t i = hash_type_id(aTypeID) & mask;
+      while(slots[i] >= 0) {
+        const entry& e = entries[slots[i]];
+        if(equal_type_id(e.type_id, aTypeID))
+          return &e;
+        i = (i + 1) & mask;
+      };
+      return NULL;
+    };
+};
+
+
+template <typename T>
+const cast_table& get_cast_table();
+
+
+/*
+ * This trait tells if the offset of the base class (of Derived) is not fixed, i.e., if it is reached
+ * through virtual inheritance, which is detected by the down-cast (static_cast) being ill-formed.
+ * This is used instead of boost::is_virtual_base_of because the latter cannot handle a class that
+ * has different final overriders in each branch of a virtual-inheritance diamond (before C++11).
+ */
+template <typename Base, typename Derived>
+struct is_virtual_base_of {
+  typedef char yes_type;
+  struct no_type { char c[2]; };
+  template <typename B, typename D>
+  static no_type test(int (*)[sizeof(static_cast<D*>(static_cast<B*>(0)))]);
+  template <typename B, typename D>
+  static yes_type test(...);
+  BOOST_STATIC_CONSTANT(bool, value = (sizeof(test<Base,Derived>(0)) == sizeof(yes_type)));
+};
+
+
+/*
+ * The offset of a non-virtual base is fixed, and is obtained by casting a dummy (never dereferenced)
+ * pointer, as done by boost::serialization (void_cast) for the same purpose.
+ */
+template <typename Derived, typename Base>
+std::ptrdiff_t get_base_offset() {
+  char* const dummy = reinterpret_cast<char*>(1 << 12);
+  return reinterpret_cast<char*>(static_cast<Base*>(reinterpret_cast<Derived*>(dummy))) - dummy;
+};
+
+
+template <typename T, typename BaseList>
+struct add_base_casts {
+  static void to(cast_table& aTable, int aIndex) {
+    typedef typename BaseList::type base_type;
+    const cast_table& base_table = get_cast_table<base_type>();
+    const bool is_virtual = is_virtual_base_of<base_type, T>::value;
+    const std::ptrdiff_t base_offset = (is_virtual ? 0 : get_base_offset<T, base_type>());
+    for(std::vector<cast_table::entry>::const_iterator it = base_table.get_entries().begin();
+        it != base_table.get_entries().end(); ++it) {
+      if(it->via_base >= 0)
+        aTable.add_entry(it->type_id, 0, aIndex, true);
+      else if(is_virtual)
+        aTable.add_entry(it->type_id, it->offset, aIndex);
+      else
+        aTable.add_entry(it->type_id, base_offset + it->offset);
+    };
+    add_base_casts<T, typename BaseList::tail>::to(aTable, aIndex + 1);
+  };
+};
+
+template <typename T>
+struct add_base_casts<T, null_base_type> {
+  static void to(cast_table&, int) { };
+};
+
+
+/**
+ * This function returns the cast table of the class T (T::rk_rtti_BaseList lists its direct bases).
+ */
+template <typename T>
+const cast_table& get_cast_table() {
+  struct table_builder {
+    cast_table table;
+    table_builder() {
+      table.add_entry(get_type_id_array<T>(), 0);
+      add_base_casts<T, typename T::rk_rtti_BaseList>::to(table, 0);
+      table.finalize();
+    };
+  };
+  static const table_builder result;
+  return result.table;
+};
+
+
+template <typename T, typename BaseList>
+struct cast_through_base {
+  static void* apply(T* aObj, const cast_table::entry& aEntry, int aIndex, const unsigned int* aTypeID);
+};
+
+template <typename T>
+struct cast_through_base<T, null_base_type> {
+  static void* apply(T*, const cast_table::entry&, int, const unsigned int*) { return NULL; };
+};
+
+
+/**
+ * This function casts a pointer to an object of class T to a pointer to the ancestor of
+ * type-ID aTypeID, using the cast table of the class T.
+ * \return The pointer to the ancestor, or NULL if the type is not an ancestor of T.
+ */
+template <typename T>
+void* cast_to_type_id(T* aObj, const unsigned int* aTypeID) {
+  const cast_table::entry* e = get_cast_table<T>().find(aTypeID);
+  if(!e)
+    return NULL;
+  if(e->via_base < 0)
+    return reinterpret_cast<char*>(aObj) + e->offset;
+  return cast_through_base<T, typename T::rk_rtti_BaseList>::apply(aObj, *e, e->via_base, aTypeID);
+};
+
+template <typename T>
+const void* cast_to_type_id(const T* aObj, const unsigned int* aTypeID) {
+  return cast_to_type_id<T>(const_cast<T*>(aObj), aTypeID);
+};
+
+template <typename T, typename BaseList>
+void* cast_through_base<T, BaseList>::apply(T* aObj, const cast_table::entry& aEntry, int aIndex, const unsigned int* aTypeID) {
+  typedef typename BaseList::type base_type;
+  if(aIndex != 0)
+    return cast_through_base<T, typename BaseList::tail>::apply(aObj, aEntry, aIndex - 1, aTypeID);
+  if(aEntry.base_lookup)
+    return cast_to_type_id<base_type>(static_cast<base_type*>(aObj), aTypeID);
+  return reinterpret_cast<char*>(static_cast<base_type*>(aObj)) + aEntry.offset;
+};
+
+
+};
+
+};
+
+};
+
+#endif
+
@@ -155,6 +155,24 @@ namespace detail {
     unsigned int at(unsigned int) const { return 0; };
   };
   
+  /// This function computes the hash value of a zero-terminated type-ID array (FNV-1a on the IDs).
+  inline std::size_t hash_type_id(const unsigned int* aTypeID) {
+    std::size_t result = 2166136261u;
+    for(; *aTypeID; ++aTypeID) {
+      result ^= *aTypeID;
+      result *= 16777619u;
+    };
+    return result ^ (result >> 15);
+  };
+  
+  /// This function compares two zero-terminated type-ID arrays.
+  inline bool equal_type_id(const unsigned int* aTypeID1, const unsigned int* aTypeID2) {
+    while((*aTypeID1) && (*aTypeID1 == *aTypeID2)) {
+      ++aTypeID1; ++aTypeID2;
+    };
+    return (*aTypeID1 == *aTypeID2);
+  };
+  
 };
 
 
@@ -25,11 +25,205 @@
 
 #include <iostream>
 
+#ifdef RK_ENABLE_CXX11_FEATURES
+#include <atomic>
+#define RK_SO_TYPE_INDEX_ATOMIC std
+#else
+#include <boost/version.hpp>
+#if BOOST_VERSION >= 105300
+#include <boost/atomic.hpp>
+#define RK_SO_TYPE_INDEX_ATOMIC boost
+#endif
+#endif
+
 
 namespace ReaK {
 
 namespace rtti {
 
+namespace detail {
+
+
+/*
+ * This class is a hash-table of so_type records keyed by their type-ID sequence, which can be read
+ * without locking by any number of threads while a writer adds records. Slots are never erased,
+ * the records and tables are immutable once published (with release / acquire ordering), and a
+ * replaced record (or an outgrown table) is retired until the index is destroyed. Records are
+ * only added under the so_type_writer_lock. Without atomics (C++03 with Boost older than 1.53),
+ * look-ups are not safe while records are being added.
+ */
+class so_type_index {
+  private:
+    struct record {
+      std::size_t hash;
+      so_type::shared_pointer type;
+    };
+
+#ifdef RK_SO_TYPE_INDEX_ATOMIC
+    typedef RK_SO_TYPE_INDEX_ATOMIC::atomic<record*> slot_type;
+
+    static record* load(const slot_type& aSlot) { return aSlot.load(RK_SO_TYPE_INDEX_ATOMIC::memory_order_acquire); };
+    static void store(slot_type& aSlot, record* aRec) { aSlot.store(aRec, RK_SO_TYPE_INDEX_ATOMIC::memory_order_release); };
+
+    struct table {
+      std::size_t mask;
+      slot_type* slots;
+    };
+
+    RK_SO_TYPE_INDEX_ATOMIC::atomic<table*> mTable;
+
+    table* get_table() const { return mTable.load(RK_SO_TYPE_INDEX_ATOMIC::memory_order_acquire); };
+    void set_table(table* aTable) { mTable.store(aTable, RK_SO_TYPE_INDEX_ATOMIC::memory_order_release); };
+#else
+    typedef record* slot_type;
+
+    static record* load(const slot_type& aSlot) { return aSlot; };
+    static void store(slot_type& aSlot, record* aRec) { aSlot = aRec; };
+
+    struct table {
+      std::size_t mask;
+      slot_type* slots;
+    };
+
+    table* mTable;
+
+    table* get_table() const { return mTable; };
+    void set_table(table* aTable) { mTable = aTable; };
+#endif
+
+    std::size_t mCount;
+    std::vector<record*> mRecords;   // all records ever published (including the replaced ones).
+    std::vector<table*> mTables;     // all tables ever published (including the outgrown ones).
+
+    table* make_table(std::size_t aCapacity) {
+      table* t = new table;
+      t->mask = aCapacity - 1;
+      t->slots = new slot_type[aCapacity];
+      for(std::size_t i = 0; i < aCapacity; ++i)
+        store(t->slots[i], NULL);
+      mTables.push_back(t);
+      return t;
+    };
+
+    // writer only: find the slot of a type-ID, or the empty slot where it would go.
+    static slot_type& find_slot(table* t, std::size_t aHash, const unsigned int* aTypeID) {
+      std::size_t i = aHash & t->mask;
+      while(true) {
+        record* r = load(t->slots[i]);
+        if((!r) || ((r->hash == aHash) && equal_type_id(r->type->TypeID_begin(), aTypeID)))
+          return t->slots[i];
+        i = (i + 1) & t->mask;
+      };
+    };
+
+    so_type_index(const so_type_index&);
+    so_type_index& operator=(const so_type_index&);
+
+  public:
+
+    so_type_index() : mCount(0) {
+      set_table(make_table(64));
+    };
+
+    ~so_type_index() {
+      for(std::size_t i = 0; i < mTables.size(); ++i) {
+        delete[] mTables[i]->slots;
+        delete mTables[i];
+      };
+      for(std::size_t i = 0; i < mRecords.size(); ++i)
+        delete mRecords[i];
+    };
+
+    /// Finds the type with the given type-ID (lock-free).
+    so_type::shared_pointer find(const unsigned int* aTypeID) const {
+      const std::size_t h = hash_type_id(aTypeID);
+      const table* t = get_table();
+      std::size_t i = h & t->mask;
+      while(const record* r = load(t->slots[i])) {
+        if((r->hash == h) && equal_type_id(r->type->TypeID_begin(), aTypeID))
+          return r->type;
+        i = (i + 1) & t->mask;
+      };
+      return so_type::shared_pointer();
+    };
+
+    /// Adds a type to the index, or replaces the type with the same type-ID (under the so_type_writer_lock).
+    void insert(const so_type::shared_pointer& aType) {
+      record* r = new record;
+      r->hash = hash_type_id(aType->TypeID_begin());
+      r->type = aType;
+
+      mRecords.push_back(r);
+      table* t = get_table();
+      slot_type& s = find_slot(t, r->hash, aType->TypeID_begin());
+      if(load(s)) {
+        store(s, r);
+        return;
+      };
+      if(2 * (mCount + 1) > t->mask + 1) {
+        // grow the table (keeping the load-factor under one half), and publish it once it is filled.
+        table* nt = make_table(2 * (t->mask + 1));
+        for(std::size_t i = 0; i <= t->mask; ++i)
+          if(record* ri = load(t->slots[i]))
+            store(find_slot(nt, ri->hash, ri->type->TypeID_begin()), ri);
+        store(find_slot(nt, r->hash, aType->TypeID_begin()), r);
+        set_table(nt);
+      } else
+        store(s, r);
+      ++mCount;
+    };
+};
+
+
+/*
+ * This spin-lock serializes the modifications of the type hierarchies and indices of all the
+ * repositories (a single lock, as the look-ups span the ring of merged repositories), and the
+ * look-ups that must search the type hierarchies. It is only held briefly, and rarely contended,
+ * since types are added once (mostly during static initialization) and most look-ups hit the index.
+ */
+class so_type_writer_lock {
+  private:
+#ifdef RK_SO_TYPE_INDEX_ATOMIC
+    RK_SO_TYPE_INDEX_ATOMIC::atomic_flag mFlag;
+#endif
+
+    so_type_writer_lock(const so_type_writer_lock&);
+    so_type_writer_lock& operator=(const so_type_writer_lock&);
+
+  public:
+#ifdef RK_SO_TYPE_INDEX_ATOMIC
+    so_type_writer_lock() { mFlag.clear(); };
+
+    void lock() {
+      while(mFlag.test_and_set(RK_SO_TYPE_INDEX_ATOMIC::memory_order_acquire)) { };
+    };
+    void unlock() { mFlag.clear(RK_SO_TYPE_INDEX_ATOMIC::memory_order_release); };
+#else
+    so_type_writer_lock() { };
+
+    void lock() { };
+    void unlock() { };
+#endif
+
+    static so_type_writer_lock& getInstance() {
+      static so_type_writer_lock instance;
+      return instance;
+    };
+
+    /// Holds the lock for the duration of a scope.
+    class guard {
+      private:
+        guard(const guard&);
+        guard& operator=(const guard&);
+      public:
+        guard() { so_type_writer_lock::getInstance().lock(); };
+        ~guard() { so_type_writer_lock::getInstance().unlock(); };
+    };
+};
+
+
+};
+
   
 so_type_repo& so_type_repo::getInstance() {
   static const unsigned int t = 0;
@@ -42,7 +236,7 @@ so_type_repo& getRKSharedObjTypeRepo() {
   return so_type_repo::getInstance();
 };
 
-so_type_repo::so_type_repo(so_type* aTypeMap) : shared_object_base(), mTypeMap(aTypeMap) { next = this; prev = this; };
+so_type_repo::so_type_repo(so_type* aTypeMap) : shared_object_base(), mTypeMap(aTypeMap), mTypeIndex(new detail::so_type_index()) { next = this; prev = this; };
 
 so_type_repo::~so_type_repo() {
   if(next != this) {
@@ -50,6 +244,7 @@ so_type_repo::~so_type_repo() {
     next->prev = prev; //take 'this' out of the ring (if not empty, of course).
   };
   
+  delete mTypeIndex;
   delete mTypeMap;
 };
 
@@ -101,8 +296,27 @@ void RK_CALL so_type_repo::merge( so_type_repo* aRepo ) {
 ///This function finds a TypeID in the descendants (recusively) of this.
 
 so_type::weak_pointer RK_CALL so_type_repo::findType(const unsigned int* aTypeID ) const {
-  so_type::weak_pointer result = mTypeMap->findDescendant(aTypeID);
+  return findTypeImpl(aTypeID, false);
+};
+
+so_type::weak_pointer so_type_repo::findTypeImpl(const unsigned int* aTypeID, bool aIsLocked ) const {
+  // all the added types are indexed (in this repo, or one merged with it).
   const so_type_repo* p = this;
+  do {
+    so_type::shared_pointer t = p->mTypeIndex->find(aTypeID);
+    if(t)
+      return t;
+    p = p->next;
+  } while(p != this);
+  
+  // otherwise, search the type hierarchies (e.g., for the null type-ID, or not-found types), 
+  // which are only read under the writer lock, as a concurrent addType() modifies them.
+  if(!aIsLocked) {
+    detail::so_type_writer_lock::guard lock_here;
+    return findTypeImpl(aTypeID, true);
+  };
+  so_type::weak_pointer result = mTypeMap->findDescendant(aTypeID);
+  p = this;
   while((p->next != this) && (!result.lock())) {
     p = p->next;
     result = p->mTypeMap->findDescendant(aTypeID);
@@ -116,11 +330,15 @@ so_type::weak_pointer RK_CALL so_type_repo::findType(const so_type::shared_point
 
 ///This function adds a type to the repo.
 so_type::weak_pointer so_type_repo::addType(const so_type::shared_pointer& aTypeID) {
-  so_type::weak_pointer r = findType(aTypeID);
+  // concurrent additions are serialized, from the look-up of an existing version to the indexing.
+  detail::so_type_writer_lock::guard lock_here;
+  so_type::weak_pointer r = findTypeImpl(aTypeID->TypeID_begin(), true);
   if((r.lock()) && (r.lock()->TypeVersion() > aTypeID->TypeVersion()))
     return r;
 
-  return mTypeMap->addDescendant( aTypeID );
+  so_type::shared_pointer result = mTypeMap->addDescendant( aTypeID );
+  mTypeIndex->insert(result);
+  return result;
 };
 
 };
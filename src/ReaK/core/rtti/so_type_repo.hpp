@@ -46,9 +46,22 @@ namespace ReaK {
 
 namespace rtti {
 
+namespace detail {
+  class so_type_index; //forward-declaration.
+};
+
 
 /**
  * This class declares the interface for the repository of shared object types.
+ * 
+ * The types added to the repository are indexed in a flat hash-table (keyed by their type-ID
+ * sequence), such that finding a type is a constant-time look-up. Finding types can be done
+ * concurrently by any number of threads (e.g., de-serializing objects in parallel), including
+ * while types are being added (e.g., when loading a module), without locking. Adding types is
+ * serialized by a writer lock, which is also taken by the look-ups that miss the index and fall
+ * back to a search of the type hierarchies. Merging repositories (of different executable modules)
+ * is not thread-safe, and the look-ups first check the index of this repository, and then the
+ * indices of the merged repositories.
  */
 class so_type_repo : public shared_object_base {
 private:
@@ -56,12 +69,16 @@ private:
   so_type_repo& operator=(const so_type_repo&);
   
   so_type* mTypeMap;
+  detail::so_type_index* mTypeIndex;
 
   so_type_repo(so_type* aTypeMap);
   
   so_type_repo* next;
   so_type_repo* prev;
   
+  // finds a type, aIsLocked tells if the caller already holds the writer lock.
+  so_type::weak_pointer findTypeImpl(const unsigned int* aTypeID, bool aIsLocked) const;
+  
 protected:
   
   virtual bool RK_CALL isInRing(so_type_repo* aRepo);
@@ -0,0 +1,204 @@
+
+/*
+ *    Copyright 2013 Sven Mikael Persson
+ *
+ *    THIS SOFTWARE IS DISTRIBUTED UNDER THE TERMS OF THE GNU GENERAL PUBLIC LICENSE v3 (GPLv3).
+ *
+ *    This file is part of ReaK.
+ *
+ *    ReaK is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    (at your option) any later version.
+ *
+ *    ReaK is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with ReaK (as LICENSE in the root folder).
+ *    If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "typed_object.hpp"
+
+#include "base/chrono_incl.hpp"
+
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+
+
+/*
+ * Micro-benchmark of the ReaK::rtti dynamic casts (castTo and rk_dynamic_ptr_cast), on a
+ * deep single-inheritance chain (as in most of ReaK), and on a diamond through virtual bases
+ * (as in the KTE models, with virtual named_object bases).
+ */
+
+namespace {
+
+using namespace ReaK;
+
+
+class cast_base : public rtti::typed_object {
+  public:
+    int base_value;
+    cast_base() : base_value(1) { };
+    RK_RTTI_MAKE_ABSTRACT_1BASE(cast_base,0xC0000001,1,"cast_base",rtti::typed_object)
+};
+
+class cast_level1 : public cast_base {
+  public:
+    double level1_value;
+    cast_level1() : level1_value(2.0) { };
+    RK_RTTI_MAKE_ABSTRACT_1BASE(cast_level1,0xC0000002,1,"cast_level1",cast_base)
+};
+
+class cast_other {
+  public:
+    double other_value;
+    cast_other() : other_value(3.0) { };
+    virtual ~cast_other() { };
+};
+
+class cast_level2 : public cast_other, public cast_level1 {
+  public:
+    int level2_value;
+    cast_level2() : level2_value(4) { };
+    RK_RTTI_MAKE_ABSTRACT_1BASE(cast_level2,0xC0000003,1,"cast_level2",cast_level1)
+};
+
+class cast_level3 : public cast_level2 {
+  public:
+    int level3_value;
+    cast_level3() : level3_value(5) { };
+    RK_RTTI_MAKE_ABSTRACT_1BASE(cast_level3,0xC0000004,1,"cast_level3",cast_level2)
+};
+
+class cast_unrelated : public rtti::typed_object {
+  public:
+    RK_RTTI_MAKE_ABSTRACT_1BASE(cast_unrelated,0xC0000005,1,"cast_unrelated",rtti::typed_object)
+};
+
+class cast_left : public virtual cast_base {
+  public:
+    int left_value;
+    cast_left() : left_value(6) { };
+    RK_RTTI_MAKE_ABSTRACT_1BASE(cast_left,0xC0000006,1,"cast_left",cast_base)
+};
+
+class cast_right : public virtual cast_base {
+  public:
+    int right_value;
+    cast_right() : right_value(7) { };
+    RK_RTTI_MAKE_ABSTRACT_1BASE(cast_right,0xC0000007,1,"cast_right",cast_base)
+};
+
+class cast_diamond : public cast_left, public cast_right {
+  public:
+    RK_RTTI_MAKE_ABSTRACT_2BASE(cast_diamond,0xC0000008,1,"cast_diamond",cast_left,cast_right)
+};
+
+
+template <typename Y, typename U>
+bool check_cast(const shared_ptr<U>& p, Y* expected) {
+  if(rtti::rk_dynamic_ptr_cast<Y>(p).get() == expected)
+    return true;
+  std::cout << "Cast to " << Y::getStaticObjectType()->TypeName() << " gave the wrong pointer!" << std::endl;
+  return false;
+};
+
+template <typename Y, typename U>
+double time_ptr_cast(const shared_ptr<U>& p, std::size_t aCount) {
+  using namespace ReaKaux::chrono;
+  std::size_t hits = 0;
+  high_resolution_clock::time_point t0 = high_resolution_clock::now();
+  for(std::size_t i = 0; i < aCount; ++i)
+    if(rtti::rk_dynamic_ptr_cast<Y>(p))
+      ++hits;
+  high_resolution_clock::time_point t1 = high_resolution_clock::now();
+  if(hits == 1)  // only to keep the loop from being optimized away.
+    std::cout << " ";
+  return double(duration_cast<nanoseconds>(t1 - t0).count()) / double(aCount);
+};
+
+template <typename Y, typename U>
+double time_castTo_type(const shared_ptr<U>& p, std::size_t aCount) {
+  using namespace ReaKaux::chrono;
+  std::size_t hits = 0;
+  high_resolution_clock::time_point t0 = high_resolution_clock::now();
+  for(std::size_t i = 0; i < aCount; ++i)
+    if(p->castTo(Y::getStaticObjectType()))
+      ++hits;
+  high_resolution_clock::time_point t1 = high_resolution_clock::now();
+  if(hits == 1)
+    std::cout << " ";
+  return double(duration_cast<nanoseconds>(t1 - t0).count()) / double(aCount);
+};
+
+template <typename Y, typename U>
+double time_castTo_id(const shared_ptr<U>& p, std::size_t aCount) {
+  using namespace ReaKaux::chrono;
+  std::size_t hits = 0;
+  const unsigned int* type_id = rtti::get_type_id_array<Y>();
+  high_resolution_clock::time_point t0 = high_resolution_clock::now();
+  for(std::size_t i = 0; i < aCount; ++i)
+    if(p->castTo(type_id))
+      ++hits;
+  high_resolution_clock::time_point t1 = high_resolution_clock::now();
+  if(hits == 1)
+    std::cout << " ";
+  return double(duration_cast<nanoseconds>(t1 - t0).count()) / double(aCount);
+};
+
+template <typename Y, typename U>
+void print_timings(const std::string& aName, const shared_ptr<U>& p, std::size_t aCount) {
+  std::cout << std::setw(40) << aName
+            << std::setw(14) << time_ptr_cast<Y>(p, aCount)
+            << std::setw(14) << time_castTo_type<Y>(p, aCount)
+            << std::setw(14) << time_castTo_id<Y>(p, aCount) << std::endl;
+};
+
+};
+
+
+int main(int argc, char** argv) {
+
+  std::size_t count = 10000000;
+  if(argc > 1)
+    count = std::atoi(argv[1]);
+
+  shared_ptr<cast_level3> chain(new cast_level3());
+  shared_ptr<rtti::typed_object> chain_obj = chain;
+  shared_ptr<cast_diamond> diamond(new cast_diamond());
+  shared_ptr<rtti::typed_object> diamond_obj = rtti::rk_static_ptr_cast<cast_left>(diamond);
+
+  bool all_correct = check_cast<cast_level3>(chain_obj, chain.get())
+                  && check_cast<cast_level2>(chain_obj, chain.get())
+                  && check_cast<cast_level1>(chain_obj, chain.get())
+                  && check_cast<cast_base>(chain_obj, chain.get())
+                  && check_cast<cast_unrelated>(chain_obj, static_cast<cast_unrelated*>(NULL))
+                  && check_cast<cast_diamond>(diamond_obj, diamond.get())
+                  && check_cast<cast_left>(diamond_obj, diamond.get())
+                  && check_cast<cast_right>(diamond_obj, diamond.get())
+                  && check_cast<cast_base>(diamond_obj, diamond.get())
+                  && check_cast<cast_level1>(diamond_obj, static_cast<cast_level1*>(NULL));
+  if(!all_correct)
+    return 1;
+
+  std::cout << "Average time per cast (ns), over " << count << " casts:" << std::endl;
+  std::cout << std::setw(40) << "cast"
+            << std::setw(14) << "ptr_cast"
+            << std::setw(14) << "castTo(type)"
+            << std::setw(14) << "castTo(id)" << std::endl;
+  print_timings<cast_level3>("chain, to most-derived", chain_obj, count);
+  print_timings<cast_base>("chain, to deepest base", chain_obj, count);
+  print_timings<cast_unrelated>("chain, to unrelated (miss)", chain_obj, count);
+  print_timings<cast_right>("diamond, to other branch", diamond_obj, count);
+  print_timings<cast_base>("diamond, to virtual base", diamond_obj, count);
+  print_timings<cast_level1>("diamond, to unrelated (miss)", diamond_obj, count);
+
+  return 0;
+};
+
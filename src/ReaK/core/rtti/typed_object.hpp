@@ -38,6 +38,7 @@
 
 #include "so_type_repo.hpp"
 #include "so_register_type.hpp"
+#include "so_cast_table.hpp"
 
 #include "typed_primitives.hpp"
 #include "typed_containers.hpp"
@@ -60,11 +61,14 @@ namespace rtti {
 class typed_object {
   public:
     
+    typedef detail::null_base_type rk_rtti_BaseList;
+    
     /**
      * This method is used to perform up- and down- casting of object pointers via a virtual call.
+     * \param aTypeID The zero-terminated type-ID array of the target type (see get_type_id_array()).
      */
-    virtual void* RK_CALL castTo(const so_type::shared_pointer& aTypeID) { 
-      if(*(aTypeID->TypeID_begin()) == 0) 
+    virtual void* RK_CALL castTo(const unsigned int* aTypeID) { 
+      if(*aTypeID == 0) 
 	return reinterpret_cast<void*>(this); 
       else 
 	return NULL;
@@ -72,13 +76,28 @@ class typed_object {
     
     /**
      * This method is used to perform up- and down- casting of const-object pointers via a virtual call.
+     * \param aTypeID The zero-terminated type-ID array of the target type (see get_type_id_array()).
      */
-    virtual const void* RK_CALL castTo(const so_type::shared_pointer& aTypeID) const { 
-      if(*(aTypeID->TypeID_begin()) == 0) 
+    virtual const void* RK_CALL castTo(const unsigned int* aTypeID) const { 
+      if(*aTypeID == 0) 
 	return reinterpret_cast<const void*>(this); 
       else 
 	return NULL;
     };
+    
+    /**
+     * This method is used to perform up- and down- casting of object pointers via a virtual call.
+     */
+    virtual void* RK_CALL castTo(const so_type::shared_pointer& aTypeID) { 
+      return castTo(aTypeID->TypeID_begin());
+    };
+    
+    /**
+     * This method is used to perform up- and down- casting of const-object pointers via a virtual call.
+     */
+    virtual const void* RK_CALL castTo(const so_type::shared_pointer& aTypeID) const { 
+      return castTo(aTypeID->TypeID_begin());
+    };
 
     virtual ~typed_object() { RK_NOTICE(8,"Typed object destructor reached!"); };
 
@@ -94,6 +113,13 @@ class typed_object {
 
 };
 
+/// The typed_object class matches (only) the null type-ID, as the root of all typed objects.
+template <>
+inline const unsigned int* get_type_id_array<typed_object>() {
+  static const unsigned int result[1] = {0};
+  return result;
+};
+
 #ifndef RK_ENABLE_CXX0X_FEATURES
 
 /**
@@ -117,7 +143,7 @@ template <typename Y,typename U>
 boost::shared_ptr<Y> rk_dynamic_ptr_cast(const boost::shared_ptr<U>& p) {
   if(!p) 
     return boost::shared_ptr<Y>();
-  return boost::shared_ptr<Y>(p,reinterpret_cast<Y*>(p->castTo(Y::getStaticObjectType())));
+  return boost::shared_ptr<Y>(p,reinterpret_cast<Y*>(p->castTo(get_type_id_array<Y>())));
 };
 #else
 
@@ -142,14 +168,14 @@ template <typename Y,typename U>
 std::shared_ptr<Y> rk_dynamic_ptr_cast(const std::shared_ptr<U>& p) {
   if(!p) 
     return std::shared_ptr<Y>();
-  return std::shared_ptr<Y>(p,reinterpret_cast<Y*>(p->castTo(Y::getStaticObjectType())));
+  return std::shared_ptr<Y>(p,reinterpret_cast<Y*>(p->castTo(get_type_id_array<Y>())));
 };
 
 template <typename Y,typename U,typename Deleter>
 std::unique_ptr<Y,Deleter> rk_dynamic_ptr_cast(std::unique_ptr<U,Deleter>&& p) {
   if(!p) 
     return std::unique_ptr<Y,Deleter>();
-  void* tmp = p->castTo(Y::getStaticObjectType());
+  void* tmp = p->castTo(get_type_id_array<Y>());
   if(tmp) {
     std::unique_ptr<Y,Deleter> r(tmp, p.get_deleter());
     p.release();
@@ -180,137 +206,112 @@ std::unique_ptr<Y,Deleter> rk_dynamic_ptr_cast(std::unique_ptr<U,Deleter>&& p) {
     
 /// This MACRO creates the static elements for the current class to be added to the global type registry (it is guaranteed to be added if the class is instantiated).
 #define RK_RTTI_REGISTER_CLASS_0BASE(CLASS_NAME,CLASS_VERSION) \
+    typedef ReaK::rtti::detail::null_base_type rk_rtti_BaseList; \
     static boost::shared_ptr<ReaK::rtti::so_type> RK_CALL getStaticObjectType() { \
-      return ReaK::rtti::register_type< CLASS_NAME , CLASS_VERSION >::impl.ptr; \
+      return ReaK::rtti::register_type< CLASS_NAME , CLASS_VERSION , rk_rtti_BaseList >::impl.ptr; \
     }; \
     virtual boost::shared_ptr<ReaK::rtti::so_type> RK_CALL getObjectType() const { \
       return CLASS_NAME::getStaticObjectType(); \
     };\
+    virtual void* RK_CALL castTo(const unsigned int* aTypeID) { \
+      return ReaK::rtti::detail::cast_to_type_id< CLASS_NAME >(this, aTypeID); \
+    };\
+    virtual const void* RK_CALL castTo(const unsigned int* aTypeID) const { \
+      return ReaK::rtti::detail::cast_to_type_id< CLASS_NAME >(this, aTypeID); \
+    };\
     virtual void* RK_CALL castTo(const boost::shared_ptr<ReaK::rtti::so_type>& aTypeID) { \
-      if(*aTypeID == *(CLASS_NAME::getStaticObjectType())) \
-	return reinterpret_cast<void*>(this); \
-      else \
-	return NULL; \
+      return castTo(aTypeID->TypeID_begin()); \
     };\
     virtual const void* RK_CALL castTo(const boost::shared_ptr<ReaK::rtti::so_type>& aTypeID) const { \
-      if(*aTypeID == *(CLASS_NAME::getStaticObjectType())) \
-	return reinterpret_cast<const void*>(this); \
-      else \
-	return NULL; \
+      return castTo(aTypeID->TypeID_begin()); \
     };
 
 /// This MACRO creates the static elements for the current class to be added to the global type registry (it is guaranteed to be added if the class is instantiated).
 #define RK_RTTI_REGISTER_CLASS_1BASE(CLASS_NAME,CLASS_VERSION,BASE_NAME) \
+    typedef ReaK::rtti::detail::base_type_list< BASE_NAME > rk_rtti_BaseList; \
     static boost::shared_ptr<ReaK::rtti::so_type> RK_CALL getStaticObjectType() { \
-      return ReaK::rtti::register_type< CLASS_NAME , CLASS_VERSION , ReaK::rtti::detail::base_type_list< BASE_NAME > >::impl.ptr; \
+      return ReaK::rtti::register_type< CLASS_NAME , CLASS_VERSION , rk_rtti_BaseList >::impl.ptr; \
     }; \
     virtual boost::shared_ptr<ReaK::rtti::so_type> RK_CALL getObjectType() const { \
       return CLASS_NAME::getStaticObjectType(); \
     };\
+    virtual void* RK_CALL castTo(const unsigned int* aTypeID) { \
+      return ReaK::rtti::detail::cast_to_type_id< CLASS_NAME >(this, aTypeID); \
+    };\
+    virtual const void* RK_CALL castTo(const unsigned int* aTypeID) const { \
+      return ReaK::rtti::detail::cast_to_type_id< CLASS_NAME >(this, aTypeID); \
+    };\
     virtual void* RK_CALL castTo(const boost::shared_ptr<ReaK::rtti::so_type>& aTypeID) { \
-      if(*aTypeID == *(CLASS_NAME::getStaticObjectType())) \
-	return reinterpret_cast<void*>(this); \
-      else \
-	return BASE_NAME::castTo(aTypeID); \
+      return castTo(aTypeID->TypeID_begin()); \
     };\
     virtual const void* RK_CALL castTo(const boost::shared_ptr<ReaK::rtti::so_type>& aTypeID) const { \
-      if(*aTypeID == *(CLASS_NAME::getStaticObjectType())) \
-	return reinterpret_cast<const void*>(this); \
-      else \
-	return BASE_NAME::castTo(aTypeID); \
+      return castTo(aTypeID->TypeID_begin()); \
     };
 
 /// This MACRO creates the static elements for the current class to be added to the global type registry (it is guaranteed to be added if the class is instantiated).
 #define RK_RTTI_REGISTER_CLASS_2BASE(CLASS_NAME,CLASS_VERSION,BASE_NAME1,BASE_NAME2) \
+    typedef ReaK::rtti::detail::base_type_list< BASE_NAME1, ReaK::rtti::detail::base_type_list< BASE_NAME2 > > rk_rtti_BaseList; \
     static boost::shared_ptr<ReaK::rtti::so_type> RK_CALL getStaticObjectType() { \
-      return ReaK::rtti::register_type< CLASS_NAME , CLASS_VERSION , ReaK::rtti::detail::base_type_list< BASE_NAME1, ReaK::rtti::detail::base_type_list< BASE_NAME2 > > >::impl.ptr; \
+      return ReaK::rtti::register_type< CLASS_NAME , CLASS_VERSION , rk_rtti_BaseList >::impl.ptr; \
     }; \
     virtual boost::shared_ptr<ReaK::rtti::so_type> RK_CALL getObjectType() const { \
       return CLASS_NAME::getStaticObjectType(); \
     };\
+    virtual void* RK_CALL castTo(const unsigned int* aTypeID) { \
+      return ReaK::rtti::detail::cast_to_type_id< CLASS_NAME >(this, aTypeID); \
+    };\
+    virtual const void* RK_CALL castTo(const unsigned int* aTypeID) const { \
+      return ReaK::rtti::detail::cast_to_type_id< CLASS_NAME >(this, aTypeID); \
+    };\
     virtual void* RK_CALL castTo(const boost::shared_ptr<ReaK::rtti::so_type>& aTypeID) { \
-      if(*aTypeID == *(CLASS_NAME::getStaticObjectType())) \
-	return reinterpret_cast<void*>(this); \
-      else { \
-	void* result = BASE_NAME1::castTo(aTypeID); \
-	if(result) return result; \
-	return BASE_NAME2::castTo(aTypeID); \
-      }; \
+      return castTo(aTypeID->TypeID_begin()); \
     };\
     virtual const void* RK_CALL castTo(const boost::shared_ptr<ReaK::rtti::so_type>& aTypeID) const { \
-      if(*aTypeID == *(CLASS_NAME::getStaticObjectType())) \
-	return reinterpret_cast<const void*>(this); \
-      else { \
-	const void* result = BASE_NAME1::castTo(aTypeID); \
-	if(result) return result; \
-	return BASE_NAME2::castTo(aTypeID); \
-      }; \
+      return castTo(aTypeID->TypeID_begin()); \
     };
     
 /// This MACRO creates the static elements for the current class to be added to the global type registry (it is guaranteed to be added if the class is instantiated).
 #define RK_RTTI_REGISTER_CLASS_3BASE(CLASS_NAME,CLASS_VERSION,BASE_NAME1,BASE_NAME2,BASE_NAME3) \
+    typedef ReaK::rtti::detail::base_type_list< BASE_NAME1, ReaK::rtti::detail::base_type_list< BASE_NAME2, ReaK::rtti::detail::base_type_list< BASE_NAME3 > > > rk_rtti_BaseList; \
     static boost::shared_ptr<ReaK::rtti::so_type> RK_CALL getStaticObjectType() { \
-      return ReaK::rtti::register_type< CLASS_NAME , CLASS_VERSION , ReaK::rtti::detail::base_type_list< BASE_NAME1, ReaK::rtti::detail::base_type_list< BASE_NAME2 , ReaK::rtti::detail::base_type_list< BASE_NAME3 > > > >::impl.ptr; \
+      return ReaK::rtti::register_type< CLASS_NAME , CLASS_VERSION , rk_rtti_BaseList >::impl.ptr; \
     }; \
     virtual boost::shared_ptr<ReaK::rtti::so_type> RK_CALL getObjectType() const { \
       return CLASS_NAME::getStaticObjectType(); \
     };\
+    virtual void* RK_CALL castTo(const unsigned int* aTypeID) { \
+      return ReaK::rtti::detail::cast_to_type_id< CLASS_NAME >(this, aTypeID); \
+    };\
+    virtual const void* RK_CALL castTo(const unsigned int* aTypeID) const { \
+      return ReaK::rtti::detail::cast_to_type_id< CLASS_NAME >(this, aTypeID); \
+    };\
     virtual void* RK_CALL castTo(const boost::shared_ptr<ReaK::rtti::so_type>& aTypeID) { \
-      if(*aTypeID == *(CLASS_NAME::getStaticObjectType())) \
-	return reinterpret_cast<void*>(this); \
-      else { \
-	void* result = BASE_NAME1::castTo(aTypeID); \
-	if(result) return result; \
-	result = BASE_NAME2::castTo(aTypeID); \
-	if(result) return result; \
-        return BASE_NAME3::castTo(aTypeID); \
-      }; \
+      return castTo(aTypeID->TypeID_begin()); \
     };\
     virtual const void* RK_CALL castTo(const boost::shared_ptr<ReaK::rtti::so_type>& aTypeID) const { \
-      if(*aTypeID == *(CLASS_NAME::getStaticObjectType())) \
-	return reinterpret_cast<const void*>(this); \
-      else { \
-	const void* result = BASE_NAME1::castTo(aTypeID); \
-	if(result) return result; \
-	result = BASE_NAME2::castTo(aTypeID); \
-	if(result) return result; \
-        return BASE_NAME3::castTo(aTypeID); \
-      }; \
+      return castTo(aTypeID->TypeID_begin()); \
     };
 
 /// This MACRO creates the static elements for the current class to be added to the global type registry (it is guaranteed to be added if the class is instantiated).
 #define RK_RTTI_REGISTER_CLASS_4BASE(CLASS_NAME,CLASS_VERSION,BASE_NAME1,BASE_NAME2,BASE_NAME3,BASE_NAME4) \
+    typedef ReaK::rtti::detail::base_type_list< BASE_NAME1, ReaK::rtti::detail::base_type_list< BASE_NAME2, ReaK::rtti::detail::base_type_list< BASE_NAME3, ReaK::rtti::detail::base_type_list< BASE_NAME4 > > > > rk_rtti_BaseList; \
     static boost::shared_ptr<ReaK::rtti::so_type> RK_CALL getStaticObjectType() { \
-      return ReaK::rtti::register_type< CLASS_NAME , CLASS_VERSION , ReaK::rtti::detail::base_type_list< BASE_NAME1, ReaK::rtti::detail::base_type_list< BASE_NAME2 , ReaK::rtti::detail::base_type_list< BASE_NAME3 , ReaK::rtti::detail::base_type_list< BASE_NAME4 > > > > >::impl.ptr; \
+      return ReaK::rtti::register_type< CLASS_NAME , CLASS_VERSION , rk_rtti_BaseList >::impl.ptr; \
     }; \
     virtual boost::shared_ptr<ReaK::rtti::so_type> RK_CALL getObjectType() const { \
       return CLASS_NAME::getStaticObjectType(); \
     };\
+    virtual void* RK_CALL castTo(const unsigned int* aTypeID) { \
+      return ReaK::rtti::detail::cast_to_type_id< CLASS_NAME >(this, aTypeID); \
+    };\
+    virtual const void* RK_CALL castTo(const unsigned int* aTypeID) const { \
+      return ReaK::rtti::detail::cast_to_type_id< CLASS_NAME >(this, aTypeID); \
+    };\
     virtual void* RK_CALL castTo(const boost::shared_ptr<ReaK::rtti::so_type>& aTypeID) { \
-      if(*aTypeID == *(CLASS_NAME::getStaticObjectType())) \
-	return reinterpret_cast<void*>(this); \
-      else { \
-	void* result = BASE_NAME1::castTo(aTypeID); \
-	if(result) return result; \
-	result = BASE_NAME2::castTo(aTypeID); \
-	if(result) return result; \
-	result = BASE_NAME3::castTo(aTypeID); \
-	if(result) return result; \
-        return BASE_NAME4::castTo(aTypeID); \
-      }; \
+      return castTo(aTypeID->TypeID_begin()); \
     };\
     virtual const void* RK_CALL castTo(const boost::shared_ptr<ReaK::rtti::so_type>& aTypeID) const { \
-      if(*aTypeID == *(CLASS_NAME::getStaticObjectType())) \
-	return reinterpret_cast<const void*>(this); \
-      else { \
-	const void* result = BASE_NAME1::castTo(aTypeID); \
-	if(result) return result; \
-	result = BASE_NAME2::castTo(aTypeID); \
-	if(result) return result; \
-	result = BASE_NAME3::castTo(aTypeID); \
-	if(result) return result; \
-        return BASE_NAME4::castTo(aTypeID); \
-      }; \
+      return castTo(aTypeID->TypeID_begin()); \
     };
     
 #else
@@ -333,137 +334,112 @@ std::unique_ptr<Y,Deleter> rk_dynamic_ptr_cast(std::unique_ptr<U,Deleter>&& p) {
     
 /// This MACRO creates the static elements for the current class to be added to the global type registry (it is guaranteed to be added if the class is instantiated).
 #define RK_RTTI_REGISTER_CLASS_0BASE(CLASS_NAME,CLASS_VERSION) \
+    typedef ReaK::rtti::detail::null_base_type rk_rtti_BaseList; \
     static std::shared_ptr<ReaK::rtti::so_type> RK_CALL getStaticObjectType() { \
-      return ReaK::rtti::register_type< CLASS_NAME , CLASS_VERSION >::impl.ptr; \
+      return ReaK::rtti::register_type< CLASS_NAME , CLASS_VERSION , rk_rtti_BaseList >::impl.ptr; \
     }; \
     virtual std::shared_ptr<ReaK::rtti::so_type> RK_CALL getObjectType() const { \
       return CLASS_NAME::getStaticObjectType(); \
     };\
+    virtual void* RK_CALL castTo(const unsigned int* aTypeID) { \
+      return ReaK::rtti::detail::cast_to_type_id< CLASS_NAME >(this, aTypeID); \
+    };\
+    virtual const void* RK_CALL castTo(const unsigned int* aTypeID) const { \
+      return ReaK::rtti::detail::cast_to_type_id< CLASS_NAME >(this, aTypeID); \
+    };\
     virtual void* RK_CALL castTo(const std::shared_ptr<ReaK::rtti::so_type>& aTypeID) { \
-      if(*aTypeID == *(CLASS_NAME::getStaticObjectType())) \
-	return reinterpret_cast<void*>(this); \
-      else \
-	return NULL; \
+      return castTo(aTypeID->TypeID_begin()); \
     };\
     virtual const void* RK_CALL castTo(const std::shared_ptr<ReaK::rtti::so_type>& aTypeID) const { \
-      if(*aTypeID == *(CLASS_NAME::getStaticObjectType())) \
-	return reinterpret_cast<const void*>(this); \
-      else \
-	return NULL; \
+      return castTo(aTypeID->TypeID_begin()); \
     };
 
 /// This MACRO creates the static elements for the current class to be added to the global type registry (it is guaranteed to be added if the class is instantiated).
 #define RK_RTTI_REGISTER_CLASS_1BASE(CLASS_NAME,CLASS_VERSION,BASE_NAME) \
+    typedef ReaK::rtti::detail::base_type_list< BASE_NAME > rk_rtti_BaseList; \
     static std::shared_ptr<ReaK::rtti::so_type> RK_CALL getStaticObjectType() { \
-      return ReaK::rtti::register_type< CLASS_NAME , CLASS_VERSION , ReaK::rtti::detail::base_type_list< BASE_NAME > >::impl.ptr; \
+      return ReaK::rtti::register_type< CLASS_NAME , CLASS_VERSION , rk_rtti_BaseList >::impl.ptr; \
     }; \
     virtual std::shared_ptr<ReaK::rtti::so_type> RK_CALL getObjectType() const { \
       return CLASS_NAME::getStaticObjectType(); \
     };\
+    virtual void* RK_CALL castTo(const unsigned int* aTypeID) { \
+      return ReaK::rtti::detail::cast_to_type_id< CLASS_NAME >(this, aTypeID); \
+    };\
+    virtual const void* RK_CALL castTo(const unsigned int* aTypeID) const { \
+      return ReaK::rtti::detail::cast_to_type_id< CLASS_NAME >(this, aTypeID); \
+    };\
     virtual void* RK_CALL castTo(const std::shared_ptr<ReaK::rtti::so_type>& aTypeID) { \
-      if(*aTypeID == *(CLASS_NAME::getStaticObjectType())) \
-	return reinterpret_cast<void*>(this); \
-      else \
-	return BASE_NAME::castTo(aTypeID); \
+      return castTo(aTypeID->TypeID_begin()); \
     };\
     virtual const void* RK_CALL castTo(const std::shared_ptr<ReaK::rtti::so_type>& aTypeID) const { \
-      if(*aTypeID == *(CLASS_NAME::getStaticObjectType())) \
-	return reinterpret_cast<const void*>(this); \
-      else \
-	return BASE_NAME::castTo(aTypeID); \
+      return castTo(aTypeID->TypeID_begin()); \
     };
 
 /// This MACRO creates the static elements for the current class to be added to the global type registry (it is guaranteed to be added if the class is instantiated).
 #define RK_RTTI_REGISTER_CLASS_2BASE(CLASS_NAME,CLASS_VERSION,BASE_NAME1,BASE_NAME2) \
+    typedef ReaK::rtti::detail::base_type_list< BASE_NAME1, ReaK::rtti::detail::base_type_list< BASE_NAME2 > > rk_rtti_BaseList; \
     static std::shared_ptr<ReaK::rtti::so_type> RK_CALL getStaticObjectType() { \
-      return ReaK::rtti::register_type< CLASS_NAME , CLASS_VERSION , ReaK::rtti::detail::base_type_list< BASE_NAME1, ReaK::rtti::detail::base_type_list< BASE_NAME2 > > >::impl.ptr; \
+      return ReaK::rtti::register_type< CLASS_NAME , CLASS_VERSION , rk_rtti_BaseList >::impl.ptr; \
     }; \
     virtual std::shared_ptr<ReaK::rtti::so_type> RK_CALL getObjectType() const { \
       return CLASS_NAME::getStaticObjectType(); \
     };\
+    virtual void* RK_CALL castTo(const unsigned int* aTypeID) { \
+      return ReaK::rtti::detail::cast_to_type_id< CLASS_NAME >(this, aTypeID); \
+    };\
+    virtual const void* RK_CALL castTo(const unsigned int* aTypeID) const { \
+      return ReaK::rtti::detail::cast_to_type_id< CLASS_NAME >(this, aTypeID); \
+    };\
     virtual void* RK_CALL castTo(const std::shared_ptr<ReaK::rtti::so_type>& aTypeID) { \
-      if(*aTypeID == *(CLASS_NAME::getStaticObjectType())) \
-	return reinterpret_cast<void*>(this); \
-      else { \
-	void* result = BASE_NAME1::castTo(aTypeID); \
-	if(result) return result; \
-	return BASE_NAME2::castTo(aTypeID); \
-      }; \
+      return castTo(aTypeID->TypeID_begin()); \
     };\
     virtual const void* RK_CALL castTo(const std::shared_ptr<ReaK::rtti::so_type>& aTypeID) const { \
-      if(*aTypeID == *(CLASS_NAME::getStaticObjectType())) \
-	return reinterpret_cast<const void*>(this); \
-      else { \
-	const void* result = BASE_NAME1::castTo(aTypeID); \
-	if(result) return result; \
-	return BASE_NAME2::castTo(aTypeID); \
-      }; \
+      return castTo(aTypeID->TypeID_begin()); \
     };
     
 /// This MACRO creates the static elements for the current class to be added to the global type registry (it is guaranteed to be added if the class is instantiated).
 #define RK_RTTI_REGISTER_CLASS_3BASE(CLASS_NAME,CLASS_VERSION,BASE_NAME1,BASE_NAME2,BASE_NAME3) \
+    typedef ReaK::rtti::detail::base_type_list< BASE_NAME1, ReaK::rtti::detail::base_type_list< BASE_NAME2, ReaK::rtti::detail::base_type_list< BASE_NAME3 > > > rk_rtti_BaseList; \
     static std::shared_ptr<ReaK::rtti::so_type> RK_CALL getStaticObjectType() { \
-      return ReaK::rtti::register_type< CLASS_NAME , CLASS_VERSION , ReaK::rtti::detail::base_type_list< BASE_NAME1, ReaK::rtti::detail::base_type_list< BASE_NAME2 , ReaK::rtti::detail::base_type_list< BASE_NAME3 > > > >::impl.ptr; \
+      return ReaK::rtti::register_type< CLASS_NAME , CLASS_VERSION , rk_rtti_BaseList >::impl.ptr; \
     }; \
     virtual std::shared_ptr<ReaK::rtti::so_type> RK_CALL getObjectType() const { \
       return CLASS_NAME::getStaticObjectType(); \
     };\
+    virtual void* RK_CALL castTo(const unsigned int* aTypeID) { \
+      return ReaK::rtti::detail::cast_to_type_id< CLASS_NAME >(this, aTypeID); \
+    };\
+    virtual const void* RK_CALL castTo(const unsigned int* aTypeID) const { \
+      return ReaK::rtti::detail::cast_to_type_id< CLASS_NAME >(this, aTypeID); \
+    };\
     virtual void* RK_CALL castTo(const std::shared_ptr<ReaK::rtti::so_type>& aTypeID) { \
-      if(*aTypeID == *(CLASS_NAME::getStaticObjectType())) \
-	return reinterpret_cast<void*>(this); \
-      else { \
-	void* result = BASE_NAME1::castTo(aTypeID); \
-	if(result) return result; \
-	result = BASE_NAME2::castTo(aTypeID); \
-	if(result) return result; \
-        return BASE_NAME3::castTo(aTypeID); \
-      }; \
+      return castTo(aTypeID->TypeID_begin()); \
     };\
     virtual const void* RK_CALL castTo(const std::shared_ptr<ReaK::rtti::so_type>& aTypeID) const { \
-      if(*aTypeID == *(CLASS_NAME::getStaticObjectType())) \
-	return reinterpret_cast<const void*>(this); \
-      else { \
-	const void* result = BASE_NAME1::castTo(aTypeID); \
-	if(result) return result; \
-	result = BASE_NAME2::castTo(aTypeID); \
-	if(result) return result; \
-        return BASE_NAME3::castTo(aTypeID); \
-      }; \
+      return castTo(aTypeID->TypeID_begin()); \
     };
 
 /// This MACRO creates the static elements for the current class to be added to the global type registry (it is guaranteed to be added if the class is instantiated).
 #define RK_RTTI_REGISTER_CLASS_4BASE(CLASS_NAME,CLASS_VERSION,BASE_NAME1,BASE_NAME2,BASE_NAME3,BASE_NAME4) \
+    typedef ReaK::rtti::detail::base_type_list< BASE_NAME1, ReaK::rtti::detail::base_type_list< BASE_NAME2, ReaK::rtti::detail::base_type_list< BASE_NAME3, ReaK::rtti::detail::base_type_list< BASE_NAME4 > > > > rk_rtti_BaseList; \
     static std::shared_ptr<ReaK::rtti::so_type> RK_CALL getStaticObjectType() { \
-      return ReaK::rtti::register_type< CLASS_NAME , CLASS_VERSION , ReaK::rtti::detail::base_type_list< BASE_NAME1, ReaK::rtti::detail::base_type_list< BASE_NAME2 , ReaK::rtti::detail::base_type_list< BASE_NAME3 , ReaK::rtti::detail::base_type_list< BASE_NAME4 > > > > >::impl.ptr; \
+      return ReaK::rtti::register_type< CLASS_NAME , CLASS_VERSION , rk_rtti_BaseList >::impl.ptr; \
     }; \
     virtual std::shared_ptr<ReaK::rtti::so_type> RK_CALL getObjectType() const { \
       return CLASS_NAME::getStaticObjectType(); \
     };\
+    virtual void* RK_CALL castTo(const unsigned int* aTypeID) { \
+      return ReaK::rtti::detail::cast_to_type_id< CLASS_NAME >(this, aTypeID); \
+    };\
+    virtual const void* RK_CALL castTo(const unsigned int* aTypeID) const { \
+      return ReaK::rtti::detail::cast_to_type_id< CLASS_NAME >(this, aTypeID); \
+    };\
     virtual void* RK_CALL castTo(const std::shared_ptr<ReaK::rtti::so_type>& aTypeID) { \
-      if(*aTypeID == *(CLASS_NAME::getStaticObjectType())) \
-	return reinterpret_cast<void*>(this); \
-      else { \
-	void* result = BASE_NAME1::castTo(aTypeID); \
-	if(result) return result; \
-	result = BASE_NAME2::castTo(aTypeID); \
-	if(result) return result; \
-	result = BASE_NAME3::castTo(aTypeID); \
-	if(result) return result; \
-        return BASE_NAME4::castTo(aTypeID); \
-      }; \
+      return castTo(aTypeID->TypeID_begin()); \
     };\
     virtual const void* RK_CALL castTo(const std::shared_ptr<ReaK::rtti::so_type>& aTypeID) const { \
-      if(*aTypeID == *(CLASS_NAME::getStaticObjectType())) \
-	return reinterpret_cast<const void*>(this); \
-      else { \
-	const void* result = BASE_NAME1::castTo(aTypeID); \
-	if(result) return result; \
-	result = BASE_NAME2::castTo(aTypeID); \
-	if(result) return result; \
-	result = BASE_NAME3::castTo(aTypeID); \
-	if(result) return result; \
-        return BASE_NAME4::castTo(aTypeID); \
-      }; \
+      return castTo(aTypeID->TypeID_begin()); \
     };
     
 #endif
@@ -0,0 +1,152 @@
+
+/*
+ *    Copyright 2013 Sven Mikael Persson
+ *
+ *    THIS SOFTWARE IS DISTRIBUTED UNDER THE TERMS OF THE GNU GENERAL PUBLIC LICENSE v3 (GPLv3).
+ *
+ *    This file is part of ReaK.
+ *
+ *    ReaK is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    (at your option) any later version.
+ *
+ *    ReaK is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with ReaK (as LICENSE in the root folder).
+ *    If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "so_type_repo.hpp"
+
+#include "base/thread_incl.hpp"
+
+#include <vector>
+#include <cstdlib>
+
+#define BOOST_TEST_DYN_LINK
+
+#define BOOST_TEST_MODULE so_type_repo
+#include <boost/test/unit_test.hpp>
+
+
+namespace {
+
+using namespace ReaK;
+
+const unsigned int writer_count = 4;
+const unsigned int reader_count = 4;
+const unsigned int types_per_writer = 500;
+
+// zero-terminated type-IDs, one per added type.
+struct test_type_ids {
+  std::vector<unsigned int> ids;
+  test_type_ids() : ids(2 * writer_count * types_per_writer, 0) {
+    for(unsigned int i = 0; i < writer_count * types_per_writer; ++i)
+      ids[2 * i] = 0xD0000000 + i;
+  };
+  const unsigned int* get(unsigned int i) const { return &ids[2 * i]; };
+};
+
+struct type_writer {
+  const test_type_ids* ids;
+  std::vector< rtti::so_type::shared_pointer >* added;
+  unsigned int first;
+  
+  type_writer(const test_type_ids* aIds, std::vector< rtti::so_type::shared_pointer >* aAdded, unsigned int aFirst) :
+              ids(aIds), added(aAdded), first(aFirst) { };
+  
+  void operator()() {
+    for(unsigned int i = first; i < first + types_per_writer; ++i) {
+      rtti::so_type::shared_pointer t(new rtti::detail::dummy_so_type(ids->get(i)), scoped_deleter());
+      (*added)[i] = rtti::so_type_repo::getInstance().addType(t).lock();
+    };
+  };
+};
+
+// looks up the test types while they are being added (a miss searches the type hierarchies).
+struct type_reader {
+  const test_type_ids* ids;
+  bool* consistent;
+  unsigned int seed;
+  
+  type_reader(const test_type_ids* aIds, bool* aConsistent, unsigned int aSeed) :
+              ids(aIds), consistent(aConsistent), seed(aSeed) { };
+  
+  void operator()() {
+    for(unsigned int k = 0; k < 20000; ++k) {
+      seed = seed * 1103515245u + 12345u;
+      unsigned int i = (seed >> 8) % (writer_count * types_per_writer);
+      rtti::so_type::shared_pointer t = rtti::so_type_repo::getInstance().findType(ids->get(i)).lock();
+      if(t && !rtti::detail::equal_type_id(t->TypeID_begin(), ids->get(i)))
+        *consistent = false;
+    };
+  };
+};
+
+};
+
+
+BOOST_AUTO_TEST_CASE( so_type_repo_concurrent_add_find_test )
+{
+  test_type_ids ids;
+  std::vector< rtti::so_type::shared_pointer > added(writer_count * types_per_writer);
+  bool reader_flags[reader_count];
+  
+  std::vector< shared_ptr<ReaKaux::thread> > threads;
+  for(unsigned int r = 0; r < reader_count; ++r) {
+    reader_flags[r] = true;
+    threads.push_back(shared_ptr<ReaKaux::thread>(new ReaKaux::thread(type_reader(&ids, &reader_flags[r], 17 + r))));
+  };
+  for(unsigned int w = 0; w < writer_count; ++w)
+    threads.push_back(shared_ptr<ReaKaux::thread>(new ReaKaux::thread(type_writer(&ids, &added, w * types_per_writer))));
+  for(std::size_t i = 0; i < threads.size(); ++i)
+    threads[i]->join();
+  
+  for(unsigned int r = 0; r < reader_count; ++r)
+    BOOST_CHECK( reader_flags[r] );
+  
+  // every added type is found, in the index and in the type hierarchy.
+  unsigned int found_count = 0;
+  for(unsigned int i = 0; i < writer_count * types_per_writer; ++i) {
+    rtti::so_type::shared_pointer t = rtti::so_type_repo::getInstance().findType(ids.get(i)).lock();
+    if(t && (t == added[i]))
+      ++found_count;
+  };
+  BOOST_CHECK_EQUAL( found_count, writer_count * types_per_writer );
+  
+  // missing types are still reported as missing.
+  unsigned int missing_id[] = {0xDFFFFFFF, 0};
+  BOOST_CHECK( !rtti::so_type_repo::getInstance().findType(missing_id).lock() );
+};
+
+
+BOOST_AUTO_TEST_CASE( so_type_repo_concurrent_same_type_test )
+{
+  // threads adding the same type-ID concurrently all get the same registered type.
+  const unsigned int same_id[] = {0xDE000001, 0};
+  test_type_ids ids;
+  for(unsigned int i = 0; i < writer_count * types_per_writer; ++i)
+    ids.ids[2 * i] = same_id[0];
+  std::vector< rtti::so_type::shared_pointer > added(writer_count * types_per_writer);
+  
+  std::vector< shared_ptr<ReaKaux::thread> > threads;
+  for(unsigned int w = 0; w < writer_count; ++w)
+    threads.push_back(shared_ptr<ReaKaux::thread>(new ReaKaux::thread(type_writer(&ids, &added, w * types_per_writer))));
+  for(std::size_t i = 0; i < threads.size(); ++i)
+    threads[i]->join();
+  
+  rtti::so_type::shared_pointer t = rtti::so_type_repo::getInstance().findType(same_id).lock();
+  BOOST_REQUIRE( t );
+  unsigned int same_count = 0;
+  for(std::size_t i = 0; i < added.size(); ++i)
+    if(added[i] == t)
+      ++same_count;
+  // the first addition wins, the later ones (of the same version) return it.
+  BOOST_CHECK_EQUAL( same_count, added.size() );
+};
+
@@ -159,6 +159,24 @@ bin_iarchive::bin_iarchive(std::istream& aStream) {
 bin_iarchive::~bin_iarchive() {};
 
 
+serializable_shared_pointer RK_CALL bin_iarchive::get_loaded_object(unsigned int aObjID) {
+  if(aObjID < mObjRegistry.size())
+    return mObjRegistry[aObjID];
+  return serializable_shared_pointer();
+};
+
+void RK_CALL bin_iarchive::register_loaded_object(unsigned int aObjID, const serializable_shared_pointer& aObj) {
+  if(aObjID < mObjRegistry.size())  // somehow this object-ID was previously skipped over.
+    mObjRegistry[aObjID] = aObj;
+  else if(aObjID == mObjRegistry.size())
+    mObjRegistry.push_back(aObj);                //in theory, only this condition should occur
+  else if(aObjID > mObjRegistry.size()) {
+    mObjRegistry.resize(aObjID + 1);
+    mObjRegistry[aObjID] = aObj;
+  };
+};
+
+
 
 iarchive& RK_CALL bin_iarchive::load_serializable_ptr(serializable_shared_pointer& Item) {
   archive_object_header hdr;
@@ -179,8 +197,8 @@ iarchive& RK_CALL bin_iarchive::load_serializable_ptr(serializable_shared_pointe
     Item = serializable_shared_pointer();
     return *this;
   };
-  if((hdr.object_ID < mObjRegistry.size()) && (mObjRegistry[hdr.object_ID])) {
-    Item = mObjRegistry[hdr.object_ID];
+  Item = get_loaded_object(hdr.object_ID);
+  if(Item) {
     file_stream->ignore(hdr.size);
     return *this;
   };
@@ -220,14 +238,7 @@ iarchive& RK_CALL bin_iarchive::load_serializable_ptr(serializable_shared_pointe
   };
 
   Item = po;
-  if(hdr.object_ID < mObjRegistry.size())  // somehow this object-ID was previously skipped over.
-    mObjRegistry[hdr.object_ID] = Item;
-  else if(hdr.object_ID == mObjRegistry.size())
-    mObjRegistry.push_back(Item);                //in theory, only this condition should occur
-  else if(hdr.object_ID > mObjRegistry.size()) {
-    mObjRegistry.resize(hdr.object_ID + 1);
-    mObjRegistry[hdr.object_ID] = Item;
-  };
+  register_loaded_object(hdr.object_ID, Item);
 
   std::streampos start_pos = file_stream->tellg();
   Item->load(*this,hdr.type_version);
@@ -387,21 +398,24 @@ bin_oarchive::bin_oarchive(std::ostream& aStream) {
 
 bin_oarchive::~bin_oarchive() { };
 
+bool RK_CALL bin_oarchive::register_saved_object(const serializable_shared_pointer& aObj, unsigned int& aObjID) {
+  std::map< serializable_shared_pointer, unsigned int>::const_iterator it = mObjRegMap.find(aObj);
+  if(it != mObjRegMap.end()) {
+    aObjID = it->second;
+    return true;
+  };
+  aObjID = mObjRegistry.size();
+  mObjRegistry.push_back(aObj);
+  mObjRegMap[aObj] = aObjID;
+  return false;
+};
+
 oarchive& RK_CALL bin_oarchive::saveToNewArchive_impl(const serializable_shared_pointer& Item, const std::string& FileName) {
   archive_object_header hdr;
   bool already_saved(false);
 
   if(Item) {
-    std::map< serializable_shared_pointer, unsigned int>::const_iterator it = mObjRegMap.find(Item);
-
-    if(it != mObjRegMap.end()) {
-      hdr.object_ID = it->second;
-      already_saved = true;
-    } else {
-      hdr.object_ID = mObjRegistry.size();
-      mObjRegistry.push_back(Item);
-      mObjRegMap[Item] = hdr.object_ID;
-    };
+    already_saved = register_saved_object(Item, hdr.object_ID);
 
     rtti::so_type::shared_pointer obj_type = Item->getObjectType();
     const unsigned int* type_ID = obj_type->TypeID_begin();
@@ -458,16 +472,7 @@ oarchive& RK_CALL bin_oarchive::save_serializable_ptr(const serializable_shared_
   bool already_saved(false);
 
   if(Item) {
-    std::map< serializable_shared_pointer, unsigned int>::const_iterator it = mObjRegMap.find(Item);
-
-    if(it != mObjRegMap.end()) {
-      hdr.object_ID = it->second;
-      already_saved = true;
-    } else {
-      hdr.object_ID = mObjRegistry.size();
-      mObjRegistry.push_back(Item);
-      mObjRegMap[Item] = hdr.object_ID;
-    };
+    already_saved = register_saved_object(Item, hdr.object_ID);
 
     rtti::so_type::shared_pointer obj_type = Item->getObjectType();
     const unsigned int* type_ID = obj_type->TypeID_begin();
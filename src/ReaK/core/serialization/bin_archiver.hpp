@@ -53,6 +53,17 @@ class bin_iarchive : public iarchive {
     
   protected:
 
+    /**
+     * Returns the object already loaded with the given object-ID, or a null pointer if there is none.
+     * Derived archives can override this (and register_loaded_object) to share the registry of objects.
+     */
+    virtual serializable_shared_pointer RK_CALL get_loaded_object(unsigned int aObjID);
+
+    /**
+     * Registers an object that was created (before it is loaded) under the given object-ID.
+     */
+    virtual void RK_CALL register_loaded_object(unsigned int aObjID, const serializable_shared_pointer& aObj);
+
     virtual iarchive& RK_CALL load_serializable_ptr(serializable_shared_pointer& Item);
 
     virtual iarchive& RK_CALL load_serializable_ptr(const std::pair<std::string, serializable_shared_pointer& >& Item);
@@ -110,6 +121,13 @@ class bin_oarchive : public oarchive {
     
   protected:
 
+    /**
+     * Finds or assigns the object-ID of an object to be saved.
+     * Derived archives can override this to share the registry of objects.
+     * \return True if the object was already saved (under the object-ID aObjID).
+     */
+    virtual bool RK_CALL register_saved_object(const serializable_shared_pointer& aObj, unsigned int& aObjID);
+
     virtual oarchive& RK_CALL saveToNewArchive_impl(const serializable_shared_pointer& Item, const std::string& FileName);
 
     virtual oarchive& RK_CALL saveToNewArchiveNamed_impl(const std::pair<std::string, const serializable_shared_pointer& >& Item, const std::string& FileName);
@@ -0,0 +1,659 @@
+
+/*
+ *    Copyright 2013 Sven Mikael Persson
+ *
+ *    THIS SOFTWARE IS DISTRIBUTED UNDER THE TERMS OF THE GNU GENERAL PUBLIC LICENSE v3 (GPLv3).
+ *
+ *    This file is part of ReaK.
+ *
+ *    ReaK is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    (at your option) any later version.
+ *
+ *    ReaK is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with ReaK (as LICENSE in the root folder).
+ *    If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "chunked_bin_archiver.hpp"
+
+#include "bin_archiver.hpp"
+
+#include "base/shared_object.hpp"
+#include "base/thread_incl.hpp"
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <set>
+#include <map>
+#include <sstream>
+#include <fstream>
+
+namespace ReaK {
+
+namespace serialization {
+
+
+/*
+ * Chunked binary archive format (version 1):
+ *  - a directory, written as a binary archive: the header "reak_serialization::chunked_bin_archive",
+ *    the version, the number of blocks and, for each block, its kind (object or values), the
+ *    indices of the (earlier) blocks that it depends on, and its size;
+ *  - the blocks, back-to-back, each being a complete binary archive (see bin_archiver.hpp).
+ * The object-IDs are global to the archive, and the block that first saves an object owns it,
+ * such that a block only depends on earlier blocks.
+ */
+
+namespace {
+
+const unsigned int chunk_object_block = 1;
+const unsigned int chunk_value_block  = 2;
+
+struct chunk_ostream_holder {
+  std::ostringstream block_stream;
+};
+
+struct chunk_istream_holder {
+  std::istringstream block_stream;
+  explicit chunk_istream_holder(const std::string& aData) : block_stream(aData) { };
+};
+
+};
+
+
+class chunked_bin_oarchive_impl {
+  public:
+    struct block_record {
+      unsigned int kind;
+      std::set<unsigned int> deps;
+      std::string data;
+    };
+    
+    /* This archive saves one block, with its object-IDs registered in the archive-wide registry. */
+    class block_oarchive : private chunk_ostream_holder, public bin_oarchive {
+      private:
+        chunked_bin_oarchive_impl* owner;
+        unsigned int block_index;
+        
+      protected:
+        virtual bool RK_CALL register_saved_object(const serializable_shared_pointer& aObj, unsigned int& aObjID) {
+          return owner->register_object(aObj, aObjID, block_index);
+        };
+        
+      public:
+        using bin_oarchive::saveToNewArchive_impl;
+        using bin_oarchive::save_serializable_ptr;
+        using bin_oarchive::save_serializable;
+        using bin_oarchive::save_char;
+        using bin_oarchive::save_unsigned_char;
+        using bin_oarchive::save_int;
+        using bin_oarchive::save_unsigned_int;
+        using bin_oarchive::save_float;
+        using bin_oarchive::save_double;
+        using bin_oarchive::save_bool;
+        using bin_oarchive::save_string;
+        
+        block_oarchive(chunked_bin_oarchive_impl* aOwner, unsigned int aBlockIndex) : 
+                       chunk_ostream_holder(), bin_oarchive(block_stream),
+                       owner(aOwner), block_index(aBlockIndex) { };
+        
+        std::string get_data() const { return block_stream.str(); };
+        unsigned int get_block_index() const { return block_index; };
+    };
+    
+    shared_ptr< std::ostream > file_stream;
+    std::vector< block_record > blocks;
+    std::map< serializable_shared_pointer, unsigned int > obj_ids;
+    std::vector< unsigned int > obj_owners;  // the block that owns each object-ID (0 is the null pointer).
+    shared_ptr< block_oarchive > value_block;
+    bool closed;
+    
+    explicit chunked_bin_oarchive_impl(const shared_ptr< std::ostream >& aStream) : 
+                                       file_stream(aStream), blocks(), obj_ids(), 
+                                       obj_owners(1, 0), value_block(), closed(false) { };
+    
+    bool register_object(const serializable_shared_pointer& aObj, unsigned int& aObjID, unsigned int aBlockIndex) {
+      std::map< serializable_shared_pointer, unsigned int >::const_iterator it = obj_ids.find(aObj);
+      if(it != obj_ids.end()) {
+        aObjID = it->second;
+        if(obj_owners[aObjID] != aBlockIndex)
+          blocks[aBlockIndex].deps.insert(obj_owners[aObjID]);
+        return true;
+      };
+      aObjID = obj_owners.size();
+      obj_owners.push_back(aBlockIndex);
+      obj_ids[aObj] = aObjID;
+      return false;
+    };
+    
+    unsigned int add_block(unsigned int aKind) {
+      if(closed)
+        throw std::ios_base::failure("Chunked Binary Archive was already closed, nothing more can be saved to it!");
+      blocks.push_back(block_record());
+      blocks.back().kind = aKind;
+      return blocks.size() - 1;
+    };
+    
+    block_oarchive& get_value_block() {
+      if(!value_block)
+        value_block = shared_ptr< block_oarchive >(new block_oarchive(this, add_block(chunk_value_block)));
+      return *value_block;
+    };
+    
+    void close_value_block() {
+      if(!value_block)
+        return;
+      blocks[value_block->get_block_index()].data = value_block->get_data();
+      value_block.reset();
+    };
+    
+    void write_archive() {
+      if(closed)
+        return;
+      closed = true;  // even if it fails, the archive is not written a second time (by the destructor).
+      close_value_block();
+      if(!(*file_stream))
+        throw std::ios_base::failure("Chunked Binary Archive could not be opened for writing!");
+      {
+        bin_oarchive dir(*file_stream);
+        unsigned int version = 1;
+        unsigned int block_count = blocks.size();
+        dir << std::string("reak_serialization::chunked_bin_archive") << version << block_count;
+        for(std::size_t i = 0; i < blocks.size(); ++i) {
+          unsigned int dep_count = blocks[i].deps.size();
+          dir << blocks[i].kind << dep_count;
+          for(std::set<unsigned int>::const_iterator it = blocks[i].deps.begin(); it != blocks[i].deps.end(); ++it)
+            dir << *it;
+          unsigned int block_size = blocks[i].data.size();
+          dir << block_size;
+        };
+      };
+      for(std::size_t i = 0; i < blocks.size(); ++i)
+        file_stream->write(blocks[i].data.data(), blocks[i].data.size());
+      file_stream->flush();
+      if(!(*file_stream))
+        throw std::ios_base::failure("Chunked Binary Archive could not be written!");
+    };
+};
+
+
+class chunked_bin_iarchive_impl {
+  public:
+    struct block_record {
+      unsigned int kind;
+      std::vector<unsigned int> deps;
+      std::string data;
+      bool loaded;
+      serializable_shared_pointer root;
+    };
+    
+    /* This archive loads one block, with its objects registered in the (shared) archive-wide registry. */
+    class block_iarchive : private chunk_istream_holder, public bin_iarchive {
+      private:
+        chunked_bin_iarchive_impl* owner;
+        
+      protected:
+        virtual serializable_shared_pointer RK_CALL get_loaded_object(unsigned int aObjID) {
+          return owner->get_object(aObjID);
+        };
+        
+        virtual void RK_CALL register_loaded_object(unsigned int aObjID, const serializable_shared_pointer& aObj) {
+          owner->register_object(aObjID, aObj);
+        };
+        
+      public:
+        using bin_iarchive::load_serializable_ptr;
+        using bin_iarchive::load_serializable;
+        using bin_iarchive::load_char;
+        using bin_iarchive::load_unsigned_char;
+        using bin_iarchive::load_int;
+        using bin_iarchive::load_unsigned_int;
+        using bin_iarchive::load_float;
+        using bin_iarchive::load_double;
+        using bin_iarchive::load_bool;
+        using bin_iarchive::load_string;
+        
+        block_iarchive(chunked_bin_iarchive_impl* aOwner, const std::string& aData) : 
+                       chunk_istream_holder(aData), bin_iarchive(block_stream), owner(aOwner) { };
+    };
+    
+    /* The function object run by each thread of the pool. */
+    struct worker {
+      chunked_bin_iarchive_impl* parent;
+      explicit worker(chunked_bin_iarchive_impl* aParent) : parent(aParent) { };
+      void operator()() { parent->run_worker(); };
+    };
+    
+    std::vector< block_record > blocks;
+    
+    ReaKaux::mutex registry_mutex;
+    std::vector< serializable_shared_pointer > registry;
+    
+    ReaKaux::mutex queue_mutex;
+    ReaKaux::condition_variable queue_cond;
+    std::deque< unsigned int > ready_blocks;
+    std::vector< unsigned int > pending_deps;
+    std::vector< std::vector< unsigned int > > dependents;
+    std::size_t remaining_count;
+    bool failed;
+    std::string error_message;
+    
+    std::size_t next_block;
+    shared_ptr< block_iarchive > value_block;
+    
+    chunked_bin_iarchive_impl() : blocks(), registry(1), ready_blocks(), pending_deps(), dependents(),
+                                  remaining_count(0), failed(false), error_message(), 
+                                  next_block(0), value_block() { };
+    
+    serializable_shared_pointer get_object(unsigned int aObjID) {
+      ReaKaux::unique_lock< ReaKaux::mutex > lock(registry_mutex);
+      if(aObjID < registry.size())
+        return registry[aObjID];
+      return serializable_shared_pointer();
+    };
+    
+    void register_object(unsigned int aObjID, const serializable_shared_pointer& aObj) {
+      ReaKaux::unique_lock< ReaKaux::mutex > lock(registry_mutex);
+      if(aObjID >= registry.size())
+        registry.resize(aObjID + 1);
+      registry[aObjID] = aObj;
+    };
+    
+    void load_object_block(unsigned int aIndex) {
+      block_iarchive blk(this, blocks[aIndex].data);
+      blk.load_serializable_ptr(blocks[aIndex].root);
+      blocks[aIndex].loaded = true;
+    };
+    
+    void run_worker() {
+      ReaKaux::unique_lock< ReaKaux::mutex > lock(queue_mutex);
+      while(true) {
+        while(ready_blocks.empty() && (remaining_count > 0) && !failed)
+          queue_cond.wait(lock);
+        if(failed || ready_blocks.empty())
+          break;
+        unsigned int i = ready_blocks.front();
+        ready_blocks.pop_front();
+        lock.unlock();
+        
+        std::string err_msg;
+        bool succeeded = true;
+        try {
+          load_object_block(i);
+        } catch(std::exception& e) {
+          succeeded = false;
+          err_msg = e.what();
+        } catch(...) {
+          succeeded = false;
+          err_msg = "unknown exception";
+        };
+        
+        lock.lock();
+        if(!succeeded) {
+          failed = true;
+          error_message = err_msg;
+          queue_cond.notify_all();
+          break;
+        };
+        for(std::size_t j = 0; j < dependents[i].size(); ++j)
+          if(--pending_deps[dependents[i][j]] == 0)
+            ready_blocks.push_back(dependents[i][j]);
+        --remaining_count;
+        queue_cond.notify_all();
+      };
+    };
+    
+    void read_archive(std::istream& aStream, unsigned int aThreadCount) {
+      {
+        bin_iarchive dir(aStream);
+        std::string header;
+        unsigned int version = 0;
+        unsigned int block_count = 0;
+        dir >> header >> version;
+        if(!(header == "reak_serialization::chunked_bin_archive"))
+          throw std::ios_base::failure("Chunked Binary Archive has a corrupt header!");
+        if(version != 1)
+          throw std::ios_base::failure("Chunked Binary Archive is of an unknown file version!");
+        dir >> block_count;
+        blocks.resize(block_count);
+        for(std::size_t i = 0; i < blocks.size(); ++i) {
+          unsigned int dep_count = 0;
+          dir >> blocks[i].kind >> dep_count;
+          blocks[i].deps.resize(dep_count);
+          for(std::size_t j = 0; j < dep_count; ++j) {
+            dir >> blocks[i].deps[j];
+            if(blocks[i].deps[j] >= i)
+              throw std::ios_base::failure("Chunked Binary Archive has a corrupt block directory!");
+          };
+          unsigned int block_size = 0;
+          dir >> block_size;
+          blocks[i].data.resize(block_size);
+          blocks[i].loaded = false;
+        };
+      };
+      for(std::size_t i = 0; i < blocks.size(); ++i) {
+        if(blocks[i].data.size())
+          aStream.read(&(blocks[i].data[0]), blocks[i].data.size());
+      };
+      if(!aStream)
+        throw std::ios_base::failure("Chunked Binary Archive is truncated!");
+      
+      // the object blocks that only depend on such blocks can be loaded right away (independently of the values).
+      std::vector<bool> is_eager(blocks.size(), false);
+      pending_deps.resize(blocks.size(), 0);
+      dependents.resize(blocks.size());
+      for(std::size_t i = 0; i < blocks.size(); ++i) {
+        if(blocks[i].kind != chunk_object_block)
+          continue;
+        is_eager[i] = true;
+        for(std::size_t j = 0; j < blocks[i].deps.size(); ++j)
+          if(!is_eager[blocks[i].deps[j]])
+            is_eager[i] = false;
+        if(!is_eager[i])
+          continue;
+        ++remaining_count;
+        pending_deps[i] = blocks[i].deps.size();
+        for(std::size_t j = 0; j < blocks[i].deps.size(); ++j)
+          dependents[blocks[i].deps[j]].push_back(i);
+        if(pending_deps[i] == 0)
+          ready_blocks.push_back(i);
+      };
+      
+      if(aThreadCount == 0)
+        aThreadCount = ReaKaux::thread::hardware_concurrency();
+      if(aThreadCount > remaining_count)
+        aThreadCount = remaining_count;
+      
+      if(aThreadCount < 2) {
+        // the blocks only depend on earlier blocks, so the sequential order is always valid.
+        for(std::size_t i = 0; i < blocks.size(); ++i)
+          if(is_eager[i])
+            load_object_block(i);
+        return;
+      };
+      
+      std::vector< shared_ptr< ReaKaux::thread > > workers;
+      for(unsigned int i = 0; i < aThreadCount; ++i)
+        workers.push_back(shared_ptr< ReaKaux::thread >(new ReaKaux::thread(worker(this))));
+      for(std::size_t i = 0; i < workers.size(); ++i)
+        workers[i]->join();
+      if(failed)
+        throw std::ios_base::failure("Chunked Binary Archive could not load a block: " + error_message);
+    };
+    
+    block_iarchive& get_value_block() {
+      if(!value_block) {
+        if((next_block >= blocks.size()) || (blocks[next_block].kind != chunk_value_block))
+          throw std::ios_base::failure("Chunked Binary Archive has no value to read at this point!");
+        value_block = shared_ptr< block_iarchive >(new block_iarchive(this, blocks[next_block].data));
+        ++next_block;
+      };
+      return *value_block;
+    };
+    
+    serializable_shared_pointer get_next_object() {
+      value_block.reset();
+      if((next_block >= blocks.size()) || (blocks[next_block].kind != chunk_object_block))
+        throw std::ios_base::failure("Chunked Binary Archive has no object to read at this point!");
+      if(!blocks[next_block].loaded)
+        load_object_block(next_block);
+      serializable_shared_pointer result = blocks[next_block].root;
+      blocks[next_block].root.reset();
+      blocks[next_block].data.clear();
+      ++next_block;
+      return result;
+    };
+};
+
+
+
+chunked_bin_iarchive::chunked_bin_iarchive(const std::string& FileName, unsigned int aThreadCount) :
+                                           pimpl(new chunked_bin_iarchive_impl()) {
+  std::ifstream file_stream(FileName.c_str(), std::ios::binary | std::ios::in);
+  pimpl->read_archive(file_stream, aThreadCount);
+};
+
+chunked_bin_iarchive::chunked_bin_iarchive(std::istream& aStream, unsigned int aThreadCount) :
+                                           pimpl(new chunked_bin_iarchive_impl()) {
+  pimpl->read_archive(aStream, aThreadCount);
+};
+
+chunked_bin_iarchive::~chunked_bin_iarchive() { };
+
+
+iarchive& RK_CALL chunked_bin_iarchive::load_serializable_ptr(serializable_shared_pointer& Item) {
+  Item = pimpl->get_next_object();
+  return *this;
+};
+
+iarchive& RK_CALL chunked_bin_iarchive::load_serializable_ptr(const std::pair<std::string, serializable_shared_pointer& >& Item) {
+  return chunked_bin_iarchive::load_serializable_ptr(Item.second);
+};
+
+iarchive& RK_CALL chunked_bin_iarchive::load_serializable(serializable& Item) {
+  pimpl->get_value_block().load_serializable(Item);
+  return *this;
+};
+
+iarchive& RK_CALL chunked_bin_iarchive::load_serializable(const std::pair<std::string, serializable& >& Item) {
+  return chunked_bin_iarchive::load_serializable(Item.second);
+};
+
+iarchive& RK_CALL chunked_bin_iarchive::load_char(char& i) {
+  pimpl->get_value_block().load_char(i);
+  return *this;
+};
+
+iarchive& RK_CALL chunked_bin_iarchive::load_char(const std::pair<std::string, char& >& i) {
+  return chunked_bin_iarchive::load_char(i.second);
+};
+
+iarchive& RK_CALL chunked_bin_iarchive::load_unsigned_char(unsigned char& u) {
+  pimpl->get_value_block().load_unsigned_char(u);
+  return *this;
+};
+
+iarchive& RK_CALL chunked_bin_iarchive::load_unsigned_char(const std::pair<std::string, unsigned char& >& u) {
+  return chunked_bin_iarchive::load_unsigned_char(u.second);
+};
+
+iarchive& RK_CALL chunked_bin_iarchive::load_int(int& i) {
+  pimpl->get_value_block().load_int(i);
+  return *this;
+};
+
+iarchive& RK_CALL chunked_bin_iarchive::load_int(const std::pair<std::string, int& >& i) {
+  return chunked_bin_iarchive::load_int(i.second);
+};
+
+iarchive& RK_CALL chunked_bin_iarchive::load_unsigned_int(unsigned int& u) {
+  pimpl->get_value_block().load_unsigned_int(u);
+  return *this;
+};
+
+iarchive& RK_CALL chunked_bin_iarchive::load_unsigned_int(const std::pair<std::string, unsigned int& >& u) {
+  return chunked_bin_iarchive::load_unsigned_int(u.second);
+};
+
+iarchive& RK_CALL chunked_bin_iarchive::load_float(float& f) {
+  pimpl->get_value_block().load_float(f);
+  return *this;
+};
+
+iarchive& RK_CALL chunked_bin_iarchive::load_float(const std::pair<std::string, float& >& f) {
+  return chunked_bin_iarchive::load_float(f.second);
+};
+
+iarchive& RK_CALL chunked_bin_iarchive::load_double(double& d) {
+  pimpl->get_value_block().load_double(d);
+  return *this;
+};
+
+iarchive& RK_CALL chunked_bin_iarchive::load_double(const std::pair<std::string, double& >& d) {
+  return chunked_bin_iarchive::load_double(d.second);
+};
+
+iarchive& RK_CALL chunked_bin_iarchive::load_bool(bool& b) {
+  pimpl->get_value_block().load_bool(b);
+  return *this;
+};
+
+iarchive& RK_CALL chunked_bin_iarchive::load_bool(const std::pair<std::string, bool& >& b) {
+  return chunked_bin_iarchive::load_bool(b.second);
+};
+
+iarchive& RK_CALL chunked_bin_iarchive::load_string(std::string& s) {
+  pimpl->get_value_block().load_string(s);
+  return *this;
+};
+
+iarchive& RK_CALL chunked_bin_iarchive::load_string(const std::pair<std::string, std::string& >& s) {
+  return chunked_bin_iarchive::load_string(s.second);
+};
+
+
+
+
+
+
+
+
+
+
+
+chunked_bin_oarchive::chunked_bin_oarchive(const std::string& FileName) :
+                                           pimpl(new chunked_bin_oarchive_impl(shared_ptr< std::ostream >(
+                                             new std::ofstream(FileName.c_str(), std::ios::binary | std::ios::out)))) { };
+
+chunked_bin_oarchive::chunked_bin_oarchive(std::ostream& aStream) :
+                                           pimpl(new chunked_bin_oarchive_impl(shared_ptr< std::ostream >(&aStream, null_deleter()))) { };
+
+chunked_bin_oarchive::~chunked_bin_oarchive() {
+  try {
+    pimpl->write_archive();
+  } catch(...) { };
+};
+
+void chunked_bin_oarchive::close() {
+  pimpl->write_archive();
+};
+
+oarchive& RK_CALL chunked_bin_oarchive::saveToNewArchive_impl(const serializable_shared_pointer& Item, const std::string& FileName) {
+  pimpl->close_value_block();
+  unsigned int i = pimpl->add_block(chunk_object_block);
+  chunked_bin_oarchive_impl::block_oarchive blk(pimpl.get(), i);
+  blk.saveToNewArchive_impl(Item, FileName);
+  pimpl->blocks[i].data = blk.get_data();
+  return *this;
+};
+
+oarchive& RK_CALL chunked_bin_oarchive::saveToNewArchiveNamed_impl(const std::pair<std::string, const serializable_shared_pointer& >& Item, const std::string& FileName) {
+  return chunked_bin_oarchive::saveToNewArchive_impl(Item.second,FileName);
+};
+
+oarchive& RK_CALL chunked_bin_oarchive::save_serializable_ptr(const serializable_shared_pointer& Item) {
+  pimpl->close_value_block();
+  unsigned int i = pimpl->add_block(chunk_object_block);
+  chunked_bin_oarchive_impl::block_oarchive blk(pimpl.get(), i);
+  blk.save_serializable_ptr(Item);
+  pimpl->blocks[i].data = blk.get_data();
+  return *this;
+};
+
+oarchive& RK_CALL chunked_bin_oarchive::save_serializable_ptr(const std::pair<std::string, const serializable_shared_pointer& >& Item) {
+  return chunked_bin_oarchive::save_serializable_ptr(Item.second);
+};
+
+oarchive& RK_CALL chunked_bin_oarchive::save_serializable(const serializable& Item) {
+  pimpl->get_value_block().save_serializable(Item);
+  return *this;
+};
+
+oarchive& RK_CALL chunked_bin_oarchive::save_serializable(const std::pair<std::string, const serializable& >& Item) {
+  return chunked_bin_oarchive::save_serializable(Item.second);
+};
+
+oarchive& RK_CALL chunked_bin_oarchive::save_char(char i) {
+  pimpl->get_value_block().save_char(i);
+  return *this;
+};
+
+oarchive& RK_CALL chunked_bin_oarchive::save_char(const std::pair<std::string, char >& i) {
+  return chunked_bin_oarchive::save_char(i.second);
+};
+
+oarchive& RK_CALL chunked_bin_oarchive::save_unsigned_char(unsigned char u) {
+  pimpl->get_value_block().save_unsigned_char(u);
+  return *this;
+};
+
+oarchive& RK_CALL chunked_bin_oarchive::save_unsigned_char(const std::pair<std::string, unsigned char >& u) {
+  return chunked_bin_oarchive::save_unsigned_char(u.second);
+};
+
+oarchive& RK_CALL chunked_bin_oarchive::save_int(int i) {
+  pimpl->get_value_block().save_int(i);
+  return *this;
+};
+
+oarchive& RK_CALL chunked_bin_oarchive::save_int(const std::pair<std::string, int >& i) {
+  return chunked_bin_oarchive::save_int(i.second);
+};
+
+oarchive& RK_CALL chunked_bin_oarchive::save_unsigned_int(unsigned int u) {
+  pimpl->get_value_block().save_unsigned_int(u);
+  return *this;
+};
+
+oarchive& RK_CALL chunked_bin_oarchive::save_unsigned_int(const std::pair<std::string, unsigned int >& u) {
+  return chunked_bin_oarchive::save_unsigned_int(u.second);
+};
+
+oarchive& RK_CALL chunked_bin_oarchive::save_float(float f) {
+  pimpl->get_value_block().save_float(f);
+  return *this;
+};
+
+oarchive& RK_CALL chunked_bin_oarchive::save_float(const std::pair<std::string, float >& f) {
+  return chunked_bin_oarchive::save_float(f.second);
+};
+
+oarchive& RK_CALL chunked_bin_oarchive::save_double(double d) {
+  pimpl->get_value_block().save_double(d);
+  return *this;
+};
+
+oarchive& RK_CALL chunked_bin_oarchive::save_double(const std::pair<std::string, double >& d) {
+  return chunked_bin_oarchive::save_double(d.second);
+};
+
+oarchive& RK_CALL chunked_bin_oarchive::save_bool(bool b) {
+  pimpl->get_value_block().save_bool(b);
+  return *this;
+};
+
+oarchive& RK_CALL chunked_bin_oarchive::save_bool(const std::pair<std::string, bool >& b) {
+  return chunked_bin_oarchive::save_bool(b.second);
+};
+
+oarchive& RK_CALL chunked_bin_oarchive::save_string(const std::string& s) {
+  pimpl->get_value_block().save_string(s);
+  return *this;
+};
+
+oarchive& RK_CALL chunked_bin_oarchive::save_string(const std::pair<std::string, const std::string& >& s) {
+  return chunked_bin_oarchive::save_string(s.second);
+};
+
+
+};
+
+};
+
@@ -0,0 +1,211 @@
+/**
+ * \file chunked_bin_archiver.hpp
+ *
+ * This library declares the classes for a chunked binary archive, i.e., a binary archive in which
+ * each top-level object (pointer) is stored as a separately addressable block (itself a complete
+ * binary archive), preceded by a directory of the blocks and of the blocks on which each depends
+ * (through shared objects). When reading such an archive, the blocks of independent object graphs
+ * are deserialized in parallel, on a pool of threads that share a (thread-safe) object registry.
+ *
+ * \author Sven Mikael Persson <mikael.s.persson@gmail.com>
+ * \date June 2013
+ */
+
+/*
+ *    Copyright 2013 Sven Mikael Persson
+ *
+ *    THIS SOFTWARE IS DISTRIBUTED UNDER THE TERMS OF THE GNU GENERAL PUBLIC LICENSE v3 (GPLv3).
+ *
+ *    This file is part of ReaK.
+ *
+ *    ReaK is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    (at your option) any later version.
+ *
+ *    ReaK is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with ReaK (as LICENSE in the root folder).
+ *    If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef REAK_CHUNKED_BIN_ARCHIVER_HPP
+#define REAK_CHUNKED_BIN_ARCHIVER_HPP
+
+#include "archiver.hpp"
+
+#include <iostream>
+#include <utility>
+#include <string>
+
+namespace ReaK {
+
+namespace serialization {
+
+
+class chunked_bin_iarchive_impl;
+class chunked_bin_oarchive_impl;
+
+
+/**
+ * Chunked binary input archive. All the blocks are read when the archive is constructed, and the
+ * object blocks which do not depend on plain values (values and objects saved by reference at the top
+ * level) are deserialized at that point, in parallel. Each top-level read then returns the next
+ * item, in the order in which they were saved (as with any other archive), and the remaining blocks
+ * are deserialized on demand. Shared objects between blocks are resolved through the object-IDs,
+ * which are global to the archive, and a block is only deserialized once the blocks that own the
+ * objects that it refers to are loaded.
+ */
+class chunked_bin_iarchive : public iarchive {
+  private:
+    shared_ptr< chunked_bin_iarchive_impl > pimpl;
+    
+  protected:
+
+    virtual iarchive& RK_CALL load_serializable_ptr(serializable_shared_pointer& Item);
+
+    virtual iarchive& RK_CALL load_serializable_ptr(const std::pair<std::string, serializable_shared_pointer& >& Item);
+
+    virtual iarchive& RK_CALL load_serializable(serializable& Item);
+
+    virtual iarchive& RK_CALL load_serializable(const std::pair<std::string, serializable& >& Item);
+
+    virtual iarchive& RK_CALL load_char(char& i);
+
+    virtual iarchive& RK_CALL load_char(const std::pair<std::string, char& >& i);
+
+    virtual iarchive& RK_CALL load_unsigned_char(unsigned char& u);
+
+    virtual iarchive& RK_CALL load_unsigned_char(const std::pair<std::string, unsigned char& >& u);
+
+    virtual iarchive& RK_CALL load_int(int& i);
+
+    virtual iarchive& RK_CALL load_int(const std::pair<std::string, int& >& i);
+
+    virtual iarchive& RK_CALL load_unsigned_int(unsigned int& u);
+
+    virtual iarchive& RK_CALL load_unsigned_int(const std::pair<std::string, unsigned int& >& u);
+
+    virtual iarchive& RK_CALL load_float(float& f);
+
+    virtual iarchive& RK_CALL load_float(const std::pair<std::string, float& >& f);
+
+    virtual iarchive& RK_CALL load_double(double& d);
+
+    virtual iarchive& RK_CALL load_double(const std::pair<std::string, double& >& d);
+
+    virtual iarchive& RK_CALL load_bool(bool& b);
+
+    virtual iarchive& RK_CALL load_bool(const std::pair<std::string, bool& >& b);
+
+    virtual iarchive& RK_CALL load_string(std::string& s);
+
+    virtual iarchive& RK_CALL load_string(const std::pair<std::string, std::string& >& s);
+
+  public:
+
+    /**
+     * Opens and reads the archive from a file, and deserializes its independent blocks.
+     * \param FileName The name of the file to read from.
+     * \param aThreadCount The number of threads to use (0 for the number of hardware threads).
+     */
+    chunked_bin_iarchive(const std::string& FileName, unsigned int aThreadCount = 0);
+    
+    /**
+     * Reads the archive from a stream, and deserializes its independent blocks.
+     * \param aStream The stream to read from.
+     * \param aThreadCount The number of threads to use (0 for the number of hardware threads).
+     */
+    chunked_bin_iarchive(std::istream& aStream, unsigned int aThreadCount = 0);
+    
+    virtual ~chunked_bin_iarchive();
+
+};
+
+/**
+ * Chunked binary output archive. Each top-level object (pointer) is saved to its own block, while
+ * consecutive top-level values (and objects saved by reference) are grouped in value blocks.
+ * The archive is only written to the file (or stream) when it is closed, either explicitly by close(),
+ * which reports write errors, or when the archive is destroyed, in which case write errors are ignored.
+ */
+class chunked_bin_oarchive : public oarchive {
+  private:
+    shared_ptr< chunked_bin_oarchive_impl > pimpl;
+    
+  protected:
+
+    virtual oarchive& RK_CALL saveToNewArchive_impl(const serializable_shared_pointer& Item, const std::string& FileName);
+
+    virtual oarchive& RK_CALL saveToNewArchiveNamed_impl(const std::pair<std::string, const serializable_shared_pointer& >& Item, const std::string& FileName);
+
+    virtual oarchive& RK_CALL save_serializable_ptr(const serializable_shared_pointer& Item);
+
+    virtual oarchive& RK_CALL save_serializable_ptr(const std::pair<std::string, const serializable_shared_pointer& >& Item);
+
+    virtual oarchive& RK_CALL save_serializable(const serializable& Item);
+
+    virtual oarchive& RK_CALL save_serializable(const std::pair<std::string, const serializable& >& Item);
+
+    virtual oarchive& RK_CALL save_char(char i);
+
+    virtual oarchive& RK_CALL save_char(const std::pair<std::string, char >& i);
+
+    virtual oarchive& RK_CALL save_unsigned_char(unsigned char u);
+
+    virtual oarchive& RK_CALL save_unsigned_char(const std::pair<std::string, unsigned char >& u);
+
+    virtual oarchive& RK_CALL save_int(int i);
+
+    virtual oarchive& RK_CALL save_int(const std::pair<std::string, int >& i);
+
+    virtual oarchive& RK_CALL save_unsigned_int(unsigned int u);
+
+    virtual oarchive& RK_CALL save_unsigned_int(const std::pair<std::string, unsigned int >& u);
+
+    virtual oarchive& RK_CALL save_float(float f);
+
+    virtual oarchive& RK_CALL save_float(const std::pair<std::string, float >& f);
+
+    virtual oarchive& RK_CALL save_double(double d);
+
+    virtual oarchive& RK_CALL save_double(const std::pair<std::string, double >& d);
+
+    virtual oarchive& RK_CALL save_bool(bool b);
+
+    virtual oarchive& RK_CALL save_bool(const std::pair<std::string, bool >& b);
+
+    virtual oarchive& RK_CALL save_string(const std::string& s);
+
+    virtual oarchive& RK_CALL save_string(const std::pair<std::string, const std::string& >& s);
+
+  public:
+
+    chunked_bin_oarchive(const std::string& FileName);
+    chunked_bin_oarchive(std::ostream& aStream);
+    
+    /**
+     * Destroys the archive, writing it to the file (or stream) if it was not closed already.
+     * Write errors are ignored at this point, call close() to get them reported.
+     */
+    virtual ~chunked_bin_oarchive();
+    
+    /**
+     * Writes the archive to the file (or stream), after which nothing more can be saved to it.
+     * Calling close() again has no effect.
+     * \throws std::ios_base::failure If the file could not be opened or written.
+     */
+    void close();
+
+};
+
+
+}; //serialization
+
+}; //ReaK
+
+#endif
+
@@ -0,0 +1,133 @@
+
+/*
+ *    Copyright 2013 Sven Mikael Persson
+ *
+ *    THIS SOFTWARE IS DISTRIBUTED UNDER THE TERMS OF THE GNU GENERAL PUBLIC LICENSE v3 (GPLv3).
+ *
+ *    This file is part of ReaK.
+ *
+ *    ReaK is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    (at your option) any later version.
+ *
+ *    ReaK is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with ReaK (as LICENSE in the root folder).
+ *    If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "xml_archiver.hpp"
+#include "xml_tokenizer.hpp"
+
+#include "base/named_object.hpp"
+#include "base/chrono_incl.hpp"
+
+#include <sstream>
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+
+
+/*
+ * Benchmark of the parsing of XML archives (xml_iarchive), on a generated archive of model-like
+ * objects (named objects with a few scalar fields, a string, and arrays of numbers). It reports the
+ * throughput of the tokenizer alone (scanning all the tags), and of the complete loading of the objects.
+ */
+
+namespace ReaK {
+
+class xml_perf_object : public named_object {
+  public:
+    int m_index;
+    double m_mass;
+    std::string m_label;
+    std::vector<double> m_values;
+    
+    xml_perf_object(int aIndex = 0) : m_index(aIndex), m_mass(0.5 * aIndex), m_label("link"), m_values() {
+      setName("xml_perf_object");
+      for(int i = 0; i < 24; ++i)
+        m_values.push_back(0.001 * (aIndex + i));
+    };
+    
+    virtual void RK_CALL save(serialization::oarchive& A, unsigned int) const {
+      named_object::save(A,named_object::getStaticObjectType()->TypeVersion());
+      A & RK_SERIAL_SAVE_WITH_NAME(m_index)
+        & RK_SERIAL_SAVE_WITH_NAME(m_mass)
+        & RK_SERIAL_SAVE_WITH_NAME(m_label)
+        & RK_SERIAL_SAVE_WITH_NAME(m_values);
+    };
+    virtual void RK_CALL load(serialization::iarchive& A, unsigned int) {
+      named_object::load(A,named_object::getStaticObjectType()->TypeVersion());
+      A & RK_SERIAL_LOAD_WITH_NAME(m_index)
+        & RK_SERIAL_LOAD_WITH_NAME(m_mass)
+        & RK_SERIAL_LOAD_WITH_NAME(m_label)
+        & RK_SERIAL_LOAD_WITH_NAME(m_values);
+    };
+    
+    RK_RTTI_MAKE_CONCRETE_1BASE(xml_perf_object, 0xC0000010, 1, "xml_perf_object", named_object)
+};
+
+};
+
+
+int main(int argc, char** argv) {
+  using namespace ReaK;
+  using namespace serialization;
+  using namespace ReaKaux::chrono;
+  
+  std::size_t count = 2000;
+  if(argc > 1)
+    count = std::atoi(argv[1]);
+  
+  std::string xml_text;
+  {
+    std::vector< shared_ptr< xml_perf_object > > objects;
+    for(std::size_t i = 0; i < count; ++i)
+      objects.push_back(shared_ptr< xml_perf_object >(new xml_perf_object(int(i))));
+    std::stringstream ss;
+    {
+      xml_oarchive out(ss);
+      out & RK_SERIAL_SAVE_WITH_NAME(objects);
+    };
+    xml_text = ss.str();
+  };
+  const double mbytes = double(xml_text.size()) / (1024.0 * 1024.0);
+  
+  std::size_t tag_count = 0;
+  high_resolution_clock::time_point t0 = high_resolution_clock::now();
+  {
+    xml_tokenizer tokens(xml_text.data(), xml_text.data() + xml_text.size());
+    while(!tokens.at_end())
+      if(!tokens.read_token().empty())
+        ++tag_count;
+  };
+  high_resolution_clock::time_point t1 = high_resolution_clock::now();
+  
+  std::vector< shared_ptr< xml_perf_object > > objects;
+  high_resolution_clock::time_point t2 = high_resolution_clock::now();
+  {
+    std::stringstream ss(xml_text);
+    xml_iarchive in(ss);
+    in & RK_SERIAL_LOAD_WITH_NAME(objects);
+  };
+  high_resolution_clock::time_point t3 = high_resolution_clock::now();
+  
+  if((objects.size() != count) || (count && (objects.back()->m_values.size() != 24))) {
+    std::cout << "The objects were not loaded correctly!" << std::endl;
+    return 1;
+  };
+  
+  double scan_s = double(duration_cast<microseconds>(t1 - t0).count()) * 1e-6;
+  double load_s = double(duration_cast<microseconds>(t3 - t2).count()) * 1e-6;
+  std::cout << "Archive of " << count << " objects: " << std::setprecision(3) << mbytes << " MB, " << tag_count << " tags." << std::endl;
+  std::cout << std::setw(30) << "tokenizer scan:" << std::setw(12) << scan_s << " s" << std::setw(12) << (mbytes / scan_s) << " MB/s" << std::endl;
+  std::cout << std::setw(30) << "xml_iarchive load:" << std::setw(12) << load_s << " s" << std::setw(12) << (mbytes / load_s) << " MB/s" << std::endl;
+  
+  return 0;
+};
+
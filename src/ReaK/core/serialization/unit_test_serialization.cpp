@@ -24,11 +24,14 @@
 #include "base/named_object.hpp"
 
 #include "bin_archiver.hpp"
+#include "chunked_bin_archiver.hpp"
 #include "xml_archiver.hpp"
 #include "protobuf_archiver.hpp"
 #include "objtree_archiver.hpp"
 
 #include <sstream>
+#include <locale>
+#include <clocale>
 
 #define BOOST_TEST_DYN_LINK
 
@@ -313,6 +316,33 @@ class obj_with_unnamed_members : public ReaK::named_object {
     
 };
 
+
+
+class obj_with_shared_member : public ReaK::named_object {
+  public:
+    shared_ptr< obj_with_named_members > m_shared;
+    int m_int;
+    
+    obj_with_shared_member(const shared_ptr< obj_with_named_members >& aShared = shared_ptr< obj_with_named_members >(), int aInt = 0) : 
+                           m_shared(aShared), m_int(aInt) {
+      setName("object_with_shared_member");
+    };
+    
+    virtual void RK_CALL save(ReaK::serialization::oarchive& A, unsigned int) const {
+      ReaK::named_object::save(A,ReaK::named_object::getStaticObjectType()->TypeVersion());
+      A & RK_SERIAL_SAVE_WITH_NAME(m_shared)
+        & RK_SERIAL_SAVE_WITH_NAME(m_int);
+    };
+    virtual void RK_CALL load(ReaK::serialization::iarchive& A, unsigned int) {
+      ReaK::named_object::load(A,ReaK::named_object::getStaticObjectType()->TypeVersion());
+      A & RK_SERIAL_LOAD_WITH_NAME(m_shared)
+        & RK_SERIAL_LOAD_WITH_NAME(m_int);
+    };
+    
+    RK_RTTI_MAKE_CONCRETE_1BASE(obj_with_shared_member, 0xFFFFFFFD, 1, "obj_with_shared_member", ReaK::named_object)
+    
+};
+
 };
 
 
@@ -409,6 +439,119 @@ BOOST_AUTO_TEST_CASE( bin_serializers_test )
 
 
 
+BOOST_AUTO_TEST_CASE( chunked_bin_serializers_test )
+{
+  using namespace ReaK;
+  using namespace serialization;
+  
+  {
+    std::stringstream ss;
+    {
+      chunked_bin_oarchive output_arc(ss);
+      
+      obj_with_named_members                 obj_with_names;
+      shared_ptr< obj_with_named_members >   ptr_with_names(new obj_with_named_members());
+      obj_with_unnamed_members               obj_with_no_names;
+      shared_ptr< obj_with_unnamed_members > ptr_with_no_names(new obj_with_unnamed_members());
+      
+      BOOST_CHECK_NO_THROW( output_arc << obj_with_names );
+      BOOST_CHECK_NO_THROW( output_arc << ptr_with_names );
+      BOOST_CHECK_NO_THROW( output_arc << obj_with_no_names );
+      BOOST_CHECK_NO_THROW( output_arc << ptr_with_no_names );
+      
+      // objects shared between blocks, and a block that depends on a value block.
+      std::vector< shared_ptr< obj_with_shared_member > > holders;
+      for(int i = 0; i < 20; ++i)
+        holders.push_back(shared_ptr< obj_with_shared_member >(new obj_with_shared_member(ptr_with_names, i)));
+      obj_with_shared_member obj_holder(shared_ptr< obj_with_named_members >(new obj_with_named_members()), 42);
+      shared_ptr< obj_with_shared_member > ptr_holder(new obj_with_shared_member(obj_holder.m_shared, 69));
+      
+      BOOST_CHECK_NO_THROW( output_arc << holders );
+      BOOST_CHECK_NO_THROW( output_arc << obj_holder );
+      BOOST_CHECK_NO_THROW( output_arc & RK_SERIAL_SAVE_WITH_NAME(ptr_holder) );
+      
+      // the archive is written once, on close, and not again by the destructor.
+      BOOST_CHECK_NO_THROW( output_arc.close() );
+      std::streampos closed_size = ss.tellp();
+      BOOST_CHECK( closed_size > 0 );
+      BOOST_CHECK_NO_THROW( output_arc.close() );
+      BOOST_CHECK( ss.tellp() == closed_size );
+      BOOST_CHECK_THROW( output_arc << obj_holder, std::ios_base::failure );
+    };
+    
+    {
+      // write errors are reported by close(), and ignored by the destructor.
+      std::stringstream bad_ss;
+      bad_ss.setstate(std::ios_base::badbit);
+      chunked_bin_oarchive bad_arc(bad_ss);
+      int i = 42;
+      BOOST_CHECK_NO_THROW( bad_arc << i );
+      BOOST_CHECK_THROW( bad_arc.close(), std::ios_base::failure );
+    };
+    
+    {
+      chunked_bin_iarchive input_arc(ss, 4);
+      
+      obj_with_named_members                 obj_with_names;
+      shared_ptr< obj_with_named_members >   ptr_with_names;
+      obj_with_unnamed_members               obj_with_no_names;
+      shared_ptr< obj_with_unnamed_members > ptr_with_no_names;
+      
+      BOOST_CHECK_NO_THROW( input_arc >> obj_with_names );
+      BOOST_CHECK_NO_THROW( input_arc >> ptr_with_names );
+      BOOST_CHECK_NO_THROW( input_arc >> obj_with_no_names );
+      BOOST_CHECK_NO_THROW( input_arc >> ptr_with_no_names );
+      
+      BOOST_CHECK( obj_with_names.check_uint() );
+      BOOST_CHECK( obj_with_names.check_str() );
+      BOOST_CHECK( obj_with_names.check_map() );
+      
+      BOOST_CHECK( ptr_with_names );
+      BOOST_CHECK( ptr_with_names->check_uint() );
+      BOOST_CHECK( ptr_with_names->check_str() );
+      BOOST_CHECK( ptr_with_names->check_map() );
+      
+      BOOST_CHECK( obj_with_no_names.check_double() );
+      BOOST_CHECK( obj_with_no_names.check_vect() );
+      BOOST_CHECK( obj_with_no_names.check_set() );
+      
+      BOOST_CHECK( ptr_with_no_names );
+      BOOST_CHECK( ptr_with_no_names->check_double() );
+      BOOST_CHECK( ptr_with_no_names->check_vect() );
+      BOOST_CHECK( ptr_with_no_names->check_set() );
+      
+      std::vector< shared_ptr< obj_with_shared_member > > holders;
+      obj_with_shared_member obj_holder;
+      shared_ptr< obj_with_shared_member > ptr_holder;
+      
+      BOOST_CHECK_NO_THROW( input_arc >> holders );
+      BOOST_CHECK_NO_THROW( input_arc >> obj_holder );
+      BOOST_CHECK_NO_THROW( input_arc & RK_SERIAL_LOAD_WITH_NAME(ptr_holder) );
+      
+      BOOST_CHECK_EQUAL( holders.size(), 20 );
+      for(std::size_t i = 0; i < holders.size(); ++i) {
+        BOOST_CHECK( holders[i] );
+        BOOST_CHECK_EQUAL( holders[i]->m_int, int(i) );
+        BOOST_CHECK( holders[i]->m_shared == ptr_with_names );
+      };
+      
+      BOOST_CHECK_EQUAL( obj_holder.m_int, 42 );
+      BOOST_CHECK( obj_holder.m_shared );
+      BOOST_CHECK( obj_holder.m_shared->check_list() );
+      BOOST_CHECK( ptr_holder );
+      BOOST_CHECK_EQUAL( ptr_holder->m_int, 69 );
+      BOOST_CHECK( ptr_holder->m_shared == obj_holder.m_shared );
+      
+      int extra_value = 0;
+      BOOST_CHECK_THROW( input_arc >> extra_value, std::ios_base::failure );
+    };
+    
+  };
+  
+};
+
+
+
 BOOST_AUTO_TEST_CASE( xml_serializers_test )
 {
   using namespace ReaK;
@@ -502,6 +645,115 @@ BOOST_AUTO_TEST_CASE( xml_serializers_test )
 };
 
 
+BOOST_AUTO_TEST_CASE( xml_tokenizer_test )
+{
+  using namespace ReaK;
+  using namespace serialization;
+  
+  const std::string xml_text = 
+    "<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"yes\" ?>\n"
+    "<!DOCTYPE reak_serialization>\n"
+    "<reak_serialization version=\"2\">\n"
+    "  <!-- a hand-written comment,\n"
+    "       over two lines -->\n"
+    "\t<count>\"42\"</count>\n"
+    "  <ratio >\"-0.25\"</ratio>\n"
+    "  <label>\"a <quoted> label\"</label>\n"
+    "</reak_serialization>\n";
+  
+  {
+    xml_tokenizer tokens(xml_text.data(), xml_text.data() + xml_text.size());
+    xml_string_ref tok = tokens.read_token();
+    BOOST_CHECK( xml_tokenizer::first_word(tok) == "reak_serialization" );
+    xml_string_ref rest(xml_tokenizer::first_word(tok).end(), tok.end());
+    xml_string_ref key, value;
+    BOOST_CHECK( xml_tokenizer::next_attribute(rest, key, value) );
+    BOOST_CHECK( key == "version" );
+    BOOST_CHECK( value == "2" );
+    BOOST_CHECK( !xml_tokenizer::next_attribute(rest, key, value) );
+    BOOST_CHECK( tokens.read_token() == "count" );
+    BOOST_CHECK( tokens.read_quoted() == "42" );
+    BOOST_CHECK( tokens.read_token() == "/count" );
+    tokens.skip_to_end_token("label");
+    BOOST_CHECK( tokens.read_token() == "/reak_serialization" );
+    BOOST_CHECK( tokens.read_token().empty() );
+    BOOST_CHECK( tokens.at_end() );
+  };
+  
+  {
+    std::stringstream ss(xml_text);
+    xml_iarchive input_arc(ss);
+    int count = 0;
+    double ratio = 0.0;
+    std::string label;
+    input_arc & RK_SERIAL_LOAD_WITH_NAME(count)
+              & RK_SERIAL_LOAD_WITH_NAME(ratio)
+              & RK_SERIAL_LOAD_WITH_NAME(label);
+    BOOST_CHECK_EQUAL( count, 42 );
+    BOOST_CHECK_CLOSE( ratio, -0.25, 1e-6 );
+    BOOST_CHECK_EQUAL( label, "a <quoted> label" );
+  };
+  
+  {
+    // a string whose name does not match is left unchanged.
+    std::stringstream ss(xml_text);
+    xml_iarchive input_arc(ss);
+    int count = 0;
+    std::string label = "unchanged";
+    input_arc & RK_SERIAL_LOAD_WITH_NAME(count)
+              & RK_SERIAL_LOAD_WITH_NAME(label);
+    BOOST_CHECK_EQUAL( count, 42 );
+    BOOST_CHECK_EQUAL( label, "unchanged" );
+  };
+  
+};
+
+
+struct comma_decimal_numpunct : std::numpunct<char> {
+  char do_decimal_point() const { return ','; };
+  char do_thousands_sep() const { return '.'; };
+  std::string do_grouping() const { return "\3"; };
+};
+
+BOOST_AUTO_TEST_CASE( xml_locale_independence_test )
+{
+  using namespace ReaK;
+  using namespace serialization;
+  
+  const std::string xml_text = 
+    "<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"yes\" ?>\n"
+    "<reak_serialization version=\"2\">\n"
+    "  <count>\"1234\"</count>\n"
+    "  <ratio>\"1234.5\"</ratio>\n"
+    "  <small>\"-2.5e-3\"</small>\n"
+    "</reak_serialization>\n";
+  
+  // the values are read the same, whatever the global locales (C and C++), 
+  //  the C one is only switched to a comma-decimal one if it is installed.
+  std::string old_c_locale = std::setlocale(LC_NUMERIC, NULL);
+  if(!std::setlocale(LC_NUMERIC, "de_DE.UTF-8"))
+    std::setlocale(LC_NUMERIC, "fr_FR.UTF-8");
+  std::locale old_locale = std::locale::global(std::locale(std::locale::classic(), new comma_decimal_numpunct()));
+  int count = 0;
+  double ratio = 0.0;
+  double small = 0.0;
+  {
+    std::stringstream ss(xml_text);
+    xml_iarchive input_arc(ss);
+    input_arc & RK_SERIAL_LOAD_WITH_NAME(count)
+              & RK_SERIAL_LOAD_WITH_NAME(ratio)
+              & RK_SERIAL_LOAD_WITH_NAME(small);
+  };
+  std::locale::global(old_locale);
+  std::setlocale(LC_NUMERIC, old_c_locale.c_str());
+  BOOST_CHECK_EQUAL( count, 1234 );
+  BOOST_CHECK_EQUAL( ratio, 1234.5 );
+  BOOST_CHECK_EQUAL( small, -2.5e-3 );
+  
+};
+
+
+
 BOOST_AUTO_TEST_CASE( protobuf_serializers_test )
 {
   using namespace ReaK;
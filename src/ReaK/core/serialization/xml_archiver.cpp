@@ -28,162 +28,161 @@
 #include "rtti/so_type_repo.hpp"
 
 #include <fstream>
+#include <iterator>
 #include <algorithm>
 #include <map>
 #include <vector>
-
-#include <cstdlib>
+#include <locale>
+#include <sstream>
 
 namespace ReaK {
 
 namespace serialization {
 
 
-char xml_iarchive::getNextChar() {
-  char c;
-  file_stream->get(c);
-  while((c == ' ') || (c == '\t') || (c == '\n') || (c == '\r'))
-    file_stream->get(c);
-  return c;
-};
+namespace {
 
-std::string xml_iarchive::readToken() {
-  std::string result;
-  char c = getNextChar();
-  if(c != '<')
-    return result;
-  c = getNextChar();
-  if((c == '!') || (c == '?')) {
-    char line_str[512];
-    file_stream->getline(line_str,512);
-    return readToken();
+/*
+ * The values are read in-place from the archive's buffer, with a num_get facet of the classic ("C")
+ * locale, such that the archives do not depend on the global locale (e.g., on its decimal point).
+ * The conversions stop at the first character that cannot be part of the value.
+ */
+typedef std::num_get<char, const char*> xml_num_get;
+
+struct xml_value_format {
+  std::locale loc;
+  mutable std::istringstream dec_format;   // the format of the values (decimal).
+  mutable std::istringstream any_format;   // the format of the header attributes (0x.. hex, 0.. octal, or decimal).
+
+  xml_value_format() : loc(std::locale::classic(), new xml_num_get()), dec_format(), any_format() {
+    dec_format.imbue(loc);
+    any_format.imbue(loc);
+    any_format.unsetf(std::ios_base::basefield);
+  };
+
+  static const xml_value_format& get() {
+    static const xml_value_format fmt;
+    return fmt;
   };
-  while(c != '>') {
-    result += c;
-    file_stream->get(c);
+
+  template <typename T>
+  T parse(const xml_string_ref& s, std::ios_base& aFormat) const {
+    T result = T(0);
+    std::ios_base::iostate err = std::ios_base::goodbit;
+    std::use_facet< xml_num_get >(loc).get(s.begin(), s.end(), aFormat, err, result);
+    return result;
   };
-  return result;
 };
 
+long xml_value_to_long(const xml_string_ref& s) {
+  const xml_value_format& fmt = xml_value_format::get();
+  return fmt.parse<long>(s, fmt.dec_format);
+};
 
-void xml_iarchive::skipToEndToken(const std::string& name) {
-  std::string token = readToken();
-  trimStr(token);
-  while(token != "/" + name) {
-    token = readToken();
-    trimStr(token);
-  };
+unsigned long xml_value_to_ulong(const xml_string_ref& s, int base = 10) {
+  const xml_value_format& fmt = xml_value_format::get();
+  return fmt.parse<unsigned long>(s, (base == 0 ? fmt.any_format : fmt.dec_format));
 };
 
-void xml_iarchive::trimStr(std::string& s) {
-  unsigned int i=0;
-  for(;((i < s.size()) && ((s[i] == ' ') || (s[i] == '\t') || (s[i] == '\n') || (s[i] == '\r')));++i) ;
-  std::string result;
-  for(;((i < s.size()) && (s[i] != ' ') && (s[i] != '\t') && (s[i] != '\n') && (s[i] != '\r'));++i)
-    result += s[i];
-  s = result;
+double xml_value_to_double(const xml_string_ref& s) {
+  const xml_value_format& fmt = xml_value_format::get();
+  return fmt.parse<double>(s, fmt.dec_format);
 };
 
-bool xml_iarchive::readNamedValue(const std::string& value_name,std::string& value_str) {
-  std::string token = readToken();
-  trimStr(token);
+};
+
+
+void xml_iarchive::readStorage(std::istream& aStream) {
+  storage.assign(std::istreambuf_iterator<char>(aStream), std::istreambuf_iterator<char>());
+  const char* first = storage.c_str();
+  tokens = xml_tokenizer(first, first + storage.size());
+};
+
+void xml_iarchive::skipToEndToken(const std::string& name) {
+  tokens.skip_to_end_token(name);
+};
+
+bool xml_iarchive::readNamedValue(const std::string& value_name, xml_string_ref& value_str) {
+  xml_string_ref token = xml_tokenizer::first_word(tokens.read_token());
   if((value_name.empty()) || (token != value_name))
     return false;
 
-  char c;
-  file_stream->get(c);
-  while(c != '\"')
-    file_stream->get(c);
+  value_str = tokens.read_quoted();
 
-  value_str.clear();
-  file_stream->get(c);
-  while(c != '\"') {
-    value_str += c;
-    file_stream->get(c);
-  };
-
-  token = readToken();
-  unsigned int i=0;
-  for(;((i<token.size()) && (token[i] != '/'));++i) ;
-  std::string tmp;
-  ++i;
-  for(;((i<token.size()) && (token[i] != value_name[0]));++i) ;
-  for(;((i<token.size()) && (tmp.size() < value_name.size()));++i)
-    tmp += token[i];
-  if(tmp != value_name)
+  token = tokens.read_token();
+  const char* p = token.begin();
+  for(;((p != token.end()) && (*p != '/'));++p) ;
+  if(p != token.end())
+    ++p;
+  for(;((p != token.end()) && (*p != value_name[0]));++p) ;
+  if(std::size_t(token.end() - p) < value_name.size())
     return false;
-  return true;
+  return (xml_string_ref(p, p + value_name.size()) == value_name);
 };
 
 archive_object_header xml_iarchive::readHeader(const std::string& obj_name) {
   archive_object_header result;
 
-  std::string token = readToken();
+  xml_string_ref token = tokens.read_token();
   if(token.empty())
     return result;
 
-  std::string name;
-  unsigned int i=0;
-  for(;((i < token.size()) && (token[i] == ' '));++i) ;
-  for(;((i < token.size()) && (token[i] != ' '));++i)
-    name += token[i];
-
-  if((name != obj_name) || (i == token.size()))
+  xml_string_ref name = xml_tokenizer::first_word(token);
+  if((name != obj_name) || (name.end() == token.end()))
     return result;
 
-  std::map<std::string,std::string> values;
-  while(i < token.size()) {
-    for(;((i < token.size()) && ((token[i] == ' ') || (token[i] == '\t') || (token[i] == '\n') || (token[i] == '\r')));++i) ;
-    std::string value_key;
-    for(;((i < token.size()) && (token[i] != ' ') && (token[i] != '='));++i)
-      value_key += token[i];
-    std::string value_str;
-    for(;((i < token.size()) && (token[i] != '\"'));++i) ;
-    ++i;
-    for(;((i < token.size()) && (token[i] != '\"'));++i)
-      value_str += token[i];
-    ++i;
-    values[value_key] = value_str;
+  xml_string_ref rest(name.end(), token.end());
+  xml_string_ref key, value;
+  xml_string_ref IDstr, version_str, object_ID_str, is_external_str;
+  while(xml_tokenizer::next_attribute(rest, key, value)) {
+    if(key == "type_ID")
+      IDstr = value;
+    else if(key == "version")
+      version_str = value;
+    else if(key == "object_ID")
+      object_ID_str = value;
+    else if(key == "is_external")
+      is_external_str = value;
   };
 
-  std::string IDstr = values["type_ID"];
   if(IDstr.empty())
     result.type_ID = NULL;
   else {
-    std::vector<unsigned int> nums;
-    for(i=0;i<IDstr.size();++i) {
-      std::string numstr;
-      for(;((i < IDstr.size()) && (IDstr[i] != '.'));++i) 
-	numstr += IDstr[i];
-      nums.push_back(strtoul(numstr.c_str(),NULL,0));
+    std::size_t count = 1;
+    for(const char* p = IDstr.begin(); p != IDstr.end(); ++p)
+      if(*p == '.')
+        ++count;
+    if(*(IDstr.end() - 1) == '.')
+      --count;
+    result.type_ID = new unsigned int[count];
+    const char* p = IDstr.begin();
+    for(std::size_t i = 0; i < count; ++i) {
+      result.type_ID[i] = ((*p == '.') ? 0 : static_cast<unsigned int>(xml_value_to_ulong(xml_string_ref(p, IDstr.end()), 0)));
+      for(;((p != IDstr.end()) && (*p != '.'));++p) ;
+      if(p != IDstr.end())
+        ++p;
     };
-    result.type_ID = new unsigned int[nums.size()];
-    std::copy(nums.begin(),nums.end(),result.type_ID);
   };
 
-  if(values["version"].empty())
+  if(version_str.empty())
     result.type_version = 0;
   else
-    result.type_version = strtoul(values["version"].c_str(),NULL,0);
+    result.type_version = xml_value_to_ulong(version_str, 0);
 
-  if(values["object_ID"].empty())
+  if(object_ID_str.empty())
     result.object_ID = 0;
   else
-    result.object_ID = strtoul(values["object_ID"].c_str(),NULL,0);
+    result.object_ID = xml_value_to_ulong(object_ID_str, 0);
 
-  if(values["is_external"].empty())
-    result.is_external = false;
-  else if(values["is_external"] == "true")
-    result.is_external = true;
-  else
-    result.is_external = false;
+  result.is_external = (is_external_str == "true");
 
   return result;
 };
 
 xml_iarchive::xml_iarchive(const std::string& FileName) {
   
-  file_stream = shared_ptr< std::istream >(new std::ifstream(FileName.c_str(),std::ios::in));
+  std::ifstream file_stream(FileName.c_str(), std::ios::in);
+  readStorage(file_stream);
   
   archive_object_header global_hdr = readHeader("reak_serialization");
   if(global_hdr.type_version != 2)
@@ -193,7 +192,7 @@ xml_iarchive::xml_iarchive(const std::string& FileName) {
 
 xml_iarchive::xml_iarchive(std::istream& aStream) {
   
-  file_stream = shared_ptr< std::istream >(&aStream, null_deleter());
+  readStorage(aStream);
   
   archive_object_header global_hdr = readHeader("reak_serialization");
   if(global_hdr.type_version != 2)
@@ -301,15 +300,12 @@ iarchive& RK_CALL xml_iarchive::load_char(char& i) {
 };
 
 iarchive& RK_CALL xml_iarchive::load_char(const std::pair<std::string, char& >& i) {
-  std::string value_str;
+  xml_string_ref value_str;
   if(readNamedValue(i.first,value_str)) {
     if(value_str.empty())
       i.second = 0;
-    else {
-      int temp;
-      std::stringstream(value_str) >> temp;
-      i.second = char(temp);
-    };
+    else
+      i.second = char(xml_value_to_long(value_str));
   } else
     i.second = 0;
   return *this;
@@ -320,15 +316,12 @@ iarchive& RK_CALL xml_iarchive::load_unsigned_char(unsigned char& u) {
 };
 
 iarchive& RK_CALL xml_iarchive::load_unsigned_char(const std::pair<std::string, unsigned char& >& u) {
-  std::string value_str;
+  xml_string_ref value_str;
   if(readNamedValue(u.first,value_str)) {
     if(value_str.empty())
       u.second = 0;
-    else {
-      unsigned int temp;
-      std::stringstream(value_str) >> temp;
-      u.second = char(temp);
-    };
+    else
+      u.second = char(xml_value_to_ulong(value_str));
   } else
     u.second = 0;
   return *this;
@@ -339,12 +332,12 @@ iarchive& RK_CALL xml_iarchive::load_int(int& i) {
 };
 
 iarchive& RK_CALL xml_iarchive::load_int(const std::pair<std::string, int& >& i) {
-  std::string value_str;
+  xml_string_ref value_str;
   if(readNamedValue(i.first,value_str)) {
     if(value_str.empty())
       i.second = 0;
     else
-      std::stringstream(value_str) >> i.second;
+      i.second = int(xml_value_to_long(value_str));
   } else
     i.second = 0;
   return *this;
@@ -355,12 +348,12 @@ iarchive& RK_CALL xml_iarchive::load_unsigned_int(unsigned int& u) {
 };
 
 iarchive& RK_CALL xml_iarchive::load_unsigned_int(const std::pair<std::string, unsigned int& >& u) {
-  std::string value_str;
+  xml_string_ref value_str;
   if(readNamedValue(u.first,value_str)) {
     if(value_str.empty())
       u.second = 0;
     else
-      std::stringstream(value_str) >> u.second;
+      u.second = static_cast<unsigned int>(xml_value_to_ulong(value_str));
   } else
     u.second = 0;
   return *this;
@@ -371,12 +364,12 @@ iarchive& RK_CALL xml_iarchive::load_float(float& f) {
 };
 
 iarchive& RK_CALL xml_iarchive::load_float(const std::pair<std::string, float& >& f) {
-  std::string value_str;
+  xml_string_ref value_str;
   if(readNamedValue(f.first,value_str)) {
     if(value_str.empty())
       f.second = 0;
     else
-      std::stringstream(value_str) >> f.second;
+      f.second = float(xml_value_to_double(value_str));
   } else
     f.second = 0;
   return *this;
@@ -387,12 +380,12 @@ iarchive& RK_CALL xml_iarchive::load_double(double& d) {
 };
 
 iarchive& RK_CALL xml_iarchive::load_double(const std::pair<std::string, double& >& d) {
-  std::string value_str;
+  xml_string_ref value_str;
   if(readNamedValue(d.first,value_str)) {
     if(value_str.empty())
       d.second = 0;
     else
-      std::stringstream(value_str) >> d.second;
+      d.second = xml_value_to_double(value_str);
   } else
     d.second = 0;
   return *this;
@@ -403,7 +396,7 @@ iarchive& RK_CALL xml_iarchive::load_bool(bool& b) {
 };
 
 iarchive& RK_CALL xml_iarchive::load_bool(const std::pair<std::string, bool& >& b) {
-  std::string value_str;
+  xml_string_ref value_str;
   if(readNamedValue(b.first,value_str)) {
     if(value_str.empty())
       b.second = false;
@@ -421,7 +414,9 @@ iarchive& RK_CALL xml_iarchive::load_string(std::string& s) {
 };
 
 iarchive& RK_CALL xml_iarchive::load_string(const std::pair<std::string, std::string& >& s) {
-  readNamedValue(s.first,s.second);
+  xml_string_ref value_str;
+  if(readNamedValue(s.first,value_str))
+    s.second.assign(value_str.begin(), value_str.end());
   return *this;
 };
 
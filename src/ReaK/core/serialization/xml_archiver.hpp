@@ -34,6 +34,7 @@
 #define REAK_XML_ARCHIVER_HPP
 
 #include "archiver.hpp"
+#include "xml_tokenizer.hpp"
 
 #include <iostream>
 #include <utility>
@@ -45,18 +46,17 @@ namespace ReaK {
 namespace serialization {
 
 /**
- * XML input archive.
+ * XML input archive. The archive is read into memory when it is opened, and then parsed in a
+ * single pass (see xml_tokenizer). When constructed from a stream, the stream is read to its end.
  */
 class xml_iarchive : public iarchive {
   private:
-    shared_ptr< std::istream > file_stream;
     std::string storage;
+    xml_tokenizer tokens;
 
-    char getNextChar();
-    std::string readToken();
+    void readStorage(std::istream& aStream);
     void skipToEndToken(const std::string& name);
-    void trimStr(std::string& s);
-    bool readNamedValue(const std::string& value_name,std::string& value_str);
+    bool readNamedValue(const std::string& value_name, xml_string_ref& value_str);
     archive_object_header readHeader(const std::string& obj_name);
 
   protected:
@@ -0,0 +1,234 @@
+/**
+ * \file xml_tokenizer.hpp
+ *
+ * This library declares a single-pass XML tokenizer over a memory buffer, as used by the XML input
+ * archive (xml_iarchive). The tokens (the contents of the tags, and the quoted values) are returned as
+ * string references into the buffer, such that no memory allocation is done while parsing.
+ *
+ * \author Sven Mikael Persson <mikael.s.persson@gmail.com>
+ * \date June 2013
+ */
+
+/*
+ *    Copyright 2013 Sven Mikael Persson
+ *
+ *    THIS SOFTWARE IS DISTRIBUTED UNDER THE TERMS OF THE GNU GENERAL PUBLIC LICENSE v3 (GPLv3).
+ *
+ *    This file is part of ReaK.
+ *
+ *    ReaK is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    (at your option) any later version.
+ *
+ *    ReaK is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with ReaK (as LICENSE in the root folder).
+ *    If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef REAK_XML_TOKENIZER_HPP
+#define REAK_XML_TOKENIZER_HPP
+
+#include "base/defs.hpp"
+
+#include <string>
+#include <cstring>
+
+namespace ReaK {
+
+namespace serialization {
+
+
+/**
+ * This class is a reference to a range of characters (not null-terminated) in a buffer, which it does
+ * not own.
+ */
+class xml_string_ref {
+  private:
+    const char* first_;
+    const char* last_;
+  public:
+    typedef const char* const_iterator;
+    
+    xml_string_ref() : first_(NULL), last_(NULL) { };
+    xml_string_ref(const char* aFirst, const char* aLast) : first_(aFirst), last_(aLast) { };
+    
+    const_iterator begin() const { return first_; };
+    const_iterator end() const { return last_; };
+    std::size_t size() const { return last_ - first_; };
+    bool empty() const { return first_ == last_; };
+    char operator[](std::size_t i) const { return first_[i]; };
+    
+    std::string str() const { return std::string(first_, last_); };
+    
+    friend bool operator==(const xml_string_ref& lhs, const std::string& rhs) {
+      return (lhs.size() == rhs.size()) && (std::memcmp(lhs.first_, rhs.data(), rhs.size()) == 0);
+    };
+    friend bool operator!=(const xml_string_ref& lhs, const std::string& rhs) { return !(lhs == rhs); };
+    friend bool operator==(const xml_string_ref& lhs, const char* rhs) {
+      std::size_t n = std::strlen(rhs);
+      return (lhs.size() == n) && (std::memcmp(lhs.first_, rhs, n) == 0);
+    };
+    friend bool operator!=(const xml_string_ref& lhs, const char* rhs) { return !(lhs == rhs); };
+};
+
+
+/**
+ * This class splits a buffer of XML text into tokens, in a single pass. It understands the subset of
+ * XML written by the XML output archive (xml_oarchive), i.e., tags with quoted attributes, and quoted
+ * values between the tags, as well as the declarations (<?...?> and <!...>) and the comments 
+ * (<!-- ... -->), which are skipped. The buffer must outlive the tokenizer and the tokens.
+ */
+class xml_tokenizer {
+  private:
+    const char* cur;
+    const char* last;
+    
+    static bool is_space(char c) { return (c == ' ') || (c == '\t') || (c == '\n') || (c == '\r'); };
+    
+    void skip_spaces() {
+      while((cur != last) && is_space(*cur))
+        ++cur;
+    };
+    
+    // skips a declaration or comment, from after its '<'.
+    void skip_declaration() {
+      if((last - cur >= 3) && (cur[0] == '!') && (cur[1] == '-') && (cur[2] == '-')) {
+        cur += 3;
+        while((last - cur >= 3) && !((cur[0] == '-') && (cur[1] == '-') && (cur[2] == '>')))
+          ++cur;
+        cur = ((last - cur >= 3) ? cur + 3 : last);
+        return;
+      };
+      const char* p = static_cast<const char*>(std::memchr(cur, '>', last - cur));
+      cur = (p ? p + 1 : last);
+    };
+    
+  public:
+    
+    xml_tokenizer() : cur(NULL), last(NULL) { };
+    
+    /**
+     * Creates a tokenizer over the range of characters [aFirst, aLast).
+     */
+    xml_tokenizer(const char* aFirst, const char* aLast) : cur(aFirst), last(aLast) { };
+    
+    /**
+     * Tells if the end of the buffer was reached.
+     */
+    bool at_end() const { return cur == last; };
+    
+    /**
+     * Reads the next tag, skipping the white-spaces, declarations and comments before it.
+     * \return The contents of the tag (between the < and > delimiters, without leading white-spaces),
+     *         or an empty string if the next character is not the start of a tag (that character is
+     *         then skipped).
+     */
+    xml_string_ref read_token() {
+      while(true) {
+        skip_spaces();
+        if(cur == last)
+          return xml_string_ref();
+        if(*cur != '<') {
+          ++cur;
+          return xml_string_ref();
+        };
+        ++cur;
+        skip_spaces();
+        if((cur != last) && ((*cur == '!') || (*cur == '?'))) {
+          skip_declaration();
+          continue;
+        };
+        const char* first = cur;
+        const char* p = static_cast<const char*>(std::memchr(cur, '>', last - cur));
+        cur = (p ? p + 1 : last);
+        return xml_string_ref(first, (p ? p : last));
+      };
+    };
+    
+    /**
+     * Reads the next quoted value (skipping everything up to the opening quote).
+     * \return The characters between the quotes.
+     */
+    xml_string_ref read_quoted() {
+      const char* p = static_cast<const char*>(std::memchr(cur, '\"', last - cur));
+      if(!p) {
+        cur = last;
+        return xml_string_ref();
+      };
+      const char* first = p + 1;
+      p = static_cast<const char*>(std::memchr(first, '\"', last - first));
+      cur = (p ? p + 1 : last);
+      return xml_string_ref(first, (p ? p : last));
+    };
+    
+    /**
+     * Skips tokens until (and including) the end tag with the given name.
+     */
+    void skip_to_end_token(const std::string& aName) {
+      while(cur != last) {
+        xml_string_ref tok = first_word(read_token());
+        if((tok.size() == aName.size() + 1) && (tok[0] == '/') && 
+           (std::memcmp(tok.begin() + 1, aName.data(), aName.size()) == 0))
+          return;
+      };
+    };
+    
+    /**
+     * Returns the first word of a token (e.g., the name of a tag), without the white-spaces.
+     */
+    static xml_string_ref first_word(const xml_string_ref& aToken) {
+      const char* first = aToken.begin();
+      while((first != aToken.end()) && is_space(*first))
+        ++first;
+      const char* p = first;
+      while((p != aToken.end()) && !is_space(*p))
+        ++p;
+      return xml_string_ref(first, p);
+    };
+    
+    /**
+     * Extracts the next attribute (key="value") from the remainder of a tag.
+     * \param aRest The remainder of the tag, which is advanced past the attribute.
+     * \param aKey Stores, as output, the key of the attribute.
+     * \param aValue Stores, as output, the value of the attribute (between the quotes).
+     * \return False if there are no more attributes in the remainder of the tag.
+     */
+    static bool next_attribute(xml_string_ref& aRest, xml_string_ref& aKey, xml_string_ref& aValue) {
+      const char* p = aRest.begin();
+      const char* end = aRest.end();
+      while((p != end) && is_space(*p))
+        ++p;
+      if(p == end) {
+        aRest = xml_string_ref(end, end);
+        return false;
+      };
+      const char* key_first = p;
+      while((p != end) && (*p != ' ') && (*p != '='))
+        ++p;
+      aKey = xml_string_ref(key_first, p);
+      while((p != end) && (*p != '\"'))
+        ++p;
+      const char* value_first = (p != end ? p + 1 : end);
+      p = value_first;
+      while((p != end) && (*p != '\"'))
+        ++p;
+      aValue = xml_string_ref(value_first, p);
+      aRest = xml_string_ref((p != end ? p + 1 : end), end);
+      return true;
+    };
+    
+};
+
+
+};
+
+};
+
+#endif
+
@@ -0,0 +1,233 @@
+/**
+ * \file cholesky_covariance_matrix.hpp
+ * 
+ * This library provides a class template to represent a covariance matrix by its 
+ * Cholesky factor (or matrix square-root).
+ * 
+ * \author Sven Mikael Persson <mikael.s.persson@gmail.com>
+ * \date May 2013
+ */
+
+/*
+ *    Copyright 2013 Sven Mikael Persson
+ *
+ *    THIS SOFTWARE IS DISTRIBUTED UNDER THE TERMS OF THE GNU GENERAL PUBLIC LICENSE v3 (GPLv3).
+ *
+ *    This file is part of ReaK.
+ *
+ *    ReaK is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    (at your option) any later version.
+ *
+ *    ReaK is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with ReaK (as LICENSE in the root folder).  
+ *    If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef REAK_CHOLESKY_COVARIANCE_MATRIX_HPP
+#define REAK_CHOLESKY_COVARIANCE_MATRIX_HPP
+
+#include "lin_alg/mat_alg.hpp"
+#include "lin_alg/mat_cholesky.hpp"
+#include "base/named_object.hpp"
+
+#include "covariance_concept.hpp"
+
+namespace ReaK {
+
+namespace ctrl {
+
+
+
+/**
+ * This class template can represent a covariance matrix (as of the CovarianceMatrixConcept) 
+ * by containing the lower-triangular Cholesky factor L of the covariance matrix P = L * transpose(L). 
+ * Outputing the covariance matrix induces a matrix multiplication while outputing the information 
+ * matrix induces two triangular back-substitutions. This representation is meant to be used with the 
+ * square-root filters (see square_root_kalman_filter.hpp and square_root_unscented_kalman_filter.hpp), 
+ * which propagate the Cholesky factor directly and never need to re-factorize the covariance matrix.
+ * 
+ * Models: CovarianceMatrixConcept
+ * 
+ * \tparam VectorType The state-vector type which the covariance matrix is the covariance of, should model ReadableVectorConcept.
+ */
+template <typename VectorType>
+class cholesky_covariance_matrix : public named_object {
+  public:
+    BOOST_CONCEPT_ASSERT((ReadableVectorConcept<VectorType>));
+    
+    typedef cholesky_covariance_matrix<VectorType> self;
+    
+    typedef typename vect_traits<VectorType>::value_type value_type;
+    typedef mat<value_type, mat_structure::symmetric> matrix_type;
+    typedef typename matrix_type::size_type size_type;
+    
+    typedef mat<value_type, mat_structure::square> matrix_block_type;
+    
+    BOOST_STATIC_CONSTANT(std::size_t, dimensions = vect_traits<VectorType>::dimensions);
+    BOOST_STATIC_CONSTANT(covariance_storage::tag, storage = covariance_storage::factored);
+    
+  private:
+    matrix_block_type mat_L;
+    
+  public:
+    
+    /**
+     * Parametrized constructor.
+     * \param aMatL The lower-triangular Cholesky factor of the covariance matrix.
+     */
+    explicit cholesky_covariance_matrix(const matrix_block_type& aMatL, 
+                                        const std::string& aName = "") : 
+                                        mat_L(aMatL) { 
+      setName(aName); 
+    };
+    
+    /**
+     * Parametrized constructor.
+     * \note With no information, the factor is a large finite diagonal (of 1/sqrt(epsilon), i.e., 
+     *       variances of 1/epsilon) instead of an infinite one, whose products (e.g., 0 * inf in the 
+     *       covariance matrix or in the filters' pre-arrays) would be NaN.
+     * \param aSize The size of the covariance matrix.
+     * \param aLevel The information level to initialize this object with.
+     */
+    explicit cholesky_covariance_matrix(size_type aSize = 0, 
+                                        covariance_initial_level::tag aLevel = covariance_initial_level::full_info, 
+                                        const std::string& aName = "") : 
+                                        mat_L(aSize, value_type(0)) { 
+      using std::sqrt;
+      setName(aName); 
+      if(aLevel == covariance_initial_level::no_info) {
+        for(size_type i = 0; i < aSize; ++i)
+          mat_L(i,i) = value_type(1) / sqrt(std::numeric_limits< value_type >::epsilon());
+      };
+    };
+    
+    /**
+     * Returns the covariance matrix (as a matrix object).
+     * \return The covariance matrix (as a matrix object).
+     */
+    matrix_type get_matrix() const { 
+      return matrix_type(mat_L * transpose_view(mat_L));
+    };
+    /**
+     * Returns the inverse covariance matrix (information matrix) (as a matrix object).
+     * \return The inverse covariance matrix (information matrix) (as a matrix object).
+     */
+    matrix_type get_inverse_matrix() const { 
+      matrix_block_type m_inv(mat<value_type, mat_structure::identity>(mat_L.get_row_count()));
+      ReaK::detail::backsub_Cholesky_impl(mat_L, m_inv);
+      return matrix_type(m_inv);
+    };
+    
+    /**
+     * Returns the lower-triangular Cholesky factor of the covariance matrix.
+     * \return The lower-triangular Cholesky factor of the covariance matrix.
+     */
+    const matrix_block_type& get_factor() const { return mat_L; };
+    
+    /**
+     * Standard swap function.
+     */
+    friend void swap(self& lhs, self& rhs) throw() {
+      using std::swap;
+      swap(lhs.mat_L,rhs.mat_L);
+    };
+    
+    /**
+     * Standard assignment operator.
+     */
+    self& operator =(self rhs) {
+      swap(rhs,*this);
+      return *this;
+    };
+    
+    /**
+     * Assignment to a readable matrix (covariance matrix), which is factorized (Cholesky) to 
+     * obtain the stored factor.
+     * \throw singularity_error if the given matrix is not positive-definite.
+     */
+    template <typename Matrix>
+    typename boost::enable_if_c< is_readable_matrix<Matrix>::value, 
+    self& >::type operator =(const Matrix& rhs) {
+      mat_L = matrix_block_type(rhs.get_row_count(), value_type(0));
+      decompose_Cholesky(rhs, mat_L, std::numeric_limits< value_type >::epsilon());
+      return *this;
+    };
+        
+    /**
+     * Implicit conversion to a covariance matrix type.
+     */
+    operator matrix_type() const { return get_matrix(); };
+    
+    /**
+     * Conversion to an information matrix type.
+     */
+    friend matrix_type invert(const self& aObj) {
+      return aObj.get_inverse_matrix();
+    };
+    
+    /**
+     * Returns the size of the covariance matrix.
+     * \return The size of the covariance matrix.
+     */
+    size_type size() const { return mat_L.get_row_count(); };
+    
+    
+    
+    virtual void RK_CALL save(ReaK::serialization::oarchive& aA, unsigned int) const {
+      ReaK::named_object::save(aA,ReaK::named_object::getStaticObjectType()->TypeVersion());
+      aA & RK_SERIAL_SAVE_WITH_NAME(mat_L);
+    };
+    virtual void RK_CALL load(ReaK::serialization::iarchive& aA, unsigned int) {
+      ReaK::named_object::load(aA,ReaK::named_object::getStaticObjectType()->TypeVersion());
+      aA & RK_SERIAL_LOAD_WITH_NAME(mat_L);
+    };
+    
+    RK_RTTI_MAKE_CONCRETE_1BASE(self,0xC230000B,1,"cholesky_covariance_matrix",named_object)
+    
+};
+
+
+/**
+ * This function template obtains the lower-triangular Cholesky factor of a covariance matrix. 
+ * For general covariance matrix representations, this performs a Cholesky decomposition.
+ * \tparam CovarianceMatrix The covariance matrix type, should model the CovarianceMatrixConcept.
+ * \tparam Matrix A fully-writable matrix type.
+ * \param aCov The covariance matrix object.
+ * \param L Stores, as output, the lower-triangular Cholesky factor of the covariance matrix.
+ * \throw singularity_error if the covariance matrix is not positive-definite.
+ */
+template <typename CovarianceMatrix, typename Matrix>
+void get_cholesky_factor(const CovarianceMatrix& aCov, Matrix& L) {
+  typedef typename covariance_mat_traits<CovarianceMatrix>::value_type ValueType;
+  L = mat<ValueType, mat_structure::square>(aCov.size(), ValueType(0));
+  decompose_Cholesky(aCov.get_matrix(), L, std::numeric_limits< ValueType >::epsilon());
+};
+
+/**
+ * This function template obtains the lower-triangular Cholesky factor of a covariance matrix. 
+ * For the Cholesky covariance matrix representation, this simply copies the stored factor.
+ * \tparam VectorType The state-vector type of the covariance matrix.
+ * \tparam Matrix A writable matrix type.
+ * \param aCov The covariance matrix object.
+ * \param L Stores, as output, the lower-triangular Cholesky factor of the covariance matrix.
+ */
+template <typename VectorType, typename Matrix>
+void get_cholesky_factor(const cholesky_covariance_matrix<VectorType>& aCov, Matrix& L) {
+  L = aCov.get_factor();
+};
+
+
+
+};
+
+};
+
+#endif
+
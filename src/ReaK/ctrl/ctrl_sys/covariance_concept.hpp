@@ -58,7 +58,8 @@ namespace covariance_storage {
     covariance = 1,
     information,
     decomposed,
-    other
+    other,
+    factored
   };
 };
 
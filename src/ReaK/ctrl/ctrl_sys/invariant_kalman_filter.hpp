@@ -55,6 +55,7 @@
 
 #include "gaussian_belief_state.hpp"
 #include "covariance_matrix.hpp"
+#include "kalman_filter.hpp"
 
 #include "path_planning/metric_space_concept.hpp"
 
@@ -289,6 +290,166 @@ void >::type invariant_kalman_filter_step(const InvariantSystem& sys,
 
 
 
+/**
+ * This function template performs one measurement update step using the Invariant Kalman Filter method,
+ * but processes the invariant error vector one scalar element at a time (sequential update). This is only 
+ * valid if the measurement covariance is diagonal (uncorrelated measurement noise), and any off-diagonal
+ * elements of it are ignored. This avoids the factorization of the innovation covariance matrix and is 
+ * thus much faster than invariant_kalman_update when the measurement vector is much larger than the 
+ * state vector.
+ * \tparam InvariantSystem An invariant discrete-time state-space system modeling the 
+ *         InvariantDiscreteSystemConcept.
+ * \tparam StateSpaceType A topology type on which the state-vectors can reside, should model
+ *         the pp::TopologyConcept.
+ * \tparam BeliefState A belief state type modeling the ContinuousBeliefStateConcept with
+ *         a unimodular gaussian representation.
+ * \tparam InputBelief A belief state type modeling the ContinuousBeliefStateConcept with
+ *         a unimodular gaussian representation.
+ * \tparam MeasurementBelief A belief state type modeling the ContinuousBeliefStateConcept with
+ *         a unimodular gaussian representation (with a diagonal covariance).
+ * \param sys The invariant discrete-time state-space system used in the state estimation.
+ * \param state_space The state-space topology on which the state representations lie.
+ * \param b_x As input, it stores the belief-state before the update step. As output, it stores
+ *        the belief-state after the update step.
+ * \param b_u The input vector to apply to the state-space system to make the transition of the 
+ *        mean-state, i.e., the current input vector and its covariance.
+ * \param b_z The output belief that was measured, i.e. the measurement vector and its covariance.
+ * \param t The current time.
+ * \throws singularity_error If the innovation variance of one of the measurements is not positive.
+ * 
+ */
+template <typename InvariantSystem,  
+          typename StateSpaceType,
+          typename BeliefState, 
+	  typename InputBelief, 
+	  typename MeasurementBelief>
+typename boost::enable_if_c< is_continuous_belief_state<BeliefState>::value &&
+                             (belief_state_traits<BeliefState>::representation == belief_representation::gaussian) &&
+                             (belief_state_traits<BeliefState>::distribution == belief_distribution::unimodal),
+void >::type invariant_kalman_sequential_update(const InvariantSystem& sys,
+				                const StateSpaceType& state_space,
+				                BeliefState& b_x,
+				                const InputBelief& b_u,
+				                const MeasurementBelief& b_z,
+				                typename discrete_sss_traits<InvariantSystem>::time_type t = 0) {
+  BOOST_CONCEPT_ASSERT((pp::TopologyConcept< StateSpaceType >));
+  BOOST_CONCEPT_ASSERT((InvariantDiscreteSystemConcept<InvariantSystem, StateSpaceType>));
+  BOOST_CONCEPT_ASSERT((ContinuousBeliefStateConcept<BeliefState>));
+  BOOST_CONCEPT_ASSERT((ContinuousBeliefStateConcept<InputBelief>));
+  BOOST_CONCEPT_ASSERT((ContinuousBeliefStateConcept<MeasurementBelief>));
+
+  typedef typename discrete_sss_traits<InvariantSystem>::point_type StateType;
+  typedef typename continuous_belief_state_traits<BeliefState>::covariance_type CovType;
+  typedef typename covariance_mat_traits< CovType >::matrix_type MatType;
+  typedef typename mat_traits<MatType>::value_type ValueType;
+  typedef typename invariant_system_traits<InvariantSystem>::invariant_frame_type InvarFrame;
+  typedef typename invariant_system_traits<InvariantSystem>::invariant_correction_type InvarCorr;
+  
+  typename discrete_linear_sss_traits<InvariantSystem>::matrixC_type C;
+  typename discrete_linear_sss_traits<InvariantSystem>::matrixD_type D;
+  
+  StateType x = b_x.get_mean_state();
+  mat< ValueType, mat_structure::symmetric > P(b_x.get_covariance().get_matrix());
+  sys.get_output_function_blocks(C, D, state_space, t, x, b_u.get_mean_state());
+  
+  vect_n<ValueType> e = 
+    to_vect<ValueType>(sys.get_invariant_error(state_space, x, b_u.get_mean_state(), b_z.get_mean_state(), t + sys.get_time_step()));
+  vect_n<ValueType> dx = detail::kalman_sequential_correction(P, C, e, b_z.get_covariance().get_matrix());
+   
+  b_x.set_mean_state( sys.apply_correction(state_space, x, from_vect<InvarCorr>(dx), b_u.get_mean_state(), t + sys.get_time_step()) );
+  InvarFrame W = sys.get_invariant_posterior_frame(state_space, x, b_x.get_mean_state(), b_u.get_mean_state(), t + sys.get_time_step());
+  b_x.set_covariance( CovType( MatType( W * P * transpose_view(W) ) ) );
+};
+
+
+/**
+ * This function template performs a number of consecutive estimation steps using the Invariant Kalman 
+ * Filter method, over a window of inputs and measurements (e.g., a buffer of delayed measurements 
+ * being replayed from an older belief-state). The mean-state and covariance are carried through the 
+ * whole window without being stored back into the belief-state until the end, and each measurement
+ * update is done sequentially (see invariant_kalman_sequential_update), which requires the measurement 
+ * covariances to be diagonal.
+ * \tparam InvariantSystem An invariant discrete-time state-space system modeling the 
+ *         InvariantDiscreteSystemConcept.
+ * \tparam StateSpaceType A topology type on which the state-vectors can reside, should model
+ *         the pp::TopologyConcept.
+ * \tparam BeliefState A belief state type modeling the ContinuousBeliefStateConcept with
+ *         a unimodular gaussian representation.
+ * \tparam InputBeliefIter A forward-iterator type whose value-type is an input belief-state type
+ *         (modeling the ContinuousBeliefStateConcept with a unimodular gaussian representation).
+ * \tparam MeasurementBeliefIter A forward-iterator type whose value-type is a measurement belief-state type
+ *         (modeling the ContinuousBeliefStateConcept with a unimodular gaussian representation).
+ * \param sys The invariant discrete-time state-space system used in the state estimation.
+ * \param state_space The state-space topology on which the state representations lie.
+ * \param b_x As input, it stores the belief-state before the first estimation step. As output, it stores
+ *        the belief-state after the last estimation step.
+ * \param u_first The iterator to the first input belief of the window.
+ * \param u_last The iterator to the one-past-last input belief of the window.
+ * \param z_first The iterator to the first measurement belief of the window (measured one time-step 
+ *        after the corresponding input), there must be as many measurements as there are inputs.
+ * \param t The time before the first prediction (each step advances by the system's time-step).
+ * \return The time after the last estimation step.
+ * \throws singularity_error If the innovation variance of one of the measurements is not positive.
+ * 
+ */
+template <typename InvariantSystem, 
+          typename StateSpaceType,
+          typename BeliefState, 
+	  typename InputBeliefIter, 
+	  typename MeasurementBeliefIter>
+typename boost::enable_if_c< is_continuous_belief_state<BeliefState>::value &&
+                             (belief_state_traits<BeliefState>::representation == belief_representation::gaussian) &&
+                             (belief_state_traits<BeliefState>::distribution == belief_distribution::unimodal),
+typename discrete_sss_traits<InvariantSystem>::time_type >::type invariant_kalman_filter_window(const InvariantSystem& sys,
+					                                                       const StateSpaceType& state_space,
+					                                                       BeliefState& b_x,
+					                                                       InputBeliefIter u_first,
+					                                                       InputBeliefIter u_last,
+					                                                       MeasurementBeliefIter z_first,
+					                                                       typename discrete_sss_traits<InvariantSystem>::time_type t = 0) {
+  BOOST_CONCEPT_ASSERT((pp::TopologyConcept< StateSpaceType >));
+  BOOST_CONCEPT_ASSERT((InvariantDiscreteSystemConcept<InvariantSystem, StateSpaceType>));
+  BOOST_CONCEPT_ASSERT((ContinuousBeliefStateConcept<BeliefState>));
+
+  typedef typename discrete_sss_traits<InvariantSystem>::point_type StateType;
+  typedef typename continuous_belief_state_traits<BeliefState>::covariance_type CovType;
+  typedef typename covariance_mat_traits< CovType >::matrix_type MatType;
+  typedef typename mat_traits<MatType>::value_type ValueType;
+  typedef typename invariant_system_traits<InvariantSystem>::invariant_frame_type InvarFrame;
+  typedef typename invariant_system_traits<InvariantSystem>::invariant_correction_type InvarCorr;
+  
+  typename discrete_linear_sss_traits<InvariantSystem>::matrixA_type A;
+  typename discrete_linear_sss_traits<InvariantSystem>::matrixB_type B;
+  typename discrete_linear_sss_traits<InvariantSystem>::matrixC_type C;
+  typename discrete_linear_sss_traits<InvariantSystem>::matrixD_type D;
+  
+  StateType x = b_x.get_mean_state();
+  mat< ValueType, mat_structure::symmetric > P(b_x.get_covariance().get_matrix());
+  
+  for(; u_first != u_last; ++u_first, ++z_first) {
+    StateType x_prior = sys.get_next_state(state_space, x, u_first->get_mean_state(), t);
+    sys.get_state_transition_blocks(A, B, state_space, t, t + sys.get_time_step(), x, x_prior, u_first->get_mean_state(), u_first->get_mean_state());
+    InvarFrame W = sys.get_invariant_prior_frame(state_space, x, x_prior, u_first->get_mean_state(), t + sys.get_time_step());
+    P = W * (( A * P * transpose_view(A)) + B * u_first->get_covariance().get_matrix() * transpose_view(B)) * transpose_view(W);
+    t += sys.get_time_step();
+    
+    sys.get_output_function_blocks(C, D, state_space, t, x_prior, u_first->get_mean_state());
+    vect_n<ValueType> e = to_vect<ValueType>(sys.get_invariant_error(state_space, x_prior, u_first->get_mean_state(), z_first->get_mean_state(), t));
+    vect_n<ValueType> dx = detail::kalman_sequential_correction(P, C, e, z_first->get_covariance().get_matrix());
+    
+    x = sys.apply_correction(state_space, x_prior, from_vect<InvarCorr>(dx), u_first->get_mean_state(), t);
+    W = sys.get_invariant_posterior_frame(state_space, x_prior, x, u_first->get_mean_state(), t);
+    P = W * P * transpose_view(W);
+  };
+  
+  b_x.set_mean_state( x );
+  b_x.set_covariance( CovType( MatType( P ) ) );
+  return t;
+};
+
+
+
+
 
 
 /**
@@ -161,6 +161,14 @@ void >::type kalman_update(const LinearSystem& sys,
   typedef typename continuous_belief_state_traits<BeliefState>::covariance_type CovType;
   typedef typename covariance_mat_traits< CovType >::matrix_type MatType;
   typedef typename mat_traits<MatType>::value_type ValueType;
+  typedef typename discrete_linear_sss_traits<LinearSystem>::matrixC_type MatCType;
+  // fixed-size temporaries (on the stack) whenever the output matrix has static dimensions:
+  typedef typename mat_fix_or_dynamic<ValueType, mat_structure::rectangular, 
+    mat_traits<MatCType>::static_row_count, mat_traits<MatCType>::static_col_count>::type MatCPType;
+  typedef typename mat_fix_or_dynamic<ValueType, mat_structure::symmetric, 
+    mat_traits<MatCType>::static_row_count, mat_traits<MatCType>::static_row_count>::type MatSType;
+  typedef typename mat_fix_or_dynamic<ValueType, mat_structure::rectangular, 
+    mat_traits<MatCType>::static_col_count, mat_traits<MatCType>::static_row_count, mat_alignment::row_major>::type MatKType;
   
   typename discrete_linear_sss_traits<LinearSystem>::matrixC_type C;
   typename discrete_linear_sss_traits<LinearSystem>::matrixD_type D;
@@ -169,10 +177,10 @@ void >::type kalman_update(const LinearSystem& sys,
   sys.get_output_function_blocks(C, D, state_space, t, x, b_u.get_mean_state());
   
   vect_n<ValueType> y = to_vect<ValueType>(b_z.get_mean_state() - sys.get_output(state_space, x, b_u.get_mean_state(), t));
-  mat< ValueType, mat_structure::rectangular, mat_alignment::column_major > CP = C * P;
-  mat< ValueType, mat_structure::symmetric > S( CP * transpose_view(C) + b_z.get_covariance().get_matrix() );
+  MatCPType CP(C * P);
+  MatSType S( CP * transpose_view(C) + b_z.get_covariance().get_matrix() );
   linsolve_Cholesky(S,CP);
-  mat< ValueType, mat_structure::rectangular, mat_alignment::row_major > K( transpose_view(CP) );
+  MatKType K( transpose_view(CP) );
    
   b_x.set_mean_state( state_space.adjust(x, from_vect<StateDiffType>(K * y) ) );
   b_x.set_covariance( CovType( MatType( (mat< ValueType, mat_structure::identity>(K.get_row_count()) - K * C) * P ) ) );
@@ -232,6 +240,14 @@ void >::type kalman_filter_step(const LinearSystem& sys,
   typedef typename continuous_belief_state_traits<BeliefState>::covariance_type CovType;
   typedef typename covariance_mat_traits< CovType >::matrix_type MatType;
   typedef typename mat_traits<MatType>::value_type ValueType;
+  typedef typename discrete_linear_sss_traits<LinearSystem>::matrixC_type MatCType;
+  // fixed-size temporaries (on the stack) whenever the output matrix has static dimensions:
+  typedef typename mat_fix_or_dynamic<ValueType, mat_structure::rectangular, 
+    mat_traits<MatCType>::static_row_count, mat_traits<MatCType>::static_col_count>::type MatCPType;
+  typedef typename mat_fix_or_dynamic<ValueType, mat_structure::symmetric, 
+    mat_traits<MatCType>::static_row_count, mat_traits<MatCType>::static_row_count>::type MatSType;
+  typedef typename mat_fix_or_dynamic<ValueType, mat_structure::rectangular, 
+    mat_traits<MatCType>::static_col_count, mat_traits<MatCType>::static_row_count, mat_alignment::row_major>::type MatKType;
   
   typename discrete_linear_sss_traits<LinearSystem>::matrixA_type A;
   typename discrete_linear_sss_traits<LinearSystem>::matrixB_type B;
@@ -242,20 +258,216 @@ void >::type kalman_filter_step(const LinearSystem& sys,
 
   x = sys.get_next_state(state_space, x, b_u.get_mean_state(), t);
   sys.get_state_transition_blocks(A, B, state_space, t, t + sys.get_time_step(), b_x.get_mean_state(), x, b_u.get_mean_state(), b_u.get_mean_state());
-  P = ( A * P * transpose_view(A)) + B * b_u.get_covariance().get_matrix() * transpose_view(B);
+  lazy_assign(P, lazy_expr(A) * P * transpose(lazy_expr(A)) + lazy_expr(B) * b_u.get_covariance().get_matrix() * transpose(lazy_expr(B)));
   
   sys.get_output_function_blocks(C, D, state_space, t + sys.get_time_step(), x, b_u.get_mean_state());
   vect_n<ValueType> y = to_vect<ValueType>(b_z.get_mean_state() - sys.get_output(state_space, x, b_u.get_mean_state(), t + sys.get_time_step()));
-  mat< ValueType, mat_structure::rectangular, mat_alignment::column_major > CP = C * P;
-  mat< ValueType, mat_structure::symmetric > S(CP * transpose_view(C) + b_z.get_covariance().get_matrix());  
+  MatCPType CP(C * P);
+  MatSType S(CP * transpose_view(C) + b_z.get_covariance().get_matrix());  
   linsolve_Cholesky(S,CP);
-  mat< ValueType, mat_structure::rectangular, mat_alignment::row_major > K( transpose_view(CP) );
+  MatKType K( transpose_view(CP) );
    
   b_x.set_mean_state( state_space.adjust( x, from_vect<StateDiffType>(K * y) ) );
   b_x.set_covariance( CovType( MatType( (mat< ValueType, mat_structure::identity>(K.get_row_count()) - K * C) * P ) ) );
 };
 
 
+namespace detail {
+
+/*
+ * This function performs the measurement correction of a Kalman filter one scalar measurement 
+ * at a time (sequential processing), which is only valid when the measurement noise covariance 
+ * is diagonal (uncorrelated measurements). The covariance matrix P is updated in-place and the
+ * state correction (gain times innovation) is returned. This avoids forming and factorizing the 
+ * innovation covariance matrix, at a cost of O(m*n^2) instead of O(m*n^2 + m^2*n + m^3).
+ */
+template <typename ValueType, typename MatrixC, typename MatrixR>
+vect_n<ValueType> kalman_sequential_correction(mat<ValueType, mat_structure::symmetric>& P, 
+                                               const MatrixC& C, const vect_n<ValueType>& y, 
+                                               const MatrixR& R) {
+  typedef typename mat<ValueType, mat_structure::symmetric>::size_type SizeType;
+  const SizeType N = P.get_row_count();
+  const SizeType M = C.get_row_count();
+  if((C.get_col_count() != N) || (y.size() != M) || (R.get_row_count() != M))
+    throw std::range_error("Measurement matrix, vector or covariance dimensions are not consistent with the state covariance!");
+  
+  vect_n<ValueType> dx(N, ValueType(0.0));
+  vect_n<ValueType> PCt(N, ValueType(0.0));
+  for(SizeType i = 0; i < M; ++i) {
+    ValueType s = R(i,i);
+    ValueType r = y[i];
+    for(SizeType j = 0; j < N; ++j) {
+      PCt[j] = ValueType(0.0);
+      for(SizeType k = 0; k < N; ++k)
+        PCt[j] += P(j,k) * C(i,k);
+      r -= C(i,j) * dx[j];
+    };
+    for(SizeType j = 0; j < N; ++j)
+      s += C(i,j) * PCt[j];
+    if(s <= std::numeric_limits<ValueType>::epsilon())
+      throw singularity_error("Innovation variance of a scalar measurement is not positive!");
+    r /= s;
+    for(SizeType j = 0; j < N; ++j) {
+      dx[j] += PCt[j] * r;
+      for(SizeType k = j; k < N; ++k)
+        P(j,k) -= PCt[j] * PCt[k] / s;
+    };
+  };
+  return dx;
+};
+
+};
+
+
+/**
+ * This function template performs one measurement update step using the (Extended) Kalman Filter method,
+ * but processes the measurement vector one scalar element at a time (sequential update). This is only 
+ * valid if the measurement covariance is diagonal (uncorrelated measurement noise), and any off-diagonal
+ * elements of it are ignored. This avoids the factorization of the innovation covariance matrix and is 
+ * thus much faster than kalman_update when the measurement vector is much larger than the state vector.
+ * For linear output functions, the result is the same as that of kalman_update.
+ * \tparam LinearSystem A discrete state-space system modeling the DiscreteLinearSSSConcept 
+ *         at least as a DiscreteLinearizedSystemType.
+ * \tparam StateSpaceType A topology type on which the state-vectors can reside, should model
+ *         the pp::TopologyConcept.
+ * \tparam BeliefState A belief state type modeling the ContinuousBeliefStateConcept with
+ *         a unimodular gaussian representation.
+ * \tparam InputBelief A belief state type modeling the ContinuousBeliefStateConcept with
+ *         a unimodular gaussian representation.
+ * \tparam MeasurementBelief A belief state type modeling the ContinuousBeliefStateConcept with
+ *         a unimodular gaussian representation (with a diagonal covariance).
+ * \param sys The discrete state-space system used in the state estimation.
+ * \param state_space The state-space topology on which the state representations lie.
+ * \param b_x As input, it stores the belief-state before the update step. As output, it stores
+ *        the belief-state after the update step.
+ * \param b_u The input vector to apply to the state-space system to make the transition of the 
+ *        mean-state, i.e., the current input vector and its covariance.
+ * \param b_z The output belief that was measured, i.e. the measurement vector and its covariance.
+ * \param t The current time.
+ * \throws singularity_error If the innovation variance of one of the measurements is not positive.
+ * 
+ */
+template <typename LinearSystem, 
+          typename StateSpaceType,
+          typename BeliefState, 
+	  typename InputBelief, 
+	  typename MeasurementBelief>
+typename boost::enable_if_c< is_continuous_belief_state<BeliefState>::value &&
+                             (belief_state_traits<BeliefState>::representation == belief_representation::gaussian) &&
+                             (belief_state_traits<BeliefState>::distribution == belief_distribution::unimodal),
+void >::type kalman_sequential_update(const LinearSystem& sys,
+			              const StateSpaceType& state_space,
+			              BeliefState& b_x,
+			              const InputBelief& b_u,
+			              const MeasurementBelief& b_z,
+			              typename discrete_sss_traits<LinearSystem>::time_type t = 0) {
+  BOOST_CONCEPT_ASSERT((pp::TopologyConcept< StateSpaceType >));
+  BOOST_CONCEPT_ASSERT((DiscreteLinearSSSConcept< LinearSystem, StateSpaceType, DiscreteLinearizedSystemType >));
+  BOOST_CONCEPT_ASSERT((ContinuousBeliefStateConcept<BeliefState>));
+  BOOST_CONCEPT_ASSERT((ContinuousBeliefStateConcept<InputBelief>));
+  BOOST_CONCEPT_ASSERT((ContinuousBeliefStateConcept<MeasurementBelief>));
+  
+  typedef typename pp::topology_traits<StateSpaceType>::point_type StateType;
+  typedef typename pp::topology_traits<StateSpaceType>::point_type StateDiffType;
+  typedef typename continuous_belief_state_traits<BeliefState>::covariance_type CovType;
+  typedef typename covariance_mat_traits< CovType >::matrix_type MatType;
+  typedef typename mat_traits<MatType>::value_type ValueType;
+  
+  typename discrete_linear_sss_traits<LinearSystem>::matrixC_type C;
+  typename discrete_linear_sss_traits<LinearSystem>::matrixD_type D;
+  StateType x = b_x.get_mean_state();
+  mat< ValueType, mat_structure::symmetric > P(b_x.get_covariance().get_matrix());
+  sys.get_output_function_blocks(C, D, state_space, t, x, b_u.get_mean_state());
+  
+  vect_n<ValueType> y = to_vect<ValueType>(b_z.get_mean_state() - sys.get_output(state_space, x, b_u.get_mean_state(), t));
+  vect_n<ValueType> dx = detail::kalman_sequential_correction(P, C, y, b_z.get_covariance().get_matrix());
+  
+  b_x.set_mean_state( state_space.adjust(x, from_vect<StateDiffType>(dx) ) );
+  b_x.set_covariance( CovType( MatType( P ) ) );
+};
+
+
+/**
+ * This function template performs a number of consecutive estimation steps using the (Extended) Kalman 
+ * Filter method, over a window of inputs and measurements (e.g., a buffer of delayed measurements 
+ * being replayed from an older belief-state). The mean-state and covariance are carried through the 
+ * whole window without being stored back into the belief-state until the end, and each measurement
+ * update is done sequentially (see kalman_sequential_update), which requires the measurement 
+ * covariances to be diagonal.
+ * \tparam LinearSystem A discrete state-space system modeling the DiscreteLinearSSSConcept 
+ *         at least as a DiscreteLinearizedSystemType.
+ * \tparam StateSpaceType A topology type on which the state-vectors can reside, should model
+ *         the pp::TopologyConcept.
+ * \tparam BeliefState A belief state type modeling the ContinuousBeliefStateConcept with
+ *         a unimodular gaussian representation.
+ * \tparam InputBeliefIter A forward-iterator type whose value-type is an input belief-state type
+ *         (modeling the ContinuousBeliefStateConcept with a unimodular gaussian representation).
+ * \tparam MeasurementBeliefIter A forward-iterator type whose value-type is a measurement belief-state type
+ *         (modeling the ContinuousBeliefStateConcept with a unimodular gaussian representation).
+ * \param sys The discrete state-space system used in the state estimation.
+ * \param state_space The state-space topology on which the state representations lie.
+ * \param b_x As input, it stores the belief-state before the first estimation step. As output, it stores
+ *        the belief-state after the last estimation step.
+ * \param u_first The iterator to the first input belief of the window.
+ * \param u_last The iterator to the one-past-last input belief of the window.
+ * \param z_first The iterator to the first measurement belief of the window (measured one time-step 
+ *        after the corresponding input), there must be as many measurements as there are inputs.
+ * \param t The time before the first prediction (each step advances by the system's time-step).
+ * \return The time after the last estimation step.
+ * \throws singularity_error If the innovation variance of one of the measurements is not positive.
+ * 
+ */
+template <typename LinearSystem, 
+          typename StateSpaceType,
+          typename BeliefState, 
+	  typename InputBeliefIter, 
+	  typename MeasurementBeliefIter>
+typename boost::enable_if_c< is_continuous_belief_state<BeliefState>::value &&
+                             (belief_state_traits<BeliefState>::representation == belief_representation::gaussian) &&
+                             (belief_state_traits<BeliefState>::distribution == belief_distribution::unimodal),
+typename discrete_sss_traits<LinearSystem>::time_type >::type kalman_filter_window(const LinearSystem& sys,
+			                                                           const StateSpaceType& state_space,
+			                                                           BeliefState& b_x,
+			                                                           InputBeliefIter u_first,
+			                                                           InputBeliefIter u_last,
+			                                                           MeasurementBeliefIter z_first,
+			                                                           typename discrete_sss_traits<LinearSystem>::time_type t = 0) {
+  BOOST_CONCEPT_ASSERT((pp::TopologyConcept< StateSpaceType >));
+  BOOST_CONCEPT_ASSERT((DiscreteLinearSSSConcept< LinearSystem, StateSpaceType, DiscreteLinearizedSystemType >));
+  BOOST_CONCEPT_ASSERT((ContinuousBeliefStateConcept<BeliefState>));
+  
+  typedef typename pp::topology_traits<StateSpaceType>::point_type StateType;
+  typedef typename pp::topology_traits<StateSpaceType>::point_type StateDiffType;
+  typedef typename continuous_belief_state_traits<BeliefState>::covariance_type CovType;
+  typedef typename covariance_mat_traits< CovType >::matrix_type MatType;
+  typedef typename mat_traits<MatType>::value_type ValueType;
+  
+  typename discrete_linear_sss_traits<LinearSystem>::matrixA_type A;
+  typename discrete_linear_sss_traits<LinearSystem>::matrixB_type B;
+  typename discrete_linear_sss_traits<LinearSystem>::matrixC_type C;
+  typename discrete_linear_sss_traits<LinearSystem>::matrixD_type D;
+  StateType x = b_x.get_mean_state();
+  mat< ValueType, mat_structure::symmetric > P(b_x.get_covariance().get_matrix());
+  
+  for(; u_first != u_last; ++u_first, ++z_first) {
+    StateType x_prior = sys.get_next_state(state_space, x, u_first->get_mean_state(), t);
+    sys.get_state_transition_blocks(A, B, state_space, t, t + sys.get_time_step(), x, x_prior, u_first->get_mean_state(), u_first->get_mean_state());
+    lazy_assign(P, lazy_expr(A) * P * transpose(lazy_expr(A)) + lazy_expr(B) * u_first->get_covariance().get_matrix() * transpose(lazy_expr(B)));
+    t += sys.get_time_step();
+    
+    sys.get_output_function_blocks(C, D, state_space, t, x_prior, u_first->get_mean_state());
+    vect_n<ValueType> y = to_vect<ValueType>(z_first->get_mean_state() - sys.get_output(state_space, x_prior, u_first->get_mean_state(), t));
+    vect_n<ValueType> dx = detail::kalman_sequential_correction(P, C, y, z_first->get_covariance().get_matrix());
+    x = state_space.adjust(x_prior, from_vect<StateDiffType>(dx));
+  };
+  
+  b_x.set_mean_state( x );
+  b_x.set_covariance( CovType( MatType( P ) ) );
+  return t;
+};
+
+
+
 
 
 /**
@@ -36,6 +36,10 @@
 #include "linear_ss_system_concept.hpp"
 #include "discrete_linear_sss_concept.hpp"
 
+#include "path_planning/spatial_trajectory_concept.hpp"
+#include "topologies/temporal_space.hpp"
+#include "topologies/time_topology.hpp"
+
 #include "base/named_object.hpp"
 
 #include "lin_alg/mat_alg.hpp"
@@ -43,6 +47,8 @@
 
 #include "lin_alg/mat_are_solver.hpp"
 
+#include "base/thread_incl.hpp"
+
 namespace ReaK {
 
 namespace ctrl {
@@ -59,6 +65,9 @@ namespace ctrl {
 template <typename StateSpaceSystem, typename StateSpaceType, typename TrajectoryType>
 class dt_ih_lqr_controller : public named_object {
   public:
+    typedef dt_ih_lqr_controller<StateSpaceSystem,StateSpaceType,TrajectoryType> self;
+    typedef std::size_t size_type;
+    
     BOOST_CONCEPT_ASSERT((DiscreteLinearSSSConcept<StateSpaceSystem, StateSpaceType, DiscreteLinearizedSystemType>));
     BOOST_CONCEPT_ASSERT((pp::SpatialTrajectoryConcept<TrajectoryType, pp::temporal_space<StateSpaceType, pp::time_topology> >));
     
@@ -92,6 +101,10 @@ class dt_ih_lqr_controller : public named_object {
     mat<value_type,mat_structure::square> Q;
     mat<value_type,mat_structure::square> R;
     
+    mutable dare_solver<value_type> m_are_solver; ///< Holds the DARE workspace, reused each time the gain is recomputed.
+    mutable mat<value_type,mat_structure::square> m_P;
+    mutable ReaKaux::mutex m_are_mutex; ///< Guards the DARE workspace (m_are_solver and m_P) shared by calls to get_output.
+    
   public:
         
     /**
@@ -112,7 +125,10 @@ class dt_ih_lqr_controller : public named_object {
       const shared_ptr< TrajectoryType >& aTraj = shared_ptr< TrajectoryType >()) :
       m_sys(aSys), m_state_space(aSpace), m_traj(aTraj), 
       Q(aQ), 
-      R(aR) {
+      R(aR),
+      m_are_solver(aQ.get_row_count(), aR.get_row_count(), value_type(1e-4)),
+      m_P(aQ.get_row_count()),
+      m_are_mutex() {
       setName(aName);
     };
     
@@ -174,6 +190,9 @@ class dt_ih_lqr_controller : public named_object {
     
     /**
      * Returns output of the system given the current state, input and time.
+     * The gain computation is serialized (on a mutex), because it reuses the solver's workspace, 
+     * so that threads sharing one controller wait on each other. The Schur pencils are not re-allocated, 
+     * but the system matrices (A, B), the gain K and the vector temporaries still are, at each call.
      * \param u The current input.
      * \param t The current time.
      * \return The current output.
@@ -187,7 +206,10 @@ class dt_ih_lqr_controller : public named_object {
       m_sys->get_state_transition_blocks(A, B, *m_state_space, t, t, u, u, from_vect<output_type>(vect_n<value_type>(get_output_count(),value_type(0.0))), from_vect<output_type>(vect_n<value_type>(get_output_count(),value_type(0.0))));
       
       mat< value_type, mat_structure::rectangular > K(get_output_count(), get_input_count());
-      solve_IHDT_LQR(A, B, Q, R, K, value_type(1e-4));
+      {
+        ReaKaux::unique_lock< ReaKaux::mutex > lock_here(m_are_mutex);
+        m_are_solver.solve_LQR(A, B, Q, R, K, m_P);
+      };
       
       return from_vect<output_type>( K * to_vect<value_type>( m_state_space->difference(m_traj->get_point_at_time(t).pt, u) ) );
     };
@@ -230,6 +252,9 @@ class dt_ih_lqr_controller : public named_object {
 template <typename StateSpaceSystem, typename StateSpaceType, typename TrajectoryType>
 class ct_ih_lqr_controller : public named_object {
   public:
+    typedef ct_ih_lqr_controller<StateSpaceSystem,StateSpaceType,TrajectoryType> self;
+    typedef std::size_t size_type;
+    
     BOOST_CONCEPT_ASSERT((LinearSSSystemConcept<StateSpaceSystem, StateSpaceType, LinearizedSystemType>));
     BOOST_CONCEPT_ASSERT((pp::SpatialTrajectoryConcept<TrajectoryType, pp::temporal_space<StateSpaceType, pp::time_topology> >));
     
@@ -263,6 +288,10 @@ class ct_ih_lqr_controller : public named_object {
     mat<value_type,mat_structure::square> Q;
     mat<value_type,mat_structure::square> R;
     
+    mutable care_solver<value_type> m_are_solver; ///< Holds the CARE workspace, reused each time the gain is recomputed.
+    mutable mat<value_type,mat_structure::square> m_P;
+    mutable ReaKaux::mutex m_are_mutex; ///< Guards the CARE workspace (m_are_solver and m_P) shared by calls to get_output.
+    
   public:
         
     /**
@@ -283,7 +312,10 @@ class ct_ih_lqr_controller : public named_object {
       const shared_ptr< TrajectoryType >& aTraj = shared_ptr< TrajectoryType >()) :
       m_sys(aSys), m_state_space(aSpace), m_traj(aTraj), 
       Q(aQ), 
-      R(aR) {
+      R(aR),
+      m_are_solver(aQ.get_row_count(), aR.get_row_count(), value_type(1e-4)),
+      m_P(aQ.get_row_count()),
+      m_are_mutex() {
       setName(aName);
     };
     
@@ -345,6 +377,9 @@ class ct_ih_lqr_controller : public named_object {
     
     /**
      * Returns output of the system given the current state, input and time.
+     * The gain computation is serialized (on a mutex), because it reuses the solver's workspace, 
+     * so that threads sharing one controller wait on each other. The Schur pencils are not re-allocated, 
+     * but the system matrices (A, B, C, D), the gain K and the vector temporaries still are, at each call.
      * \param u The current input.
      * \param t The current time.
      * \return The current output.
@@ -362,7 +397,10 @@ class ct_ih_lqr_controller : public named_object {
       m_sys->get_linear_blocks(A, B, C, D, *m_state_space, t, u, from_vect<output_type>(vect_n<value_type>(get_output_count(),value_type(0.0))));
       
       mat< value_type, mat_structure::rectangular > K(get_output_count(), get_input_count());
-      solve_IHCT_LQR(A, B, Q, R, K, value_type(1e-4));
+      {
+        ReaKaux::unique_lock< ReaKaux::mutex > lock_here(m_are_mutex);
+        m_are_solver.solve_LQR(A, B, Q, R, K, m_P);
+      };
       
       return from_vect<output_type>( K * to_vect<value_type>( m_state_space->difference(m_traj->get_point_at_time(t).pt, u) ) );
     };
@@ -0,0 +1,429 @@
+/**
+ * \file square_root_kalman_filter.hpp
+ * 
+ * This library provides a number of functions and classes to do state estimation 
+ * using the Square-Root (Extended) Kalman Filter. This filtering technique applies to a 
+ * gaussian belief state where the covariance is represented by its Cholesky factor 
+ * (see cholesky_covariance_matrix.hpp). The prediction and update steps are carried out 
+ * directly on the Cholesky factor by orthogonal (QR) triangularizations of compound 
+ * (pre-)arrays, which guarantees that the covariance matrix stays symmetric and 
+ * positive semi-definite, and avoids re-computing the factorization at every step.
+ * 
+ * \author Sven Mikael Persson <mikael.s.persson@gmail.com>
+ * \date May 2013
+ */
+
+/*
+ *    Copyright 2013 Sven Mikael Persson
+ *
+ *    THIS SOFTWARE IS DISTRIBUTED UNDER THE TERMS OF THE GNU GENERAL PUBLIC LICENSE v3 (GPLv3).
+ *
+ *    This file is part of ReaK.
+ *
+ *    ReaK is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    (at your option) any later version.
+ *
+ *    ReaK is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with ReaK (as LICENSE in the root folder).  
+ *    If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef REAK_SQUARE_ROOT_KALMAN_FILTER_HPP
+#define REAK_SQUARE_ROOT_KALMAN_FILTER_HPP
+
+#include "belief_state_concept.hpp"
+#include "discrete_linear_sss_concept.hpp"
+#include <boost/utility/enable_if.hpp>
+#include <lin_alg/vect_concepts.hpp>
+#include <lin_alg/mat_alg.hpp>
+#include <lin_alg/mat_cholesky.hpp>
+#include <lin_alg/mat_qr_decomp.hpp>
+
+#include <boost/static_assert.hpp>
+#include "covariance_concept.hpp"
+
+#include "gaussian_belief_state.hpp"
+#include "cholesky_covariance_matrix.hpp"
+
+#include "path_planning/metric_space_concept.hpp"
+
+namespace ReaK {
+
+namespace ctrl {
+
+
+namespace detail {
+
+/**
+ * This function lower-triangularizes a compound (pre-)array M (N x K, with K >= N) by applying 
+ * an orthogonal transformation from the right, i.e., M * Theta = [L 0], such that 
+ * M * transpose(M) = L * transpose(L). The lower-triangular factor L (with non-negative diagonal) 
+ * is stored in the first N columns of M, and the remaining columns are left unspecified.
+ */
+template <typename Matrix>
+void sr_lower_triangularize(Matrix& M, typename mat_traits<Matrix>::value_type NumTol) {
+  typedef typename mat_traits<Matrix>::value_type ValueType;
+  typedef typename mat_traits<Matrix>::size_type SizeType;
+  
+  mat_transpose_view< Matrix > M_t(M);
+  ReaK::detail::decompose_QR_impl(M_t, static_cast< mat<ValueType, mat_structure::square>* >(NULL), NumTol);
+  
+  SizeType N = M.get_row_count();
+  for(SizeType i = 0; i < N; ++i) {
+    for(SizeType j = i + 1; j < N; ++j)
+      M(i,j) = ValueType(0);
+    if(M(i,i) < ValueType(0))
+      for(SizeType j = i; j < N; ++j)
+        M(j,i) = -M(j,i);
+  };
+};
+
+};
+
+
+/**
+ * This function template performs one prediction step using the Square-Root (Extended) Kalman Filter method.
+ * The Cholesky factor of the covariance is obtained by a QR triangularization of the compound array 
+ * [ A * S_x,  B * S_u ], where S_x and S_u are the Cholesky factors of the state and input covariances.
+ * \tparam LinearSystem A discrete state-space system modeling the DiscreteLinearSSSConcept 
+ *         at least as a DiscreteLinearizedSystemType.
+ * \tparam StateSpaceType A topology type on which the state-vectors can reside, should model
+ *         the pp::TopologyConcept.
+ * \tparam BeliefState A belief state type modeling the ContinuousBeliefStateConcept with
+ *         a unimodular gaussian representation, and a factored covariance (e.g., cholesky_covariance_matrix).
+ * \tparam InputBelief A belief state type modeling the ContinuousBeliefStateConcept with
+ *         a unimodular gaussian representation.
+ * \param sys The discrete state-space system used in the state estimation.
+ * \param state_space The state-space topology on which the state representations lie.
+ * \param b_x As input, it stores the belief-state before the prediction step. As output, it stores
+ *        the belief-state after the prediction step.
+ * \param b_u The input belief to apply to the state-space system to make the transition of the 
+ *        mean-state, i.e., the current input vector and its covariance.
+ * \param t The current time (before the prediction).
+ * 
+ */
+template <typename LinearSystem, 
+          typename StateSpaceType,
+          typename BeliefState, 
+	  typename InputBelief>
+typename boost::enable_if_c< is_continuous_belief_state<BeliefState>::value &&
+                             (belief_state_traits<BeliefState>::representation == belief_representation::gaussian) &&
+                             (belief_state_traits<BeliefState>::distribution == belief_distribution::unimodal),
+void >::type sr_kalman_predict(const LinearSystem& sys, 
+			       const StateSpaceType& state_space,
+			       BeliefState& b_x,
+			       const InputBelief& b_u,
+			       typename discrete_sss_traits<LinearSystem>::time_type t = 0) {
+  BOOST_CONCEPT_ASSERT((pp::TopologyConcept< StateSpaceType >));
+  BOOST_CONCEPT_ASSERT((DiscreteLinearSSSConcept< LinearSystem, StateSpaceType, DiscreteLinearizedSystemType >));
+  BOOST_CONCEPT_ASSERT((ContinuousBeliefStateConcept<BeliefState>));
+  BOOST_CONCEPT_ASSERT((ContinuousBeliefStateConcept<InputBelief>));
+  
+  typedef typename pp::topology_traits<StateSpaceType>::point_type StateType;
+  typedef typename continuous_belief_state_traits<BeliefState>::covariance_type CovType;
+  typedef typename covariance_mat_traits< CovType >::value_type ValueType;
+  typedef typename mat_traits< mat<ValueType, mat_structure::square> >::size_type SizeType;
+  BOOST_STATIC_ASSERT((covariance_mat_traits< CovType >::storage == covariance_storage::factored));
+  
+  typename discrete_linear_sss_traits<LinearSystem>::matrixA_type A;
+  typename discrete_linear_sss_traits<LinearSystem>::matrixB_type B;
+  StateType x = b_x.get_mean_state();
+  
+  mat<ValueType, mat_structure::square> S_x;
+  mat<ValueType, mat_structure::square> S_u;
+  get_cholesky_factor(b_x.get_covariance(), S_x);
+  get_cholesky_factor(b_u.get_covariance(), S_u);
+  SizeType N = S_x.get_row_count();
+  SizeType M = S_u.get_row_count();
+  
+  b_x.set_mean_state( sys.get_next_state(state_space, x, b_u.get_mean_state(), t) );
+  sys.get_state_transition_blocks(A, B, state_space, t, t + sys.get_time_step(), x, b_x.get_mean_state(), b_u.get_mean_state(), b_u.get_mean_state());
+  
+  mat<ValueType, mat_structure::rectangular> M_pre(N, N + M);
+  sub(M_pre)(range(0,N-1),range(0,N-1)) = A * S_x;
+  if(M > 0)
+    sub(M_pre)(range(0,N-1),range(N,N+M-1)) = B * S_u;
+  detail::sr_lower_triangularize(M_pre, std::numeric_limits<ValueType>::epsilon());
+  
+  b_x.set_covariance( CovType( mat<ValueType, mat_structure::square>( sub(M_pre)(range(0,N-1),range(0,N-1)) ) ) );
+};
+
+
+/**
+ * This function template performs one measurement update step using the Square-Root (Extended) Kalman Filter method.
+ * The gain and the Cholesky factor of the updated covariance are obtained by a QR triangularization 
+ * of the compound array [ S_z, C * S_x ; 0, S_x ], where S_x and S_z are the Cholesky factors of the 
+ * state and measurement covariances, which avoids the inversion of the innovation covariance matrix.
+ * \tparam LinearSystem A discrete state-space system modeling the DiscreteLinearSSSConcept 
+ *         at least as a DiscreteLinearizedSystemType.
+ * \tparam StateSpaceType A topology type on which the state-vectors can reside, should model
+ *         the pp::TopologyConcept.
+ * \tparam BeliefState A belief state type modeling the ContinuousBeliefStateConcept with
+ *         a unimodular gaussian representation, and a factored covariance (e.g., cholesky_covariance_matrix).
+ * \tparam InputBelief A belief state type modeling the ContinuousBeliefStateConcept with
+ *         a unimodular gaussian representation.
+ * \tparam MeasurementBelief A belief state type modeling the ContinuousBeliefStateConcept with
+ *         a unimodular gaussian representation.
+ * \param sys The discrete state-space system used in the state estimation.
+ * \param state_space The state-space topology on which the state representations lie.
+ * \param b_x As input, it stores the belief-state before the update step. As output, it stores
+ *        the belief-state after the update step.
+ * \param b_u The input vector to apply to the state-space system to make the transition of the 
+ *        mean-state, i.e., the current input vector and its covariance.
+ * \param b_z The output belief that was measured, i.e. the measurement vector and its covariance.
+ * \param t The current time.
+ * 
+ */
+template <typename LinearSystem, 
+          typename StateSpaceType,
+          typename BeliefState, 
+	  typename InputBelief, 
+	  typename MeasurementBelief>
+typename boost::enable_if_c< is_continuous_belief_state<BeliefState>::value &&
+                             (belief_state_traits<BeliefState>::representation == belief_representation::gaussian) &&
+                             (belief_state_traits<BeliefState>::distribution == belief_distribution::unimodal),
+void >::type sr_kalman_update(const LinearSystem& sys,
+			      const StateSpaceType& state_space,
+			      BeliefState& b_x,
+			      const InputBelief& b_u,
+			      const MeasurementBelief& b_z,
+			      typename discrete_sss_traits<LinearSystem>::time_type t = 0) {
+  BOOST_CONCEPT_ASSERT((pp::TopologyConcept< StateSpaceType >));
+  BOOST_CONCEPT_ASSERT((DiscreteLinearSSSConcept< LinearSystem, StateSpaceType, DiscreteLinearizedSystemType >));
+  BOOST_CONCEPT_ASSERT((ContinuousBeliefStateConcept<BeliefState>));
+  BOOST_CONCEPT_ASSERT((ContinuousBeliefStateConcept<InputBelief>));
+  BOOST_CONCEPT_ASSERT((ContinuousBeliefStateConcept<MeasurementBelief>));
+  
+  typedef typename pp::topology_traits<StateSpaceType>::point_type StateType;
+  typedef typename pp::topology_traits<StateSpaceType>::point_type StateDiffType;
+  typedef typename continuous_belief_state_traits<BeliefState>::covariance_type CovType;
+  typedef typename covariance_mat_traits< CovType >::value_type ValueType;
+  typedef typename mat_traits< mat<ValueType, mat_structure::square> >::size_type SizeType;
+  BOOST_STATIC_ASSERT((covariance_mat_traits< CovType >::storage == covariance_storage::factored));
+  
+  typename discrete_linear_sss_traits<LinearSystem>::matrixC_type C;
+  typename discrete_linear_sss_traits<LinearSystem>::matrixD_type D;
+  StateType x = b_x.get_mean_state();
+  sys.get_output_function_blocks(C, D, state_space, t, x, b_u.get_mean_state());
+  
+  mat<ValueType, mat_structure::square> S_x;
+  mat<ValueType, mat_structure::square> S_z;
+  get_cholesky_factor(b_x.get_covariance(), S_x);
+  get_cholesky_factor(b_z.get_covariance(), S_z);
+  SizeType N = S_x.get_row_count();
+  SizeType M = S_z.get_row_count();
+  if(M == 0)
+    return; // nothing is measured.
+  
+  mat<ValueType, mat_structure::rectangular> M_pre(M + N, M + N, ValueType(0));
+  sub(M_pre)(range(0,M-1),range(0,M-1)) = S_z;
+  sub(M_pre)(range(0,M-1),range(M,M+N-1)) = C * S_x;
+  sub(M_pre)(range(M,M+N-1),range(M,M+N-1)) = S_x;
+  detail::sr_lower_triangularize(M_pre, std::numeric_limits<ValueType>::epsilon());
+  
+  // the post-array is [ S_e, 0 ; K * S_e, S_x_post ], solve S_e * w = y by forward-substitution:
+  vect_n<ValueType> w = to_vect<ValueType>(b_z.get_mean_state() - sys.get_output(state_space, x, b_u.get_mean_state(), t));
+  for(SizeType i = 0; i < M; ++i) {
+    for(SizeType k = 0; k < i; ++k)
+      w[i] -= M_pre(i,k) * w[k];
+    if(M_pre(i,i) < std::numeric_limits<ValueType>::epsilon())
+      throw singularity_error("'Innovation Covariance, in SR-KF update'");
+    w[i] /= M_pre(i,i);
+  };
+  
+  b_x.set_mean_state( state_space.adjust(x, from_vect<StateDiffType>( sub(M_pre)(range(M,M+N-1),range(0,M-1)) * w ) ) );
+  b_x.set_covariance( CovType( mat<ValueType, mat_structure::square>( sub(M_pre)(range(M,M+N-1),range(M,M+N-1)) ) ) );
+};
+
+
+/**
+ * This function template performs one complete estimation step using the Square-Root (Extended) Kalman 
+ * Filter method, which includes a prediction and measurement update step.
+ * \tparam LinearSystem A discrete state-space system modeling the DiscreteLinearSSSConcept 
+ *         at least as a DiscreteLinearizedSystemType.
+ * \tparam StateSpaceType A topology type on which the state-vectors can reside, should model
+ *         the pp::TopologyConcept.
+ * \tparam BeliefState A belief state type modeling the ContinuousBeliefStateConcept with
+ *         a unimodular gaussian representation, and a factored covariance (e.g., cholesky_covariance_matrix).
+ * \tparam InputBelief A belief state type modeling the ContinuousBeliefStateConcept with
+ *         a unimodular gaussian representation.
+ * \tparam MeasurementBelief A belief state type modeling the ContinuousBeliefStateConcept with
+ *         a unimodular gaussian representation.
+ * \param sys The discrete state-space system used in the state estimation.
+ * \param state_space The state-space topology on which the state representations lie.
+ * \param b_x As input, it stores the belief-state before the estimation step. As output, it stores
+ *        the belief-state after the estimation step.
+ * \param b_u The input vector to apply to the state-space system to make the transition of the 
+ *        mean-state, i.e., the current input vector and its covariance.
+ * \param b_z The output belief that was measured, i.e. the measurement vector and its covariance.
+ * \param t The current time (before the prediction).
+ * 
+ */
+template <typename LinearSystem, 
+          typename StateSpaceType,
+          typename BeliefState, 
+	  typename InputBelief, 
+	  typename MeasurementBelief>
+typename boost::enable_if_c< is_continuous_belief_state<BeliefState>::value &&
+                             (belief_state_traits<BeliefState>::representation == belief_representation::gaussian) &&
+                             (belief_state_traits<BeliefState>::distribution == belief_distribution::unimodal),
+void >::type sr_kalman_filter_step(const LinearSystem& sys,
+			           const StateSpaceType& state_space,
+			           BeliefState& b_x,
+			           const InputBelief& b_u,
+			           const MeasurementBelief& b_z,
+				   typename discrete_sss_traits<LinearSystem>::time_type t = 0) {
+  sr_kalman_predict(sys, state_space, b_x, b_u, t);
+  sr_kalman_update(sys, state_space, b_x, b_u, b_z, t + sys.get_time_step());
+};
+
+
+
+
+/**
+ * This class template can be used as a belief-state predictor (and transfer) that uses the 
+ * Square-Root (Extended) Kalman Filter method. This class template models the BeliefTransferConcept and 
+ * the BeliefPredictorConcept.
+ * \tparam LinearSystem A discrete state-space system modeling the DiscreteLinearSSSConcept 
+ *         at least as a DiscreteLinearizedSystemType.
+ * \tparam BeliefState A belief state type modeling the ContinuousBeliefStateConcept with
+ *         a unimodular gaussian representation and a factored covariance.
+ * \tparam SystemNoiseCovar A covariance matrix type modeling the CovarianceMatrixConcept.
+ * \tparam MeasurementCovar A covariance matrix type modeling the CovarianceMatrixConcept.
+ */
+template <typename LinearSystem,
+          typename BeliefState = gaussian_belief_state< typename discrete_sss_traits<LinearSystem>::point_type, cholesky_covariance_matrix< typename discrete_sss_traits<LinearSystem>::point_type > >,
+          typename SystemNoiseCovar = cholesky_covariance_matrix< typename discrete_sss_traits< LinearSystem >::input_type >,
+          typename MeasurementCovar = cholesky_covariance_matrix< typename discrete_sss_traits< LinearSystem >::output_type > >
+struct SRKF_belief_transfer {
+  typedef SRKF_belief_transfer<LinearSystem, BeliefState, SystemNoiseCovar, MeasurementCovar> self;
+  typedef BeliefState belief_state;
+  typedef LinearSystem state_space_system;
+  typedef shared_ptr< state_space_system > state_space_system_ptr;
+  typedef typename discrete_sss_traits< state_space_system >::time_type time_type;
+  typedef typename discrete_sss_traits< state_space_system >::time_difference_type time_difference_type;
+
+  typedef typename belief_state_traits< belief_state >::state_type state_type;
+  typedef typename continuous_belief_state_traits<BeliefState>::covariance_type covariance_type;
+  typedef typename covariance_mat_traits< covariance_type >::matrix_type matrix_type;
+
+  typedef typename discrete_sss_traits< state_space_system >::input_type input_type;
+  typedef typename discrete_sss_traits< state_space_system >::output_type output_type;
+  
+  typedef gaussian_belief_state<input_type, SystemNoiseCovar> input_belief_type;
+  typedef gaussian_belief_state<output_type, MeasurementCovar> output_belief_type;
+  
+  BOOST_CONCEPT_ASSERT((ContinuousBeliefStateConcept<BeliefState>));
+  BOOST_CONCEPT_ASSERT((CovarianceMatrixConcept<SystemNoiseCovar, input_type>));
+  BOOST_CONCEPT_ASSERT((CovarianceMatrixConcept<MeasurementCovar, output_type>));
+
+  state_space_system_ptr sys; ///< Holds the reference to the system used for the filter.
+  SystemNoiseCovar Q; ///< Holds the system's input noise covariance matrix.
+  MeasurementCovar R; ///< Holds the system's output measurement's covariance matrix.
+
+  /**
+   * Parametrized constructor.
+   * \param aSys The reference to the system used for the filter.
+   * \param aQ The system's input noise covariance matrix.
+   * \param aR The system's output measurement's covariance matrix.
+   */
+  SRKF_belief_transfer(const state_space_system_ptr& aSys, 
+                       const SystemNoiseCovar& aQ,
+                       const MeasurementCovar& aR) : sys(aSys), Q(aQ), R(aR) { };
+  
+  /**
+   * Returns the time-step of the predictor.
+   * \return The time-step of the predictor.
+   */
+  time_difference_type get_time_step() const { return sys->get_time_step(); };
+
+  /**
+   * Returns a reference to the underlying state-space system.
+   * \return A reference to the underlying state-space system.
+   */
+  const state_space_system& get_ss_system() const { return *sys; };
+
+  /**
+   * Returns the belief-state at the next time instant.
+   * \tparam BeliefSpace The belief-space type on which to operate.
+   * \param b_space The belief-space on which the belief-states lie.
+   * \param b The current belief-state.
+   * \param t The current time.
+   * \param u The current input given to the system.
+   * \param y The output that was measured at the next time instant.
+   * \return the belief-state at the next time instant.
+   */
+  template <typename BeliefSpace>
+  belief_state get_next_belief(const BeliefSpace& b_space, belief_state b, const time_type& t, const input_type& u, const output_type& y) const {
+    sr_kalman_filter_step(*sys,b_space.get_state_topology(),b,input_belief_type(u,Q),output_belief_type(y,R),t);
+    return b;
+  };
+  
+  /**
+   * Returns the prediction belief-state at the next time instant.
+   * \tparam BeliefSpace The belief-space type on which to operate.
+   * \param b_space The belief-space on which the belief-states lie.
+   * \param b The current belief-state.
+   * \param t The current time.
+   * \param u The current input given to the system.
+   * \return the belief-state at the next time instant, predicted by the filter.
+   */
+  template <typename BeliefSpace>
+  belief_state predict_belief(const BeliefSpace& b_space, belief_state b, const time_type& t, const input_type& u) const {
+    sr_kalman_predict(*sys,b_space.get_state_topology(),b,input_belief_type(u,Q),t);
+    return b;
+  };
+  
+  /**
+   * Converts a prediction belief-state into an updated belief-state which assumes the most likely measurement.
+   * \tparam BeliefSpace The belief-space type on which to operate.
+   * \param b_space The belief-space on which the belief-states lie.
+   * \param b The current prediction's belief-state.
+   * \param t The current time.
+   * \param u The current input given to the system.
+   * \return the updated belief-state when assuming the most likely measurement.
+   */
+  template <typename BeliefSpace>
+  belief_state prediction_to_ML_belief(const BeliefSpace& b_space, belief_state b, const time_type& t, const input_type& u) const {
+    sr_kalman_update(*sys,b_space.get_state_topology(),b,input_belief_type(u,Q),output_belief_type(sys->get_output(b_space.get_state_topology(),b.get_mean_state(),u,t),R),t);
+    return b;
+  };
+  
+  /**
+   * Returns the prediction belief-state at the next time instant, assuming the upcoming measurement to be the most likely one.
+   * \tparam BeliefSpace The belief-space type on which to operate.
+   * \param b_space The belief-space on which the belief-states lie.
+   * \param b The current belief-state.
+   * \param t The current time.
+   * \param u The current input given to the system.
+   * \return the belief-state at the next time instant, predicted by the filter.
+   */
+  template <typename BeliefSpace>
+  belief_state predict_ML_belief(const BeliefSpace& b_space, belief_state b, const time_type& t, const input_type& u) const {
+    sr_kalman_predict(*sys,b_space.get_state_topology(),b,input_belief_type(u,Q),t);
+    sr_kalman_update(*sys,b_space.get_state_topology(),b,input_belief_type(u,Q),output_belief_type(sys->get_output(b_space.get_state_topology(),b.get_mean_state(),u,t + sys->get_time_step()),R),t + sys->get_time_step());
+    return b;
+  };
+  
+};
+
+
+
+
+
+
+
+
+};
+
+};
+
+
+#endif
@@ -0,0 +1,513 @@
+/**
+ * \file square_root_unscented_kalman_filter.hpp
+ * 
+ * This library provides a number of functions and classes to do state estimation 
+ * using the Square-Root Unscented Kalman Filter (SR-UKF). This filtering technique applies to a 
+ * gaussian belief state where the covariance is represented by its Cholesky factor 
+ * (see cholesky_covariance_matrix.hpp). The sigma-points are generated directly from the 
+ * Cholesky factor, and the Cholesky factor of the transformed covariance is obtained by 
+ * a QR triangularization of the weighted sigma-point deviations followed by a rank-one 
+ * update (or downdate) for the central sigma-point. This avoids the Cholesky decomposition
+ * (and the SVD fall-back) of the covariance matrix at every step, as done in the UKF 
+ * implementation of unscented_kalman_filter.hpp.
+ * 
+ * \author Sven Mikael Persson <mikael.s.persson@gmail.com>
+ * \date May 2013
+ */
+
+/*
+ *    Copyright 2013 Sven Mikael Persson
+ *
+ *    THIS SOFTWARE IS DISTRIBUTED UNDER THE TERMS OF THE GNU GENERAL PUBLIC LICENSE v3 (GPLv3).
+ *
+ *    This file is part of ReaK.
+ *
+ *    ReaK is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    (at your option) any later version.
+ *
+ *    ReaK is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with ReaK (as LICENSE in the root folder).  
+ *    If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef REAK_SQUARE_ROOT_UNSCENTED_KALMAN_FILTER_HPP
+#define REAK_SQUARE_ROOT_UNSCENTED_KALMAN_FILTER_HPP
+
+#include "belief_state_concept.hpp"
+#include "discrete_sss_concept.hpp"
+#include <boost/utility/enable_if.hpp>
+#include <lin_alg/vect_concepts.hpp>
+#include <lin_alg/mat_alg.hpp>
+#include <lin_alg/mat_cholesky.hpp>
+
+#include <boost/static_assert.hpp>
+#include "covariance_concept.hpp"
+
+#include "gaussian_belief_state.hpp"
+#include "cholesky_covariance_matrix.hpp"
+#include "square_root_kalman_filter.hpp"
+
+
+namespace ReaK {
+
+namespace ctrl {
+
+
+namespace detail {
+
+/**
+ * This function computes the Cholesky factor of the weighted covariance of a set of 
+ * sigma-points (as deviations from their mean), i.e., it computes the lower-triangular L such 
+ * that L * transpose(L) = W_0 * dX_0 * transpose(dX_0) + W_i * sum_k( dX_k * transpose(dX_k) ).
+ * The central weight W_0 may be negative, in which case a Cholesky downdate is performed.
+ */
+template <typename ValueType>
+mat<ValueType, mat_structure::square> sr_sigma_points_factor(const vect_n< vect_n<ValueType> >& dX, ValueType W_0, ValueType W_i) {
+  typedef typename vect_n<ValueType>::size_type SizeType;
+  using std::sqrt;
+  
+  SizeType N = dX[0].size();
+  SizeType K = dX.size() - 1;
+  mat<ValueType, mat_structure::rectangular> M_pre(N, (K > N ? K : N), ValueType(0));
+  ValueType sqrt_W_i = sqrt(W_i);
+  for(SizeType k = 0; k < K; ++k)
+    for(SizeType i = 0; i < N; ++i)
+      M_pre(i,k) = sqrt_W_i * dX[k+1][i];
+  sr_lower_triangularize(M_pre, std::numeric_limits<ValueType>::epsilon());
+  
+  mat<ValueType, mat_structure::square> L( sub(M_pre)(range(0,N-1),range(0,N-1)) );
+  if(W_0 < ValueType(0))
+    downdate_Cholesky(L, sqrt(-W_0) * dX[0], std::numeric_limits<ValueType>::epsilon());
+  else
+    update_Cholesky(L, sqrt(W_0) * dX[0]);
+  return L;
+};
+
+};
+
+
+/**
+ * This function template performs one prediction step using the Square-Root Unscented Kalman Filter method.
+ * The sigma-points are generated from the Cholesky factors of the state and input covariances (augmented).
+ * \tparam System A discrete state-space system modeling the DiscreteSSSConcept.
+ * \tparam StateSpaceType A topology type on which the state-vectors can reside, should model
+ *         the pp::TopologyConcept.
+ * \tparam BeliefState A belief state type modeling the ContinuousBeliefStateConcept with
+ *         a unimodular gaussian representation, and a factored covariance (e.g., cholesky_covariance_matrix).
+ * \tparam InputBelief A belief state type modeling the ContinuousBeliefStateConcept with
+ *         a unimodular gaussian representation.
+ * \param sys The discrete state-space system used in the state estimation.
+ * \param state_space The state-space topology on which the state representations lie.
+ * \param b_x As input, it stores the belief-state before the prediction step. As output, it stores
+ *        the belief-state after the prediction step.
+ * \param b_u The input belief to apply to the state-space system to make the transition of the 
+ *        mean-state, i.e., the current input vector and its covariance.
+ * \param t The current time (before the prediction).
+ * \param alpha The spread parameter of the sigma-points.
+ * \param kappa The secondary scaling parameter of the sigma-points.
+ * \param beta The prior-knowledge parameter of the distribution (2 is optimal for gaussian distributions).
+ * 
+ * \throws singularity_error if the central sigma-point downdate leads to a non-positive-definite covariance.
+ */
+template <typename System, 
+          typename StateSpaceType,
+          typename BeliefState, 
+	  typename InputBelief>
+typename boost::enable_if_c< is_continuous_belief_state<BeliefState>::value &&
+                             (belief_state_traits<BeliefState>::representation == belief_representation::gaussian) &&
+                             (belief_state_traits<BeliefState>::distribution == belief_distribution::unimodal),
+void >::type sr_unscented_kalman_predict(const System& sys,
+				         const StateSpaceType& state_space,
+				         BeliefState& b_x,
+				         const InputBelief& b_u,
+				         typename discrete_sss_traits<System>::time_type t = 0,
+				         typename belief_state_traits<BeliefState>::scalar_type alpha = 1E-3,
+				         typename belief_state_traits<BeliefState>::scalar_type kappa = 1,
+				         typename belief_state_traits<BeliefState>::scalar_type beta = 2) {
+  BOOST_CONCEPT_ASSERT((DiscreteSSSConcept< System, StateSpaceType >));
+  BOOST_CONCEPT_ASSERT((ContinuousBeliefStateConcept<BeliefState>));
+  BOOST_CONCEPT_ASSERT((ContinuousBeliefStateConcept<InputBelief>));
+  
+  using std::sqrt;
+  
+  typedef typename discrete_sss_traits<System>::point_type StateType;
+  typedef typename continuous_belief_state_traits<BeliefState>::covariance_type CovType;
+  typedef typename covariance_mat_traits< CovType >::value_type ValueType;
+  typedef typename vect_n<ValueType>::size_type SizeType;
+  typedef typename continuous_belief_state_traits<InputBelief>::state_type InputType;
+  BOOST_STATIC_ASSERT((covariance_mat_traits< CovType >::storage == covariance_storage::factored));
+  
+  StateType x = b_x.get_mean_state();
+  
+  mat<ValueType, mat_structure::square> S_x;
+  mat<ValueType, mat_structure::square> S_u;
+  get_cholesky_factor(b_x.get_covariance(), S_x);
+  get_cholesky_factor(b_u.get_covariance(), S_u);
+  
+  SizeType N = S_x.get_row_count();
+  SizeType M = S_u.get_row_count();
+  
+  ValueType lambda = alpha * alpha * (N + M + kappa) - N - M;
+  ValueType gamma = sqrt(ValueType(N + M) + lambda);
+  
+  vect_n< vect_n<ValueType> > X_a(1 + 2 * (N + M));
+  X_a[0] = to_vect<ValueType>(sys.get_next_state(state_space, x, b_u.get_mean_state(), t));
+  for(SizeType j = 0; j < N; ++j) {
+    StateType x_right = x;
+    StateType x_left = x;
+    for(SizeType i = j; i < N; ++i) {
+      x_right[i] += gamma * S_x(i,j);
+      x_left[i] -= gamma * S_x(i,j);
+    };
+    X_a[1+2*j] = to_vect<ValueType>(sys.get_next_state(state_space, x_right, b_u.get_mean_state(), t));
+    X_a[2+2*j] = to_vect<ValueType>(sys.get_next_state(state_space, x_left, b_u.get_mean_state(), t));
+  };
+  for(SizeType j = 0; j < M; ++j) {
+    InputType u_right = b_u.get_mean_state();
+    InputType u_left = b_u.get_mean_state();
+    for(SizeType i = j; i < M; ++i) {
+      u_right[i] += gamma * S_u(i,j);
+      u_left[i] -= gamma * S_u(i,j);
+    };
+    X_a[1+2*(N+j)] = to_vect<ValueType>(sys.get_next_state(state_space, x, u_right, t));
+    X_a[2+2*(N+j)] = to_vect<ValueType>(sys.get_next_state(state_space, x, u_left, t));
+  };
+  
+  gamma = ValueType(1) / (ValueType(N+M) + lambda);
+  vect_n<ValueType> x_mean = (lambda * gamma) * X_a[0];
+  for(SizeType j = 0; j < N + M; ++j)
+    x_mean += (0.5 * gamma) * (X_a[1+2*j] + X_a[2+2*j]);
+  for(SizeType j = 0; j < 1 + 2 * (N + M); ++j)
+    X_a[j] -= x_mean;
+  
+  b_x.set_mean_state(from_vect<StateType>(x_mean));
+  b_x.set_covariance( CovType( detail::sr_sigma_points_factor(X_a, lambda * gamma + ValueType(1) - alpha * alpha + beta, ValueType(0.5) * gamma) ) );
+};
+
+
+/**
+ * This function template performs one measurement update step using the Square-Root Unscented Kalman Filter method.
+ * The gain is obtained by two triangular back-substitutions with the Cholesky factor of the innovation 
+ * covariance, and the Cholesky factor of the state covariance is corrected by successive rank-one downdates.
+ * \tparam System A discrete state-space system modeling the DiscreteSSSConcept.
+ * \tparam StateSpaceType A topology type on which the state-vectors can reside, should model
+ *         the pp::TopologyConcept.
+ * \tparam BeliefState A belief state type modeling the ContinuousBeliefStateConcept with
+ *         a unimodular gaussian representation, and a factored covariance (e.g., cholesky_covariance_matrix).
+ * \tparam InputBelief A belief state type modeling the ContinuousBeliefStateConcept with
+ *         a unimodular gaussian representation.
+ * \tparam MeasurementBelief A belief state type modeling the ContinuousBeliefStateConcept with
+ *         a unimodular gaussian representation.
+ * \param sys The discrete state-space system used in the state estimation.
+ * \param state_space The state-space topology on which the state representations lie.
+ * \param b_x As input, it stores the belief-state before the update step. As output, it stores
+ *        the belief-state after the update step.
+ * \param b_u The input vector to apply to the state-space system to make the transition of the 
+ *        mean-state, i.e., the current input vector and its covariance.
+ * \param b_z The output belief that was measured, i.e. the measurement vector and its covariance.
+ * \param t The current time.
+ * \param alpha The spread parameter of the sigma-points.
+ * \param kappa The secondary scaling parameter of the sigma-points.
+ * \param beta The prior-knowledge parameter of the distribution (2 is optimal for gaussian distributions).
+ * 
+ * \throws singularity_error if the innovation covariance or the updated state covariance is not positive-definite.
+ */
+template <typename System, 
+          typename StateSpaceType,
+          typename BeliefState, 
+	  typename InputBelief, 
+	  typename MeasurementBelief>
+typename boost::enable_if_c< is_continuous_belief_state<BeliefState>::value &&
+                             (belief_state_traits<BeliefState>::representation == belief_representation::gaussian) &&
+                             (belief_state_traits<BeliefState>::distribution == belief_distribution::unimodal),
+void >::type sr_unscented_kalman_update(const System& sys,
+				        const StateSpaceType& state_space,
+				        BeliefState& b_x,
+				        const InputBelief& b_u,
+				        const MeasurementBelief& b_z,
+				        typename discrete_sss_traits<System>::time_type t = 0,
+				        typename belief_state_traits<BeliefState>::scalar_type alpha = 1E-3,
+				        typename belief_state_traits<BeliefState>::scalar_type kappa = 1,
+				        typename belief_state_traits<BeliefState>::scalar_type beta = 2) {
+  BOOST_CONCEPT_ASSERT((DiscreteSSSConcept< System, StateSpaceType >));
+  BOOST_CONCEPT_ASSERT((ContinuousBeliefStateConcept<BeliefState>));
+  BOOST_CONCEPT_ASSERT((ContinuousBeliefStateConcept<InputBelief>));
+  BOOST_CONCEPT_ASSERT((ContinuousBeliefStateConcept<MeasurementBelief>));
+  
+  using std::sqrt;
+  
+  typedef typename discrete_sss_traits<System>::point_type StateType;
+  typedef typename pp::topology_traits<StateSpaceType>::point_difference_type StateDiffType;
+  typedef typename continuous_belief_state_traits<BeliefState>::covariance_type CovType;
+  typedef typename covariance_mat_traits< CovType >::value_type ValueType;
+  typedef typename vect_n<ValueType>::size_type SizeType;
+  BOOST_STATIC_ASSERT((covariance_mat_traits< CovType >::storage == covariance_storage::factored));
+  
+  StateType x = b_x.get_mean_state();
+  
+  mat<ValueType, mat_structure::square> S_x;
+  mat<ValueType, mat_structure::square> S_z;
+  get_cholesky_factor(b_x.get_covariance(), S_x);
+  get_cholesky_factor(b_z.get_covariance(), S_z);
+  
+  SizeType N = S_x.get_row_count();
+  SizeType M = S_z.get_row_count();
+  if(M == 0)
+    return; // nothing is measured.
+  
+  ValueType lambda = alpha * alpha * (N + M + kappa) - N - M;
+  ValueType gamma = sqrt(ValueType(N + M) + lambda);
+  
+  // only the first N pairs of sigma-points deviate in the state, the rest deviate in the measurement noise.
+  vect_n< vect_n<ValueType> > Y_a(1 + 2 * (N + M));
+  Y_a[0] = to_vect<ValueType>(sys.get_output(state_space, x, b_u.get_mean_state(), t));
+  for(SizeType j = 0; j < N; ++j) {
+    StateType x_right = x;
+    StateType x_left = x;
+    for(SizeType i = j; i < N; ++i) {
+      x_right[i] += gamma * S_x(i,j);
+      x_left[i] -= gamma * S_x(i,j);
+    };
+    Y_a[1+2*j] = to_vect<ValueType>(sys.get_output(state_space, x_right, b_u.get_mean_state(), t));
+    Y_a[2+2*j] = to_vect<ValueType>(sys.get_output(state_space, x_left, b_u.get_mean_state(), t));
+  };
+  for(SizeType j = 0; j < M; ++j) {
+    Y_a[1+2*(N+j)] = Y_a[0];
+    Y_a[2+2*(N+j)] = Y_a[0];
+    for(SizeType i = j; i < M; ++i) {
+      Y_a[1+2*(N+j)][i] += gamma * S_z(i,j);
+      Y_a[2+2*(N+j)][i] -= gamma * S_z(i,j);
+    };
+  };
+  
+  ValueType W_0 = lambda / (ValueType(N+M) + lambda);
+  ValueType W_i = ValueType(0.5) / (ValueType(N+M) + lambda);
+  vect_n<ValueType> z_p = W_0 * Y_a[0];
+  for(SizeType j = 0; j < N + M; ++j)
+    z_p += W_i * (Y_a[1+2*j] + Y_a[2+2*j]);
+  for(SizeType j = 0; j < 1 + 2 * (N + M); ++j)
+    Y_a[j] -= z_p;
+  
+  mat<ValueType, mat_structure::square> S_e = detail::sr_sigma_points_factor(Y_a, W_0 + ValueType(1) - alpha * alpha + beta, W_i);
+  
+  // cross-covariance (transposed), the state deviations are gamma * S_x(:,j) for the first N pairs.
+  mat<ValueType, mat_structure::rectangular> Kt(M, N, ValueType(0));
+  for(SizeType j = 0; j < N; ++j)
+    for(SizeType i = j; i < N; ++i)
+      for(SizeType k = 0; k < M; ++k)
+        Kt(k,i) += W_i * gamma * S_x(i,j) * (Y_a[1+2*j][k] - Y_a[2+2*j][k]);
+  
+  ReaK::detail::backsub_Cholesky_impl(S_e, Kt);
+  
+  vect_n<ValueType> dz = to_vect<ValueType>(b_z.get_mean_state()) - z_p;
+  b_x.set_mean_state( state_space.adjust(x, from_vect<StateDiffType>( dz * Kt ) ) );
+  
+  // the update of the covariance factor is: P_post = P - K * S_e * transpose(K * S_e), as rank-one downdates.
+  mat<ValueType, mat_structure::rectangular> U( transpose_view(Kt) * S_e );
+  for(SizeType j = 0; j < M; ++j)
+    downdate_Cholesky(S_x, mat_row_slice< mat<ValueType, mat_structure::rectangular> >(U, j, 0, N), std::numeric_limits<ValueType>::epsilon());
+  
+  b_x.set_covariance( CovType( S_x ) );
+};
+
+
+/**
+ * This function template performs one complete estimation step using the Square-Root Unscented Kalman 
+ * Filter method, which includes a prediction and measurement update step.
+ * \tparam System A discrete state-space system modeling the DiscreteSSSConcept.
+ * \tparam StateSpaceType A topology type on which the state-vectors can reside, should model
+ *         the pp::TopologyConcept.
+ * \tparam BeliefState A belief state type modeling the ContinuousBeliefStateConcept with
+ *         a unimodular gaussian representation, and a factored covariance (e.g., cholesky_covariance_matrix).
+ * \tparam InputBelief A belief state type modeling the ContinuousBeliefStateConcept with
+ *         a unimodular gaussian representation.
+ * \tparam MeasurementBelief A belief state type modeling the ContinuousBeliefStateConcept with
+ *         a unimodular gaussian representation.
+ * \param sys The discrete state-space system used in the state estimation.
+ * \param state_space The state-space topology on which the state representations lie.
+ * \param b_x As input, it stores the belief-state before the estimation step. As output, it stores
+ *        the belief-state after the estimation step.
+ * \param b_u The input vector to apply to the state-space system to make the transition of the 
+ *        mean-state, i.e., the current input vector and its covariance.
+ * \param b_z The output belief that was measured, i.e. the measurement vector and its covariance.
+ * \param t The current time (before the prediction).
+ * \param alpha The spread parameter of the sigma-points.
+ * \param kappa The secondary scaling parameter of the sigma-points.
+ * \param beta The prior-knowledge parameter of the distribution (2 is optimal for gaussian distributions).
+ */
+template <typename System, 
+          typename StateSpaceType,
+          typename BeliefState, 
+	  typename InputBelief, 
+	  typename MeasurementBelief>
+typename boost::enable_if_c< is_continuous_belief_state<BeliefState>::value &&
+                             (belief_state_traits<BeliefState>::representation == belief_representation::gaussian) &&
+                             (belief_state_traits<BeliefState>::distribution == belief_distribution::unimodal),
+void >::type sr_unscented_kalman_filter_step(const System& sys,
+					     const StateSpaceType& state_space,
+					     BeliefState& b_x,
+					     const InputBelief& b_u,
+					     const MeasurementBelief& b_z,
+					     typename discrete_sss_traits<System>::time_type t = 0,
+					     typename belief_state_traits<BeliefState>::scalar_type alpha = 1E-3,
+					     typename belief_state_traits<BeliefState>::scalar_type kappa = 1,
+					     typename belief_state_traits<BeliefState>::scalar_type beta = 2) {
+  sr_unscented_kalman_predict(sys,state_space,b_x,b_u,t,alpha,kappa,beta);
+  sr_unscented_kalman_update(sys,state_space,b_x,b_u,b_z,t + sys.get_time_step(),alpha,kappa,beta);
+};
+
+
+
+/**
+ * This class template can be used as a belief-state predictor (and transfer) that uses the 
+ * Square-Root Unscented Kalman Filter method. This class template models the BeliefTransferConcept and 
+ * the BeliefPredictorConcept.
+ * \tparam System A discrete state-space system modeling the DiscreteSSSConcept.
+ * \tparam BeliefState A belief state type modeling the ContinuousBeliefStateConcept with
+ *         a unimodular gaussian representation and a factored covariance.
+ * \tparam SystemNoiseCovar A covariance matrix type modeling the CovarianceMatrixConcept.
+ * \tparam MeasurementCovar A covariance matrix type modeling the CovarianceMatrixConcept.
+ */
+template <typename System,
+          typename BeliefState = gaussian_belief_state< typename discrete_sss_traits<System>::point_type, cholesky_covariance_matrix< typename discrete_sss_traits<System>::point_type > >,
+          typename SystemNoiseCovar = cholesky_covariance_matrix< typename discrete_sss_traits< System >::input_type >,
+          typename MeasurementCovar = cholesky_covariance_matrix< typename discrete_sss_traits< System >::output_type > >
+struct SRUKF_belief_transfer {
+  typedef SRUKF_belief_transfer<System, BeliefState, SystemNoiseCovar, MeasurementCovar> self;
+  typedef BeliefState belief_state;
+  typedef System state_space_system;
+  typedef shared_ptr< state_space_system > state_space_system_ptr;
+  typedef typename discrete_sss_traits< state_space_system >::time_type time_type;
+  typedef typename discrete_sss_traits< state_space_system >::time_difference_type time_difference_type;
+
+  typedef typename belief_state_traits< belief_state >::state_type state_type;
+  typedef typename belief_state_traits< belief_state >::scalar_type scalar_type;
+  typedef typename continuous_belief_state_traits<BeliefState>::covariance_type covariance_type;
+  typedef typename covariance_mat_traits< covariance_type >::matrix_type matrix_type;
+
+  typedef typename discrete_sss_traits< state_space_system >::input_type input_type;
+  typedef typename discrete_sss_traits< state_space_system >::output_type output_type;
+  
+  typedef gaussian_belief_state<input_type, SystemNoiseCovar> input_belief_type;
+  typedef gaussian_belief_state<output_type, MeasurementCovar> output_belief_type;
+  
+  BOOST_CONCEPT_ASSERT((ContinuousBeliefStateConcept<BeliefState>));
+  BOOST_CONCEPT_ASSERT((CovarianceMatrixConcept<SystemNoiseCovar, input_type>));
+  BOOST_CONCEPT_ASSERT((CovarianceMatrixConcept<MeasurementCovar, output_type>));
+
+  state_space_system_ptr sys; ///< Holds the reference to the system used for the filter.
+  SystemNoiseCovar Q; ///< Holds the system's input noise covariance matrix.
+  MeasurementCovar R; ///< Holds the system's output measurement's covariance matrix.
+  scalar_type alpha; ///< Holds the spread parameter of the sigma-points.
+  scalar_type kappa; ///< Holds the secondary scaling parameter of the sigma-points.
+  scalar_type beta; ///< Holds the prior-knowledge parameter of the distribution.
+
+  /**
+   * Parametrized constructor.
+   * \param aSys The reference to the system used for the filter.
+   * \param aQ The system's input noise covariance matrix.
+   * \param aR The system's output measurement's covariance matrix.
+   * \param aAlpha The spread parameter of the sigma-points.
+   * \param aKappa The secondary scaling parameter of the sigma-points.
+   * \param aBeta The prior-knowledge parameter of the distribution (2 is optimal for gaussian distributions).
+   */
+  SRUKF_belief_transfer(const state_space_system_ptr& aSys, 
+                        const SystemNoiseCovar& aQ,
+                        const MeasurementCovar& aR,
+                        scalar_type aAlpha = 1E-3,
+                        scalar_type aKappa = 1,
+                        scalar_type aBeta = 2) : sys(aSys), Q(aQ), R(aR), alpha(aAlpha), kappa(aKappa), beta(aBeta) { };
+  
+  /**
+   * Returns the time-step of the predictor.
+   * \return The time-step of the predictor.
+   */
+  time_difference_type get_time_step() const { return sys->get_time_step(); };
+
+  /**
+   * Returns a reference to the underlying state-space system.
+   * \return A reference to the underlying state-space system.
+   */
+  const state_space_system& get_ss_system() const { return *sys; };
+
+  /**
+   * Returns the belief-state at the next time instant.
+   * \tparam BeliefSpace The belief-space type on which to operate.
+   * \param b_space The belief-space on which the belief-states lie.
+   * \param b The current belief-state.
+   * \param t The current time.
+   * \param u The current input given to the system.
+   * \param y The output that was measured at the next time instant.
+   * \return the belief-state at the next time instant.
+   */
+  template <typename BeliefSpace>
+  belief_state get_next_belief(const BeliefSpace& b_space, belief_state b, const time_type& t, const input_type& u, const output_type& y) const {
+    sr_unscented_kalman_filter_step(*sys,b_space.get_state_topology(),b,input_belief_type(u,Q),output_belief_type(y,R),t,alpha,kappa,beta);
+    return b;
+  };
+  
+  /**
+   * Returns the prediction belief-state at the next time instant.
+   * \tparam BeliefSpace The belief-space type on which to operate.
+   * \param b_space The belief-space on which the belief-states lie.
+   * \param b The current belief-state.
+   * \param t The current time.
+   * \param u The current input given to the system.
+   * \return the belief-state at the next time instant, predicted by the filter.
+   */
+  template <typename BeliefSpace>
+  belief_state predict_belief(const BeliefSpace& b_space, belief_state b, const time_type& t, const input_type& u) const {
+    sr_unscented_kalman_predict(*sys,b_space.get_state_topology(),b,input_belief_type(u,Q),t,alpha,kappa,beta);
+    return b;
+  };
+  
+  /**
+   * Converts a prediction belief-state into an updated belief-state which assumes the most likely measurement.
+   * \tparam BeliefSpace The belief-space type on which to operate.
+   * \param b_space The belief-space on which the belief-states lie.
+   * \param b The current prediction's belief-state.
+   * \param t The current time.
+   * \param u The current input given to the system.
+   * \return the updated belief-state when assuming the most likely measurement.
+   */
+  template <typename BeliefSpace>
+  belief_state prediction_to_ML_belief(const BeliefSpace& b_space, belief_state b, const time_type& t, const input_type& u) const {
+    sr_unscented_kalman_update(*sys,b_space.get_state_topology(),b,input_belief_type(u,Q),output_belief_type(sys->get_output(b_space.get_state_topology(),b.get_mean_state(),u,t),R),t,alpha,kappa,beta);
+    return b;
+  };
+  
+  /**
+   * Returns the prediction belief-state at the next time instant, assuming the upcoming measurement to be the most likely one.
+   * \tparam BeliefSpace The belief-space type on which to operate.
+   * \param b_space The belief-space on which the belief-states lie.
+   * \param b The current belief-state.
+   * \param t The current time.
+   * \param u The current input given to the system.
+   * \return the belief-state at the next time instant, predicted by the filter.
+   */
+  template <typename BeliefSpace>
+  belief_state predict_ML_belief(const BeliefSpace& b_space, belief_state b, const time_type& t, const input_type& u) const {
+    sr_unscented_kalman_predict(*sys,b_space.get_state_topology(),b,input_belief_type(u,Q),t,alpha,kappa,beta);
+    sr_unscented_kalman_update(*sys,b_space.get_state_topology(),b,input_belief_type(u,Q),output_belief_type(sys->get_output(b_space.get_state_topology(),b.get_mean_state(),u,t + sys->get_time_step()),R),t + sys->get_time_step(),alpha,kappa,beta);
+    return b;
+  };
+  
+};
+
+
+
+
+
+
+};
+
+};
+
+#endif
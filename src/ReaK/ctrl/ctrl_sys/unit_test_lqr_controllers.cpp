@@ -0,0 +1,193 @@
+/*
+ *    Copyright 2013 Sven Mikael Persson
+ *
+ *    THIS SOFTWARE IS DISTRIBUTED UNDER THE TERMS OF THE GNU GENERAL PUBLIC LICENSE v3 (GPLv3).
+ *
+ *    This file is part of ReaK.
+ *
+ *    ReaK is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    (at your option) any later version.
+ *
+ *    ReaK is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with ReaK (as LICENSE in the root folder).
+ *    If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "base/defs.hpp"
+
+#include "lqr_controllers.hpp"
+#include "lti_ss_system.hpp"
+#include "lti_discrete_sys.hpp"
+#include "topologies/hyperbox_topology.hpp"
+#include "topologies/time_topology.hpp"
+#include "topologies/temporal_space.hpp"
+
+#include "base/thread_incl.hpp"
+
+#include <cmath>
+
+#define BOOST_TEST_DYN_LINK
+
+#define BOOST_TEST_MODULE lqr_controllers
+#include <boost/test/unit_test.hpp>
+
+
+namespace {
+
+using namespace ReaK;
+
+typedef pp::hyperbox_topology< vect_n<double> > space_type;
+typedef pp::temporal_space< space_type, pp::time_topology > temporal_space_type;
+typedef pp::topology_traits< temporal_space_type >::point_type temporal_point_type;
+
+shared_ptr< space_type > make_space() {
+  return shared_ptr< space_type >(new space_type("state_space", vect_n<double>(2, -10.0), vect_n<double>(2, 10.0)));
+};
+
+/* A trajectory that stays at one point, for all times. */
+class constant_trajectory : public named_object {
+  public:
+    typedef constant_trajectory self;
+    typedef temporal_space_type topology;
+    typedef temporal_point_type point_type;
+    typedef pp::topology_traits< temporal_space_type >::point_difference_type point_difference_type;
+    typedef pp::metric_space_traits< temporal_space_type >::distance_metric_type distance_metric;
+    typedef int waypoint_descriptor;
+    typedef int const_waypoint_descriptor;
+
+    temporal_space_type m_space;
+    vect_n<double> m_pt;
+
+    explicit constant_trajectory(const vect_n<double>& aPt = vect_n<double>()) : 
+                                 m_space("temporal_space", *make_space()), m_pt(aPt) { };
+
+    point_type get_point_at_time(double t) const { return point_type(t, m_pt); };
+    point_type move_time_diff_from(const point_type& a, double dt) const { return get_point_at_time(a.time + dt); };
+    double travel_distance(const point_type&, const point_type&) const { return 0.0; };
+    std::pair< int, point_type > get_waypoint_at_time(double t) const { return std::make_pair(0, get_point_at_time(t)); };
+    std::pair< int, point_type > move_time_diff_from(const std::pair< int, point_type >& a, double dt) const {
+      return std::make_pair(0, move_time_diff_from(a.second, dt));
+    };
+    double travel_distance(const std::pair< int, point_type >&, const std::pair< int, point_type >&) const { return 0.0; };
+    double get_start_time() const { return 0.0; };
+    double get_end_time() const { return std::numeric_limits<double>::infinity(); };
+    const topology& get_temporal_space() const { return m_space; };
+    
+    virtual void RK_CALL save(serialization::oarchive& A, unsigned int) const {
+      named_object::save(A,named_object::getStaticObjectType()->TypeVersion());
+      A & RK_SERIAL_SAVE_WITH_NAME(m_pt);
+    };
+    virtual void RK_CALL load(serialization::iarchive& A, unsigned int) {
+      named_object::load(A,named_object::getStaticObjectType()->TypeVersion());
+      A & RK_SERIAL_LOAD_WITH_NAME(m_pt);
+    };
+    
+    RK_RTTI_MAKE_CONCRETE_1BASE(self,0xC2FFFF01,1,"constant_trajectory",named_object)
+};
+
+typedef ctrl::ct_ih_lqr_controller< ctrl::lti_system_ss<double>, space_type, constant_trajectory > ct_lqr_type;
+typedef ctrl::dt_ih_lqr_controller< ctrl::lti_discrete_sys<double>, space_type, constant_trajectory > dt_lqr_type;
+
+/* Calls get_output on a shared controller, many times, and records whether any output differed from the expected one. */
+template <typename Controller>
+struct lqr_output_worker {
+  const Controller* p_ctrl;
+  vect_n<double> x;
+  vect_n<double> expected;
+  bool* failed;
+
+  void operator()() const {
+    for(std::size_t i = 0; i < 50; ++i)
+      if(norm_2(p_ctrl->get_output(x) - expected) > 1e-6)
+        *failed = true;
+  };
+};
+
+};
+
+
+BOOST_AUTO_TEST_CASE( ct_ih_lqr_tests )
+{
+  // double integrator, with Q = I and R = 1, whose LQR gain is K = [1, sqrt(3)].
+  mat<double,mat_structure::square> A(2);
+  A(0,1) = 1.0;
+  mat<double,mat_structure::rectangular> B(2,1);
+  B(1,0) = 1.0;
+  mat<double,mat_structure::rectangular> C(2,2,true);
+  mat<double,mat_structure::rectangular> D(2,1);
+  shared_ptr< ctrl::lti_system_ss<double> > sys(new ctrl::lti_system_ss<double>(A, B, C, D, "double_integrator"));
+
+  ct_lqr_type lqr("ct_lqr",
+                  mat<double,mat_structure::square>(mat<double,mat_structure::identity>(2)),
+                  mat<double,mat_structure::square>(mat<double,mat_structure::identity>(1)),
+                  sys, make_space(),
+                  shared_ptr< constant_trajectory >(new constant_trajectory(vect_n<double>(2, 0.0))));
+  BOOST_CHECK_EQUAL( lqr.get_input_count(), 2 );
+  BOOST_CHECK_EQUAL( lqr.get_output_count(), 1 );
+
+  vect_n<double> x(vect<double,2>(1.0, -0.5));
+  vect_n<double> u = lqr.get_output(x);
+  BOOST_REQUIRE_EQUAL( u.size(), 1 );
+  BOOST_CHECK_CLOSE( u[0], -(1.0 * x[0] + std::sqrt(3.0) * x[1]), 1e-4 );
+
+  // the workspace is re-used by later calls, and shared (under a lock) by concurrent calls.
+  bool failed = false;
+  lqr_output_worker< ct_lqr_type > w1 = { &lqr, x, u, &failed };
+  lqr_output_worker< ct_lqr_type > w2 = { &lqr, x, u, &failed };
+  ReaKaux::thread t1(w1);
+  ReaKaux::thread t2(w2);
+  t1.join();
+  t2.join();
+  BOOST_CHECK( !failed );
+};
+
+
+BOOST_AUTO_TEST_CASE( dt_ih_lqr_tests )
+{
+  // discretized double integrator.
+  const double dt = 0.1;
+  mat<double,mat_structure::square> A(2,true);
+  A(0,1) = dt;
+  mat<double,mat_structure::rectangular> B(2,1);
+  B(0,0) = 0.5 * dt * dt;
+  B(1,0) = dt;
+  mat<double,mat_structure::rectangular> C(2,2,true);
+  mat<double,mat_structure::rectangular> D(2,1);
+  shared_ptr< ctrl::lti_discrete_sys<double> > sys(new ctrl::lti_discrete_sys<double>(A, B, C, D, dt));
+
+  mat<double,mat_structure::square> Q(mat<double,mat_structure::identity>(2));
+  mat<double,mat_structure::square> R(mat<double,mat_structure::identity>(1));
+  dt_lqr_type lqr("dt_lqr", Q, R, sys, make_space(),
+                  shared_ptr< constant_trajectory >(new constant_trajectory(vect_n<double>(2, 0.0))));
+
+  // reference gain, from a separate solver.
+  mat<double,mat_structure::rectangular> K(1,2);
+  mat<double,mat_structure::square> P(2);
+  dare_solver<double> ref_solver(2, 1, 1e-4);
+  ref_solver.solve_LQR(A, B, Q, R, K, P);
+
+  vect_n<double> x(vect<double,2>(1.0, -0.5));
+  vect_n<double> u = lqr.get_output(x);
+  BOOST_REQUIRE_EQUAL( u.size(), 1 );
+  BOOST_CHECK_CLOSE( u[0], -(K(0,0) * x[0] + K(0,1) * x[1]), 1e-6 );
+  // a stabilizing gain for a double integrator pushes back on both the position and the velocity.
+  BOOST_CHECK( K(0,0) > 0.0 );
+  BOOST_CHECK( K(0,1) > 0.0 );
+
+  bool failed = false;
+  lqr_output_worker< dt_lqr_type > w1 = { &lqr, x, u, &failed };
+  lqr_output_worker< dt_lqr_type > w2 = { &lqr, x, u, &failed };
+  ReaKaux::thread t1(w1);
+  ReaKaux::thread t2(w2);
+  t1.join();
+  t2.join();
+  BOOST_CHECK( !failed );
+};
+
@@ -0,0 +1,159 @@
+/*
+ *    Copyright 2013 Sven Mikael Persson
+ *
+ *    THIS SOFTWARE IS DISTRIBUTED UNDER THE TERMS OF THE GNU GENERAL PUBLIC LICENSE v3 (GPLv3).
+ *
+ *    This file is part of ReaK.
+ *
+ *    ReaK is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    (at your option) any later version.
+ *
+ *    ReaK is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with ReaK (as LICENSE in the root folder).
+ *    If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "base/defs.hpp"
+
+#include "kalman_filter.hpp"
+#include "square_root_kalman_filter.hpp"
+#include "square_root_unscented_kalman_filter.hpp"
+#include "lti_discrete_sys.hpp"
+#include "gaussian_belief_state.hpp"
+#include "covariance_matrix.hpp"
+#include "cholesky_covariance_matrix.hpp"
+#include "topologies/vector_topology.hpp"
+
+#include <cmath>
+
+#define BOOST_TEST_DYN_LINK
+
+#define BOOST_TEST_MODULE sr_filters
+#include <boost/test/unit_test.hpp>
+
+
+namespace {
+
+using namespace ReaK;
+
+typedef pp::vector_topology< vect_n<double> > space_type;
+typedef ctrl::covariance_matrix< vect_n<double> > cov_type;
+typedef ctrl::cholesky_covariance_matrix< vect_n<double> > chol_cov_type;
+typedef ctrl::gaussian_belief_state< vect_n<double>, cov_type > belief_type;
+typedef ctrl::gaussian_belief_state< vect_n<double>, chol_cov_type > chol_belief_type;
+
+// a discrete-time, damped, position-velocity-acceleration chain, with position and velocity measurements.
+ctrl::lti_discrete_sys<double> make_system() {
+  mat<double,mat_structure::square> A(3,true);
+  A(0,1) = 0.1; A(1,2) = 0.1; A(2,2) = 0.9;
+  mat<double,mat_structure::rectangular> B(3,1);
+  B(2,0) = 0.1;
+  mat<double,mat_structure::rectangular> C(2,3);
+  C(0,0) = 1.0; C(1,1) = 1.0;
+  mat<double,mat_structure::rectangular> D(2,1);
+  return ctrl::lti_discrete_sys<double>(A, B, C, D, 0.1);
+};
+
+void check_same_belief(const belief_type& b, const chol_belief_type& b_sr) {
+  mat<double,mat_structure::symmetric> P = b.get_covariance().get_matrix();
+  mat<double,mat_structure::symmetric> P_sr = b_sr.get_covariance().get_matrix();
+  for(std::size_t i = 0; i < 3; ++i) {
+    BOOST_CHECK_SMALL( b.get_mean_state()[i] - b_sr.get_mean_state()[i], 1e-8 );
+    for(std::size_t j = 0; j < 3; ++j)
+      BOOST_CHECK_SMALL( P(i,j) - P_sr(i,j), 1e-8 * (1.0 + std::fabs(P(i,j))) );
+  };
+};
+
+};
+
+
+BOOST_AUTO_TEST_CASE( cholesky_covariance_tests )
+{
+  chol_cov_type no_info(3, ctrl::covariance_initial_level::no_info);
+  mat<double,mat_structure::symmetric> P = no_info.get_matrix();
+  for(std::size_t i = 0; i < 3; ++i) {
+    BOOST_CHECK( P(i,i) > 1e12 );
+    BOOST_CHECK( P(i,i) < std::numeric_limits<double>::infinity() );
+    for(std::size_t j = 0; j < 3; ++j)
+      BOOST_CHECK( P(i,j) == P(i,j) ); // not NaN.
+  };
+  
+  chol_cov_type full_info(3, ctrl::covariance_initial_level::full_info);
+  BOOST_CHECK_EQUAL( full_info.get_matrix()(1,1), 0.0 );
+};
+
+
+BOOST_AUTO_TEST_CASE( sr_kf_vs_kf_tests )
+{
+  ctrl::lti_discrete_sys<double> sys = make_system();
+  space_type space;
+  
+  belief_type b(vect_n<double>(0.0, 0.0, 0.0), cov_type(cov_type::matrix_type(mat<double,mat_structure::diagonal>(3, 10.0))));
+  chol_belief_type b_sr(vect_n<double>(0.0, 0.0, 0.0), chol_cov_type(chol_cov_type::matrix_block_type(mat<double,mat_structure::diagonal>(3, std::sqrt(10.0)))));
+  belief_type b_u(vect_n<double>(std::size_t(1), 1.0), cov_type(cov_type::matrix_type(mat<double,mat_structure::diagonal>(1, 0.1))));
+  
+  for(std::size_t k = 0; k < 20; ++k) {
+    belief_type b_z(vect_n<double>(vect<double,2>(0.01 * k * k, 0.02 * k)), cov_type(cov_type::matrix_type(mat<double,mat_structure::diagonal>(2, 0.01))));
+    ctrl::kalman_filter_step(sys, space, b, b_u, b_z, 0.1 * k);
+    ctrl::sr_kalman_filter_step(sys, space, b_sr, b_u, b_z, 0.1 * k);
+    check_same_belief(b, b_sr);
+  };
+};
+
+
+BOOST_AUTO_TEST_CASE( sr_ukf_vs_kf_tests )
+{
+  // on a linear system, the unscented transform of the augmented state is exact, i.e., the UKF 
+  // gives the KF estimates (the UKF of unscented_kalman_filter.hpp ignores the input noise, so 
+  // the KF is the reference here).
+  ctrl::lti_discrete_sys<double> sys = make_system();
+  space_type space;
+  
+  belief_type b(vect_n<double>(0.0, 0.0, 0.0), cov_type(cov_type::matrix_type(mat<double,mat_structure::diagonal>(3, 10.0))));
+  chol_belief_type b_sr(vect_n<double>(0.0, 0.0, 0.0), chol_cov_type(chol_cov_type::matrix_block_type(mat<double,mat_structure::diagonal>(3, std::sqrt(10.0)))));
+  belief_type b_u(vect_n<double>(std::size_t(1), 1.0), cov_type(cov_type::matrix_type(mat<double,mat_structure::diagonal>(1, 0.1))));
+  
+  for(std::size_t k = 0; k < 20; ++k) {
+    belief_type b_z(vect_n<double>(vect<double,2>(0.01 * k * k, 0.02 * k)), cov_type(cov_type::matrix_type(mat<double,mat_structure::diagonal>(2, 0.01))));
+    ctrl::kalman_filter_step(sys, space, b, b_u, b_z, 0.1 * k);
+    ctrl::sr_unscented_kalman_filter_step(sys, space, b_sr, b_u, b_z, 0.1 * k, 1.0, 0.0, 2.0);
+    check_same_belief(b, b_sr);
+  };
+};
+
+
+BOOST_AUTO_TEST_CASE( sr_filters_no_measurement_tests )
+{
+  // a system without inputs nor outputs.
+  mat<double,mat_structure::square> A(3,true);
+  A(0,1) = 0.1; A(1,2) = 0.1;
+  ctrl::lti_discrete_sys<double> sys(A, mat<double,mat_structure::rectangular>(3,0), 
+                                     mat<double,mat_structure::rectangular>(0,3), 
+                                     mat<double,mat_structure::rectangular>(0,0), 0.1);
+  space_type space;
+  
+  chol_belief_type b_sr(vect_n<double>(1.0, 2.0, 3.0), chol_cov_type(chol_cov_type::matrix_block_type(mat<double,mat_structure::diagonal>(3, 1.0))));
+  belief_type b_u(vect_n<double>(), cov_type(cov_type::matrix_type(mat<double,mat_structure::diagonal>(0, 0.0))));
+  belief_type b_z(vect_n<double>(), cov_type(cov_type::matrix_type(mat<double,mat_structure::diagonal>(0, 0.0))));
+  
+  chol_belief_type b_before = b_sr;
+  ctrl::sr_kalman_update(sys, space, b_sr, b_u, b_z, 0.0);
+  ctrl::sr_unscented_kalman_update(sys, space, b_sr, b_u, b_z, 0.0);
+  for(std::size_t i = 0; i < 3; ++i) {
+    BOOST_CHECK_EQUAL( b_sr.get_mean_state()[i], b_before.get_mean_state()[i] );
+    BOOST_CHECK_EQUAL( b_sr.get_covariance().get_factor()(i,i), 1.0 );
+  };
+  
+  ctrl::sr_kalman_predict(sys, space, b_sr, b_u, 0.0);
+  BOOST_CHECK_CLOSE( b_sr.get_mean_state()[0], 1.2, 1e-9 );
+  BOOST_CHECK_CLOSE( b_sr.get_covariance().get_matrix()(0,0), 1.01, 1e-9 );
+};
+
+
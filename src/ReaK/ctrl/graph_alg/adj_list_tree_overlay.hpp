@@ -710,8 +710,8 @@ class alt_graph_view {
     degree_size_type in_degree_impl(vertex_descriptor v) const {
       return in_degree(v, m_alt->m_adj_list);
     };
-    degree_size_type degree_impl(edge_descriptor e) const {
-      return degree(e, m_alt->m_adj_list);
+    degree_size_type degree_impl(vertex_descriptor v) const {
+      return degree(v, m_alt->m_adj_list);
     };
 
     // AdjacencyGraph concept
@@ -1019,9 +1019,9 @@ typename boost::graph_traits< alt_tree_view<AdjListOnTreeType> >::degree_size_ty
 
 template <typename AdjListOnTreeType>
 typename boost::graph_traits< alt_tree_view<AdjListOnTreeType> >::degree_size_type
-  degree(typename boost::graph_traits< alt_tree_view<AdjListOnTreeType> >::edge_descriptor e,
+  degree(typename boost::graph_traits< alt_tree_view<AdjListOnTreeType> >::vertex_descriptor v,
 	 const alt_tree_view<AdjListOnTreeType>& g) {
-  return degree(e, g.get_tree());
+  return degree(v, g.get_tree());
 };
 
 
@@ -1281,9 +1281,9 @@ typename boost::graph_traits< alt_graph_view<AdjListOnTreeType> >::degree_size_t
 
 template <typename AdjListOnTreeType>
 typename boost::graph_traits< alt_graph_view<AdjListOnTreeType> >::degree_size_type
-  degree(typename boost::graph_traits< alt_graph_view<AdjListOnTreeType> >::edge_descriptor e,
+  degree(typename boost::graph_traits< alt_graph_view<AdjListOnTreeType> >::vertex_descriptor v,
 	 const alt_graph_view<AdjListOnTreeType>& g) {
-  return g.degree_impl(e);
+  return g.degree_impl(v);
 };
 
 
@@ -546,6 +546,102 @@ namespace graph {
       std::less<double>(), std::equal_to<double>(), std::plus<double>(), std::multiplies<double>());
     
   };
+  
+  
+  /**
+   * This function template repairs the FADPRM search on a roadmap that was previously generated 
+   * by generate_fadprm (for the same goal location), after the weights of some of its edges were 
+   * changed (e.g., edges invalidated by moving obstacles) or some vertices were added (e.g., a new 
+   * start location). The distance and rhs values of the previous search are kept, the inconsistent 
+   * vertices of the previous search and the given affected vertices are put back in the OPEN set, 
+   * and the AD* loop then only propagates the changes from these vertices (as in D* Lite), expanding 
+   * the roadmap as it goes.
+   * \tparam Graph The graph type that can store the generated roadmap, should model 
+   *         BidirectionalGraphConcept and MutableGraphConcept.
+   * \tparam VertexIter A forward-iterator type over vertices of the graph.
+   * 
+   * \param g The roadmap, as left by a previous FADPRM search.
+   * \param start_vertex The starting point of the algorithm, on the graph (same as for the previous search).
+   * \param affected_first The start of the range of vertices affected by the changes in the roadmap, 
+   *        i.e., the end-points of edges whose weights changed, and the vertices that were added.
+   * \param affected_last The end of the range of affected vertices.
+   * 
+   * See generate_fadprm for the documentation of the other template and function parameters.
+   */
+  template <typename Graph,
+            typename Vertex,
+	    typename Topology,
+            typename AStarHeuristicMap,
+            typename FADPRMVisitor,
+	    typename PredecessorMap,
+            typename DistanceMap,
+	    typename RHSMap,
+	    typename KeyMap,
+            typename WeightMap,
+            typename PositionMap,
+            typename DensityMap,
+	    typename NcSelector,
+	    typename ColorMap,
+	    typename VertexIter>
+  inline void
+  repair_fadprm
+    (Graph &g, Vertex start_vertex, const Topology& free_space,
+     AStarHeuristicMap hval, FADPRMVisitor vis,
+     PredecessorMap predecessor, DistanceMap distance,
+     RHSMap rhs, KeyMap key, WeightMap weight, DensityMap density, PositionMap position, 
+     NcSelector select_neighborhood, ColorMap color, double epsilon, 
+     VertexIter affected_first, VertexIter affected_last)
+  {
+    typedef typename boost::property_traits<KeyMap>::value_type KeyValue;
+    typedef typename adstar_key_traits<KeyValue>::compare_type KeyCompareType;
+    typedef typename boost::property_traits<ColorMap>::value_type ColorValue;
+    typedef boost::color_traits<ColorValue> Color;
+    typedef boost::vector_property_map<std::size_t> IndexInHeapMap;
+    IndexInHeapMap index_in_heap;
+    {
+      typename boost::graph_traits<Graph>::vertex_iterator ui, ui_end;
+      for (boost::tie(ui, ui_end) = vertices(g); ui != ui_end; ++ui) {
+        put(index_in_heap,*ui, static_cast<std::size_t>(-1)); 
+      };
+    };
+    
+    typedef boost::d_ary_heap_indirect<Vertex, 4, IndexInHeapMap, KeyMap, KeyCompareType> MutableQueue;
+    MutableQueue Q(key, index_in_heap, KeyCompareType()); //priority queue holding the OPEN set.
+    std::vector<Vertex> I; //list holding the INCONS set (inconsistent nodes).
+    
+    detail::fadprm_bfs_visitor<Topology, AStarHeuristicMap, FADPRMVisitor,
+        MutableQueue, std::vector<Vertex>,
+        IndexInHeapMap, PredecessorMap, KeyMap, DistanceMap, RHSMap,
+        WeightMap, DensityMap, PositionMap, NcSelector, ColorMap>
+      bfs_vis(free_space, hval, vis, Q, I, index_in_heap, predecessor, key, distance, 
+              rhs, weight, density, position, select_neighborhood, color, epsilon);
+    
+    // the OPEN and INCONS sets of the previous search are gone, so every visited vertex is recycled 
+    // (not CLOSED, not OPEN) and the inconsistent ones are put back in the OPEN set.
+    {
+      typename boost::graph_traits<Graph>::vertex_iterator ui, ui_end;
+      for (boost::tie(ui, ui_end) = vertices(g); ui != ui_end; ++ui) {
+        if((*ui == start_vertex) || (get(color, *ui) == Color::white()))
+          continue;
+        put(color, *ui, Color::green());
+        if(get(distance, *ui) != get(rhs, *ui)) {
+          bfs_vis.update_key(*ui, g);
+          Q.push(*ui);
+          put(color, *ui, Color::gray());
+        };
+      };
+    };
+    
+    for(; affected_first != affected_last; ++affected_first)
+      if(*affected_first != start_vertex)
+        bfs_vis.update_vertex(*affected_first, g);
+    
+    detail::adstar_search_loop(
+      g, start_vertex, hval, bfs_vis, predecessor, distance, rhs, key, weight, color, 
+      index_in_heap, Q, I, epsilon, std::numeric_limits<double>::infinity(), 0.0, 
+      std::less<double>(), std::equal_to<double>(), std::plus<double>(), std::multiplies<double>());
+    
+  };
 
 
    /**
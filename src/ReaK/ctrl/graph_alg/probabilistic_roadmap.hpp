@@ -52,9 +52,11 @@
 #include <boost/graph/graph_concepts.hpp>
 #include <boost/graph/detail/d_ary_heap.hpp>
 #include <boost/property_map/property_map.hpp>
+#include <boost/random/uniform_01.hpp>
 
 #include "path_planning/metric_space_concept.hpp"
 #include "path_planning/random_sampler_concept.hpp"
+#include "path_planning/global_rng.hpp"
 
 #include "bgl_more_property_maps.hpp"
 
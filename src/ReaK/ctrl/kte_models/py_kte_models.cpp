@@ -44,6 +44,7 @@
 #include <boost/python/suite/indexing/vector_indexing_suite.hpp>
 
 #include "base/py_fixes.hpp"
+#include "base/py_array_interface.hpp"
 
 #include <sstream>
 
@@ -66,6 +67,83 @@ ReaK::vect_n<double> py_dyn_mdl_compute_state_rate(ReaK::kte::manipulator_dynami
   return aStateRate;
 };
 
+/*
+ * The batch functions below run many passes of a model over the rows of arrays (e.g., NumPy arrays,
+ * one row per pass), and return the results as a matrix (one row per pass) which can be viewed as a
+ * NumPy array without copying. The GIL is released during the passes, so the model must not be used
+ * by other Python threads meanwhile.
+ */
+
+ReaK::mat<double, ReaK::mat_structure::rectangular> py_kin_mdl_batch_direct_motion(ReaK::kte::direct_kinematics_model& aMdl, 
+                                                                                   const boost::python::object& aJointPositions) {
+  py_double_array_view positions(aJointPositions);
+  ReaK::mat<double, ReaK::mat_structure::rectangular> result(positions.get_row_count(), aMdl.getDependentPositionsCount());
+  {
+    py_release_gil no_gil_here;
+    ReaK::vect_n<double> q(positions.get_col_count());
+    for(std::size_t i = 0; i < positions.get_row_count(); ++i) {
+      for(std::size_t j = 0; j < q.size(); ++j)
+        q[j] = positions(i,j);
+      aMdl.setJointPositions(q);
+      aMdl.doDirectMotion();
+      ReaK::vect_n<double> dep_q = aMdl.getDependentPositions();
+      for(std::size_t j = 0; (j < dep_q.size()) && (j < result.get_col_count()); ++j)
+        result(i,j) = dep_q[j];
+    };
+  };
+  return result;
+};
+
+typedef void (RK_CALL ReaK::kte::manipulator_dynamics_model::*py_dyn_mdl_compute_fn)(double, const ReaK::vect_n<double>&, ReaK::vect_n<double>&);
+
+ReaK::mat<double, ReaK::mat_structure::rectangular> py_dyn_mdl_batch_compute(ReaK::kte::manipulator_dynamics_model& aMdl, 
+                                                                             py_dyn_mdl_compute_fn aFunc,
+                                                                             const boost::python::object& aTimes, 
+                                                                             const boost::python::object& aStates) {
+  py_double_array_view times(aTimes);
+  py_double_array_view states(aStates);
+  if(times.get_row_count() != states.get_row_count()) {
+    PyErr_SetString(PyExc_ValueError, "The times and states arrays must have the same number of rows.");
+    boost::python::throw_error_already_set();
+  };
+  std::vector<double> values;
+  std::size_t col_count = 0;
+  {
+    py_release_gil no_gil_here;
+    ReaK::vect_n<double> x(states.get_col_count());
+    ReaK::vect_n<double> y;
+    for(std::size_t i = 0; i < states.get_row_count(); ++i) {
+      for(std::size_t j = 0; j < x.size(); ++j)
+        x[j] = states(i,j);
+      (aMdl.*aFunc)(times(i), x, y);
+      if(i == 0) {
+        col_count = y.size();
+        values.reserve(states.get_row_count() * col_count);
+      };
+      for(std::size_t j = 0; j < col_count; ++j)
+        values.push_back((j < y.size() ? y[j] : 0.0));
+    };
+  };
+  ReaK::mat<double, ReaK::mat_structure::rectangular> result(states.get_row_count(), col_count);
+  std::vector<double>::const_iterator it = values.begin();
+  for(std::size_t i = 0; i < result.get_row_count(); ++i)
+    for(std::size_t j = 0; j < col_count; ++j, ++it)
+      result(i,j) = *it;
+  return result;
+};
+
+ReaK::mat<double, ReaK::mat_structure::rectangular> py_dyn_mdl_batch_compute_output(ReaK::kte::manipulator_dynamics_model& aMdl, 
+                                                                                    const boost::python::object& aTimes, 
+                                                                                    const boost::python::object& aStates) {
+  return py_dyn_mdl_batch_compute(aMdl, &ReaK::kte::manipulator_dynamics_model::computeOutput, aTimes, aStates);
+};
+
+ReaK::mat<double, ReaK::mat_structure::rectangular> py_dyn_mdl_batch_compute_state_rate(ReaK::kte::manipulator_dynamics_model& aMdl, 
+                                                                                        const boost::python::object& aTimes, 
+                                                                                        const boost::python::object& aStates) {
+  return py_dyn_mdl_batch_compute(aMdl, &ReaK::kte::manipulator_dynamics_model::computeStateRate, aTimes, aStates);
+};
+
 
 void export_kte_models() {
 
@@ -96,7 +174,8 @@ void export_kte_models() {
     .def("dependent_frame_2D", &ReaK::kte::direct_kinematics_model::getDependentFrame2D)
     .def("dependent_frames_3D_count", &ReaK::kte::direct_kinematics_model::getDependentFrames3DCount)
     .def("dependent_frame_3D", &ReaK::kte::direct_kinematics_model::getDependentFrame3D)
-    .def("do_direct_motion", &ReaK::kte::direct_kinematics_model::doDirectMotion);
+    .def("do_direct_motion", &ReaK::kte::direct_kinematics_model::doDirectMotion)
+    .def("batch_direct_motion", &py_kin_mdl_batch_direct_motion);
     
   class_< ReaK::kte::inverse_kinematics_model,
           boost::noncopyable,
@@ -154,7 +233,9 @@ void export_kte_models() {
     .add_property("dependent_states", &ReaK::kte::manipulator_dynamics_model::getDependentStates)
     .def("mass_calculator", &ReaK::kte::manipulator_dynamics_model::getMassCalc, return_internal_reference<>())
     .def("compute_output", &py_dyn_mdl_compute_output)
-    .def("compute_state_rate", &py_dyn_mdl_compute_state_rate);
+    .def("compute_state_rate", &py_dyn_mdl_compute_state_rate)
+    .def("batch_compute_output", &py_dyn_mdl_batch_compute_output)
+    .def("batch_compute_state_rate", &py_dyn_mdl_batch_compute_state_rate);
     
   
 #ifdef RK_ENABLE_CXX0X_FEATURES
@@ -111,12 +111,33 @@ template <typename FreeSpaceType>
 struct fadprm_edge_data { 
   /// The travel-distance associated to the edge (from source to target).
   double astar_weight; //for A*
+  /// The clearance of the motion along the edge, less the obstacle displacements since it was computed (for incremental replanning).
+  double clearance;
   
   /**
    * Default constructor.
    * \param aWeight The travel-distance to be associated to this edge.
    */
-  fadprm_edge_data(double aWeight = 0.0) : astar_weight(aWeight) { };
+  fadprm_edge_data(double aWeight = 0.0) : astar_weight(aWeight), clearance(0.0) { };
+};
+
+
+/**
+ * This function returns the clearance of the motion from p1 to p2 in a free-space, i.e., how far 
+ * the obstacles can move without intersecting the volume swept along that motion. This default 
+ * version knows no clearance, it only checks the motion (through the free-space's distance metric), 
+ * and free-spaces that can compute the clearance (from their proximity models) provide an overload.
+ * \param space The free-space in which the motion is done.
+ * \param p1 The start point of the motion.
+ * \param p2 The end point of the motion.
+ * \return The clearance of the motion, negative if the motion is not collision-free.
+ */
+template <typename FreeSpaceType, typename PointType>
+double get_motion_clearance(const FreeSpaceType& space, const PointType& p1, const PointType& p2) {
+  if(get(distance_metric, space)(p1, p2, space) < std::numeric_limits<double>::infinity())
+    return 0.0;
+  else
+    return -1.0;
 };
 
 
@@ -194,6 +215,30 @@ class fadprm_path_planner : public sample_based_planner< path_planner_base<FreeS
     
     std::map<double, shared_ptr< seq_path_base< super_space_type > > > m_solutions;
     
+    typedef boost::adjacency_list< 
+      boost::vecS, boost::vecS, boost::undirectedS,
+      fadprm_vertex_data<FreeSpaceType>,
+      fadprm_edge_data<FreeSpaceType>, boost::listS> roadmap_type;
+    typedef typename boost::graph_traits<roadmap_type>::vertex_descriptor roadmap_vertex;
+    
+    bool m_incremental;
+    double m_obstacle_displacement;
+    shared_ptr< roadmap_type > m_roadmap;
+    roadmap_vertex m_roadmap_start;
+    roadmap_vertex m_roadmap_goal;
+    std::size_t m_last_vertex_count;
+    double m_last_best_distance;
+    std::pair<double, double> m_last_start_values;
+    bool m_search_stalled;
+    
+    template <typename MotionGraph, typename Visitor, typename PositionMap, typename NcSelector>
+    roadmap_vertex add_roadmap_vertex(const point_type& aPos, MotionGraph& g, Visitor& vis, 
+                                      PositionMap pos_map, NcSelector select_neighborhood, 
+                                      std::vector< roadmap_vertex >& aAffected);
+    
+    template <typename MotionGraph, typename Visitor, typename PositionMap, typename NcSelector>
+    void repair_roadmap_search(MotionGraph& g, Visitor& vis, PositionMap pos_map, NcSelector select_neighborhood);
+    
   public:
     
     /**
@@ -213,7 +258,7 @@ class fadprm_path_planner : public sample_based_planner< path_planner_base<FreeS
      * \return True if the solver should keep on going trying to solve the path-planning problem.
      */
     bool keep_going() const {
-      return (max_num_results > m_solutions.size()) && !has_reached_max_vertices;
+      return (max_num_results > m_solutions.size()) && !has_reached_max_vertices && !m_search_stalled;
     };
     
     template <typename EdgeIter, typename Graph>
@@ -263,7 +308,8 @@ class fadprm_path_planner : public sample_based_planner< path_planner_base<FreeS
     template <typename Vertex, typename Graph>
     void create_solution_path(Vertex start_node, Vertex goal_node, Graph& g) {
       
-      double goal_distance = g[goal_node].distance_accum;
+      // the search is rooted at the goal, so the predecessors lead from the start to the goal.
+      double goal_distance = g[start_node].distance_accum;
       
       if(goal_distance < std::numeric_limits<double>::infinity()) {
         //Draw the edges of the current best solution:
@@ -273,27 +319,30 @@ class fadprm_path_planner : public sample_based_planner< path_planner_base<FreeS
         point_to_point_path<super_space_type>& waypoints = new_sol->get_underlying_path();
         std::set<Vertex> path;
         
-        Vertex v = goal_node;
-        point_type p_v = this->m_goal_pos;
-        Vertex u = g[v].predecessor;
-        point_type p_u = g[u].position;
-        
-        waypoints.push_front(m_goal_pos);
-        waypoints.push_front(p_u);
-        path.insert(v);
-      
-        while((u != start_node) && (path.insert(u).second)) {
-          v = u; p_v = p_u;
-          u = g[v].predecessor; 
-          p_u = g[u].position; 
-          waypoints.push_front(p_u);
+        Vertex u = start_node;
+        waypoints.push_back(g[u].position);
+      
+        while((u != goal_node) && (path.insert(u).second)) {
+          u = g[u].predecessor; 
+          waypoints.push_back(g[u].position);
         };
         
-        if(u == start_node) {
+        if(u == goal_node) {
           m_solutions[goal_distance] = new_sol;
           m_reporter.draw_solution(*(this->m_space), m_solutions[goal_distance]);
         };
       };
+      
+      // the roadmap might have nothing left to expand (all its vertices saturated, or a retained 
+      // roadmap), so the search stops as soon as one of its iterations neither grows the roadmap, 
+      // nor improves the solution, nor changes the start's values (i.e., the search has converged).
+      double best_distance = get_best_solution_distance();
+      std::pair<double, double> start_values(g[start_node].distance_accum, g[start_node].astar_rhs_value);
+      m_search_stalled = (num_vertices(g) == m_last_vertex_count) && (best_distance >= m_last_best_distance) 
+                         && (start_values == m_last_start_values);
+      m_last_vertex_count = num_vertices(g);
+      m_last_best_distance = best_distance;
+      m_last_start_values = start_values;
     };
     
     /**
@@ -365,6 +414,53 @@ class fadprm_path_planner : public sample_based_planner< path_planner_base<FreeS
      */
     void set_max_result_count(std::size_t aMaxResultCount) { max_num_results = aMaxResultCount; };
     
+    /**
+     * Returns true if this planner keeps its roadmap between calls to solve_path().
+     * \return True if this planner keeps its roadmap between calls to solve_path().
+     */
+    bool is_incremental_replanning() const { return m_incremental; };
+    /**
+     * Sets whether this planner keeps its roadmap between calls to solve_path(), i.e., the incremental 
+     * replanning mode. In this mode, each call to solve_path() after the first one repairs the previous 
+     * search instead of planning from scratch: the edges affected by the obstacle motions (see 
+     * notify_obstacle_motion()) are re-validated, a moved start position is connected to the roadmap, 
+     * and the AD* search is repaired from the affected vertices only (as in D* Lite). A moved goal 
+     * position (the root of the search) requires a new search, but over the retained roadmap. 
+     * \note This mode is only available with the ADJ_LIST_MOTION_GRAPH storage (the other storages 
+     *       always plan from scratch). The free-space should not cache the results of motion validations 
+     *       across obstacle motions (e.g., clear the edge-cache of a manipulator's environment).
+     * \param aIncremental True to keep the roadmap between calls to solve_path().
+     */
+    void set_incremental_replanning(bool aIncremental) { 
+      m_incremental = aIncremental; 
+      if(!m_incremental)
+        reset_roadmap();
+    };
+    
+    /**
+     * Notifies this planner that the obstacles have moved (by at most the given displacement, in the 
+     * units of the clearance of motions, see get_motion_clearance()) since the last call to solve_path().
+     * With incremental replanning, only the edges of the roadmap whose clearance (less the accumulated 
+     * displacements) is exhausted are re-validated, i.e., the edges whose swept volume could intersect 
+     * the moved obstacles. 
+     * \note The displacement is a single bound for all obstacles, so one fast obstacle causes the 
+     *       re-validation of the edges near any obstacle. Also, the re-validation is only as safe as 
+     *       the clearance reported by the free-space: if it is the minimum over samples of the motion 
+     *       (e.g., manip_quasi_static_env), it over-estimates the clearance of the swept volume by up 
+     *       to the workspace motion between samples, and the displacement should be padded accordingly.
+     * \param aMaxDisplacement The maximum displacement of any obstacle (infinity to re-validate all edges).
+     */
+    void notify_obstacle_motion(double aMaxDisplacement) { m_obstacle_displacement += aMaxDisplacement; };
+    
+    /**
+     * Discards the roadmap kept for incremental replanning, such that the next call to solve_path() 
+     * plans from scratch (e.g., after the free-space was changed completely).
+     */
+    void reset_roadmap() { 
+      m_roadmap.reset(); 
+      m_obstacle_displacement = 0.0;
+    };
+    
     
     /**
      * Parametrized constructor.
@@ -400,7 +496,16 @@ class fadprm_path_planner : public sample_based_planner< path_planner_base<FreeS
                         m_goal_pos(aGoalPos),
                         m_initial_relaxation( ( aInitialRelaxation > 1.0 ? 1.0 : aInitialRelaxation ) ),
                         max_num_results(aMaxResultCount),
-                        has_reached_max_vertices(false) { };
+                        has_reached_max_vertices(false),
+                        m_incremental(false),
+                        m_obstacle_displacement(0.0),
+                        m_roadmap(),
+                        m_roadmap_start(0),
+                        m_roadmap_goal(0),
+                        m_last_vertex_count(0),
+                        m_last_best_distance(std::numeric_limits<double>::infinity()),
+                        m_last_start_values(std::numeric_limits<double>::infinity(), std::numeric_limits<double>::infinity()),
+                        m_search_stalled(false) { };
     
     virtual ~fadprm_path_planner() { };
     
@@ -426,6 +531,7 @@ class fadprm_path_planner : public sample_based_planner< path_planner_base<FreeS
         & RK_SERIAL_LOAD_WITH_NAME(max_num_results);
       has_reached_max_vertices = false;
       m_solutions.clear();
+      reset_roadmap();
     };
 
     RK_RTTI_MAKE_CONCRETE_1BASE(self,0xC246000B,1,"fadprm_path_planner",base_type)
@@ -497,13 +603,25 @@ struct fadprm_planner_visitor {
     std::pair<PointType, bool> result = m_space->random_walk(g[u].position);
     if(result.second) {
       double dist = get(distance_metric, m_space->get_super_space())(g[u].position, result.first, m_space->get_super_space());
-      return boost::tuple<PointType, bool, EdgeProp >(result.first, result.second, EdgeProp(dist));
+      EdgeProp ep(dist);
+      if(m_planner->is_incremental_replanning())
+        ep.clearance = get_motion_clearance(*m_space, g[u].position, result.first);
+      return boost::tuple<PointType, bool, EdgeProp >(result.first, result.second, ep);
     } else 
       return boost::tuple<PointType, bool, EdgeProp >(result.first, result.second, EdgeProp());
   };
   
   template <typename Vertex, typename Graph>
   std::pair<bool, EdgeProp > can_be_connected(Vertex u, Vertex v, const Graph& g) const {
+    if(m_planner->is_incremental_replanning()) {
+      // the clearance query also checks the motion, the edge's clearance is then valid from its creation.
+      EdgeProp ep;
+      ep.clearance = get_motion_clearance(*m_space, g[u].position, g[v].position);
+      if(ep.clearance < 0.0)
+        return std::pair<bool, EdgeProp>(false, ep);
+      ep.astar_weight = get(distance_metric, m_space->get_super_space())(g[u].position, g[v].position, m_space->get_super_space());
+      return std::pair<bool, EdgeProp>(true, ep);
+    };
     double dist = get(distance_metric, *m_space)(g[u].position, g[v].position, *m_space);
     return std::pair<bool, EdgeProp>((dist < std::numeric_limits<double>::infinity()), EdgeProp(dist));
   };
@@ -604,6 +722,139 @@ struct fadprm_planner_visitor {
 
 
 
+template <typename FreeSpaceType, 
+          typename SBPPReporter>
+template <typename MotionGraph, typename Visitor, typename PositionMap, typename NcSelector>
+typename fadprm_path_planner<FreeSpaceType,SBPPReporter>::roadmap_vertex 
+  fadprm_path_planner<FreeSpaceType,SBPPReporter>::add_roadmap_vertex(
+    const point_type& aPos, MotionGraph& g, Visitor& vis, PositionMap pos_map, 
+    NcSelector select_neighborhood, std::vector< roadmap_vertex >& aAffected) {
+  typedef typename boost::graph_traits<MotionGraph>::edge_descriptor Edge;
+  typedef fadprm_edge_data<FreeSpaceType> EdgeProp;
+  
+  std::vector< roadmap_vertex > Nc;
+  select_neighborhood(aPos, std::back_inserter(Nc), g, *(this->m_space), boost::bundle_prop_to_vertex_prop(pos_map, g));
+  
+  fadprm_vertex_data<FreeSpaceType> up;
+  up.position = aPos;
+#ifdef RK_ENABLE_CXX0X_FEATURES
+  roadmap_vertex u = add_vertex(std::move(up), g);
+#else
+  roadmap_vertex u = add_vertex(up, g);
+#endif
+  g[u].density = 0.0;
+  g[u].astar_color = boost::color_traits<boost::default_color_type>::white();
+  g[u].distance_accum = std::numeric_limits<double>::infinity();
+  g[u].astar_rhs_value = std::numeric_limits<double>::infinity();
+  g[u].predecessor = u;
+  vis.vertex_added(u, g);
+  
+  for(typename std::vector< roadmap_vertex >::iterator it = Nc.begin(); it != Nc.end(); ++it) {
+    std::pair<bool, EdgeProp> conn = vis.can_be_connected(*it, u, g);
+    if(!conn.first)
+      continue;
+    std::pair<Edge, bool> e_new = add_edge(*it, u, conn.second, g);
+    if(e_new.second) {
+      vis.edge_added(e_new.first, g);
+      aAffected.push_back(*it);
+    };
+  };
+  aAffected.push_back(u);
+  
+  return u;
+};
+
+
+template <typename FreeSpaceType, 
+          typename SBPPReporter>
+template <typename MotionGraph, typename Visitor, typename PositionMap, typename NcSelector>
+void fadprm_path_planner<FreeSpaceType,SBPPReporter>::repair_roadmap_search(
+    MotionGraph& g, Visitor& vis, PositionMap pos_map, NcSelector select_neighborhood) {
+  typedef typename boost::graph_traits<MotionGraph>::vertex_iterator VertexIter;
+  typedef typename boost::graph_traits<MotionGraph>::edge_iterator EdgeIter;
+  
+  const super_space_type& sup_space = this->m_space->get_super_space();
+  std::vector< roadmap_vertex > affected;
+  
+  // a moved start position is connected to the roadmap (as a new vertex), and since the search 
+  // is rooted at the goal, only the heuristic values must be updated (as in D* Lite).
+  if(get(distance_metric, sup_space)(g[vis.m_start_node].position, m_start_pos, sup_space) > std::numeric_limits<double>::epsilon()) {
+    roadmap_vertex u = add_roadmap_vertex(m_start_pos, g, vis, pos_map, select_neighborhood, affected);
+    vis.m_start_node = u;
+    m_roadmap_start = u;
+    VertexIter vi, vi_end;
+    for(boost::tie(vi, vi_end) = vertices(g); vi != vi_end; ++vi)
+      g[*vi].heuristic_value = get(distance_metric, sup_space)(m_start_pos, g[*vi].position, sup_space);
+  };
+  
+  // a moved goal position invalidates all the distance values, it requires a new search (over the roadmap).
+  bool is_goal_moved = (get(distance_metric, sup_space)(g[vis.m_goal_node].position, m_goal_pos, sup_space) > std::numeric_limits<double>::epsilon());
+  if(is_goal_moved) {
+    roadmap_vertex v = add_roadmap_vertex(m_goal_pos, g, vis, pos_map, select_neighborhood, affected);
+    vis.m_goal_node = v;
+    m_roadmap_goal = v;
+  };
+  
+  // only the edges whose clearance was exhausted by the obstacle motions are re-validated, 
+  // the weights of those that became blocked (or free again) are changed.
+  if(m_obstacle_displacement > 0.0) {
+    EdgeIter ei, ei_end;
+    for(boost::tie(ei, ei_end) = edges(g); ei != ei_end; ++ei) {
+      fadprm_edge_data<FreeSpaceType>& ep = g[*ei];
+      ep.clearance -= m_obstacle_displacement;
+      if(ep.clearance > 0.0)
+        continue;
+      roadmap_vertex u = source(*ei, g);
+      roadmap_vertex v = target(*ei, g);
+      ep.clearance = get_motion_clearance(*(this->m_space), g[u].position, g[v].position);
+      bool was_blocked = (ep.astar_weight == std::numeric_limits<double>::infinity());
+      bool is_blocked = (ep.clearance < 0.0);
+      if(was_blocked == is_blocked)
+        continue;
+      if(is_blocked)
+        ep.astar_weight = std::numeric_limits<double>::infinity();
+      else
+        ep.astar_weight = get(distance_metric, sup_space)(g[u].position, g[v].position, sup_space);
+      affected.push_back(u);
+      affected.push_back(v);
+    };
+    m_obstacle_displacement = 0.0;
+  };
+  
+  if(is_goal_moved) {
+    ReaK::graph::generate_fadprm(
+      g, vis.m_goal_node, *(this->m_space), 
+      get(&fadprm_vertex_data<FreeSpaceType>::heuristic_value, g), 
+      vis, 
+      get(&fadprm_vertex_data<FreeSpaceType>::predecessor, g), 
+      get(&fadprm_vertex_data<FreeSpaceType>::distance_accum, g), 
+      get(&fadprm_vertex_data<FreeSpaceType>::astar_rhs_value, g), 
+      get(&fadprm_vertex_data<FreeSpaceType>::astar_key_value, g), 
+      get(&fadprm_edge_data<FreeSpaceType>::astar_weight, g), 
+      get(&fadprm_vertex_data<FreeSpaceType>::density, g), 
+      pos_map, select_neighborhood, 
+      get(&fadprm_vertex_data<FreeSpaceType>::astar_color, g), 
+      this->m_initial_relaxation);
+  } else {
+    ReaK::graph::repair_fadprm(
+      g, vis.m_goal_node, *(this->m_space), 
+      get(&fadprm_vertex_data<FreeSpaceType>::heuristic_value, g), 
+      vis, 
+      get(&fadprm_vertex_data<FreeSpaceType>::predecessor, g), 
+      get(&fadprm_vertex_data<FreeSpaceType>::distance_accum, g), 
+      get(&fadprm_vertex_data<FreeSpaceType>::astar_rhs_value, g), 
+      get(&fadprm_vertex_data<FreeSpaceType>::astar_key_value, g), 
+      get(&fadprm_edge_data<FreeSpaceType>::astar_weight, g), 
+      get(&fadprm_vertex_data<FreeSpaceType>::density, g), 
+      pos_map, select_neighborhood, 
+      get(&fadprm_vertex_data<FreeSpaceType>::astar_color, g), 
+      this->m_initial_relaxation, 
+      affected.begin(), affected.end());
+  };
+};
+
+
+
 template <typename FreeSpaceType, 
           typename SBPPReporter>
 shared_ptr< seq_path_base< typename fadprm_path_planner<FreeSpaceType,SBPPReporter>::super_space_type > > 
@@ -612,6 +863,10 @@ shared_ptr< seq_path_base< typename fadprm_path_planner<FreeSpaceType,SBPPReport
   
   this->has_reached_max_vertices = false;
   this->m_solutions.clear();
+  this->m_last_vertex_count = 0;
+  this->m_last_best_distance = std::numeric_limits<double>::infinity();
+  this->m_last_start_values = std::pair<double, double>(std::numeric_limits<double>::infinity(), std::numeric_limits<double>::infinity());
+  this->m_search_stalled = false;
   
   typedef typename subspace_traits<FreeSpaceType>::super_space_type SuperSpace;
   typedef typename topology_traits<SuperSpace>::point_type PointType;
@@ -693,6 +948,17 @@ shared_ptr< seq_path_base< typename fadprm_path_planner<FreeSpaceType,SBPPReport
         this->m_initial_relaxation);
   
   
+#define RK_FADPRM_MAKE_GENERATE_OR_REPAIR_CALL_FIXED_NEIGHBORHOOD \
+      if(is_repair) { \
+        repair_roadmap_search(motion_graph, vis, pos_map,  \
+          ReaK::graph::fixed_neighborhood< NNFinderType >( \
+            nn_finder,  \
+            10, max_radius)); \
+      } else { \
+        RK_FADPRM_MAKE_GENERATE_CALL_FIXED_NEIGHBORHOOD \
+      };
+  
+  
 #define RK_FADPRM_MAKE_GENERATE_CALL_STAR_NEIGHBORHOOD \
       ReaK::graph::generate_fadprm( \
         motion_graph, goal_node, *(this->m_space), \
@@ -715,19 +981,31 @@ shared_ptr< seq_path_base< typename fadprm_path_planner<FreeSpaceType,SBPPReport
   
   if((this->m_data_structure_flags & MOTION_GRAPH_STORAGE_MASK) == ADJ_LIST_MOTION_GRAPH) {
     
-    typedef boost::adjacency_list< 
-      boost::vecS, boost::vecS, boost::undirectedS,
-      fadprm_vertex_data<FreeSpaceType>,
-      fadprm_edge_data<FreeSpaceType>, boost::listS> MotionGraphType;
+    typedef roadmap_type MotionGraphType;
     typedef typename boost::graph_traits<MotionGraphType>::vertex_descriptor Vertex;
     typedef typename MotionGraphType::vertex_property_type VertexProp;
     typedef boost::composite_property_map< 
       PositionMap, boost::whole_bundle_property_map< MotionGraphType, boost::vertex_bundle_t > > GraphPositionMap;
     
-    MotionGraphType motion_graph;
+    // with incremental replanning, the roadmap of the previous call is repaired instead of re-generated.
+    bool is_repair = (this->m_incremental && this->m_roadmap);
+    shared_ptr< MotionGraphType > motion_graph_ptr = this->m_roadmap;
+    if(!is_repair) {
+      motion_graph_ptr = shared_ptr< MotionGraphType >(new MotionGraphType());
+      this->m_obstacle_displacement = 0.0;
+    };
+    MotionGraphType& motion_graph = *motion_graph_ptr;
     GraphPositionMap g_pos_map = GraphPositionMap(pos_map, boost::whole_bundle_property_map< MotionGraphType, boost::vertex_bundle_t >(&motion_graph));
     
-    RK_FADPRM_INITIALIZE_START_AND_GOAL
+    if(!is_repair) {
+      RK_FADPRM_INITIALIZE_START_AND_GOAL
+      this->m_roadmap_start = start_node;
+      this->m_roadmap_goal = goal_node;
+      if(this->m_incremental)
+        this->m_roadmap = motion_graph_ptr;
+    };
+    Vertex start_node = this->m_roadmap_start;
+    Vertex goal_node = this->m_roadmap_goal;
     
     if((this->m_data_structure_flags & KNN_METHOD_MASK) == LINEAR_SEARCH_KNN) {
       fadprm_planner_visitor<FreeSpaceType, MotionGraphType, no_NNfinder_synchro, SBPPReporter> vis(this->m_space, this, no_NNfinder_synchro(), start_node, goal_node);
@@ -735,7 +1013,7 @@ shared_ptr< seq_path_base< typename fadprm_path_planner<FreeSpaceType,SBPPReport
       typedef linear_neighbor_search<> NNFinderType;
       NNFinderType nn_finder;
       
-      RK_FADPRM_MAKE_GENERATE_CALL_FIXED_NEIGHBORHOOD
+      RK_FADPRM_MAKE_GENERATE_OR_REPAIR_CALL_FIXED_NEIGHBORHOOD
       
     } else if((this->m_data_structure_flags & KNN_METHOD_MASK) == DVP_BF2_TREE_KNN) {
       
@@ -749,7 +1027,7 @@ shared_ptr< seq_path_base< typename fadprm_path_planner<FreeSpaceType,SBPPReport
       
       fadprm_planner_visitor<FreeSpaceType, MotionGraphType, NNFinderType, SBPPReporter> vis(this->m_space, this, nn_finder, start_node, goal_node);
       
-      RK_FADPRM_MAKE_GENERATE_CALL_FIXED_NEIGHBORHOOD
+      RK_FADPRM_MAKE_GENERATE_OR_REPAIR_CALL_FIXED_NEIGHBORHOOD
       
     } else if((this->m_data_structure_flags & KNN_METHOD_MASK) == DVP_BF4_TREE_KNN) {
       
@@ -763,7 +1041,7 @@ shared_ptr< seq_path_base< typename fadprm_path_planner<FreeSpaceType,SBPPReport
       
       fadprm_planner_visitor<FreeSpaceType, MotionGraphType, NNFinderType, SBPPReporter> vis(this->m_space, this, nn_finder, start_node, goal_node);
       
-      RK_FADPRM_MAKE_GENERATE_CALL_FIXED_NEIGHBORHOOD
+      RK_FADPRM_MAKE_GENERATE_OR_REPAIR_CALL_FIXED_NEIGHBORHOOD
       
     } else if((this->m_data_structure_flags & KNN_METHOD_MASK) == DVP_COB2_TREE_KNN) {
       
@@ -777,7 +1055,7 @@ shared_ptr< seq_path_base< typename fadprm_path_planner<FreeSpaceType,SBPPReport
       
       fadprm_planner_visitor<FreeSpaceType, MotionGraphType, NNFinderType, SBPPReporter> vis(this->m_space, this, nn_finder, start_node, goal_node);
       
-      RK_FADPRM_MAKE_GENERATE_CALL_FIXED_NEIGHBORHOOD
+      RK_FADPRM_MAKE_GENERATE_OR_REPAIR_CALL_FIXED_NEIGHBORHOOD
       
     } else if((this->m_data_structure_flags & KNN_METHOD_MASK) == DVP_COB4_TREE_KNN) {
       
@@ -791,7 +1069,7 @@ shared_ptr< seq_path_base< typename fadprm_path_planner<FreeSpaceType,SBPPReport
       
       fadprm_planner_visitor<FreeSpaceType, MotionGraphType, NNFinderType, SBPPReporter> vis(this->m_space, this, nn_finder, start_node, goal_node);
       
-      RK_FADPRM_MAKE_GENERATE_CALL_FIXED_NEIGHBORHOOD
+      RK_FADPRM_MAKE_GENERATE_OR_REPAIR_CALL_FIXED_NEIGHBORHOOD
       
     };
     
@@ -911,6 +1189,7 @@ shared_ptr< seq_path_base< typename fadprm_path_planner<FreeSpaceType,SBPPReport
   
 #undef RK_FADPRM_INITIALIZE_START_AND_GOAL
 #undef RK_FADPRM_MAKE_GENERATE_CALL_FIXED_NEIGHBORHOOD
+#undef RK_FADPRM_MAKE_GENERATE_OR_REPAIR_CALL_FIXED_NEIGHBORHOOD
 #undef RK_FADPRM_MAKE_GENERATE_CALL_STAR_NEIGHBORHOOD
   
   if(m_solutions.size())
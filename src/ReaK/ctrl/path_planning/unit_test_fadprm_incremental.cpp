@@ -0,0 +1,202 @@
+/*
+ *    Copyright 2013 Sven Mikael Persson
+ *
+ *    THIS SOFTWARE IS DISTRIBUTED UNDER THE TERMS OF THE GNU GENERAL PUBLIC LICENSE v3 (GPLv3).
+ *
+ *    This file is part of ReaK.
+ *
+ *    ReaK is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    (at your option) any later version.
+ *
+ *    ReaK is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with ReaK (as LICENSE in the root folder).
+ *    If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "fadprm_path_planner.hpp"
+
+#include "topologies/hyperbox_topology.hpp"
+#include "topologies/no_obstacle_space.hpp"
+#include "global_rng.hpp"
+
+#include <cmath>
+
+#define BOOST_TEST_DYN_LINK
+
+#define BOOST_TEST_MODULE fadprm_incremental
+#include <boost/test/unit_test.hpp>
+
+
+namespace {
+
+using namespace ReaK;
+
+typedef vect<double,2> point_2D;
+typedef pp::hyperbox_topology< point_2D > box_space;
+
+
+/*
+ * A square world with one moving disc obstacle, whose motions have an exact clearance
+ * (the distance from the segment of the motion to the disc).
+ */
+class disc_obstacle_world : public pp::no_obstacle_space< box_space > {
+  public:
+    typedef pp::no_obstacle_space< box_space > base_type;
+
+    point_2D center;
+    double radius;
+    mutable std::size_t clearance_count;
+
+    disc_obstacle_world(const point_2D& aCenter, double aRadius) :
+                        base_type("disc_obstacle_world", box_space("box", point_2D(0.0, 0.0), point_2D(100.0, 100.0)), 30.0),
+                        center(aCenter), radius(aRadius), clearance_count(0) { };
+
+    bool is_free(const point_2D& p) const {
+      return (norm_2(p - center) > radius);
+    };
+
+    double get_motion_clearance(const point_2D& p1, const point_2D& p2) const {
+      point_2D d = p2 - p1;
+      double dd = d * d;
+      double t = (dd > 0.0 ? ((center - p1) * d) / dd : 0.0);
+      t = (t < 0.0 ? 0.0 : (t > 1.0 ? 1.0 : t));
+      return norm_2(p1 + t * d - center) - radius;
+    };
+
+    point_2D move_position_toward(const point_2D& p1, double fraction, const point_2D& p2) const {
+      point_2D p = base_type::move_position_toward(p1, fraction, p2);
+      if(get_motion_clearance(p1, p) >= 0.0)
+        return p;
+      // stop just before the first intersection with the disc.
+      point_2D d = p - p1;
+      point_2D f = p1 - center;
+      double a = d * d;
+      double b = f * d;
+      double s = (-b - std::sqrt(b * b - a * (f * f - radius * radius))) / a - 1e-6;
+      return p1 + (s > 0.0 ? s : 0.0) * d;
+    };
+
+    double distance(const point_2D& p1, const point_2D& p2) const {
+      if(norm_2(p2 - move_position_toward(p1, 1.0, p2)) < std::numeric_limits< double >::epsilon())
+        return norm_2(p2 - p1);
+      else
+        return std::numeric_limits<double>::infinity();
+    };
+
+    point_2D random_point() const {
+      point_2D p = base_type::random_point();
+      while(!is_free(p))
+        p = base_type::random_point();
+      return p;
+    };
+
+    std::pair<point_2D, bool> random_walk(const point_2D& p_u) const {
+      point_2D p = move_position_toward(p_u, 1.0, random_point());
+      return std::pair<point_2D, bool>(p, (norm_2(p - p_u) > 1e-3));
+    };
+
+};
+
+// this is the overload used by the planner, it counts the (re-)validations of motions.
+double get_motion_clearance(const disc_obstacle_world& space, const point_2D& p1, const point_2D& p2) {
+  ++space.clearance_count;
+  return space.get_motion_clearance(p1, p2);
+};
+
+};
+
+
+namespace ReaK {
+
+namespace pp {
+
+template <>
+struct is_metric_space< disc_obstacle_world > : boost::mpl::true_ { };
+
+template <>
+struct is_point_distribution< disc_obstacle_world > : boost::mpl::true_ { };
+
+};
+
+};
+
+
+namespace {
+
+typedef pp::fadprm_path_planner< disc_obstacle_world > planner_type;
+
+// checks that the path goes from the start to the goal of the planner, through collision-free motions.
+void check_solution(const shared_ptr< pp::seq_path_base< box_space > >& aPath, const planner_type& aPlanner,
+                    const disc_obstacle_world& aWorld) {
+  BOOST_REQUIRE( aPath );
+  typedef pp::seq_path_base< box_space >::point_fraction_iterator PtIter;
+  PtIter it = aPath->begin_fraction_travel();
+  PtIter it_end = aPath->end_fraction_travel();
+  point_2D p_prev = *it;
+  BOOST_CHECK_SMALL( norm_2(p_prev - aPlanner.get_start_pos()), 1e-9 );
+  // moving by a fraction of 1.0 goes from one waypoint to the next.
+  while(it != it_end) {
+    it += 1.0;
+    BOOST_CHECK( aWorld.get_motion_clearance(p_prev, *it) >= 0.0 );
+    p_prev = *it;
+  };
+  BOOST_CHECK_SMALL( norm_2(p_prev - aPlanner.get_goal_pos()), 1e-9 );
+};
+
+};
+
+
+BOOST_AUTO_TEST_CASE( fadprm_solve_test )
+{
+  // the planner draws from the global random number generator, a fixed seed makes the test repeatable.
+  pp::get_global_rng().seed(1);
+  shared_ptr< disc_obstacle_world > world(new disc_obstacle_world(point_2D(50.0, 50.0), 15.0));
+
+  planner_type planner(world, point_2D(5.0, 5.0), point_2D(95.0, 95.0), 0.5, 1000, 100,
+                       pp::ADJ_LIST_MOTION_GRAPH | pp::LINEAR_SEARCH_KNN, pp::no_sbmp_report(), 5);
+
+  check_solution(planner.solve_path(), planner, *world);
+};
+
+
+BOOST_AUTO_TEST_CASE( fadprm_incremental_replanning_test )
+{
+  pp::get_global_rng().seed(1);
+  shared_ptr< disc_obstacle_world > world(new disc_obstacle_world(point_2D(50.0, 50.0), 15.0));
+
+  planner_type planner(world, point_2D(5.0, 5.0), point_2D(95.0, 95.0), 0.5, 1000, 100,
+                       pp::ADJ_LIST_MOTION_GRAPH | pp::LINEAR_SEARCH_KNN, pp::no_sbmp_report(), 5);
+  planner.set_incremental_replanning(true);
+
+  BOOST_TEST_MESSAGE( "Initial solve..." );
+  check_solution(planner.solve_path(), planner, *world);
+  std::size_t full_count = world->clearance_count;
+
+  BOOST_TEST_MESSAGE( "Solve after an obstacle motion..." );
+  world->center = point_2D(60.0, 40.0);
+  world->clearance_count = 0;
+  planner.notify_obstacle_motion(norm_2(point_2D(10.0, -10.0)));
+  check_solution(planner.solve_path(), planner, *world);
+  BOOST_TEST_MESSAGE( "Motions validated: " << full_count << " for the initial solve, " 
+                      << world->clearance_count << " for the repair." );
+  // only the motions near the obstacle are re-validated, not the whole roadmap (as a full replan would).
+  BOOST_CHECK_LT( world->clearance_count, full_count );
+
+  BOOST_TEST_MESSAGE( "Solve with a moved start..." );
+  planner.set_start_pos(point_2D(10.0, 5.0));
+  check_solution(planner.solve_path(), planner, *world);
+
+  BOOST_TEST_MESSAGE( "Solve with a moved goal..." );
+  planner.set_goal_pos(point_2D(90.0, 95.0));
+  check_solution(planner.solve_path(), planner, *world);
+
+};
+
+
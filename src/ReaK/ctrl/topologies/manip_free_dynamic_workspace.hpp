@@ -83,6 +83,39 @@ class manip_dynamic_env : public named_object {
     detail::manip_dk_proxy_env_impl m_prox_env;
     std::vector< shared_ptr< proxy_model_updater > > m_prox_updaters;
     
+    bool m_bisection_validation;
+    
+    /* Checks if the complete motion from p1 to p2 is collision-free, visiting the samples in bisection order. */
+    bool is_edge_free_bisection(const point_type& p1, const point_type& p2) const {
+      typedef typename get_tagged_spatial_interpolator< InterpMethodTag, RateLimitedJointSpace, time_topology>::type InterpType;
+      typedef typename get_tagged_spatial_interpolator< InterpMethodTag, RateLimitedJointSpace, time_topology>::pseudo_factory_type InterpFactoryType;
+      
+      if(p1.time > p2.time) // Am I trying to go backwards in time (impossible)?
+        return false;
+      double reach_time = m_distance(p1.pt, p2.pt, m_space.get_space_topology());
+      double dt_total = (p2.time - p1.time);  // the free time that I have along the path.
+      if((dt_total < reach_time) || (dt_total >= max_edge_length))
+        return false;
+      
+      std::size_t sample_count = 0;
+      for(double d = min_interval; d < dt_total; d += min_interval)
+        ++sample_count;
+      std::vector< std::size_t > order;
+      detail::get_bisection_order(sample_count, order);
+      
+      InterpType interp;
+      interp.initialize(p1.pt, p2.pt, dt_total, m_space.get_space_topology(), m_space.get_time_topology(), InterpFactoryType());
+      point_type result = p1;
+      for(std::size_t i = 0; i < order.size(); ++i) {
+        double d = order[i] * min_interval;
+        interp.compute_point(result.pt, p1.pt, p2.pt, m_space.get_space_topology(), m_space.get_time_topology(), d, dt_total, InterpFactoryType());
+        result.time = p1.time + d;
+        if(!is_free(result))
+          return false;
+      };
+      return true;
+    };
+    
   public:
     
     /**
@@ -144,6 +177,13 @@ class manip_dynamic_env : public named_object {
       if(actual_dist == std::numeric_limits<double>::infinity())
         return actual_dist;
       
+      if(m_bisection_validation) {
+        if(is_edge_free_bisection(p1, p2))
+          return actual_dist;
+        else
+          return std::numeric_limits<double>::infinity(); //p2 is not reachable from p1, due to a collision.
+      };
+      
       if(fabs(p2.time - move_position_toward(p1, 1.0, p2).time) < std::numeric_limits< double >::epsilon())
         return actual_dist; //if p2 is reachable from p1, use Euclidean distance.
       else
@@ -258,10 +298,26 @@ class manip_dynamic_env : public named_object {
                               time_poisson_topology("time-poisson topology", aMinInterval, aMaxEdgeLength)),
                       m_distance(get(distance_metric, m_space.get_space_topology())),
                       m_rand_sampler(get(random_sampler, m_space.get_space_topology())), 
-                      m_prox_env(aModel, aJointLimitsMap) { };
+                      m_prox_env(aModel, aJointLimitsMap),
+                      m_bisection_validation(false) { };
     
     virtual ~manip_dynamic_env() { };
     
+    /**
+     * Sets whether the validity of complete motions (as needed by the distance function) is checked 
+     * by visiting the samples in hierarchical bisection (van der Corput) order, stopping at the 
+     * first collision. This does not affect move_position_toward, which still returns the last 
+     * collision-free point along the motion.
+     * \param aBisection True to use bisection-ordered validation of motions.
+     */
+    void set_bisection_validation(bool aBisection) { m_bisection_validation = aBisection; };
+    
+    /**
+     * Returns true if the validity of complete motions is checked in bisection order.
+     * \return True if the validity of complete motions is checked in bisection order.
+     */
+    bool is_bisection_validation() const { return m_bisection_validation; };
+    
     /**
      * Add a 2D proxy query pair to the collision environment.
      * \param aProxy The new 2D proxy query pair to add to the collision environment.
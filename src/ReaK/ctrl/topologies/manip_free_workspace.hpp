@@ -55,6 +55,15 @@
 
 #include "interpolation/generic_interpolator_factory.hpp"
 
+#include "base/thread_incl.hpp"
+
+#include "lin_alg/arithmetic_tuple.hpp"
+
+#include <list>
+#include <vector>
+#include <unordered_map>
+#include <functional>
+
 namespace ReaK {
 
 namespace pp {
@@ -70,6 +79,10 @@ class manip_dk_proxy_env_impl {
     std::vector< shared_ptr< geom::proxy_query_pair_2D > > m_proxy_env_2D;
     std::vector< shared_ptr< geom::proxy_query_pair_3D > > m_proxy_env_3D;
     
+    // proxy pairs between two parts of the manipulator (self-collisions), both sides of these pairs move.
+    std::vector< shared_ptr< geom::proxy_query_pair_2D > > m_self_proxy_env_2D;
+    std::vector< shared_ptr< geom::proxy_query_pair_3D > > m_self_proxy_env_3D;
+    
     manip_dk_proxy_env_impl(const shared_ptr< kte::direct_kinematics_model >& aModel = shared_ptr< kte::direct_kinematics_model >(),
                             const shared_ptr< joint_limits_collection<double> >& aJointLimitMap = shared_ptr< joint_limits_collection<double> >()) :
                             m_model(aModel), m_joint_limits_map(aJointLimitMap) { };
@@ -92,14 +105,328 @@ class manip_dk_proxy_env_impl {
           return false;
       };
       for( std::vector< shared_ptr< geom::proxy_query_pair_3D > >::const_iterator it = m_proxy_env_3D.begin(); it != m_proxy_env_3D.end(); ++it) {
-        ReaK::shared_ptr< ReaK::geom::proximity_finder_3D > tmp = (*it)->findMinimumDistance();
+        if(!(*it)->isCollisionFree())
+          return false;
+      };
+      for( std::vector< shared_ptr< geom::proxy_query_pair_2D > >::const_iterator it = m_self_proxy_env_2D.begin(); it != m_self_proxy_env_2D.end(); ++it) {
+        ReaK::shared_ptr< ReaK::geom::proximity_finder_2D > tmp = (*it)->findMinimumDistance();
         if((tmp) && (tmp->getLastResult().mDistance < 0.0))
           return false;
       };
+      for( std::vector< shared_ptr< geom::proxy_query_pair_3D > >::const_iterator it = m_self_proxy_env_3D.begin(); it != m_self_proxy_env_3D.end(); ++it) {
+        if(!(*it)->isCollisionFree())
+          return false;
+      };
       
       return true;
     };
     
+    /* 
+     * Returns the minimum distance over the proxy pairs, where the distances of the self-collision pairs 
+     * are divided by aSelfScale (e.g., 2.0 to account for the two sides of those pairs moving towards 
+     * each other, each at up to the maximum speed of the manipulator).
+     */
+    template <typename PointType, typename RateLimitedJointSpace>
+    double get_clearance(const PointType& pt, const RateLimitedJointSpace& space, double aSelfScale = 1.0) const {
+      typedef typename get_rate_illimited_space< RateLimitedJointSpace >::type NormalJointSpace;
+      NormalJointSpace normal_j_space; // dummy
+      typename topology_traits< NormalJointSpace >::point_type pt_inter;
+      detail::create_normal_joint_vectors_impl(pt_inter, pt, *m_joint_limits_map);
+      detail::write_joint_coordinates_impl(pt_inter, normal_j_space, m_model);
+      // update the kinematics model with the given joint states.
+      m_model->doDirectMotion();
+      
+      double result = std::numeric_limits<double>::infinity();
+      for( std::vector< shared_ptr< geom::proxy_query_pair_2D > >::const_iterator it = m_proxy_env_2D.begin(); it != m_proxy_env_2D.end(); ++it) {
+        ReaK::shared_ptr< ReaK::geom::proximity_finder_2D > tmp = (*it)->findMinimumDistance();
+        if((tmp) && (tmp->getLastResult().mDistance < result))
+          result = tmp->getLastResult().mDistance;
+      };
+      for( std::vector< shared_ptr< geom::proxy_query_pair_3D > >::const_iterator it = m_proxy_env_3D.begin(); it != m_proxy_env_3D.end(); ++it) {
+        ReaK::shared_ptr< ReaK::geom::proximity_finder_3D > tmp = (*it)->findMinimumDistance();
+        if((tmp) && (tmp->getLastResult().mDistance < result))
+          result = tmp->getLastResult().mDistance;
+      };
+      for( std::vector< shared_ptr< geom::proxy_query_pair_2D > >::const_iterator it = m_self_proxy_env_2D.begin(); it != m_self_proxy_env_2D.end(); ++it) {
+        ReaK::shared_ptr< ReaK::geom::proximity_finder_2D > tmp = (*it)->findMinimumDistance();
+        if((tmp) && (tmp->getLastResult().mDistance / aSelfScale < result))
+          result = tmp->getLastResult().mDistance / aSelfScale;
+      };
+      for( std::vector< shared_ptr< geom::proxy_query_pair_3D > >::const_iterator it = m_self_proxy_env_3D.begin(); it != m_self_proxy_env_3D.end(); ++it) {
+        ReaK::shared_ptr< ReaK::geom::proximity_finder_3D > tmp = (*it)->findMinimumDistance();
+        if((tmp) && (tmp->getLastResult().mDistance / aSelfScale < result))
+          result = tmp->getLastResult().mDistance / aSelfScale;
+      };
+      
+      return result;
+    };
+    
+    /* 
+     * Returns an upper-bound on the speed of any point of the manipulator when its joints move at 
+     * their rate limits: each joint contributes its linear speed limit plus its angular speed limit 
+     * times aMaxReach (the largest distance from a joint to a point of the manipulator's geometry).
+     * Generalized coordinates can be either linear or angular, and so, they contribute their speed 
+     * limit times the larger of 1 and aMaxReach.
+     */
+    double get_max_motion_speed(double aMaxReach) const {
+      const joint_limits_collection<double>& lim = *m_joint_limits_map;
+      double gen_lever = (aMaxReach > 1.0 ? aMaxReach : 1.0);
+      double result = 0.0;
+      for(std::size_t i = 0; i < lim.gen_speed_limits.size(); ++i)
+        result += lim.gen_speed_limits[i] * gen_lever;
+      for(std::size_t i = 0; i + 1 < lim.frame2D_speed_limits.size(); i += 2)
+        result += lim.frame2D_speed_limits[i] + lim.frame2D_speed_limits[i+1] * aMaxReach;
+      for(std::size_t i = 0; i + 1 < lim.frame3D_speed_limits.size(); i += 2)
+        result += lim.frame3D_speed_limits[i] + lim.frame3D_speed_limits[i+1] * aMaxReach;
+      return result;
+    };
+    
+};
+
+/* 
+ * This functor hashes a point (of any vector, arithmetic-tuple or scalar type) from its 
+ * flattened coordinates. Points that are equal (bit-wise) have equal hash values.
+ */
+struct manip_point_hasher {
+  template <typename Vector>
+  static std::size_t hash_coefs(const Vector& v) {
+    std::size_t seed = v.size();
+    for(std::size_t i = 0; i < v.size(); ++i)
+      seed ^= std::hash< double >()(v[i]) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+    return seed;
+  };
+  
+  template <typename PointType>
+  std::size_t operator()(const PointType& p) const {
+    return hash_coefs(to_vect<double>(p));
+  };
+};
+
+/* 
+ * This class is a bounded, thread-safe (least-recently-used) cache of the results of 
+ * edge validations (the point reached when moving from one point toward another, and whether 
+ * the target was reached). Entries are indexed by a hash of their end-points, and the 
+ * (few) entries with a matching hash are confirmed with an equality predicate (e.g., 
+ * zero distance in the space).
+ */
+template <typename PointType, typename PointHasher = manip_point_hasher>
+class manip_edge_result_cache {
+  public:
+    struct entry {
+      PointType p1;
+      PointType p2;
+      PointType reached;
+      bool is_free;
+      bool has_reached; // false if only the validity of the edge is known (fail-fast validation).
+    };
+    
+  private:
+    typedef std::pair< std::size_t, entry > keyed_entry;
+    typedef typename std::list< keyed_entry >::iterator entry_iterator;
+    typedef std::unordered_multimap< std::size_t, entry_iterator > index_type;
+    
+    std::list< keyed_entry > m_entries; // most recently used first.
+    index_type m_index;
+    PointHasher m_hasher;
+    std::size_t m_capacity;
+    std::size_t m_hits;
+    std::size_t m_misses;
+    std::size_t m_validations;
+    std::size_t m_checks;
+    mutable ReaKaux::mutex m_access_mutex;
+    
+    std::size_t get_key(const PointType& p1, const PointType& p2) const {
+      std::size_t seed = m_hasher(p1);
+      seed ^= m_hasher(p2) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+      return seed;
+    };
+    
+    void pop_oldest() {
+      std::pair< typename index_type::iterator, typename index_type::iterator > rg = m_index.equal_range(m_entries.back().first);
+      for(; rg.first != rg.second; ++rg.first) {
+        if(rg.first->second == --m_entries.end()) {
+          m_index.erase(rg.first);
+          break;
+        };
+      };
+      m_entries.pop_back();
+    };
+    
+  public:
+    
+    explicit manip_edge_result_cache(std::size_t aCapacity = 256, const PointHasher& aHasher = PointHasher()) : 
+                                     m_entries(), m_index(), m_hasher(aHasher), m_capacity(aCapacity), 
+                                     m_hits(0), m_misses(0), 
+                                     m_validations(0), m_checks(0), m_access_mutex() { };
+    
+    template <typename EqualPredicate>
+    bool find(const PointType& p1, const PointType& p2, EqualPredicate is_equal, entry& result) {
+      std::size_t key = get_key(p1, p2);
+      ReaKaux::unique_lock< ReaKaux::mutex > lock_here(m_access_mutex);
+      std::pair< typename index_type::iterator, typename index_type::iterator > rg = m_index.equal_range(key);
+      for(; rg.first != rg.second; ++rg.first) {
+        entry_iterator it = rg.first->second;
+        if(is_equal(it->second.p1, p1) && is_equal(it->second.p2, p2)) {
+          m_entries.splice(m_entries.begin(), m_entries, it);
+          result = it->second;
+          ++m_hits;
+          return true;
+        };
+      };
+      ++m_misses;
+      return false;
+    };
+    
+    template <typename EqualPredicate>
+    void insert(const entry& e, EqualPredicate is_equal) {
+      std::size_t key = get_key(e.p1, e.p2);
+      ReaKaux::unique_lock< ReaKaux::mutex > lock_here(m_access_mutex);
+      if(m_capacity == 0)
+        return;
+      // an existing entry for the same edge (e.g., inserted concurrently, or with a fail-fast result) is updated.
+      std::pair< typename index_type::iterator, typename index_type::iterator > rg = m_index.equal_range(key);
+      for(; rg.first != rg.second; ++rg.first) {
+        entry_iterator it = rg.first->second;
+        if(is_equal(it->second.p1, e.p1) && is_equal(it->second.p2, e.p2)) {
+          it->second = e;
+          m_entries.splice(m_entries.begin(), m_entries, it);
+          return;
+        };
+      };
+      m_entries.push_front(keyed_entry(key, e));
+      m_index.insert(typename index_type::value_type(key, m_entries.begin()));
+      while(m_entries.size() > m_capacity)
+        pop_oldest();
+    };
+    
+    void clear() {
+      ReaKaux::unique_lock< ReaKaux::mutex > lock_here(m_access_mutex);
+      m_entries.clear();
+      m_index.clear();
+      m_hits = 0;
+      m_misses = 0;
+      m_validations = 0;
+      m_checks = 0;
+    };
+    
+    void add_validation(std::size_t aCheckCount) {
+      ReaKaux::unique_lock< ReaKaux::mutex > lock_here(m_access_mutex);
+      ++m_validations;
+      m_checks += aCheckCount;
+    };
+    
+    void set_capacity(std::size_t aCapacity) {
+      ReaKaux::unique_lock< ReaKaux::mutex > lock_here(m_access_mutex);
+      m_capacity = aCapacity;
+      while(m_entries.size() > m_capacity)
+        pop_oldest();
+    };
+    
+    std::size_t get_capacity() const { 
+      ReaKaux::unique_lock< ReaKaux::mutex > lock_here(m_access_mutex);
+      return m_capacity; 
+    };
+    std::size_t get_size() const { 
+      ReaKaux::unique_lock< ReaKaux::mutex > lock_here(m_access_mutex);
+      return m_entries.size(); 
+    };
+    std::size_t get_hit_count() const { 
+      ReaKaux::unique_lock< ReaKaux::mutex > lock_here(m_access_mutex);
+      return m_hits; 
+    };
+    std::size_t get_miss_count() const { 
+      ReaKaux::unique_lock< ReaKaux::mutex > lock_here(m_access_mutex);
+      return m_misses; 
+    };
+    std::size_t get_validation_count() const { 
+      ReaKaux::unique_lock< ReaKaux::mutex > lock_here(m_access_mutex);
+      return m_validations; 
+    };
+    std::size_t get_check_count() const { 
+      ReaKaux::unique_lock< ReaKaux::mutex > lock_here(m_access_mutex);
+      return m_checks; 
+    };
+    
+};
+
+
+/* 
+ * Fills in the sample indices 1..aCount in hierarchical bisection (van der Corput) order, i.e., 
+ * the middle sample first, then the quarter samples, and so on. 
+ */
+inline void get_bisection_order(std::size_t aCount, std::vector< std::size_t >& aOrder) {
+  aOrder.clear();
+  aOrder.reserve(aCount);
+  std::size_t n2 = 1;
+  unsigned int bits = 0;
+  while(n2 < aCount + 1) {
+    n2 <<= 1;
+    ++bits;
+  };
+  std::vector< bool > visited(aCount + 2, false);
+  for(std::size_t i = 1; i < n2; ++i) {
+    // bit-reversal of i gives the dyadic fraction r / n2 in van der Corput order.
+    std::size_t r = 0;
+    for(unsigned int b = 0; b < bits; ++b)
+      if(i & (std::size_t(1) << b))
+        r |= (std::size_t(1) << (bits - 1 - b));
+    std::size_t k = (r * (aCount + 1) + n2 / 2) / n2;
+    if(!visited[k]) {
+      visited[k] = true;
+      aOrder.push_back(k);
+    };
+  };
+};
+
+
+/* 
+ * This functor checks a subset of the samples of an edge (every aStride-th sample of the 
+ * bisection order, starting at aFirst) on a given environment, and stops as soon as 
+ * any worker has found a collision. The interpolator of the edge is initialized once, and 
+ * the flag shared with the other workers is only looked at between batches of samples. 
+ */
+template <typename Environment>
+struct manip_edge_validation_worker {
+  BOOST_STATIC_CONSTANT(std::size_t, batch_size = 8);
+  
+  typedef typename Environment::point_type point_type;
+  
+  const Environment* p_env;
+  const point_type* p1;
+  const point_type* p2;
+  const std::vector< std::size_t >* order;
+  std::size_t first;
+  std::size_t stride;
+  bool* blocked;
+  ReaKaux::mutex* blocked_mutex;
+  std::size_t* check_count;
+  
+  manip_edge_validation_worker(const Environment* aEnv, const point_type* aP1, const point_type* aP2, 
+                               const std::vector< std::size_t >* aOrder, std::size_t aFirst, std::size_t aStride,
+                               bool* aBlocked, ReaKaux::mutex* aBlockedMutex, std::size_t* aCheckCount) :
+                               p_env(aEnv), p1(aP1), p2(aP2), order(aOrder), first(aFirst), stride(aStride),
+                               blocked(aBlocked), blocked_mutex(aBlockedMutex), check_count(aCheckCount) { };
+  
+  void operator()() {
+    *check_count = 0;
+    typename Environment::edge_sampler sampler(p_env, *p1, *p2);
+    std::size_t i = first;
+    while(i < order->size()) {
+      {
+        ReaKaux::unique_lock< ReaKaux::mutex > lock_here(*blocked_mutex);
+        if(*blocked)
+          return;
+      };
+      for(std::size_t j = 0; (j < batch_size) && (i < order->size()); ++j, i += stride) {
+        ++(*check_count);
+        if(!sampler.is_sample_free((*order)[i])) {
+          ReaKaux::unique_lock< ReaKaux::mutex > lock_here(*blocked_mutex);
+          *blocked = true;
+          return;
+        };
+      };
+    };
+  };
 };
 
 };
@@ -127,6 +454,7 @@ class manip_quasi_static_env : public named_object {
   private:
     double min_interval;
     double max_edge_length;
+    double max_motion_speed;
     
     super_space_type m_space;
     typename metric_space_traits<super_space_type>::distance_metric_type m_distance;
@@ -134,6 +462,135 @@ class manip_quasi_static_env : public named_object {
     
     detail::manip_dk_proxy_env_impl m_prox_env;
     
+    typedef detail::manip_edge_result_cache< point_type > edge_cache_type;
+    shared_ptr< edge_cache_type > m_edge_cache;
+    bool m_unchecked_metric;
+    bool m_bisection_validation;
+    
+    template <typename Environment>
+    friend struct detail::manip_edge_validation_worker;
+    
+    struct point_equal_pred {
+      const self* p_env;
+      explicit point_equal_pred(const self* aEnv) : p_env(aEnv) { };
+      bool operator()(const point_type& a, const point_type& b) const {
+        return (p_env->m_distance(a, b, p_env->m_space) < std::numeric_limits< double >::epsilon());
+      };
+    };
+    
+    point_type move_position_toward_impl(const point_type& p1, double fraction, const point_type& p2) const {
+      typedef typename get_tagged_spatial_interpolator< InterpMethodTag, RateLimitedJointSpace, time_topology>::type InterpType;
+      typedef typename get_tagged_spatial_interpolator< InterpMethodTag, RateLimitedJointSpace, time_topology>::pseudo_factory_type InterpFactoryType;
+      
+      InterpType interp;
+      double dt_min = m_distance(p1, p2, m_space);
+      interp.initialize(p1, p2, dt_min, m_space, time_topology(), InterpFactoryType());
+      double dt = dt_min * fraction;
+      dt = (dt < max_edge_length ? dt : max_edge_length);
+      point_type result = p1;
+      point_type last_result = p1;
+      std::size_t check_count = 0;
+      if(max_motion_speed > 0.0) {
+        // conservative advancement: no point of the manipulator can travel further than the 
+        // current clearance within clearance / max_motion_speed, so that interval is collision-free.
+        double d = 0.0;
+        while(true) {
+          // both sides of a self-collision pair can move, so they close in at up to twice the speed.
+          double clearance = m_prox_env.get_clearance(result, m_space, 2.0);
+          ++check_count;
+          if(clearance < 0.0) {
+            m_edge_cache->add_validation(check_count);
+            return last_result;
+          };
+          last_result = result;
+          double d_safe = clearance / max_motion_speed;
+          if(d_safe < 1e-3 * min_interval) { // too close to an obstacle, stop here to remain conservative.
+            m_edge_cache->add_validation(check_count);
+            return last_result;
+          };
+          d += d_safe;
+          if(d >= dt)
+            break;
+          interp.compute_point(result, p1, p2, m_space, time_topology(), d, dt_min, InterpFactoryType());
+        };
+      } else {
+        double d = min_interval;
+        while(d < dt) {
+          interp.compute_point(result, p1, p2, m_space, time_topology(), d, dt_min, InterpFactoryType());
+          ++check_count;
+          if(!m_prox_env.is_free(result, m_space)) {
+            m_edge_cache->add_validation(check_count);
+            return last_result;
+          };
+          d += min_interval;
+          last_result = result;
+        };
+      };
+      m_edge_cache->add_validation(check_count);
+      if((fraction == 1.0) && (dt_min < max_edge_length)) //these equal comparison are used for when exact end fractions are used.
+        return p2;
+      else if(fraction == 0.0)
+        return p1;
+      else {
+        interp.compute_point(result, p1, p2, m_space, time_topology(), dt, dt_min, InterpFactoryType());
+        return result;
+      };
+    };
+    
+    /* Checks the samples (at multiples of min_interval) of the motion from p1 to p2, with an interpolator initialized once for the edge. */
+    class edge_sampler {
+      private:
+        typedef typename get_tagged_spatial_interpolator< InterpMethodTag, RateLimitedJointSpace, time_topology>::type InterpType;
+        typedef typename get_tagged_spatial_interpolator< InterpMethodTag, RateLimitedJointSpace, time_topology>::pseudo_factory_type InterpFactoryType;
+        
+        const self* p_env;
+        const point_type* p1;
+        const point_type* p2;
+        InterpType interp;
+        double dt_min;
+        point_type result;
+        
+      public:
+        edge_sampler(const self* aEnv, const point_type& aP1, const point_type& aP2) : 
+                     p_env(aEnv), p1(&aP1), p2(&aP2), interp(), 
+                     dt_min(aEnv->m_distance(aP1, aP2, aEnv->m_space)), result(aP1) {
+          interp.initialize(*p1, *p2, dt_min, p_env->m_space, time_topology(), InterpFactoryType());
+        };
+        
+        /* Checks if the aIndex-th sample (at aIndex * min_interval) of the motion is collision-free. */
+        bool is_sample_free(std::size_t aIndex) {
+          interp.compute_point(result, *p1, *p2, p_env->m_space, time_topology(), aIndex * p_env->min_interval, dt_min, InterpFactoryType());
+          return p_env->m_prox_env.is_free(result, p_env->m_space);
+        };
+    };
+    friend class edge_sampler;
+    
+    /* Returns the number of intermediate samples checked along the (complete) motion from p1 to p2. */
+    std::size_t get_edge_sample_count(const point_type& p1, const point_type& p2) const {
+      double dt = m_distance(p1, p2, m_space);
+      dt = (dt < max_edge_length ? dt : max_edge_length);
+      std::size_t result = 0;
+      for(double d = min_interval; d < dt; d += min_interval)
+        ++result;
+      return result;
+    };
+    
+    /* Checks if the complete motion from p1 to p2 is collision-free, visiting the samples in bisection order. */
+    bool is_edge_free_bisection(const point_type& p1, const point_type& p2) const {
+      std::vector< std::size_t > order;
+      detail::get_bisection_order(get_edge_sample_count(p1, p2), order);
+      
+      edge_sampler sampler(this, p1, p2);
+      for(std::size_t i = 0; i < order.size(); ++i) {
+        if(!sampler.is_sample_free(order[i])) {
+          m_edge_cache->add_validation(i + 1);
+          return false;
+        };
+      };
+      m_edge_cache->add_validation(order.size());
+      return true;
+    };
+    
   public:
     
     /**
@@ -178,6 +635,27 @@ class manip_quasi_static_env : public named_object {
      * \return The collision-free distance between the two given points.
      */
     double distance(const point_type& p1, const point_type& p2) const {
+      if(m_unchecked_metric)
+        return m_distance(p1, p2, m_space); //collision-checks are deferred to move_position_toward.
+      if(m_bisection_validation && (max_motion_speed <= 0.0)) {
+        // only the validity of the edge is needed here, so the fail-fast bisection order can be used.
+        double dt_min = m_distance(p1, p2, m_space);
+        if(dt_min >= max_edge_length)
+          return std::numeric_limits<double>::infinity(); //p2 is too far to be reached from p1 in one edge.
+        typename edge_cache_type::entry e;
+        if(!m_edge_cache->find(p1, p2, point_equal_pred(this), e)) {
+          e.p1 = p1;
+          e.p2 = p2;
+          e.is_free = is_edge_free_bisection(p1, p2);
+          e.reached = p2;
+          e.has_reached = e.is_free;
+          m_edge_cache->insert(e, point_equal_pred(this));
+        };
+        if(e.is_free)
+          return dt_min;
+        else
+          return std::numeric_limits<double>::infinity(); //p2 is not reachable from p1.
+      };
       if(m_distance(p2, move_position_toward(p1, 1.0, p2), m_space) < std::numeric_limits< double >::epsilon())
         return m_distance(p1, p2, m_space); //if p2 is reachable from p1, use Euclidean distance.
       else
@@ -219,32 +697,20 @@ class manip_quasi_static_env : public named_object {
      * far as it can get before a collision.
      */
     point_type move_position_toward(const point_type& p1, double fraction, const point_type& p2) const {
-      typedef typename get_tagged_spatial_interpolator< InterpMethodTag, RateLimitedJointSpace, time_topology>::type InterpType;
-      typedef typename get_tagged_spatial_interpolator< InterpMethodTag, RateLimitedJointSpace, time_topology>::pseudo_factory_type InterpFactoryType;
+      if((fraction != 1.0) || (!m_edge_cache))
+        return move_position_toward_impl(p1, fraction, p2);
       
-      InterpType interp;
-      double dt_min = m_distance(p1, p2, m_space);
-      interp.initialize(p1, p2, dt_min, m_space, time_topology(), InterpFactoryType());
-      double dt = dt_min * fraction;
-      dt = (dt < max_edge_length ? dt : max_edge_length);
-      double d = min_interval;
-      point_type result = p1;
-      point_type last_result = p1;
-      while(d < dt) {
-        interp.compute_point(result, p1, p2, m_space, time_topology(), d, dt_min, InterpFactoryType());
-        if(!m_prox_env.is_free(result, m_space))
-          return last_result;
-        d += min_interval;
-        last_result = result;
-      };
-      if((fraction == 1.0) && (dt_min < max_edge_length)) //these equal comparison are used for when exact end fractions are used.
-        return p2;
-      else if(fraction == 0.0)
-        return p1;
-      else {
-        interp.compute_point(result, p1, p2, m_space, time_topology(), dt, dt_min, InterpFactoryType());
-        return result;
-      };
+      typename edge_cache_type::entry e;
+      if(m_edge_cache->find(p1, p2, point_equal_pred(this), e) && e.has_reached)
+        return e.reached;
+      
+      e.p1 = p1;
+      e.p2 = p2;
+      e.reached = move_position_toward_impl(p1, 1.0, p2);
+      e.is_free = (m_distance(p2, e.reached, m_space) < std::numeric_limits< double >::epsilon());
+      e.has_reached = true;
+      m_edge_cache->insert(e, point_equal_pred(this));
+      return e.reached;
     };
     
     /**
@@ -270,21 +736,267 @@ class manip_quasi_static_env : public named_object {
     /**
      * Parametrized constructor (this class is a RAII class).
      * \param aMaxEdgeLength The maximum length of an added edge, in time units (e.g., seconds).
+     * \param aMaxMotionSpeed An upper-bound on the speed of any point of the manipulator's geometry 
+     *                        along the interpolated motions (with the joints at their rate limits), 
+     *                        which enables the conservative-advancement validation of the motions 
+     *                        (if zero, motions are validated by sampling them at aMinInterval). 
+     *                        See set_max_motion_speed_from_limits to derive it from the joint rate limits.
      */
     manip_quasi_static_env(const super_space_type& aSpace = super_space_type(),
                            const shared_ptr< kte::direct_kinematics_model >& aModel = shared_ptr< kte::direct_kinematics_model >(),
                            const shared_ptr< joint_limits_collection<double> >& aJointLimitsMap = shared_ptr< joint_limits_collection<double> >(),
                            double aMinInterval = 0.1, 
-                           double aMaxEdgeLength = 1.0) : 
+                           double aMaxEdgeLength = 1.0,
+                           double aMaxMotionSpeed = 0.0) : 
                            min_interval(aMinInterval),
                            max_edge_length(aMaxEdgeLength),
+                           max_motion_speed(aMaxMotionSpeed),
                            m_space(aSpace),
                            m_distance(get(distance_metric, m_space)),
                            m_rand_sampler(get(random_sampler, m_space)), 
-                           m_prox_env(aModel, aJointLimitsMap) { };
+                           m_prox_env(aModel, aJointLimitsMap),
+                           m_edge_cache(new edge_cache_type()),
+                           m_unchecked_metric(false),
+                           m_bisection_validation(false) { };
+    
+    /**
+     * Copy-constructor, the copy gets its own (empty) edge-validation cache, with the same capacity.
+     */
+    manip_quasi_static_env(const self& rhs) : 
+                           named_object(rhs),
+                           min_interval(rhs.min_interval),
+                           max_edge_length(rhs.max_edge_length),
+                           max_motion_speed(rhs.max_motion_speed),
+                           m_space(rhs.m_space),
+                           m_distance(rhs.m_distance),
+                           m_rand_sampler(rhs.m_rand_sampler), 
+                           m_prox_env(rhs.m_prox_env),
+                           m_edge_cache(new edge_cache_type(rhs.m_edge_cache->get_capacity())),
+                           m_unchecked_metric(rhs.m_unchecked_metric),
+                           m_bisection_validation(rhs.m_bisection_validation) { };
+    
+    /**
+     * Assignment operator, this environment keeps its own edge-validation cache, which is cleared.
+     */
+    self& operator=(const self& rhs) {
+      if(this == &rhs)
+        return *this;
+      named_object::operator=(rhs);
+      min_interval = rhs.min_interval;
+      max_edge_length = rhs.max_edge_length;
+      max_motion_speed = rhs.max_motion_speed;
+      m_space = rhs.m_space;
+      m_distance = rhs.m_distance;
+      m_rand_sampler = rhs.m_rand_sampler;
+      m_prox_env = rhs.m_prox_env;
+      m_edge_cache->clear();
+      m_edge_cache->set_capacity(rhs.m_edge_cache->get_capacity());
+      m_unchecked_metric = rhs.m_unchecked_metric;
+      m_bisection_validation = rhs.m_bisection_validation;
+      return *this;
+    };
     
     virtual ~manip_quasi_static_env() { };
     
+    /**
+     * Sets the maximum number of edge-validation results kept in the cache (least-recently used 
+     * results are evicted first). A capacity of zero disables the caching.
+     * \param aCapacity The new capacity of the edge-validation cache.
+     */
+    void set_edge_cache_capacity(std::size_t aCapacity) { m_edge_cache->set_capacity(aCapacity); };
+    
+    /**
+     * Returns the maximum number of edge-validation results kept in the cache.
+     * \return The capacity of the edge-validation cache.
+     */
+    std::size_t get_edge_cache_capacity() const { return m_edge_cache->get_capacity(); };
+    
+    /**
+     * Clears the edge-validation cache (and its hit / miss counters), e.g., after the environment 
+     * has changed.
+     */
+    void clear_edge_cache() { m_edge_cache->clear(); };
+    
+    /**
+     * Returns the number of edge validations that were found in the cache.
+     * \return The number of edge-validation cache hits.
+     */
+    std::size_t get_edge_cache_hits() const { return m_edge_cache->get_hit_count(); };
+    
+    /**
+     * Returns the number of edge validations that had to be computed (not found in the cache).
+     * \return The number of edge-validation cache misses.
+     */
+    std::size_t get_edge_cache_misses() const { return m_edge_cache->get_miss_count(); };
+    
+    /**
+     * Returns the number of edge-validation results currently kept in the cache.
+     * \return The number of entries in the edge-validation cache.
+     */
+    std::size_t get_edge_cache_size() const { return m_edge_cache->get_size(); };
+    
+    /**
+     * Sets the upper-bound on the speed of any point of the manipulator's geometry along the interpolated 
+     * motions, which enables the conservative-advancement validation of the motions (if zero, motions 
+     * are validated by sampling them at the min-interval).
+     * \param aMaxMotionSpeed The upper-bound on the speed of the manipulator's geometry.
+     */
+    void set_max_motion_speed(double aMaxMotionSpeed) { 
+      max_motion_speed = aMaxMotionSpeed; 
+      m_edge_cache->clear();
+    };
+    
+    /**
+     * Sets the upper-bound on the speed of the manipulator's geometry from the joint rate limits 
+     * (see the joint limits collection given to the constructor). The kinematic model does not 
+     * expose the extent of the geometry, so the largest distance from any joint to any point of the 
+     * geometry that it moves must be given. The bound is the sum, over the joints, of the linear speed 
+     * limits and of the angular speed limits times that reach (generalized coordinates are taken 
+     * as either, whichever is larger). This assumes that the interpolated motions do not exceed the 
+     * joint rate limits, which is the case for motions in the rate-limited space.
+     * \param aMaxReach The largest distance from a joint to a point of the manipulator's geometry.
+     */
+    void set_max_motion_speed_from_limits(double aMaxReach) { 
+      set_max_motion_speed(m_prox_env.get_max_motion_speed(aMaxReach));
+    };
+    
+    /**
+     * Returns the upper-bound on the speed of the manipulator's geometry used for the 
+     * conservative-advancement validation of the motions (zero if motions are sampled instead).
+     * \return The upper-bound on the speed of the manipulator's geometry.
+     */
+    double get_max_motion_speed() const { return max_motion_speed; };
+    
+    /**
+     * Sets whether the distance function is the unchecked metric of the super-space, i.e., 
+     * without checking that the motion between the points is collision-free. This is useful 
+     * for nearest-neighbor searches, deferring the collision checks to the moment an edge is 
+     * actually added (through move_position_toward).
+     * \param aUnchecked True to use the unchecked metric in the distance function.
+     */
+    void set_unchecked_metric(bool aUnchecked) { m_unchecked_metric = aUnchecked; };
+    
+    /**
+     * Returns true if the distance function is the unchecked metric of the super-space.
+     * \return True if the distance function is the unchecked metric of the super-space.
+     */
+    bool is_unchecked_metric() const { return m_unchecked_metric; };
+    
+    /**
+     * Sets whether the validity of complete motions (as needed by the distance function) is checked 
+     * by visiting the samples in hierarchical bisection (van der Corput) order, stopping at the 
+     * first collision. Blocked motions are usually rejected after a few checks, instead of after 
+     * all the checks that precede the collision. This does not affect move_position_toward, which 
+     * still returns the last collision-free point along the motion. The specializations for the 
+     * reach-time interpolators (SAP and SVP, see manip_free_workspace_tsppf.hpp) do not have this 
+     * option, they always check the samples in order.
+     * \param aBisection True to use bisection-ordered validation of motions.
+     */
+    void set_bisection_validation(bool aBisection) { m_bisection_validation = aBisection; };
+    
+    /**
+     * Returns true if the validity of complete motions is checked in bisection order.
+     * \return True if the validity of complete motions is checked in bisection order.
+     */
+    bool is_bisection_validation() const { return m_bisection_validation; };
+    
+    /**
+     * Returns the number of motion validations performed so far (i.e., excluding cache hits).
+     * \return The number of motion validations.
+     */
+    std::size_t get_edge_validation_count() const { return m_edge_cache->get_validation_count(); };
+    
+    /**
+     * Returns the number of collision checks (or clearance evaluations) performed so far by the 
+     * motion validations.
+     * \return The number of collision checks.
+     */
+    std::size_t get_edge_check_count() const { return m_edge_cache->get_check_count(); };
+    
+    /**
+     * Checks if the complete motion from p1 to p2 is collision-free, by distributing its samples 
+     * (in bisection order) over several threads. Because the kinematic model and proximity queries 
+     * are stateful, each additional thread must work with its own copy of this environment 
+     * (same space and parameters, but its own kinematic model and proxy query pairs). Each thread 
+     * initializes the interpolator of the motion once, and checks its samples in batches, only 
+     * synchronizing with the other threads (to stop at the first collision found) between batches.
+     * \param p1 The start point of the motion.
+     * \param p2 The end point of the motion.
+     * \param aWorkerEnvs The environments used by the additional threads (one thread per environment).
+     * \return True if the motion from p1 to p2 is collision-free.
+     */
+    bool is_edge_free_parallel(const point_type& p1, const point_type& p2, 
+                               const std::vector< shared_ptr< self > >& aWorkerEnvs) const {
+      if(m_distance(p1, p2, m_space) >= max_edge_length)
+        return false;
+      
+      std::vector< std::size_t > order;
+      detail::get_bisection_order(get_edge_sample_count(p1, p2), order);
+      
+      std::size_t stride = aWorkerEnvs.size() + 1;
+      bool blocked = false;
+      ReaKaux::mutex blocked_mutex;
+      std::vector< std::size_t > check_counts(stride, 0);
+      
+      std::vector< shared_ptr< ReaKaux::thread > > threads;
+      for(std::size_t i = 0; i < aWorkerEnvs.size(); ++i)
+        threads.push_back(shared_ptr< ReaKaux::thread >(new ReaKaux::thread(
+          detail::manip_edge_validation_worker< self >(aWorkerEnvs[i].get(), &p1, &p2, &order, i + 1, stride, 
+                                                       &blocked, &blocked_mutex, &check_counts[i + 1]))));
+      detail::manip_edge_validation_worker< self >(this, &p1, &p2, &order, 0, stride, 
+                                                   &blocked, &blocked_mutex, &check_counts[0])();
+      for(std::size_t i = 0; i < threads.size(); ++i)
+        threads[i]->join();
+      
+      std::size_t total_checks = 0;
+      for(std::size_t i = 0; i < check_counts.size(); ++i)
+        total_checks += check_counts[i];
+      m_edge_cache->add_validation(total_checks);
+      
+      return !blocked;
+    };
+    
+    /**
+     * Computes the clearance of the motion from p1 to p2, i.e., the minimum distance between the 
+     * manipulator and the obstacles (as reported by the proximity models) over the samples of the 
+     * motion (at every min-interval, and at its end-points). Obstacles that move by less than this 
+     * clearance cannot intersect the volume swept by the manipulator along the motion, which is 
+     * used to only re-validate the motions that are affected by moving obstacles.
+     * \note This is the clearance at the samples of the motion, which over-estimates the clearance of 
+     *       the swept volume by up to the workspace motion of the manipulator over one min-interval.
+     * \param p1 The start point of the motion.
+     * \param p2 The end point of the motion.
+     * \return The clearance of the motion, negative if the motion is not collision-free.
+     */
+    double get_motion_clearance(const point_type& p1, const point_type& p2) const {
+      typedef typename get_tagged_spatial_interpolator< InterpMethodTag, RateLimitedJointSpace, time_topology>::type InterpType;
+      typedef typename get_tagged_spatial_interpolator< InterpMethodTag, RateLimitedJointSpace, time_topology>::pseudo_factory_type InterpFactoryType;
+      
+      double result = m_prox_env.get_clearance(p1, m_space);
+      std::size_t check_count = 1;
+      if(result >= 0.0) {
+        InterpType interp;
+        double dt_min = m_distance(p1, p2, m_space);
+        interp.initialize(p1, p2, dt_min, m_space, time_topology(), InterpFactoryType());
+        point_type p = p1;
+        for(double d = min_interval; (d < dt_min) && (result >= 0.0); d += min_interval) {
+          interp.compute_point(p, p1, p2, m_space, time_topology(), d, dt_min, InterpFactoryType());
+          double clearance = m_prox_env.get_clearance(p, m_space);
+          ++check_count;
+          if(clearance < result)
+            result = clearance;
+        };
+        if(result >= 0.0) {
+          double clearance = m_prox_env.get_clearance(p2, m_space);
+          ++check_count;
+          if(clearance < result)
+            result = clearance;
+        };
+      };
+      m_edge_cache->add_validation(check_count);
+      return result;
+    };
+    
     /**
      * Add a 2D proxy query pair to the collision environment.
      * \param aProxy The new 2D proxy query pair to add to the collision environment.
@@ -292,6 +1004,7 @@ class manip_quasi_static_env : public named_object {
      */
     self& operator<<(const shared_ptr< geom::proxy_query_pair_2D >& aProxy) {
       m_prox_env.m_proxy_env_2D.push_back(aProxy);
+      m_edge_cache->clear(); // cached edge results are no longer valid with the new obstacle.
       return *this;
     };
     
@@ -302,9 +1015,32 @@ class manip_quasi_static_env : public named_object {
      */
     self& operator<<(const shared_ptr< geom::proxy_query_pair_3D >& aProxy) {
       m_prox_env.m_proxy_env_3D.push_back(aProxy);
+      m_edge_cache->clear(); // cached edge results are no longer valid with the new obstacle.
       return *this;
     };
     
+    /**
+     * Add a 2D proxy query pair between two parts of the manipulator (self-collision) to the collision 
+     * environment. Because both sides of such a pair move, the conservative-advancement validation 
+     * assumes they close in at twice the maximum motion speed.
+     * \param aProxy The new 2D self-collision proxy query pair.
+     */
+    void add_self_collision_pair(const shared_ptr< geom::proxy_query_pair_2D >& aProxy) {
+      m_prox_env.m_self_proxy_env_2D.push_back(aProxy);
+      m_edge_cache->clear();
+    };
+    
+    /**
+     * Add a 3D proxy query pair between two parts of the manipulator (self-collision) to the collision 
+     * environment. Because both sides of such a pair move, the conservative-advancement validation 
+     * assumes they close in at twice the maximum motion speed.
+     * \param aProxy The new 3D self-collision proxy query pair.
+     */
+    void add_self_collision_pair(const shared_ptr< geom::proxy_query_pair_3D >& aProxy) {
+      m_prox_env.m_self_proxy_env_3D.push_back(aProxy);
+      m_edge_cache->clear();
+    };
+    
 /*******************************************************************************
                    ReaK's RTTI and Serialization interfaces
 *******************************************************************************/
@@ -319,10 +1055,13 @@ class manip_quasi_static_env : public named_object {
         & RK_SERIAL_SAVE_WITH_NAME(m_prox_env.m_model)
         & RK_SERIAL_SAVE_WITH_NAME(m_prox_env.m_joint_limits_map)
         & RK_SERIAL_SAVE_WITH_NAME(m_prox_env.m_proxy_env_2D)
-        & RK_SERIAL_SAVE_WITH_NAME(m_prox_env.m_proxy_env_3D);
+        & RK_SERIAL_SAVE_WITH_NAME(m_prox_env.m_proxy_env_3D)
+        & RK_SERIAL_SAVE_WITH_NAME(max_motion_speed)
+        & RK_SERIAL_SAVE_WITH_NAME(m_prox_env.m_self_proxy_env_2D)
+        & RK_SERIAL_SAVE_WITH_NAME(m_prox_env.m_self_proxy_env_3D);
     };
     
-    virtual void RK_CALL load(serialization::iarchive& A, unsigned int) {
+    virtual void RK_CALL load(serialization::iarchive& A, unsigned int Version) {
       ReaK::named_object::load(A,named_object::getStaticObjectType()->TypeVersion());
       A & RK_SERIAL_LOAD_WITH_NAME(min_interval)
         & RK_SERIAL_LOAD_WITH_NAME(max_edge_length)
@@ -333,14 +1072,36 @@ class manip_quasi_static_env : public named_object {
         & RK_SERIAL_LOAD_WITH_NAME(m_prox_env.m_joint_limits_map)
         & RK_SERIAL_LOAD_WITH_NAME(m_prox_env.m_proxy_env_2D)
         & RK_SERIAL_LOAD_WITH_NAME(m_prox_env.m_proxy_env_3D);
+      // version 1 archives pre-date the conservative-advancement validation.
+      max_motion_speed = 0.0;
+      if(Version >= 2)
+        A & RK_SERIAL_LOAD_WITH_NAME(max_motion_speed);
+      // version 2 archives pre-date the self-collision pairs.
+      m_prox_env.m_self_proxy_env_2D.clear();
+      m_prox_env.m_self_proxy_env_3D.clear();
+      if(Version >= 3)
+        A & RK_SERIAL_LOAD_WITH_NAME(m_prox_env.m_self_proxy_env_2D)
+          & RK_SERIAL_LOAD_WITH_NAME(m_prox_env.m_self_proxy_env_3D);
+      m_edge_cache->clear();
     };
     
-    RK_RTTI_MAKE_CONCRETE_1BASE(self,0xC2400027,1,"manip_quasi_static_env",named_object)
+    RK_RTTI_MAKE_CONCRETE_1BASE(self,0xC2400027,3,"manip_quasi_static_env",named_object)
     
     
 };
 
 
+/**
+ * Returns the clearance of the motion from p1 to p2 in a manipulator's quasi-static environment, 
+ * see manip_quasi_static_env::get_motion_clearance.
+ */
+template <typename RateLimitedJointSpace, typename InterpMethodTag>
+double get_motion_clearance(const manip_quasi_static_env<RateLimitedJointSpace, InterpMethodTag>& space, 
+                            const typename manip_quasi_static_env<RateLimitedJointSpace, InterpMethodTag>::point_type& p1, 
+                            const typename manip_quasi_static_env<RateLimitedJointSpace, InterpMethodTag>::point_type& p2) {
+  return space.get_motion_clearance(p1, p2);
+};
+
 template <typename RateLimitedJointSpace, typename InterpMethodTag>
 struct is_metric_space< manip_quasi_static_env<RateLimitedJointSpace, InterpMethodTag> > : boost::mpl::true_ { };
 
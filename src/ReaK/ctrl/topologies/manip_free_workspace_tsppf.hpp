@@ -27,6 +27,11 @@
 
 #ifdef RK_GENERATE_MQSENV_REACHINTERP
 
+/*
+ * Specialization for the reach-time interpolators (SAP / SVP). Unlike the general environment, 
+ * motions are always checked sample by sample from the start (there is no bisection-ordered 
+ * validation, edge-result cache or parallel edge validation for these).
+ */
 template <typename RateLimitedJointSpace>
 class manip_quasi_static_env<RateLimitedJointSpace, RK_REACHINTERP_TAG> : public named_object {
   public:
@@ -196,6 +201,10 @@ class manip_quasi_static_env<RateLimitedJointSpace, RK_REACHINTERP_TAG> : public
 #ifdef RK_GENERATE_MDENV_REACHINTERP
 
 
+/*
+ * Specialization for the reach-time interpolators (SAP / SVP). As for the quasi-static one above, 
+ * motions are always checked sample by sample from the start (no bisection-ordered validation).
+ */
 template <typename RateLimitedJointSpace>
 class manip_dynamic_env<RateLimitedJointSpace, RK_REACHINTERP_TAG> : public named_object {
   public:
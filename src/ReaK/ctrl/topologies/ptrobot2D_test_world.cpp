@@ -33,6 +33,13 @@
 #endif
 
 #include <string>
+#include <vector>
+#include <fstream>
+#include <iterator>
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <boost/cstdint.hpp>
 
 #include "path_planning/global_rng.hpp"
 
@@ -41,6 +48,43 @@ namespace ReaK {
 namespace pp {
 
 
+namespace {
+
+bool has_file_extension(const std::string& aFileName, const std::string& aExt) {
+  if(aFileName.length() < aExt.length())
+    return false;
+  for(std::size_t i = 0; i < aExt.length(); ++i)
+    if(std::tolower(static_cast<unsigned char>(aFileName[aFileName.length() - aExt.length() + i])) != aExt[i])
+      return false;
+  return true;
+};
+
+unsigned int read_little_endian(const unsigned char* p, int aByteCount) {
+  unsigned int result = 0;
+  for(int i = aByteCount - 1; i >= 0; --i)
+    result = (result << 8) | p[i];
+  return result;
+};
+
+int read_pbm_header_value(std::istream& in) {
+  // skip the white-spaces and the comments (from '#' to the end of the line).
+  char c;
+  while(in.get(c)) {
+    if(c == '#') {
+      while(in.get(c) && (c != '\n')) ;
+    } else if(!std::isspace(static_cast<unsigned char>(c))) {
+      in.putback(c);
+      break;
+    };
+  };
+  int result = -1;
+  in >> result;
+  return result;
+};
+
+};
+
+
 class ptrobot2D_test_world_impl {
 #ifdef REAK_HAS_OPENCV
   private:
@@ -48,6 +92,183 @@ class ptrobot2D_test_world_impl {
     mutable cv::Mat world_map_output;
     int bpp;
 #endif
+  private:
+    /*
+     * The occupancy grid is stored one bit per pixel (set if the pixel is free), packed in 64-bit words,
+     * and each row starts on a new word. The clearance grid is the Euclidean distance transform of the
+     * occupancy grid, i.e., the distance (in pixels, rounded down, and saturated at 255) from each pixel
+     * to the nearest occupied pixel, where all pixels outside the grid are occupied.
+     */
+    std::vector< boost::uint64_t > free_bits;
+    std::size_t words_per_row;
+    std::vector< unsigned char > clearance;
+
+    void resize_grid(int aWidth, int aHeight) {
+      grid_width = aWidth;
+      grid_height = aHeight;
+      words_per_row = (std::size_t(grid_width) + 63) / 64;
+      free_bits.assign(words_per_row * grid_height, 0);
+      start_pos = ptrobot2D_test_world::point_type(1.0,1.0);
+      goal_pos  = ptrobot2D_test_world::point_type(grid_width - 2.0, grid_height - 2.0);
+    };
+
+    void set_pixel_free(int x, int y) {
+      free_bits[y * words_per_row + (x >> 6)] |= (boost::uint64_t(1) << (x & 63));
+    };
+
+    bool is_pixel_free(int x, int y) const {
+      return (free_bits[y * words_per_row + (x >> 6)] >> (x & 63)) & 1;
+    };
+
+    /*
+     * Parses a row of an (BGR) color image, any non-white gray-scaled pixel is occupied, a pure blue pixel
+     * is the start position and a pure green pixel is the goal position.
+     */
+    void parse_color_row(const unsigned char* color_bits, int y, int aBytesPerPixel) {
+      for(int x = 0; x < grid_width; ++x) {
+        if( (color_bits[2] == 0) &&
+            (color_bits[0] == 255) &&
+            (color_bits[1] == 0) ) {
+          //this is the start position.
+          start_pos[0] = x;
+          start_pos[1] = y;
+        } else if( (color_bits[2] == 0) &&
+                   (color_bits[0] == 0) &&
+                   (color_bits[1] == 255) ) {
+          //this is the goal position.
+          goal_pos[0] = x;
+          goal_pos[1] = y;
+        };
+        if( (color_bits[1] >= 250) ||
+            (color_bits[2] >= 250) ||
+            (color_bits[0] >= 250) )
+          set_pixel_free(x, y);
+        color_bits += aBytesPerPixel;
+      };
+    };
+
+    /*
+     * Loads an uncompressed 24 or 32 bits bitmap (BMP) image, which is the format of the
+     * test-worlds, such that they can be loaded without OpenCV.
+     */
+    void load_bmp(const std::string& aFileName) {
+      std::ifstream in(aFileName.c_str(), std::ios::in | std::ios::binary);
+      std::vector<unsigned char> data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+      if((data.size() < 54) || (data[0] != 'B') || (data[1] != 'M'))
+        throw std::ios_base::failure("Could not open the world map image '" + aFileName + "'! File is missing, empty or invalid!");
+
+      std::size_t offset = read_little_endian(&data[10], 4);
+      int width          = int(read_little_endian(&data[18], 4));
+      int height         = int(read_little_endian(&data[22], 4));
+      unsigned int bits  = read_little_endian(&data[28], 2);
+      if(((bits != 24) && (bits != 32)) || (read_little_endian(&data[30], 4) != 0) || (width <= 0) || (height == 0))
+        throw std::ios_base::failure("The world map image '" + aFileName + "' is not an uncompressed 24 or 32 bits bitmap (other image formats require OpenCV)!");
+
+      bool bottom_up = (height > 0); // bitmap rows are stored bottom-up, unless the height is negative.
+      if(!bottom_up)
+        height = -height;
+      std::size_t row_size = ((bits * width + 31) / 32) * 4;
+      if(data.size() < offset + row_size * height)
+        throw std::ios_base::failure("Could not open the world map image '" + aFileName + "'! File is missing, empty or invalid!");
+
+      resize_grid(width, height);
+      for(int y = 0; y < grid_height; ++y)
+        parse_color_row(&data[offset + row_size * (bottom_up ? grid_height - 1 - y : y)], y, bits / 8);
+    };
+
+    /*
+     * Loads a raw binary occupancy grid, in the binary portable bitmap format (PBM, "P4"),
+     * i.e., a short text header with the width and height, followed by the rows of bits (8 pixels
+     * per byte, most significant bit first), where a set bit (black) is occupied.
+     */
+    void load_pbm(const std::string& aFileName) {
+      std::ifstream in(aFileName.c_str(), std::ios::in | std::ios::binary);
+      std::string magic_number;
+      in >> magic_number;
+      if(!in || (magic_number != "P4"))
+        throw std::ios_base::failure("Could not open the world map file '" + aFileName + "'! File is missing, empty or not a binary PBM (P4) file!");
+      int width = read_pbm_header_value(in);
+      int height = read_pbm_header_value(in);
+      in.get(); // the single white-space before the bits.
+      if(!in || (width <= 0) || (height <= 0))
+        throw std::ios_base::failure("Could not read the header of the world map file '" + aFileName + "'!");
+
+      resize_grid(width, height);
+      std::vector<char> row((grid_width + 7) / 8);
+      for(int y = 0; y < grid_height; ++y) {
+        if(!in.read(&row[0], row.size()))
+          throw std::ios_base::failure("The world map file '" + aFileName + "' is truncated!");
+        for(int x = 0; x < grid_width; ++x)
+          if(((row[x >> 3] >> (7 - (x & 7))) & 1) == 0)
+            set_pixel_free(x, y);
+      };
+    };
+
+    /*
+     * Computes the clearance grid with the linear-time distance transform of Felzenszwalb and
+     * Huttenlocher (2004): first the distance to the nearest occupied pixel in the same column,
+     * then, for each row, the lower envelope of the parabolas rooted at each pixel of the row.
+     * Because the clearance saturates at 255, the column distances can also saturate at 255.
+     */
+    void compute_clearance() {
+      const int max_clearance = 255;
+      const std::size_t w = grid_width;
+      clearance.assign(w * grid_height, 0);
+
+      // the column distances (the rows above and below the grid are occupied).
+      for(int y = 0; y < grid_height; ++y) {
+        unsigned char* c = &clearance[y * w];
+        const unsigned char* c_above = (y > 0 ? c - w : NULL);
+        for(int x = 0; x < grid_width; ++x)
+          if(is_pixel_free(x, y))
+            c[x] = (c_above ? std::min(int(c_above[x]) + 1, max_clearance) : 1);
+      };
+      for(int y = grid_height - 1; y >= 0; --y) {
+        unsigned char* c = &clearance[y * w];
+        const unsigned char* c_below = (y < grid_height - 1 ? c + w : NULL);
+        for(int x = 0; x < grid_width; ++x) {
+          int g = (c_below ? std::min(int(c_below[x]) + 1, max_clearance) : 1);
+          if(g < c[x])
+            c[x] = g;
+        };
+      };
+
+      // the row-wise lower envelopes (the columns left and right of the grid are occupied).
+      std::vector<int> f(w);
+      std::vector<int> v(w);
+      std::vector<double> z(w + 1);
+      for(int y = 0; y < grid_height; ++y) {
+        unsigned char* c = &clearance[y * w];
+        for(int x = 0; x < grid_width; ++x)
+          f[x] = int(c[x]) * int(c[x]);
+
+        int k = 0;
+        v[0] = 0;
+        z[0] = -std::numeric_limits<double>::infinity();
+        z[1] = std::numeric_limits<double>::infinity();
+        for(int q = 1; q < grid_width; ++q) {
+          double s = double((f[q] + q * q) - (f[v[k]] + v[k] * v[k])) / double(2 * (q - v[k]));
+          while(s <= z[k]) {
+            --k;
+            s = double((f[q] + q * q) - (f[v[k]] + v[k] * v[k])) / double(2 * (q - v[k]));
+          };
+          ++k;
+          v[k] = q;
+          z[k] = s;
+          z[k + 1] = std::numeric_limits<double>::infinity();
+        };
+
+        k = 0;
+        for(int q = 0; q < grid_width; ++q) {
+          while(z[k + 1] < q)
+            ++k;
+          int d2 = (q - v[k]) * (q - v[k]) + f[v[k]];
+          d2 = std::min(d2, std::min((q + 1) * (q + 1), (grid_width - q) * (grid_width - q)));
+          c[q] = (d2 >= max_clearance * max_clearance ? max_clearance : int(std::sqrt(double(d2))));
+        };
+      };
+    };
+
   public:
     int grid_width;
     int grid_height;
@@ -55,36 +276,39 @@ class ptrobot2D_test_world_impl {
     ptrobot2D_test_world::point_type goal_pos;
 
     ptrobot2D_test_world_impl(const std::string& aFileName, double aRobotRadius = 1.0) {
+      if(has_file_extension(aFileName, ".pbm")) {
+        load_pbm(aFileName);
 #ifdef REAK_HAS_OPENCV
-      world_map_image = cv::imread(aFileName);
-      if(world_map_image.empty())
-        throw std::ios_base::failure("Could not open the world map image '" + aFileName + "'! File is missing, empty or invalid!");
-
-      world_map_output = world_map_image.clone();
-      grid_width = world_map_image.size().width;
-      grid_height = world_map_image.size().height;
-
-      bpp = world_map_image.elemSize();
+        world_map_image = cv::Mat(grid_height, grid_width, CV_8UC3, cv::Scalar(0,0,0));
+        for(int y = 0; y < grid_height; ++y)
+          for(int x = 0; x < grid_width; ++x)
+            if(is_pixel_free(x, y))
+              world_map_image.at<cv::Vec3b>(y, x) = cv::Vec3b(255,255,255);
+        world_map_output = world_map_image.clone();
+        bpp = world_map_image.elemSize();
+#endif
+      } else {
+#ifdef REAK_HAS_OPENCV
+        world_map_image = cv::imread(aFileName);
+        if(world_map_image.empty())
+          throw std::ios_base::failure("Could not open the world map image '" + aFileName + "'! File is missing, empty or invalid!");
 
-      for(int y = 0; y < grid_height; ++y) {
-        uchar* color_bits = world_map_image.ptr(y);
+        world_map_output = world_map_image.clone();
+        bpp = world_map_image.elemSize();
 
-        for(int x = 0; x < grid_width; ++x) {
-          if( (color_bits[2] == 0) &&
-              (color_bits[0] == 255) &&
-              (color_bits[1] == 0) ) {
-            //this is the start position.
-            start_pos[0] = x;
-            start_pos[1] = y;
-          } else if( (color_bits[2] == 0) &&
-                     (color_bits[0] == 0) &&
-                     (color_bits[1] == 255) ) {
-            //this is the goal position.
-            goal_pos[0] = x;
-            goal_pos[1] = y;
-          };
-          color_bits += bpp;
+        resize_grid(world_map_image.size().width, world_map_image.size().height);
+        for(int y = 0; y < grid_height; ++y)
+          parse_color_row(world_map_image.ptr(y), y, bpp);
+#else
+        if(has_file_extension(aFileName, ".bmp")) {
+          load_bmp(aFileName);
+        } else {
+          resize_grid(500, 500);
+          for(int y = 0; y < grid_height; ++y)
+            for(int x = 0; x < grid_width; ++x)
+              set_pixel_free(x, y);
         };
+#endif
       };
 
 //       int iRobotRadius = int(std::fabs(aRobotRadius));
@@ -94,12 +318,8 @@ class ptrobot2D_test_world_impl {
 //                          aRobotRadius
 //                         );
 //       };
-#else
-      grid_width = 500;
-      grid_height = 500;
-      start_pos = ptrobot2D_test_world::point_type(1.0,1.0);
-      goal_pos  = ptrobot2D_test_world::point_type(498.0,498.0);
-#endif
+
+      compute_clearance();
     };
 
     ptrobot2D_test_world_impl(const ptrobot2D_test_world_impl& rhs) :
@@ -108,25 +328,36 @@ class ptrobot2D_test_world_impl {
                               world_map_output(rhs.world_map_output.clone()),
                               bpp(rhs.bpp),
 #endif
+                              free_bits(rhs.free_bits), words_per_row(rhs.words_per_row),
+                              clearance(rhs.clearance),
                               grid_width(rhs.grid_width), grid_height(rhs.grid_height),
                               start_pos(rhs.start_pos), goal_pos(rhs.goal_pos) { };
 
     bool is_free(const ptrobot2D_test_world::point_type& p) const {
       if((p[0] < 0) || (p[0] >= grid_width) || (p[1] < 0) || (p[1] >= grid_height))
         return false;
-#ifdef REAK_HAS_OPENCV
-      const uchar* color_bits = world_map_image.ptr(int(p[1]));
-      color_bits += bpp * int(p[0]);
-      if( (color_bits[1] < 250) &&
-          (color_bits[2] < 250) &&
-          (color_bits[0] < 250) ) {
-        return false;
-      } else {
-        return true;
+      return is_pixel_free(int(p[0]), int(p[1]));
+    };
+
+    double get_clearance(const ptrobot2D_test_world::point_type& p) const {
+      if((p[0] < 0) || (p[0] >= grid_width) || (p[1] < 0) || (p[1] >= grid_height))
+        return 0.0;
+      return clearance[int(p[1]) * std::size_t(grid_width) + int(p[0])];
+    };
+
+    void save_occupancy_grid(const std::string& aFileName) const {
+      std::ofstream out(aFileName.c_str(), std::ios::out | std::ios::binary);
+      if(!out)
+        throw std::ios_base::failure("Could not open the file '" + aFileName + "' to save the occupancy grid!");
+      out << "P4\n" << grid_width << " " << grid_height << "\n";
+      std::vector<char> row((grid_width + 7) / 8);
+      for(int y = 0; y < grid_height; ++y) {
+        std::fill(row.begin(), row.end(), 0);
+        for(int x = 0; x < grid_width; ++x)
+          if(!is_pixel_free(x, y))
+            row[x >> 3] |= char(1 << (7 - (x & 7)));
+        out.write(&row[0], row.size());
       };
-#else
-      return true;
-#endif
     };
 
 
@@ -166,6 +397,14 @@ bool ptrobot2D_test_world::is_free(const ptrobot2D_test_world::point_type& p) co
   return pimpl->is_free(p);
 };
 
+double ptrobot2D_test_world::get_clearance(const ptrobot2D_test_world::point_type& p) const {
+  return pimpl->get_clearance(p);
+};
+
+void ptrobot2D_test_world::save_occupancy_grid(const std::string& aFilename) const {
+  pimpl->save_occupancy_grid(aFilename);
+};
+
 void ptrobot2D_test_world::reset_output() const {
   pimpl->reset_output();
 };
@@ -224,12 +463,27 @@ ptrobot2D_test_world::point_type ptrobot2D_test_world::move_position_toward(cons
   double dist = m_distance(p1, p2, m_space);
   if(dist * fraction > max_edge_length)
     fraction = max_edge_length / dist;
+  // below this clearance, too few samples can be skipped to pay for the look-up, so the next few
+  // samples are bit-tested one by one (as a pixel walk), which is cheaper in cluttered areas.
+  const double min_skip_clearance = 8.0;
+  const unsigned int low_clearance_walk = 8;
+  double d_max = dist * fraction;
   double d = 1.0;
-  while(d < dist * fraction) {
-    if (!pimpl->is_free(m_space.move_position_toward(p1, (d / dist), p2))) {
-      return m_space.move_position_toward(p1,((d - 1.0) / dist), p2);
+  while(d < d_max) {
+    double c = pimpl->get_clearance(m_space.move_position_toward(p1, (d / dist), p2));
+    if(c >= min_skip_clearance) {
+      // any sample less than (c - sqrt(2)) pixels further lies on a pixel closer than c to this one,
+      // which must be free, so those samples can be skipped (without changing the outcome).
+      d += 1.0 + std::floor(c - 1.4142136);
+      continue;
     };
+    if(c == 0.0)
+      return m_space.move_position_toward(p1, ((d - 1.0) / dist), p2);
     d += 1.0;
+    for(unsigned int i = 0; (i < low_clearance_walk) && (d < d_max); ++i, d += 1.0) {
+      if(!pimpl->is_free(m_space.move_position_toward(p1, (d / dist), p2)))
+        return m_space.move_position_toward(p1, ((d - 1.0) / dist), p2);
+    };
   };
   if(fraction == 1.0) //these equal comparison are used for when exact end fractions are used.
     return p2;
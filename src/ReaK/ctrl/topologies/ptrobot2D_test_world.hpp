@@ -8,6 +8,10 @@
  * pixel which each represent the start and goal positions. Alternatively, the start 
  * and goal position can be set via set_start_pos and set_goal_pos functions. The class 
  * also allows for many parameters and callbacks, see the constructor's documentation for details.
+ * The world map is kept as a bit-packed occupancy grid along with its (Euclidean) distance 
+ * transform, which is used to skip over the free pixels when checking a motion for collisions. 
+ * The world map can also be loaded from a raw binary occupancy grid (PBM file), and the uncompressed 
+ * bitmap (BMP) images can be loaded without OpenCV.
  * See the test_prm.cpp file for a program that uses this class.
  * 
  * \author Sven Mikael Persson <mikael.s.persson@gmail.com>
@@ -113,6 +117,22 @@ class ptrobot2D_test_world : public named_object {
      */
     bool is_free(const point_type& p) const;
     
+    /**
+     * Returns the clearance of the given point, i.e., the distance (in pixels) from its pixel to 
+     * the nearest occupied pixel, as obtained from the distance transform of the world map. 
+     * The clearance is rounded down and saturates at 255 pixels.
+     * \param p The point whose clearance is sought.
+     * \return The clearance of point p, which is zero if p is not collision-free.
+     */
+    double get_clearance(const point_type& p) const;
+    
+    /**
+     * Saves the occupancy grid of the world map to a raw binary PBM file (P4), which is
+     * faster to load than an image, and which can be used as the world map file of this class.
+     * \param aFilename The name of the PBM file to write.
+     */
+    void save_occupancy_grid(const std::string& aFilename) const;
+    
     /**
      * Resets the output image used to draw the edges of the motion graph.
      */
@@ -197,7 +217,8 @@ class ptrobot2D_test_world : public named_object {
     
     /**
      * Parametrized constructor (this class is a RAII class).
-     * \param aWorldMapImage The filename of the image which represents the C-free as white (or colored) pixels and the occupied C-space as gray pixels.
+     * \param aWorldMapImage The filename of the image which represents the C-free as white (or colored) pixels and the occupied C-space as gray pixels, 
+     *                      or of a PBM (P4) file (".pbm") in which the occupied pixels are set (black). The images require OpenCV, except for uncompressed bitmaps (".bmp").
      * \param aMaxEdgeLength The maximum length of an added edge, in pixel-units.
      * \param aRobotRadius The radius of the robot (collision radius), in pixel-units.
      */
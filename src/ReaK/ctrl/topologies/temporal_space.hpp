@@ -35,6 +35,7 @@
 
 #include "base/defs.hpp"
 #include <boost/config.hpp>
+#include <boost/mpl/and.hpp>
 
 #include "path_planning/metric_space_concept.hpp"
 #include "temporal_distance_metrics.hpp"
@@ -0,0 +1,168 @@
+
+/*
+ *    Copyright 2013 Sven Mikael Persson
+ *
+ *    THIS SOFTWARE IS DISTRIBUTED UNDER THE TERMS OF THE GNU GENERAL PUBLIC LICENSE v3 (GPLv3).
+ *
+ *    This file is part of ReaK.
+ *
+ *    ReaK is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    (at your option) any later version.
+ *
+ *    ReaK is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with ReaK (as LICENSE in the root folder).
+ *    If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ptrobot2D_test_world.hpp"
+
+#include "base/chrono_incl.hpp"
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <cstdlib>
+#include <cstdio>
+#include <cmath>
+
+
+/*
+ * Benchmark of the ptrobot2D_test_world, on the test-world images (e.g., the bitmaps in path_planning/test_worlds).
+ * For each world, it times the loading of the image and of its raw binary occupancy grid (PBM), the
+ * point collision checks (is_free), and the motion collision checks (move_position_toward, on random
+ * pairs of free points), against a pixel-by-pixel walk along the motion, whose results must be identical.
+ */
+
+namespace {
+
+using namespace ReaK;
+
+typedef pp::ptrobot2D_test_world::point_type point_type;
+
+
+point_type pixel_walk_toward(const pp::ptrobot2D_test_world& world, const point_type& p1, const point_type& p2) {
+  double dist = norm_2(p2 - p1);
+  double d = 1.0;
+  while(d < dist) {
+    if(!world.is_free(world.get_super_space().move_position_toward(p1, (d / dist), p2)))
+      return world.get_super_space().move_position_toward(p1, ((d - 1.0) / dist), p2);
+    d += 1.0;
+  };
+  return p2;
+};
+
+double elapsed_ms(ReaKaux::chrono::high_resolution_clock::time_point t0, ReaKaux::chrono::high_resolution_clock::time_point t1) {
+  using namespace ReaKaux::chrono;
+  return double(duration_cast<microseconds>(t1 - t0).count()) * 0.001;
+};
+
+};
+
+
+int main(int argc, char** argv) {
+  using namespace ReaKaux::chrono;
+
+  if(argc < 2) {
+    std::cout << "Usage: " << argv[0] << " <world map images...> (e.g., path_planning/test_worlds/*.bmp)" << std::endl;
+    return 1;
+  };
+
+  const std::size_t edge_count = 20000;
+  const std::size_t point_count = 10000000;
+
+  std::cout << std::setw(24) << "world"
+            << std::setw(12) << "image (ms)"
+            << std::setw(12) << "PBM (ms)"
+            << std::setw(14) << "is_free (ns)"
+            << std::setw(16) << "pixel walk (us)"
+            << std::setw(16) << "clearance (us)"
+            << std::setw(10) << "speed-up" << std::endl;
+
+  bool all_identical = true;
+  for(int i = 1; i < argc; ++i) {
+    std::string world_file_name = argv[i];
+    std::string world_name = world_file_name.substr(world_file_name.find_last_of('/') + 1);
+    std::string pbm_file_name = world_name + ".pbm";
+
+    high_resolution_clock::time_point t0 = high_resolution_clock::now();
+    pp::ptrobot2D_test_world world(world_file_name, 1.0, 1.0);
+    high_resolution_clock::time_point t1 = high_resolution_clock::now();
+    world.save_occupancy_grid(pbm_file_name);
+    high_resolution_clock::time_point t2 = high_resolution_clock::now();
+    pp::ptrobot2D_test_world pbm_world(pbm_file_name, 1.0, 1.0);
+    high_resolution_clock::time_point t3 = high_resolution_clock::now();
+    std::remove(pbm_file_name.c_str());
+
+    const point_type& upper = world.get_super_space().get_upper_corner();
+    world.set_max_edge_length(norm_2(upper));
+
+    // point collision checks, on a regular sweep of the world.
+    std::size_t free_count = 0;
+    std::size_t side = std::size_t(std::sqrt(double(point_count)));
+    high_resolution_clock::time_point t4 = high_resolution_clock::now();
+    for(std::size_t y = 0; y < side; ++y)
+      for(std::size_t x = 0; x < side; ++x)
+        if(world.is_free(point_type(upper[0] * x / side, upper[1] * y / side)))
+          ++free_count;
+    high_resolution_clock::time_point t5 = high_resolution_clock::now();
+    if(free_count == 1)  // only to keep the loop from being optimized away.
+      std::cout << " ";
+
+    // compare the grids loaded from the image and from the PBM file (with the same sweep).
+    for(std::size_t y = 0; y < side; ++y)
+      for(std::size_t x = 0; x < side; ++x) {
+        point_type p(upper[0] * x / side, upper[1] * y / side);
+        if(world.is_free(p) != pbm_world.is_free(p)) {
+          std::cout << "The occupancy grid loaded from the PBM file differs from the image of '" << world_name << "'!" << std::endl;
+          all_identical = false;
+          y = side;
+          break;
+        };
+      };
+
+    // motion collision checks, between random free points.
+    std::vector< point_type > endpoints(2 * edge_count);
+    for(std::size_t j = 0; j < endpoints.size(); ++j)
+      endpoints[j] = world.random_point();
+    std::vector< point_type > walk_results(edge_count);
+    std::vector< point_type > clearance_results(edge_count);
+
+    high_resolution_clock::time_point t6 = high_resolution_clock::now();
+    for(std::size_t j = 0; j < edge_count; ++j)
+      walk_results[j] = pixel_walk_toward(world, endpoints[2 * j], endpoints[2 * j + 1]);
+    high_resolution_clock::time_point t7 = high_resolution_clock::now();
+    for(std::size_t j = 0; j < edge_count; ++j)
+      clearance_results[j] = world.move_position_toward(endpoints[2 * j], 1.0, endpoints[2 * j + 1]);
+    high_resolution_clock::time_point t8 = high_resolution_clock::now();
+
+    std::size_t mismatches = 0;
+    for(std::size_t j = 0; j < edge_count; ++j)
+      if(norm_2(walk_results[j] - clearance_results[j]) > 1e-9)
+        ++mismatches;
+    if(mismatches > 0) {
+      std::cout << "The motion checks differ from the pixel walk on " << mismatches << " motions of '" << world_name << "'!" << std::endl;
+      all_identical = false;
+    };
+
+    double walk_us = elapsed_ms(t6, t7) * 1000.0 / double(edge_count);
+    double clearance_us = elapsed_ms(t7, t8) * 1000.0 / double(edge_count);
+    std::cout << std::setw(24) << world_name
+              << std::setw(12) << elapsed_ms(t0, t1)
+              << std::setw(12) << elapsed_ms(t2, t3)
+              << std::setw(14) << (elapsed_ms(t4, t5) * 1e6 / double(side * side))
+              << std::setw(16) << walk_us
+              << std::setw(16) << clearance_us
+              << std::setw(10) << (walk_us / clearance_us) << std::endl;
+  };
+
+  return (all_identical ? 0 : 1);
+};
+
@@ -0,0 +1,145 @@
+
+/*
+ *    Copyright 2013 Sven Mikael Persson
+ *
+ *    THIS SOFTWARE IS DISTRIBUTED UNDER THE TERMS OF THE GNU GENERAL PUBLIC LICENSE v3 (GPLv3).
+ *
+ *    This file is part of ReaK.
+ *
+ *    ReaK is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    (at your option) any later version.
+ *
+ *    ReaK is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with ReaK (as LICENSE in the root folder).
+ *    If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "manip_free_workspace.hpp"
+
+#include "lin_alg/vect_alg.hpp"
+#include "lin_alg/arithmetic_tuple.hpp"
+
+#define BOOST_TEST_DYN_LINK
+
+#define BOOST_TEST_MODULE manip_edge_cache
+#include <boost/test/unit_test.hpp>
+
+
+namespace {
+
+using namespace ReaK;
+
+typedef vect<double,3> point_3D;
+typedef arithmetic_tuple< vect<double,2>, double > point_tuple;
+
+struct exact_equal {
+  template <typename PointType>
+  bool operator()(const PointType& a, const PointType& b) const {
+    return norm_2(to_vect<double>(a) - to_vect<double>(b)) == 0.0;
+  };
+};
+
+// a (terrible) hasher that makes all the entries collide.
+struct constant_hasher {
+  template <typename PointType>
+  std::size_t operator()(const PointType&) const { return 42; };
+};
+
+template <typename Cache, typename PointType>
+void insert_edge(Cache& cache, const PointType& p1, const PointType& p2, bool is_free) {
+  typename Cache::entry e;
+  e.p1 = p1;
+  e.p2 = p2;
+  e.reached = (is_free ? p2 : p1);
+  e.is_free = is_free;
+  e.has_reached = true;
+  cache.insert(e, exact_equal());
+};
+
+};
+
+
+BOOST_AUTO_TEST_CASE( manip_point_hasher_tests )
+{
+  pp::detail::manip_point_hasher h;
+  BOOST_CHECK_EQUAL( h(point_3D(1.0, 2.0, 3.0)), h(point_3D(1.0, 2.0, 3.0)) );
+  BOOST_CHECK( h(point_3D(1.0, 2.0, 3.0)) != h(point_3D(3.0, 2.0, 1.0)) );
+  BOOST_CHECK_EQUAL( h(point_tuple(vect<double,2>(1.0, 2.0), 3.0)), h(point_3D(1.0, 2.0, 3.0)) );
+  BOOST_CHECK_EQUAL( h(point_3D(0.0, 1.0, 2.0)), h(point_3D(-0.0, 1.0, 2.0)) );
+  BOOST_CHECK_EQUAL( h(4.0), h(4.0) );
+};
+
+
+BOOST_AUTO_TEST_CASE( manip_edge_cache_lookup_tests )
+{
+  typedef pp::detail::manip_edge_result_cache< point_3D > cache_type;
+  cache_type cache(8);
+  
+  for(std::size_t i = 0; i < 8; ++i)
+    insert_edge(cache, point_3D(double(i), 0.0, 0.0), point_3D(double(i), 1.0, 0.0), (i % 2 == 0));
+  BOOST_CHECK_EQUAL( cache.get_size(), 8 );
+  
+  cache_type::entry e;
+  for(std::size_t i = 0; i < 8; ++i) {
+    BOOST_CHECK( cache.find(point_3D(double(i), 0.0, 0.0), point_3D(double(i), 1.0, 0.0), exact_equal(), e) );
+    BOOST_CHECK_EQUAL( e.is_free, (i % 2 == 0) );
+  };
+  // the edges are directed.
+  BOOST_CHECK( !cache.find(point_3D(0.0, 1.0, 0.0), point_3D(0.0, 0.0, 0.0), exact_equal(), e) );
+  BOOST_CHECK_EQUAL( cache.get_hit_count(), 8 );
+  BOOST_CHECK_EQUAL( cache.get_miss_count(), 1 );
+  
+  // touch the first edge, then overflow the cache by one: the least-recently used (second) edge goes.
+  BOOST_CHECK( cache.find(point_3D(0.0, 0.0, 0.0), point_3D(0.0, 1.0, 0.0), exact_equal(), e) );
+  insert_edge(cache, point_3D(8.0, 0.0, 0.0), point_3D(8.0, 1.0, 0.0), true);
+  BOOST_CHECK_EQUAL( cache.get_size(), 8 );
+  BOOST_CHECK( cache.find(point_3D(0.0, 0.0, 0.0), point_3D(0.0, 1.0, 0.0), exact_equal(), e) );
+  BOOST_CHECK( !cache.find(point_3D(1.0, 0.0, 0.0), point_3D(1.0, 1.0, 0.0), exact_equal(), e) );
+  BOOST_CHECK( cache.find(point_3D(8.0, 0.0, 0.0), point_3D(8.0, 1.0, 0.0), exact_equal(), e) );
+  
+  // re-inserting a cached edge updates its entry (and makes it the most recently used).
+  insert_edge(cache, point_3D(2.0, 0.0, 0.0), point_3D(2.0, 1.0, 0.0), false);
+  BOOST_CHECK_EQUAL( cache.get_size(), 8 );
+  BOOST_CHECK( cache.find(point_3D(2.0, 0.0, 0.0), point_3D(2.0, 1.0, 0.0), exact_equal(), e) );
+  BOOST_CHECK( !e.is_free );
+  
+  cache.set_capacity(2);
+  BOOST_CHECK_EQUAL( cache.get_size(), 2 );
+  BOOST_CHECK( cache.find(point_3D(8.0, 0.0, 0.0), point_3D(8.0, 1.0, 0.0), exact_equal(), e) );
+  BOOST_CHECK( cache.find(point_3D(2.0, 0.0, 0.0), point_3D(2.0, 1.0, 0.0), exact_equal(), e) );
+  BOOST_CHECK( !cache.find(point_3D(0.0, 0.0, 0.0), point_3D(0.0, 1.0, 0.0), exact_equal(), e) );
+  
+  cache.clear();
+  BOOST_CHECK_EQUAL( cache.get_size(), 0 );
+  BOOST_CHECK_EQUAL( cache.get_hit_count(), 0 );
+  BOOST_CHECK( !cache.find(point_3D(0.0, 0.0, 0.0), point_3D(0.0, 1.0, 0.0), exact_equal(), e) );
+};
+
+
+BOOST_AUTO_TEST_CASE( manip_edge_cache_collision_tests )
+{
+  typedef pp::detail::manip_edge_result_cache< point_tuple, constant_hasher > cache_type;
+  cache_type cache(4);
+  
+  for(std::size_t i = 0; i < 10; ++i)
+    insert_edge(cache, point_tuple(vect<double,2>(double(i), 0.0), 0.0), point_tuple(vect<double,2>(double(i), 1.0), 0.0), (i % 3 == 0));
+  BOOST_CHECK_EQUAL( cache.get_size(), 4 );
+  
+  cache_type::entry e;
+  for(std::size_t i = 0; i < 6; ++i)
+    BOOST_CHECK( !cache.find(point_tuple(vect<double,2>(double(i), 0.0), 0.0), point_tuple(vect<double,2>(double(i), 1.0), 0.0), exact_equal(), e) );
+  for(std::size_t i = 6; i < 10; ++i) {
+    BOOST_CHECK( cache.find(point_tuple(vect<double,2>(double(i), 0.0), 0.0), point_tuple(vect<double,2>(double(i), 1.0), 0.0), exact_equal(), e) );
+    BOOST_CHECK_EQUAL( e.is_free, (i % 3 == 0) );
+    BOOST_CHECK_EQUAL( get<0>(e.p1)[0], double(i) );
+  };
+};
+
+
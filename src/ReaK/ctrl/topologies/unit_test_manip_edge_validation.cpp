@@ -0,0 +1,288 @@
+
+/*
+ *    Copyright 2013 Sven Mikael Persson
+ *
+ *    THIS SOFTWARE IS DISTRIBUTED UNDER THE TERMS OF THE GNU GENERAL PUBLIC LICENSE v3 (GPLv3).
+ *
+ *    This file is part of ReaK.
+ *
+ *    ReaK is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    (at your option) any later version.
+ *
+ *    ReaK is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with ReaK (as LICENSE in the root folder).
+ *    If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "manip_free_workspace.hpp"
+#include "Ndof_spaces.hpp"
+#include "interpolation/linear_interp.hpp"
+
+#include "shapes/circle.hpp"
+#include "shapes/rectangle.hpp"
+
+#include <vector>
+#include <cmath>
+
+#define BOOST_TEST_DYN_LINK
+
+#define BOOST_TEST_MODULE manip_edge_validation
+#include <boost/test/unit_test.hpp>
+
+
+namespace {
+
+using namespace ReaK;
+
+/* A planar point-robot (a disc), whose two generalized coordinates are the position of its frame. */
+class disc_robot_kinematics : public kte::direct_kinematics_model {
+  public:
+    std::vector< shared_ptr< gen_coord<double> > > m_joints;
+    shared_ptr< frame_2D<double> > m_frame;
+    
+    disc_robot_kinematics() : kte::direct_kinematics_model("disc_robot"), m_joints(), m_frame(new frame_2D<double>()) {
+      m_joints.push_back(shared_ptr< gen_coord<double> >(new gen_coord<double>()));
+      m_joints.push_back(shared_ptr< gen_coord<double> >(new gen_coord<double>()));
+    };
+    
+    virtual std::size_t getJointPositionsCount() const { return 2; };
+    virtual std::size_t getCoordsCount() const { return 2; };
+    virtual shared_ptr< gen_coord<double> > getCoord(std::size_t i) const { return m_joints[i]; };
+    
+    virtual void doDirectMotion() {
+      m_frame->Position = vect<double,2>(m_joints[0]->q, m_joints[1]->q);
+    };
+};
+
+typedef pp::Ndof_rl_space<double, 2, 0>::type space_type;
+typedef pp::manip_quasi_static_env< space_type, pp::linear_interpolation_tag > env_type;
+typedef pp::topology_traits< space_type >::point_type point_type;
+
+/* An environment with the disc robot and a wall, with its own kinematic model and proximity queries. */
+shared_ptr< env_type > make_wall_env() {
+  shared_ptr< disc_robot_kinematics > robot(new disc_robot_kinematics());
+  
+  shared_ptr< geom::proxy_query_model_2D > robot_geom(new geom::proxy_query_model_2D("robot_geom"));
+  robot_geom->addShape(shared_ptr< geom::shape_2D >(new geom::circle("robot_disc", robot->m_frame, pose_2D<double>(), 0.5)));
+  shared_ptr< geom::proxy_query_model_2D > world_geom(new geom::proxy_query_model_2D("world_geom"));
+  world_geom->addShape(shared_ptr< geom::shape_2D >(new geom::rectangle("wall", shared_ptr< pose_2D<double> >(), 
+    pose_2D<double>(shared_ptr< pose_2D<double> >(), vect<double,2>(5.0, 4.0), rot_mat_2D<double>(0.0)), vect<double,2>(1.0, 6.0))));
+  shared_ptr< geom::proxy_query_pair_2D > robot_world(new geom::proxy_query_pair_2D("robot_world", robot_geom, world_geom));
+  
+  shared_ptr< pp::joint_limits_collection<double> > limits(new pp::joint_limits_collection<double>("limits"));
+  limits->gen_speed_limits.resize(2);
+  limits->gen_speed_limits[0] = 1.0;
+  limits->gen_speed_limits[1] = 1.0;
+  
+  space_type space = pp::make_Ndof_rl_space<2>(vect<double,2>(0.0, 0.0), vect<double,2>(10.0, 10.0), vect<double,2>(1.0, 1.0));
+  
+  shared_ptr< env_type > env(new env_type(space, robot, limits, 0.05, 20.0));
+  *env << robot_world;
+  return env;
+};
+
+};
+
+
+BOOST_AUTO_TEST_CASE( bisection_vs_linear_validation_tests )
+{
+  shared_ptr< disc_robot_kinematics > robot(new disc_robot_kinematics());
+  
+  shared_ptr< geom::proxy_query_model_2D > robot_geom(new geom::proxy_query_model_2D("robot_geom"));
+  robot_geom->addShape(shared_ptr< geom::shape_2D >(new geom::circle("robot_disc", robot->m_frame, pose_2D<double>(), 0.5)));
+  shared_ptr< geom::proxy_query_model_2D > world_geom(new geom::proxy_query_model_2D("world_geom"));
+  world_geom->addShape(shared_ptr< geom::shape_2D >(new geom::rectangle("wall", shared_ptr< pose_2D<double> >(), 
+    pose_2D<double>(shared_ptr< pose_2D<double> >(), vect<double,2>(5.0, 4.0), rot_mat_2D<double>(0.0)), vect<double,2>(1.0, 6.0))));
+  shared_ptr< geom::proxy_query_pair_2D > robot_world(new geom::proxy_query_pair_2D("robot_world", robot_geom, world_geom));
+  
+  shared_ptr< pp::joint_limits_collection<double> > limits(new pp::joint_limits_collection<double>("limits"));
+  limits->gen_speed_limits.resize(2);
+  limits->gen_speed_limits[0] = 1.0;
+  limits->gen_speed_limits[1] = 1.0;
+  
+  space_type space = pp::make_Ndof_rl_space<2>(vect<double,2>(0.0, 0.0), vect<double,2>(10.0, 10.0), vect<double,2>(1.0, 1.0));
+  
+  env_type linear_env(space, robot, limits, 0.05, 20.0);
+  linear_env << robot_world;
+  env_type bisection_env(space, robot, limits, 0.05, 20.0);
+  bisection_env << robot_world;
+  bisection_env.set_bisection_validation(true);
+  
+  // a regular grid of collision-free points, on both sides of the wall.
+  std::vector< point_type > pts;
+  for(std::size_t i = 0; i < 10; ++i) {
+    for(std::size_t j = 0; j < 10; ++j) {
+      point_type p(vect<double,2>(0.3 + 0.97 * i, 0.3 + 0.97 * j));
+      if(linear_env.is_free(p))
+        pts.push_back(p);
+    };
+  };
+  BOOST_REQUIRE( pts.size() > 50 );
+  
+  std::size_t free_count = 0;
+  std::size_t blocked_count = 0;
+  for(std::size_t i = 0; i < pts.size(); ++i) {
+    for(std::size_t j = 0; j < pts.size(); j += 3) {
+      double d_lin = linear_env.distance(pts[i], pts[j]);
+      double d_bis = bisection_env.distance(pts[i], pts[j]);
+      if(d_lin == std::numeric_limits< double >::infinity()) {
+        BOOST_CHECK_EQUAL( d_bis, std::numeric_limits< double >::infinity() );
+        ++blocked_count;
+      } else {
+        BOOST_CHECK_CLOSE( d_bis, d_lin, 1e-9 );
+        ++free_count;
+      };
+    };
+  };
+  BOOST_CHECK( free_count > 0 );
+  BOOST_CHECK( blocked_count > 0 );
+  
+  // both modes check the same samples on free motions, but bisection finds the collisions sooner.
+  BOOST_CHECK_EQUAL( linear_env.get_edge_validation_count(), bisection_env.get_edge_validation_count() );
+  BOOST_CHECK( bisection_env.get_edge_check_count() < linear_env.get_edge_check_count() );
+  BOOST_TEST_MESSAGE( "Average collision checks per motion validation: linear = " 
+                      << double(linear_env.get_edge_check_count()) / double(linear_env.get_edge_validation_count())
+                      << ", bisection = " 
+                      << double(bisection_env.get_edge_check_count()) / double(bisection_env.get_edge_validation_count())
+                      << " (" << free_count << " free and " << blocked_count << " blocked motions)" );
+};
+
+
+BOOST_AUTO_TEST_CASE( edge_cache_tests )
+{
+  shared_ptr< disc_robot_kinematics > robot(new disc_robot_kinematics());
+  
+  shared_ptr< geom::proxy_query_model_2D > robot_geom(new geom::proxy_query_model_2D("robot_geom"));
+  robot_geom->addShape(shared_ptr< geom::shape_2D >(new geom::circle("robot_disc", robot->m_frame, pose_2D<double>(), 0.5)));
+  shared_ptr< geom::proxy_query_model_2D > world_geom(new geom::proxy_query_model_2D("world_geom"));
+  world_geom->addShape(shared_ptr< geom::shape_2D >(new geom::rectangle("wall", shared_ptr< pose_2D<double> >(), 
+    pose_2D<double>(shared_ptr< pose_2D<double> >(), vect<double,2>(5.0, 4.0), rot_mat_2D<double>(0.0)), vect<double,2>(1.0, 6.0))));
+  shared_ptr< geom::proxy_query_pair_2D > robot_world(new geom::proxy_query_pair_2D("robot_world", robot_geom, world_geom));
+  
+  shared_ptr< pp::joint_limits_collection<double> > limits(new pp::joint_limits_collection<double>("limits"));
+  limits->gen_speed_limits.resize(2);
+  limits->gen_speed_limits[0] = 1.0;
+  limits->gen_speed_limits[1] = 1.0;
+  
+  space_type space = pp::make_Ndof_rl_space<2>(vect<double,2>(0.0, 0.0), vect<double,2>(10.0, 10.0), vect<double,2>(1.0, 1.0));
+  
+  env_type env(space, robot, limits, 0.05, 20.0);
+  env << robot_world;
+  env.set_bisection_validation(true);
+  
+  // a motion through the wall: the fail-fast validation caches its validity only, and then the 
+  // reached point is computed and stored in the same cache entry.
+  point_type p1(vect<double,2>(2.0, 4.0));
+  point_type p2(vect<double,2>(8.0, 4.0));
+  BOOST_CHECK_EQUAL( env.distance(p1, p2), std::numeric_limits< double >::infinity() );
+  BOOST_CHECK_EQUAL( env.get_edge_cache_size(), 1 );
+  point_type p_reached = env.move_position_toward(p1, 1.0, p2);
+  BOOST_CHECK( get<0>(p_reached)[0] < 4.5 );
+  BOOST_CHECK_EQUAL( env.get_edge_cache_size(), 1 );
+  BOOST_CHECK_EQUAL( get<0>(env.move_position_toward(p1, 1.0, p2))[0], get<0>(p_reached)[0] );
+  BOOST_CHECK_EQUAL( env.get_edge_cache_size(), 1 );
+  
+  // a copy of the environment gets its own cache.
+  env_type env_copy(env);
+  BOOST_CHECK_EQUAL( env_copy.get_edge_cache_size(), 0 );
+  BOOST_CHECK_EQUAL( env_copy.get_edge_cache_capacity(), env.get_edge_cache_capacity() );
+  BOOST_CHECK_EQUAL( env_copy.distance(p1, p2), std::numeric_limits< double >::infinity() );
+  env_copy.clear_edge_cache();
+  BOOST_CHECK_EQUAL( env.get_edge_cache_size(), 1 );
+  env_copy = env;
+  BOOST_CHECK_EQUAL( env_copy.get_edge_cache_size(), 0 );
+  BOOST_CHECK_EQUAL( env.get_edge_cache_size(), 1 );
+};
+
+
+BOOST_AUTO_TEST_CASE( conservative_advancement_tests )
+{
+  shared_ptr< disc_robot_kinematics > robot(new disc_robot_kinematics());
+  
+  shared_ptr< geom::proxy_query_model_2D > robot_geom(new geom::proxy_query_model_2D("robot_geom"));
+  robot_geom->addShape(shared_ptr< geom::shape_2D >(new geom::circle("robot_disc", robot->m_frame, pose_2D<double>(), 0.5)));
+  shared_ptr< geom::proxy_query_model_2D > world_geom(new geom::proxy_query_model_2D("world_geom"));
+  world_geom->addShape(shared_ptr< geom::shape_2D >(new geom::rectangle("wall", shared_ptr< pose_2D<double> >(), 
+    pose_2D<double>(shared_ptr< pose_2D<double> >(), vect<double,2>(5.0, 4.0), rot_mat_2D<double>(0.0)), vect<double,2>(1.0, 6.0))));
+  shared_ptr< geom::proxy_query_pair_2D > robot_world(new geom::proxy_query_pair_2D("robot_world", robot_geom, world_geom));
+  
+  shared_ptr< pp::joint_limits_collection<double> > limits(new pp::joint_limits_collection<double>("limits"));
+  limits->gen_speed_limits.resize(2);
+  limits->gen_speed_limits[0] = 1.0;
+  limits->gen_speed_limits[1] = 1.0;
+  
+  space_type space = pp::make_Ndof_rl_space<2>(vect<double,2>(0.0, 0.0), vect<double,2>(10.0, 10.0), vect<double,2>(1.0, 1.0));
+  
+  // the generalized coordinates are translations here, so they contribute their speed limits (reach < 1).
+  env_type env(space, robot, limits, 0.05, 20.0);
+  env << robot_world;
+  env.set_max_motion_speed_from_limits(0.5);
+  BOOST_CHECK_CLOSE( env.get_max_motion_speed(), 2.0, 1e-9 );
+  
+  // the same pair, registered as a self-collision pair, is approached at twice the speed.
+  env_type self_env(space, robot, limits, 0.05, 20.0, env.get_max_motion_speed());
+  self_env.add_self_collision_pair(robot_world);
+  
+  point_type p1(vect<double,2>(2.0, 4.0));
+  point_type p2(vect<double,2>(8.0, 4.0));
+  point_type p_reached = env.move_position_toward(p1, 1.0, p2);
+  point_type p_self_reached = self_env.move_position_toward(p1, 1.0, p2);
+  BOOST_CHECK( env.is_free(p_reached) );
+  BOOST_CHECK( self_env.is_free(p_self_reached) );
+  BOOST_CHECK( get<0>(p_reached)[0] < 4.0 );
+  BOOST_CHECK( get<0>(p_self_reached)[0] < 4.0 );
+  BOOST_CHECK( get<0>(p_reached)[0] > 3.9 );
+  BOOST_CHECK( get<0>(p_self_reached)[0] > 3.9 );
+  BOOST_CHECK_LT( env.get_edge_check_count(), self_env.get_edge_check_count() );
+  BOOST_TEST_MESSAGE( "Clearance evaluations: " << env.get_edge_check_count() << " with an obstacle pair, " 
+                      << self_env.get_edge_check_count() << " with a self-collision pair." );
+};
+
+
+BOOST_AUTO_TEST_CASE( parallel_validation_tests )
+{
+  shared_ptr< env_type > env = make_wall_env();
+  env->set_bisection_validation(true);
+  std::vector< shared_ptr< env_type > > workers;
+  for(std::size_t i = 0; i < 3; ++i)
+    workers.push_back(make_wall_env());
+  
+  std::vector< point_type > pts;
+  for(std::size_t i = 0; i < 8; ++i) {
+    for(std::size_t j = 0; j < 8; ++j) {
+      point_type p(vect<double,2>(0.4 + 1.2 * i, 0.4 + 1.2 * j));
+      if(env->is_free(p))
+        pts.push_back(p);
+    };
+  };
+  BOOST_REQUIRE( pts.size() > 30 );
+  
+  // the parallel validation agrees with the sequential one, on free and blocked motions.
+  std::size_t free_count = 0;
+  std::size_t blocked_count = 0;
+  for(std::size_t i = 0; i < pts.size(); ++i) {
+    for(std::size_t j = i + 1; j < pts.size(); j += 5) {
+      bool seq_free = (env->distance(pts[i], pts[j]) < std::numeric_limits< double >::infinity());
+      BOOST_CHECK_EQUAL( env->is_edge_free_parallel(pts[i], pts[j], workers), seq_free );
+      if(seq_free)
+        ++free_count;
+      else
+        ++blocked_count;
+    };
+  };
+  BOOST_CHECK( free_count > 0 );
+  BOOST_CHECK( blocked_count > 0 );
+  
+  // with no worker environments, all the samples are checked on the calling thread.
+  BOOST_CHECK( !env->is_edge_free_parallel(point_type(vect<double,2>(2.0, 4.0)), point_type(vect<double,2>(8.0, 4.0)), 
+                                           std::vector< shared_ptr< env_type > >()) );
+};
+
+
@@ -62,6 +62,9 @@
 
 #include "lin_alg/mat_qr_decomp.hpp"
 #include "lin_alg/mat_are_solver.hpp"
+#include "lin_alg/mat_are_cached_solver.hpp"
+
+#include "base/thread_incl.hpp"
 
 namespace ReaK {
 
@@ -218,6 +221,8 @@ class IHAQR_topology : public named_object
     typedef default_distance_metric distance_metric_type;
     typedef default_random_sampler random_sampler_type;
     
+    typedef IHCT_AQR_cached_solver< state_type > Riccati_solver_type;
+    
     BOOST_STATIC_CONSTANT(std::size_t, dimensions = 0);
     
     
@@ -236,6 +241,43 @@ class IHAQR_topology : public named_object
     double m_max_time_horizon;
     double m_goal_proximity_threshold;
     
+    /* 
+     * Holds the Riccati solver with the mutex that serializes its use from the const member functions. 
+     * A copy of the topology gets its own copy of the solver (with the cached solutions), never a shared one.
+     */
+    struct Riccati_solver_holder {
+      Riccati_solver_type solver;
+      mutable ReaKaux::mutex access_mutex;
+      
+      Riccati_solver_holder() : solver(), access_mutex() { };
+      Riccati_solver_holder(const Riccati_solver_holder& rhs) : solver(), access_mutex() {
+        ReaKaux::unique_lock< ReaKaux::mutex > lock_here(rhs.access_mutex);
+        solver = rhs.solver;
+      };
+      Riccati_solver_holder& operator=(const Riccati_solver_holder& rhs) {
+        if(this == &rhs)
+          return *this;
+        Riccati_solver_type tmp;
+        {
+          ReaKaux::unique_lock< ReaKaux::mutex > lock_here(rhs.access_mutex);
+          tmp = rhs.solver;
+        };
+        ReaKaux::unique_lock< ReaKaux::mutex > lock_here(access_mutex);
+        solver = tmp;
+        return *this;
+      };
+    };
+    
+    mutable Riccati_solver_holder m_Riccati; ///< Caches the CARE solutions at previous linearization points to warm-start the solution at new ones.
+    
+    struct state_distance_functor {
+      const StateSpace* p_space;
+      explicit state_distance_functor(const StateSpace* aSpace) : p_space(aSpace) { };
+      double operator()(const state_type& a, const state_type& b) const {
+        return p_space->distance(a, b);
+      };
+    };
+    
     /**
      * This function computes linearization data (A,B,u0,c) for a given point p.
      * \param p The point for which the linearization data is required.
@@ -278,8 +320,10 @@ class IHAQR_topology : public named_object
       // solve for M, K, and u_bias
       try {
         vect_n<double> u_bias_v = to_vect<double>(a.lin_data->u);
-        solve_IHCT_AQR(a.lin_data->A, a.lin_data->B, c_v, m_Q, m_R, 
-                       a.IHAQR_data->K, a.IHAQR_data->M, u_bias_v, 1e-4, true);
+        ReaKaux::unique_lock< ReaKaux::mutex > lock_here(m_Riccati.access_mutex);
+        m_Riccati.solver.solve(a.x, state_distance_functor(&m_space),
+                                a.lin_data->A, a.lin_data->B, c_v, m_Q, m_R, 
+                                a.IHAQR_data->K, a.IHAQR_data->M, u_bias_v, 1e-4, true);
         a.IHAQR_data->u_bias = from_vect<system_input_type>(u_bias_v);
       } catch(std::exception& e) {
         std::cout << "Warning! Solution to the CARE problem could not be found for the given state point: " << a.x << std::endl
@@ -407,6 +451,19 @@ class IHAQR_topology : public named_object
     const mat<double,mat_structure::diagonal>& get_input_cost_matrix() const { return m_R; };
     const mat<double,mat_structure::diagonal>& get_state_cost_matrix() const { return m_Q; };
     
+    /**
+     * Returns the Riccati solver (and solution cache) used to compute the IHAQR data of the points.
+     * This can be used to tune the caching and warm-starting parameters, or to query the number of 
+     * warm-started versus full solutions performed.
+     * \note The solver should not be accessed this way while other threads use this topology.
+     */
+    Riccati_solver_type& get_Riccati_solver() { return m_Riccati.solver; };
+    /**
+     * Returns the Riccati solver (and solution cache) used to compute the IHAQR data of the points.
+     * \note The solver should not be accessed this way while other threads use this topology.
+     */
+    const Riccati_solver_type& get_Riccati_solver() const { return m_Riccati.solver; };
+    
     /**
      * Default constructor.
      * \param aName The name of this topology / object.
@@ -444,7 +501,8 @@ class IHAQR_topology : public named_object
                    m_Q(aQ),
                    m_time_step(aTimeStep),
                    m_max_time_horizon(aMaxTimeHorizon),
-                   m_goal_proximity_threshold(aGoalProximityThreshold) {
+                   m_goal_proximity_threshold(aGoalProximityThreshold),
+                   m_Riccati() {
       setName(aName);
     };
     
@@ -573,6 +631,7 @@ class IHAQR_topology : public named_object
         & RK_SERIAL_LOAD_WITH_NAME(m_time_step)
         & RK_SERIAL_LOAD_WITH_NAME(m_max_time_horizon)
         & RK_SERIAL_LOAD_WITH_NAME(m_goal_proximity_threshold);
+      m_Riccati.solver.clear();
     };
 
     RK_RTTI_MAKE_CONCRETE_1BASE(self,0xC2400032,1,"IHAQR_topology",named_object)
@@ -58,6 +58,12 @@
 #include "topologies/inverse_kinematics_topomap.hpp"
 #include "path_planning/frame_tracer_coin3d.hpp"
 
+#include <iostream>
+
+#include <boost/program_options.hpp>
+
+namespace po = boost::program_options;
+
 
 struct all_robot_info {
   SoSeparator* sg_root;
@@ -74,6 +80,9 @@ struct all_robot_info {
   ReaK::shared_ptr< ReaK::geom::proxy_query_pair_3D > robot_airship_proxy;
   ReaK::shared_ptr< ReaK::geom::proxy_query_pair_3D > lab_airship_proxy;
   std::vector< SoSeparator* > solution_seps;
+  bool bisection_validation;
+  
+  all_robot_info() : bisection_validation(false) { };
 };
 
 void add_new_solution_sep(void* userData, SoSensor*) {
@@ -210,6 +219,7 @@ void keyboard_press_hdl(void* userData, SoEventCallback* eventCB) {
         0.1, 1.0, 1e-6, 60));*/
     
     (*workspace) << r_info->robot_lab_proxy << r_info->robot_airship_proxy;
+    workspace->set_bisection_validation(r_info->bisection_validation);
     
     ReaK::shared_ptr< ReaK::robot_airship::CRS_A465_model_builder::rate_limited_joint_space_1st_type > jt_space(new ReaK::robot_airship::CRS_A465_model_builder::rate_limited_joint_space_1st_type(r_info->builder.get_rl_joint_space_1st()));
     ReaK::shared_ptr< ReaK::robot_airship::CRS_A465_model_builder::joint_space_1st_type > normal_jt_space(new ReaK::robot_airship::CRS_A465_model_builder::joint_space_1st_type(r_info->builder.get_joint_space_1st()));
@@ -259,6 +269,11 @@ void keyboard_press_hdl(void* userData, SoEventCallback* eventCB) {
     
     workspace_planner.solve_path();
     
+    std::cout << (r_info->bisection_validation ? "[bisection] " : "[linear] ")
+              << "Average number of collision checks per motion validation: " 
+              << double(workspace->get_edge_check_count()) / double(workspace->get_edge_validation_count()) 
+              << " (over " << workspace->get_edge_validation_count() << " validations)" << std::endl;
+    
     r_info->solution_seps.push_back(workspace_planner.get_reporter().get_motion_graph_tracer(r_info->builder.arm_joint_6_end).get_separator());
     r_info->solution_seps.back()->ref();
     if(workspace_planner.get_reporter().get_solution_count()) {
@@ -290,7 +305,24 @@ void keyboard_press_hdl(void* userData, SoEventCallback* eventCB) {
 int main(int argc, char ** argv) {
   using namespace ReaK;
   
+  po::options_description generic_options("Generic options");
+  generic_options.add_options()
+    ("help,h", "produce this help message.")
+    ("bisection-validation", "validate the motions by checking their samples in bisection order (fail-fast), instead of in order along the motion")
+  ;
+  
+  po::variables_map vm;
+  // the remaining options (e.g., Qt options) are passed on to SoQt.
+  po::store(po::command_line_parser(argc, argv).options(generic_options).allow_unregistered().run(), vm);
+  po::notify(vm);
+  
+  if(vm.count("help")) {
+    std::cout << generic_options << std::endl;
+    return 1;
+  };
+  
   all_robot_info r_info;
+  r_info.bisection_validation = (vm.count("bisection-validation") > 0);
   
   //r_info.builder.create_geom_from_preset();
   r_info.builder.load_kte_and_geom("models/CRS_A465_with_geom.xml");
@@ -0,0 +1,81 @@
+
+/*
+ *    Copyright 2013 Sven Mikael Persson
+ *
+ *    THIS SOFTWARE IS DISTRIBUTED UNDER THE TERMS OF THE GNU GENERAL PUBLIC LICENSE v3 (GPLv3).
+ *
+ *    This file is part of ReaK.
+ *
+ *    ReaK is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    (at your option) any later version.
+ *
+ *    ReaK is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with ReaK (as LICENSE in the root folder).  
+ *    If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "prox_convex_2D.hpp"
+
+#include "prox_gjk_epa.hpp"
+
+#include <limits>
+
+/** Main namespace for ReaK */
+namespace ReaK {
+
+/** Main namespace for ReaK.Geometry */
+namespace geom {
+
+
+shared_ptr< shape_2D > prox_convex_2D::getShape1() const {
+  return mShape1;
+};
+
+shared_ptr< shape_2D > prox_convex_2D::getShape2() const {
+  return mShape2;
+};
+
+void prox_convex_2D::computeProximity() {
+  if((!mShape1) || (!mShape2)) {
+    mLastResult.mDistance = std::numeric_limits<double>::infinity();
+    mLastResult.mPoint1 = vect<double,2>(0.0,0.0);
+    mLastResult.mPoint2 = vect<double,2>(0.0,0.0);
+    return;
+  };
+  
+  mLastResult = findProximityByGJKEPA(*mShape1, *mShape2, mSimplexDirs);
+};
+
+
+prox_convex_2D::prox_convex_2D(const shared_ptr< shape_2D >& aShape1,
+                               const shared_ptr< shape_2D >& aShape2) :
+                               proximity_finder_2D(),
+                               mShape1(aShape1),
+                               mShape2(aShape2) { };
+
+
+void RK_CALL prox_convex_2D::save(ReaK::serialization::oarchive& A, unsigned int) const {
+  proximity_finder_2D::save(A,proximity_finder_2D::getStaticObjectType()->TypeVersion());
+  A & RK_SERIAL_SAVE_WITH_NAME(mShape1)
+    & RK_SERIAL_SAVE_WITH_NAME(mShape2);
+};
+
+void RK_CALL prox_convex_2D::load(ReaK::serialization::iarchive& A, unsigned int) {
+  proximity_finder_2D::load(A,proximity_finder_2D::getStaticObjectType()->TypeVersion());
+  A & RK_SERIAL_LOAD_WITH_NAME(mShape1)
+    & RK_SERIAL_LOAD_WITH_NAME(mShape2);
+  mSimplexDirs.clear();
+};
+
+
+};
+
+};
+
@@ -0,0 +1,101 @@
+/**
+ * \file prox_convex_3D.hpp
+ *
+ * This library declares a class for proximity queries between any two convex 3D shapes (that have 
+ * a support function), based on the GJK / EPA algorithms, warm-started from the previous query.
+ *
+ * \author Mikael Persson, <mikael.s.persson@gmail.com>
+ * \date May 2013
+ */
+
+/*
+ *    Copyright 2013 Sven Mikael Persson
+ *
+ *    THIS SOFTWARE IS DISTRIBUTED UNDER THE TERMS OF THE GNU GENERAL PUBLIC LICENSE v3 (GPLv3).
+ *
+ *    This file is part of ReaK.
+ *
+ *    ReaK is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    (at your option) any later version.
+ *
+ *    ReaK is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with ReaK (as LICENSE in the root folder).  
+ *    If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef REAK_PROX_CONVEX_3D_HPP
+#define REAK_PROX_CONVEX_3D_HPP
+
+#include "proximity_finder_3D.hpp"
+
+#include <vector>
+
+/** Main namespace for ReaK */
+namespace ReaK {
+
+/** Main namespace for ReaK.Geometry */
+namespace geom {
+
+
+/**
+ * This class is for proximity queries between two convex 3D shapes, using the GJK distance 
+ * algorithm (and EPA for penetration depths). The search directions of the last simplex are kept 
+ * to warm-start the next query, which makes repeated queries on slowly moving shapes (e.g., 
+ * along a path) converge in one or two iterations.
+ */
+class prox_convex_3D : public proximity_finder_3D {
+  protected:
+    
+    shared_ptr< shape_3D > mShape1;
+    shared_ptr< shape_3D > mShape2;
+    
+    std::vector< vect<double,3> > mSimplexDirs;
+    
+  public:
+    
+    /** Returns the first shape involved in the proximity query. */
+    virtual shared_ptr< shape_3D > getShape1() const;
+    /** Returns the second shape involved in the proximity query. */
+    virtual shared_ptr< shape_3D > getShape2() const;
+    
+    /** This function performs the proximity query on its associated shapes. */
+    virtual void computeProximity();
+    
+    /** 
+     * Default constructor. 
+     * \param aShape1 The first shape involved in the proximity query (must have a support function).
+     * \param aShape2 The second shape involved in the proximity query (must have a support function).
+     */
+    prox_convex_3D(const shared_ptr< shape_3D >& aShape1 = shared_ptr< shape_3D >(),
+                   const shared_ptr< shape_3D >& aShape2 = shared_ptr< shape_3D >());
+    
+    /** Destructor. */
+    virtual ~prox_convex_3D() { };
+    
+    
+/*******************************************************************************
+                   ReaK's RTTI and Serialization interfaces
+*******************************************************************************/
+    
+    virtual void RK_CALL save(ReaK::serialization::oarchive& A, unsigned int) const;
+    
+    virtual void RK_CALL load(ReaK::serialization::iarchive& A, unsigned int);
+    
+    RK_RTTI_MAKE_ABSTRACT_1BASE(prox_convex_3D,0xC3200021,1,"prox_convex_3D",proximity_finder_3D)
+    
+};
+
+
+};
+
+};
+
+#endif
+
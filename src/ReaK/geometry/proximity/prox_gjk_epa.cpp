@@ -0,0 +1,566 @@
+
+/*
+ *    Copyright 2013 Sven Mikael Persson
+ *
+ *    THIS SOFTWARE IS DISTRIBUTED UNDER THE TERMS OF THE GNU GENERAL PUBLIC LICENSE v3 (GPLv3).
+ *
+ *    This file is part of ReaK.
+ *
+ *    ReaK is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    (at your option) any later version.
+ *
+ *    ReaK is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with ReaK (as LICENSE in the root folder).  
+ *    If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "prox_gjk_epa.hpp"
+
+#include "shapes/circle.hpp"
+#include "shapes/rectangle.hpp"
+#include "shapes/capped_rectangle.hpp"
+
+#include "shapes/sphere.hpp"
+#include "shapes/box.hpp"
+#include "shapes/cylinder.hpp"
+#include "shapes/capped_cylinder.hpp"
+#include "shapes/convex_polyhedron.hpp"
+
+#include <cmath>
+#include <limits>
+#include <algorithm>
+
+/** Main namespace for ReaK */
+namespace ReaK {
+
+/** Main namespace for ReaK.Geometry */
+namespace geom {
+
+
+bool hasSupportFunction(const shape_2D& aShape) {
+  return (aShape.getObjectType() == circle::getStaticObjectType()) ||
+         (aShape.getObjectType() == rectangle::getStaticObjectType()) ||
+         (aShape.getObjectType() == capped_rectangle::getStaticObjectType());
+};
+
+bool hasSupportFunction(const shape_3D& aShape) {
+  return (aShape.getObjectType() == sphere::getStaticObjectType()) ||
+         (aShape.getObjectType() == box::getStaticObjectType()) ||
+         (aShape.getObjectType() == cylinder::getStaticObjectType()) ||
+         (aShape.getObjectType() == capped_cylinder::getStaticObjectType()) ||
+         (aShape.getObjectType() == convex_polyhedron::getStaticObjectType());
+};
+
+
+vect<double,2> getSupportPoint(const shape_2D& aShape, const vect<double,2>& aDirection) {
+  using std::sqrt;
+  vect<double,2> d_rel = aShape.getPose().rotateFromGlobal(aDirection);
+  vect<double,2> p_rel(0.0,0.0);
+  
+  if(aShape.getObjectType() == circle::getStaticObjectType()) {
+    double d_mag = norm_2(d_rel);
+    if(d_mag > std::numeric_limits<double>::epsilon())
+      p_rel = (static_cast<const circle&>(aShape).getRadius() / d_mag) * d_rel;
+  } else if(aShape.getObjectType() == rectangle::getStaticObjectType()) {
+    const vect<double,2>& dims = static_cast<const rectangle&>(aShape).getDimensions();
+    p_rel[0] = (d_rel[0] < 0.0 ? -0.5 : 0.5) * dims[0];
+    p_rel[1] = (d_rel[1] < 0.0 ? -0.5 : 0.5) * dims[1];
+  } else if(aShape.getObjectType() == capped_rectangle::getStaticObjectType()) {
+    // a line-segment along x, swept by a circle of radius half the width.
+    const vect<double,2>& dims = static_cast<const capped_rectangle&>(aShape).getDimensions();
+    p_rel[0] = (d_rel[0] < 0.0 ? -0.5 : 0.5) * dims[0];
+    double d_mag = norm_2(d_rel);
+    if(d_mag > std::numeric_limits<double>::epsilon())
+      p_rel += (0.5 * dims[1] / d_mag) * d_rel;
+  };
+  
+  return aShape.getPose().transformToGlobal(p_rel);
+};
+
+vect<double,3> getSupportPoint(const shape_3D& aShape, const vect<double,3>& aDirection) {
+  using std::sqrt;
+  vect<double,3> d_rel = aShape.getPose().rotateFromGlobal(aDirection);
+  vect<double,3> p_rel(0.0,0.0,0.0);
+  
+  if(aShape.getObjectType() == sphere::getStaticObjectType()) {
+    double d_mag = norm_2(d_rel);
+    if(d_mag > std::numeric_limits<double>::epsilon())
+      p_rel = (static_cast<const sphere&>(aShape).getRadius() / d_mag) * d_rel;
+  } else if(aShape.getObjectType() == box::getStaticObjectType()) {
+    const vect<double,3>& dims = static_cast<const box&>(aShape).getDimensions();
+    p_rel[0] = (d_rel[0] < 0.0 ? -0.5 : 0.5) * dims[0];
+    p_rel[1] = (d_rel[1] < 0.0 ? -0.5 : 0.5) * dims[1];
+    p_rel[2] = (d_rel[2] < 0.0 ? -0.5 : 0.5) * dims[2];
+  } else if(aShape.getObjectType() == cylinder::getStaticObjectType()) {
+    const cylinder& cy = static_cast<const cylinder&>(aShape);
+    double d_rad = sqrt(d_rel[0] * d_rel[0] + d_rel[1] * d_rel[1]);
+    if(d_rad > std::numeric_limits<double>::epsilon()) {
+      p_rel[0] = cy.getRadius() * d_rel[0] / d_rad;
+      p_rel[1] = cy.getRadius() * d_rel[1] / d_rad;
+    };
+    p_rel[2] = (d_rel[2] < 0.0 ? -0.5 : 0.5) * cy.getLength();
+  } else if(aShape.getObjectType() == capped_cylinder::getStaticObjectType()) {
+    // a line-segment along z, swept by a sphere.
+    const capped_cylinder& cc = static_cast<const capped_cylinder&>(aShape);
+    p_rel[2] = (d_rel[2] < 0.0 ? -0.5 : 0.5) * cc.getLength();
+    double d_mag = norm_2(d_rel);
+    if(d_mag > std::numeric_limits<double>::epsilon())
+      p_rel += (cc.getRadius() / d_mag) * d_rel;
+  } else if(aShape.getObjectType() == convex_polyhedron::getStaticObjectType()) {
+    p_rel = static_cast<const convex_polyhedron&>(aShape).getSupportVertex(d_rel);
+  };
+  
+  return aShape.getPose().transformToGlobal(p_rel);
+};
+
+
+
+namespace {
+
+
+/* A vertex of the Minkowski difference (shape1 - shape2), with its generating points and direction. */
+template <unsigned int Size>
+struct gjk_vertex {
+  vect<double,Size> w;
+  vect<double,Size> p1;
+  vect<double,Size> p2;
+  vect<double,Size> dir;
+};
+
+/* A simplex of the Minkowski difference, with the barycentric coordinates of its closest point to the origin. */
+template <unsigned int Size>
+struct gjk_simplex {
+  gjk_vertex<Size> v[Size + 1];
+  double lambda[Size + 1];
+  unsigned int count;
+  
+  gjk_simplex() : count(0) { };
+};
+
+
+template <typename Shape, unsigned int Size>
+gjk_vertex<Size> make_gjk_vertex(const Shape& aShape1, const Shape& aShape2, const vect<double,Size>& aDir) {
+  gjk_vertex<Size> result;
+  result.p1 = getSupportPoint(aShape1, aDir);
+  result.p2 = getSupportPoint(aShape2, -aDir);
+  result.w = result.p1 - result.p2;
+  result.dir = aDir;
+  return result;
+};
+
+
+/* Solves the (at most 3-by-3) linear system A x = b in-place (x is returned in b), by Gaussian 
+ * elimination with partial pivoting. Returns false if the system is (numerically) singular. */
+bool solve_small_system(double A[3][3], double b[3], unsigned int n, double aTolerance) {
+  using std::fabs;
+  for(unsigned int k = 0; k < n; ++k) {
+    unsigned int piv = k;
+    for(unsigned int i = k + 1; i < n; ++i)
+      if(fabs(A[i][k]) > fabs(A[piv][k]))
+        piv = i;
+    if(fabs(A[piv][k]) <= aTolerance)
+      return false;
+    if(piv != k) {
+      for(unsigned int j = 0; j < n; ++j)
+        std::swap(A[k][j], A[piv][j]);
+      std::swap(b[k], b[piv]);
+    };
+    for(unsigned int i = k + 1; i < n; ++i) {
+      double f = A[i][k] / A[k][k];
+      for(unsigned int j = k; j < n; ++j)
+        A[i][j] -= f * A[k][j];
+      b[i] -= f * b[k];
+    };
+  };
+  for(unsigned int k = n; k-- > 0; ) {
+    for(unsigned int j = k + 1; j < n; ++j)
+      b[k] -= A[k][j] * b[j];
+    b[k] /= A[k][k];
+  };
+  return true;
+};
+
+
+/* Computes the barycentric coordinates of the point of the affine hull of the given vertices of 
+ * the simplex that is closest to a point. Returns false if the vertices are affinely dependent. */
+template <unsigned int Size>
+bool get_affine_projection(const gjk_simplex<Size>& aSimplex, const unsigned int* aIdx, unsigned int aCount, 
+                           const vect<double,Size>& aPoint, double* aLambda) {
+  if(aCount == 1) {
+    aLambda[0] = 1.0;
+    return true;
+  };
+  // minimize | w0 + sum_i mu_i (w_i - w0) - p |, through the normal equations.
+  const vect<double,Size>& w0 = aSimplex.v[aIdx[0]].w;
+  vect<double,Size> e[Size];
+  double G[3][3];
+  double rhs[3];
+  double scale = 0.0;
+  unsigned int m = aCount - 1;
+  for(unsigned int i = 0; i < m; ++i) {
+    e[i] = aSimplex.v[aIdx[i + 1]].w - w0;
+    for(unsigned int j = 0; j <= i; ++j)
+      G[i][j] = G[j][i] = e[i] * e[j];
+    rhs[i] = e[i] * (aPoint - w0);
+    if(G[i][i] > scale)
+      scale = G[i][i];
+  };
+  if(!solve_small_system(G, rhs, m, 1e-12 * scale))
+    return false;
+  aLambda[0] = 1.0;
+  for(unsigned int i = 0; i < m; ++i) {
+    aLambda[i + 1] = rhs[i];
+    aLambda[0] -= rhs[i];
+  };
+  return true;
+};
+
+
+/* Finds the point of the simplex closest to the origin (Johnson's distance sub-algorithm, done by 
+ * exhaustive search over the faces of the simplex, which is at most a tetrahedron), reduces the 
+ * simplex to the smallest face that contains that point, and returns the point. */
+template <unsigned int Size>
+vect<double,Size> reduce_simplex_to_closest(gjk_simplex<Size>& aSimplex) {
+  double best_d2 = std::numeric_limits<double>::infinity();
+  unsigned int best_idx[Size + 1];
+  unsigned int best_count = 0;
+  double best_lambda[Size + 1];
+  vect<double,Size> best_v;
+  
+  for(unsigned int mask = 1; mask < (1u << aSimplex.count); ++mask) {
+    unsigned int idx[Size + 1];
+    unsigned int cnt = 0;
+    for(unsigned int i = 0; i < aSimplex.count; ++i)
+      if(mask & (1u << i))
+        idx[cnt++] = i;
+    double lambda[Size + 1];
+    if(!get_affine_projection(aSimplex, idx, cnt, vect<double,Size>(), lambda))
+      continue;
+    bool in_face = true;
+    vect<double,Size> v;
+    for(unsigned int i = 0; i < cnt; ++i) {
+      if(lambda[i] <= 0.0)
+        in_face = false;
+      v += lambda[i] * aSimplex.v[idx[i]].w;
+    };
+    if(!in_face)
+      continue;
+    double d2 = norm_2_sqr(v);
+    if(d2 < best_d2) {
+      best_d2 = d2;
+      best_count = cnt;
+      best_v = v;
+      for(unsigned int i = 0; i < cnt; ++i) {
+        best_idx[i] = idx[i];
+        best_lambda[i] = lambda[i];
+      };
+    };
+  };
+  
+  if(best_count == 0) { // can only happen from round-off, keep the last vertex.
+    aSimplex.v[0] = aSimplex.v[aSimplex.count - 1];
+    aSimplex.lambda[0] = 1.0;
+    aSimplex.count = 1;
+    return aSimplex.v[0].w;
+  };
+  
+  gjk_simplex<Size> reduced;
+  for(unsigned int i = 0; i < best_count; ++i) {
+    reduced.v[i] = aSimplex.v[best_idx[i]];
+    reduced.lambda[i] = best_lambda[i];
+  };
+  reduced.count = best_count;
+  aSimplex = reduced;
+  return best_v;
+};
+
+
+template <unsigned int Size>
+bool is_in_simplex(const gjk_simplex<Size>& aSimplex, const vect<double,Size>& aW, double aTolerance) {
+  for(unsigned int i = 0; i < aSimplex.count; ++i)
+    if(norm_2_sqr(aSimplex.v[i].w - aW) <= aTolerance * aTolerance)
+      return true;
+  return false;
+};
+
+
+/* Runs the GJK iterations, returns true if the shapes intersect (origin within tolerance of the simplex). */
+template <typename Shape, unsigned int Size>
+bool run_gjk(const Shape& aShape1, const Shape& aShape2, 
+             const std::vector< vect<double,Size> >& aSimplexDirs, double aTolerance,
+             gjk_simplex<Size>& aSimplex, vect<double,Size>& aV) {
+  
+  // warm-start from the simplex of the previous query, re-evaluated at the current poses.
+  aSimplex.count = 0;
+  for(std::size_t i = 0; (i < aSimplexDirs.size()) && (aSimplex.count < Size + 1); ++i) {
+    gjk_vertex<Size> wv = make_gjk_vertex(aShape1, aShape2, aSimplexDirs[i]);
+    if(is_in_simplex(aSimplex, wv.w, aTolerance))
+      continue;
+    aSimplex.v[aSimplex.count++] = wv;
+  };
+  if(aSimplex.count == 0) {
+    vect<double,Size> d = aShape2.getPose().transformToGlobal(vect<double,Size>()) 
+                        - aShape1.getPose().transformToGlobal(vect<double,Size>());
+    if(norm_2_sqr(d) <= aTolerance * aTolerance)
+      d[0] = 1.0;
+    aSimplex.v[aSimplex.count++] = make_gjk_vertex(aShape1, aShape2, d);
+  };
+  aV = reduce_simplex_to_closest(aSimplex);
+  
+  for(unsigned int iter = 0; iter < 64; ++iter) {
+    double v2 = norm_2_sqr(aV);
+    if((v2 <= aTolerance * aTolerance) || (aSimplex.count == Size + 1))
+      return true;
+    
+    gjk_vertex<Size> wv = make_gjk_vertex(aShape1, aShape2, -aV);
+    // no significant progress toward the origin, aV is the closest point (to within tolerance).
+    if((v2 - aV * wv.w <= aTolerance * std::sqrt(v2)) || is_in_simplex(aSimplex, wv.w, aTolerance))
+      return false;
+    
+    aSimplex.v[aSimplex.count++] = wv;
+    aV = reduce_simplex_to_closest(aSimplex);
+  };
+  return (norm_2_sqr(aV) <= aTolerance * aTolerance);
+};
+
+
+/* Adds vertices (supports along the axes) until the simplex spans the space, returns false if impossible (flat shapes). */
+template <typename Shape, unsigned int Size>
+bool complete_simplex(const Shape& aShape1, const Shape& aShape2, double aTolerance, gjk_simplex<Size>& aSimplex) {
+  for(unsigned int k = 0; (k < 2 * Size) && (aSimplex.count < Size + 1); ++k) {
+    vect<double,Size> d;
+    d[k / 2] = ((k % 2) ? -1.0 : 1.0);
+    gjk_vertex<Size> wv = make_gjk_vertex(aShape1, aShape2, d);
+    if(aSimplex.count > 0) {
+      // reject the vertex if it lies on the affine hull of the current simplex.
+      unsigned int idx[Size + 1];
+      for(unsigned int i = 0; i < aSimplex.count; ++i)
+        idx[i] = i;
+      double lambda[Size + 1];
+      if(!get_affine_projection(aSimplex, idx, aSimplex.count, wv.w, lambda))
+        return false;
+      vect<double,Size> proj;
+      for(unsigned int i = 0; i < aSimplex.count; ++i)
+        proj += lambda[i] * aSimplex.v[i].w;
+      if(norm_2_sqr(wv.w - proj) <= aTolerance * aTolerance)
+        continue;
+    };
+    aSimplex.v[aSimplex.count++] = wv;
+  };
+  return (aSimplex.count == Size + 1);
+};
+
+
+proximity_record_2D run_epa(const shape_2D& aShape1, const shape_2D& aShape2, double aTolerance, gjk_simplex<2>& aSimplex) {
+  proximity_record_2D result;
+  std::vector< gjk_vertex<2> > poly(aSimplex.v, aSimplex.v + 3);
+  if((poly[1].w - poly[0].w) % (poly[2].w - poly[0].w) < 0.0)
+    std::swap(poly[1], poly[2]);
+  
+  std::size_t best_i = 0;
+  vect<double,2> best_n;
+  double best_d = 0.0;
+  for(unsigned int iter = 0; iter < 64; ++iter) {
+    // find the edge of the (counter-clockwise) polygon that is closest to the origin.
+    best_d = std::numeric_limits<double>::infinity();
+    for(std::size_t i = 0; i < poly.size(); ++i) {
+      vect<double,2> e = poly[(i + 1) % poly.size()].w - poly[i].w;
+      double e_mag = norm_2(e);
+      if(e_mag <= aTolerance)
+        continue;
+      vect<double,2> n(e[1] / e_mag, -e[0] / e_mag);
+      double d = n * poly[i].w;
+      if(d < best_d) {
+        best_d = d;
+        best_n = n;
+        best_i = i;
+      };
+    };
+    
+    if(best_d == std::numeric_limits<double>::infinity()) {
+      // degenerate polygon, report a contact at the GJK solution.
+      result.mPoint1 = aSimplex.v[0].p1;
+      result.mPoint2 = aSimplex.v[0].p1;
+      result.mDistance = 0.0;
+      return result;
+    };
+    
+    gjk_vertex<2> wv = make_gjk_vertex(aShape1, aShape2, best_n);
+    if(wv.w * best_n - best_d <= aTolerance)
+      break;
+    poly.insert(poly.begin() + (best_i + 1), wv);
+  };
+  
+  const gjk_vertex<2>& a = poly[best_i];
+  const gjk_vertex<2>& b = poly[(best_i + 1) % poly.size()];
+  vect<double,2> e = b.w - a.w;
+  double t = ((best_d * best_n - a.w) * e) / (e * e);
+  t = (t < 0.0 ? 0.0 : (t > 1.0 ? 1.0 : t));
+  result.mPoint1 = (1.0 - t) * a.p1 + t * b.p1;
+  result.mPoint2 = (1.0 - t) * a.p2 + t * b.p2;
+  result.mDistance = -best_d;
+  return result;
+};
+
+
+struct epa_face {
+  std::size_t i[3];
+  vect<double,3> n;
+  double d;
+};
+
+bool make_epa_face(const std::vector< gjk_vertex<3> >& aVerts, std::size_t a, std::size_t b, std::size_t c, epa_face& aFace) {
+  vect<double,3> n = (aVerts[b].w - aVerts[a].w) % (aVerts[c].w - aVerts[a].w);
+  double n_mag = norm_2(n);
+  if(n_mag <= std::numeric_limits<double>::epsilon())
+    return false;
+  aFace.i[0] = a; aFace.i[1] = b; aFace.i[2] = c;
+  aFace.n = n / n_mag;
+  aFace.d = aFace.n * aVerts[a].w;
+  return true;
+};
+
+void add_horizon_edge(std::vector< std::pair<std::size_t,std::size_t> >& aEdges, std::size_t a, std::size_t b) {
+  for(std::size_t k = 0; k < aEdges.size(); ++k) {
+    if((aEdges[k].first == b) && (aEdges[k].second == a)) {
+      aEdges.erase(aEdges.begin() + k);
+      return;
+    };
+  };
+  aEdges.push_back(std::pair<std::size_t,std::size_t>(a,b));
+};
+
+proximity_record_3D run_epa(const shape_3D& aShape1, const shape_3D& aShape2, double aTolerance, gjk_simplex<3>& aSimplex) {
+  proximity_record_3D result;
+  std::vector< gjk_vertex<3> > verts(aSimplex.v, aSimplex.v + 4);
+  std::vector< epa_face > faces;
+  
+  // initial tetrahedron, with faces oriented away from its centroid.
+  vect<double,3> centroid = 0.25 * (verts[0].w + verts[1].w + verts[2].w + verts[3].w);
+  const std::size_t tet[4][3] = {{0,1,2},{0,3,1},{0,2,3},{1,3,2}};
+  for(unsigned int k = 0; k < 4; ++k) {
+    epa_face f;
+    if(!make_epa_face(verts, tet[k][0], tet[k][1], tet[k][2], f))
+      continue;
+    if(f.n * (verts[tet[k][0]].w - centroid) < 0.0)
+      make_epa_face(verts, tet[k][0], tet[k][2], tet[k][1], f);
+    faces.push_back(f);
+  };
+  
+  epa_face best;
+  best.d = std::numeric_limits<double>::infinity();
+  for(unsigned int iter = 0; (iter < 64) && !faces.empty(); ++iter) {
+    std::size_t best_k = 0;
+    for(std::size_t k = 1; k < faces.size(); ++k)
+      if(faces[k].d < faces[best_k].d)
+        best_k = k;
+    best = faces[best_k];
+    
+    gjk_vertex<3> wv = make_gjk_vertex(aShape1, aShape2, best.n);
+    if(wv.w * best.n - best.d <= aTolerance)
+      break;
+    
+    // remove the faces seen from the new vertex, and stitch the horizon to it.
+    verts.push_back(wv);
+    std::vector< std::pair<std::size_t,std::size_t> > horizon;
+    for(std::size_t k = faces.size(); k-- > 0; ) {
+      if(faces[k].n * (wv.w - verts[faces[k].i[0]].w) <= 0.0)
+        continue;
+      add_horizon_edge(horizon, faces[k].i[0], faces[k].i[1]);
+      add_horizon_edge(horizon, faces[k].i[1], faces[k].i[2]);
+      add_horizon_edge(horizon, faces[k].i[2], faces[k].i[0]);
+      faces.erase(faces.begin() + k);
+    };
+    for(std::size_t k = 0; k < horizon.size(); ++k) {
+      epa_face f;
+      if(make_epa_face(verts, horizon[k].first, horizon[k].second, verts.size() - 1, f))
+        faces.push_back(f);
+    };
+  };
+  
+  if(best.d == std::numeric_limits<double>::infinity()) {
+    // degenerate polytope, report a contact at the GJK solution.
+    result.mPoint1 = aSimplex.v[0].p1;
+    result.mPoint2 = aSimplex.v[0].p1;
+    result.mDistance = 0.0;
+    return result;
+  };
+  
+  // barycentric coordinates of the origin's projection on the closest face.
+  const gjk_vertex<3>& a = verts[best.i[0]];
+  const gjk_vertex<3>& b = verts[best.i[1]];
+  const gjk_vertex<3>& c = verts[best.i[2]];
+  vect<double,3> q = best.d * best.n;
+  double area = ((b.w - a.w) % (c.w - a.w)) * best.n;
+  double la = (((b.w - q) % (c.w - q)) * best.n) / area;
+  double lb = (((c.w - q) % (a.w - q)) * best.n) / area;
+  double lc = 1.0 - la - lb;
+  result.mPoint1 = la * a.p1 + lb * b.p1 + lc * c.p1;
+  result.mPoint2 = la * a.p2 + lb * b.p2 + lc * c.p2;
+  result.mDistance = -best.d;
+  return result;
+};
+
+
+template <typename Shape, typename Record, unsigned int Size>
+Record find_proximity_gjk_epa(const Shape& aShape1, const Shape& aShape2, 
+                              std::vector< vect<double,Size> >& aSimplexDirs) {
+  double tol = 1e-9 * (aShape1.getBoundingRadius() + aShape2.getBoundingRadius());
+  if(tol < std::numeric_limits<double>::epsilon())
+    tol = std::numeric_limits<double>::epsilon();
+  
+  gjk_simplex<Size> s;
+  vect<double,Size> v;
+  bool intersects = run_gjk(aShape1, aShape2, aSimplexDirs, tol, s, v);
+  
+  aSimplexDirs.clear();
+  for(unsigned int i = 0; i < s.count; ++i)
+    aSimplexDirs.push_back(s.v[i].dir);
+  
+  if(!intersects) {
+    Record result;
+    result.mPoint1 = vect<double,Size>();
+    result.mPoint2 = vect<double,Size>();
+    for(unsigned int i = 0; i < s.count; ++i) {
+      result.mPoint1 += s.lambda[i] * s.v[i].p1;
+      result.mPoint2 += s.lambda[i] * s.v[i].p2;
+    };
+    result.mDistance = norm_2(v);
+    return result;
+  };
+  
+  if(!complete_simplex(aShape1, aShape2, tol, s)) {
+    Record result;
+    result.mPoint1 = s.v[0].p1;
+    result.mPoint2 = s.v[0].p1;
+    result.mDistance = 0.0;
+    return result;
+  };
+  return run_epa(aShape1, aShape2, tol, s);
+};
+
+
+};
+
+
+proximity_record_2D findProximityByGJKEPA(const shape_2D& aShape1, const shape_2D& aShape2, 
+                                          std::vector< vect<double,2> >& aSimplexDirs) {
+  return find_proximity_gjk_epa<shape_2D, proximity_record_2D, 2>(aShape1, aShape2, aSimplexDirs);
+};
+
+proximity_record_3D findProximityByGJKEPA(const shape_3D& aShape1, const shape_3D& aShape2, 
+                                          std::vector< vect<double,3> >& aSimplexDirs) {
+  return find_proximity_gjk_epa<shape_3D, proximity_record_3D, 3>(aShape1, aShape2, aSimplexDirs);
+};
+
+
+};
+
+};
+
@@ -0,0 +1,120 @@
+/**
+ * \file prox_gjk_epa.hpp
+ *
+ * This library declares the support functions of the convex shapes (2D and 3D), and 
+ * a generic proximity query between any two convex shapes based on the 
+ * Gilbert-Johnson-Keerthi (GJK) distance algorithm, completed by the Expanding 
+ * Polytope Algorithm (EPA) for the penetration depth of intersecting shapes.
+ *
+ * \author Mikael Persson, <mikael.s.persson@gmail.com>
+ * \date May 2013
+ */
+
+/*
+ *    Copyright 2013 Sven Mikael Persson
+ *
+ *    THIS SOFTWARE IS DISTRIBUTED UNDER THE TERMS OF THE GNU GENERAL PUBLIC LICENSE v3 (GPLv3).
+ *
+ *    This file is part of ReaK.
+ *
+ *    ReaK is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    (at your option) any later version.
+ *
+ *    ReaK is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with ReaK (as LICENSE in the root folder).  
+ *    If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef REAK_PROX_GJK_EPA_HPP
+#define REAK_PROX_GJK_EPA_HPP
+
+#include "proximity_record_2D.hpp"
+#include "proximity_record_3D.hpp"
+
+#include "shapes/shape_2D.hpp"
+#include "shapes/shape_3D.hpp"
+
+#include <vector>
+
+/** Main namespace for ReaK */
+namespace ReaK {
+
+/** Main namespace for ReaK.Geometry */
+namespace geom {
+
+
+/**
+ * This function checks if a support function is available for a given 2D shape 
+ * (i.e., if it is a bounded convex primitive: circle, rectangle or capped rectangle).
+ * \param aShape The shape to check.
+ * \return True if getSupportPoint can be called for the shape.
+ */
+bool hasSupportFunction(const shape_2D& aShape);
+
+/**
+ * This function checks if a support function is available for a given 3D shape 
+ * (i.e., if it is a bounded convex primitive: sphere, box, cylinder, capped cylinder or convex polyhedron).
+ * \param aShape The shape to check.
+ * \return True if getSupportPoint can be called for the shape.
+ */
+bool hasSupportFunction(const shape_3D& aShape);
+
+/**
+ * This function computes the support point of a 2D shape, that is, the point of the shape that is 
+ * furthest along a given direction.
+ * \param aShape The shape (must have a support function, see hasSupportFunction).
+ * \param aDirection The direction (in global coordinates), needs not be normalized.
+ * \return The support point (in global coordinates).
+ */
+vect<double,2> getSupportPoint(const shape_2D& aShape, const vect<double,2>& aDirection);
+
+/**
+ * This function computes the support point of a 3D shape, that is, the point of the shape that is 
+ * furthest along a given direction.
+ * \param aShape The shape (must have a support function, see hasSupportFunction).
+ * \param aDirection The direction (in global coordinates), needs not be normalized.
+ * \return The support point (in global coordinates).
+ */
+vect<double,3> getSupportPoint(const shape_3D& aShape, const vect<double,3>& aDirection);
+
+
+/**
+ * This function computes the proximity between two convex 2D shapes using the GJK algorithm 
+ * (and EPA if the shapes intersect).
+ * \param aShape1 The first shape (must have a support function).
+ * \param aShape2 The second shape (must have a support function).
+ * \param aSimplexDirs The search directions that generated the simplex of a previous query on 
+ *                     the same shapes, used to warm-start the search (can be empty), and 
+ *                     overwritten with the directions of the final simplex of this query.
+ * \return The proximity record (point1 on shape1, point2 on shape2, negative distance for penetration).
+ */
+proximity_record_2D findProximityByGJKEPA(const shape_2D& aShape1, const shape_2D& aShape2, 
+                                          std::vector< vect<double,2> >& aSimplexDirs);
+
+/**
+ * This function computes the proximity between two convex 3D shapes using the GJK algorithm 
+ * (and EPA if the shapes intersect).
+ * \param aShape1 The first shape (must have a support function).
+ * \param aShape2 The second shape (must have a support function).
+ * \param aSimplexDirs The search directions that generated the simplex of a previous query on 
+ *                     the same shapes, used to warm-start the search (can be empty), and 
+ *                     overwritten with the directions of the final simplex of this query.
+ * \return The proximity record (point1 on shape1, point2 on shape2, negative distance for penetration).
+ */
+proximity_record_3D findProximityByGJKEPA(const shape_3D& aShape1, const shape_3D& aShape2, 
+                                          std::vector< vect<double,3> >& aSimplexDirs);
+
+
+};
+
+};
+
+#endif
+
@@ -65,6 +65,10 @@
 #include "prox_cylinder_box.hpp"           // NOTE: not working.
 #include "prox_box_box.hpp"                // NOTE: not working.
 
+#include "prox_gjk_epa.hpp"
+#include "prox_convex_2D.hpp"
+#include "prox_convex_3D.hpp"
+
 
 namespace ReaK {
 
@@ -85,6 +89,7 @@ void proxy_query_pair_2D::createProxFinderList() {
     for(std::size_t j = 0; j < mModel2->mShapeList.size(); ++j) {
       if(!mModel2->mShapeList[j])
         continue;
+      std::size_t prev_count = mProxFinders.size();
       // if one of the model is a circle?
       if((mModel1->mShapeList[i]->getObjectType() == circle::getStaticObjectType()) ||
          (mModel2->mShapeList[j]->getObjectType() == circle::getStaticObjectType())) {
@@ -154,6 +159,11 @@ void proxy_query_pair_2D::createProxFinderList() {
           mProxFinders.push_back(shared_ptr< prox_rectangle_rectangle >(new prox_rectangle_rectangle(re_geom, re2_geom)));
         };
       };
+      
+      // otherwise, any other pair of convex shapes is handled by GJK / EPA.
+      if((mProxFinders.size() == prev_count) && 
+         hasSupportFunction(*mModel1->mShapeList[i]) && hasSupportFunction(*mModel2->mShapeList[j]))
+        mProxFinders.push_back(shared_ptr< prox_convex_2D >(new prox_convex_2D(mModel1->mShapeList[i], mModel2->mShapeList[j])));
     };
   };
   
@@ -226,6 +236,7 @@ void proxy_query_pair_3D::createProxFinderList() {
     for(std::size_t j = 0; j < mModel2->mShapeList.size(); ++j) {
       if(!mModel2->mShapeList[j])
         continue;
+      std::size_t prev_count = mProxFinders.size();
       
       // if one of the model is a plane?
       if((mModel1->mShapeList[i]->getObjectType() == plane::getStaticObjectType()) ||
@@ -318,7 +329,7 @@ void proxy_query_pair_3D::createProxFinderList() {
         // if the other is a cylinder..
         else if(other_geom->getObjectType() == cylinder::getStaticObjectType()) {
           shared_ptr<cylinder> cy_geom = rtti::rk_static_ptr_cast<cylinder>(other_geom);
-          //mProxFinders.push_back(shared_ptr< prox_ccylinder_cylinder >(new prox_ccylinder_cylinder(cc_geom, cy_geom)));
+          mProxFinders.push_back(shared_ptr< prox_convex_3D >(new prox_convex_3D(cc_geom, cy_geom)));
         }
         // if the other is a box..
         else if(other_geom->getObjectType() == box::getStaticObjectType()) {
@@ -341,12 +352,12 @@ void proxy_query_pair_3D::createProxFinderList() {
         // if the other is a cylinder..
         if(other_geom->getObjectType() == cylinder::getStaticObjectType()) {
           shared_ptr<cylinder> cy2_geom = rtti::rk_static_ptr_cast<cylinder>(other_geom);
-          //mProxFinders.push_back(shared_ptr< prox_cylinder_cylinder >(new prox_cylinder_cylinder(cy_geom, cy2_geom)));
+          mProxFinders.push_back(shared_ptr< prox_convex_3D >(new prox_convex_3D(cy_geom, cy2_geom)));
         }
         // if the other is a box..
         else if(other_geom->getObjectType() == box::getStaticObjectType()) {
           shared_ptr<box> bx_geom = rtti::rk_static_ptr_cast<box>(other_geom);
-          //mProxFinders.push_back(shared_ptr< prox_cylinder_box >(new prox_cylinder_box(cy_geom, bx_geom)));
+          mProxFinders.push_back(shared_ptr< prox_convex_3D >(new prox_convex_3D(cy_geom, bx_geom)));
         };
       }
       // if one of the model is a box?
@@ -364,9 +375,14 @@ void proxy_query_pair_3D::createProxFinderList() {
         // if the other is a box..
         if(other_geom->getObjectType() == box::getStaticObjectType()) {
           shared_ptr<box> bx2_geom = rtti::rk_static_ptr_cast<box>(other_geom);
-          //mProxFinders.push_back(shared_ptr< prox_box_box >(new prox_box_box(bx_geom, bx2_geom)));
+          mProxFinders.push_back(shared_ptr< prox_convex_3D >(new prox_convex_3D(bx_geom, bx2_geom)));
         };
       };
+      
+      // otherwise, any other pair of convex shapes is handled by GJK / EPA.
+      if((mProxFinders.size() == prev_count) && 
+         hasSupportFunction(*mModel1->mShapeList[i]) && hasSupportFunction(*mModel2->mShapeList[j]))
+        mProxFinders.push_back(shared_ptr< prox_convex_3D >(new prox_convex_3D(mModel1->mShapeList[i], mModel2->mShapeList[j])));
     };
   };
   
@@ -399,6 +415,11 @@ shared_ptr< proximity_finder_3D > proxy_query_pair_3D::findMinimumDistance() con
   return mProxFinders[min_i];
 };
     
+bool proxy_query_pair_3D::isCollisionFree() const {
+  shared_ptr< proximity_finder_3D > tmp = findMinimumDistance();
+  return !((tmp) && (tmp->getLastResult().mDistance < 0.0));
+};
+
 bool proxy_query_pair_3D::gatherCollisionPoints(std::vector< proximity_record_3D >& aOutput) const {
   bool collision_found = false;
   
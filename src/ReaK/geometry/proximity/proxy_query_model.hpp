@@ -231,6 +231,12 @@ class proxy_query_pair_3D : public named_object {
     
     virtual bool gatherCollisionPoints(std::vector< proximity_record_3D >& aOutput) const;
     
+    /**
+     * Checks if the two models are free of collision.
+     * \return True if the two models are not colliding.
+     */
+    virtual bool isCollisionFree() const;
+    
     
 /*******************************************************************************
                    ReaK's RTTI and Serialization interfaces
@@ -0,0 +1,438 @@
+
+/*
+ *    Copyright 2013 Sven Mikael Persson
+ *
+ *    THIS SOFTWARE IS DISTRIBUTED UNDER THE TERMS OF THE GNU GENERAL PUBLIC LICENSE v3 (GPLv3).
+ *
+ *    This file is part of ReaK.
+ *
+ *    ReaK is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    (at your option) any later version.
+ *
+ *    ReaK is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with ReaK (as LICENSE in the root folder).  
+ *    If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "proxy_sdf_grid.hpp"
+
+#include "shapes/sphere.hpp"
+
+#include <cmath>
+#include <limits>
+#include <fstream>
+#include <algorithm>
+#include <stdexcept>
+#include <cstring>
+
+#ifndef WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+namespace ReaK {
+
+namespace geom {
+
+
+/* A read-only view of a whole file, memory-mapped where the platform supports it. */
+class proxy_sdf_grid_3D::raw_file_mapping {
+  private:
+    const char* mData;
+    std::size_t mSize;
+#ifdef WIN32
+    std::vector<double> mBuffer;  // a buffer of doubles, such that the node values are aligned.
+#endif
+    
+    raw_file_mapping(const raw_file_mapping&);
+    raw_file_mapping& operator=(const raw_file_mapping&);
+    
+  public:
+    const char* data() const { return mData; };
+    std::size_t size() const { return mSize; };
+    
+#ifdef WIN32
+    explicit raw_file_mapping(const std::string& aFileName) : mData(NULL), mSize(0), mBuffer() {
+      std::ifstream in(aFileName.c_str(), std::ios::binary);
+      if(!in)
+        throw std::ios_base::failure("The file '" + aFileName + "' could not be opened!");
+      in.seekg(0, std::ios::end);
+      mSize = static_cast<std::size_t>(in.tellg());
+      in.seekg(0);
+      mBuffer.resize(mSize / sizeof(double) + 1);
+      mData = reinterpret_cast<const char*>(&mBuffer[0]);
+      if(!in.read(reinterpret_cast<char*>(&mBuffer[0]), mSize))
+        throw std::ios_base::failure("The file '" + aFileName + "' could not be read!");
+    };
+    
+    ~raw_file_mapping() { };
+#else
+    explicit raw_file_mapping(const std::string& aFileName) : mData(NULL), mSize(0) {
+      int fd = ::open(aFileName.c_str(), O_RDONLY);
+      if(fd < 0)
+        throw std::ios_base::failure("The file '" + aFileName + "' could not be opened!");
+      struct stat st;
+      if(::fstat(fd, &st) != 0) {
+        ::close(fd);
+        throw std::ios_base::failure("The file '" + aFileName + "' could not be read!");
+      };
+      mSize = static_cast<std::size_t>(st.st_size);
+      if(mSize == 0) {  // an empty file cannot be mapped, it is rejected as too short later.
+        ::close(fd);
+        return;
+      };
+      void* p = ::mmap(NULL, mSize, PROT_READ, MAP_PRIVATE, fd, 0);
+      ::close(fd);  // the mapping remains valid once the descriptor is closed.
+      if(p == MAP_FAILED) {
+        mSize = 0;
+        throw std::ios_base::failure("The file '" + aFileName + "' could not be memory-mapped!");
+      };
+      mData = static_cast<const char*>(p);
+    };
+    
+    ~raw_file_mapping() {
+      if(mData)
+        ::munmap(const_cast<char*>(mData), mSize);
+    };
+#endif
+};
+
+
+vect<double,3> proxy_sdf_grid_3D::getUpperCorner() const {
+  if(getNodeCount() == 0)
+    return mLowerCorner;
+  return mLowerCorner + mCellSize * vect<double,3>(mDims[0] - 1, mDims[1] - 1, mDims[2] - 1);
+};
+
+bool proxy_sdf_grid_3D::isValidGrid(const unsigned int* aDims, double aCellSize, std::size_t aNodeCount) {
+  if((aDims[0] < 2) || (aDims[1] < 2) || (aDims[2] < 2) || !(aCellSize > 0.0))
+    return false;
+  return (aNodeCount == std::size_t(aDims[0]) * aDims[1] * aDims[2]);
+};
+
+bool proxy_sdf_grid_3D::isInside(const vect<double,3>& aPoint) const {
+  if(!isValidGrid(mDims, mCellSize, getNodeCount()))
+    return false;
+  vect<double,3> up = getUpperCorner();
+  for(unsigned int i = 0; i < 3; ++i)
+    if((aPoint[i] < mLowerCorner[i]) || (aPoint[i] > up[i]))
+      return false;
+  return true;
+};
+
+void proxy_sdf_grid_3D::computeGrid(const shared_ptr< proxy_query_model_3D >& aModel, 
+                                    const vect<double,3>& aLowerCorner, 
+                                    const vect<double,3>& aUpperCorner, 
+                                    double aCellSize) {
+  if(!(aCellSize > 0.0))
+    throw std::range_error("The cell size of a signed-distance grid must be positive!");
+  mLowerCorner = aLowerCorner;
+  mCellSize = aCellSize;
+  for(unsigned int i = 0; i < 3; ++i) {
+    double n = std::ceil((aUpperCorner[i] - aLowerCorner[i]) / aCellSize);
+    mDims[i] = (n < 1.0 ? 2 : static_cast<unsigned int>(n) + 1);
+  };
+  mDistances.resize(std::size_t(mDims[0]) * mDims[1] * mDims[2]);
+  mMapping.reset(); mMappedNodes = NULL; mMappedCount = 0;
+  
+  // a point-like probe is moved to each node, and the exact proximity queries give the signed-distance.
+  shared_ptr< sphere > probe(new sphere("sdf_probe", shared_ptr< pose_3D<double> >(), pose_3D<double>(), 0.0));
+  shared_ptr< proxy_query_model_3D > probe_model(new proxy_query_model_3D("sdf_probe_model"));
+  probe_model->addShape(probe);
+  proxy_query_pair_3D probe_pair("sdf_probe_pair", probe_model, aModel);
+  
+  std::size_t l = 0;
+  for(unsigned int i = 0; i < mDims[0]; ++i) {
+    for(unsigned int j = 0; j < mDims[1]; ++j) {
+      for(unsigned int k = 0; k < mDims[2]; ++k, ++l) {
+        probe->setPose(pose_3D<double>(weak_ptr< pose_3D<double> >(), 
+                                       mLowerCorner + mCellSize * vect<double,3>(i,j,k), 
+                                       quaternion<double>()));
+        shared_ptr< proximity_finder_3D > tmp = probe_pair.findMinimumDistance();
+        if(tmp)
+          mDistances[l] = tmp->getLastResult().mDistance;
+        else
+          mDistances[l] = std::numeric_limits<double>::infinity();
+      };
+    };
+  };
+};
+
+void proxy_sdf_grid_3D::getCell(const vect<double,3>& aPoint, unsigned int* aCell, double* aFraction) const {
+  for(unsigned int i = 0; i < 3; ++i) {
+    double r = (aPoint[i] - mLowerCorner[i]) / mCellSize;
+    aCell[i] = static_cast<unsigned int>(r);
+    if(aCell[i] > mDims[i] - 2)
+      aCell[i] = mDims[i] - 2;
+    aFraction[i] = r - aCell[i];
+  };
+};
+
+double proxy_sdf_grid_3D::getDistance(const vect<double,3>& aPoint) const {
+  if(!isInside(aPoint))
+    return -std::numeric_limits<double>::infinity();
+  
+  unsigned int c[3]; double f[3];
+  getCell(aPoint, c, f);
+  
+  double result = 0.0;
+  for(unsigned int n = 0; n < 8; ++n) {
+    unsigned int di = (n & 1), dj = ((n >> 1) & 1), dk = ((n >> 2) & 1);
+    double w = (di ? f[0] : 1.0 - f[0]) * (dj ? f[1] : 1.0 - f[1]) * (dk ? f[2] : 1.0 - f[2]);
+    result += w * getNodeDistance(c[0] + di, c[1] + dj, c[2] + dk);
+  };
+  return result;
+};
+
+vect<double,3> proxy_sdf_grid_3D::getGradient(const vect<double,3>& aPoint) const {
+  if(!isInside(aPoint))
+    return vect<double,3>(0.0, 0.0, 0.0);
+  
+  unsigned int c[3]; double f[3];
+  getCell(aPoint, c, f);
+  
+  // derivative of each trilinear weight along each axis (the factor of that axis becomes -1 or +1).
+  vect<double,3> result(0.0, 0.0, 0.0);
+  for(unsigned int n = 0; n < 8; ++n) {
+    unsigned int di = (n & 1), dj = ((n >> 1) & 1), dk = ((n >> 2) & 1);
+    double wi = (di ? f[0] : 1.0 - f[0]), wj = (dj ? f[1] : 1.0 - f[1]), wk = (dk ? f[2] : 1.0 - f[2]);
+    double d = getNodeDistance(c[0] + di, c[1] + dj, c[2] + dk);
+    result[0] += (di ? 1.0 : -1.0) * wj * wk * d;
+    result[1] += (dj ? 1.0 : -1.0) * wi * wk * d;
+    result[2] += (dk ? 1.0 : -1.0) * wi * wj * d;
+  };
+  return result * (1.0 / mCellSize);
+};
+
+double proxy_sdf_grid_3D::getDistanceLowerBound(const vect<double,3>& aPoint) const {
+  if(!isInside(aPoint))
+    return -std::numeric_limits<double>::infinity();
+  
+  unsigned int c[3];
+  for(unsigned int i = 0; i < 3; ++i) {
+    c[i] = static_cast<unsigned int>((aPoint[i] - mLowerCorner[i]) / mCellSize);
+    if(c[i] > mDims[i] - 2)
+      c[i] = mDims[i] - 2;
+  };
+  
+  // the signed-distance is 1-Lipschitz, so each node gives a valid lower-bound, take the tightest.
+  double result = -std::numeric_limits<double>::infinity();
+  for(unsigned int n = 0; n < 8; ++n) {
+    unsigned int di = (n & 1), dj = ((n >> 1) & 1), dk = ((n >> 2) & 1);
+    vect<double,3> node = mLowerCorner + mCellSize * vect<double,3>(c[0] + di, c[1] + dj, c[2] + dk);
+    double d = getNodeDistance(c[0] + di, c[1] + dj, c[2] + dk) - norm_2(aPoint - node);
+    if(d > result)
+      result = d;
+  };
+  return result;
+};
+
+
+static const char sdf_raw_file_signature[8] = {'R','K','S','D','F','3','D','\0'};
+static const unsigned int sdf_raw_file_version = 1;
+static const std::size_t sdf_raw_file_header_size = 8 + 4 * sizeof(unsigned int) + 4 * sizeof(double);
+
+/*
+ * Layout of the raw file (native endianness), such that the node values start on an 8-byte boundary:
+ *  [0,8)   signature "RKSDF3D"
+ *  [8,12)  file format version
+ *  [12,24) number of nodes along x, y and z
+ *  [24,56) lower corner (x,y,z) and cell size
+ *  [56,..) node values
+ */
+
+void proxy_sdf_grid_3D::saveRawFile(const std::string& aFileName) const {
+  std::ofstream out(aFileName.c_str(), std::ios::binary);
+  out.exceptions(std::ios::failbit | std::ios::badbit);
+  out.write(sdf_raw_file_signature, 8);
+  out.write(reinterpret_cast<const char*>(&sdf_raw_file_version), sizeof(unsigned int));
+  out.write(reinterpret_cast<const char*>(mDims), 3 * sizeof(unsigned int));
+  double header[4] = {mLowerCorner[0], mLowerCorner[1], mLowerCorner[2], mCellSize};
+  out.write(reinterpret_cast<const char*>(header), 4 * sizeof(double));
+  if(getNodeCount() > 0)
+    out.write(reinterpret_cast<const char*>(getNodes()), getNodeCount() * sizeof(double));
+};
+
+void proxy_sdf_grid_3D::loadRawFile(const std::string& aFileName) {
+  shared_ptr< raw_file_mapping > file(new raw_file_mapping(aFileName));
+  const char* data = file->data();
+  if((file->size() < sdf_raw_file_header_size) || !std::equal(data, data + 8, sdf_raw_file_signature))
+    throw std::ios_base::failure("The file '" + aFileName + "' is not a signed-distance grid file of a supported version!");
+  unsigned int version = 0;
+  std::memcpy(&version, data + 8, sizeof(unsigned int));
+  if(version != sdf_raw_file_version)
+    throw std::ios_base::failure("The file '" + aFileName + "' is not a signed-distance grid file of a supported version!");
+  unsigned int dims[3];
+  double header[4];
+  std::memcpy(dims, data + 8 + sizeof(unsigned int), 3 * sizeof(unsigned int));
+  std::memcpy(header, data + 8 + 4 * sizeof(unsigned int), 4 * sizeof(double));
+  
+  // check that the header is consistent and that the file holds exactly the node values it announces.
+  std::size_t data_size = file->size() - sdf_raw_file_header_size;
+  if((data_size % sizeof(double) != 0) || !isValidGrid(dims, header[3], data_size / sizeof(double)))
+    throw std::ios_base::failure("The signed-distance grid file '" + aFileName + "' is corrupt or truncated!");
+  
+  // the node values start on an 8-byte boundary of the (page-aligned) mapping, they are used in place.
+  mLowerCorner = vect<double,3>(header[0], header[1], header[2]);
+  mCellSize = header[3];
+  std::copy(dims, dims + 3, mDims);
+  std::vector<double>().swap(mDistances);
+  mMappedNodes = reinterpret_cast<const double*>(data + sdf_raw_file_header_size);
+  mMappedCount = data_size / sizeof(double);
+  mMapping = file;
+};
+
+
+proxy_sdf_grid_3D::proxy_sdf_grid_3D(const std::string& aName) : 
+                                     named_object(), mLowerCorner(), mCellSize(1.0), mDistances(), 
+                                     mMapping(), mMappedNodes(NULL), mMappedCount(0) {
+  setName(aName);
+  mDims[0] = 0; mDims[1] = 0; mDims[2] = 0;
+};
+
+void RK_CALL proxy_sdf_grid_3D::save(ReaK::serialization::oarchive& A, unsigned int) const {
+  named_object::save(A,named_object::getStaticObjectType()->TypeVersion());
+  A & RK_SERIAL_SAVE_WITH_NAME(mLowerCorner)
+    & RK_SERIAL_SAVE_WITH_NAME(mCellSize)
+    & RK_SERIAL_SAVE_WITH_ALIAS("mDimX",mDims[0])
+    & RK_SERIAL_SAVE_WITH_ALIAS("mDimY",mDims[1])
+    & RK_SERIAL_SAVE_WITH_ALIAS("mDimZ",mDims[2]);
+  if(mMappedNodes) {
+    std::vector<double> distances(mMappedNodes, mMappedNodes + mMappedCount);
+    A & RK_SERIAL_SAVE_WITH_ALIAS("mDistances",distances);
+  } else
+    A & RK_SERIAL_SAVE_WITH_NAME(mDistances);
+};
+
+void RK_CALL proxy_sdf_grid_3D::load(ReaK::serialization::iarchive& A, unsigned int) {
+  named_object::load(A,named_object::getStaticObjectType()->TypeVersion());
+  vect<double,3> lower_corner;
+  double cell_size = 0.0;
+  unsigned int dims[3] = {0, 0, 0};
+  std::vector<double> distances;
+  A & RK_SERIAL_LOAD_WITH_ALIAS("mLowerCorner",lower_corner)
+    & RK_SERIAL_LOAD_WITH_ALIAS("mCellSize",cell_size)
+    & RK_SERIAL_LOAD_WITH_ALIAS("mDimX",dims[0])
+    & RK_SERIAL_LOAD_WITH_ALIAS("mDimY",dims[1])
+    & RK_SERIAL_LOAD_WITH_ALIAS("mDimZ",dims[2])
+    & RK_SERIAL_LOAD_WITH_ALIAS("mDistances",distances);
+  if(!isValidGrid(dims, cell_size, distances.size()))
+    throw std::range_error("The loaded signed-distance grid has inconsistent dimensions!");
+  mLowerCorner = lower_corner;
+  mCellSize = cell_size;
+  std::copy(dims, dims + 3, mDims);
+  mDistances.swap(distances);
+  mMapping.reset(); mMappedNodes = NULL; mMappedCount = 0;
+};
+
+
+
+
+void proxy_query_sdf_pair_3D::computeGrid(const vect<double,3>& aLowerCorner, 
+                                          const vect<double,3>& aUpperCorner, 
+                                          double aCellSize) {
+  if(!mModel2)
+    return;
+  if(!mGrid)
+    mGrid = shared_ptr< proxy_sdf_grid_3D >(new proxy_sdf_grid_3D(this->getName() + "_sdf_grid"));
+  mGrid->computeGrid(mModel2, aLowerCorner, aUpperCorner, aCellSize);
+};
+
+
+namespace {
+
+// collects the shapes of the model that are provably clear of the static model according to the grid.
+void get_sdf_cleared_shapes(const proxy_sdf_grid_3D& aGrid, 
+                            const proxy_query_model_3D& aModel, 
+                            std::vector< const shape_3D* >& aCleared) {
+  for(std::size_t i = 0; i < aModel.mShapeList.size(); ++i) {
+    if(!aModel.mShapeList[i])
+      continue;
+    vect<double,3> c = aModel.mShapeList[i]->getPose().transformToGlobal(vect<double,3>(0.0,0.0,0.0));
+    if(aGrid.getDistanceLowerBound(c) - aModel.mShapeList[i]->getBoundingRadius() > 0.0)
+      aCleared.push_back(aModel.mShapeList[i].get());
+  };
+};
+
+bool is_sdf_cleared_finder(const proximity_finder_3D& aFinder, 
+                           const std::vector< const shape_3D* >& aCleared) {
+  const shape_3D* s1 = aFinder.getShape1().get();
+  const shape_3D* s2 = aFinder.getShape2().get();
+  for(std::size_t i = 0; i < aCleared.size(); ++i)
+    if((aCleared[i] == s1) || (aCleared[i] == s2))
+      return true;
+  return false;
+};
+
+};
+
+
+bool proxy_query_sdf_pair_3D::isCollisionFree() const {
+  if(!mGrid || !mModel1)
+    return proxy_query_pair_3D::isCollisionFree();
+  
+  std::vector< const shape_3D* > cleared;
+  get_sdf_cleared_shapes(*mGrid, *mModel1, cleared);
+  
+  for(std::size_t i = 0; i < mProxFinders.size(); ++i) {
+    if(is_sdf_cleared_finder(*mProxFinders[i], cleared))
+      continue;
+    
+    vect<double,3> p1 = mProxFinders[i]->getShape1()->getPose().transformToGlobal(vect<double,3>(0.0,0.0,0.0));
+    vect<double,3> p2 = mProxFinders[i]->getShape2()->getPose().transformToGlobal(vect<double,3>(0.0,0.0,0.0));
+    if(norm_2(p2 - p1) - mProxFinders[i]->getShape1()->getBoundingRadius() 
+                       - mProxFinders[i]->getShape2()->getBoundingRadius() > 0.0)
+      continue;
+    
+    mProxFinders[i]->computeProximity();
+    if(mProxFinders[i]->getLastResult().mDistance < 0.0)
+      return false;
+  };
+  
+  return true;
+};
+
+bool proxy_query_sdf_pair_3D::gatherCollisionPoints(std::vector< proximity_record_3D >& aOutput) const {
+  if(!mGrid || !mModel1)
+    return proxy_query_pair_3D::gatherCollisionPoints(aOutput);
+  
+  std::vector< const shape_3D* > cleared;
+  get_sdf_cleared_shapes(*mGrid, *mModel1, cleared);
+  
+  bool collision_found = false;
+  for(std::size_t i = 0; i < mProxFinders.size(); ++i) {
+    if(is_sdf_cleared_finder(*mProxFinders[i], cleared))
+      continue;
+    
+    vect<double,3> p1 = mProxFinders[i]->getShape1()->getPose().transformToGlobal(vect<double,3>(0.0,0.0,0.0));
+    vect<double,3> p2 = mProxFinders[i]->getShape2()->getPose().transformToGlobal(vect<double,3>(0.0,0.0,0.0));
+    if(norm_2(p2 - p1) - mProxFinders[i]->getShape1()->getBoundingRadius() 
+                       - mProxFinders[i]->getShape2()->getBoundingRadius() > 0.0)
+      continue;
+    
+    mProxFinders[i]->computeProximity();
+    if(mProxFinders[i]->getLastResult().mDistance < 0.0) {
+      aOutput.push_back(mProxFinders[i]->getLastResult());
+      collision_found = true;
+    };
+  };
+  
+  return collision_found;
+};
+
+
+
+};
+
+
+};
+
@@ -0,0 +1,289 @@
+/**
+ * \file proxy_sdf_grid.hpp
+ *
+ * This library declares a class that stores a signed-distance grid of a static proximity-query model, 
+ * and a proximity-query pair that uses it to screen out exact proximity queries that cannot 
+ * result in a collision.
+ *
+ * \author Mikael Persson, <mikael.s.persson@gmail.com>
+ * \date May 2013
+ */
+
+/*
+ *    Copyright 2013 Sven Mikael Persson
+ *
+ *    THIS SOFTWARE IS DISTRIBUTED UNDER THE TERMS OF THE GNU GENERAL PUBLIC LICENSE v3 (GPLv3).
+ *
+ *    This file is part of ReaK.
+ *
+ *    ReaK is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    (at your option) any later version.
+ *
+ *    ReaK is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with ReaK (as LICENSE in the root folder).  
+ *    If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef REAK_PROXY_SDF_GRID_HPP
+#define REAK_PROXY_SDF_GRID_HPP
+
+#include "proxy_query_model.hpp"
+
+#include <vector>
+#include <string>
+
+/** Main namespace for ReaK */
+namespace ReaK {
+
+/** Main namespace for ReaK.Geometry */
+namespace geom {
+
+
+/**
+ * This class stores a signed-distance field (SDF) of a static 3D proximity-query model, sampled 
+ * on a regular axis-aligned grid. The distances at the grid nodes are computed with the exact 
+ * proximity queries (against a point-like probe), and lookups return a conservative lower-bound 
+ * on the signed distance, obtained by correcting each of the eight surrounding node values by 
+ * the distance to that node (the signed-distance being 1-Lipschitz). The node values are stored 
+ * contiguously (x-major, then y, then z), such that a grid can be saved to and loaded from a 
+ * flat binary file, for reuse between runs against the same environment. A grid loaded from such 
+ * a file is memory-mapped (read-only) instead of being copied, where the platform supports it.
+ */
+class proxy_sdf_grid_3D : public named_object {
+  protected:
+    
+    class raw_file_mapping;
+    
+    vect<double,3> mLowerCorner;
+    double mCellSize;
+    unsigned int mDims[3];
+    std::vector<double> mDistances;
+    shared_ptr< raw_file_mapping > mMapping;  // holds the memory-mapped file, if the grid was loaded from one.
+    const double* mMappedNodes;               // the node values, within the mapped file (or null if not mapped).
+    std::size_t mMappedCount;
+    
+    const double* getNodes() const {
+      return (mMappedNodes ? mMappedNodes : &mDistances[0]);
+    };
+    
+    double getNodeDistance(unsigned int i, unsigned int j, unsigned int k) const {
+      return getNodes()[(i * mDims[1] + j) * mDims[2] + k];
+    };
+    
+    void getCell(const vect<double,3>& aPoint, unsigned int* aCell, double* aFraction) const;
+    
+    static bool isValidGrid(const unsigned int* aDims, double aCellSize, std::size_t aNodeCount);
+    
+  public:
+    
+    /**
+     * Returns the lower corner of the grid's bounding box.
+     * \return The lower corner of the grid's bounding box.
+     */
+    const vect<double,3>& getLowerCorner() const { return mLowerCorner; };
+    
+    /**
+     * Returns the upper corner of the grid's bounding box.
+     * \return The upper corner of the grid's bounding box.
+     */
+    vect<double,3> getUpperCorner() const;
+    
+    /**
+     * Returns the size of a (cubic) cell of the grid.
+     * \return The size of a (cubic) cell of the grid.
+     */
+    double getCellSize() const { return mCellSize; };
+    
+    /**
+     * Returns the total number of nodes in the grid.
+     * \return The total number of nodes in the grid.
+     */
+    std::size_t getNodeCount() const { return (mMappedNodes ? mMappedCount : mDistances.size()); };
+    
+    /**
+     * Checks if a point lies within the bounding box of the grid.
+     * \param aPoint The point to check, in global coordinates.
+     * \return True if the point is inside the grid's bounding box.
+     */
+    bool isInside(const vect<double,3>& aPoint) const;
+    
+    /**
+     * Computes the signed-distance field of a given proximity-query model over a given box.
+     * \param aModel The (static) proximity-query model whose signed-distance field is sampled.
+     * \param aLowerCorner The lower corner of the box to be covered by the grid.
+     * \param aUpperCorner The upper corner of the box to be covered by the grid.
+     * \param aCellSize The size of the (cubic) cells of the grid.
+     * \throws std::range_error If the cell size is not positive.
+     */
+    void computeGrid(const shared_ptr< proxy_query_model_3D >& aModel, 
+                     const vect<double,3>& aLowerCorner, 
+                     const vect<double,3>& aUpperCorner, 
+                     double aCellSize);
+    
+    /**
+     * Computes the trilinear interpolation of the signed-distance at a given point.
+     * \param aPoint The point at which to evaluate the distance, in global coordinates.
+     * \return The interpolated signed-distance, or negative infinity if the point lies outside the grid.
+     */
+    double getDistance(const vect<double,3>& aPoint) const;
+    
+    /**
+     * Computes the gradient of the trilinear interpolation of the signed-distance at a given point, 
+     * which approximates the outward normal of the nearest surface.
+     * \param aPoint The point at which to evaluate the gradient, in global coordinates.
+     * \return The gradient of the interpolated signed-distance, or zero if the point lies outside the grid.
+     */
+    vect<double,3> getGradient(const vect<double,3>& aPoint) const;
+    
+    /**
+     * Computes a conservative lower-bound on the signed-distance at a given point.
+     * \param aPoint The point at which to evaluate the distance, in global coordinates.
+     * \return A lower-bound on the signed-distance, or negative infinity if the point lies outside the grid.
+     */
+    double getDistanceLowerBound(const vect<double,3>& aPoint) const;
+    
+    /**
+     * Saves the grid to a flat binary file (header followed by the contiguous node values).
+     * \param aFileName The name of the file to write.
+     * \throws std::ios_base::failure If the file could not be written.
+     */
+    void saveRawFile(const std::string& aFileName) const;
+    
+    /**
+     * Loads the grid from a flat binary file (as written by saveRawFile). The file is memory-mapped, 
+     * and stays mapped for as long as this grid (or a copy of it) uses it, such that the node values 
+     * are paged in on demand, instead of being read in full. On platforms without memory-mapping (Windows), 
+     * the file is read in full. The file must not be modified while it is mapped. The grid is left 
+     * unchanged if the file cannot be read.
+     * \param aFileName The name of the file to read.
+     * \throws std::ios_base::failure If the file could not be read or is not a valid grid file 
+     *         (wrong signature or version, less than two nodes along an axis, non-positive cell size, 
+     *         or a number of node values that does not match the dimensions).
+     */
+    void loadRawFile(const std::string& aFileName);
+    
+    /**
+     * Default constructor.
+     */
+    proxy_sdf_grid_3D(const std::string& aName = "");
+    
+    /**
+     * Default destructor.
+     */
+    virtual ~proxy_sdf_grid_3D() { };
+    
+/*******************************************************************************
+                   ReaK's RTTI and Serialization interfaces
+*******************************************************************************/
+    
+    virtual void RK_CALL save(ReaK::serialization::oarchive& A, unsigned int) const;
+
+    virtual void RK_CALL load(ReaK::serialization::iarchive& A, unsigned int);
+    
+    RK_RTTI_MAKE_CONCRETE_1BASE(proxy_sdf_grid_3D,0xC320001E,1,"proxy_sdf_grid_3D",named_object)
+    
+};
+
+
+
+/**
+ * This class defines a proximity-query pair for 3D models in which the second model is static 
+ * and represented by a signed-distance grid. Collision checks first bound each shape of the first
+ * model by its bounding sphere and look up the grid, and fall back to the exact proximity queries
+ * only for the shapes that come near to contact (or lie outside the grid).
+ */
+class proxy_query_sdf_pair_3D : public proxy_query_pair_3D {
+  protected:
+    
+    shared_ptr< proxy_sdf_grid_3D > mGrid;
+    
+  public:
+    
+    /**
+     * Sets the signed-distance grid of the second (static) model.
+     * \param aGrid The signed-distance grid of the second model.
+     */
+    void setGrid(const shared_ptr< proxy_sdf_grid_3D >& aGrid) { mGrid = aGrid; };
+    
+    /**
+     * Returns the signed-distance grid of the second (static) model.
+     * \return The signed-distance grid of the second model.
+     */
+    const shared_ptr< proxy_sdf_grid_3D >& getGrid() const { return mGrid; };
+    
+    /**
+     * Computes the signed-distance grid of the second (static) model.
+     * \param aLowerCorner The lower corner of the box to be covered by the grid.
+     * \param aUpperCorner The upper corner of the box to be covered by the grid.
+     * \param aCellSize The size of the (cubic) cells of the grid.
+     * \throws std::range_error If the cell size is not positive.
+     */
+    void computeGrid(const vect<double,3>& aLowerCorner, 
+                     const vect<double,3>& aUpperCorner, 
+                     double aCellSize);
+    
+    /**
+     * Default constructor.
+     */
+    proxy_query_sdf_pair_3D(const std::string& aName = "",
+                            const shared_ptr< proxy_query_model_3D >& aModel1 = shared_ptr< proxy_query_model_3D >(), 
+                            const shared_ptr< proxy_query_model_3D >& aModel2 = shared_ptr< proxy_query_model_3D >(),
+                            const shared_ptr< proxy_sdf_grid_3D >& aGrid = shared_ptr< proxy_sdf_grid_3D >()) : 
+                            proxy_query_pair_3D(aName, aModel1, aModel2), mGrid(aGrid) { };
+    
+    /**
+     * Default destructor.
+     */
+    virtual ~proxy_query_sdf_pair_3D() { };
+    
+    /**
+     * Checks if the two models are free of collision, using the signed-distance grid to 
+     * avoid the exact proximity queries for shapes that are far from contact.
+     * \return True if the two models are not colliding.
+     */
+    virtual bool isCollisionFree() const;
+    
+    virtual bool gatherCollisionPoints(std::vector< proximity_record_3D >& aOutput) const;
+    
+    
+/*******************************************************************************
+                   ReaK's RTTI and Serialization interfaces
+*******************************************************************************/
+    
+    virtual void RK_CALL save(ReaK::serialization::oarchive& A, unsigned int) const {
+      proxy_query_pair_3D::save(A,proxy_query_pair_3D::getStaticObjectType()->TypeVersion());
+      A & RK_SERIAL_SAVE_WITH_NAME(mGrid);
+    };
+
+    virtual void RK_CALL load(ReaK::serialization::iarchive& A, unsigned int) {
+      proxy_query_pair_3D::load(A,proxy_query_pair_3D::getStaticObjectType()->TypeVersion());
+      A & RK_SERIAL_LOAD_WITH_NAME(mGrid);
+    };
+
+    RK_RTTI_MAKE_CONCRETE_1BASE(proxy_query_sdf_pair_3D,0xC320001F,1,"proxy_query_sdf_pair_3D",proxy_query_pair_3D)
+    
+};
+
+
+};
+
+};
+
+#endif
+
+
+
+
+
+
+
+
+
+
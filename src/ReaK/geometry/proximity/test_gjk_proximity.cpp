@@ -0,0 +1,126 @@
+
+/*
+ *    Copyright 2013 Sven Mikael Persson
+ *
+ *    THIS SOFTWARE IS DISTRIBUTED UNDER THE TERMS OF THE GNU GENERAL PUBLIC LICENSE v3 (GPLv3).
+ *
+ *    This file is part of ReaK.
+ *
+ *    ReaK is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    (at your option) any later version.
+ *
+ *    ReaK is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with ReaK (as LICENSE in the root folder).  
+ *    If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "prox_sphere_sphere.hpp"
+#include "prox_sphere_ccylinder.hpp"
+#include "prox_sphere_box.hpp"
+#include "prox_ccylinder_ccylinder.hpp"
+#include "prox_ccylinder_box.hpp"
+#include "prox_convex_3D.hpp"
+
+#include <boost/date_time/posix_time/posix_time.hpp>
+
+#include <iostream>
+#include <cmath>
+#include <algorithm>
+
+
+using namespace ReaK;
+
+
+/* Moves the second shape of the pair along a path (sweeping past the first shape, through contact), 
+ * computing the proximity at each step, and returns the average time (in microseconds) per query. */
+double run_along_path(geom::proximity_finder_3D& aFinder, const shared_ptr< geom::shape_3D >& aMover, 
+                      std::size_t aSteps, std::vector<double>& aDistances) {
+  aDistances.resize(aSteps);
+  boost::posix_time::ptime t_start = boost::posix_time::microsec_clock::local_time();
+  for(std::size_t i = 0; i < aSteps; ++i) {
+    double s = double(i) / double(aSteps - 1);
+    aMover->setPose(pose_3D<double>(shared_ptr< pose_3D<double> >(), 
+                                    vect<double,3>(-4.0 + 8.0 * s, 0.5, 0.25), 
+                                    axis_angle<double>(3.0 * s, vect<double,3>(0.0,0.6,0.8)).getQuaternion()));
+    aFinder.computeProximity();
+    aDistances[i] = aFinder.getLastResult().mDistance;
+  };
+  boost::posix_time::time_duration dt = boost::posix_time::microsec_clock::local_time() - t_start;
+  return dt.total_microseconds() / double(aSteps);
+};
+
+
+void benchmark_pair(const std::string& aName, geom::proximity_finder_3D& aSpecialized, 
+                    const shared_ptr< geom::shape_3D >& aShape1, const shared_ptr< geom::shape_3D >& aMover) {
+  const std::size_t steps = 10000;
+  std::vector<double> d_spec, d_warm, d_cold;
+  
+  double t_spec = run_along_path(aSpecialized, aMover, steps, d_spec);
+  
+  geom::prox_convex_3D warm_finder(aShape1, aMover);
+  double t_warm = run_along_path(warm_finder, aMover, steps, d_warm);
+  
+  // a fresh GJK finder at every step, i.e., without warm-starting.
+  double t_cold = 0.0;
+  d_cold.resize(steps);
+  for(std::size_t i = 0; i < steps; ++i) {
+    double s = double(i) / double(steps - 1);
+    aMover->setPose(pose_3D<double>(shared_ptr< pose_3D<double> >(), 
+                                    vect<double,3>(-4.0 + 8.0 * s, 0.5, 0.25), 
+                                    axis_angle<double>(3.0 * s, vect<double,3>(0.0,0.6,0.8)).getQuaternion()));
+    geom::prox_convex_3D cold_finder(aShape1, aMover);
+    boost::posix_time::ptime t_start = boost::posix_time::microsec_clock::local_time();
+    cold_finder.computeProximity();
+    t_cold += (boost::posix_time::microsec_clock::local_time() - t_start).total_microseconds();
+    d_cold[i] = cold_finder.getLastResult().mDistance;
+  };
+  t_cold /= double(steps);
+  
+  double max_err = 0.0;
+  for(std::size_t i = 0; i < steps; ++i) {
+    max_err = std::max(max_err, std::fabs(d_warm[i] - d_spec[i]));
+    max_err = std::max(max_err, std::fabs(d_cold[i] - d_spec[i]));
+  };
+  
+  std::cout << aName << "\t" << t_spec << "\t" << t_cold << "\t" << t_warm << "\t" << max_err << std::endl;
+};
+
+
+int main() {
+  
+  pose_3D<double> a0 = pose_3D<double>(shared_ptr< pose_3D<double> >(), vect<double,3>(0.0,0.0,0.0), quaternion<double>(vect<double,4>(0.8,0.0,0.6,0.0)));
+  
+  shared_ptr< geom::sphere > sp1(new geom::sphere("sp1", shared_ptr< pose_3D<double> >(), a0, 1.0));
+  shared_ptr< geom::sphere > sp2(new geom::sphere("sp2", shared_ptr< pose_3D<double> >(), a0, 0.5));
+  shared_ptr< geom::capped_cylinder > cc1(new geom::capped_cylinder("cc1", shared_ptr< pose_3D<double> >(), a0, 2.0, 0.5));
+  shared_ptr< geom::capped_cylinder > cc2(new geom::capped_cylinder("cc2", shared_ptr< pose_3D<double> >(), a0, 1.0, 0.25));
+  shared_ptr< geom::box > bx2(new geom::box("bx2", shared_ptr< pose_3D<double> >(), a0, vect<double,3>(1.0,0.5,2.0)));
+  
+  std::cout << "Pair\tSpecialized (us)\tGJK/EPA cold (us)\tGJK/EPA warm (us)\tMax. distance difference" << std::endl;
+  
+  geom::prox_sphere_sphere sp_sp(sp1, sp2);
+  benchmark_pair("sphere-sphere", sp_sp, sp1, sp2);
+  
+  geom::prox_sphere_ccylinder sp_cc(sp1, cc2);
+  benchmark_pair("sphere-ccylinder", sp_cc, sp1, cc2);
+  
+  geom::prox_sphere_box sp_bx(sp1, bx2);
+  benchmark_pair("sphere-box", sp_bx, sp1, bx2);
+  
+  geom::prox_ccylinder_ccylinder cc_cc(cc1, cc2);
+  benchmark_pair("ccylinder-ccylinder", cc_cc, cc1, cc2);
+  
+  geom::prox_ccylinder_box cc_bx(cc1, bx2);
+  benchmark_pair("ccylinder-box", cc_bx, cc1, bx2);
+  
+  return 0;
+};
+
+
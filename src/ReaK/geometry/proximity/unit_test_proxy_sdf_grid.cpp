@@ -0,0 +1,134 @@
+/*
+ *    Copyright 2013 Sven Mikael Persson
+ *
+ *    THIS SOFTWARE IS DISTRIBUTED UNDER THE TERMS OF THE GNU GENERAL PUBLIC LICENSE v3 (GPLv3).
+ *
+ *    This file is part of ReaK.
+ *
+ *    ReaK is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    (at your option) any later version.
+ *
+ *    ReaK is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with ReaK (as LICENSE in the root folder).
+ *    If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "proxy_sdf_grid.hpp"
+
+#include "shapes/sphere.hpp"
+
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+
+#define BOOST_TEST_DYN_LINK
+
+#define BOOST_TEST_MODULE proxy_sdf_grid
+#include <boost/test/unit_test.hpp>
+
+
+namespace {
+
+using namespace ReaK;
+using namespace ReaK::geom;
+
+const double sphere_radius = 1.0;
+const double cell_size = 0.1;
+
+// the signed-distance grid of a unit sphere at the origin, over the box [-2,2]^3.
+shared_ptr< proxy_sdf_grid_3D > make_sphere_grid() {
+  shared_ptr< proxy_query_model_3D > model(new proxy_query_model_3D("sphere_model"));
+  model->addShape(shared_ptr< sphere >(new sphere("sphere", shared_ptr< pose_3D<double> >(), pose_3D<double>(), sphere_radius)));
+  shared_ptr< proxy_sdf_grid_3D > grid(new proxy_sdf_grid_3D("sphere_grid"));
+  grid->computeGrid(model, vect<double,3>(-2.0, -2.0, -2.0), vect<double,3>(2.0, 2.0, 2.0), cell_size);
+  return grid;
+};
+
+// a few points at different distances (inside and outside) and directions from the sphere.
+std::vector< vect<double,3> > get_test_points() {
+  std::vector< vect<double,3> > result;
+  result.push_back(vect<double,3>(1.5, 0.0, 0.0));
+  result.push_back(vect<double,3>(0.0, -1.23, 0.0));
+  result.push_back(vect<double,3>(0.31, 0.47, 1.38));
+  result.push_back(vect<double,3>(-0.62, 0.55, -0.41));
+  result.push_back(vect<double,3>(1.17, -1.04, 0.86));
+  result.push_back(vect<double,3>(-0.83, 0.0, 0.27));
+  return result;
+};
+
+void check_sphere_grid(const proxy_sdf_grid_3D& aGrid) {
+  std::vector< vect<double,3> > pts = get_test_points();
+  for(std::size_t i = 0; i < pts.size(); ++i) {
+    double r = norm_2(pts[i]);
+    double exact = r - sphere_radius;
+    // the interpolation of a 1-Lipschitz field is off by at most half a cell diagonal.
+    BOOST_CHECK_SMALL( aGrid.getDistance(pts[i]) - exact, 0.5 * std::sqrt(3.0) * cell_size );
+    BOOST_CHECK_LE( aGrid.getDistanceLowerBound(pts[i]), exact + 1e-9 );
+    // away from the center, the gradient is the radial direction, to within the cell size over the 
+    // radius of curvature of the level-set.
+    vect<double,3> grad = aGrid.getGradient(pts[i]);
+    BOOST_CHECK_SMALL( norm_2(grad - pts[i] * (1.0 / r)), cell_size / r );
+  };
+
+  BOOST_CHECK( !aGrid.isInside(vect<double,3>(2.5, 0.0, 0.0)) );
+  BOOST_CHECK_EQUAL( aGrid.getDistance(vect<double,3>(2.5, 0.0, 0.0)), -std::numeric_limits<double>::infinity() );
+  BOOST_CHECK_SMALL( norm_2(aGrid.getGradient(vect<double,3>(2.5, 0.0, 0.0))), 1e-12 );
+};
+
+};
+
+
+BOOST_AUTO_TEST_CASE( sdf_grid_sphere_tests )
+{
+  shared_ptr< proxy_sdf_grid_3D > grid = make_sphere_grid();
+  BOOST_CHECK_EQUAL( grid->getNodeCount(), 41 * 41 * 41 );
+  check_sphere_grid(*grid);
+};
+
+
+BOOST_AUTO_TEST_CASE( sdf_grid_raw_file_tests )
+{
+  const std::string file_name = "unit_test_proxy_sdf_grid.rksdf";
+  {
+    shared_ptr< proxy_sdf_grid_3D > grid = make_sphere_grid();
+    BOOST_CHECK_NO_THROW( grid->saveRawFile(file_name) );
+  };
+
+  // the loaded (mapped) grid gives the same values, also from a copy that outlives the original.
+  shared_ptr< proxy_sdf_grid_3D > grid_copy;
+  {
+    proxy_sdf_grid_3D loaded("loaded_grid");
+    BOOST_REQUIRE_NO_THROW( loaded.loadRawFile(file_name) );
+    BOOST_CHECK_EQUAL( loaded.getNodeCount(), 41 * 41 * 41 );
+    BOOST_CHECK_SMALL( norm_2(loaded.getLowerCorner() - vect<double,3>(-2.0, -2.0, -2.0)), 1e-12 );
+    check_sphere_grid(loaded);
+    grid_copy = shared_ptr< proxy_sdf_grid_3D >(new proxy_sdf_grid_3D(loaded));
+  };
+  check_sphere_grid(*grid_copy);
+
+  // a truncated file is rejected, and the grid is left unchanged (the mapped file itself is not modified).
+  const std::string truncated_name = "unit_test_proxy_sdf_grid_truncated.rksdf";
+  {
+    std::ifstream in(file_name.c_str(), std::ios::binary);
+    std::string contents((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    std::ofstream out(truncated_name.c_str(), std::ios::binary);
+    out.write(contents.data(), contents.size() - sizeof(double));
+  };
+  BOOST_CHECK_THROW( grid_copy->loadRawFile(truncated_name), std::ios_base::failure );
+  check_sphere_grid(*grid_copy);
+
+  BOOST_CHECK_THROW( grid_copy->loadRawFile("unit_test_proxy_sdf_grid.missing"), std::ios_base::failure );
+
+  grid_copy.reset();
+  std::remove(truncated_name.c_str());
+  std::remove(file_name.c_str());
+};
+
+
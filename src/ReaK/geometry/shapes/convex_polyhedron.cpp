@@ -0,0 +1,230 @@
+
+/*
+ *    Copyright 2013 Sven Mikael Persson
+ *
+ *    THIS SOFTWARE IS DISTRIBUTED UNDER THE TERMS OF THE GNU GENERAL PUBLIC LICENSE v3 (GPLv3).
+ *
+ *    This file is part of ReaK.
+ *
+ *    ReaK is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    (at your option) any later version.
+ *
+ *    ReaK is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with ReaK (as LICENSE in the root folder).  
+ *    If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "convex_polyhedron.hpp"
+
+#include <set>
+#include <utility>
+#include <cmath>
+
+namespace ReaK {
+
+namespace geom {
+
+
+namespace {
+
+struct hull_face {
+  std::size_t v[3];
+  vect<double,3> normal;
+  double offset;
+};
+
+hull_face make_hull_face(const std::vector< vect<double,3> >& aPts, std::size_t a, std::size_t b, std::size_t c) {
+  hull_face f;
+  f.v[0] = a; f.v[1] = b; f.v[2] = c;
+  f.normal = (aPts[b] - aPts[a]) % (aPts[c] - aPts[a]);
+  double n = norm_2(f.normal);
+  if(n > 0.0)
+    f.normal *= 1.0 / n;
+  f.offset = f.normal * aPts[a];
+  return f;
+};
+
+std::size_t get_farthest_point(const std::vector< vect<double,3> >& aPts, 
+                               const vect<double,3>& aOrigin, 
+                               const vect<double,3>& aAxis, 
+                               int aMode, double& aDist) {
+  // aMode: 0 for the distance to the origin, 1 to the line (origin, axis), 2 to the plane (origin, normal).
+  std::size_t result = 0;
+  aDist = -1.0;
+  for(std::size_t i = 0; i < aPts.size(); ++i) {
+    vect<double,3> d = aPts[i] - aOrigin;
+    double dist = (aMode == 0 ? norm_2(d) : (aMode == 1 ? norm_2(d % aAxis) : std::fabs(d * aAxis)));
+    if(dist > aDist) {
+      aDist = dist;
+      result = i;
+    };
+  };
+  return result;
+};
+
+/*
+ * Keeps only the vertices of the convex hull of the points (an incremental hull, quadratic in the 
+ * worst-case, but only done when the vertices are set). Points that lie within a small tolerance 
+ * of the hull's faces are dropped, as they are never needed as support points. If the points are 
+ * degenerate (coplanar or fewer than four), they are left as is.
+ */
+void reduce_to_hull_vertices(std::vector< vect<double,3> >& aPts) {
+  if(aPts.size() < 5)
+    return;
+  
+  double scale = 0.0;
+  get_farthest_point(aPts, aPts[0], vect<double,3>(), 0, scale);
+  const double tol = 1e-9 * scale;
+  
+  // initial tetrahedron, from the most spread-out points.
+  double d = 0.0;
+  std::size_t i0 = get_farthest_point(aPts, aPts[0], vect<double,3>(), 0, d);
+  std::size_t i1 = get_farthest_point(aPts, aPts[i0], vect<double,3>(), 0, d);
+  if(d <= tol)
+    return;
+  std::size_t i2 = get_farthest_point(aPts, aPts[i0], unit(aPts[i1] - aPts[i0]), 1, d);
+  if(d <= tol)
+    return;
+  std::size_t i3 = get_farthest_point(aPts, aPts[i0], unit((aPts[i1] - aPts[i0]) % (aPts[i2] - aPts[i0])), 2, d);
+  if(d <= tol)
+    return;
+  
+  std::vector< hull_face > faces;
+  faces.push_back(make_hull_face(aPts, i0, i1, i2));
+  faces.push_back(make_hull_face(aPts, i0, i3, i1));
+  faces.push_back(make_hull_face(aPts, i1, i3, i2));
+  faces.push_back(make_hull_face(aPts, i2, i3, i0));
+  vect<double,3> center = 0.25 * (aPts[i0] + aPts[i1] + aPts[i2] + aPts[i3]);
+  if(faces[0].normal * center > faces[0].offset) {  // all faces are inward, flip them.
+    for(std::size_t j = 0; j < faces.size(); ++j)
+      faces[j] = make_hull_face(aPts, faces[j].v[0], faces[j].v[2], faces[j].v[1]);
+  };
+  
+  std::vector< hull_face > kept_faces;
+  std::set< std::pair<std::size_t, std::size_t> > visible_edges;
+  for(std::size_t i = 0; i < aPts.size(); ++i) {
+    if((i == i0) || (i == i1) || (i == i2) || (i == i3))
+      continue;
+    
+    // split the faces into those visible from the point, whose edges are collected, and the others.
+    kept_faces.clear();
+    visible_edges.clear();
+    for(std::size_t j = 0; j < faces.size(); ++j) {
+      if(faces[j].normal * aPts[i] - faces[j].offset > tol) {
+        for(std::size_t k = 0; k < 3; ++k)
+          visible_edges.insert(std::make_pair(faces[j].v[k], faces[j].v[(k + 1) % 3]));
+      } else
+        kept_faces.push_back(faces[j]);
+    };
+    if(visible_edges.empty())
+      continue;  // inside the current hull.
+    
+    // the horizon edges are those of a visible face whose twin is not visible, they are joined to the point.
+    for(std::set< std::pair<std::size_t, std::size_t> >::const_iterator it = visible_edges.begin(); it != visible_edges.end(); ++it)
+      if(visible_edges.find(std::make_pair(it->second, it->first)) == visible_edges.end())
+        kept_faces.push_back(make_hull_face(aPts, it->first, it->second, i));
+    faces.swap(kept_faces);
+  };
+  
+  // a point added before the corners around it can remain a vertex of coplanar faces, 
+  // only the corners are kept, i.e., the vertices whose incident faces' normals span the space.
+  std::vector< std::vector< vect<double,3> > > incident_normals(aPts.size());
+  for(std::size_t j = 0; j < faces.size(); ++j)
+    for(std::size_t k = 0; k < 3; ++k)
+      incident_normals[faces[j].v[k]].push_back(faces[j].normal);
+  
+  std::vector< vect<double,3> > hull_pts;
+  for(std::size_t i = 0; i < aPts.size(); ++i) {
+    const std::vector< vect<double,3> >& n = incident_normals[i];
+    if(n.empty())
+      continue;
+    std::size_t j = 1;
+    while((j < n.size()) && (norm_2(n[0] % n[j]) < 1e-6))
+      ++j;
+    if(j == n.size())
+      continue;  // within a face.
+    vect<double,3> n01 = unit(n[0] % n[j]);
+    std::size_t k = j + 1;
+    while((k < n.size()) && (std::fabs(n01 * n[k]) < 1e-6))
+      ++k;
+    if(k == n.size())
+      continue;  // within an edge.
+    hull_pts.push_back(aPts[i]);
+  };
+  aPts.swap(hull_pts);
+};
+
+};
+
+
+void convex_polyhedron::updateBoundingRadius() {
+  mBoundingRadius = 0.0;
+  for(std::size_t i = 0; i < mVertices.size(); ++i) {
+    double r = norm_2(mVertices[i]);
+    if(r > mBoundingRadius)
+      mBoundingRadius = r;
+  };
+};
+
+double convex_polyhedron::getBoundingRadius() const {
+  return mBoundingRadius;
+};
+
+void convex_polyhedron::setVertices(const std::vector< vect<double,3> >& aVertices) {
+  mVertices = aVertices;
+  reduce_to_hull_vertices(mVertices);
+  updateBoundingRadius();
+};
+
+vect<double,3> convex_polyhedron::getSupportVertex(const vect<double,3>& aDirection) const {
+  if(mVertices.empty())
+    return vect<double,3>(0.0,0.0,0.0);
+  std::size_t max_i = 0;
+  double max_d = mVertices[0] * aDirection;
+  for(std::size_t i = 1; i < mVertices.size(); ++i) {
+    double d = mVertices[i] * aDirection;
+    if(d > max_d) {
+      max_d = d;
+      max_i = i;
+    };
+  };
+  return mVertices[max_i];
+};
+
+
+convex_polyhedron::convex_polyhedron(const std::string& aName,
+                                     const shared_ptr< pose_3D<double> >& aAnchor,
+                                     const pose_3D<double>& aPose,
+                                     const std::vector< vect<double,3> >& aVertices) :
+                                     shape_3D(aName,aAnchor,aPose),
+                                     mVertices(aVertices), mBoundingRadius(0.0) { 
+  reduce_to_hull_vertices(mVertices);
+  updateBoundingRadius();
+};
+    
+void RK_CALL convex_polyhedron::save(ReaK::serialization::oarchive& A, unsigned int) const {
+  shape_3D::save(A,shape_3D::getStaticObjectType()->TypeVersion());
+  A & RK_SERIAL_SAVE_WITH_NAME(mVertices);
+};
+
+void RK_CALL convex_polyhedron::load(ReaK::serialization::iarchive& A, unsigned int) {
+  shape_3D::load(A,shape_3D::getStaticObjectType()->TypeVersion());
+  A & RK_SERIAL_LOAD_WITH_NAME(mVertices);
+  reduce_to_hull_vertices(mVertices);
+  updateBoundingRadius();
+};
+
+
+
+};
+
+
+};
+
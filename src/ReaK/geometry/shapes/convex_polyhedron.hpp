@@ -0,0 +1,125 @@
+/**
+ * \file convex_polyhedron.hpp
+ *
+ * This library declares a class to represent convex polyhedra in 3D (as the convex hull of a set of points).
+ *
+ * \author Mikael Persson, <mikael.s.persson@gmail.com>
+ * \date May 2013
+ */
+
+/*
+ *    Copyright 2013 Sven Mikael Persson
+ *
+ *    THIS SOFTWARE IS DISTRIBUTED UNDER THE TERMS OF THE GNU GENERAL PUBLIC LICENSE v3 (GPLv3).
+ *
+ *    This file is part of ReaK.
+ *
+ *    ReaK is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    (at your option) any later version.
+ *
+ *    ReaK is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with ReaK (as LICENSE in the root folder).  
+ *    If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef REAK_CONVEX_POLYHEDRON_HPP
+#define REAK_CONVEX_POLYHEDRON_HPP
+
+#include "shape_3D.hpp"
+
+#include <vector>
+
+/** Main namespace for ReaK */
+namespace ReaK {
+
+/** Main namespace for ReaK.Geometry */
+namespace geom {
+
+
+/** 
+ * This class represents a convex polyhedron as the convex hull of a set of vertices 
+ * (expressed relative to its center pose). The vertices need not all be on the hull, 
+ * only the vertices of the hull are kept when they are set (interior points, and points 
+ * on the hull's faces or edges, are dropped), such that the support-vertex search, which 
+ * is linear in the number of vertices, only visits the hull's corners. 
+ */
+class convex_polyhedron : public shape_3D {
+  protected:
+    
+    std::vector< vect<double,3> > mVertices;
+    double mBoundingRadius;
+    
+    void updateBoundingRadius();
+    
+  public:
+    
+    /**
+     * This function returns the maximum radius of the shape (radius of the sphere that bounds the shape).
+     * \return The maximum radius of the shape.
+     */
+    virtual double getBoundingRadius() const;
+    
+    /**
+     * This function returns the vertices of the polyhedron (relative to its center pose).
+     * \return The vertices of the polyhedron.
+     */
+    const std::vector< vect<double,3> >& getVertices() const { return mVertices; };
+    /**
+     * This function sets the vertices of the polyhedron (relative to its center pose), 
+     * only the vertices of their convex hull are kept.
+     * \param aVertices The new vertices of the polyhedron.
+     */
+    void setVertices(const std::vector< vect<double,3> >& aVertices);
+    
+    /**
+     * This function computes the vertex of the polyhedron that is furthest along a given direction, 
+     * by a linear search over the (hull) vertices.
+     * \param aDirection The direction (relative to the center pose) along which to find the furthest vertex.
+     * \return The furthest vertex (relative to the center pose).
+     */
+    vect<double,3> getSupportVertex(const vect<double,3>& aDirection) const;
+    
+    /**
+     * Default constructor.
+     * \param aName The name of the object.
+     * \param aAnchor The anchor object for the geometry.
+     * \param aPose The pose of the geometry (relative to the anchor).
+     * \param aVertices The vertices of the polyhedron (relative to its pose).
+     */
+    convex_polyhedron(const std::string& aName = "",
+                      const shared_ptr< pose_3D<double> >& aAnchor = shared_ptr< pose_3D<double> >(),
+                      const pose_3D<double>& aPose = pose_3D<double>(),
+                      const std::vector< vect<double,3> >& aVertices = std::vector< vect<double,3> >());
+    
+    /**
+     * Default destructor.
+     */
+    virtual ~convex_polyhedron() { };
+    
+    
+/*******************************************************************************
+                   ReaK's RTTI and Serialization interfaces
+*******************************************************************************/
+    
+    virtual void RK_CALL save(ReaK::serialization::oarchive& A, unsigned int) const;
+
+    virtual void RK_CALL load(ReaK::serialization::iarchive& A, unsigned int);
+
+    RK_RTTI_MAKE_CONCRETE_1BASE(convex_polyhedron,0xC3100014,1,"convex_polyhedron",shape_3D)
+
+};
+
+
+};
+
+};
+
+#endif
+
@@ -30,6 +30,7 @@
 #include "sphere.hpp"
 #include "box.hpp"
 #include "cylinder.hpp"
+#include "convex_polyhedron.hpp"
 #include "composite_shape_3D.hpp"
 
 #include "proximity/proxy_query_model.hpp"
@@ -39,6 +40,8 @@
 #include <Inventor/SbViewportRegion.h>                  // for SbViewportRegion
 #include <Inventor/SbXfBox3f.h>                         // for SbXfBox3f
 #include <Inventor/actions/SoGetBoundingBoxAction.h>    // for SoGetBoundingBoxAction
+#include <Inventor/actions/SoCallbackAction.h>          // for SoCallbackAction
+#include <Inventor/SoPrimitiveVertex.h>                 // for SoPrimitiveVertex
 #include <Inventor/fields/SoMFColor.h>                  // for SoMFColor
 #include <Inventor/fields/SoMFInt32.h>                  // for SoMFInt32
 #include <Inventor/fields/SoMFVec3f.h>                  // for SoMFVec3f
@@ -68,6 +71,8 @@
 #include <Inventor/misc/SoChildList.h>                  // for SoChildList
 
 #include <stack>
+#include <vector>
+#include <algorithm>
 #include <cmath>                                        // for sqrt, M_PI
 
 namespace ReaK {
@@ -184,6 +189,30 @@ oi_reader& oi_reader::read_stream(std::istream& aStream) {
 
 
 
+static void collect_triangle_vertices(void* aUserData, SoCallbackAction*, 
+                                      const SoPrimitiveVertex* v1, 
+                                      const SoPrimitiveVertex* v2, 
+                                      const SoPrimitiveVertex* v3) {
+  std::vector< vect<double,3> >* pts = static_cast< std::vector< vect<double,3> >* >(aUserData);
+  const SoPrimitiveVertex* tri[3] = {v1, v2, v3};
+  // the vertices shared between adjacent triangles are repeated here, see remove_duplicate_vertices.
+  for(int i = 0; i < 3; ++i)
+    pts->push_back(vect<double,3>(tri[i]->getPoint()[0], tri[i]->getPoint()[1], tri[i]->getPoint()[2]));
+};
+
+static bool vertex_less(const vect<double,3>& a, const vect<double,3>& b) {
+  if(a[0] != b[0])
+    return a[0] < b[0];
+  if(a[1] != b[1])
+    return a[1] < b[1];
+  return a[2] < b[2];
+};
+
+static void remove_duplicate_vertices(std::vector< vect<double,3> >& aPts) {
+  std::sort(aPts.begin(), aPts.end(), vertex_less);
+  aPts.erase(std::unique(aPts.begin(), aPts.end()), aPts.end());
+};
+
 static void read_sg_into_models(SoSeparator* aRoot, colored_model_3D* aModel, proxy_query_model_3D* aProxy) {
   
   std::stack< std::pair<SoChildList*,int> > so_group_stack;
@@ -394,39 +423,58 @@ static void read_sg_into_models(SoSeparator* aRoot, colored_model_3D* aModel, pr
       
     } else if(current_node->getTypeId().isDerivedFrom(SoShape::getClassTypeId())) {
       
-      // just register the bounding-box, cannot deal with the display.
-      SbViewportRegion dummy_viewport;
-      SoGetBoundingBoxAction bb_calc(dummy_viewport);
-      bb_calc.apply(current_node);
-      SbXfBox3f& bbox = bb_calc.getXfBoundingBox();
-      if((bbox.getVolume() > std::numeric_limits<float>::epsilon()) && (aProxy)) {
-        float x,y,z;
-        bbox.getSize(x,y,z);
-        SbVec3f center = bbox.getCenter();
-        
-        SbVec3f    translation;
-        SbRotation rotation;
-        SbVec3f    scaleFactor;
-        SbRotation scaleOrientation;
-        bbox.getTransform().getTransform(translation,rotation,scaleFactor,scaleOrientation);
-        // set the transformation:
-        SbVec3f rot_axis;
-        float rot_angle;
-        rotation.getValue(rot_axis, rot_angle);
-        
+      // register the convex hull of the shape's vertices, cannot deal with the display.
+      std::vector< vect<double,3> > hull_pts;
+      if(aProxy) {
+        SoCallbackAction tri_collector;
+        tri_collector.addTriangleCallback(SoShape::getClassTypeId(), collect_triangle_vertices, &hull_pts);
+        tri_collector.apply(current_node);
+        remove_duplicate_vertices(hull_pts);
+      };
+      if(hull_pts.size() >= 4) {
         shared_ptr< pose_3D<double> > anchor_ptr;
         if(!anchor_stack.top()->Parent.expired())
           anchor_ptr = anchor_stack.top()->Parent.lock();
-        pose_3D<double> final_pose = *anchor_stack.top();
-        final_pose.addBefore(pose_3D<double>(weak_ptr< pose_3D<double> >(),
-          vect<double,3>(translation[0] + center[0], translation[1] + center[1], translation[2] + center[2]),
-          axis_angle<double>(rot_angle, vect<double,3>(rot_axis[0],rot_axis[1],rot_axis[2])).getQuaternion()
-        ));
+        shared_ptr< convex_polyhedron > new_poly(new convex_polyhedron(current_node->getName().getString(),
+                                                                       anchor_ptr, *anchor_stack.top(),
+                                                                       hull_pts));
+        aProxy->addShape(new_poly);
+      } else {
         
-        shared_ptr< box > new_box(new box(current_node->getName().getString(),
-                                          anchor_ptr, final_pose,
-                                          vect<double,3>(x,y,z)));
-        aProxy->addShape(new_box);
+        // just register the bounding-box, cannot deal with the display.
+        SbViewportRegion dummy_viewport;
+        SoGetBoundingBoxAction bb_calc(dummy_viewport);
+        bb_calc.apply(current_node);
+        SbXfBox3f& bbox = bb_calc.getXfBoundingBox();
+        if((bbox.getVolume() > std::numeric_limits<float>::epsilon()) && (aProxy)) {
+          float x,y,z;
+          bbox.getSize(x,y,z);
+          SbVec3f center = bbox.getCenter();
+        
+          SbVec3f    translation;
+          SbRotation rotation;
+          SbVec3f    scaleFactor;
+          SbRotation scaleOrientation;
+          bbox.getTransform().getTransform(translation,rotation,scaleFactor,scaleOrientation);
+          // set the transformation:
+          SbVec3f rot_axis;
+          float rot_angle;
+          rotation.getValue(rot_axis, rot_angle);
+        
+          shared_ptr< pose_3D<double> > anchor_ptr;
+          if(!anchor_stack.top()->Parent.expired())
+            anchor_ptr = anchor_stack.top()->Parent.lock();
+          pose_3D<double> final_pose = *anchor_stack.top();
+          final_pose.addBefore(pose_3D<double>(weak_ptr< pose_3D<double> >(),
+            vect<double,3>(translation[0] + center[0], translation[1] + center[1], translation[2] + center[2]),
+            axis_angle<double>(rot_angle, vect<double,3>(rot_axis[0],rot_axis[1],rot_axis[2])).getQuaternion()
+          ));
+        
+          shared_ptr< box > new_box(new box(current_node->getName().getString(),
+                                            anchor_ptr, final_pose,
+                                            vect<double,3>(x,y,z)));
+          aProxy->addShape(new_box);
+        };
       };
     };
     
@@ -171,12 +171,12 @@ struct update_inter_frame_3D {
 oi_scene_graph& operator<<(oi_scene_graph& aSG, const kte::kte_map& aModel) {
   
   // first check if the model is a kte-chain:
-  const void* p_chain = aModel.castTo(kte::kte_map_chain::getStaticObjectType());
+  const void* p_chain = aModel.castTo(rtti::get_type_id_array<kte::kte_map_chain>());
   if(p_chain)
     return aSG << static_cast<const kte::kte_map_chain&>(aModel);
   
   
-  if(aModel.castTo(kte::revolute_joint_3D::getStaticObjectType())) {
+  if(aModel.castTo(rtti::get_type_id_array<kte::revolute_joint_3D>())) {
     const kte::revolute_joint_3D& rev_joint = static_cast<const kte::revolute_joint_3D&>(aModel);
     
     SoSeparator* sep = new SoSeparator;
@@ -228,7 +228,7 @@ oi_scene_graph& operator<<(oi_scene_graph& aSG, const kte::kte_map& aModel) {
       aSG.mAnchor3DMap[rev_joint.BaseFrame()].first->addChild(sep);
     };
     
-  } else if(aModel.castTo(kte::revolute_joint_2D::getStaticObjectType())) {
+  } else if(aModel.castTo(rtti::get_type_id_array<kte::revolute_joint_2D>())) {
     const kte::revolute_joint_2D& rev_joint = static_cast<const kte::revolute_joint_2D&>(aModel);
     
     SoSeparator* sep = new SoSeparator;
@@ -267,7 +267,7 @@ oi_scene_graph& operator<<(oi_scene_graph& aSG, const kte::kte_map& aModel) {
       aSG.mAnchor2DMap[rev_joint.BaseFrame()].first->addChild(sep);
     };
     
-  } else if(aModel.castTo(kte::prismatic_joint_3D::getStaticObjectType())) {
+  } else if(aModel.castTo(rtti::get_type_id_array<kte::prismatic_joint_3D>())) {
     const kte::prismatic_joint_3D& pri_joint = static_cast<const kte::prismatic_joint_3D&>(aModel);
     
     SoSeparator* sep = new SoSeparator;
@@ -320,7 +320,7 @@ oi_scene_graph& operator<<(oi_scene_graph& aSG, const kte::kte_map& aModel) {
       aSG.mAnchor3DMap[pri_joint.BaseFrame()].first->addChild(sep);
     };
     
-  } else if(aModel.castTo(kte::prismatic_joint_2D::getStaticObjectType())) {
+  } else if(aModel.castTo(rtti::get_type_id_array<kte::prismatic_joint_2D>())) {
     const kte::prismatic_joint_2D& pri_joint = static_cast<const kte::prismatic_joint_2D&>(aModel);
     using std::atan2;
     
@@ -364,7 +364,7 @@ oi_scene_graph& operator<<(oi_scene_graph& aSG, const kte::kte_map& aModel) {
       aSG.mAnchor2DMap[pri_joint.BaseFrame()].first->addChild(sep);
     };
     
-  } else if(aModel.castTo(kte::free_joint_3D::getStaticObjectType())) {
+  } else if(aModel.castTo(rtti::get_type_id_array<kte::free_joint_3D>())) {
     const kte::free_joint_3D& fr_joint = static_cast<const kte::free_joint_3D&>(aModel);
     
     SoSeparator* sep = new SoSeparator;
@@ -445,7 +445,7 @@ oi_scene_graph& operator<<(oi_scene_graph& aSG, const kte::kte_map& aModel) {
       aSG.mAnchor3DMap[fr_joint.BaseFrame()].first->addChild(sep);
     };
     
-  } else if(aModel.castTo(kte::free_joint_2D::getStaticObjectType())) {
+  } else if(aModel.castTo(rtti::get_type_id_array<kte::free_joint_2D>())) {
     const kte::free_joint_2D& fr_joint = static_cast<const kte::free_joint_2D&>(aModel);
     
     SoSeparator* sep = new SoSeparator;
@@ -484,7 +484,7 @@ oi_scene_graph& operator<<(oi_scene_graph& aSG, const kte::kte_map& aModel) {
       aSG.mAnchor2DMap[fr_joint.BaseFrame()].first->addChild(sep);
     };
     
-  } else if(aModel.castTo(kte::rigid_link_3D::getStaticObjectType())) {
+  } else if(aModel.castTo(rtti::get_type_id_array<kte::rigid_link_3D>())) {
     const kte::rigid_link_3D& lnk_obj = static_cast<const kte::rigid_link_3D&>(aModel);
     
     vect<double,3> y_axis = lnk_obj.PoseOffset().Position;
@@ -533,7 +533,7 @@ oi_scene_graph& operator<<(oi_scene_graph& aSG, const kte::kte_map& aModel) {
       aSG.mAnchor3DMap[lnk_obj.BaseFrame()].first->addChild(sep);
     };
     
-  } else if(aModel.castTo(kte::rigid_link_2D::getStaticObjectType())) {
+  } else if(aModel.castTo(rtti::get_type_id_array<kte::rigid_link_2D>())) {
     const kte::rigid_link_2D& lnk_obj = static_cast<const kte::rigid_link_2D&>(aModel);
     using std::atan2;
     
@@ -569,7 +569,7 @@ oi_scene_graph& operator<<(oi_scene_graph& aSG, const kte::kte_map& aModel) {
       aSG.mAnchor2DMap[lnk_obj.BaseFrame()].first->addChild(sep);
     };
     
-  } else if(aModel.castTo(kte::spring_3D::getStaticObjectType())) {
+  } else if(aModel.castTo(rtti::get_type_id_array<kte::spring_3D>())) {
     const kte::spring_3D& spr_obj = static_cast<const kte::spring_3D&>(aModel);
     
     if(aSG.mAnchor3DMap.find(spr_obj.Anchor1()) == aSG.mAnchor3DMap.end())
@@ -632,7 +632,7 @@ oi_scene_graph& operator<<(oi_scene_graph& aSG, const kte::kte_map& aModel) {
     */
     aSG.mRoot->addChild(sep); // always at the root because "trans" is a global transformation.
     
-  } else if(aModel.castTo(kte::spring_2D::getStaticObjectType())) {
+  } else if(aModel.castTo(rtti::get_type_id_array<kte::spring_2D>())) {
     const kte::spring_2D& spr_obj = static_cast<const kte::spring_2D&>(aModel);
     
     if(aSG.mAnchor2DMap.find(spr_obj.Anchor1()) == aSG.mAnchor2DMap.end())
@@ -679,7 +679,7 @@ oi_scene_graph& operator<<(oi_scene_graph& aSG, const kte::kte_map& aModel) {
     
     aSG.mRoot->addChild(sep); // always at the root because "trans" is a global transformation.
     
-  } else if(aModel.castTo(kte::damper_3D::getStaticObjectType())) {
+  } else if(aModel.castTo(rtti::get_type_id_array<kte::damper_3D>())) {
     const kte::damper_3D& dmp_obj = static_cast<const kte::damper_3D&>(aModel);
     
     if(aSG.mAnchor3DMap.find(dmp_obj.Anchor1()) == aSG.mAnchor3DMap.end())
@@ -747,7 +747,7 @@ oi_scene_graph& operator<<(oi_scene_graph& aSG, const kte::kte_map& aModel) {
     
     aSG.mRoot->addChild(sep); // always at the root because "trans" is a global transformation.
     
-  } else if(aModel.castTo(kte::damper_2D::getStaticObjectType())) {
+  } else if(aModel.castTo(rtti::get_type_id_array<kte::damper_2D>())) {
     const kte::damper_2D& dmp_obj = static_cast<const kte::damper_2D&>(aModel);
     
     if(aSG.mAnchor2DMap.find(dmp_obj.Anchor1()) == aSG.mAnchor2DMap.end())
@@ -794,7 +794,7 @@ oi_scene_graph& operator<<(oi_scene_graph& aSG, const kte::kte_map& aModel) {
     
     aSG.mRoot->addChild(sep); // always at the root because "trans" is a global transformation.
     
-  } else if(aModel.castTo(kte::torsion_spring_3D::getStaticObjectType())) {
+  } else if(aModel.castTo(rtti::get_type_id_array<kte::torsion_spring_3D>())) {
     const kte::torsion_spring_3D& tor_spr = static_cast<const kte::torsion_spring_3D&>(aModel);
     using std::atan2;
     
@@ -834,7 +834,7 @@ oi_scene_graph& operator<<(oi_scene_graph& aSG, const kte::kte_map& aModel) {
       aSG.mAnchor3DMap[tor_spr.Anchor1()].first->addChild(sep);
     };
     
-  } else if(aModel.castTo(kte::torsion_spring_2D::getStaticObjectType())) {
+  } else if(aModel.castTo(rtti::get_type_id_array<kte::torsion_spring_2D>())) {
     const kte::torsion_spring_2D& tor_spr = static_cast<const kte::torsion_spring_2D&>(aModel);
     using std::atan2;
     
@@ -874,7 +874,7 @@ oi_scene_graph& operator<<(oi_scene_graph& aSG, const kte::kte_map& aModel) {
       aSG.mAnchor2DMap[tor_spr.Anchor1()].first->addChild(sep);
     };
     
-  } else if(aModel.castTo(kte::torsion_damper_3D::getStaticObjectType())) {
+  } else if(aModel.castTo(rtti::get_type_id_array<kte::torsion_damper_3D>())) {
     const kte::torsion_damper_3D& tor_dmp = static_cast<const kte::torsion_damper_3D&>(aModel);
     using std::atan2;
     
@@ -914,7 +914,7 @@ oi_scene_graph& operator<<(oi_scene_graph& aSG, const kte::kte_map& aModel) {
       aSG.mAnchor3DMap[tor_dmp.Anchor1()].first->addChild(sep);
     };
     
-  } else if(aModel.castTo(kte::torsion_damper_2D::getStaticObjectType())) {
+  } else if(aModel.castTo(rtti::get_type_id_array<kte::torsion_damper_2D>())) {
     const kte::torsion_damper_2D& tor_dmp = static_cast<const kte::torsion_damper_2D&>(aModel);
     using std::atan2;
     
@@ -954,7 +954,7 @@ oi_scene_graph& operator<<(oi_scene_graph& aSG, const kte::kte_map& aModel) {
       aSG.mAnchor2DMap[tor_dmp.Anchor1()].first->addChild(sep);
     };
     
-  } else if(aModel.castTo(kte::inertia_3D::getStaticObjectType())) {
+  } else if(aModel.castTo(rtti::get_type_id_array<kte::inertia_3D>())) {
     const kte::inertia_3D& cm_obj = static_cast<const kte::inertia_3D&>(aModel);
     
     SoSeparator* sep = new SoSeparator;
@@ -979,7 +979,7 @@ oi_scene_graph& operator<<(oi_scene_graph& aSG, const kte::kte_map& aModel) {
       aSG.mAnchor3DMap[cm_obj.CenterOfMass()->mFrame].first->addChild(sep);
     };
     
-  } else if(aModel.castTo(kte::inertia_2D::getStaticObjectType())) {
+  } else if(aModel.castTo(rtti::get_type_id_array<kte::inertia_2D>())) {
     const kte::inertia_2D& cm_obj = static_cast<const kte::inertia_2D&>(aModel);
     
     SoSeparator* sep = new SoSeparator;
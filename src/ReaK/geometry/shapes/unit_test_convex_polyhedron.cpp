@@ -0,0 +1,108 @@
+/*
+ *    Copyright 2013 Sven Mikael Persson
+ *
+ *    THIS SOFTWARE IS DISTRIBUTED UNDER THE TERMS OF THE GNU GENERAL PUBLIC LICENSE v3 (GPLv3).
+ *
+ *    This file is part of ReaK.
+ *
+ *    ReaK is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    (at your option) any later version.
+ *
+ *    ReaK is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with ReaK (as LICENSE in the root folder).
+ *    If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "convex_polyhedron.hpp"
+
+#include <cmath>
+
+#define BOOST_TEST_DYN_LINK
+
+#define BOOST_TEST_MODULE convex_polyhedron
+#include <boost/test/unit_test.hpp>
+
+
+using namespace ReaK;
+using namespace ReaK::geom;
+
+
+BOOST_AUTO_TEST_CASE( convex_polyhedron_cube_tests )
+{
+  // a tessellated cube: corners, edge mid-points, face centers, interior points, and repeated vertices.
+  std::vector< vect<double,3> > pts;
+  for(int i = -1; i <= 1; ++i)
+    for(int j = -1; j <= 1; ++j)
+      for(int k = -1; k <= 1; ++k)
+        pts.push_back(vect<double,3>(i, j, k));
+  pts.push_back(vect<double,3>(0.3, -0.2, 0.5));
+  pts.push_back(vect<double,3>(1.0, 1.0, 1.0));
+  pts.push_back(vect<double,3>(-1.0, 0.5, 0.25));
+
+  convex_polyhedron cube("cube", shared_ptr< pose_3D<double> >(), pose_3D<double>(), pts);
+  BOOST_CHECK_EQUAL( cube.getVertices().size(), 8 );
+  for(std::size_t i = 0; i < cube.getVertices().size(); ++i) {
+    const vect<double,3>& v = cube.getVertices()[i];
+    BOOST_CHECK_CLOSE( std::fabs(v[0]), 1.0, 1e-9 );
+    BOOST_CHECK_CLOSE( std::fabs(v[1]), 1.0, 1e-9 );
+    BOOST_CHECK_CLOSE( std::fabs(v[2]), 1.0, 1e-9 );
+  };
+  BOOST_CHECK_CLOSE( cube.getBoundingRadius(), std::sqrt(3.0), 1e-9 );
+
+  vect<double,3> s = cube.getSupportVertex(vect<double,3>(1.0, -2.0, 3.0));
+  BOOST_CHECK_SMALL( norm_2(s - vect<double,3>(1.0, -1.0, 1.0)), 1e-12 );
+
+  // points that lie inside a tetrahedron are all dropped.
+  std::vector< vect<double,3> > tet;
+  tet.push_back(vect<double,3>(0.0, 0.0, 0.0));
+  tet.push_back(vect<double,3>(0.1, 0.1, 0.1));
+  tet.push_back(vect<double,3>(2.0, 0.0, 0.0));
+  tet.push_back(vect<double,3>(0.2, 0.3, 0.1));
+  tet.push_back(vect<double,3>(0.0, 2.0, 0.0));
+  tet.push_back(vect<double,3>(0.0, 0.0, 2.0));
+  cube.setVertices(tet);
+  BOOST_CHECK_EQUAL( cube.getVertices().size(), 4 );
+};
+
+
+BOOST_AUTO_TEST_CASE( convex_polyhedron_sphere_tests )
+{
+  // points spread on a sphere are all on the hull, the center is not.
+  const std::size_t n = 200;
+  std::vector< vect<double,3> > pts;
+  pts.push_back(vect<double,3>(0.0, 0.0, 0.0));
+  for(std::size_t i = 0; i < n; ++i) {
+    double z = 1.0 - (2.0 * i + 1.0) / n;
+    double r = std::sqrt(1.0 - z * z);
+    double a = 2.399963229728653 * i;  // the golden angle.
+    pts.push_back(vect<double,3>(r * std::cos(a), r * std::sin(a), z));
+  };
+  convex_polyhedron ball("ball", shared_ptr< pose_3D<double> >(), pose_3D<double>(), pts);
+  BOOST_CHECK_EQUAL( ball.getVertices().size(), n );
+
+  // the support vertex is the same as a search over all the original points.
+  for(std::size_t i = 0; i < 20; ++i) {
+    vect<double,3> d(std::cos(0.7 * i), std::sin(1.3 * i), std::cos(2.1 * i + 0.5));
+    double max_d = pts[0] * d;
+    for(std::size_t j = 1; j < pts.size(); ++j)
+      max_d = std::max(max_d, pts[j] * d);
+    BOOST_CHECK_CLOSE( ball.getSupportVertex(d) * d, max_d, 1e-9 );
+  };
+
+  // degenerate (coplanar) points are kept as they are.
+  std::vector< vect<double,3> > flat;
+  for(int i = 0; i < 3; ++i)
+    for(int j = 0; j < 3; ++j)
+      flat.push_back(vect<double,3>(i, j, 0.0));
+  ball.setVertices(flat);
+  BOOST_CHECK_EQUAL( ball.getVertices().size(), 9 );
+};
+
+
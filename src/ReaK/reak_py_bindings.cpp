@@ -36,9 +36,11 @@ namespace PyReaK {
 
 void export_base();
 void export_vect_alg();
+void export_mat_alg();
 void export_kinetostatics();
 void export_mbd_kte();
 void export_kte_models();
+void export_recorders();
 
 };
 
@@ -51,9 +53,11 @@ BOOST_PYTHON_MODULE(libreak_py) {
   
   export_base();
   export_vect_alg();
+  export_mat_alg();
   export_kinetostatics();
   export_mbd_kte();
   export_kte_models();
+  export_recorders();
   
 };
 